@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cuda_runtime.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -129,6 +130,39 @@ cuvsError_t cuvsRMMFree(cuvsResources_t res, void* ptr, size_t bytes);
 
 /** @} */
 
+/**
+ * @defgroup serialize_c cuVS Serialization Streams
+ * @{
+ */
+
+/**
+ * @brief Receives the bytes of a serialized index, in order.
+ *
+ * Used by the `...SerializeToStream` functions to write an index without a file, for instance to
+ * a socket or a buffer of the caller.
+ *
+ * @param[in] context the opaque pointer passed along with the callback
+ * @param[in] data the next bytes of the index
+ * @param[in] size the number of bytes
+ * @return the number of bytes taken; anything but `size` aborts the serialization
+ */
+typedef size_t (*cuvsWriteCallback)(void* context, const void* data, size_t size);
+
+/**
+ * @brief Provides the bytes of a serialized index, in order.
+ *
+ * Used by the `...DeserializeFromStream` functions to load an index without a file.
+ *
+ * @param[in] context the opaque pointer passed along with the callback
+ * @param[out] data buffer receiving the next bytes of the index
+ * @param[in] size the capacity of the buffer
+ * @return the number of bytes stored in `data`, at most `size`; zero at the end of the stream or
+ *         on error
+ */
+typedef size_t (*cuvsReadCallback)(void* context, void* data, size_t size);
+
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -158,6 +158,93 @@ cuvsError_t cuvsBruteForceSearch(cuvsResources_t res,
  * @}
  */
 
+/**
+ * @defgroup bruteforce_c_serialize BRUTEFORCE C-API serialize functions
+ * @{
+ */
+/**
+ * Save the index to file.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.c}
+ * #include <cuvs/neighbors/brute_force.h>
+ *
+ * // Create cuvsResources_t
+ * cuvsResources_t res;
+ * cuvsError_t res_create_status = cuvsResourcesCreate(&res);
+ *
+ * // create an index with `cuvsBruteForceBuild`
+ * cuvsBruteForceSerialize(res, "/path/to/index", index);
+ * @endcode
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index BRUTEFORCE index
+ */
+cuvsError_t cuvsBruteForceSerialize(cuvsResources_t res,
+                                    const char* filename,
+                                    cuvsBruteForceIndex_t index);
+
+/**
+ * Write the index to a stream, through a callback receiving its bytes in order.
+ *
+ * The callback can write to a socket, a pipe or a buffer of the caller: no file is needed.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] write the callback receiving the bytes of the index
+ * @param[in] context opaque pointer passed to `write`
+ * @param[in] index BRUTEFORCE index
+ */
+cuvsError_t cuvsBruteForceSerializeToStream(cuvsResources_t res,
+                                            cuvsWriteCallback write,
+                                            void* context,
+                                            cuvsBruteForceIndex_t index);
+
+/**
+ * Load index from file.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index BRUTEFORCE index loaded from disk, created with `cuvsBruteForceIndexCreate`
+ */
+cuvsError_t cuvsBruteForceDeserialize(cuvsResources_t res,
+                                      const char* filename,
+                                      cuvsBruteForceIndex_t index);
+
+/**
+ * Load index from a stream, through a callback providing its bytes in order.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] read the callback providing the bytes of the index
+ * @param[in] context opaque pointer passed to `read`
+ * @param[out] index BRUTEFORCE index, created with `cuvsBruteForceIndexCreate`
+ */
+cuvsError_t cuvsBruteForceDeserializeFromStream(cuvsResources_t res,
+                                                cuvsReadCallback read,
+                                                void* context,
+                                                cuvsBruteForceIndex_t index);
+
+/**
+ * Load index from a host memory buffer holding a serialized index.
+ *
+ * The buffer is not referenced after the call returns.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] data the serialized index
+ * @param[in] size the size of the serialized index in bytes
+ * @param[out] index BRUTEFORCE index, created with `cuvsBruteForceIndexCreate`
+ */
+cuvsError_t cuvsBruteForceDeserializeFromBuffer(cuvsResources_t res,
+                                                const void* data,
+                                                size_t size,
+                                                cuvsBruteForceIndex_t index);
+/**
+ * @}
+ */
+
 #ifdef __cplusplus
 }
 #endif
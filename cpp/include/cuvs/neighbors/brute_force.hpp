@@ -21,8 +21,13 @@
 #include <raft/core/device_mdarray.hpp>
 #include <raft/core/device_mdspan.hpp>
 #include <raft/core/handle.hpp>
+#include <raft/core/host_mdarray.hpp>
 #include <raft/core/host_mdspan.hpp>
 
+#include <istream>
+#include <ostream>
+#include <string>
+
 namespace cuvs::neighbors::brute_force {
 
 /**
@@ -45,6 +50,12 @@ struct index : cuvs::neighbors::index {
   index& operator=(index&&)      = default;
   ~index()                       = default;
 
+  /** Construct an empty index.
+   *
+   * Constructs an empty index, to be replaced by `deserialize`.
+   */
+  index(raft::resources const& res);
+
   /** Construct a brute force index from dataset
    *
    * Constructs a brute force index from a dataset. This lets us precompute norms for
@@ -129,6 +140,67 @@ struct index : cuvs::neighbors::index {
   raft::device_matrix_view<const T, int64_t, raft::row_major> dataset_view_;
   T metric_arg_;
 };
+
+/**
+ * @brief Brute Force index in host memory, searched on the CPU.
+ *
+ * The index stores a non-owning reference to the dataset and the dataset norms of the expanded
+ * metrics, precomputed at construction like those of `index`.
+ *
+ * @tparam T data element type
+ */
+template <typename T>
+struct host_index : cuvs::neighbors::index {
+ public:
+  host_index(const host_index&)            = delete;
+  host_index(host_index&&)                 = default;
+  host_index& operator=(const host_index&) = delete;
+  host_index& operator=(host_index&&)      = default;
+  ~host_index()                            = default;
+
+  /** Construct a host brute force index from a dataset in host memory.
+   *
+   * The norms are computed here for `L2Expanded`, `L2SqrtExpanded` and `CosineExpanded`.
+   * The dataset must outlive the index.
+   */
+  host_index(raft::resources const& res,
+             raft::host_matrix_view<const T, int64_t, raft::row_major> dataset_view,
+             cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+             T metric_arg                        = 0.0);
+
+  /** Distance metric used for retrieval */
+  cuvs::distance::DistanceType metric() const noexcept { return metric_; }
+
+  /** Metric argument */
+  T metric_arg() const noexcept { return metric_arg_; }
+
+  /** Total length of the index (number of vectors). */
+  size_t size() const noexcept { return dataset_view_.extent(0); }
+
+  /** Dimensionality of the data. */
+  size_t dim() const noexcept { return dataset_view_.extent(1); }
+
+  /** Dataset [size, dim] */
+  raft::host_matrix_view<const T, int64_t, raft::row_major> dataset() const noexcept
+  {
+    return dataset_view_;
+  }
+
+  /** Dataset norms */
+  raft::host_vector_view<const T, int64_t> norms() const
+  {
+    return raft::make_const_mdspan(norms_.value().view());
+  }
+
+  /** Whether ot not this index has dataset norms */
+  inline bool has_norms() const noexcept { return norms_.has_value(); }
+
+ private:
+  cuvs::distance::DistanceType metric_;
+  raft::host_matrix_view<const T, int64_t, raft::row_major> dataset_view_;
+  std::optional<raft::host_vector<T, int64_t>> norms_;
+  T metric_arg_;
+};
 /**
  * @}
  */
@@ -200,6 +272,163 @@ void search(raft::resources const& handle,
             raft::device_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
             raft::device_matrix_view<float, int64_t, raft::row_major> distances,
             std::optional<cuvs::core::bitmap_view<const uint32_t, int64_t>> sample_filter);
+
+/**
+ * @brief Search a host index on the CPU.
+ *
+ * Exact search, meant as a baseline for recall checks and for small collections. The queries
+ * and the dataset are processed in tiles sized for the CPU caches; the inner products of a tile
+ * are computed with SIMD kernels selected at run time (AVX2, AVX-512 or NEON, where available)
+ * and the top-k of every query are selected while the tile is in cache. Supported metrics:
+ * L2 (expanded and unexpanded, with or without square root), inner product, cosine, L1 and Linf.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   auto metric = cuvs::distance::DistanceType::L2Expanded;
+ *   brute_force::host_index<float> index(handle, dataset, metric);
+ *   brute_force::search(handle, index, queries, out_inds, out_dists);
+ * @endcode
+ *
+ * @param[in] handle
+ * @param[in] index brute force index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& handle,
+            const cuvs::neighbors::brute_force::host_index<float>& index,
+            raft::host_matrix_view<const float, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+/**
+ * @}
+ */
+
+/**
+ * @defgroup bruteforce_cpp_index_serialize Bruteforce index serialize
+ * @{
+ */
+/**
+ * Save the index to file.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/brute_force.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * // create an index with `auto index = brute_force::build(...);`
+ * cuvs::neighbors::brute_force::serialize_file(handle, filename, index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index brute force index
+ * @param[in] compression compression of the dataset
+ *
+ */
+void serialize_file(raft::resources const& handle,
+                    const std::string& filename,
+                    const cuvs::neighbors::brute_force::index<float>& index,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
+
+/**
+ * Write the index to an output string.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[out] str output string
+ * @param[in] index brute force index
+ * @param[in] compression compression of the dataset
+ *
+ */
+void serialize(raft::resources const& handle,
+               std::string& str,
+               const cuvs::neighbors::brute_force::index<float>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
+
+/**
+ * Write the index to an output stream, which need not be seekable.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] os output stream
+ * @param[in] index brute force index
+ * @param[in] compression compression of the dataset
+ *
+ */
+void serialize(raft::resources const& handle,
+               std::ostream& os,
+               const cuvs::neighbors::brute_force::index<float>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
+
+/**
+ * Load index from file.
+ *
+ * The loaded index owns a device copy of the dataset.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/brute_force.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * brute_force::index<float> index(handle);
+ * cuvs::neighbors::brute_force::deserialize_file(handle, filename, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index brute force index
+ *
+ */
+void deserialize_file(raft::resources const& handle,
+                      const std::string& filename,
+                      cuvs::neighbors::brute_force::index<float>* index);
+
+/**
+ * Load index from input string.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] str input string
+ * @param[out] index brute force index
+ *
+ */
+void deserialize(raft::resources const& handle,
+                 const std::string& str,
+                 cuvs::neighbors::brute_force::index<float>* index);
+
+/**
+ * Load index from an input stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] is input stream
+ * @param[out] index brute force index
+ *
+ */
+void deserialize(raft::resources const& handle,
+                 std::istream& is,
+                 cuvs::neighbors::brute_force::index<float>* index);
 /**
  * @}
  */
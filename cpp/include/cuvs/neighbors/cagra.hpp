@@ -30,6 +30,7 @@
 #include <raft/util/integer_utils.hpp>
 #include <rmm/cuda_stream_view.hpp>
 
+#include <memory>
 #include <optional>
 #include <variant>
 
@@ -50,6 +51,22 @@ struct ivf_pq_params {
   cuvs::neighbors::ivf_pq::index_params build_params;
   cuvs::neighbors::ivf_pq::search_params search_params;
   float refinement_rate;
+  /**
+   * Number of rows searched per batch of the graph build. The default (0) picks it from the free
+   * device and host memory.
+   */
+  size_t max_batch_size = 0;
+  /**
+   * Number of batches in flight in the graph build: while one batch is searched on the device,
+   * the previous ones are refined and written to the graph on the host (at least 2).
+   */
+  size_t n_pipeline_buffers = 4;
+  /**
+   * Number of host threads refining batches concurrently; the OpenMP threads are shared among
+   * them. The default (0) uses one thread per batch in flight that is not being searched or
+   * written.
+   */
+  size_t n_refine_threads = 0;
 
   ivf_pq_params() = default;
   /**
@@ -176,6 +193,22 @@ struct search_params : cuvs::neighbors::search_params {
 static_assert(std::is_aggregate_v<index_params>);
 static_assert(std::is_aggregate_v<search_params>);
 
+/**
+ * @defgroup cagra_cpp_extend_params CAGRA index extend parameters
+ * @{
+ */
+
+struct extend_params {
+  /** The new nodes are added in chunks of at most this many nodes; the nodes of a chunk are not
+   * linked to each other directly. Auto select when 0 (a tenth of the graph at each step). */
+  uint32_t max_chunk_size = 0;
+};
+
+/**
+ * @}
+ */
+static_assert(std::is_aggregate_v<extend_params>);
+
 /**
  * @defgroup cagra_cpp_index CAGRA index type
  * @{
@@ -415,6 +448,77 @@ struct index : cuvs::neighbors::index {
   raft::device_matrix_view<const IdxT, int64_t, raft::row_major> graph_view_;
   std::unique_ptr<neighbors::dataset<int64_t>> dataset_;
 };
+
+/**
+ * @brief A CAGRA index mapped from a file into host memory.
+ *
+ * The graph and the dataset are views into a read-only memory mapping of a file written by
+ * `serialize_mapped_file`; nothing is copied when the index is loaded and the pages are read
+ * from disk on first access. The mapping is released when the last copy of the object is
+ * destroyed.
+ *
+ * The views can be passed to the host search directly, or to `index::update_graph` and
+ * `index::update_dataset` to populate a GPU index with a single copy.
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the vector indices
+ */
+template <typename T, typename IdxT>
+struct mapped_index {
+ public:
+  mapped_index() = default;
+
+  /**
+   * Construct from views into a mapping; `mapping` keeps the memory alive.
+   *
+   * The dataset view has zero rows if the file does not contain the dataset.
+   */
+  mapped_index(std::shared_ptr<const void> mapping,
+               cuvs::distance::DistanceType metric,
+               raft::host_matrix_view<const IdxT, int64_t, raft::row_major> graph,
+               raft::host_matrix_view<const T, int64_t, raft::row_major> dataset)
+    : mapping_(std::move(mapping)), metric_(metric), graph_(graph), dataset_(dataset)
+  {
+  }
+
+  /** Distance metric of the index. */
+  [[nodiscard]] inline auto metric() const noexcept -> cuvs::distance::DistanceType
+  {
+    return metric_;
+  }
+  /** Total length of the index (number of vectors). */
+  [[nodiscard]] inline auto size() const noexcept -> IdxT { return graph_.extent(0); }
+  /** Dimensionality of the data. */
+  [[nodiscard]] inline auto dim() const noexcept -> uint32_t { return dataset_.extent(1); }
+  /** Graph degree */
+  [[nodiscard]] inline auto graph_degree() const noexcept -> uint32_t
+  {
+    return graph_.extent(1);
+  }
+  /** Whether the file contains the dataset. */
+  [[nodiscard]] inline auto has_dataset() const noexcept -> bool
+  {
+    return dataset_.extent(0) > 0;
+  }
+  /** neighborhood graph [size, graph-degree] */
+  [[nodiscard]] inline auto graph() const noexcept
+    -> raft::host_matrix_view<const IdxT, int64_t, raft::row_major>
+  {
+    return graph_;
+  }
+  /** Dataset [size, dim], or [0, dim] if not included in the file. */
+  [[nodiscard]] inline auto dataset() const noexcept
+    -> raft::host_matrix_view<const T, int64_t, raft::row_major>
+  {
+    return dataset_;
+  }
+
+ private:
+  std::shared_ptr<const void> mapping_;
+  cuvs::distance::DistanceType metric_ = cuvs::distance::DistanceType::L2Expanded;
+  raft::host_matrix_view<const IdxT, int64_t, raft::row_major> graph_;
+  raft::host_matrix_view<const T, int64_t, raft::row_major> dataset_;
+};
 /**
  * @}
  */
@@ -643,6 +747,148 @@ auto build(raft::resources const& res,
  * @}
  */
 
+/**
+ * @defgroup cagra_cpp_index_optimize CAGRA graph optimization functions
+ * @{
+ */
+
+/**
+ * @brief Prune a kNN graph into a CAGRA graph.
+ *
+ * Decrease the number of neighbors of each node: the edges with the fewest 2-hop detours are
+ * kept, then some of them are replaced with reverse edges. The rows of `knn_graph` must be sorted
+ * by distance. The detour counting and the reverse graph run on the GPU.
+ *
+ * @param[in] res raft resources
+ * @param[in] knn_graph a matrix view (host or device) of the input knn graph [n_rows,
+ * knn_graph_degree]
+ * @param[out] new_graph a host matrix view of the optimized knn graph [n_rows, graph_degree]
+ */
+void optimize(raft::resources const& res,
+              raft::device_matrix_view<uint32_t, int64_t, raft::row_major> knn_graph,
+              raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph);
+void optimize(raft::resources const& res,
+              raft::host_matrix_view<uint32_t, int64_t, raft::row_major> knn_graph,
+              raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph);
+
+/**
+ * @brief Prune a kNN graph into a CAGRA graph on the host, without a GPU.
+ *
+ * Same as `optimize`, with all the steps multithreaded on the CPU, so that kNN graphs from any
+ * source (e.g. NN-descent or an external tool) can be converted on machines without a GPU. The
+ * result is deterministic; it may differ from the GPU result only in the order in which the
+ * reverse edges of a node are considered.
+ *
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // a kNN graph [n_rows, 128] sorted by distance, built by any means
+ *   auto knn_graph = raft::make_host_matrix<uint32_t, int64_t>(n_rows, 128);
+ *   auto graph     = raft::make_host_matrix<uint32_t, int64_t>(n_rows, 64);
+ *   cagra::optimize_host(res, raft::make_const_mdspan(knn_graph.view()), graph.view());
+ * @endcode
+ *
+ * @param[in] res raft resources
+ * @param[in] knn_graph a host matrix view of the input knn graph [n_rows, knn_graph_degree]
+ * @param[out] new_graph a host matrix view of the optimized knn graph [n_rows, graph_degree]
+ */
+void optimize_host(raft::resources const& res,
+                   raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> knn_graph,
+                   raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph);
+/**
+ * @}
+ */
+
+/**
+ * @defgroup cagra_cpp_index_extend CAGRA extend functions
+ * @{
+ */
+
+/**
+ * @brief Add new rows to a CAGRA graph on the host, without rebuilding it.
+ *
+ * The first `graph.extent(0)` rows of `dataset` are the rows of `graph`, the others are added to
+ * it. The new nodes are added in chunks (see `extend_params`): the neighbors of each new node are
+ * searched in the graph of the nodes before it and pruned like `optimize` prunes a kNN graph,
+ * which gives the row of the node. Then the new node is patched as a reverse edge into the rows
+ * of its closest neighbors, with the rule of `optimize`: the first half of every row is kept, and
+ * the reverse edge is moved to the front of the second half, evicting the last edge of the row.
+ *
+ * The search and the pruning run in parallel using OpenMP. Extending a graph by a small fraction
+ * of its size gives a graph of about the same recall as building it from scratch.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // the rows of the graph followed by the new rows
+ *   auto dataset   = raft::make_host_matrix<float, int64_t>(n_rows + n_new_rows, dim);
+ *   auto new_graph = raft::make_host_matrix<uint32_t, int64_t>(n_rows + n_new_rows, graph_degree);
+ *   ...
+ *   cagra::extend(res, cagra::extend_params{}, cuvs::distance::DistanceType::L2Expanded,
+ *                 raft::make_const_mdspan(dataset.view()), graph, new_graph.view());
+ * @endcode
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the extension
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to the rows of the graph followed by the new rows
+ * [n_rows + n_new_rows, dim]
+ * @param[in] graph a host matrix view to the graph of the first rows [n_rows, graph_degree]
+ * @param[out] new_graph a host matrix view to the graph of all the rows
+ * [n_rows + n_new_rows, graph_degree]
+ */
+void extend(raft::resources const& res,
+            cuvs::neighbors::cagra::extend_params const& params,
+            cuvs::distance::DistanceType metric,
+            raft::host_matrix_view<const float, int64_t, raft::row_major> dataset,
+            raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+            raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph);
+
+/**
+ * @brief Add new rows to a CAGRA graph on the host.
+ *
+ * See the host [cagra::extend](#cagra::extend) overload for `float` for details.
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the extension
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to the rows of the graph followed by the new rows
+ * [n_rows + n_new_rows, dim]
+ * @param[in] graph a host matrix view to the graph of the first rows [n_rows, graph_degree]
+ * @param[out] new_graph a host matrix view to the graph of all the rows
+ * [n_rows + n_new_rows, graph_degree]
+ */
+void extend(raft::resources const& res,
+            cuvs::neighbors::cagra::extend_params const& params,
+            cuvs::distance::DistanceType metric,
+            raft::host_matrix_view<const int8_t, int64_t, raft::row_major> dataset,
+            raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+            raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph);
+
+/**
+ * @brief Add new rows to a CAGRA graph on the host.
+ *
+ * See the host [cagra::extend](#cagra::extend) overload for `float` for details.
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the extension
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to the rows of the graph followed by the new rows
+ * [n_rows + n_new_rows, dim]
+ * @param[in] graph a host matrix view to the graph of the first rows [n_rows, graph_degree]
+ * @param[out] new_graph a host matrix view to the graph of all the rows
+ * [n_rows + n_new_rows, graph_degree]
+ */
+void extend(raft::resources const& res,
+            cuvs::neighbors::cagra::extend_params const& params,
+            cuvs::distance::DistanceType metric,
+            raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> dataset,
+            raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+            raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph);
+
+/**
+ * @}
+ */
+
 /**
  * @defgroup cagra_cpp_index_search CAGRA search functions
  * @{
@@ -719,6 +965,204 @@ void search(raft::resources const& res,
             raft::device_matrix_view<const uint8_t, int64_t, raft::row_major> queries,
             raft::device_matrix_view<uint32_t, int64_t, raft::row_major> neighbors,
             raft::device_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search a CAGRA graph on the host.
+ *
+ * The graph and the dataset are given as host matrix views, for example the ones of an index
+ * that was deserialized to host memory, so that no GPU is needed. The search follows the same
+ * algorithm as the single-CTA GPU search and interprets `params` the same way (`itopk_size`,
+ * `search_width`, `min_iterations`, `max_iterations`, `hashmap_mode`, `hashmap_min_bitlen`,
+ * `hashmap_max_fill_rate`, `num_random_samplings`, `rand_xor_mask`); the remaining fields only
+ * concern the GPU kernels and are ignored. The queries are processed in parallel using OpenMP.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // host copies of the index data
+ *   auto graph   = raft::make_host_matrix<uint32_t, int64_t>(n_rows, graph_degree);
+ *   auto dataset = raft::make_host_matrix<float, int64_t>(n_rows, dim);
+ *   ...
+ *   cagra::search_params search_params;
+ *   cagra::search(res, search_params, cuvs::distance::DistanceType::L2Expanded,
+ *                 raft::make_const_mdspan(dataset.view()), raft::make_const_mdspan(graph.view()),
+ *                 queries, neighbors, distances);
+ * @endcode
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the search
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to a row-major matrix [n_rows, dim]
+ * @param[in] graph a host matrix view to the search graph [n_rows, graph_degree]
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, dim]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& res,
+            cuvs::neighbors::cagra::search_params const& params,
+            cuvs::distance::DistanceType metric,
+            raft::host_matrix_view<const float, int64_t, raft::row_major> dataset,
+            raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+            raft::host_matrix_view<const float, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<uint32_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search a CAGRA graph on the host.
+ *
+ * See the host [cagra::search](#cagra::search) overload for `float` for details.
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the search
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to a row-major matrix [n_rows, dim]
+ * @param[in] graph a host matrix view to the search graph [n_rows, graph_degree]
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, dim]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& res,
+            cuvs::neighbors::cagra::search_params const& params,
+            cuvs::distance::DistanceType metric,
+            raft::host_matrix_view<const int8_t, int64_t, raft::row_major> dataset,
+            raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+            raft::host_matrix_view<const int8_t, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<uint32_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search a CAGRA graph on the host.
+ *
+ * See the host [cagra::search](#cagra::search) overload for `float` for details.
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the search
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to a row-major matrix [n_rows, dim]
+ * @param[in] graph a host matrix view to the search graph [n_rows, graph_degree]
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, dim]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& res,
+            cuvs::neighbors::cagra::search_params const& params,
+            cuvs::distance::DistanceType metric,
+            raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> dataset,
+            raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+            raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<uint32_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search a CAGRA graph on the host with the given filter.
+ *
+ * The rows rejected by the filter are never returned. The admitted rows are counted first: when
+ * the filter admits fewer rows than the graph search would visit, or so few that the search would
+ * be unlikely to meet k of them, the admitted rows are scanned exactly instead, which makes the
+ * search exact and its cost proportional to the number of admitted rows. Otherwise the graph is
+ * searched through all the nodes, and the best admitted nodes met on the way are returned.
+ *
+ * See the host [cagra::search](#cagra::search) overload for `float` for the other parameters.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // a bitset in host memory, bit i set if row i may be returned
+ *   std::vector<uint32_t> bits(raft::ceildiv<int64_t>(n_rows, 32));
+ *   ...
+ *   cuvs::core::bitset_view<uint32_t, int64_t> bitset(bits.data(), n_rows);
+ *   cagra::search_with_filtering(res, search_params, metric, dataset, graph,
+ *                                queries, neighbors, distances,
+ *                                filtering::bitset_filter<uint32_t, int64_t>(bitset));
+ * @endcode
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the search
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to a row-major matrix [n_rows, dim]
+ * @param[in] graph a host matrix view to the search graph [n_rows, graph_degree]
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, dim]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& res,
+  cuvs::neighbors::cagra::search_params const& params,
+  cuvs::distance::DistanceType metric,
+  raft::host_matrix_view<const float, int64_t, raft::row_major> dataset,
+  raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+  raft::host_matrix_view<const float, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<uint32_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search a CAGRA graph on the host with the given filter.
+ *
+ * See the host [cagra::search_with_filtering](#cagra::search_with_filtering) overload for `float`.
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the search
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to a row-major matrix [n_rows, dim]
+ * @param[in] graph a host matrix view to the search graph [n_rows, graph_degree]
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, dim]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& res,
+  cuvs::neighbors::cagra::search_params const& params,
+  cuvs::distance::DistanceType metric,
+  raft::host_matrix_view<const int8_t, int64_t, raft::row_major> dataset,
+  raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+  raft::host_matrix_view<const int8_t, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<uint32_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search a CAGRA graph on the host with the given filter.
+ *
+ * See the host [cagra::search_with_filtering](#cagra::search_with_filtering) overload for `float`.
+ *
+ * @param[in] res raft resources
+ * @param[in] params configure the search
+ * @param[in] metric the distance of the index (L2Expanded or InnerProduct)
+ * @param[in] dataset a host matrix view to a row-major matrix [n_rows, dim]
+ * @param[in] graph a host matrix view to the search graph [n_rows, graph_degree]
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, dim]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& res,
+  cuvs::neighbors::cagra::search_params const& params,
+  cuvs::distance::DistanceType metric,
+  raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> dataset,
+  raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> graph,
+  raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<uint32_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
 /**
  * @}
  */
@@ -730,7 +1174,9 @@ void search(raft::resources const& res,
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
                     const cuvs::neighbors::cagra::index<float, uint32_t>& index,
-                    bool include_dataset = true);
+                    bool include_dataset = true,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
 
 void deserialize_file(raft::resources const& handle,
                       const std::string& filename,
@@ -738,16 +1184,136 @@ void deserialize_file(raft::resources const& handle,
 void serialize(raft::resources const& handle,
                std::string& str,
                const cuvs::neighbors::cagra::index<float, uint32_t>& index,
-               bool include_dataset = true);
+               bool include_dataset = true,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
 
 void deserialize(raft::resources const& handle,
                  const std::string& str,
                  cuvs::neighbors::cagra::index<float, uint32_t>* index);
 
+/**
+ * Save the index in the mapped file layout.
+ *
+ * The file starts with a versioned header followed by the graph and the (unpadded) dataset, each
+ * section starting at a page-aligned offset, so that `deserialize_mapped_file` can map it without
+ * copying. The data is staged through host memory in fixed-size chunks.
+ *
+ * @code{.cpp}
+ *   // build an index
+ *   auto index = cagra::build(res, index_params, dataset);
+ *   cagra::serialize_mapped_file(res, "/path/to/index", index);
+ *   // ... later, possibly on a machine without a GPU
+ *   cagra::mapped_index<float, uint32_t> mapped;
+ *   cagra::deserialize_mapped_file(res, "/path/to/index", &mapped);
+ *   cagra::search(res, search_params, mapped.metric(), mapped.dataset(), mapped.graph(),
+ *                 queries, neighbors, distances);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index CAGRA index
+ * @param[in] include_dataset Whether or not to write out the dataset to the file.
+ */
+void serialize_mapped_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::cagra::index<float, uint32_t>& index,
+                           bool include_dataset = true);
+
+/**
+ * Map an index saved by `serialize_mapped_file` into host memory.
+ *
+ * Only the header is read; the graph and dataset views point into the mapping. The file must
+ * not be modified while it is mapped.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index the mapped index
+ */
+void deserialize_mapped_file(raft::resources const& handle,
+                             const std::string& filename,
+                             cuvs::neighbors::cagra::mapped_index<float, uint32_t>* index);
+
+/**
+ * Save the index in the hnswlib serialized format.
+ *
+ * The CAGRA graph becomes the base layer. The upper layers are built on the host like hnswlib
+ * builds them, over the rows sampled with the hnswlib level distribution (M = graph_degree / 2),
+ * and the entry point is the row of the top level. Only L2 and inner product metrics are
+ * supported.
+ *
+ * The level-0 records are assembled in parallel in large chunks; the graph and dataset are
+ * streamed from the device in batches, so the whole index is never copied to the host.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index CAGRA index (must include the dataset)
+ */
+void serialize_to_hnswlib_file(raft::resources const& handle,
+                               const std::string& filename,
+                               const cuvs::neighbors::cagra::index<float, uint32_t>& index);
+void serialize_to_hnswlib(raft::resources const& handle,
+                          std::string& str,
+                          const cuvs::neighbors::cagra::index<float, uint32_t>& index);
+
+/**
+ * Save a host-resident or memory-mapped index in the hnswlib serialized format.
+ *
+ * The output is the same as for a GPU index (see above), but the graph and the dataset are read
+ * directly from the host views and the GPU is not used. A `mapped_index` can also wrap graph and
+ * dataset arrays that already live in host memory.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index mapped CAGRA index (must include the dataset)
+ */
+void serialize_to_hnswlib_file(raft::resources const& handle,
+                               const std::string& filename,
+                               const cuvs::neighbors::cagra::mapped_index<float, uint32_t>& index);
+void serialize_to_hnswlib(raft::resources const& handle,
+                          std::string& str,
+                          const cuvs::neighbors::cagra::mapped_index<float, uint32_t>& index);
+
+/**
+ * Import an index saved in the hnswlib serialized format.
+ *
+ * The hnswlib base layer becomes the CAGRA graph and its vectors the dataset; the upper layers
+ * are not used. The neighbor lists are sorted by distance, padded with neighbors of neighbors
+ * where they are shorter than the graph degree, and pruned to `params.graph_degree` with
+ * `optimize`. Deleted elements are dropped and the rows are ordered by hnswlib label, so the row
+ * ids are the labels when those are 0..n-1.
+ *
+ * @code{.cpp}
+ *   cagra::index_params params;
+ *   params.metric       = cuvs::distance::DistanceType::L2Expanded;  // as in the hnswlib index
+ *   params.graph_degree = 32;
+ *   cagra::index<float, uint32_t> index(res);
+ *   cagra::deserialize_from_hnswlib_file(res, "/path/to/index.hnsw", params, &index);
+ *   // save it as a CAGRA index if needed
+ *   cagra::serialize_file(res, "/path/to/index", index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the hnswlib index
+ * @param[in] params the metric of the hnswlib index (L2 or inner product) and the graph degree;
+ *   the other parameters are not used
+ * @param[out] index the CAGRA index
+ */
+void deserialize_from_hnswlib_file(raft::resources const& handle,
+                                   const std::string& filename,
+                                   const cuvs::neighbors::cagra::index_params& params,
+                                   cuvs::neighbors::cagra::index<float, uint32_t>* index);
+void deserialize_from_hnswlib(raft::resources const& handle,
+                              const std::string& str,
+                              const cuvs::neighbors::cagra::index_params& params,
+                              cuvs::neighbors::cagra::index<float, uint32_t>* index);
+
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
                     const cuvs::neighbors::cagra::index<int8_t, uint32_t>& index,
-                    bool include_dataset = true);
+                    bool include_dataset = true,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
 
 void deserialize_file(raft::resources const& handle,
                       const std::string& filename,
@@ -755,16 +1321,52 @@ void deserialize_file(raft::resources const& handle,
 void serialize(raft::resources const& handle,
                std::string& str,
                const cuvs::neighbors::cagra::index<int8_t, uint32_t>& index,
-               bool include_dataset = true);
+               bool include_dataset = true,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
 
 void deserialize(raft::resources const& handle,
                  const std::string& str,
                  cuvs::neighbors::cagra::index<int8_t, uint32_t>* index);
 
+void serialize_mapped_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::cagra::index<int8_t, uint32_t>& index,
+                           bool include_dataset = true);
+
+void deserialize_mapped_file(raft::resources const& handle,
+                             const std::string& filename,
+                             cuvs::neighbors::cagra::mapped_index<int8_t, uint32_t>* index);
+
+void serialize_to_hnswlib_file(raft::resources const& handle,
+                               const std::string& filename,
+                               const cuvs::neighbors::cagra::index<int8_t, uint32_t>& index);
+void serialize_to_hnswlib(raft::resources const& handle,
+                          std::string& str,
+                          const cuvs::neighbors::cagra::index<int8_t, uint32_t>& index);
+
+void serialize_to_hnswlib_file(raft::resources const& handle,
+                               const std::string& filename,
+                               const cuvs::neighbors::cagra::mapped_index<int8_t, uint32_t>& index);
+void serialize_to_hnswlib(raft::resources const& handle,
+                          std::string& str,
+                          const cuvs::neighbors::cagra::mapped_index<int8_t, uint32_t>& index);
+
+void deserialize_from_hnswlib_file(raft::resources const& handle,
+                                   const std::string& filename,
+                                   const cuvs::neighbors::cagra::index_params& params,
+                                   cuvs::neighbors::cagra::index<int8_t, uint32_t>* index);
+void deserialize_from_hnswlib(raft::resources const& handle,
+                              const std::string& str,
+                              const cuvs::neighbors::cagra::index_params& params,
+                              cuvs::neighbors::cagra::index<int8_t, uint32_t>* index);
+
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
                     const cuvs::neighbors::cagra::index<uint8_t, uint32_t>& index,
-                    bool include_dataset = true);
+                    bool include_dataset = true,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
 
 void deserialize_file(raft::resources const& handle,
                       const std::string& filename,
@@ -772,11 +1374,46 @@ void deserialize_file(raft::resources const& handle,
 void serialize(raft::resources const& handle,
                std::string& str,
                const cuvs::neighbors::cagra::index<uint8_t, uint32_t>& index,
-               bool include_dataset = true);
+               bool include_dataset = true,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
 
 void deserialize(raft::resources const& handle,
                  const std::string& str,
                  cuvs::neighbors::cagra::index<uint8_t, uint32_t>* index);
+
+void serialize_mapped_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::cagra::index<uint8_t, uint32_t>& index,
+                           bool include_dataset = true);
+
+void deserialize_mapped_file(raft::resources const& handle,
+                             const std::string& filename,
+                             cuvs::neighbors::cagra::mapped_index<uint8_t, uint32_t>* index);
+
+void serialize_to_hnswlib_file(raft::resources const& handle,
+                               const std::string& filename,
+                               const cuvs::neighbors::cagra::index<uint8_t, uint32_t>& index);
+void serialize_to_hnswlib(raft::resources const& handle,
+                          std::string& str,
+                          const cuvs::neighbors::cagra::index<uint8_t, uint32_t>& index);
+
+void serialize_to_hnswlib_file(
+  raft::resources const& handle,
+  const std::string& filename,
+  const cuvs::neighbors::cagra::mapped_index<uint8_t, uint32_t>& index);
+void serialize_to_hnswlib(raft::resources const& handle,
+                          std::string& str,
+                          const cuvs::neighbors::cagra::mapped_index<uint8_t, uint32_t>& index);
+
+void deserialize_from_hnswlib_file(raft::resources const& handle,
+                                   const std::string& filename,
+                                   const cuvs::neighbors::cagra::index_params& params,
+                                   cuvs::neighbors::cagra::index<uint8_t, uint32_t>* index);
+void deserialize_from_hnswlib(raft::resources const& handle,
+                              const std::string& str,
+                              const cuvs::neighbors::cagra::index_params& params,
+                              cuvs::neighbors::cagra::index<uint8_t, uint32_t>* index);
 /**
  * @}
  */
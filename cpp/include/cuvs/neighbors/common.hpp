@@ -103,6 +103,23 @@ struct index_params {
 
 struct search_params {};
 
+/**
+ * Compression of the bulk data of a serialized index: the lists of the IVF indexes, the graph and
+ * the dataset of CAGRA.
+ *
+ * The compression is lossless and applies to the files and strings written by `serialize`; the
+ * readers detect it.
+ */
+enum class serialize_compression {
+  /** Store the data as is. */
+  NONE = 0,
+  /**
+   * Delta-varint coding of the graph rows, byte shuffling and LZ77 compression of the vectors.
+   * Trades serialization speed for size, most effectively on the graphs and the integer data.
+   */
+  LOSSLESS = 1,
+};
+
 /** @} */  // end group neighbors_index
 
 /** Two-dimensional dataset; maybe owning, maybe compressed, maybe strided. */
@@ -597,6 +614,40 @@ enable_if_valid_list_t<ListT> deserialize_list(const raft::resources& handle,
                                                const typename ListT::spec_type& store_spec,
                                                const typename ListT::spec_type& device_spec);
 
+/**
+ * Source of the lists of a host IVF index loaded on demand (see `host_load_params::lazy_lists`).
+ *
+ * @tparam ListT the content of a list in host memory
+ */
+template <typename ListT>
+struct host_list_loader {
+  virtual ~host_list_loader() = default;
+
+  /**
+   * Get a list, loading it if it is not resident. The list stays in memory at least as long as the
+   * returned pointer; the pointer is null for empty lists.
+   */
+  virtual auto get(uint32_t label) -> std::shared_ptr<const ListT> = 0;
+
+  /** Memory taken by the lists kept resident by the loader, in bytes. */
+  [[nodiscard]] virtual auto resident_bytes() const -> size_t = 0;
+};
+
+/** Parameters of loading a host IVF index from a file. */
+struct host_load_params {
+  /**
+   * Load every list when the list is first probed rather than loading all lists upfront. Only the
+   * quantizers, the list sizes and the table of contents of the file stay in memory; the file must
+   * stay in place while the index is in use.
+   */
+  bool lazy_lists = false;
+  /**
+   * With `lazy_lists`, the memory cap of the resident lists, in bytes. Beyond it, the least
+   * recently used lists are dropped from memory, except for the lists currently being scanned.
+   */
+  size_t max_resident_list_bytes = size_t(4) << 30;
+};
+
 }  // namespace ivf
 
 };  // namespace cuvs::neighbors
@@ -19,9 +19,16 @@
 #include "common.hpp"
 #include <cstdint>
 #include <cuvs/neighbors/common.hpp>
+#include <raft/core/error.hpp>
 #include <raft/core/host_mdarray.hpp>
 #include <raft/core/host_mdspan.hpp>
 
+#include <algorithm>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
 namespace cuvs::neighbors::ivf_flat {
 /**
  * @defgroup ivf_flat_cpp_index_params IVF-Flat index build parameters
@@ -275,6 +282,178 @@ struct index : cuvs::neighbors::index {
     return veclen;
   }
 };
+
+/**
+ * @brief An IVF-Flat index in host memory, searchable on the CPU.
+ *
+ * The lists keep the interleaved layout of `index::data` (see the `index` documentation), padded
+ * to a multiple of `kIndexGroupSize` rows, so that the host search can scan them group by group.
+ * A host index is loaded from the serialized form of a GPU index (see `deserialize_host_file`),
+ * either entirely or with lists loaded when first probed (`ivf::host_load_params::lazy_lists`).
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the indices in the source dataset
+ */
+template <typename T, typename IdxT>
+struct host_index {
+ public:
+  /** The content of a list. */
+  struct list_type {
+    /** Interleaved data [round_up(list size, kIndexGroupSize) * dim]. */
+    std::vector<T> data;
+    /** Source indices of the vectors [list size]. */
+    std::vector<IdxT> indices;
+  };
+  using list_loader_type = ivf::host_list_loader<list_type>;
+
+  host_index() = default;
+
+  /** Construct an index with `n_lists` empty lists. */
+  host_index(cuvs::distance::DistanceType metric, uint32_t n_lists, uint32_t dim)
+    : metric_(metric),
+      dim_(dim),
+      veclen_(calculate_veclen(dim)),
+      centers_(size_t(n_lists) * dim),
+      list_sizes_(n_lists, 0),
+      lists_(n_lists),
+      inds_ptrs_(n_lists, nullptr)
+  {
+  }
+
+  /** Distance metric used for clustering. */
+  [[nodiscard]] inline auto metric() const noexcept -> cuvs::distance::DistanceType
+  {
+    return metric_;
+  }
+  /** Dimensionality of the data. */
+  [[nodiscard]] inline auto dim() const noexcept -> uint32_t { return dim_; }
+  /** Number of clusters/inverted lists. */
+  [[nodiscard]] inline auto n_lists() const noexcept -> uint32_t { return list_sizes_.size(); }
+  /** Interleaving chunk length of the list data, the same as `index::veclen`. */
+  [[nodiscard]] inline auto veclen() const noexcept -> uint32_t { return veclen_; }
+  /** Total length of the index. */
+  [[nodiscard]] inline auto size() const noexcept -> IdxT
+  {
+    IdxT total = 0;
+    for (auto s : list_sizes_) {
+      total += s;
+    }
+    return total;
+  }
+
+  /** k-means cluster centers corresponding to the lists [n_lists, dim] */
+  [[nodiscard]] inline auto centers() noexcept
+    -> raft::host_matrix_view<float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<float, uint32_t>(centers_.data(), n_lists(), dim_);
+  }
+  [[nodiscard]] inline auto centers() const noexcept
+    -> raft::host_matrix_view<const float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<const float, uint32_t>(centers_.data(), n_lists(), dim_);
+  }
+
+  /** Sizes of the lists (clusters) [n_lists] */
+  [[nodiscard]] inline auto list_sizes() const noexcept
+    -> raft::host_vector_view<const uint32_t, uint32_t>
+  {
+    return raft::make_host_vector_view<const uint32_t, uint32_t>(list_sizes_.data(), n_lists());
+  }
+
+  /**
+   * Get a list, loading it first if the lists are loaded on demand. The list stays in memory at
+   * least as long as the returned pointer; the pointer is null for empty lists.
+   */
+  [[nodiscard]] inline auto list(uint32_t label) const -> std::shared_ptr<const list_type>
+  {
+    return loader_ ? loader_->get(label) : lists_[label];
+  }
+  /** Whether the lists are loaded on demand. */
+  [[nodiscard]] inline auto lazy_lists() const noexcept -> bool { return loader_ != nullptr; }
+  /** The loader of the lists loaded on demand, if any. */
+  [[nodiscard]] inline auto list_loader() const noexcept -> const list_loader_type*
+  {
+    return loader_.get();
+  }
+
+  /**
+   * Interleaved data of a list [round_up(list size, kIndexGroupSize) * dim].
+   *
+   * Null for the lists loaded on demand, see `list`.
+   */
+  [[nodiscard]] inline auto list_data(uint32_t label) const noexcept -> const T*
+  {
+    return lists_[label] ? lists_[label]->data.data() : nullptr;
+  }
+  /** Source indices of the vectors of a list [list size]; null for the lists loaded on demand. */
+  [[nodiscard]] inline auto list_indices(uint32_t label) const noexcept -> const IdxT*
+  {
+    return lists_[label] ? lists_[label]->indices.data() : nullptr;
+  }
+  /**
+   * Pointers to the source indices of the lists [n_lists], as used by `ivf_to_sample_filter`; null
+   * for the lists loaded on demand.
+   */
+  [[nodiscard]] inline auto inds_ptrs() const noexcept
+    -> raft::host_vector_view<const IdxT* const, uint32_t>
+  {
+    return raft::make_host_vector_view<const IdxT* const, uint32_t>(inds_ptrs_.data(), n_lists());
+  }
+
+  /**
+   * Set the content of a list.
+   *
+   * @param label the list
+   * @param size number of vectors in the list
+   * @param data interleaved data, at least `round_up(size, kIndexGroupSize) * dim` elements
+   * @param indices source indices of the vectors, at least `size` elements
+   */
+  void set_list(uint32_t label, uint32_t size, std::vector<T>&& data, std::vector<IdxT>&& indices)
+  {
+    RAFT_EXPECTS(label < n_lists(), "List label %u is out of range", label);
+    RAFT_EXPECTS(!loader_, "The lists of the index are loaded on demand");
+    RAFT_EXPECTS(data.size() >= raft::round_up_safe<size_t>(size, kIndexGroupSize) * dim_,
+                 "The list data is smaller than the padded list size");
+    RAFT_EXPECTS(indices.size() >= size, "The list indices are smaller than the list size");
+    auto list          = std::make_shared<list_type>();
+    list->data         = std::move(data);
+    list->indices      = std::move(indices);
+    list_sizes_[label] = size;
+    inds_ptrs_[label]  = list->indices.data();
+    lists_[label]      = std::move(list);
+  }
+
+  /**
+   * Load the lists on demand from `loader`, with the given sizes; the lists set before are
+   * dropped.
+   */
+  void set_list_loader(std::shared_ptr<list_loader_type> loader, std::vector<uint32_t> list_sizes)
+  {
+    RAFT_EXPECTS(list_sizes.size() == n_lists(), "Expected %u list sizes", n_lists());
+    list_sizes_ = std::move(list_sizes);
+    std::fill(lists_.begin(), lists_.end(), nullptr);
+    std::fill(inds_ptrs_.begin(), inds_ptrs_.end(), nullptr);
+    loader_ = std::move(loader);
+  }
+
+ private:
+  cuvs::distance::DistanceType metric_ = cuvs::distance::DistanceType::L2Expanded;
+  uint32_t dim_                        = 0;
+  uint32_t veclen_                     = 1;
+  std::vector<float> centers_;
+  std::vector<uint32_t> list_sizes_;
+  std::vector<std::shared_ptr<const list_type>> lists_;
+  std::vector<const IdxT*> inds_ptrs_;
+  std::shared_ptr<list_loader_type> loader_;
+
+  /** The same as `index::calculate_veclen`: the data layout must match the GPU index. */
+  static auto calculate_veclen(uint32_t dim) -> uint32_t
+  {
+    uint32_t veclen = std::max<uint32_t>(1, 16 / sizeof(T));
+    if (dim % veclen != 0) { veclen = 1; }
+    return veclen;
+  }
+};
 /**
  * @}
  */
@@ -1174,6 +1353,183 @@ void search_with_filtering(
   raft::device_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
   raft::device_matrix_view<float, int64_t, raft::row_major> distances,
   cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search ANN using a host index on the CPU.
+ *
+ * The cluster centers are compared with the queries using SIMD kernels selected at run time
+ * (AVX2, AVX-512 or NEON, where available), and the `n_probes` closest lists are scanned
+ * directly in their interleaved layout. The queries are processed in parallel with OpenMP; with
+ * fewer queries than threads, the lists probed by each query are scanned in parallel instead.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // load an index saved with `ivf_flat::serialize_file`
+ *   ivf_flat::host_index<float, int64_t> index;
+ *   ivf_flat::deserialize_host_file(handle, filename, &index);
+ *   ivf_flat::search_params search_params;
+ *   ivf_flat::search(handle, search_params, index, queries, out_inds, out_dists);
+ * @endcode
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] index ivf-flat index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& handle,
+            const cuvs::neighbors::ivf_flat::search_params& params,
+            const cuvs::neighbors::ivf_flat::host_index<float, int64_t>& index,
+            raft::host_matrix_view<const float, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search ANN using a host index on the CPU with the given filter.
+ *
+ * See the host `ivf_flat::search` for details.
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] idx ivf-flat index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& handle,
+  const search_params& params,
+  const host_index<float, int64_t>& idx,
+  raft::host_matrix_view<const float, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search ANN using a host index on the CPU.
+ *
+ * The cluster centers are compared with the queries using SIMD kernels selected at run time
+ * (AVX2, AVX-512 or NEON, where available), and the `n_probes` closest lists are scanned
+ * directly in their interleaved layout. The queries are processed in parallel with OpenMP; with
+ * fewer queries than threads, the lists probed by each query are scanned in parallel instead.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // load an index saved with `ivf_flat::serialize_file`
+ *   ivf_flat::host_index<int8_t, int64_t> index;
+ *   ivf_flat::deserialize_host_file(handle, filename, &index);
+ *   ivf_flat::search_params search_params;
+ *   ivf_flat::search(handle, search_params, index, queries, out_inds, out_dists);
+ * @endcode
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] index ivf-flat index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& handle,
+            const cuvs::neighbors::ivf_flat::search_params& params,
+            const cuvs::neighbors::ivf_flat::host_index<int8_t, int64_t>& index,
+            raft::host_matrix_view<const int8_t, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search ANN using a host index on the CPU with the given filter.
+ *
+ * See the host `ivf_flat::search` for details.
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] idx ivf-flat index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& handle,
+  const search_params& params,
+  const host_index<int8_t, int64_t>& idx,
+  raft::host_matrix_view<const int8_t, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search ANN using a host index on the CPU.
+ *
+ * The cluster centers are compared with the queries using SIMD kernels selected at run time
+ * (AVX2, AVX-512 or NEON, where available), and the `n_probes` closest lists are scanned
+ * directly in their interleaved layout. The queries are processed in parallel with OpenMP; with
+ * fewer queries than threads, the lists probed by each query are scanned in parallel instead.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // load an index saved with `ivf_flat::serialize_file`
+ *   ivf_flat::host_index<uint8_t, int64_t> index;
+ *   ivf_flat::deserialize_host_file(handle, filename, &index);
+ *   ivf_flat::search_params search_params;
+ *   ivf_flat::search(handle, search_params, index, queries, out_inds, out_dists);
+ * @endcode
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] index ivf-flat index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& handle,
+            const cuvs::neighbors::ivf_flat::search_params& params,
+            const cuvs::neighbors::ivf_flat::host_index<uint8_t, int64_t>& index,
+            raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search ANN using a host index on the CPU with the given filter.
+ *
+ * See the host `ivf_flat::search` for details.
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] idx ivf-flat index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& handle,
+  const search_params& params,
+  const host_index<uint8_t, int64_t>& idx,
+  raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
 /**
  * @}
  */
@@ -1203,11 +1559,14 @@ void search_with_filtering(
  * @param[in] handle the raft handle
  * @param[in] filename the file name for saving the index
  * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
-                    const cuvs::neighbors::ivf_flat::index<float, int64_t>& index);
+                    const cuvs::neighbors::ivf_flat::index<float, int64_t>& index,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Load index from file.
@@ -1257,11 +1616,14 @@ void deserialize_file(raft::resources const& handle,
  * @param[in] handle the raft handle
  * @param[out] str output string
  * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize(raft::resources const& handle,
                std::string& str,
-               const cuvs::neighbors::ivf_flat::index<float, int64_t>& index);
+               const cuvs::neighbors::ivf_flat::index<float, int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Load index from input string
@@ -1291,6 +1653,113 @@ void deserialize(raft::resources const& handle,
                  const std::string& str,
                  cuvs::neighbors::ivf_flat::index<float, int64_t>* index);
 
+/**
+ * Write the index to an output stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * The stream need not be seekable: a pipe or a socket can receive the index as it is written.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] os output stream
+ * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
+ *
+ */
+void serialize(raft::resources const& handle,
+               std::ostream& os,
+               const cuvs::neighbors::ivf_flat::index<float, int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
+
+/**
+ * Load an index from an input stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] is input stream
+ * @param[out] index IVF-Flat index
+ *
+ */
+void deserialize(raft::resources const& handle,
+                 std::istream& is,
+                 cuvs::neighbors::ivf_flat::index<float, int64_t>* index);
+
+/**
+ * Load an index from file into host memory, for the search on the CPU.
+ *
+ * The file is written by `serialize_file` from a GPU index; no GPU is needed to load it.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/ivf_flat.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * cuvs::neighbors::ivf_flat::host_index<float, int64_t> index;
+ * cuvs::neighbors::ivf_flat::deserialize_host_file(handle, filename, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           cuvs::neighbors::ivf_flat::host_index<float, int64_t>* index);
+
+/**
+ * Load an index from file into host memory, optionally with its lists loaded when first probed.
+ *
+ * With `params.lazy_lists`, the index keeps the file mapped and holds at most about
+ * `params.max_resident_list_bytes` of lists in memory, which lets the host search run over indexes
+ * larger than the memory. The file must have been written by this version of `serialize_file`.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ *
+ * raft::resources handle;
+ *
+ * cuvs::neighbors::ivf::host_load_params params;
+ * params.lazy_lists              = true;
+ * params.max_resident_list_bytes = size_t(1) << 30;
+ * cuvs::neighbors::ivf_flat::host_index<float, int64_t> index;
+ * cuvs::neighbors::ivf_flat::deserialize_host_file(handle, "/path/to/index", params, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[in] params how to load the lists
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::ivf::host_load_params& params,
+                           cuvs::neighbors::ivf_flat::host_index<float, int64_t>* index);
+
+/**
+ * Load an index from an input string into host memory, for the search on the CPU.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] str input string
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host(raft::resources const& handle,
+                      const std::string& str,
+                      cuvs::neighbors::ivf_flat::host_index<float, int64_t>* index);
+
 /**
  * Save the index to file.
  *
@@ -1311,11 +1780,14 @@ void deserialize(raft::resources const& handle,
  * @param[in] handle the raft handle
  * @param[in] filename the file name for saving the index
  * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
-                    const cuvs::neighbors::ivf_flat::index<int8_t, int64_t>& index);
+                    const cuvs::neighbors::ivf_flat::index<int8_t, int64_t>& index,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Load index from file.
@@ -1365,11 +1837,14 @@ void deserialize_file(raft::resources const& handle,
  * @param[in] handle the raft handle
  * @param[out] str output string
  * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize(raft::resources const& handle,
                std::string& str,
-               const cuvs::neighbors::ivf_flat::index<int8_t, int64_t>& index);
+               const cuvs::neighbors::ivf_flat::index<int8_t, int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Load index from input string
@@ -1399,6 +1874,113 @@ void deserialize(raft::resources const& handle,
                  const std::string& str,
                  cuvs::neighbors::ivf_flat::index<int8_t, int64_t>* index);
 
+/**
+ * Write the index to an output stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * The stream need not be seekable: a pipe or a socket can receive the index as it is written.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] os output stream
+ * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
+ *
+ */
+void serialize(raft::resources const& handle,
+               std::ostream& os,
+               const cuvs::neighbors::ivf_flat::index<int8_t, int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
+
+/**
+ * Load an index from an input stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] is input stream
+ * @param[out] index IVF-Flat index
+ *
+ */
+void deserialize(raft::resources const& handle,
+                 std::istream& is,
+                 cuvs::neighbors::ivf_flat::index<int8_t, int64_t>* index);
+
+/**
+ * Load an index from file into host memory, for the search on the CPU.
+ *
+ * The file is written by `serialize_file` from a GPU index; no GPU is needed to load it.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/ivf_flat.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * cuvs::neighbors::ivf_flat::host_index<int8_t, int64_t> index;
+ * cuvs::neighbors::ivf_flat::deserialize_host_file(handle, filename, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           cuvs::neighbors::ivf_flat::host_index<int8_t, int64_t>* index);
+
+/**
+ * Load an index from file into host memory, optionally with its lists loaded when first probed.
+ *
+ * With `params.lazy_lists`, the index keeps the file mapped and holds at most about
+ * `params.max_resident_list_bytes` of lists in memory, which lets the host search run over indexes
+ * larger than the memory. The file must have been written by this version of `serialize_file`.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ *
+ * raft::resources handle;
+ *
+ * cuvs::neighbors::ivf::host_load_params params;
+ * params.lazy_lists              = true;
+ * params.max_resident_list_bytes = size_t(1) << 30;
+ * cuvs::neighbors::ivf_flat::host_index<int8_t, int64_t> index;
+ * cuvs::neighbors::ivf_flat::deserialize_host_file(handle, "/path/to/index", params, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[in] params how to load the lists
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::ivf::host_load_params& params,
+                           cuvs::neighbors::ivf_flat::host_index<int8_t, int64_t>* index);
+
+/**
+ * Load an index from an input string into host memory, for the search on the CPU.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] str input string
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host(raft::resources const& handle,
+                      const std::string& str,
+                      cuvs::neighbors::ivf_flat::host_index<int8_t, int64_t>* index);
+
 /**
  * Save the index to file.
  *
@@ -1419,11 +2001,14 @@ void deserialize(raft::resources const& handle,
  * @param[in] handle the raft handle
  * @param[in] filename the file name for saving the index
  * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
-                    const cuvs::neighbors::ivf_flat::index<uint8_t, int64_t>& index);
+                    const cuvs::neighbors::ivf_flat::index<uint8_t, int64_t>& index,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Load index from file.
@@ -1473,11 +2058,14 @@ void deserialize_file(raft::resources const& handle,
  * @param[in] handle the raft handle
  * @param[out] str output string
  * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize(raft::resources const& handle,
                std::string& str,
-               const cuvs::neighbors::ivf_flat::index<uint8_t, int64_t>& index);
+               const cuvs::neighbors::ivf_flat::index<uint8_t, int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Load index from input string
@@ -1507,6 +2095,113 @@ void deserialize(raft::resources const& handle,
                  const std::string& str,
                  cuvs::neighbors::ivf_flat::index<uint8_t, int64_t>* index);
 
+/**
+ * Write the index to an output stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * The stream need not be seekable: a pipe or a socket can receive the index as it is written.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] os output stream
+ * @param[in] index IVF-Flat index
+ * @param[in] compression compression of the lists
+ *
+ */
+void serialize(raft::resources const& handle,
+               std::ostream& os,
+               const cuvs::neighbors::ivf_flat::index<uint8_t, int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
+
+/**
+ * Load an index from an input stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] is input stream
+ * @param[out] index IVF-Flat index
+ *
+ */
+void deserialize(raft::resources const& handle,
+                 std::istream& is,
+                 cuvs::neighbors::ivf_flat::index<uint8_t, int64_t>* index);
+
+/**
+ * Load an index from file into host memory, for the search on the CPU.
+ *
+ * The file is written by `serialize_file` from a GPU index; no GPU is needed to load it.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/ivf_flat.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * cuvs::neighbors::ivf_flat::host_index<uint8_t, int64_t> index;
+ * cuvs::neighbors::ivf_flat::deserialize_host_file(handle, filename, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           cuvs::neighbors::ivf_flat::host_index<uint8_t, int64_t>* index);
+
+/**
+ * Load an index from file into host memory, optionally with its lists loaded when first probed.
+ *
+ * With `params.lazy_lists`, the index keeps the file mapped and holds at most about
+ * `params.max_resident_list_bytes` of lists in memory, which lets the host search run over indexes
+ * larger than the memory. The file must have been written by this version of `serialize_file`.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ *
+ * raft::resources handle;
+ *
+ * cuvs::neighbors::ivf::host_load_params params;
+ * params.lazy_lists              = true;
+ * params.max_resident_list_bytes = size_t(1) << 30;
+ * cuvs::neighbors::ivf_flat::host_index<uint8_t, int64_t> index;
+ * cuvs::neighbors::ivf_flat::deserialize_host_file(handle, "/path/to/index", params, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[in] params how to load the lists
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::ivf::host_load_params& params,
+                           cuvs::neighbors::ivf_flat::host_index<uint8_t, int64_t>* index);
+
+/**
+ * Load an index from an input string into host memory, for the search on the CPU.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] str input string
+ * @param[out] index IVF-Flat host index
+ *
+ */
+void deserialize_host(raft::resources const& handle,
+                      const std::string& str,
+                      cuvs::neighbors::ivf_flat::host_index<uint8_t, int64_t>* index);
+
 /**
  * @}
  */
@@ -351,6 +351,93 @@ cuvsError_t cuvsIvfPqSearch(cuvsResources_t res,
  * @}
  */
 
+/**
+ * @defgroup ivf_pq_c_serialize IVF-PQ C-API serialize functions
+ * @{
+ */
+/**
+ * Save the index to file.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.c}
+ * #include <cuvs/neighbors/ivf_pq.h>
+ *
+ * // Create cuvsResources_t
+ * cuvsResources_t res;
+ * cuvsError_t res_create_status = cuvsResourcesCreate(&res);
+ *
+ * // create an index with `cuvsIvfPqBuild`
+ * cuvsIvfPqSerialize(res, "/path/to/index", index);
+ * @endcode
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index IVF-PQ index
+ */
+cuvsError_t cuvsIvfPqSerialize(cuvsResources_t res,
+                               const char* filename,
+                               cuvsIvfPqIndex_t index);
+
+/**
+ * Write the index to a stream, through a callback receiving its bytes in order.
+ *
+ * The callback can write to a socket, a pipe or a buffer of the caller: no file is needed.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] write the callback receiving the bytes of the index
+ * @param[in] context opaque pointer passed to `write`
+ * @param[in] index IVF-PQ index
+ */
+cuvsError_t cuvsIvfPqSerializeToStream(cuvsResources_t res,
+                                       cuvsWriteCallback write,
+                                       void* context,
+                                       cuvsIvfPqIndex_t index);
+
+/**
+ * Load index from file.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index IVF-PQ index loaded from disk, created with `cuvsIvfPqIndexCreate`
+ */
+cuvsError_t cuvsIvfPqDeserialize(cuvsResources_t res,
+                                 const char* filename,
+                                 cuvsIvfPqIndex_t index);
+
+/**
+ * Load index from a stream, through a callback providing its bytes in order.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] read the callback providing the bytes of the index
+ * @param[in] context opaque pointer passed to `read`
+ * @param[out] index IVF-PQ index, created with `cuvsIvfPqIndexCreate`
+ */
+cuvsError_t cuvsIvfPqDeserializeFromStream(cuvsResources_t res,
+                                           cuvsReadCallback read,
+                                           void* context,
+                                           cuvsIvfPqIndex_t index);
+
+/**
+ * Load index from a host memory buffer holding a serialized index.
+ *
+ * The buffer is not referenced after the call returns.
+ *
+ * @param[in] res cuvsResources_t opaque C handle
+ * @param[in] data the serialized index
+ * @param[in] size the size of the serialized index in bytes
+ * @param[out] index IVF-PQ index, created with `cuvsIvfPqIndexCreate`
+ */
+cuvsError_t cuvsIvfPqDeserializeFromBuffer(cuvsResources_t res,
+                                           const void* data,
+                                           size_t size,
+                                           cuvsIvfPqIndex_t index);
+/**
+ * @}
+ */
+
 #ifdef __cplusplus
 }
 #endif
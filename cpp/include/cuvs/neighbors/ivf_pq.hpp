@@ -25,6 +25,12 @@
 #include <raft/core/resources.hpp>
 #include <raft/util/integer_utils.hpp>
 
+#include <algorithm>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
 namespace cuvs::neighbors::ivf_pq {
 
 /**
@@ -337,6 +343,14 @@ struct index : cuvs::neighbors::index {
    */
   bool conservative_memory_allocation() const noexcept;
 
+  /**
+   * Type of the vectors the index was built from: CUDA_R_32F, CUDA_R_16F, CUDA_R_8I or CUDA_R_8U
+   * (CUDA_R_32F unless set by `build` or loaded from a file recording it). It is stored with the
+   * index, so that the readers of a serialized index know the type of its queries.
+   */
+  cudaDataType_t data_type() const noexcept;
+  void set_data_type(cudaDataType_t data_type) noexcept;
+
   /**
    * PQ cluster centers
    *
@@ -412,6 +426,7 @@ struct index : cuvs::neighbors::index {
   uint32_t pq_bits_;
   uint32_t pq_dim_;
   bool conservative_memory_allocation_;
+  cudaDataType_t data_type_ = CUDA_R_32F;
 
   // Primary data members
   std::vector<std::shared_ptr<list_data<IdxT>>> lists_;
@@ -433,6 +448,309 @@ struct index : cuvs::neighbors::index {
 
   static uint32_t calculate_pq_dim(uint32_t dim);
 };
+
+/**
+ * @brief An IVF-PQ index in host memory, searchable on the CPU.
+ *
+ * The index holds the same quantizers as `index` and the PQ codes of its lists, grouped by
+ * `kIndexGroupSize` vectors as in `list_spec`. Within each group, every `kIndexGroupVecLen`-byte
+ * chunk of the 32 vectors is stored transposed, that is, the list codes have the extents
+ *
+ *    [ ceildiv(list_size, kIndexGroupSize)
+ *    , ceildiv(pq_dim, (kIndexGroupVecLen * 8u) / pq_bits)
+ *    , kIndexGroupVecLen
+ *    , kIndexGroupSize
+ *    ],
+ *
+ * so that the same byte of all vectors of a group is contiguous, as needed by the SIMD table
+ * lookups of the host search. A host index is loaded from the serialized form of a GPU index
+ * (see `deserialize_host_file`), either entirely or with lists loaded when first probed
+ * (`ivf::host_load_params::lazy_lists`).
+ *
+ * @tparam IdxT type of the indices in the source dataset
+ */
+template <typename IdxT>
+struct host_index {
+  using pq_centers_extents = typename index<IdxT>::pq_centers_extents;
+
+ public:
+  /** The content of a list. */
+  struct list_type {
+    /** PQ codes, in the transposed group layout described above. */
+    std::vector<uint8_t> codes;
+    /** Source indices of the vectors [list size]. */
+    std::vector<IdxT> indices;
+  };
+  using list_loader_type = ivf::host_list_loader<list_type>;
+
+  host_index() = default;
+
+  /** Construct an index with `n_lists` empty lists. */
+  host_index(cuvs::distance::DistanceType metric,
+             codebook_gen codebook_kind,
+             uint32_t n_lists,
+             uint32_t dim,
+             uint32_t pq_bits,
+             uint32_t pq_dim)
+    : metric_(metric),
+      codebook_kind_(codebook_kind),
+      dim_(dim),
+      pq_bits_(pq_bits),
+      pq_dim_(pq_dim),
+      centers_(size_t(n_lists) * dim),
+      centers_rot_(size_t(n_lists) * rot_dim()),
+      rotation_matrix_(size_t(rot_dim()) * dim),
+      list_sizes_(n_lists, 0),
+      lists_(n_lists),
+      inds_ptrs_(n_lists, nullptr)
+  {
+    RAFT_EXPECTS(pq_bits >= 4 && pq_bits <= 8,
+                 "The pq_bits parameter must be within [4, 8], got %u.",
+                 pq_bits);
+    RAFT_EXPECTS(pq_dim > 0, "The pq_dim parameter must be positive.");
+    pq_centers_.resize(size_t(codebook_kind == codebook_gen::PER_SUBSPACE ? pq_dim : n_lists) *
+                       pq_len() * pq_book_size());
+  }
+
+  /** Distance metric used for clustering. */
+  [[nodiscard]] inline auto metric() const noexcept -> cuvs::distance::DistanceType
+  {
+    return metric_;
+  }
+  /** How PQ codebooks are created. */
+  [[nodiscard]] inline auto codebook_kind() const noexcept -> codebook_gen
+  {
+    return codebook_kind_;
+  }
+  /** Dimensionality of the input data. */
+  [[nodiscard]] inline auto dim() const noexcept -> uint32_t { return dim_; }
+  /** Dimensionality of the data after the rotation (`pq_dim * pq_len`). */
+  [[nodiscard]] inline auto rot_dim() const noexcept -> uint32_t { return pq_len() * pq_dim_; }
+  /** The bit length of an encoded vector element after compression by PQ. */
+  [[nodiscard]] inline auto pq_bits() const noexcept -> uint32_t { return pq_bits_; }
+  /** The dimensionality of an encoded vector after compression by PQ. */
+  [[nodiscard]] inline auto pq_dim() const noexcept -> uint32_t { return pq_dim_; }
+  /** Dimensionality of a subspace. */
+  [[nodiscard]] inline auto pq_len() const noexcept -> uint32_t
+  {
+    return pq_dim_ == 0 ? 0 : raft::div_rounding_up_unsafe(dim_, pq_dim_);
+  }
+  /** The number of vectors in a PQ codebook (`1 << pq_bits`). */
+  [[nodiscard]] inline auto pq_book_size() const noexcept -> uint32_t { return 1u << pq_bits_; }
+  /** Number of `kIndexGroupVecLen`-byte chunks encoding one vector. */
+  [[nodiscard]] inline auto pq_chunks() const noexcept -> uint32_t
+  {
+    return raft::div_rounding_up_safe<uint32_t>(pq_dim_, (kIndexGroupVecLen * 8u) / pq_bits_);
+  }
+  /** Number of clusters/inverted lists (first level quantization). */
+  [[nodiscard]] inline auto n_lists() const noexcept -> uint32_t { return list_sizes_.size(); }
+  /** Total length of the index. */
+  [[nodiscard]] inline auto size() const noexcept -> IdxT
+  {
+    IdxT total = 0;
+    for (auto s : list_sizes_) {
+      total += s;
+    }
+    return total;
+  }
+
+  /**
+   * PQ cluster centers
+   *
+   *   - codebook_gen::PER_SUBSPACE: [pq_dim , pq_len, pq_book_size]
+   *   - codebook_gen::PER_CLUSTER:  [n_lists, pq_len, pq_book_size]
+   */
+  [[nodiscard]] inline auto pq_centers() noexcept
+    -> raft::host_mdspan<float, pq_centers_extents, raft::row_major>
+  {
+    return raft::make_mdspan<float, uint32_t, raft::row_major, true, false>(
+      pq_centers_.data(), make_pq_centers_extents());
+  }
+  [[nodiscard]] inline auto pq_centers() const noexcept
+    -> raft::host_mdspan<const float, pq_centers_extents, raft::row_major>
+  {
+    return raft::make_mdspan<const float, uint32_t, raft::row_major, true, false>(
+      pq_centers_.data(), make_pq_centers_extents());
+  }
+
+  /** Cluster centers corresponding to the lists in the original space [n_lists, dim] */
+  [[nodiscard]] inline auto centers() noexcept
+    -> raft::host_matrix_view<float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<float, uint32_t>(centers_.data(), n_lists(), dim_);
+  }
+  [[nodiscard]] inline auto centers() const noexcept
+    -> raft::host_matrix_view<const float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<const float, uint32_t>(centers_.data(), n_lists(), dim_);
+  }
+
+  /** Cluster centers corresponding to the lists in the rotated space [n_lists, rot_dim] */
+  [[nodiscard]] inline auto centers_rot() noexcept
+    -> raft::host_matrix_view<float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<float, uint32_t>(centers_rot_.data(), n_lists(), rot_dim());
+  }
+  [[nodiscard]] inline auto centers_rot() const noexcept
+    -> raft::host_matrix_view<const float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<const float, uint32_t>(
+      centers_rot_.data(), n_lists(), rot_dim());
+  }
+
+  /** The transform matrix (original space -> rotated padded space) [rot_dim, dim] */
+  [[nodiscard]] inline auto rotation_matrix() noexcept
+    -> raft::host_matrix_view<float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<float, uint32_t>(rotation_matrix_.data(), rot_dim(), dim_);
+  }
+  [[nodiscard]] inline auto rotation_matrix() const noexcept
+    -> raft::host_matrix_view<const float, uint32_t, raft::row_major>
+  {
+    return raft::make_host_matrix_view<const float, uint32_t>(
+      rotation_matrix_.data(), rot_dim(), dim_);
+  }
+
+  /** Sizes of the lists (clusters) [n_lists] */
+  [[nodiscard]] inline auto list_sizes() const noexcept
+    -> raft::host_vector_view<const uint32_t, uint32_t>
+  {
+    return raft::make_host_vector_view<const uint32_t, uint32_t>(list_sizes_.data(), n_lists());
+  }
+
+  /**
+   * Get a list, loading it first if the lists are loaded on demand. The list stays in memory at
+   * least as long as the returned pointer; the pointer is null for empty lists.
+   */
+  [[nodiscard]] inline auto list(uint32_t label) const -> std::shared_ptr<const list_type>
+  {
+    return loader_ ? loader_->get(label) : lists_[label];
+  }
+  /** Whether the lists are loaded on demand. */
+  [[nodiscard]] inline auto lazy_lists() const noexcept -> bool { return loader_ != nullptr; }
+  /** The loader of the lists loaded on demand, if any. */
+  [[nodiscard]] inline auto list_loader() const noexcept -> const list_loader_type*
+  {
+    return loader_.get();
+  }
+
+  /**
+   * PQ codes of a list, in the transposed group layout described above.
+   *
+   * Null for the lists loaded on demand, see `list`.
+   */
+  [[nodiscard]] inline auto list_codes(uint32_t label) const noexcept -> const uint8_t*
+  {
+    return lists_[label] ? lists_[label]->codes.data() : nullptr;
+  }
+  /** Source indices of the vectors of a list [list size]; null for the lists loaded on demand. */
+  [[nodiscard]] inline auto list_indices(uint32_t label) const noexcept -> const IdxT*
+  {
+    return lists_[label] ? lists_[label]->indices.data() : nullptr;
+  }
+  /**
+   * Pointers to the source indices of the lists [n_lists], as used by `ivf_to_sample_filter`; null
+   * for the lists loaded on demand.
+   */
+  [[nodiscard]] inline auto inds_ptrs() const noexcept
+    -> raft::host_vector_view<const IdxT* const, uint32_t>
+  {
+    return raft::make_host_vector_view<const IdxT* const, uint32_t>(inds_ptrs_.data(), n_lists());
+  }
+
+  /**
+   * Set the content of a list.
+   *
+   * @param label the list
+   * @param size number of vectors in the list
+   * @param codes PQ codes in the `list_spec` layout (as stored by `ivf_pq::serialize`), at least
+   *   `list_spec::make_list_extents(size)` bytes
+   * @param indices source indices of the vectors, at least `size` elements
+   */
+  void set_list(uint32_t label,
+                uint32_t size,
+                const std::vector<uint8_t>& codes,
+                std::vector<IdxT>&& indices)
+  {
+    set_list(label, size, make_list(pq_chunks(), size, codes, std::move(indices)));
+  }
+
+  /** Set the content of a list made by `make_list`. */
+  void set_list(uint32_t label, uint32_t size, list_type&& list)
+  {
+    RAFT_EXPECTS(label < n_lists(), "List label %u is out of range", label);
+    RAFT_EXPECTS(!loader_, "The lists of the index are loaded on demand");
+    auto content       = std::make_shared<list_type>(std::move(list));
+    list_sizes_[label] = size;
+    inds_ptrs_[label]  = content->indices.data();
+    lists_[label]      = std::move(content);
+  }
+
+  /**
+   * Make the content of a list from its serialized form, without adding it to an index (see
+   * `set_list` for the parameters).
+   *
+   * @param pq_chunks `pq_chunks()` of the index
+   */
+  [[nodiscard]] static auto make_list(uint32_t pq_chunks,
+                                      uint32_t size,
+                                      const std::vector<uint8_t>& codes,
+                                      std::vector<IdxT>&& indices) -> list_type
+  {
+    constexpr uint32_t kBlock = kIndexGroupSize * kIndexGroupVecLen;
+    const size_t n_blocks =
+      size_t(raft::div_rounding_up_safe<uint32_t>(size, kIndexGroupSize)) * pq_chunks;
+    RAFT_EXPECTS(codes.size() >= n_blocks * kBlock, "The list codes are smaller than the list");
+    RAFT_EXPECTS(indices.size() >= size, "The list indices are smaller than the list size");
+    list_type list;
+    list.codes.resize(n_blocks * kBlock);
+    for (size_t b = 0; b < n_blocks; b++) {
+      const uint8_t* src = codes.data() + b * kBlock;
+      uint8_t* dst       = list.codes.data() + b * kBlock;
+      for (uint32_t r = 0; r < kIndexGroupSize; r++) {
+        for (uint32_t j = 0; j < kIndexGroupVecLen; j++) {
+          dst[j * kIndexGroupSize + r] = src[r * kIndexGroupVecLen + j];
+        }
+      }
+    }
+    list.indices = std::move(indices);
+    return list;
+  }
+
+  /**
+   * Load the lists on demand from `loader`, with the given sizes; the lists set before are
+   * dropped.
+   */
+  void set_list_loader(std::shared_ptr<list_loader_type> loader, std::vector<uint32_t> list_sizes)
+  {
+    RAFT_EXPECTS(list_sizes.size() == n_lists(), "Expected %u list sizes", n_lists());
+    list_sizes_ = std::move(list_sizes);
+    std::fill(lists_.begin(), lists_.end(), nullptr);
+    std::fill(inds_ptrs_.begin(), inds_ptrs_.end(), nullptr);
+    loader_ = std::move(loader);
+  }
+
+ private:
+  cuvs::distance::DistanceType metric_ = cuvs::distance::DistanceType::L2Expanded;
+  codebook_gen codebook_kind_          = codebook_gen::PER_SUBSPACE;
+  uint32_t dim_                        = 0;
+  uint32_t pq_bits_                    = 8;
+  uint32_t pq_dim_                     = 0;
+  std::vector<float> pq_centers_;
+  std::vector<float> centers_;
+  std::vector<float> centers_rot_;
+  std::vector<float> rotation_matrix_;
+  std::vector<uint32_t> list_sizes_;
+  std::vector<std::shared_ptr<const list_type>> lists_;
+  std::vector<const IdxT*> inds_ptrs_;
+  std::shared_ptr<list_loader_type> loader_;
+
+  auto make_pq_centers_extents() const -> pq_centers_extents
+  {
+    return raft::make_extents<uint32_t>(
+      codebook_kind_ == codebook_gen::PER_SUBSPACE ? pq_dim_ : n_lists(), pq_len(), pq_book_size());
+  }
+};
 /**
  * @}
  */
@@ -1299,6 +1617,161 @@ void search_with_filtering(
   raft::device_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
   raft::device_matrix_view<float, int64_t, raft::row_major> distances,
   cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search ANN using a host index on the CPU.
+ *
+ * The queries are compared with the cluster centers and rotated using SIMD kernels selected at run
+ * time, and the codes of the `n_probes` closest lists are scanned with per-list lookup tables, as
+ * in the GPU search. The `lut_dtype` selects the lookup table precision: CUDA_R_32F and CUDA_R_16F
+ * use a float table, CUDA_R_8U and CUDA_R_8I an 8-bit quantized one; with `pq_bits = 4` the latter
+ * is scanned in SIMD registers with byte shuffles (AVX2, AVX-512 or NEON, where available). The
+ * queries are processed in parallel with OpenMP; with fewer queries than threads, the lists probed
+ * by each query are scanned in parallel instead.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   // load an index saved with `ivf_pq::serialize_file`
+ *   ivf_pq::host_index<int64_t> index;
+ *   ivf_pq::deserialize_host_file(handle, filename, &index);
+ *   ivf_pq::search_params search_params;
+ *   search_params.lut_dtype = CUDA_R_8U;
+ *   ivf_pq::search(handle, search_params, index, queries, out_inds, out_dists);
+ * @endcode
+ *
+ * @param[in] handle
+ * @param[in] search_params configure the search
+ * @param[in] index ivf-pq index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& handle,
+            const cuvs::neighbors::ivf_pq::search_params& search_params,
+            const cuvs::neighbors::ivf_pq::host_index<int64_t>& index,
+            raft::host_matrix_view<const float, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search ANN using a host index on the CPU with the given filter.
+ *
+ * See the host `ivf_pq::search` for details.
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] idx ivf-pq index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& handle,
+  const search_params& params,
+  const host_index<int64_t>& idx,
+  raft::host_matrix_view<const float, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search ANN using a host index on the CPU.
+ *
+ * See the host `ivf_pq::search` for float queries for details.
+ *
+ * @param[in] handle
+ * @param[in] search_params configure the search
+ * @param[in] index ivf-pq index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& handle,
+            const cuvs::neighbors::ivf_pq::search_params& search_params,
+            const cuvs::neighbors::ivf_pq::host_index<int64_t>& index,
+            raft::host_matrix_view<const int8_t, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search ANN using a host index on the CPU with the given filter.
+ *
+ * See the host `ivf_pq::search` for details.
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] idx ivf-pq index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& handle,
+  const search_params& params,
+  const host_index<int64_t>& idx,
+  raft::host_matrix_view<const int8_t, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
+
+/**
+ * @brief Search ANN using a host index on the CPU.
+ *
+ * See the host `ivf_pq::search` for float queries for details.
+ *
+ * @param[in] handle
+ * @param[in] search_params configure the search
+ * @param[in] index ivf-pq index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ */
+void search(raft::resources const& handle,
+            const cuvs::neighbors::ivf_pq::search_params& search_params,
+            const cuvs::neighbors::ivf_pq::host_index<int64_t>& index,
+            raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> queries,
+            raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+            raft::host_matrix_view<float, int64_t, raft::row_major> distances);
+
+/**
+ * @brief Search ANN using a host index on the CPU with the given filter.
+ *
+ * See the host `ivf_pq::search` for details.
+ *
+ * @param[in] handle
+ * @param[in] params configure the search
+ * @param[in] idx ivf-pq index in host memory
+ * @param[in] queries a host matrix view to a row-major matrix [n_queries, index->dim()]
+ * @param[out] neighbors a host matrix view to the indices of the neighbors in the source dataset
+ * [n_queries, k]
+ * @param[out] distances a host matrix view to the distances to the selected neighbors [n_queries,
+ * k]
+ * @param[in] sample_filter a bitset filter, the bitset residing in host memory, that greenlights
+ * samples for a given query.
+ */
+void search_with_filtering(
+  raft::resources const& handle,
+  const search_params& params,
+  const host_index<int64_t>& idx,
+  raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> queries,
+  raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+  raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+  cuvs::neighbors::filtering::bitset_filter<uint32_t, int64_t> sample_filter);
 /**
  * @}
  */
@@ -1324,11 +1797,14 @@ void search_with_filtering(
  * @param[in] handle the raft handle
  * @param[out] str output string
  * @param[in] index IVF-PQ index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize(raft::resources const& handle,
                std::string& str,
-               const cuvs::neighbors::ivf_pq::index<int64_t>& index);
+               const cuvs::neighbors::ivf_pq::index<int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Save the index to file.
@@ -1347,11 +1823,14 @@ void serialize(raft::resources const& handle,
  * @param[in] handle the raft handle
  * @param[in] filename the file name for saving the index
  * @param[in] index IVF-PQ index
+ * @param[in] compression compression of the lists
  *
  */
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
-                    const cuvs::neighbors::ivf_pq::index<int64_t>& index);
+                    const cuvs::neighbors::ivf_pq::index<int64_t>& index,
+                    cuvs::neighbors::serialize_compression compression =
+                      cuvs::neighbors::serialize_compression::NONE);
 
 /**
  * Load index from input string.
@@ -1379,6 +1858,39 @@ void serialize_file(raft::resources const& handle,
 void deserialize(raft::resources const& handle,
                  const std::string& str,
                  cuvs::neighbors::ivf_pq::index<int64_t>* index);
+
+/**
+ * Write the index to an output stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * The stream need not be seekable: a pipe or a socket can receive the index as it is written.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] os output stream
+ * @param[in] index IVF-PQ index
+ * @param[in] compression compression of the lists
+ *
+ */
+void serialize(raft::resources const& handle,
+               std::ostream& os,
+               const cuvs::neighbors::ivf_pq::index<int64_t>& index,
+               cuvs::neighbors::serialize_compression compression =
+                 cuvs::neighbors::serialize_compression::NONE);
+
+/**
+ * Load an index from an input stream.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] is input stream
+ * @param[out] index IVF-PQ index
+ *
+ */
+void deserialize(raft::resources const& handle,
+                 std::istream& is,
+                 cuvs::neighbors::ivf_pq::index<int64_t>* index);
 /**
  * Load index from file.
  *
@@ -1404,6 +1916,79 @@ void deserialize(raft::resources const& handle,
 void deserialize_file(raft::resources const& handle,
                       const std::string& filename,
                       cuvs::neighbors::ivf_pq::index<int64_t>* index);
+
+/**
+ * Load an index from file into host memory, for the search on the CPU.
+ *
+ * The file is written by `serialize_file` from a GPU index; no GPU is needed to load it.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * cuvs::neighbors::ivf_pq::host_index<int64_t> index;
+ * cuvs::neighbors::ivf_pq::deserialize_host_file(handle, filename, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[out] index IVF-PQ host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           cuvs::neighbors::ivf_pq::host_index<int64_t>* index);
+
+/**
+ * Load an index from file into host memory, optionally with its lists loaded when first probed.
+ *
+ * With `params.lazy_lists`, the index keeps the file mapped and holds at most about
+ * `params.max_resident_list_bytes` of lists in memory, which lets the host search run over indexes
+ * larger than the memory. The file must have been written by this version of `serialize_file`.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ *
+ * raft::resources handle;
+ *
+ * cuvs::neighbors::ivf::host_load_params params;
+ * params.lazy_lists              = true;
+ * params.max_resident_list_bytes = size_t(1) << 30;
+ * cuvs::neighbors::ivf_pq::host_index<int64_t> index;
+ * cuvs::neighbors::ivf_pq::deserialize_host_file(handle, "/path/to/index", params, &index);
+ * @endcode
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ * @param[in] params how to load the lists
+ * @param[out] index IVF-PQ host index
+ *
+ */
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::ivf::host_load_params& params,
+                           cuvs::neighbors::ivf_pq::host_index<int64_t>* index);
+
+/**
+ * Load an index from an input string into host memory, for the search on the CPU.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] str input string
+ * @param[out] index IVF-PQ host index
+ *
+ */
+void deserialize_host(raft::resources const& handle,
+                      const std::string& str,
+                      cuvs::neighbors::ivf_pq::host_index<int64_t>* index);
 /**
  * @}
  */
@@ -27,6 +27,9 @@
 
 #include <cuvs/distance/distance.hpp>
 
+#include <cstdint>
+#include <string>
+
 namespace cuvs::neighbors::nn_descent {
 /**
  * @defgroup nn_descent_cpp_index_params The nn-descent algorithm parameters.
@@ -46,6 +49,15 @@ namespace cuvs::neighbors::nn_descent {
  * `max_iterations`: The number of iterations that nn-descent will refine
  * the graph for. More iterations produce a better quality graph at cost of performance
  * `termination_threshold`: The delta at which nn-descent will terminate its iterations
+ * `n_clusters`: The number of overlapping partitions of a dataset in host memory or in a file.
+ * With more than one, every row is assigned to its `partition_overlap` closest partitions (k-means
+ * on a sample), nn-descent runs on one partition at a time, and the kNN lists of the partitions are
+ * merged. Only one partition of the dataset, of about partition_overlap * N / n_clusters rows, is
+ * loaded at a time. A dataset in device memory is not partitioned: `n_clusters` must then be 1.
+ * `partition_overlap`: The number of partitions each row is assigned to, when `n_clusters` > 1.
+ * A true neighbor of a row is found only if the two rows share a partition, so a larger overlap
+ * raises the recall, most of all for data of high intrinsic dimension, at the cost of larger
+ * partitions.
  *
  */
 struct index_params : cuvs::neighbors::index_params {
@@ -53,6 +65,8 @@ struct index_params : cuvs::neighbors::index_params {
   size_t intermediate_graph_degree = 128;     // Degree of input graph for pruning.
   size_t max_iterations            = 20;      // Number of nn-descent iterations.
   float termination_threshold      = 0.0001;  // Termination threshold of nn-descent.
+  size_t n_clusters                = 1;       // Number of partitions of the dataset.
+  size_t partition_overlap         = 2;       // Number of partitions of each row.
 
   /** @brief Construct NN descent parameters for a specific kNN graph degree
    *
@@ -168,6 +182,23 @@ struct index : cuvs::neighbors::index {
     graph_view_;  // view of graph for user provided matrix
 };
 
+/**
+ * @brief A row-major [n_rows, dim] matrix stored in a file, from byte `offset` on.
+ *
+ * The rows are read in blocks by the builds from a file; the file is never loaded whole. For a file
+ * with a header, such as the `[uint32 n_rows][uint32 dim]` header of the `.fbin`, `.u8bin` and
+ * `.i8bin` files, `offset` is the size of the header.
+ *
+ * @tparam T data-type of the elements
+ */
+template <typename T>
+struct file_dataset {
+  std::string path;
+  int64_t n_rows;
+  int64_t dim;
+  uint64_t offset = 0;
+};
+
 /** @} */
 
 /**
@@ -211,6 +242,8 @@ auto build(raft::resources const& res,
  * The following distance metrics are supported:
  * - L2
  *
+ * On a machine without a CUDA device, the graph is built on the CPU, with the same parameters.
+ *
  * Usage example:
  * @code{.cpp}
  *   using namespace cuvs::neighbors::experimental;
@@ -273,6 +306,8 @@ auto build(raft::resources const& res,
  * The following distance metrics are supported:
  * - L2
  *
+ * On a machine without a CUDA device, the graph is built on the CPU, with the same parameters.
+ *
  * Usage example:
  * @code{.cpp}
  *   using namespace cuvs::neighbors::experimental;
@@ -337,6 +372,8 @@ auto build(raft::resources const& res,
  * The following distance metrics are supported:
  * - L2
  *
+ * On a machine without a CUDA device, the graph is built on the CPU, with the same parameters.
+ *
  * Usage example:
  * @code{.cpp}
  *   using namespace cuvs::neighbors::experimental;
@@ -363,6 +400,69 @@ auto build(raft::resources const& res,
            raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> dataset)
   -> cuvs::neighbors::nn_descent::index<uint32_t>;
 
+/**
+ * @brief Build an nn-descent kNN graph of a dataset stored in a file, out of core
+ *
+ * The dataset is split into `params.n_clusters` overlapping partitions, built one after the other
+ * and merged into the graph of `idx`: only one partition of the dataset is in memory at a time.
+ * The graph (which may be a view of user memory, e.g. a memory-mapped file) and the distances of
+ * its edges stay in host memory. Each partition is built on the device, or on the CPU when no
+ * device is available.
+ *
+ * Usage example:
+ * @code{.cpp}
+ *   using namespace cuvs::neighbors;
+ *   nn_descent::index_params index_params;
+ *   index_params.n_clusters = 16;
+ *   // a .fbin file: [uint32 n_rows][uint32 dim] then the rows
+ *   nn_descent::file_dataset<float> dataset{"base.fbin", n_rows, dim, 8};
+ *   nn_descent::index<uint32_t> index{res, n_rows, int64_t(index_params.graph_degree)};
+ *   nn_descent::build(res, index_params, dataset, index);
+ * @endcode
+ *
+ * @param[in] res raft::resources is an object mangaging resources
+ * @param[in] params an instance of nn_descent::index_params that are parameters
+ *               to run the nn-descent algorithm
+ * @param[in] dataset the file and shape of the input dataset
+ * @param[out] idx the index of the graph [n_rows, params.graph_degree]
+ */
+void build(raft::resources const& res,
+           index_params const& params,
+           const file_dataset<float>& dataset,
+           index<uint32_t>& idx);
+
+/**
+ * @brief Build an nn-descent kNN graph of a dataset stored in a file, out of core
+ *
+ * See the float overload.
+ *
+ * @param[in] res raft::resources is an object mangaging resources
+ * @param[in] params an instance of nn_descent::index_params that are parameters
+ *               to run the nn-descent algorithm
+ * @param[in] dataset the file and shape of the input dataset
+ * @param[out] idx the index of the graph [n_rows, params.graph_degree]
+ */
+void build(raft::resources const& res,
+           index_params const& params,
+           const file_dataset<int8_t>& dataset,
+           index<uint32_t>& idx);
+
+/**
+ * @brief Build an nn-descent kNN graph of a dataset stored in a file, out of core
+ *
+ * See the float overload.
+ *
+ * @param[in] res raft::resources is an object mangaging resources
+ * @param[in] params an instance of nn_descent::index_params that are parameters
+ *               to run the nn-descent algorithm
+ * @param[in] dataset the file and shape of the input dataset
+ * @param[out] idx the index of the graph [n_rows, params.graph_degree]
+ */
+void build(raft::resources const& res,
+           index_params const& params,
+           const file_dataset<uint8_t>& dataset,
+           index<uint32_t>& idx);
+
 /**
  * @brief Test if we have enough GPU memory to run NN descent algorithm.
  *
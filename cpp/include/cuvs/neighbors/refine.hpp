@@ -25,6 +25,8 @@
 #include <raft/core/resources.hpp>
 #include <raft/util/integer_utils.hpp>
 
+#include <optional>
+
 namespace cuvs::neighbors {
 /**
  * @defgroup ann_refine Approximate Nearest Neighbors Refinement
@@ -246,7 +248,13 @@ void refine(raft::resources const& handle,
  *   n_candidates], where n_candidates >= k
  * @param[out] indices host matrix that stores the refined indices [n_queries, k]
  * @param[out] distances host matrix that stores the refined distances [n_queries, k]
- * @param[in] metric distance metric to use. Euclidean (L2) is used by default
+ * @param[in] metric distance metric to use. Euclidean (L2) is used by default. Besides the L2
+ *   and inner product metrics, the host implementation supports CosineExpanded, L1, Linf,
+ *   HammingUnexpanded, LpUnexpanded, Canberra, CorrelationExpanded, HellingerExpanded,
+ *   JensenShannon, KLDivergence and RusselRaoExpanded.
+ * @param[in] metric_arg the exponent p of the LpUnexpanded metric (ignored by the others)
+ * @param[in] dataset_norms optional L2 norms of the dataset rows [n_rows], used by the
+ *   CosineExpanded metric instead of computing the norm of every candidate row
  */
 void refine(raft::resources const& handle,
             raft::host_matrix_view<const float, int64_t, raft::row_major> dataset,
@@ -254,7 +262,10 @@ void refine(raft::resources const& handle,
             raft::host_matrix_view<const int64_t, int64_t, raft::row_major> neighbor_candidates,
             raft::host_matrix_view<int64_t, int64_t, raft::row_major> indices,
             raft::host_matrix_view<float, int64_t, raft::row_major> distances,
-            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded);
+            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+            float metric_arg = 2.0f,
+            std::optional<raft::host_vector_view<const float, int64_t>> dataset_norms =
+              std::nullopt);
 
 /**
  * @brief Refine nearest neighbor search.
@@ -291,7 +302,13 @@ void refine(raft::resources const& handle,
  *   n_candidates], where n_candidates >= k
  * @param[out] indices host matrix that stores the refined indices [n_queries, k]
  * @param[out] distances host matrix that stores the refined distances [n_queries, k]
- * @param[in] metric distance metric to use. Euclidean (L2) is used by default
+ * @param[in] metric distance metric to use. Euclidean (L2) is used by default. Besides the L2
+ *   and inner product metrics, the host implementation supports CosineExpanded, L1, Linf,
+ *   HammingUnexpanded, LpUnexpanded, Canberra, CorrelationExpanded, HellingerExpanded,
+ *   JensenShannon, KLDivergence and RusselRaoExpanded.
+ * @param[in] metric_arg the exponent p of the LpUnexpanded metric (ignored by the others)
+ * @param[in] dataset_norms optional L2 norms of the dataset rows [n_rows], used by the
+ *   CosineExpanded metric instead of computing the norm of every candidate row
  */
 void refine(raft::resources const& handle,
             raft::host_matrix_view<const float, int64_t, raft::row_major> dataset,
@@ -299,7 +316,10 @@ void refine(raft::resources const& handle,
             raft::host_matrix_view<const uint32_t, int64_t, raft::row_major> neighbor_candidates,
             raft::host_matrix_view<uint32_t, int64_t, raft::row_major> indices,
             raft::host_matrix_view<float, int64_t, raft::row_major> distances,
-            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded);
+            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+            float metric_arg = 2.0f,
+            std::optional<raft::host_vector_view<const float, int64_t>> dataset_norms =
+              std::nullopt);
 
 /**
  * @brief Refine nearest neighbor search.
@@ -336,7 +356,13 @@ void refine(raft::resources const& handle,
  *   n_candidates], where n_candidates >= k
  * @param[out] indices host matrix that stores the refined indices [n_queries, k]
  * @param[out] distances host matrix that stores the refined distances [n_queries, k]
- * @param[in] metric distance metric to use. Euclidean (L2) is used by default
+ * @param[in] metric distance metric to use. Euclidean (L2) is used by default. Besides the L2
+ *   and inner product metrics, the host implementation supports CosineExpanded, L1, Linf,
+ *   HammingUnexpanded, LpUnexpanded, Canberra, CorrelationExpanded, HellingerExpanded,
+ *   JensenShannon, KLDivergence and RusselRaoExpanded.
+ * @param[in] metric_arg the exponent p of the LpUnexpanded metric (ignored by the others)
+ * @param[in] dataset_norms optional L2 norms of the dataset rows [n_rows], used by the
+ *   CosineExpanded metric instead of computing the norm of every candidate row
  */
 void refine(raft::resources const& handle,
             raft::host_matrix_view<const half, int64_t, raft::row_major> dataset,
@@ -344,7 +370,10 @@ void refine(raft::resources const& handle,
             raft::host_matrix_view<const int64_t, int64_t, raft::row_major> neighbor_candidates,
             raft::host_matrix_view<int64_t, int64_t, raft::row_major> indices,
             raft::host_matrix_view<float, int64_t, raft::row_major> distances,
-            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded);
+            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+            float metric_arg = 2.0f,
+            std::optional<raft::host_vector_view<const float, int64_t>> dataset_norms =
+              std::nullopt);
 
 /**
  * @brief Refine nearest neighbor search.
@@ -381,7 +410,13 @@ void refine(raft::resources const& handle,
  *   n_candidates], where n_candidates >= k
  * @param[out] indices host matrix that stores the refined indices [n_queries, k]
  * @param[out] distances host matrix that stores the refined distances [n_queries, k]
- * @param[in] metric distance metric to use. Euclidean (L2) is used by default
+ * @param[in] metric distance metric to use. Euclidean (L2) is used by default. Besides the L2
+ *   and inner product metrics, the host implementation supports CosineExpanded, L1, Linf,
+ *   HammingUnexpanded, LpUnexpanded, Canberra, CorrelationExpanded, HellingerExpanded,
+ *   JensenShannon, KLDivergence and RusselRaoExpanded.
+ * @param[in] metric_arg the exponent p of the LpUnexpanded metric (ignored by the others)
+ * @param[in] dataset_norms optional L2 norms of the dataset rows [n_rows], used by the
+ *   CosineExpanded metric instead of computing the norm of every candidate row
  */
 void refine(raft::resources const& handle,
             raft::host_matrix_view<const int8_t, int64_t, raft::row_major> dataset,
@@ -389,7 +424,10 @@ void refine(raft::resources const& handle,
             raft::host_matrix_view<const int64_t, int64_t, raft::row_major> neighbor_candidates,
             raft::host_matrix_view<int64_t, int64_t, raft::row_major> indices,
             raft::host_matrix_view<float, int64_t, raft::row_major> distances,
-            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded);
+            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+            float metric_arg = 2.0f,
+            std::optional<raft::host_vector_view<const float, int64_t>> dataset_norms =
+              std::nullopt);
 
 /**
  * @brief Refine nearest neighbor search.
@@ -426,7 +464,13 @@ void refine(raft::resources const& handle,
  *   n_candidates], where n_candidates >= k
  * @param[out] indices host matrix that stores the refined indices [n_queries, k]
  * @param[out] distances host matrix that stores the refined distances [n_queries, k]
- * @param[in] metric distance metric to use. Euclidean (L2) is used by default
+ * @param[in] metric distance metric to use. Euclidean (L2) is used by default. Besides the L2
+ *   and inner product metrics, the host implementation supports CosineExpanded, L1, Linf,
+ *   HammingUnexpanded, LpUnexpanded, Canberra, CorrelationExpanded, HellingerExpanded,
+ *   JensenShannon, KLDivergence and RusselRaoExpanded.
+ * @param[in] metric_arg the exponent p of the LpUnexpanded metric (ignored by the others)
+ * @param[in] dataset_norms optional L2 norms of the dataset rows [n_rows], used by the
+ *   CosineExpanded metric instead of computing the norm of every candidate row
  */
 void refine(raft::resources const& handle,
             raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> dataset,
@@ -434,6 +478,9 @@ void refine(raft::resources const& handle,
             raft::host_matrix_view<const int64_t, int64_t, raft::row_major> neighbor_candidates,
             raft::host_matrix_view<int64_t, int64_t, raft::row_major> indices,
             raft::host_matrix_view<float, int64_t, raft::row_major> distances,
-            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded);
+            cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+            float metric_arg = 2.0f,
+            std::optional<raft::host_vector_view<const float, int64_t>> dataset_norms =
+              std::nullopt);
 
 }  // namespace cuvs::neighbors
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include <cuda_fp16.h>
 
 #include <raft/core/device_mdspan.hpp>
+#include <raft/core/host_mdspan.hpp>
 #include <raft/core/resources.hpp>
 #include <raft/matrix/select_k_types.hpp>
 
@@ -196,6 +197,104 @@ void select_k(
   bool sorted                                                            = false,
   SelectAlgo algo                                                        = SelectAlgo::kAuto,
   std::optional<raft::device_vector_view<const uint32_t, int64_t>> len_i = std::nullopt);
+
+/**
+ * Select k smallest or largest key/values from each row of the input data, on the host.
+ *
+ * This is the CPU counterpart of the device `select_k`, with the same semantics; the rows are
+ * processed in parallel with OpenMP. If a row is shorter than k (see `len_i`), the remaining
+ * outputs are filled with the worst possible value and the maximum index.
+ *
+ * The host implements three algorithms: a bounded heap with a SIMD prefilter (small k), a partial
+ * sort (very short rows) and a radix select (otherwise). `SelectAlgo::kAuto` chooses among them
+ * from the row length and k, and runs the rows in parallel when the batch is large enough; the
+ * radix variants of `SelectAlgo` select the radix select and the warp-sort variants the heap.
+ *
+ * Example usage
+ * @code{.cpp}
+ *   using namespace raft;
+ *   // get a 2D row-major array of values to search through
+ *   auto in_values = {... input host_matrix_view<const float, int64_t, row_major> ...}
+ *   // prepare output arrays
+ *   auto out_values  = make_host_matrix<float, int64_t>(in_values.extent(0), k);
+ *   auto out_indices = make_host_matrix<int64_t, int64_t>(in_values.extent(0), k);
+ *   // search `k` smallest values in each row
+ *   cuvs::selection::select_k(
+ *     handle, in_values, std::nullopt, out_values.view(), out_indices.view(), true);
+ * @endcode
+ *
+ * @param[in] handle container of reusable resources
+ * @param[in] in_val
+ *   inputs values [batch_size, len];
+ *   these are compared and selected.
+ * @param[in] in_idx
+ *   optional input payload [batch_size, len];
+ *   typically, these are indices of the corresponding `in_val`.
+ *   If `in_idx` is `std::nullopt`, a contiguous array `0...len-1` is implied.
+ * @param[out] out_val
+ *   output values [batch_size, k];
+ *   the k smallest/largest values from each row of the `in_val`.
+ * @param[out] out_idx
+ *   output payload (e.g. indices) [batch_size, k];
+ *   the payload selected together with `out_val`.
+ * @param[in] select_min
+ *   whether to select k smallest (true) or largest (false) keys.
+ * @param[in] sorted
+ *   whether to make sure selected pairs are sorted by value
+ * @param[in] algo
+ *   the selection algorithm to use
+ * @param[in] len_i
+ *  optional array of size (batch_size) providing lengths for each individual row
+ */
+void select_k(
+  raft::resources const& handle,
+  raft::host_matrix_view<const float, int64_t, raft::row_major> in_val,
+  std::optional<raft::host_matrix_view<const int64_t, int64_t, raft::row_major>> in_idx,
+  raft::host_matrix_view<float, int64_t, raft::row_major> out_val,
+  raft::host_matrix_view<int64_t, int64_t, raft::row_major> out_idx,
+  bool select_min,
+  bool sorted                                                         = false,
+  SelectAlgo algo                                                     = SelectAlgo::kAuto,
+  std::optional<raft::host_vector_view<const int64_t, int64_t>> len_i = std::nullopt);
+
+/**
+ * Select k smallest or largest key/values from each row of the input data, on the host.
+ *
+ * See the host `select_k` overload with `int64_t` indices.
+ *
+ * @param[in] handle container of reusable resources
+ * @param[in] in_val
+ *   inputs values [batch_size, len];
+ *   these are compared and selected.
+ * @param[in] in_idx
+ *   optional input payload [batch_size, len];
+ *   typically, these are indices of the corresponding `in_val`.
+ *   If `in_idx` is `std::nullopt`, a contiguous array `0...len-1` is implied.
+ * @param[out] out_val
+ *   output values [batch_size, k];
+ *   the k smallest/largest values from each row of the `in_val`.
+ * @param[out] out_idx
+ *   output payload (e.g. indices) [batch_size, k];
+ *   the payload selected together with `out_val`.
+ * @param[in] select_min
+ *   whether to select k smallest (true) or largest (false) keys.
+ * @param[in] sorted
+ *   whether to make sure selected pairs are sorted by value
+ * @param[in] algo
+ *   the selection algorithm to use
+ * @param[in] len_i
+ *  optional array of size (batch_size) providing lengths for each individual row
+ */
+void select_k(
+  raft::resources const& handle,
+  raft::host_matrix_view<const float, int64_t, raft::row_major> in_val,
+  std::optional<raft::host_matrix_view<const uint32_t, int64_t, raft::row_major>> in_idx,
+  raft::host_matrix_view<float, int64_t, raft::row_major> out_val,
+  raft::host_matrix_view<uint32_t, int64_t, raft::row_major> out_idx,
+  bool select_min,
+  bool sorted                                                          = false,
+  SelectAlgo algo                                                      = SelectAlgo::kAuto,
+  std::optional<raft::host_vector_view<const uint32_t, int64_t>> len_i = std::nullopt);
 /** @} */  // end of group select_k
 
 }  // namespace cuvs::selection
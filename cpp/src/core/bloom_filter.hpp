@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace cuvs::core::detail {
+
+/**
+ * A blocked Bloom filter on the host, split into independent lists.
+ *
+ * Each list owns `sets_per_list` blocks of one cache line (512 bits, eight 64-bit words). A key
+ * selects one block of its list, and sets one bit in each of the eight words of the block (a
+ * "split block" filter): the eight bit positions are derived from a single hash with eight
+ * multiplicative salts, in a loop that the compiler vectorizes, and a probe reads exactly one cache
+ * line.
+ *
+ * `add` is safe to call concurrently, also on the same list: the bits are set with atomic ORs, and
+ * only when missing, so that the common case of a key already present does not write. `check`
+ * may run concurrently with `add`; it may or may not observe a key being added at the same time.
+ * `check_and_add` is the cheaper, non-atomic variant for a thread that owns its list, as in the
+ * sampling of NN-descent. `clear` zeroes the blocks with `memset`, in parallel for large filters,
+ * and must not run concurrently with the other operations.
+ *
+ * @tparam KeyT an integral key type of at most 64 bits
+ */
+template <typename KeyT>
+class blocked_bloom_filter {
+ public:
+  static constexpr size_t kWordsPerBlock = 8;
+  static constexpr size_t kBlockBytes    = kWordsPerBlock * sizeof(uint64_t);
+
+  /**
+   * @param n_lists number of independent lists
+   * @param sets_per_list number of blocks of each list (at least 1)
+   */
+  blocked_bloom_filter(size_t n_lists, size_t sets_per_list)
+    : n_lists_(n_lists),
+      sets_per_list_(std::max<size_t>(sets_per_list, 1)),
+      words_(static_cast<uint64_t*>(
+        ::operator new(std::max<size_t>(n_lists_ * sets_per_list_, 1) * kBlockBytes,
+                       std::align_val_t{kBlockBytes})))
+  {
+    clear_blocks();
+  }
+
+  [[nodiscard]] auto n_lists() const noexcept -> size_t { return n_lists_; }
+  [[nodiscard]] auto sets_per_list() const noexcept -> size_t { return sets_per_list_; }
+  /** Size of the bit array in bytes. */
+  [[nodiscard]] auto size_bytes() const noexcept -> size_t
+  {
+    return n_lists_ * sets_per_list_ * kBlockBytes;
+  }
+
+  /** Add a key to a list. */
+  inline void add(size_t list_id, KeyT key) noexcept
+  {
+    mark_not_cleared();
+    uint64_t* block = block_of(list_id, key);
+    uint64_t mask[kWordsPerBlock];
+    block_mask(key, mask);
+    for (size_t w = 0; w < kWordsPerBlock; w++) {
+      if ((__atomic_load_n(block + w, __ATOMIC_RELAXED) & mask[w]) != mask[w]) {
+        __atomic_fetch_or(block + w, mask[w], __ATOMIC_RELAXED);
+      }
+    }
+  }
+
+  /** Whether a key may have been added to a list (false positives are possible). */
+  [[nodiscard]] inline auto check(size_t list_id, KeyT key) const noexcept -> bool
+  {
+    const uint64_t* block = block_of(list_id, key);
+    uint64_t mask[kWordsPerBlock];
+    block_mask(key, mask);
+    uint64_t missing = 0;
+    for (size_t w = 0; w < kWordsPerBlock; w++) {
+      missing |= mask[w] & ~block[w];
+    }
+    return missing == 0;
+  }
+
+  /**
+   * Add a key to a list, and return whether it may have been there before.
+   *
+   * This is the fast path of a thread that owns the list: the block is updated with plain loads
+   * and stores, which the compiler vectorizes, instead of one atomic OR per word. It must not run
+   * concurrently with an `add` or `check_and_add` on the same list.
+   */
+  inline auto check_and_add(size_t list_id, KeyT key) noexcept -> bool
+  {
+    uint64_t* block = block_of(list_id, key);
+    uint64_t mask[kWordsPerBlock];
+    block_mask(key, mask);
+    uint64_t missing = 0;
+    for (size_t w = 0; w < kWordsPerBlock; w++) {
+      missing |= mask[w] & ~block[w];
+      block[w] |= mask[w];
+    }
+    if (missing == 0) { return true; }
+    mark_not_cleared();
+    return false;
+  }
+
+  /** Remove all the keys of all the lists; does nothing if no key was added since the last call. */
+  void clear()
+  {
+    if (is_cleared_.load(std::memory_order_relaxed)) { return; }
+    clear_blocks();
+  }
+
+ private:
+  struct aligned_delete {
+    void operator()(uint64_t* p) const noexcept
+    {
+      ::operator delete(p, std::align_val_t{kBlockBytes});
+    }
+  };
+
+  size_t n_lists_;
+  size_t sets_per_list_;
+  std::unique_ptr<uint64_t[], aligned_delete> words_;
+  std::atomic<bool> is_cleared_{false};
+
+  inline void mark_not_cleared() noexcept
+  {
+    if (is_cleared_.load(std::memory_order_relaxed)) {
+      is_cleared_.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  void clear_blocks()
+  {
+    auto* bytes             = reinterpret_cast<unsigned char*>(words_.get());
+    const size_t total      = size_bytes();
+    constexpr size_t kChunk = size_t{1} << 20;
+    const auto n_chunks     = static_cast<int64_t>((total + kChunk - 1) / kChunk);
+#pragma omp parallel for schedule(static) if (n_chunks > 4)
+    for (int64_t c = 0; c < n_chunks; c++) {
+      const size_t begin = size_t(c) * kChunk;
+      std::memset(bytes + begin, 0, std::min(kChunk, total - begin));
+    }
+    is_cleared_.store(true, std::memory_order_relaxed);
+  }
+
+  /** A 64-bit mix of the key (the finalizer of splitmix64). */
+  static inline auto hash(KeyT key) noexcept -> uint64_t
+  {
+    auto h = static_cast<uint64_t>(key);
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+  }
+
+  /** The block of a key: the high half of the hash picks one of the sets of the list. */
+  inline auto block_of(size_t list_id, KeyT key) const noexcept -> uint64_t*
+  {
+    const uint64_t set = ((hash(key) >> 32) * sets_per_list_) >> 32;
+    return words_.get() + (list_id * sets_per_list_ + set) * kWordsPerBlock;
+  }
+
+  /** The bit of each word of the block: the low half of the hash times an odd salt per word. */
+  static inline void block_mask(KeyT key, uint64_t* mask) noexcept
+  {
+    constexpr uint32_t kSalt[kWordsPerBlock] = {0x47b6137bu,
+                                                0x44974d91u,
+                                                0x8824ad5bu,
+                                                0xa2b7289du,
+                                                0x705495c7u,
+                                                0x2df1424bu,
+                                                0x9efc4947u,
+                                                0x5c6bfb31u};
+    const auto h = static_cast<uint32_t>(hash(key));
+    for (size_t w = 0; w < kWordsPerBlock; w++) {
+      mask[w] = uint64_t{1} << ((h * kSalt[w]) >> 26);
+    }
+  }
+};
+
+}  // namespace cuvs::core::detail
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuvs/core/c_api.h>
+
+#include <raft/core/error.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+namespace cuvs::core::detail {
+
+/**
+ * An output stream buffer handing the bytes to a `cuvsWriteCallback`.
+ *
+ * Small writes are gathered into a buffer; large ones go to the callback directly. The buffer is
+ * not seekable, the containers written through it are staged section by section.
+ */
+class callback_writebuf : public std::streambuf {
+ public:
+  static constexpr size_t kBufferBytes = size_t{1} << 20;
+
+  callback_writebuf(cuvsWriteCallback write, void* context)
+    : write_(write), context_(context), buffer_(kBufferBytes)
+  {
+    RAFT_EXPECTS(write != nullptr, "The write callback is null");
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+  callback_writebuf(const callback_writebuf&)                    = delete;
+  auto operator=(const callback_writebuf&) -> callback_writebuf& = delete;
+
+ protected:
+  auto overflow(int_type c) -> int_type override
+  {
+    if (flush() != 0) { return traits_type::eof(); }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  auto xsputn(const char* s, std::streamsize n) -> std::streamsize override
+  {
+    if (n < epptr() - pptr()) { return std::streambuf::xsputn(s, n); }
+    if (flush() != 0 || !put(s, n)) { return 0; }
+    return n;
+  }
+
+  auto sync() -> int override { return flush(); }
+
+ private:
+  cuvsWriteCallback write_;
+  void* context_;
+  std::vector<char> buffer_;
+
+  auto put(const char* s, size_t n) -> bool { return n == 0 || write_(context_, s, n) == n; }
+
+  auto flush() -> int
+  {
+    auto n = static_cast<size_t>(pptr() - pbase());
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    return put(buffer_.data(), n) ? 0 : -1;
+  }
+};
+
+/**
+ * An input stream buffer reading the bytes from a `cuvsReadCallback`.
+ *
+ * `peek` gives the first bytes of the stream before they are read, which lets a caller look at
+ * the header of an index (e.g. for its data type) before deserializing it.
+ */
+class callback_readbuf : public std::streambuf {
+ public:
+  static constexpr size_t kBufferBytes = size_t{1} << 20;
+
+  callback_readbuf(cuvsReadCallback read, void* context)
+    : read_(read), context_(context), buffer_(kBufferBytes)
+  {
+    RAFT_EXPECTS(read != nullptr, "The read callback is null");
+    setg(buffer_.data(), buffer_.data(), buffer_.data());
+  }
+  callback_readbuf(const callback_readbuf&)                    = delete;
+  auto operator=(const callback_readbuf&) -> callback_readbuf& = delete;
+
+  /** Up to `n` first bytes of the stream, which stay unread; only valid before any read. */
+  auto peek(size_t n) -> std::string_view
+  {
+    RAFT_EXPECTS(gptr() == eback(), "The stream was read before it was peeked at");
+    n = std::min(n, buffer_.size());
+    while (static_cast<size_t>(egptr() - eback()) < n) {
+      auto got = read_(context_, egptr(), n - (egptr() - eback()));
+      if (got == 0) { break; }
+      setg(eback(), gptr(), egptr() + got);
+    }
+    return {eback(), static_cast<size_t>(egptr() - eback())};
+  }
+
+ protected:
+  auto underflow() -> int_type override
+  {
+    if (gptr() == egptr()) {
+      auto got = read_(context_, buffer_.data(), buffer_.size());
+      setg(buffer_.data(), buffer_.data(), buffer_.data() + got);
+      if (got == 0) { return traits_type::eof(); }
+    }
+    return traits_type::to_int_type(*gptr());
+  }
+
+  auto xsgetn(char* s, std::streamsize n) -> std::streamsize override
+  {
+    // Serve the buffered bytes first, then read large arrays directly.
+    std::streamsize done = std::min<std::streamsize>(n, egptr() - gptr());
+    if (done > 0) {
+      std::copy(gptr(), gptr() + done, s);
+      gbump(static_cast<int>(done));
+    }
+    if (n - done < static_cast<std::streamsize>(buffer_.size())) {
+      return done + std::streambuf::xsgetn(s + done, n - done);
+    }
+    while (done < n) {
+      auto got = read_(context_, s + done, n - done);
+      if (got == 0) { break; }
+      done += got;
+    }
+    return done;
+  }
+
+ private:
+  cuvsReadCallback read_;
+  void* context_;
+  std::vector<char> buffer_;
+};
+
+}  // namespace cuvs::core::detail
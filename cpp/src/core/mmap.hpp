@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <raft/core/error.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace cuvs::core::detail {
+
+/** Size of a virtual memory page on the host. */
+inline auto page_size() -> size_t
+{
+  static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+inline auto page_floor(uintptr_t addr) -> uintptr_t { return addr & ~(page_size() - 1); }
+inline auto page_ceil(uintptr_t addr) -> uintptr_t { return page_floor(addr + page_size() - 1); }
+
+/**
+ * Ask the kernel to start reading the pages of the given range in the background.
+ *
+ * This is a hint: for file-backed mappings it triggers an asynchronous readahead, for anonymous
+ * memory it has no effect. Errors are ignored.
+ */
+inline void advise_willneed(const void* ptr, size_t bytes)
+{
+  if (bytes == 0) { return; }
+  auto begin = page_floor(reinterpret_cast<uintptr_t>(ptr));
+  auto end   = page_ceil(reinterpret_cast<uintptr_t>(ptr) + bytes);
+  madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
+
+/**
+ * Whether the page containing the given address is resident in physical memory.
+ *
+ * Addresses that are not part of a mapping known to the kernel are reported as resident.
+ */
+inline auto is_page_resident(const void* ptr) -> bool
+{
+  unsigned char vec = 0;
+  auto page         = page_floor(reinterpret_cast<uintptr_t>(ptr));
+  if (mincore(reinterpret_cast<void*>(page), 1, &vec) != 0) { return true; }
+  return (vec & 1) != 0;
+}
+
+/**
+ * A read-only, shared memory mapping of a whole file.
+ *
+ * The pages are loaded by the kernel on first access and are shared with the page cache, so
+ * mapping a file neither reads it nor allocates memory for its contents.
+ */
+class mapped_file {
+ public:
+  explicit mapped_file(const std::string& filename)
+  {
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      RAFT_FAIL("Cannot open file %s: %s", filename.c_str(), std::strerror(errno));
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+      int err = errno;
+      close(fd);
+      RAFT_FAIL("Cannot stat file %s: %s", filename.c_str(), std::strerror(err));
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* ptr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED) {
+        int err = errno;
+        close(fd);
+        RAFT_FAIL("Cannot map file %s: %s", filename.c_str(), std::strerror(err));
+      }
+      data_ = static_cast<const uint8_t*>(ptr);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+  }
+
+  mapped_file(const mapped_file&)                    = delete;
+  auto operator=(const mapped_file&) -> mapped_file& = delete;
+
+  ~mapped_file() noexcept
+  {
+    if (data_ != nullptr) { munmap(const_cast<uint8_t*>(data_), size_); }
+  }
+
+  /** Page-aligned start of the mapping. */
+  [[nodiscard]] auto data() const noexcept -> const uint8_t* { return data_; }
+  [[nodiscard]] auto size() const noexcept -> size_t { return size_; }
+
+  /** Hint the expected access pattern of a range of the mapping (e.g. MADV_RANDOM). */
+  void advise(size_t offset, size_t bytes, int advice) const noexcept
+  {
+    if (bytes == 0 || offset >= size_) { return; }
+    auto begin = page_floor(reinterpret_cast<uintptr_t>(data_ + offset));
+    auto end   = page_ceil(reinterpret_cast<uintptr_t>(data_ + offset + bytes));
+    madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_         = 0;
+};
+
+/** A file descriptor, closed on destruction. */
+class file_descriptor {
+ public:
+  file_descriptor(const std::string& filename, int flags) : fd_(open(filename.c_str(), flags))
+  {
+    if (fd_ < 0) { RAFT_FAIL("Cannot open file %s: %s", filename.c_str(), std::strerror(errno)); }
+  }
+
+  file_descriptor(const file_descriptor&)                    = delete;
+  auto operator=(const file_descriptor&) -> file_descriptor& = delete;
+
+  ~file_descriptor() noexcept { close(fd_); }
+
+  [[nodiscard]] auto value() const noexcept -> int { return fd_; }
+
+  /** Read exactly `bytes` at the given offset of the file; safe to call from several threads. */
+  void pread_all(void* data, size_t bytes, uint64_t offset) const
+  {
+    auto* p = static_cast<char*>(data);
+    while (bytes > 0) {
+      auto n_read = pread(fd_, p, bytes, static_cast<off_t>(offset));
+      if (n_read < 0 && errno == EINTR) { continue; }
+      if (n_read < 0) { RAFT_FAIL("Error reading the file: %s", std::strerror(errno)); }
+      if (n_read == 0) { RAFT_FAIL("Unexpected end of file at offset %lu", offset); }
+      p += n_read;
+      bytes -= n_read;
+      offset += n_read;
+    }
+  }
+
+  /** Size of the file in bytes. */
+  [[nodiscard]] auto size() const -> uint64_t
+  {
+    struct stat st {};
+    if (fstat(fd_, &st) != 0) { RAFT_FAIL("Cannot stat the file: %s", std::strerror(errno)); }
+    return static_cast<uint64_t>(st.st_size);
+  }
+
+  /** Write all `bytes` at the given offset of the file; safe to call from several threads. */
+  void pwrite_all(const void* data, size_t bytes, uint64_t offset) const
+  {
+    auto* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+      auto written = pwrite(fd_, p, bytes, static_cast<off_t>(offset));
+      if (written < 0 && errno == EINTR) { continue; }
+      if (written <= 0) { RAFT_FAIL("Error writing the file: %s", std::strerror(errno)); }
+      p += written;
+      bytes -= written;
+      offset += written;
+    }
+  }
+
+ private:
+  int fd_;
+};
+
+}  // namespace cuvs::core::detail
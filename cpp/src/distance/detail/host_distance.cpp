@@ -0,0 +1,947 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host (CPU) distance kernels with runtime instruction set dispatch.
+ *
+ * The x86 kernels are compiled with function-level `target` attributes, so the library does not
+ * need to be built with `-mavx2`/`-mavx512f` and still runs on CPUs that lack these extensions.
+ * NEON is part of the aarch64 baseline and needs no dispatch.
+ */
+
+#include "host_distance.hpp"
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CUVS_HOST_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CUVS_HOST_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cuvs::distance::detail::host {
+
+namespace {
+
+/**
+ * Integer kernels accumulate in 32-bit lanes. Each lane grows by at most 2 * 255^2 per step, hence
+ * we flush the accumulators into a float sum after this many elements to rule out overflow.
+ */
+constexpr size_t kIntBlock = 65536;
+
+template <typename DataT>
+auto l2_scalar(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float r = 0;
+  for (size_t i = 0; i < dim; i++) {
+    auto d = to_float(x[i]) - to_float(y[i]);
+    r += d * d;
+  }
+  return r;
+}
+
+template <typename DataT>
+auto ip_scalar(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float r = 0;
+  for (size_t i = 0; i < dim; i++) {
+    r += to_float(x[i]) * to_float(y[i]);
+  }
+  return r;
+}
+
+template <typename DataT>
+auto l1_scalar(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float r = 0;
+  for (size_t i = 0; i < dim; i++) {
+    r += std::abs(to_float(x[i]) - to_float(y[i]));
+  }
+  return r;
+}
+
+template <typename DataT>
+auto linf_scalar(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float r = 0;
+  for (size_t i = 0; i < dim; i++) {
+    r = std::max(r, std::abs(to_float(x[i]) - to_float(y[i])));
+  }
+  return r;
+}
+
+template <typename DataT>
+auto hamming_scalar(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  size_t r = 0;
+  for (size_t i = 0; i < dim; i++) {
+    r += to_float(x[i]) != to_float(y[i]);
+  }
+  return static_cast<float>(r);
+}
+
+#ifdef CUVS_HOST_SIMD_X86
+
+/* ---------------------------------------- AVX2 ---------------------------------------------- */
+
+__attribute__((target("avx2"))) inline auto hsum_avx2(__m256 v) -> float
+{
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s        = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s        = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2"))) inline auto hsum_avx2(__m256i v) -> int32_t
+{
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  s         = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+  s         = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(s);
+}
+
+__attribute__((target("avx2"))) inline auto load8_avx2(const float* p) -> __m256
+{
+  return _mm256_loadu_ps(p);
+}
+
+__attribute__((target("avx2,f16c"))) inline auto load8_avx2(const half* p) -> __m256
+{
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+/** Load 16 bytes and widen them to 16 x int16. */
+__attribute__((target("avx2"))) inline auto load16_avx2(const int8_t* p) -> __m256i
+{
+  return _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+__attribute__((target("avx2"))) inline auto load16_avx2(const uint8_t* p) -> __m256i
+{
+  return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+template <typename DataT>
+__attribute__((target("avx2,fma,f16c"))) auto l2_avx2_fp(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  size_t i    = 0;
+  for (; i + 16 <= dim; i += 16) {
+    __m256 d0 = _mm256_sub_ps(load8_avx2(x + i), load8_avx2(y + i));
+    __m256 d1 = _mm256_sub_ps(load8_avx2(x + i + 8), load8_avx2(y + i + 8));
+    acc0      = _mm256_fmadd_ps(d0, d0, acc0);
+    acc1      = _mm256_fmadd_ps(d1, d1, acc1);
+  }
+  for (; i + 8 <= dim; i += 8) {
+    __m256 d = _mm256_sub_ps(load8_avx2(x + i), load8_avx2(y + i));
+    acc0     = _mm256_fmadd_ps(d, d, acc0);
+  }
+  float r = hsum_avx2(_mm256_add_ps(acc0, acc1));
+  return r + l2_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx2,fma,f16c"))) auto ip_avx2_fp(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  size_t i    = 0;
+  for (; i + 16 <= dim; i += 16) {
+    acc0 = _mm256_fmadd_ps(load8_avx2(x + i), load8_avx2(y + i), acc0);
+    acc1 = _mm256_fmadd_ps(load8_avx2(x + i + 8), load8_avx2(y + i + 8), acc1);
+  }
+  for (; i + 8 <= dim; i += 8) {
+    acc0 = _mm256_fmadd_ps(load8_avx2(x + i), load8_avx2(y + i), acc0);
+  }
+  float r = hsum_avx2(_mm256_add_ps(acc0, acc1));
+  return r + ip_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx2"))) auto l2_avx2_int(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 16 <= dim) {
+    __m256i acc = _mm256_setzero_si256();
+    auto end    = std::min(dim, i + kIntBlock);
+    for (; i + 16 <= end; i += 16) {
+      __m256i d = _mm256_sub_epi16(load16_avx2(x + i), load16_avx2(y + i));
+      acc       = _mm256_add_epi32(acc, _mm256_madd_epi16(d, d));
+    }
+    r += static_cast<float>(hsum_avx2(acc));
+  }
+  return r + l2_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx2"))) auto ip_avx2_int(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 16 <= dim) {
+    __m256i acc = _mm256_setzero_si256();
+    auto end    = std::min(dim, i + kIntBlock);
+    for (; i + 16 <= end; i += 16) {
+      acc = _mm256_add_epi32(acc, _mm256_madd_epi16(load16_avx2(x + i), load16_avx2(y + i)));
+    }
+    r += static_cast<float>(hsum_avx2(acc));
+  }
+  return r + ip_scalar(x + i, y + i, dim - i);
+}
+
+auto l2_avx2(const float* x, const float* y, size_t dim) -> float { return l2_avx2_fp(x, y, dim); }
+auto l2_avx2(const half* x, const half* y, size_t dim) -> float { return l2_avx2_fp(x, y, dim); }
+auto l2_avx2(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return l2_avx2_int(x, y, dim);
+}
+auto l2_avx2(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return l2_avx2_int(x, y, dim);
+}
+auto ip_avx2(const float* x, const float* y, size_t dim) -> float { return ip_avx2_fp(x, y, dim); }
+auto ip_avx2(const half* x, const half* y, size_t dim) -> float { return ip_avx2_fp(x, y, dim); }
+auto ip_avx2(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return ip_avx2_int(x, y, dim);
+}
+auto ip_avx2(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return ip_avx2_int(x, y, dim);
+}
+
+__attribute__((target("avx2"))) inline auto hmax_avx2(__m256 v) -> float
+{
+  __m128 s = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s        = _mm_max_ps(s, _mm_movehl_ps(s, s));
+  s        = _mm_max_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+/**
+ * Load 32 bytes as unsigned integers.
+ * Signed values are biased by 128, which preserves both |x - y| and x == y.
+ */
+__attribute__((target("avx2"))) inline auto load32u_avx2(const uint8_t* p) -> __m256i
+{
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+__attribute__((target("avx2"))) inline auto load32u_avx2(const int8_t* p) -> __m256i
+{
+  return _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                          _mm256_set1_epi8(static_cast<char>(0x80)));
+}
+
+template <typename DataT>
+__attribute__((target("avx2,f16c"))) auto l1_avx2_fp(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 acc0       = _mm256_setzero_ps();
+  __m256 acc1       = _mm256_setzero_ps();
+  size_t i          = 0;
+  for (; i + 16 <= dim; i += 16) {
+    __m256 d0 = _mm256_sub_ps(load8_avx2(x + i), load8_avx2(y + i));
+    __m256 d1 = _mm256_sub_ps(load8_avx2(x + i + 8), load8_avx2(y + i + 8));
+    acc0      = _mm256_add_ps(acc0, _mm256_andnot_ps(sign, d0));
+    acc1      = _mm256_add_ps(acc1, _mm256_andnot_ps(sign, d1));
+  }
+  for (; i + 8 <= dim; i += 8) {
+    __m256 d = _mm256_sub_ps(load8_avx2(x + i), load8_avx2(y + i));
+    acc0     = _mm256_add_ps(acc0, _mm256_andnot_ps(sign, d));
+  }
+  float r = hsum_avx2(_mm256_add_ps(acc0, acc1));
+  return r + l1_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx2,f16c"))) auto linf_avx2_fp(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 acc        = _mm256_setzero_ps();
+  size_t i          = 0;
+  for (; i + 8 <= dim; i += 8) {
+    __m256 d = _mm256_sub_ps(load8_avx2(x + i), load8_avx2(y + i));
+    acc      = _mm256_max_ps(acc, _mm256_andnot_ps(sign, d));
+  }
+  return std::max(hmax_avx2(acc), linf_scalar(x + i, y + i, dim - i));
+}
+
+template <typename DataT>
+__attribute__((target("avx2,f16c,popcnt"))) auto hamming_avx2_fp(const DataT* x,
+                                                                 const DataT* y,
+                                                                 size_t dim) -> float
+{
+  size_t r = 0;
+  size_t i = 0;
+  for (; i + 8 <= dim; i += 8) {
+    __m256 ne = _mm256_cmp_ps(load8_avx2(x + i), load8_avx2(y + i), _CMP_NEQ_UQ);
+    r += __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_ps(ne)));
+  }
+  return static_cast<float>(r) + hamming_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx2"))) auto l1_avx2_byte(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  // The sums of absolute differences are accumulated in 64-bit lanes and cannot overflow.
+  __m256i acc = _mm256_setzero_si256();
+  size_t i    = 0;
+  for (; i + 32 <= dim; i += 32) {
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(load32u_avx2(x + i), load32u_avx2(y + i)));
+  }
+  __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  s         = _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+  return static_cast<float>(_mm_cvtsi128_si64(s)) + l1_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx2"))) auto linf_avx2_byte(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  __m256i acc = _mm256_setzero_si256();
+  size_t i    = 0;
+  for (; i + 32 <= dim; i += 32) {
+    __m256i a = load32u_avx2(x + i);
+    __m256i b = load32u_avx2(y + i);
+    acc = _mm256_max_epu8(acc, _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a)));
+  }
+  __m128i s = _mm_max_epu8(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  s         = _mm_max_epu8(s, _mm_srli_si128(s, 8));
+  s         = _mm_max_epu8(s, _mm_srli_si128(s, 4));
+  s         = _mm_max_epu8(s, _mm_srli_si128(s, 2));
+  s         = _mm_max_epu8(s, _mm_srli_si128(s, 1));
+  auto r    = static_cast<float>(static_cast<uint8_t>(_mm_cvtsi128_si32(s)));
+  return std::max(r, linf_scalar(x + i, y + i, dim - i));
+}
+
+template <typename DataT>
+__attribute__((target("avx2,popcnt"))) auto hamming_avx2_byte(const DataT* x,
+                                                              const DataT* y,
+                                                              size_t dim) -> float
+{
+  size_t r = 0;
+  size_t i = 0;
+  for (; i + 32 <= dim; i += 32) {
+    __m256i eq = _mm256_cmpeq_epi8(load32u_avx2(x + i), load32u_avx2(y + i));
+    r += 32 - __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(eq)));
+  }
+  return static_cast<float>(r) + hamming_scalar(x + i, y + i, dim - i);
+}
+
+auto l1_avx2(const float* x, const float* y, size_t dim) -> float { return l1_avx2_fp(x, y, dim); }
+auto l1_avx2(const half* x, const half* y, size_t dim) -> float { return l1_avx2_fp(x, y, dim); }
+auto l1_avx2(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return l1_avx2_byte(x, y, dim);
+}
+auto l1_avx2(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return l1_avx2_byte(x, y, dim);
+}
+auto linf_avx2(const float* x, const float* y, size_t dim) -> float
+{
+  return linf_avx2_fp(x, y, dim);
+}
+auto linf_avx2(const half* x, const half* y, size_t dim) -> float
+{
+  return linf_avx2_fp(x, y, dim);
+}
+auto linf_avx2(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return linf_avx2_byte(x, y, dim);
+}
+auto linf_avx2(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return linf_avx2_byte(x, y, dim);
+}
+auto hamming_avx2(const float* x, const float* y, size_t dim) -> float
+{
+  return hamming_avx2_fp(x, y, dim);
+}
+auto hamming_avx2(const half* x, const half* y, size_t dim) -> float
+{
+  return hamming_avx2_fp(x, y, dim);
+}
+auto hamming_avx2(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return hamming_avx2_byte(x, y, dim);
+}
+auto hamming_avx2(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return hamming_avx2_byte(x, y, dim);
+}
+
+/* --------------------------------------- AVX-512 -------------------------------------------- */
+
+__attribute__((target("avx512f"))) inline auto load16_avx512(const float* p) -> __m512
+{
+  return _mm512_loadu_ps(p);
+}
+
+__attribute__((target("avx512f"))) inline auto load16_avx512(const half* p) -> __m512
+{
+  return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+
+/** Load 32 bytes and widen them to 32 x int16. */
+__attribute__((target("avx512f,avx512bw"))) inline auto load32_avx512(const int8_t* p) -> __m512i
+{
+  return _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+
+__attribute__((target("avx512f,avx512bw"))) inline auto load32_avx512(const uint8_t* p) -> __m512i
+{
+  return _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+
+__attribute__((target("avx512f"))) auto l2_avx512(const float* x, const float* y, size_t dim)
+  -> float
+{
+  __m512 acc0 = _mm512_setzero_ps();
+  __m512 acc1 = _mm512_setzero_ps();
+  size_t i    = 0;
+  for (; i + 32 <= dim; i += 32) {
+    __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i));
+    __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16));
+    acc0      = _mm512_fmadd_ps(d0, d0, acc0);
+    acc1      = _mm512_fmadd_ps(d1, d1, acc1);
+  }
+  for (; i < dim; i += 16) {
+    auto rest   = std::min<size_t>(dim - i, 16);
+    __mmask16 m = static_cast<__mmask16>((1u << rest) - 1u);
+    __m512 d    = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, x + i), _mm512_maskz_loadu_ps(m, y + i));
+    acc0        = _mm512_fmadd_ps(d, d, acc0);
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx512f"))) auto ip_avx512(const float* x, const float* y, size_t dim)
+  -> float
+{
+  __m512 acc0 = _mm512_setzero_ps();
+  __m512 acc1 = _mm512_setzero_ps();
+  size_t i    = 0;
+  for (; i + 32 <= dim; i += 32) {
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc0);
+    acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), acc1);
+  }
+  for (; i < dim; i += 16) {
+    auto rest   = std::min<size_t>(dim - i, 16);
+    __mmask16 m = static_cast<__mmask16>((1u << rest) - 1u);
+    acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, x + i), _mm512_maskz_loadu_ps(m, y + i), acc0);
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx512f"))) auto l2_avx512(const half* x, const half* y, size_t dim)
+  -> float
+{
+  __m512 acc = _mm512_setzero_ps();
+  size_t i   = 0;
+  for (; i + 16 <= dim; i += 16) {
+    __m512 d = _mm512_sub_ps(load16_avx512(x + i), load16_avx512(y + i));
+    acc      = _mm512_fmadd_ps(d, d, acc);
+  }
+  return _mm512_reduce_add_ps(acc) + l2_scalar(x + i, y + i, dim - i);
+}
+
+__attribute__((target("avx512f"))) auto ip_avx512(const half* x, const half* y, size_t dim)
+  -> float
+{
+  __m512 acc = _mm512_setzero_ps();
+  size_t i   = 0;
+  for (; i + 16 <= dim; i += 16) {
+    acc = _mm512_fmadd_ps(load16_avx512(x + i), load16_avx512(y + i), acc);
+  }
+  return _mm512_reduce_add_ps(acc) + ip_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx512f,avx512bw"))) auto l2_avx512_int(const DataT* x,
+                                                               const DataT* y,
+                                                               size_t dim) -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 32 <= dim) {
+    __m512i acc = _mm512_setzero_si512();
+    auto end    = std::min(dim, i + kIntBlock);
+    for (; i + 32 <= end; i += 32) {
+      __m512i d = _mm512_sub_epi16(load32_avx512(x + i), load32_avx512(y + i));
+      acc       = _mm512_add_epi32(acc, _mm512_madd_epi16(d, d));
+    }
+    r += static_cast<float>(_mm512_reduce_add_epi32(acc));
+  }
+  return r + l2_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx512f,avx512bw"))) auto ip_avx512_int(const DataT* x,
+                                                               const DataT* y,
+                                                               size_t dim) -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 32 <= dim) {
+    __m512i acc = _mm512_setzero_si512();
+    auto end    = std::min(dim, i + kIntBlock);
+    for (; i + 32 <= end; i += 32) {
+      acc = _mm512_add_epi32(acc, _mm512_madd_epi16(load32_avx512(x + i), load32_avx512(y + i)));
+    }
+    r += static_cast<float>(_mm512_reduce_add_epi32(acc));
+  }
+  return r + ip_scalar(x + i, y + i, dim - i);
+}
+
+auto l2_avx512(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return l2_avx512_int(x, y, dim);
+}
+auto l2_avx512(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return l2_avx512_int(x, y, dim);
+}
+auto ip_avx512(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return ip_avx512_int(x, y, dim);
+}
+auto ip_avx512(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return ip_avx512_int(x, y, dim);
+}
+
+template <typename DataT>
+__attribute__((target("avx512f"))) auto l1_avx512_fp(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  __m512 acc0 = _mm512_setzero_ps();
+  __m512 acc1 = _mm512_setzero_ps();
+  size_t i    = 0;
+  for (; i + 32 <= dim; i += 32) {
+    __m512 d0 = _mm512_sub_ps(load16_avx512(x + i), load16_avx512(y + i));
+    __m512 d1 = _mm512_sub_ps(load16_avx512(x + i + 16), load16_avx512(y + i + 16));
+    acc0      = _mm512_add_ps(acc0, _mm512_abs_ps(d0));
+    acc1      = _mm512_add_ps(acc1, _mm512_abs_ps(d1));
+  }
+  for (; i + 16 <= dim; i += 16) {
+    __m512 d = _mm512_sub_ps(load16_avx512(x + i), load16_avx512(y + i));
+    acc0     = _mm512_add_ps(acc0, _mm512_abs_ps(d));
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1)) + l1_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+__attribute__((target("avx512f"))) auto linf_avx512_fp(const DataT* x, const DataT* y, size_t dim)
+  -> float
+{
+  __m512 acc = _mm512_setzero_ps();
+  size_t i   = 0;
+  for (; i + 16 <= dim; i += 16) {
+    __m512 d = _mm512_sub_ps(load16_avx512(x + i), load16_avx512(y + i));
+    acc      = _mm512_max_ps(acc, _mm512_abs_ps(d));
+  }
+  return std::max(_mm512_reduce_max_ps(acc), linf_scalar(x + i, y + i, dim - i));
+}
+
+// The byte kernels of L1 and Linf are bound by the loads already with AVX2, hence the AVX-512
+// table reuses them (as well as the Hamming kernels).
+auto l1_avx512(const float* x, const float* y, size_t dim) -> float
+{
+  return l1_avx512_fp(x, y, dim);
+}
+auto l1_avx512(const half* x, const half* y, size_t dim) -> float
+{
+  return l1_avx512_fp(x, y, dim);
+}
+auto l1_avx512(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return l1_avx2_byte(x, y, dim);
+}
+auto l1_avx512(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return l1_avx2_byte(x, y, dim);
+}
+auto linf_avx512(const float* x, const float* y, size_t dim) -> float
+{
+  return linf_avx512_fp(x, y, dim);
+}
+auto linf_avx512(const half* x, const half* y, size_t dim) -> float
+{
+  return linf_avx512_fp(x, y, dim);
+}
+auto linf_avx512(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return linf_avx2_byte(x, y, dim);
+}
+auto linf_avx512(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return linf_avx2_byte(x, y, dim);
+}
+
+#endif  // CUVS_HOST_SIMD_X86
+
+#ifdef CUVS_HOST_SIMD_NEON
+
+/* ----------------------------------------- NEON --------------------------------------------- */
+
+inline auto load4_neon(const float* p) -> float32x4_t { return vld1q_f32(p); }
+inline auto load4_neon(const half* p) -> float32x4_t
+{
+  return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(p))));
+}
+
+template <typename DataT>
+auto l2_neon_fp(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float32x4_t acc0 = vdupq_n_f32(0);
+  float32x4_t acc1 = vdupq_n_f32(0);
+  size_t i         = 0;
+  for (; i + 8 <= dim; i += 8) {
+    float32x4_t d0 = vsubq_f32(load4_neon(x + i), load4_neon(y + i));
+    float32x4_t d1 = vsubq_f32(load4_neon(x + i + 4), load4_neon(y + i + 4));
+    acc0           = vfmaq_f32(acc0, d0, d0);
+    acc1           = vfmaq_f32(acc1, d1, d1);
+  }
+  for (; i + 4 <= dim; i += 4) {
+    float32x4_t d = vsubq_f32(load4_neon(x + i), load4_neon(y + i));
+    acc0          = vfmaq_f32(acc0, d, d);
+  }
+  return vaddvq_f32(vaddq_f32(acc0, acc1)) + l2_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+auto ip_neon_fp(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float32x4_t acc0 = vdupq_n_f32(0);
+  float32x4_t acc1 = vdupq_n_f32(0);
+  size_t i         = 0;
+  for (; i + 8 <= dim; i += 8) {
+    acc0 = vfmaq_f32(acc0, load4_neon(x + i), load4_neon(y + i));
+    acc1 = vfmaq_f32(acc1, load4_neon(x + i + 4), load4_neon(y + i + 4));
+  }
+  for (; i + 4 <= dim; i += 4) {
+    acc0 = vfmaq_f32(acc0, load4_neon(x + i), load4_neon(y + i));
+  }
+  return vaddvq_f32(vaddq_f32(acc0, acc1)) + ip_scalar(x + i, y + i, dim - i);
+}
+
+auto l2_neon(const float* x, const float* y, size_t dim) -> float { return l2_neon_fp(x, y, dim); }
+auto l2_neon(const half* x, const half* y, size_t dim) -> float { return l2_neon_fp(x, y, dim); }
+auto ip_neon(const float* x, const float* y, size_t dim) -> float { return ip_neon_fp(x, y, dim); }
+auto ip_neon(const half* x, const half* y, size_t dim) -> float { return ip_neon_fp(x, y, dim); }
+
+auto l2_neon(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 8 <= dim) {
+    int32x4_t acc = vdupq_n_s32(0);
+    auto end      = std::min(dim, i + kIntBlock);
+    for (; i + 8 <= end; i += 8) {
+      int16x8_t d = vsubl_s8(vld1_s8(x + i), vld1_s8(y + i));
+      acc         = vmlal_s16(acc, vget_low_s16(d), vget_low_s16(d));
+      acc         = vmlal_high_s16(acc, d, d);
+    }
+    r += static_cast<float>(vaddvq_s32(acc));
+  }
+  return r + l2_scalar(x + i, y + i, dim - i);
+}
+
+auto l2_neon(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 8 <= dim) {
+    uint32x4_t acc = vdupq_n_u32(0);
+    auto end       = std::min(dim, i + kIntBlock);
+    for (; i + 8 <= end; i += 8) {
+      uint8x8_t d = vabd_u8(vld1_u8(x + i), vld1_u8(y + i));
+      acc         = vpadalq_u16(acc, vmull_u8(d, d));
+    }
+    r += static_cast<float>(vaddvq_u32(acc));
+  }
+  return r + l2_scalar(x + i, y + i, dim - i);
+}
+
+auto ip_neon(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 8 <= dim) {
+    int32x4_t acc = vdupq_n_s32(0);
+    auto end      = std::min(dim, i + kIntBlock);
+    for (; i + 8 <= end; i += 8) {
+      acc = vpadalq_s16(acc, vmull_s8(vld1_s8(x + i), vld1_s8(y + i)));
+    }
+    r += static_cast<float>(vaddvq_s32(acc));
+  }
+  return r + ip_scalar(x + i, y + i, dim - i);
+}
+
+auto ip_neon(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 8 <= dim) {
+    uint32x4_t acc = vdupq_n_u32(0);
+    auto end       = std::min(dim, i + kIntBlock);
+    for (; i + 8 <= end; i += 8) {
+      acc = vpadalq_u16(acc, vmull_u8(vld1_u8(x + i), vld1_u8(y + i)));
+    }
+    r += static_cast<float>(vaddvq_u32(acc));
+  }
+  return r + ip_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+auto l1_neon_fp(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float32x4_t acc0 = vdupq_n_f32(0);
+  float32x4_t acc1 = vdupq_n_f32(0);
+  size_t i         = 0;
+  for (; i + 8 <= dim; i += 8) {
+    acc0 = vaddq_f32(acc0, vabdq_f32(load4_neon(x + i), load4_neon(y + i)));
+    acc1 = vaddq_f32(acc1, vabdq_f32(load4_neon(x + i + 4), load4_neon(y + i + 4)));
+  }
+  for (; i + 4 <= dim; i += 4) {
+    acc0 = vaddq_f32(acc0, vabdq_f32(load4_neon(x + i), load4_neon(y + i)));
+  }
+  return vaddvq_f32(vaddq_f32(acc0, acc1)) + l1_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+auto linf_neon_fp(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float32x4_t acc = vdupq_n_f32(0);
+  size_t i        = 0;
+  for (; i + 4 <= dim; i += 4) {
+    acc = vmaxq_f32(acc, vabdq_f32(load4_neon(x + i), load4_neon(y + i)));
+  }
+  return std::max(vmaxvq_f32(acc), linf_scalar(x + i, y + i, dim - i));
+}
+
+template <typename DataT>
+auto hamming_neon_fp(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  size_t r = 0;
+  size_t i = 0;
+  for (; i + 4 <= dim; i += 4) {
+    uint32x4_t eq = vceqq_f32(load4_neon(x + i), load4_neon(y + i));
+    r += 4 - vaddvq_u32(vshrq_n_u32(eq, 31));
+  }
+  return static_cast<float>(r) + hamming_scalar(x + i, y + i, dim - i);
+}
+
+/**
+ * Load 16 bytes as unsigned integers.
+ * Signed values are biased by 128, which preserves both |x - y| and x == y.
+ */
+inline auto load16u_neon(const uint8_t* p) -> uint8x16_t { return vld1q_u8(p); }
+inline auto load16u_neon(const int8_t* p) -> uint8x16_t
+{
+  return veorq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p)), vdupq_n_u8(0x80));
+}
+
+template <typename DataT>
+auto l1_neon_byte(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  float r  = 0;
+  size_t i = 0;
+  while (i + 16 <= dim) {
+    uint32x4_t acc = vdupq_n_u32(0);
+    auto end       = std::min(dim, i + kIntBlock);
+    for (; i + 16 <= end; i += 16) {
+      acc = vpadalq_u16(acc, vpaddlq_u8(vabdq_u8(load16u_neon(x + i), load16u_neon(y + i))));
+    }
+    r += static_cast<float>(vaddvq_u32(acc));
+  }
+  return r + l1_scalar(x + i, y + i, dim - i);
+}
+
+template <typename DataT>
+auto linf_neon_byte(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  uint8x16_t acc = vdupq_n_u8(0);
+  size_t i       = 0;
+  for (; i + 16 <= dim; i += 16) {
+    acc = vmaxq_u8(acc, vabdq_u8(load16u_neon(x + i), load16u_neon(y + i)));
+  }
+  return std::max(static_cast<float>(vmaxvq_u8(acc)), linf_scalar(x + i, y + i, dim - i));
+}
+
+template <typename DataT>
+auto hamming_neon_byte(const DataT* x, const DataT* y, size_t dim) -> float
+{
+  size_t r = 0;
+  size_t i = 0;
+  for (; i + 16 <= dim; i += 16) {
+    uint8x16_t eq = vceqq_u8(load16u_neon(x + i), load16u_neon(y + i));
+    r += 16 - vaddvq_u8(vshrq_n_u8(eq, 7));
+  }
+  return static_cast<float>(r) + hamming_scalar(x + i, y + i, dim - i);
+}
+
+auto l1_neon(const float* x, const float* y, size_t dim) -> float { return l1_neon_fp(x, y, dim); }
+auto l1_neon(const half* x, const half* y, size_t dim) -> float { return l1_neon_fp(x, y, dim); }
+auto l1_neon(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return l1_neon_byte(x, y, dim);
+}
+auto l1_neon(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return l1_neon_byte(x, y, dim);
+}
+auto linf_neon(const float* x, const float* y, size_t dim) -> float
+{
+  return linf_neon_fp(x, y, dim);
+}
+auto linf_neon(const half* x, const half* y, size_t dim) -> float
+{
+  return linf_neon_fp(x, y, dim);
+}
+auto linf_neon(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return linf_neon_byte(x, y, dim);
+}
+auto linf_neon(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return linf_neon_byte(x, y, dim);
+}
+auto hamming_neon(const float* x, const float* y, size_t dim) -> float
+{
+  return hamming_neon_fp(x, y, dim);
+}
+auto hamming_neon(const half* x, const half* y, size_t dim) -> float
+{
+  return hamming_neon_fp(x, y, dim);
+}
+auto hamming_neon(const int8_t* x, const int8_t* y, size_t dim) -> float
+{
+  return hamming_neon_byte(x, y, dim);
+}
+auto hamming_neon(const uint8_t* x, const uint8_t* y, size_t dim) -> float
+{
+  return hamming_neon_byte(x, y, dim);
+}
+
+#endif  // CUVS_HOST_SIMD_NEON
+
+auto detect_simd_isa() -> simd_isa
+{
+  auto isa = simd_isa::kScalar;
+#if defined(CUVS_HOST_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { isa = simd_isa::kAvx2; }
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    isa = simd_isa::kAvx512;
+  }
+#elif defined(CUVS_HOST_SIMD_NEON)
+  isa = simd_isa::kNeon;
+#endif
+  if (const char* env = std::getenv("CUVS_HOST_SIMD"); env != nullptr) {
+    std::string cap(env);
+    if (cap == "scalar") {
+      isa = simd_isa::kScalar;
+    } else if (cap == "avx2" && isa == simd_isa::kAvx512) {
+      isa = simd_isa::kAvx2;
+    }
+  }
+  return isa;
+}
+
+}  // namespace
+
+auto detected_simd_isa() -> simd_isa
+{
+  static const simd_isa isa = detect_simd_isa();
+  return isa;
+}
+
+auto simd_isa_name(simd_isa isa) -> const char*
+{
+  switch (isa) {
+    case simd_isa::kNeon: return "neon";
+    case simd_isa::kAvx2: return "avx2";
+    case simd_isa::kAvx512: return "avx512";
+    default: return "scalar";
+  }
+}
+
+template <typename DataT>
+auto get_distance_kernels(simd_isa isa) -> const distance_kernels<DataT>&
+{
+  using kernel_t = distance_kernel<DataT>;
+  static const distance_kernels<DataT> scalar{&l2_scalar<DataT>,
+                                              &ip_scalar<DataT>,
+                                              &l1_scalar<DataT>,
+                                              &linf_scalar<DataT>,
+                                              &hamming_scalar<DataT>};
+  switch (isa) {
+#if defined(CUVS_HOST_SIMD_X86)
+    case simd_isa::kAvx2: {
+      static const distance_kernels<DataT> avx2{static_cast<kernel_t>(&l2_avx2),
+                                                static_cast<kernel_t>(&ip_avx2),
+                                                static_cast<kernel_t>(&l1_avx2),
+                                                static_cast<kernel_t>(&linf_avx2),
+                                                static_cast<kernel_t>(&hamming_avx2)};
+      return avx2;
+    }
+    case simd_isa::kAvx512: {
+      static const distance_kernels<DataT> avx512{static_cast<kernel_t>(&l2_avx512),
+                                                  static_cast<kernel_t>(&ip_avx512),
+                                                  static_cast<kernel_t>(&l1_avx512),
+                                                  static_cast<kernel_t>(&linf_avx512),
+                                                  static_cast<kernel_t>(&hamming_avx2)};
+      return avx512;
+    }
+#elif defined(CUVS_HOST_SIMD_NEON)
+    case simd_isa::kNeon: {
+      static const distance_kernels<DataT> neon{static_cast<kernel_t>(&l2_neon),
+                                                static_cast<kernel_t>(&ip_neon),
+                                                static_cast<kernel_t>(&l1_neon),
+                                                static_cast<kernel_t>(&linf_neon),
+                                                static_cast<kernel_t>(&hamming_neon)};
+      return neon;
+    }
+#endif
+    default: return scalar;
+  }
+}
+
+template auto get_distance_kernels<float>(simd_isa) -> const distance_kernels<float>&;
+template auto get_distance_kernels<half>(simd_isa) -> const distance_kernels<half>&;
+template auto get_distance_kernels<int8_t>(simd_isa) -> const distance_kernels<int8_t>&;
+template auto get_distance_kernels<uint8_t>(simd_isa) -> const distance_kernels<uint8_t>&;
+
+}  // namespace cuvs::distance::detail::host
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cuda_fp16.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cuvs::distance::detail::host {
+
+/** Instruction set used by the host distance kernels. */
+enum class simd_isa { kScalar, kNeon, kAvx2, kAvx512 };
+
+/**
+ * Returns the best instruction set supported both by the library build and the CPU we run on.
+ *
+ * The result is computed once. Setting the environment variable `CUVS_HOST_SIMD` to one of
+ * `scalar`, `avx2`, `avx512` caps the selection (useful for testing and benchmarking).
+ */
+auto detected_simd_isa() -> simd_isa;
+
+/** Human readable name of the instruction set. */
+auto simd_isa_name(simd_isa isa) -> const char*;
+
+/** Conversion of the supported element types to float. */
+inline auto to_float(float x) -> float { return x; }
+inline auto to_float(half x) -> float { return __half2float(x); }
+inline auto to_float(int8_t x) -> float { return static_cast<float>(x); }
+inline auto to_float(uint8_t x) -> float { return static_cast<float>(x); }
+
+/**
+ * Distance between two vectors of length `dim`, accumulated in single precision.
+ *
+ * The inputs do not need to be aligned.
+ */
+template <typename DataT>
+using distance_kernel = float (*)(const DataT* x, const DataT* y, size_t dim);
+
+/** A set of distance kernels for one data type and instruction set. */
+template <typename DataT>
+struct distance_kernels {
+  /** Squared euclidean distance: sum (x - y)^2 */
+  distance_kernel<DataT> l2;
+  /** Inner product: sum x * y */
+  distance_kernel<DataT> inner_product;
+  /** Manhattan distance: sum |x - y| */
+  distance_kernel<DataT> l1;
+  /** Chebyshev distance: max |x - y| */
+  distance_kernel<DataT> linf;
+  /** Number of mismatching components: sum (x != y) */
+  distance_kernel<DataT> hamming;
+};
+
+/**
+ * Get the kernels for the given instruction set.
+ *
+ * If the instruction set is not available in this build, the scalar kernels are returned.
+ * Calling the returned kernels on a CPU that does not support the instruction set is undefined.
+ */
+template <typename DataT>
+auto get_distance_kernels(simd_isa isa) -> const distance_kernels<DataT>&;
+
+/** Get the kernels for the instruction set selected by the runtime CPU dispatch. */
+template <typename DataT>
+auto get_distance_kernels() -> const distance_kernels<DataT>&
+{
+  static const distance_kernels<DataT>& kernels = get_distance_kernels<DataT>(detected_simd_isa());
+  return kernels;
+}
+
+extern template auto get_distance_kernels<float>(simd_isa) -> const distance_kernels<float>&;
+extern template auto get_distance_kernels<half>(simd_isa) -> const distance_kernels<half>&;
+extern template auto get_distance_kernels<int8_t>(simd_isa) -> const distance_kernels<int8_t>&;
+extern template auto get_distance_kernels<uint8_t>(simd_isa)
+  -> const distance_kernels<uint8_t>&;
+
+}  // namespace cuvs::distance::detail::host
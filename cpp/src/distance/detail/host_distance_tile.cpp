@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host (CPU) kernels computing tiles of inner products, the GEMM part of the expanded distances.
+ *
+ * A micro-kernel keeps an MR x NR block of accumulators in registers and walks the dimension of
+ * MR rows of `x` and NR rows of `y` at once: each step loads MR + NR vectors and issues MR * NR
+ * fused multiply-adds. The block sizes use the register file without spilling: 3 x 4 with the 16
+ * AVX2 registers, 4 x 4 with the 32 AVX-512 and NEON registers. The accumulators of a row are
+ * reduced together at the end, which yields NR consecutive outputs in one vector.
+ *
+ * As with the host distance kernels, the x86 kernels use function-level `target` attributes and
+ * are selected at run time.
+ */
+
+#include "host_distance_tile.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CUVS_HOST_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CUVS_HOST_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cuvs::distance::detail::host {
+
+namespace {
+
+void inner_product_tile_scalar(
+  const float* x, size_t n_x, const float* y, size_t n_y, size_t dim, float* out, size_t ld_out)
+{
+  for (size_t j = 0; j < n_y; j++) {
+    const float* y_row = y + j * dim;
+    for (size_t i = 0; i < n_x; i++) {
+      const float* x_row = x + i * dim;
+      float s            = 0;
+      for (size_t l = 0; l < dim; l++) {
+        s += x_row[l] * y_row[l];
+      }
+      out[i * ld_out + j] = s;
+    }
+  }
+}
+
+/**
+ * The loop over the register blocks shared by the SIMD kernels.
+ *
+ * `Block<MR, NR>::run(x, y, dim, ld_x, out, ld_out)` computes one block; the blocks at the edges
+ * of the tile, which are smaller than MR x NR, are computed one output at a time.
+ */
+template <size_t MR, size_t NR, template <size_t, size_t> class Block>
+inline void tile_loop(
+  const float* x, size_t n_x, const float* y, size_t n_y, size_t dim, float* out, size_t ld_out)
+{
+  for (size_t j = 0; j < n_y; j += NR) {
+    const size_t nr = std::min(NR, n_y - j);
+    for (size_t i = 0; i < n_x; i += MR) {
+      const size_t mr = std::min(MR, n_x - i);
+      if (mr == MR && nr == NR) {
+        Block<MR, NR>::run(x + i * dim, y + j * dim, dim, out + i * ld_out + j, ld_out);
+        continue;
+      }
+      for (size_t a = 0; a < mr; a++) {
+        for (size_t b = 0; b < nr; b++) {
+          Block<1, 1>::run(
+            x + (i + a) * dim, y + (j + b) * dim, dim, out + (i + a) * ld_out + j + b, ld_out);
+        }
+      }
+    }
+  }
+}
+
+#ifdef CUVS_HOST_SIMD_X86
+
+/* ---------------------------------------- AVX2 ---------------------------------------------- */
+
+/** Mask of the first `n` (< 8) lanes, for the tail of the dimension. */
+__attribute__((target("avx2"))) inline auto tail_mask_avx2(size_t n) -> __m256i
+{
+  static const int32_t kMask[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kMask + 8 - n));
+}
+
+/** Sums of the lanes of four vectors: {sum a, sum b, sum c, sum d}. */
+__attribute__((target("avx2"))) inline auto hsum4_avx2(__m256 a, __m256 b, __m256 c, __m256 d)
+  -> __m128
+{
+  __m256 s = _mm256_hadd_ps(_mm256_hadd_ps(a, b), _mm256_hadd_ps(c, d));
+  return _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+}
+
+template <size_t MR, size_t NR>
+struct block_avx2 {
+  __attribute__((target("avx2,fma"))) static inline void run(
+    const float* x, const float* y, size_t dim, float* out, size_t ld_out)
+  {
+    __m256 acc[MR][NR];
+    for (size_t a = 0; a < MR; a++) {
+      for (size_t b = 0; b < NR; b++) {
+        acc[a][b] = _mm256_setzero_ps();
+      }
+    }
+    size_t l = 0;
+    for (; l + 8 <= dim; l += 8) {
+      __m256 xv[MR];
+      for (size_t a = 0; a < MR; a++) {
+        xv[a] = _mm256_loadu_ps(x + a * dim + l);
+      }
+      for (size_t b = 0; b < NR; b++) {
+        __m256 yv = _mm256_loadu_ps(y + b * dim + l);
+        for (size_t a = 0; a < MR; a++) {
+          acc[a][b] = _mm256_fmadd_ps(xv[a], yv, acc[a][b]);
+        }
+      }
+    }
+    if (l < dim) {
+      __m256i mask = tail_mask_avx2(dim - l);
+      __m256 xv[MR];
+      for (size_t a = 0; a < MR; a++) {
+        xv[a] = _mm256_maskload_ps(x + a * dim + l, mask);
+      }
+      for (size_t b = 0; b < NR; b++) {
+        __m256 yv = _mm256_maskload_ps(y + b * dim + l, mask);
+        for (size_t a = 0; a < MR; a++) {
+          acc[a][b] = _mm256_fmadd_ps(xv[a], yv, acc[a][b]);
+        }
+      }
+    }
+    for (size_t a = 0; a < MR; a++) {
+      if constexpr (NR == 4) {
+        _mm_storeu_ps(out + a * ld_out, hsum4_avx2(acc[a][0], acc[a][1], acc[a][2], acc[a][3]));
+      } else {
+        for (size_t b = 0; b < NR; b++) {
+          __m256 z            = _mm256_setzero_ps();
+          out[a * ld_out + b] = _mm_cvtss_f32(hsum4_avx2(acc[a][b], z, z, z));
+        }
+      }
+    }
+  }
+};
+
+__attribute__((target("avx2,fma"))) void inner_product_tile_avx2(
+  const float* x, size_t n_x, const float* y, size_t n_y, size_t dim, float* out, size_t ld_out)
+{
+  tile_loop<3, 4, block_avx2>(x, n_x, y, n_y, dim, out, ld_out);
+}
+
+/* --------------------------------------- AVX-512 -------------------------------------------- */
+
+template <size_t MR, size_t NR>
+struct block_avx512 {
+  __attribute__((target("avx512f,avx2,fma"))) static inline void run(
+    const float* x, const float* y, size_t dim, float* out, size_t ld_out)
+  {
+    __m512 acc[MR][NR];
+    for (size_t a = 0; a < MR; a++) {
+      for (size_t b = 0; b < NR; b++) {
+        acc[a][b] = _mm512_setzero_ps();
+      }
+    }
+    size_t l = 0;
+    for (; l + 16 <= dim; l += 16) {
+      __m512 xv[MR];
+      for (size_t a = 0; a < MR; a++) {
+        xv[a] = _mm512_loadu_ps(x + a * dim + l);
+      }
+      for (size_t b = 0; b < NR; b++) {
+        __m512 yv = _mm512_loadu_ps(y + b * dim + l);
+        for (size_t a = 0; a < MR; a++) {
+          acc[a][b] = _mm512_fmadd_ps(xv[a], yv, acc[a][b]);
+        }
+      }
+    }
+    if (l < dim) {
+      __mmask16 mask = static_cast<__mmask16>((1u << (dim - l)) - 1u);
+      __m512 xv[MR];
+      for (size_t a = 0; a < MR; a++) {
+        xv[a] = _mm512_maskz_loadu_ps(mask, x + a * dim + l);
+      }
+      for (size_t b = 0; b < NR; b++) {
+        __m512 yv = _mm512_maskz_loadu_ps(mask, y + b * dim + l);
+        for (size_t a = 0; a < MR; a++) {
+          acc[a][b] = _mm512_fmadd_ps(xv[a], yv, acc[a][b]);
+        }
+      }
+    }
+    for (size_t a = 0; a < MR; a++) {
+      if constexpr (NR == 4) {
+        __m256 h[4];
+        for (size_t b = 0; b < 4; b++) {
+          h[b] = _mm256_add_ps(
+            _mm512_castps512_ps256(acc[a][b]),
+            _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(acc[a][b]), 1)));
+        }
+        _mm_storeu_ps(out + a * ld_out, hsum4_avx2(h[0], h[1], h[2], h[3]));
+      } else {
+        for (size_t b = 0; b < NR; b++) {
+          out[a * ld_out + b] = _mm512_reduce_add_ps(acc[a][b]);
+        }
+      }
+    }
+  }
+};
+
+__attribute__((target("avx512f,avx2,fma"))) void inner_product_tile_avx512(
+  const float* x, size_t n_x, const float* y, size_t n_y, size_t dim, float* out, size_t ld_out)
+{
+  tile_loop<4, 4, block_avx512>(x, n_x, y, n_y, dim, out, ld_out);
+}
+
+#endif  // CUVS_HOST_SIMD_X86
+
+#ifdef CUVS_HOST_SIMD_NEON
+
+/* ---------------------------------------- NEON ---------------------------------------------- */
+
+template <size_t MR, size_t NR>
+struct block_neon {
+  static inline void run(const float* x, const float* y, size_t dim, float* out, size_t ld_out)
+  {
+    float32x4_t acc[MR][NR];
+    for (size_t a = 0; a < MR; a++) {
+      for (size_t b = 0; b < NR; b++) {
+        acc[a][b] = vdupq_n_f32(0);
+      }
+    }
+    size_t l = 0;
+    for (; l + 4 <= dim; l += 4) {
+      float32x4_t xv[MR];
+      for (size_t a = 0; a < MR; a++) {
+        xv[a] = vld1q_f32(x + a * dim + l);
+      }
+      for (size_t b = 0; b < NR; b++) {
+        float32x4_t yv = vld1q_f32(y + b * dim + l);
+        for (size_t a = 0; a < MR; a++) {
+          acc[a][b] = vfmaq_f32(acc[a][b], xv[a], yv);
+        }
+      }
+    }
+    for (size_t a = 0; a < MR; a++) {
+      float tail[NR] = {};
+      for (size_t t = l; t < dim; t++) {
+        for (size_t b = 0; b < NR; b++) {
+          tail[b] += x[a * dim + t] * y[b * dim + t];
+        }
+      }
+      if constexpr (NR == 4) {
+        float32x4_t s =
+          vpaddq_f32(vpaddq_f32(acc[a][0], acc[a][1]), vpaddq_f32(acc[a][2], acc[a][3]));
+        vst1q_f32(out + a * ld_out, vaddq_f32(s, vld1q_f32(tail)));
+      } else {
+        for (size_t b = 0; b < NR; b++) {
+          out[a * ld_out + b] = vaddvq_f32(acc[a][b]) + tail[b];
+        }
+      }
+    }
+  }
+};
+
+void inner_product_tile_neon(
+  const float* x, size_t n_x, const float* y, size_t n_y, size_t dim, float* out, size_t ld_out)
+{
+  tile_loop<4, 4, block_neon>(x, n_x, y, n_y, dim, out, ld_out);
+}
+
+#endif  // CUVS_HOST_SIMD_NEON
+
+}  // namespace
+
+auto get_inner_product_tile_kernel(simd_isa isa) -> inner_product_tile_kernel
+{
+  switch (isa) {
+#if defined(CUVS_HOST_SIMD_X86)
+    case simd_isa::kAvx2: return &inner_product_tile_avx2;
+    case simd_isa::kAvx512: return &inner_product_tile_avx512;
+#elif defined(CUVS_HOST_SIMD_NEON)
+    case simd_isa::kNeon: return &inner_product_tile_neon;
+#endif
+    default: return &inner_product_tile_scalar;
+  }
+}
+
+}  // namespace cuvs::distance::detail::host
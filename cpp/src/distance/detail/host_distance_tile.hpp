@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "host_distance.hpp"
+
+#include <cstddef>
+
+namespace cuvs::distance::detail::host {
+
+/**
+ * Inner products of all pairs of rows of two row-major tiles:
+ *
+ *   out[i * ld_out + j] = sum_l x[i * dim + l] * y[j * dim + l],  i < n_x, j < n_y
+ *
+ * This is the NT matrix product X * Y^T of a distance tile. The kernels compute it in register
+ * blocks of a few rows of `x` by a few rows of `y`, so every loaded vector of one tile is used
+ * against several rows of the other. The rows of `y` are the outer loop: they are streamed once,
+ * while the `x` tile is reused and should fit in the L2 cache.
+ */
+using inner_product_tile_kernel = void (*)(const float* x,
+                                           size_t n_x,
+                                           const float* y,
+                                           size_t n_y,
+                                           size_t dim,
+                                           float* out,
+                                           size_t ld_out);
+
+/**
+ * Get the tile kernel for the given instruction set.
+ *
+ * If the instruction set is not available in this build, the scalar kernel is returned.
+ */
+auto get_inner_product_tile_kernel(simd_isa isa) -> inner_product_tile_kernel;
+
+/** Get the tile kernel for the instruction set selected by the runtime CPU dispatch. */
+inline auto get_inner_product_tile_kernel() -> inner_product_tile_kernel
+{
+  static const inner_product_tile_kernel kernel =
+    get_inner_product_tile_kernel(detected_simd_isa());
+  return kernel;
+}
+
+}  // namespace cuvs::distance::detail::host
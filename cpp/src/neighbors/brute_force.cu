@@ -21,6 +21,16 @@
 #include <raft/core/copy.hpp>
 
 namespace cuvs::neighbors::brute_force {
+template <typename T>
+index<T>::index(raft::resources const& res)
+  : cuvs::neighbors::index(),
+    metric_(cuvs::distance::DistanceType::L2Unexpanded),
+    dataset_(raft::make_device_matrix<T, int64_t>(res, 0, 0)),
+    dataset_view_(raft::make_const_mdspan(dataset_.view())),
+    metric_arg_(0)
+{
+}
+
 template <typename T>
 index<T>::index(raft::resources const& res,
                 raft::host_matrix_view<const T, int64_t, raft::row_major> dataset,
@@ -17,6 +17,8 @@
 
 #include <cstdint>
 #include <dlpack/dlpack.h>
+#include <fstream>
+#include <string>
 
 #include <raft/core/error.hpp>
 #include <raft/core/mdspan_types.hpp>
@@ -28,6 +30,9 @@
 #include <cuvs/neighbors/brute_force.h>
 #include <cuvs/neighbors/brute_force.hpp>
 
+#include "../core/c_api_stream.hpp"
+#include "detail/container_serialize.hpp"
+
 namespace {
 
 template <typename T>
@@ -69,6 +74,41 @@ void _search(cuvsResources_t res,
     *res_ptr, *index_ptr, queries_mds, neighbors_mds, distances_mds, std::nullopt);
 }
 
+template <typename T>
+void _serialize(cuvsResources_t res, std::ostream& os, cuvsBruteForceIndex index)
+{
+  auto res_ptr   = reinterpret_cast<raft::resources*>(res);
+  auto index_ptr = reinterpret_cast<cuvs::neighbors::brute_force::index<T>*>(index.addr);
+  cuvs::neighbors::brute_force::serialize(*res_ptr, os, *index_ptr);
+}
+
+void _serialize(cuvsResources_t res, std::ostream& os, cuvsBruteForceIndex_t index)
+{
+  if (index->dtype.code == kDLFloat && index->dtype.bits == 32) {
+    _serialize<float>(res, os, *index);
+  } else {
+    RAFT_FAIL("Unsupported index dtype: %d and bits: %d", index->dtype.code, index->dtype.bits);
+  }
+  os.flush();
+  RAFT_EXPECTS(os.good(), "Error writing the brute force index");
+}
+
+/** Load an index; only float indexes are supported, the others are rejected by `deserialize`. */
+void _deserialize(cuvsResources_t res, std::istream& is, cuvsBruteForceIndex_t index)
+{
+  auto res_ptr   = reinterpret_cast<raft::resources*>(res);
+  auto index_ptr = new cuvs::neighbors::brute_force::index<float>(*res_ptr);
+  try {
+    cuvs::neighbors::brute_force::deserialize(*res_ptr, is, index_ptr);
+  } catch (...) {
+    delete index_ptr;
+    throw;
+  }
+  index->addr       = reinterpret_cast<uintptr_t>(index_ptr);
+  index->dtype.code = kDLFloat;
+  index->dtype.bits = 32;
+}
+
 }  // namespace
 
 extern "C" cuvsError_t cuvsBruteForceIndexCreate(cuvsBruteForceIndex_t* index)
@@ -108,6 +148,7 @@ extern "C" cuvsError_t cuvsBruteForceBuild(cuvsResources_t res,
       index->addr =
         reinterpret_cast<uintptr_t>(_build<float>(res, dataset_tensor, metric, metric_arg));
       index->dtype.code = kDLFloat;
+      index->dtype.bits = 32;
     } else {
       RAFT_FAIL("Unsupported dataset DLtensor dtype: %d and bits: %d",
                 dataset.dtype.code,
@@ -151,3 +192,61 @@ extern "C" cuvsError_t cuvsBruteForceSearch(cuvsResources_t res,
     }
   });
 }
+
+extern "C" cuvsError_t cuvsBruteForceSerialize(cuvsResources_t res,
+                                               const char* filename,
+                                               cuvsBruteForceIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    if (!os) { RAFT_FAIL("Cannot open file %s", filename); }
+    _serialize(res, os, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsBruteForceSerializeToStream(cuvsResources_t res,
+                                                       cuvsWriteCallback write,
+                                                       void* context,
+                                                       cuvsBruteForceIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::core::detail::callback_writebuf buf(write, context);
+    std::ostream os(&buf);
+    _serialize(res, os, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsBruteForceDeserialize(cuvsResources_t res,
+                                                 const char* filename,
+                                                 cuvsBruteForceIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    std::ifstream is(filename, std::ios::in | std::ios::binary);
+    if (!is) { RAFT_FAIL("Cannot open file %s", filename); }
+    _deserialize(res, is, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsBruteForceDeserializeFromStream(cuvsResources_t res,
+                                                           cuvsReadCallback read,
+                                                           void* context,
+                                                           cuvsBruteForceIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::core::detail::callback_readbuf buf(read, context);
+    std::istream is(&buf);
+    _deserialize(res, is, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsBruteForceDeserializeFromBuffer(cuvsResources_t res,
+                                                           const void* data,
+                                                           size_t size,
+                                                           cuvsBruteForceIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::neighbors::detail::memory_readbuf buf(static_cast<const uint8_t*>(data), size);
+    std::istream is(&buf);
+    _deserialize(res, is, index);
+  });
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "detail/knn_brute_force_host.hpp"
+#include <cuvs/neighbors/brute_force.hpp>
+
+namespace cuvs::neighbors::brute_force {
+
+template <typename T>
+host_index<T>::host_index(raft::resources const& res,
+                          raft::host_matrix_view<const T, int64_t, raft::row_major> dataset_view,
+                          cuvs::distance::DistanceType metric,
+                          T metric_arg)
+  : cuvs::neighbors::index(),
+    metric_(metric),
+    dataset_view_(dataset_view),
+    norms_(detail::compute_norms_host(dataset_view, metric)),
+    metric_arg_(metric_arg)
+{
+}
+
+#define CUVS_INST_BFKNN_HOST(T)                                                    \
+  void search(raft::resources const& res,                                          \
+              const cuvs::neighbors::brute_force::host_index<T>& idx,              \
+              raft::host_matrix_view<const T, int64_t, raft::row_major> queries,   \
+              raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors, \
+              raft::host_matrix_view<T, int64_t, raft::row_major> distances)       \
+  {                                                                                \
+    detail::search_host<T>(res, idx, queries, neighbors, distances);               \
+  }                                                                                \
+                                                                                   \
+  template struct cuvs::neighbors::brute_force::host_index<T>;
+
+CUVS_INST_BFKNN_HOST(float);
+
+#undef CUVS_INST_BFKNN_HOST
+
+}  // namespace cuvs::neighbors::brute_force
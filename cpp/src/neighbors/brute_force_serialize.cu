@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./detail/knn_brute_force_serialize.cuh"
+
+#include <cuvs/neighbors/brute_force.hpp>
+
+#include <sstream>
+
+namespace cuvs::neighbors::brute_force {
+
+#define CUVS_INST_BFKNN_SERIALIZE(T)                                                  \
+  void serialize_file(raft::resources const& handle,                                  \
+                      const std::string& filename,                                    \
+                      const cuvs::neighbors::brute_force::index<T>& index,            \
+                      cuvs::neighbors::serialize_compression compression)             \
+  {                                                                                   \
+    detail::serialize(handle, filename, index, compression);                          \
+  }                                                                                   \
+                                                                                      \
+  void serialize(raft::resources const& handle,                                       \
+                 std::string& str,                                                    \
+                 const cuvs::neighbors::brute_force::index<T>& index,                 \
+                 cuvs::neighbors::serialize_compression compression)                  \
+  {                                                                                   \
+    std::ostringstream os;                                                            \
+    detail::serialize(handle, os, index, compression);                                \
+    str = os.str();                                                                   \
+  }                                                                                   \
+                                                                                      \
+  void serialize(raft::resources const& handle,                                       \
+                 std::ostream& os,                                                    \
+                 const cuvs::neighbors::brute_force::index<T>& index,                 \
+                 cuvs::neighbors::serialize_compression compression)                  \
+  {                                                                                   \
+    detail::serialize(handle, os, index, compression);                                \
+  }                                                                                   \
+                                                                                      \
+  void deserialize_file(raft::resources const& handle,                                \
+                        const std::string& filename,                                  \
+                        cuvs::neighbors::brute_force::index<T>* index)                \
+  {                                                                                   \
+    if (!index) { RAFT_FAIL("Invalid index pointer"); }                               \
+    *index = detail::deserialize<T>(handle, filename);                                \
+  }                                                                                   \
+                                                                                      \
+  void deserialize(raft::resources const& handle,                                     \
+                   const std::string& str,                                            \
+                   cuvs::neighbors::brute_force::index<T>* index)                     \
+  {                                                                                   \
+    if (!index) { RAFT_FAIL("Invalid index pointer"); }                               \
+    std::istringstream is(str);                                                       \
+    *index = detail::deserialize<T>(handle, is);                                      \
+  }                                                                                   \
+                                                                                      \
+  void deserialize(raft::resources const& handle,                                     \
+                   std::istream& is,                                                  \
+                   cuvs::neighbors::brute_force::index<T>* index)                     \
+  {                                                                                   \
+    if (!index) { RAFT_FAIL("Invalid index pointer"); }                               \
+    *index = detail::deserialize<T>(handle, is);                                      \
+  }
+
+CUVS_INST_BFKNN_SERIALIZE(float);
+
+#undef CUVS_INST_BFKNN_SERIALIZE
+
+}  // namespace cuvs::neighbors::brute_force
@@ -17,6 +17,8 @@
 
 #include <cstdint>
 #include <dlpack/dlpack.h>
+#include <fstream>
+#include <string>
 
 #include <raft/core/error.hpp>
 #include <raft/core/mdspan_types.hpp>
@@ -29,6 +31,8 @@
 #include <cuvs/neighbors/cagra.h>
 #include <cuvs/neighbors/cagra.hpp>
 
+#include "detail/container_serialize.hpp"
+
 namespace {
 
 template <typename T>
@@ -290,9 +294,8 @@ extern "C" cuvsError_t cuvsCagraDeserialize(cuvsResources_t res,
     // read the numpy dtype from the beginning of the file
     std::ifstream is(filename, std::ios::in | std::ios::binary);
     if (!is) { RAFT_FAIL("Cannot open file %s", filename); }
-    char dtype_string[4];
-    is.read(dtype_string, 4);
-    auto dtype = raft::detail::numpy_serializer::parse_descr(std::string(dtype_string, 4));
+    auto dtype_string = cuvs::neighbors::detail::read_index_dtype(is, "cagra");
+    auto dtype = raft::detail::numpy_serializer::parse_descr(dtype_string);
 
     index->dtype.bits = dtype.itemsize * 8;
     if (dtype.kind == 'f' && dtype.itemsize == 4) {
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "detail/cagra/cagra_extend_host.hpp"
+#include <cuvs/neighbors/cagra.hpp>
+
+namespace cuvs::neighbors::cagra {
+
+#define CUVS_INST_CAGRA_EXTEND_HOST(T, IdxT)                                         \
+  void extend(raft::resources const& handle,                                         \
+              cuvs::neighbors::cagra::extend_params const& params,                   \
+              cuvs::distance::DistanceType metric,                                   \
+              raft::host_matrix_view<const T, int64_t, raft::row_major> dataset,     \
+              raft::host_matrix_view<const IdxT, int64_t, raft::row_major> graph,    \
+              raft::host_matrix_view<IdxT, int64_t, raft::row_major> new_graph)      \
+  {                                                                                  \
+    detail::extend_host<T, IdxT>(handle, params, metric, dataset, graph, new_graph); \
+  }
+
+CUVS_INST_CAGRA_EXTEND_HOST(float, uint32_t);
+CUVS_INST_CAGRA_EXTEND_HOST(int8_t, uint32_t);
+CUVS_INST_CAGRA_EXTEND_HOST(uint8_t, uint32_t);
+
+#undef CUVS_INST_CAGRA_EXTEND_HOST
+
+}  // namespace cuvs::neighbors::cagra
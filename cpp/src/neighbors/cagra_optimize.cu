@@ -23,13 +23,13 @@ void optimize(raft::resources const& handle,
               raft::device_matrix_view<uint32_t, int64_t, raft::row_major> knn_graph,
               raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph)
 {
-  cuvs::neighbors::cagra::optimize(handle, knn_graph, new_graph);
+  cuvs::neighbors::cagra::optimize<uint32_t>(handle, knn_graph, new_graph);
 }
 void optimize(raft::resources const& handle,
               raft::host_matrix_view<uint32_t, int64_t, raft::row_major> knn_graph,
               raft::host_matrix_view<uint32_t, int64_t, raft::row_major> new_graph)
 {
-  cuvs::neighbors::cagra::optimize(handle, knn_graph, new_graph);
+  cuvs::neighbors::cagra::optimize<uint32_t>(handle, knn_graph, new_graph);
 }
 
 }  // namespace cuvs::neighbors::cagra
\ No newline at end of file
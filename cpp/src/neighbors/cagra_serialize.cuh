@@ -49,15 +49,17 @@ namespace cuvs::neighbors::cagra {
  * @param[in] os output stream
  * @param[in] index CAGRA index
  * @param[in] include_dataset Whether or not to write out the dataset to the file.
+ * @param[in] compression compression of the graph and the dataset
  *
  */
 template <typename T, typename IdxT>
 void serialize(raft::resources const& handle,
                std::ostream& os,
                const index<T, IdxT>& index,
-               bool include_dataset = true)
+               bool include_dataset              = true,
+               serialize_compression compression = serialize_compression::NONE)
 {
-  detail::serialize(handle, os, index, include_dataset);
+  detail::serialize(handle, os, index, include_dataset, compression);
 }
 
 /**
@@ -84,19 +86,89 @@ void serialize(raft::resources const& handle,
  * @param[in] filename the file name for saving the index
  * @param[in] index CAGRA index
  * @param[in] include_dataset Whether or not to write out the dataset to the file.
+ * @param[in] compression compression of the graph and the dataset
  *
  */
 template <typename T, typename IdxT>
 void serialize(raft::resources const& handle,
                const std::string& filename,
                const index<T, IdxT>& index,
-               bool include_dataset = true)
+               bool include_dataset              = true,
+               serialize_compression compression = serialize_compression::NONE)
 {
-  detail::serialize(handle, filename, index, include_dataset);
+  detail::serialize(handle, filename, index, include_dataset, compression);
 }
 
 /**
- * Write the CAGRA built index as a base layer HNSW index to an output stream
+ * Save the index in the mapped file layout, to be loaded with `deserialize_mapped`.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/cagra_serialize.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * // create an index with `auto index = cuvs::neighbors::cagra::build(...);`
+ * cuvs::neighbors::cagra::serialize_mapped(handle, filename, index);
+ * @endcode
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the indices
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index CAGRA index
+ * @param[in] include_dataset Whether or not to write out the dataset to the file.
+ *
+ */
+template <typename T, typename IdxT>
+void serialize_mapped(raft::resources const& handle,
+                      const std::string& filename,
+                      const index<T, IdxT>& index,
+                      bool include_dataset = true)
+{
+  detail::serialize_mapped(handle, filename, index, include_dataset);
+}
+
+/**
+ * Map an index saved by `serialize_mapped` into host memory, without copying it.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/cagra_serialize.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create a string with a filepath
+ * std::string filename("/path/to/index");
+ * auto index = cuvs::neighbors::cagra::deserialize_mapped<float, uint32_t>(handle, filename);
+ * @endcode
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the indices
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ *
+ * @return cuvs::neighbors::cagra::mapped_index<T, IdxT>
+ */
+template <typename T, typename IdxT>
+mapped_index<T, IdxT> deserialize_mapped(raft::resources const& handle,
+                                         const std::string& filename)
+{
+  return detail::deserialize_mapped<T, IdxT>(filename);
+}
+
+/**
+ * Write the CAGRA built index as an HNSW index to an output stream.
+ *
+ * The CAGRA graph is the base layer; the upper layers are built on the host.
  *
  * Experimental, both the API and the serialization format are subject to change.
  *
@@ -129,7 +201,7 @@ void serialize_to_hnswlib(raft::resources const& handle,
 }
 
 /**
- * Save a CAGRA build index in hnswlib base-layer-only serialized format
+ * Save a CAGRA build index in hnswlib serialized format
  *
  * Experimental, both the API and the serialization format are subject to change.
  *
@@ -161,6 +233,60 @@ void serialize_to_hnswlib(raft::resources const& handle,
   detail::serialize_to_hnswlib<T, IdxT>(handle, filename, index);
 }
 
+/**
+ * Write a host-resident or memory-mapped CAGRA index as an HNSW index to an output stream.
+ * No GPU is needed.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/cagra_serialize.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // map an index saved with `cuvs::neighbors::cagra::serialize_mapped(...)`
+ * auto index = cuvs::neighbors::cagra::deserialize_mapped<float, uint32_t>(handle, "index");
+ * cuvs::neighbors::cagra::serialize_to_hnswlib(handle, "index.hnsw", index);
+ * @endcode
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the indices
+ *
+ * @param[in] handle the raft handle
+ * @param[in] os output stream
+ * @param[in] index mapped CAGRA index (must include the dataset)
+ *
+ */
+template <typename T, typename IdxT>
+void serialize_to_hnswlib(raft::resources const& handle,
+                          std::ostream& os,
+                          const cuvs::neighbors::cagra::mapped_index<T, IdxT>& index)
+{
+  detail::serialize_to_hnswlib<T, IdxT>(handle, os, index);
+}
+
+/**
+ * Save a host-resident or memory-mapped CAGRA index in hnswlib serialized format.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the indices
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the file name for saving the index
+ * @param[in] index mapped CAGRA index (must include the dataset)
+ *
+ */
+template <typename T, typename IdxT>
+void serialize_to_hnswlib(raft::resources const& handle,
+                          const std::string& filename,
+                          const cuvs::neighbors::cagra::mapped_index<T, IdxT>& index)
+{
+  detail::serialize_to_hnswlib<T, IdxT>(handle, filename, index);
+}
+
 /**
  * Load index from input stream
  *
@@ -225,6 +351,71 @@ index<T, IdxT> deserialize(raft::resources const& handle, const std::string& fil
   return detail::deserialize<T, IdxT>(handle, filename);
 }
 
+/**
+ * Import an hnswlib index from an input stream.
+ *
+ * The base layer of the hnswlib index becomes the CAGRA graph: the neighbor lists are sorted by
+ * distance, padded (with neighbors of neighbors) to a fixed degree, and pruned to
+ * `params.graph_degree` with `optimize`. Deleted elements are dropped, and the rows are ordered
+ * by hnswlib label. The upper layers are not used. Only `params.metric`, which must be the metric
+ * the hnswlib index was built with (L2 or inner product), and `params.graph_degree` are used.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @code{.cpp}
+ * #include <raft/core/resources.hpp>
+ * #include <cuvs/neighbors/cagra_serialize.hpp>
+ *
+ * raft::resources handle;
+ *
+ * // create an input stream
+ * std::ifstream is("/path/to/index.hnsw", std::ios::binary);
+ * cuvs::neighbors::cagra::index_params params;
+ * params.metric       = cuvs::distance::DistanceType::L2Expanded;
+ * params.graph_degree = 32;
+ * auto index = cuvs::neighbors::cagra::deserialize_from_hnswlib<float, uint32_t>(handle, is,
+ *                                                                                params);
+ * @endcode
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the indices
+ *
+ * @param[in] handle the raft handle
+ * @param[in] is input stream
+ * @param[in] params the metric of the hnswlib index and the CAGRA graph degree
+ *
+ * @return cuvs::neighbors::cagra::index<T, IdxT>
+ */
+template <typename T, typename IdxT>
+index<T, IdxT> deserialize_from_hnswlib(raft::resources const& handle,
+                                        std::istream& is,
+                                        const index_params& params)
+{
+  return detail::deserialize_from_hnswlib<T, IdxT>(handle, is, params);
+}
+
+/**
+ * Import an hnswlib index from a file.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @tparam T data element type
+ * @tparam IdxT type of the indices
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the hnswlib index
+ * @param[in] params the metric of the hnswlib index and the CAGRA graph degree
+ *
+ * @return cuvs::neighbors::cagra::index<T, IdxT>
+ */
+template <typename T, typename IdxT>
+index<T, IdxT> deserialize_from_hnswlib(raft::resources const& handle,
+                                        const std::string& filename,
+                                        const index_params& params)
+{
+  return detail::deserialize_from_hnswlib<T, IdxT>(handle, filename, params);
+}
+
 /**@}*/
 
 }  // namespace cuvs::neighbors::cagra
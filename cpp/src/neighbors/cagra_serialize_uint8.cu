@@ -30,9 +30,11 @@ namespace cuvs::neighbors::cagra {
   void serialize_file(raft::resources const& handle,                                              \
                       const std::string& filename,                                                \
                       const cuvs::neighbors::cagra::index<DTYPE, uint32_t>& index,                \
-                      bool include_dataset)                                                       \
+                      bool include_dataset,                                                       \
+                      cuvs::neighbors::serialize_compression compression)                         \
   {                                                                                               \
-    cuvs::neighbors::cagra::serialize<DTYPE, uint32_t>(handle, filename, index, include_dataset); \
+    cuvs::neighbors::cagra::serialize<DTYPE, uint32_t>(                                           \
+      handle, filename, index, include_dataset, compression);                                     \
   };                                                                                              \
                                                                                                   \
   void deserialize_file(raft::resources const& handle,                                            \
@@ -45,10 +47,12 @@ namespace cuvs::neighbors::cagra {
   void serialize(raft::resources const& handle,                                                   \
                  std::string& str,                                                                \
                  const cuvs::neighbors::cagra::index<DTYPE, uint32_t>& index,                     \
-                 bool include_dataset)                                                            \
+                 bool include_dataset,                                                            \
+                 cuvs::neighbors::serialize_compression compression)                              \
   {                                                                                               \
     std::stringstream os;                                                                         \
-    cuvs::neighbors::cagra::serialize<DTYPE, uint32_t>(handle, os, index, include_dataset);       \
+    cuvs::neighbors::cagra::serialize<DTYPE, uint32_t>(                                           \
+      handle, os, index, include_dataset, compression);                                           \
     str = os.str();                                                                               \
   }                                                                                               \
                                                                                                   \
@@ -74,6 +78,59 @@ namespace cuvs::neighbors::cagra {
     std::istringstream is(str);                                                                   \
     if (!index) { RAFT_FAIL("Invalid index pointer"); }                                           \
     *index = cuvs::neighbors::cagra::deserialize<DTYPE, uint32_t>(handle, is);                    \
+  }                                                                                               \
+                                                                                                  \
+  void serialize_mapped_file(raft::resources const& handle,                                       \
+                             const std::string& filename,                                         \
+                             const cuvs::neighbors::cagra::index<DTYPE, uint32_t>& index,         \
+                             bool include_dataset)                                                \
+  {                                                                                               \
+    cuvs::neighbors::cagra::serialize_mapped<DTYPE, uint32_t>(                                    \
+      handle, filename, index, include_dataset);                                                  \
+  }                                                                                               \
+                                                                                                  \
+  void deserialize_mapped_file(raft::resources const& handle,                                     \
+                               const std::string& filename,                                       \
+                               cuvs::neighbors::cagra::mapped_index<DTYPE, uint32_t>* index)      \
+  {                                                                                               \
+    if (!index) { RAFT_FAIL("Invalid index pointer"); }                                           \
+    *index = cuvs::neighbors::cagra::deserialize_mapped<DTYPE, uint32_t>(handle, filename);       \
+  }                                                                                               \
+                                                                                                  \
+  void serialize_to_hnswlib_file(                                                                 \
+    raft::resources const& handle,                                                                \
+    const std::string& filename,                                                                  \
+    const cuvs::neighbors::cagra::mapped_index<DTYPE, uint32_t>& index)                           \
+  {                                                                                               \
+    cuvs::neighbors::cagra::serialize_to_hnswlib<DTYPE, uint32_t>(handle, filename, index);       \
+  }                                                                                               \
+  void serialize_to_hnswlib(raft::resources const& handle,                                        \
+                            std::string& str,                                                     \
+                            const cuvs::neighbors::cagra::mapped_index<DTYPE, uint32_t>& index)   \
+  {                                                                                               \
+    std::stringstream os;                                                                         \
+    cuvs::neighbors::cagra::serialize_to_hnswlib<DTYPE, uint32_t>(handle, os, index);             \
+    str = os.str();                                                                               \
+  }                                                                                               \
+                                                                                                  \
+  void deserialize_from_hnswlib_file(raft::resources const& handle,                               \
+                                     const std::string& filename,                                 \
+                                     const cuvs::neighbors::cagra::index_params& params,          \
+                                     cuvs::neighbors::cagra::index<DTYPE, uint32_t>* index)       \
+  {                                                                                               \
+    if (!index) { RAFT_FAIL("Invalid index pointer"); }                                           \
+    *index = cuvs::neighbors::cagra::deserialize_from_hnswlib<DTYPE, uint32_t>(                   \
+      handle, filename, params);                                                                  \
+  }                                                                                               \
+  void deserialize_from_hnswlib(raft::resources const& handle,                                    \
+                                const std::string& str,                                           \
+                                const cuvs::neighbors::cagra::index_params& params,               \
+                                cuvs::neighbors::cagra::index<DTYPE, uint32_t>* index)            \
+  {                                                                                               \
+    std::istringstream is(str);                                                                   \
+    if (!index) { RAFT_FAIL("Invalid index pointer"); }                                           \
+    *index =                                                                                      \
+      cuvs::neighbors::cagra::deserialize_from_hnswlib<DTYPE, uint32_t>(handle, is, params);      \
   }
 
 RAFT_INST_CAGRA_SERIALIZE(uint8_t);
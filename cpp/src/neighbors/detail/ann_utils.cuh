@@ -141,28 +141,33 @@ struct config {};
 
 template <>
 struct config<double> {
-  using value_t                    = double;
-  static constexpr double kDivisor = 1.0;
+  using value_t                            = double;
+  static constexpr double kDivisor         = 1.0;
+  static constexpr cudaDataType_t kDataType = CUDA_R_64F;
 };
 template <>
 struct config<float> {
-  using value_t                    = float;
-  static constexpr double kDivisor = 1.0;
+  using value_t                            = float;
+  static constexpr double kDivisor         = 1.0;
+  static constexpr cudaDataType_t kDataType = CUDA_R_32F;
 };
 template <>
 struct config<half> {
-  using value_t                    = half;
-  static constexpr double kDivisor = 1.0;
+  using value_t                            = half;
+  static constexpr double kDivisor         = 1.0;
+  static constexpr cudaDataType_t kDataType = CUDA_R_16F;
 };
 template <>
 struct config<uint8_t> {
-  using value_t                    = uint32_t;
-  static constexpr double kDivisor = 256.0;
+  using value_t                            = uint32_t;
+  static constexpr double kDivisor         = 256.0;
+  static constexpr cudaDataType_t kDataType = CUDA_R_8U;
 };
 template <>
 struct config<int8_t> {
-  using value_t                    = int32_t;
-  static constexpr double kDivisor = 128.0;
+  using value_t                            = int32_t;
+  static constexpr double kDivisor         = 128.0;
+  static constexpr cudaDataType_t kDataType = CUDA_R_8I;
 };
 
 /**
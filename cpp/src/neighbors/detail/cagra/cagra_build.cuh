@@ -17,6 +17,7 @@
 
 #include "../../vpq_dataset.cuh"
 #include "graph_core.cuh"
+#include "knn_graph_pipeline.hpp"
 #include <cuvs/neighbors/cagra.hpp>
 
 #include <raft/core/device_mdarray.hpp>
@@ -39,10 +40,15 @@
 // TODO: This shouldn't be calling spatial/knn APIs
 #include "../ann_utils.cuh"
 
+#include <rmm/cuda_device.hpp>
 #include <rmm/resource_ref.hpp>
 
+#include <omp.h>
+#include <unistd.h>
+
 #include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <vector>
 
 namespace cuvs::neighbors::cagra::detail {
@@ -73,51 +79,15 @@ void write_to_graph(raft::host_matrix_view<IdxT, int64_t, raft::row_major> knn_g
   }
 }
 
-template <typename DataT, typename IdxT, typename accessor>
-void refine_host_and_write_graph(
-  raft::resources const& res,
-  raft::host_matrix<DataT, int64_t>& queries_host,
-  raft::host_matrix<int64_t, int64_t>& neighbors_host,
-  raft::host_matrix<int64_t, int64_t>& refined_neighbors_host,
-  raft::host_matrix<float, int64_t>& refined_distances_host,
-  raft::mdspan<const DataT, raft::matrix_extent<int64_t>, raft::row_major, accessor> dataset,
-  raft::host_matrix_view<IdxT, int64_t, raft::row_major> knn_graph,
-  cuvs::distance::DistanceType metric,
-  size_t& num_self_included,
-  size_t batch_size,
-  size_t batch_offset,
-  int top_k,
-  int gpu_top_k)
-{
-  bool do_refine = top_k != gpu_top_k;
-
-  auto refined_neighbors_host_view = raft::make_host_matrix_view<int64_t, int64_t>(
-    do_refine ? refined_neighbors_host.data_handle() : neighbors_host.data_handle(),
-    batch_size,
-    top_k);
-
-  if (do_refine) {
-    // needed for compilation as this routine will also be run for device data with !do_refine
-    if constexpr (raft::is_host_mdspan_v<decltype(dataset)>) {
-      auto queries_host_view = raft::make_host_matrix_view<const DataT, int64_t>(
-        queries_host.data_handle(), batch_size, dataset.extent(1));
-      auto neighbors_host_view = raft::make_host_matrix_view<const int64_t, int64_t>(
-        neighbors_host.data_handle(), batch_size, neighbors_host.extent(1));
-      auto refined_distances_host_view = raft::make_host_matrix_view<float, int64_t>(
-        refined_distances_host.data_handle(), batch_size, top_k);
-      cuvs::neighbors::refine(res,
-                              dataset,
-                              queries_host_view,
-                              neighbors_host_view,
-                              refined_neighbors_host_view,
-                              refined_distances_host_view,
-                              metric);
-    }
-  }
-
-  write_to_graph(
-    knn_graph, refined_neighbors_host_view, num_self_included, batch_size, batch_offset);
-}
+/** The host buffers of one batch of the kNN graph build. */
+template <typename DataT>
+struct knn_graph_buffer {
+  /** The rows of the batch, for a dataset in host memory. */
+  raft::host_matrix<DataT, int64_t> queries;
+  raft::host_matrix<int64_t, int64_t> neighbors;
+  raft::host_matrix<int64_t, int64_t> refined_neighbors;
+  raft::host_matrix<float, int64_t> refined_distances;
+};
 
 template <typename DataT, typename IdxT, typename accessor>
 void build_knn_graph(
@@ -162,124 +132,110 @@ void build_knn_graph(
   // search top (k + 1) neighbors
   //
 
-  const auto top_k          = node_degree + 1;
-  uint32_t gpu_top_k        = node_degree * pq.refinement_rate;
-  gpu_top_k                 = std::min<IdxT>(std::max(gpu_top_k, top_k), dataset.extent(0));
-  const auto num_queries    = dataset.extent(0);
-  const auto max_batch_size = 1024;
+  const auto top_k       = node_degree + 1;
+  uint32_t gpu_top_k     = node_degree * pq.refinement_rate;
+  gpu_top_k              = std::min<IdxT>(std::max(gpu_top_k, top_k), dataset.extent(0));
+  const auto num_queries = dataset.extent(0);
+  const size_t dim       = dataset.extent(1);
+  const bool do_refine   = top_k != gpu_top_k;
+  // A dataset in host memory is refined on the host, in the pipeline; one on the device is refined
+  // on the device, by the search stage.
+  constexpr bool host_dataset = raft::is_host_mdspan_v<decltype(dataset)>;
+
+  // TODO(tfeher): batched search with multiple GPUs
+  knn_graph_pipeline_params pipeline;
+  pipeline.n_rows           = num_queries;
+  pipeline.n_buffers        = std::max<size_t>(pq.n_pipeline_buffers, 2);
+  pipeline.n_refine_threads = pq.n_refine_threads > 0
+                                ? pq.n_refine_threads
+                                : std::max<size_t>(pipeline.n_buffers - 2, 1);
+  pipeline.batch_size       = pq.max_batch_size;
+  if (pipeline.batch_size == 0) {
+    const size_t query_bytes = host_dataset ? dim * sizeof(DataT) : 0;
+    const size_t device_bytes_per_row =
+      query_bytes + gpu_top_k * (sizeof(int64_t) + sizeof(float)) +
+      (!host_dataset && do_refine ? top_k * (sizeof(int64_t) + sizeof(float)) : 0);
+    const size_t host_bytes_per_row =
+      query_bytes + gpu_top_k * sizeof(int64_t) + top_k * (sizeof(int64_t) + sizeof(float));
+    const size_t free_host_bytes   = size_t(sysconf(_SC_AVPHYS_PAGES)) * sysconf(_SC_PAGESIZE);
+    const size_t free_device_bytes = rmm::available_device_memory().first;
+
+    pipeline.batch_size = choose_knn_graph_batch_size(num_queries,
+                                                      device_bytes_per_row,
+                                                      host_bytes_per_row,
+                                                      pipeline.n_buffers,
+                                                      free_device_bytes,
+                                                      free_host_bytes);
+  }
+  const auto max_batch_size = static_cast<int64_t>(pipeline.batch_size);
   RAFT_LOG_DEBUG(
-    "IVF-PQ search node_degree: %d, top_k: %d,  gpu_top_k: %d,  max_batch_size:: %d, n_probes: %u",
+    "IVF-PQ search node_degree: %d, top_k: %d,  gpu_top_k: %d,  max_batch_size:: %ld, n_probes: "
+    "%u, buffers: %lu, refine threads: %lu",
     node_degree,
     top_k,
     gpu_top_k,
     max_batch_size,
-    pq.search_params.n_probes);
+    pq.search_params.n_probes,
+    pipeline.n_buffers,
+    pipeline.n_refine_threads);
 
+  auto stream    = raft::resource::get_cuda_stream(res);
   auto distances = raft::make_device_matrix<float, int64_t>(res, max_batch_size, gpu_top_k);
   auto neighbors = raft::make_device_matrix<int64_t, int64_t>(res, max_batch_size, gpu_top_k);
-  auto refined_distances = raft::make_device_matrix<float, int64_t>(res, max_batch_size, top_k);
-  auto refined_neighbors = raft::make_device_matrix<int64_t, int64_t>(res, max_batch_size, top_k);
-  auto neighbors_host    = raft::make_host_matrix<int64_t, int64_t>(max_batch_size, gpu_top_k);
-  auto queries_host = raft::make_host_matrix<DataT, int64_t>(max_batch_size, dataset.extent(1));
-  auto refined_neighbors_host = raft::make_host_matrix<int64_t, int64_t>(max_batch_size, top_k);
-  auto refined_distances_host = raft::make_host_matrix<float, int64_t>(max_batch_size, top_k);
-
-  // TODO(tfeher): batched search with multiple GPUs
-  std::size_t num_self_included = 0;
-  bool first                    = true;
-  const auto start_clock        = std::chrono::system_clock::now();
-
-  rmm::device_async_resource_ref device_memory = raft::resource::get_workspace_resource(res);
-
-  cuvs::spatial::knn::detail::utils::batch_load_iterator<DataT> vec_batches(
-    dataset.data_handle(),
-    dataset.extent(0),
-    dataset.extent(1),
-    (int64_t)max_batch_size,
-    raft::resource::get_cuda_stream(res),
-    device_memory);
-
-  size_t next_report_offset = 0;
-  size_t d_report_offset    = dataset.extent(0) / 100;  // Report progress in 1% steps.
-
-  bool async_host_processing   = raft::is_host_mdspan_v<decltype(dataset)> || top_k == gpu_top_k;
-  size_t previous_batch_size   = 0;
-  size_t previous_batch_offset = 0;
+  // The device buffers of the rows of a host dataset, and of the results of the device refine.
+  auto queries_device =
+    raft::make_device_matrix<DataT, int64_t>(res, host_dataset ? max_batch_size : 0, dim);
+  const int64_t refined_rows = !host_dataset && do_refine ? max_batch_size : 0;
+  auto refined_distances     = raft::make_device_matrix<float, int64_t>(res, refined_rows, top_k);
+  auto refined_neighbors = raft::make_device_matrix<int64_t, int64_t>(res, refined_rows, top_k);
+
+  std::vector<knn_graph_buffer<DataT>> buffers;
+  for (size_t b = 0; b < pipeline.n_buffers; b++) {
+    const int64_t refined_host_rows = do_refine ? max_batch_size : 0;
+    buffers.push_back(knn_graph_buffer<DataT>{
+      raft::make_host_matrix<DataT, int64_t>(host_dataset ? max_batch_size : 0, dim),
+      raft::make_host_matrix<int64_t, int64_t>(max_batch_size, gpu_top_k),
+      raft::make_host_matrix<int64_t, int64_t>(refined_host_rows, top_k),
+      raft::make_host_matrix<float, int64_t>(host_dataset ? refined_host_rows : 0, top_k)});
+  }
 
-  for (const auto& batch : vec_batches) {
+  // Gather the rows of the batch on the producer thread, so that the page faults of a dataset in
+  // a (memory-mapped) file do not stall the search.
+  auto produce_batch = [&]([[maybe_unused]] const knn_graph_batch& batch) {
+    if constexpr (host_dataset) {
+      std::memcpy(buffers[batch.buffer].queries.data_handle(),
+                  dataset.data_handle() + batch.offset * dim,
+                  batch.size * dim * sizeof(DataT));
+    }
+  };
+
+  auto search_batch = [&](const knn_graph_batch& batch) {
+    auto& buffer             = buffers[batch.buffer];
+    const DataT* queries_ptr = dataset.data_handle() + batch.offset * dim;
+    if constexpr (host_dataset) {
+      raft::copy(
+        queries_device.data_handle(), buffer.queries.data_handle(), batch.size * dim, stream);
+      queries_ptr = queries_device.data_handle();
+    }
     // Map int64_t to uint32_t because ivf_pq requires the latter.
     // TODO(tfeher): remove this mapping once ivf_pq accepts mdspan with int64_t index type
-    auto queries_view = raft::make_device_matrix_view<const DataT, uint32_t>(
-      batch.data(), batch.size(), batch.row_width());
+    auto queries_view =
+      raft::make_device_matrix_view<const DataT, uint32_t>(queries_ptr, batch.size, dim);
     auto neighbors_view = raft::make_device_matrix_view<int64_t, uint32_t>(
-      neighbors.data_handle(), batch.size(), neighbors.extent(1));
+      neighbors.data_handle(), batch.size, neighbors.extent(1));
     auto distances_view = raft::make_device_matrix_view<float, uint32_t>(
-      distances.data_handle(), batch.size(), distances.extent(1));
+      distances.data_handle(), batch.size, distances.extent(1));
 
     cuvs::neighbors::ivf_pq::search(
       res, pq.search_params, index, queries_view, neighbors_view, distances_view);
 
-    if (async_host_processing) {
-      // process previous batch async on host
-      // NOTE: the async path also covers disabled refinement (top_k == gpu_top_k)
-      if (previous_batch_size > 0) {
-        refine_host_and_write_graph(res,
-                                    queries_host,
-                                    neighbors_host,
-                                    refined_neighbors_host,
-                                    refined_distances_host,
-                                    dataset,
-                                    knn_graph,
-                                    pq.build_params.metric,
-                                    num_self_included,
-                                    previous_batch_size,
-                                    previous_batch_offset,
-                                    top_k,
-                                    gpu_top_k);
-      }
-
-      // copy next batch to host
-      raft::copy(neighbors_host.data_handle(),
-                 neighbors.data_handle(),
-                 neighbors_view.size(),
-                 raft::resource::get_cuda_stream(res));
-      if (top_k != gpu_top_k) {
-        // can be skipped for disabled refinement
-        raft::copy(queries_host.data_handle(),
-                   batch.data(),
-                   queries_view.size(),
-                   raft::resource::get_cuda_stream(res));
-      }
-
-      previous_batch_size   = batch.size();
-      previous_batch_offset = batch.offset();
-
-      // we need to ensure the copy operations are done prior using the host data
-      raft::resource::sync_stream(res);
-
-      // process last batch
-      if (previous_batch_offset + previous_batch_size == (size_t)num_queries) {
-        refine_host_and_write_graph(res,
-                                    queries_host,
-                                    neighbors_host,
-                                    refined_neighbors_host,
-                                    refined_distances_host,
-                                    dataset,
-                                    knn_graph,
-                                    pq.build_params.metric,
-                                    num_self_included,
-                                    previous_batch_size,
-                                    previous_batch_offset,
-                                    top_k,
-                                    gpu_top_k);
-      }
-    } else {
+    if (!host_dataset && do_refine) {
       auto neighbor_candidates_view = raft::make_device_matrix_view<const int64_t, uint64_t>(
-        neighbors.data_handle(), batch.size(), gpu_top_k);
+        neighbors.data_handle(), batch.size, gpu_top_k);
       auto refined_neighbors_view = raft::make_device_matrix_view<int64_t, int64_t>(
-        refined_neighbors.data_handle(), batch.size(), top_k);
+        refined_neighbors.data_handle(), batch.size, top_k);
       auto refined_distances_view = raft::make_device_matrix_view<float, int64_t>(
-        refined_distances.data_handle(), batch.size(), top_k);
+        refined_distances.data_handle(), batch.size, top_k);
 
       auto dataset_view = raft::make_device_matrix_view<const DataT, int64_t>(
         dataset.data_handle(), dataset.extent(0), dataset.extent(1));
@@ -290,22 +246,65 @@ void build_knn_graph(
                               refined_neighbors_view,
                               refined_distances_view,
                               pq.build_params.metric);
-      raft::copy(refined_neighbors_host.data_handle(),
-                 refined_neighbors_view.data_handle(),
-                 refined_neighbors_view.size(),
-                 raft::resource::get_cuda_stream(res));
-      raft::resource::sync_stream(res);
-
+      raft::copy(buffer.refined_neighbors.data_handle(),
+                 refined_neighbors.data_handle(),
+                 batch.size * top_k,
+                 stream);
+    } else {
+      raft::copy(buffer.neighbors.data_handle(),
+                 neighbors.data_handle(),
+                 batch.size * gpu_top_k,
+                 stream);
+    }
+    // The host stages use the buffer as soon as the search returns.
+    raft::resource::sync_stream(res);
+  };
+
+  // The OpenMP threads of the host refine are shared among the refine threads.
+  const int refine_omp_threads =
+    std::max<int>(1, omp_get_max_threads() / static_cast<int>(pipeline.n_refine_threads));
+  auto refine_batch = [&]([[maybe_unused]] const knn_graph_batch& batch) {
+    if constexpr (host_dataset) {
+      if (!do_refine) { return; }
+      omp_set_num_threads(refine_omp_threads);
+      auto& buffer           = buffers[batch.buffer];
+      auto queries_host_view = raft::make_host_matrix_view<const DataT, int64_t>(
+        buffer.queries.data_handle(), batch.size, dim);
+      auto neighbors_host_view = raft::make_host_matrix_view<const int64_t, int64_t>(
+        buffer.neighbors.data_handle(), batch.size, gpu_top_k);
       auto refined_neighbors_host_view = raft::make_host_matrix_view<int64_t, int64_t>(
-        refined_neighbors_host.data_handle(), batch.size(), top_k);
-      write_to_graph(
-        knn_graph, refined_neighbors_host_view, num_self_included, batch.size(), batch.offset());
+        buffer.refined_neighbors.data_handle(), batch.size, top_k);
+      auto refined_distances_host_view = raft::make_host_matrix_view<float, int64_t>(
+        buffer.refined_distances.data_handle(), batch.size, top_k);
+      cuvs::neighbors::refine(res,
+                              dataset,
+                              queries_host_view,
+                              neighbors_host_view,
+                              refined_neighbors_host_view,
+                              refined_distances_host_view,
+                              pq.build_params.metric);
     }
+  };
 
-    size_t num_queries_done = batch.offset() + batch.size();
-    const auto end_clock    = std::chrono::system_clock::now();
-    if (batch.offset() > next_report_offset) {
+  std::size_t num_self_included = 0;
+  size_t num_queries_done       = 0;
+  size_t next_report_offset     = 0;
+  size_t d_report_offset        = dataset.extent(0) / 100;  // Report progress in 1% steps.
+  const auto start_clock        = std::chrono::system_clock::now();
+
+  auto write_batch = [&](const knn_graph_batch& batch) {
+    auto& buffer                     = buffers[batch.buffer];
+    auto refined_neighbors_host_view = raft::make_host_matrix_view<int64_t, int64_t>(
+      do_refine ? buffer.refined_neighbors.data_handle() : buffer.neighbors.data_handle(),
+      batch.size,
+      top_k);
+    write_to_graph(
+      knn_graph, refined_neighbors_host_view, num_self_included, batch.size, batch.offset);
+
+    num_queries_done += batch.size;
+    if (num_queries_done > next_report_offset) {
       next_report_offset += d_report_offset;
+      const auto end_clock = std::chrono::system_clock::now();
       const auto time =
         std::chrono::duration_cast<std::chrono::microseconds>(end_clock - start_clock).count() *
         1e-6;
@@ -321,10 +320,22 @@ void build_knn_graph(
         (num_queries - num_queries_done) / throughput / 60,
         static_cast<double>(num_self_included) / num_queries_done * 100.);
     }
-    first = false;
+  };
+
+  auto stats = run_knn_graph_pipeline(
+    pipeline, produce_batch, search_batch, refine_batch, write_batch);
+
+  RAFT_LOG_DEBUG("# Finished building kNN graph in %.2f s (%lu batches of %ld rows)",
+                 stats.total_seconds,
+                 stats.search.n_batches,
+                 max_batch_size);
+  for (const auto& [name, stage] : {std::make_pair("produce", stats.produce),
+                                    std::make_pair("search", stats.search),
+                                    std::make_pair("refine", stats.refine),
+                                    std::make_pair("write", stats.write)}) {
+    RAFT_LOG_DEBUG(
+      "#   %-8s busy %8.2f s, waiting %8.2f s", name, stage.busy_seconds, stage.wait_seconds);
   }
-
-  if (!first) RAFT_LOG_DEBUG("# Finished building kNN graph");
 }
 
 template <typename DataT, typename IdxT, typename accessor>
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../../distance/detail/host_distance.hpp"
+#include "cagra_serialize_hnswlib.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/logger.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace cuvs::neighbors::cagra::detail {
+
+/** The header of an hnswlib index, in the order it is serialized. */
+struct hnswlib_header {
+  size_t offset_level_0;
+  size_t max_element;
+  size_t cur_element_count;
+  size_t size_data_per_element;
+  size_t label_offset;
+  size_t offset_data;
+  int max_level;
+  int entry_point;
+  size_t max_M;
+  size_t max_M0;
+  size_t M;
+  double mult;
+  size_t ef_construction;
+};
+
+/** Read and validate the header of an hnswlib index whose vectors are of type T. */
+template <typename T>
+auto read_hnswlib_header(std::istream& is) -> hnswlib_header
+{
+  hnswlib_header h{};
+  auto get = [&is](auto& value) { is.read(reinterpret_cast<char*>(&value), sizeof(value)); };
+  get(h.offset_level_0);
+  get(h.max_element);
+  get(h.cur_element_count);
+  get(h.size_data_per_element);
+  get(h.label_offset);
+  get(h.offset_data);
+  get(h.max_level);
+  get(h.entry_point);
+  get(h.max_M);
+  get(h.max_M0);
+  get(h.M);
+  get(h.mult);
+  get(h.ef_construction);
+  RAFT_EXPECTS(is.good(), "Failed to read the hnswlib header");
+
+  // hnswlib links are 32-bit (`tableint`), preceded by a 32-bit link count.
+  RAFT_EXPECTS(h.offset_level_0 == 0 && h.cur_element_count <= h.max_element &&
+                 h.max_M0 > 0 && h.offset_data == sizeof(uint32_t) * (1 + h.max_M0),
+               "Not an hnswlib index, or an unsupported layout");
+  RAFT_EXPECTS(h.label_offset > h.offset_data &&
+                 (h.label_offset - h.offset_data) % sizeof(T) == 0 &&
+                 h.size_data_per_element == h.label_offset + sizeof(size_t),
+               "The vector size of the hnswlib index does not match the data type");
+  RAFT_EXPECTS(h.cur_element_count <= std::numeric_limits<uint32_t>::max(),
+               "The hnswlib index has too many elements");
+  return h;
+}
+
+/** The base layer of an hnswlib index, in hnswlib's internal order. */
+template <typename T>
+struct hnswlib_base_layer {
+  size_t n_rows;
+  uint32_t dim;
+  uint32_t max_degree;
+  /** [n_rows, dim] */
+  std::vector<T> dataset;
+  /** [n_rows, max_degree]; only the first `n_links[i]` links of row i are valid. */
+  std::vector<uint32_t> links;
+  std::vector<uint32_t> n_links;
+  std::vector<size_t> labels;
+  std::vector<uint8_t> deleted;
+
+  /** Number of elements that are not marked deleted. */
+  [[nodiscard]] auto n_live() const -> size_t
+  {
+    return std::count(deleted.begin(), deleted.end(), uint8_t{0});
+  }
+};
+
+/**
+ * Read the level-0 records of an hnswlib index; the stream is left after them (the upper layers
+ * are not needed).
+ *
+ * The records are read in large chunks and parsed in parallel.
+ */
+template <typename T>
+auto read_hnswlib_base_layer(std::istream& is, const hnswlib_header& h) -> hnswlib_base_layer<T>
+{
+  hnswlib_base_layer<T> base;
+  base.n_rows     = h.cur_element_count;
+  base.dim        = static_cast<uint32_t>((h.label_offset - h.offset_data) / sizeof(T));
+  base.max_degree = static_cast<uint32_t>(h.max_M0);
+  base.dataset.resize(base.n_rows * base.dim);
+  base.links.resize(base.n_rows * base.max_degree);
+  base.n_links.resize(base.n_rows);
+  base.labels.resize(base.n_rows);
+  base.deleted.resize(base.n_rows);
+
+  const size_t record_bytes = h.size_data_per_element;
+  size_t chunk_rows         = std::max<size_t>(1, kHnswlibChunkBytes / record_bytes);
+  std::vector<char> buffer(std::min(chunk_rows, std::max<size_t>(base.n_rows, 1)) * record_bytes);
+  bool bad_count = false;
+  for (size_t first = 0; first < base.n_rows; first += chunk_rows) {
+    size_t rows = std::min(chunk_rows, base.n_rows - first);
+    is.read(buffer.data(), rows * record_bytes);
+    RAFT_EXPECTS(is.good(), "The hnswlib index is truncated");
+#pragma omp parallel for schedule(static) reduction(|| : bad_count)
+    for (size_t i = 0; i < rows; i++) {
+      const char* record = buffer.data() + i * record_bytes;
+      size_t row         = first + i;
+      // The link list header holds the count in its lower two bytes and the deletion mark in
+      // the third byte.
+      uint16_t count;
+      std::memcpy(&count, record, sizeof(count));
+      base.deleted[row] = static_cast<uint8_t>(record[2]) & 0x1;
+      base.n_links[row] = std::min<uint32_t>(count, base.max_degree);
+      bad_count         = bad_count || count > base.max_degree;
+      std::memcpy(base.links.data() + row * base.max_degree,
+                  record + sizeof(uint32_t),
+                  base.max_degree * sizeof(uint32_t));
+      std::memcpy(base.dataset.data() + row * base.dim,
+                  record + h.offset_data,
+                  base.dim * sizeof(T));
+      std::memcpy(&base.labels[row], record + h.label_offset, sizeof(size_t));
+    }
+  }
+  RAFT_EXPECTS(!bad_count, "Invalid link count in the hnswlib index");
+  return base;
+}
+
+/**
+ * Convert the base layer of an hnswlib index into a fixed-degree kNN graph that `optimize` can
+ * prune to the CAGRA graph degree.
+ *
+ * Deleted elements are dropped and the remaining ones are ordered by label, so that the row ids
+ * are the hnswlib labels when those are 0..n-1 (as in indexes written by `serialize_to_hnswlib`).
+ * Each row lists its hnswlib neighbors sorted by distance. Rows with fewer neighbors than the
+ * width of `knn_graph` (hnswlib lists are variable-length, and links to deleted elements are
+ * dropped) are padded with the closest neighbors of their neighbors and, if that is not enough,
+ * with other rows.
+ *
+ * @param[in] base the parsed base layer
+ * @param[in] metric the metric the hnswlib index was built with
+ * @param[out] dataset [n_rows, dim], the vectors in output row order (n_rows = `base.n_live()`)
+ * @param[out] knn_graph [n_rows, knn_degree], knn_degree < n_rows
+ */
+template <typename T, typename IdxT>
+void hnswlib_to_knn_graph(const hnswlib_base_layer<T>& base,
+                          cuvs::distance::DistanceType metric,
+                          raft::host_matrix_view<T, int64_t, raft::row_major> dataset,
+                          raft::host_matrix_view<IdxT, int64_t, raft::row_major> knn_graph)
+{
+  auto& kernels = cuvs::distance::detail::host::get_distance_kernels<T>();
+  cuvs::distance::detail::host::distance_kernel<T> kernel;
+  float sign = 1;
+  switch (metric) {
+    case cuvs::distance::DistanceType::L2Expanded:
+    case cuvs::distance::DistanceType::L2Unexpanded:
+    case cuvs::distance::DistanceType::L2SqrtExpanded:
+    case cuvs::distance::DistanceType::L2SqrtUnexpanded: kernel = kernels.l2; break;
+    case cuvs::distance::DistanceType::InnerProduct:
+      kernel = kernels.inner_product;
+      sign   = -1;
+      break;
+    default: RAFT_FAIL("Unsupported metric for the hnswlib import: %d", static_cast<int>(metric));
+  }
+
+  constexpr auto kInvalid = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> order;
+  order.reserve(base.n_rows);
+  for (size_t i = 0; i < base.n_rows; i++) {
+    if (!base.deleted[i]) { order.push_back(i); }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return base.labels[a] < base.labels[b];
+  });
+  for (size_t i = 1; i < order.size(); i++) {
+    RAFT_EXPECTS(base.labels[order[i - 1]] != base.labels[order[i]],
+                 "The hnswlib index has duplicate labels");
+  }
+  std::vector<uint32_t> row_of(base.n_rows, kInvalid);
+  for (size_t i = 0; i < order.size(); i++) {
+    row_of[order[i]] = i;
+  }
+
+  const size_t n_rows = order.size();
+  const size_t degree = knn_graph.extent(1);
+  const uint32_t dim  = base.dim;
+  RAFT_EXPECTS(size_t(dataset.extent(0)) == n_rows && dataset.extent(1) == dim &&
+                 size_t(knn_graph.extent(0)) == n_rows,
+               "Output shape mismatch for the hnswlib import");
+  RAFT_EXPECTS(n_rows > degree,
+               "The hnswlib index has %zu elements, too few for a graph of degree %zu",
+               n_rows,
+               degree);
+
+  // Level-0 links in output row ids, without deleted targets, self links and duplicates.
+  std::vector<size_t> adj_offsets(n_rows + 1, 0);
+  std::vector<uint32_t> adj(n_rows * size_t(base.max_degree));
+#pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < n_rows; i++) {
+    const uint32_t* links = base.links.data() + size_t(order[i]) * base.max_degree;
+    uint32_t* out         = adj.data() + i * base.max_degree;
+    uint32_t count        = 0;
+    for (uint32_t j = 0; j < base.n_links[order[i]]; j++) {
+      uint32_t v = links[j] < base.n_rows ? row_of[links[j]] : kInvalid;
+      if (v != kInvalid && v != i) { out[count++] = v; }
+    }
+    std::sort(out, out + count);
+    adj_offsets[i + 1] = std::unique(out, out + count) - out;
+    std::copy(base.dataset.data() + size_t(order[i]) * dim,
+              base.dataset.data() + size_t(order[i] + 1) * dim,
+              dataset.data_handle() + i * dim);
+  }
+  // Compact the adjacency in place: the lists only move towards the front.
+  for (size_t i = 0; i < n_rows; i++) {
+    size_t count = adj_offsets[i + 1];
+    std::copy(adj.data() + i * base.max_degree,
+              adj.data() + i * base.max_degree + count,
+              adj.data() + adj_offsets[i]);
+    adj_offsets[i + 1] = adj_offsets[i] + count;
+  }
+
+  size_t n_padded = 0;
+#pragma omp parallel reduction(+ : n_padded)
+  {
+    std::vector<std::pair<float, uint32_t>> candidates;
+    std::vector<uint32_t> members;
+#pragma omp for schedule(dynamic, 256)
+    for (size_t i = 0; i < n_rows; i++) {
+      const T* query = dataset.data_handle() + i * dim;
+      auto add       = [&](uint32_t v) {
+        candidates.emplace_back(sign * kernel(query, dataset.data_handle() + size_t(v) * dim, dim),
+                                v);
+      };
+      candidates.clear();
+      for (size_t j = adj_offsets[i]; j < adj_offsets[i + 1]; j++) {
+        add(adj[j]);
+      }
+
+      if (candidates.size() < degree) {
+        n_padded++;
+        auto exclude_members = [&]() {
+          members.clear();
+          for (auto& c : candidates) {
+            members.push_back(c.second);
+          }
+          members.push_back(i);
+          std::sort(members.begin(), members.end());
+        };
+        // The neighbors of the neighbors.
+        exclude_members();
+        size_t n_direct = candidates.size();
+        for (size_t k = 0; k < n_direct; k++) {
+          uint32_t u = candidates[k].second;
+          for (size_t j = adj_offsets[u]; j < adj_offsets[u + 1]; j++) {
+            if (!std::binary_search(members.begin(), members.end(), adj[j])) { add(adj[j]); }
+          }
+        }
+        std::sort(candidates.begin() + n_direct, candidates.end());
+        auto last = std::unique(candidates.begin() + n_direct,
+                                candidates.end(),
+                                [](auto& a, auto& b) { return a.second == b.second; });
+        candidates.erase(last, candidates.end());
+
+        // Not enough (isolated rows or tiny components): fill with the following rows.
+        if (candidates.size() < degree) {
+          exclude_members();
+          for (size_t v = (i + 1) % n_rows; candidates.size() < degree; v = (v + 1) % n_rows) {
+            if (!std::binary_search(members.begin(), members.end(), uint32_t(v))) { add(v); }
+          }
+        }
+      }
+      // `optimize` expects the rows sorted by distance.
+      std::sort(candidates.begin(), candidates.end());
+
+      IdxT* row = knn_graph.data_handle() + i * degree;
+      for (size_t k = 0; k < degree; k++) {
+        row[k] = static_cast<IdxT>(candidates[k].second);
+      }
+    }
+  }
+  if (n_padded > 0) {
+    RAFT_LOG_DEBUG(
+      "hnswlib import: padded %zu of %zu rows to degree %zu", n_padded, n_rows, degree);
+  }
+}
+
+}  // namespace cuvs::neighbors::cagra::detail
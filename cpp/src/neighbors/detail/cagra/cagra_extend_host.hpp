@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../../../core/nvtx.hpp"
+#include "cagra_search_host.hpp"
+#include "graph_core_host.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/cagra.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/host_mdspan.hpp>
+#include <raft/core/logger.hpp>
+#include <raft/core/resources.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace cuvs::neighbors::cagra::detail {
+
+/**
+ * Prune the candidate neighbors of one new node, the host equivalent of the `optimize` pruning
+ * applied to a single row.
+ *
+ * The candidates are sorted by distance; the detours of the candidate B are the candidates D
+ * before it with an edge D->B in the current graph. The `degree` candidates with the fewest
+ * detours are kept, in candidate order. Invalid candidates (the search found fewer nodes) are
+ * skipped, and a row with fewer valid candidates than `degree` repeats them.
+ */
+template <typename IdxT>
+void prune_new_node(const IdxT* graph,
+                    uint64_t graph_size,
+                    uint32_t degree,
+                    const IdxT* candidates,
+                    uint32_t n_candidates,
+                    std::vector<std::pair<IdxT, uint32_t>>& sorted_candidates,
+                    std::vector<uint32_t>& num_detour,
+                    IdxT* new_row)
+{
+  sorted_candidates.clear();
+  for (uint32_t k = 0; k < n_candidates; k++) {
+    if (candidates[k] < graph_size) { sorted_candidates.emplace_back(candidates[k], k); }
+  }
+  RAFT_EXPECTS(!sorted_candidates.empty(), "The search found no neighbor of a new node");
+  std::sort(sorted_candidates.begin(), sorted_candidates.end());
+
+  num_detour.assign(n_candidates, std::numeric_limits<uint32_t>::max());
+  for (const auto& [id, k] : sorted_candidates) {
+    num_detour[k] = 0;
+  }
+  for (uint32_t kD = 0; kD + 1 < n_candidates; kD++) {
+    const uint64_t iD = candidates[kD];
+    if (iD >= graph_size) { continue; }
+    const IdxT* row_D = graph + uint64_t(degree) * iD;
+    for (uint32_t kDB = 0; kDB < degree; kDB++) {
+      // The first candidate B after D.
+      auto it = std::lower_bound(sorted_candidates.begin(),
+                                 sorted_candidates.end(),
+                                 std::make_pair(row_D[kDB], kD + 1));
+      if (it != sorted_candidates.end() && it->first == row_D[kDB]) { num_detour[it->second]++; }
+    }
+  }
+
+  uint32_t pk = 0;
+  for (uint32_t detours = 0; pk < degree && pk < sorted_candidates.size(); detours++) {
+    for (uint32_t k = 0; k < n_candidates && pk < degree; k++) {
+      if (num_detour[k] == detours) { new_row[pk++] = candidates[k]; }
+    }
+  }
+  for (uint32_t k = pk; k < degree; k++) {
+    new_row[k] = new_row[k % pk];
+  }
+}
+
+/**
+ * Add the nodes [graph.extent(0), dataset.extent(0)) of the dataset to the CAGRA graph `graph` of
+ * the first rows, on the host.
+ *
+ * The new nodes are added in chunks. The neighbors of the nodes of a chunk are searched in the
+ * graph of all the previous nodes, pruned as `optimize` prunes a kNN graph, and appended to the
+ * graph. Then the protected (first `degree / 2`) edges i->j of the new nodes are patched into the
+ * rows j as reverse edges j->i, with the rule of `optimize`: a reverse edge is moved to the front
+ * of the unprotected part of the row, evicting the last edge, and the reverse edges of the shortest
+ * forward edges end up first. The nodes of a chunk are not linked to each other directly, hence
+ * the chunks are kept small relative to the graph.
+ *
+ * @param[in] dataset [n_rows + n_new_rows, dim]
+ * @param[in] graph [n_rows, degree]
+ * @param[out] new_graph [n_rows + n_new_rows, degree]
+ */
+template <typename T, typename IdxT>
+void extend_host(raft::resources const& res,
+                 const extend_params& params,
+                 cuvs::distance::DistanceType metric,
+                 raft::host_matrix_view<const T, int64_t, raft::row_major> dataset,
+                 raft::host_matrix_view<const IdxT, int64_t, raft::row_major> graph,
+                 raft::host_matrix_view<IdxT, int64_t, raft::row_major> new_graph)
+{
+  const uint64_t n_rows     = graph.extent(0);
+  const uint64_t n_total    = dataset.extent(0);
+  const uint32_t degree     = graph.extent(1);
+  const int64_t dim         = dataset.extent(1);
+  const uint64_t n_new_rows = n_total - std::min(n_rows, n_total);
+
+  cuvs::common::nvtx::range<cuvs::common::nvtx::domain::cuvs> fun_scope(
+    "cagra::extend_host(%zu, %zu)", size_t(n_rows), size_t(n_new_rows));
+
+  RAFT_EXPECTS(n_total >= n_rows, "The dataset must contain the rows of the graph");
+  RAFT_EXPECTS(new_graph.extent(0) == dataset.extent(0),
+               "The new graph must have a row per row of the dataset");
+  RAFT_EXPECTS(new_graph.extent(1) == graph.extent(1),
+               "The new graph must have the degree of the graph");
+  RAFT_EXPECTS(n_rows > degree, "The graph must have more rows than its degree");
+
+  IdxT* new_graph_ptr = new_graph.data_handle();
+  if (new_graph_ptr != graph.data_handle()) {
+    std::memcpy(new_graph_ptr, graph.data_handle(), n_rows * degree * sizeof(IdxT));
+  }
+  if (n_new_rows == 0) { return; }
+
+  // More candidates than the degree, so that the pruning has edges to drop.
+  const uint32_t max_candidates = 2 * degree;
+  search_params candidate_search;
+  candidate_search.itopk_size = std::max<size_t>(max_candidates, 128);
+
+  const uint32_t num_protected_edges = degree / 2;
+  const auto start                   = std::chrono::steady_clock::now();
+  std::vector<IdxT> candidates;
+  std::vector<float> candidate_distances;
+  // (destination, position of the edge in the new row, new node)
+  std::vector<std::tuple<IdxT, uint32_t, IdxT>> reverse_edges;
+  std::vector<uint64_t> group_offsets;
+
+  for (uint64_t offset = n_rows; offset < n_total;) {
+    const uint64_t max_chunk_size =
+      params.max_chunk_size > 0 ? params.max_chunk_size : std::max<uint64_t>(offset / 10, 1);
+    const uint64_t chunk_size     = std::min(max_chunk_size, n_total - offset);
+    const uint32_t n_candidates   = std::min<uint64_t>(max_candidates, offset);
+    RAFT_LOG_DEBUG("# Extending the graph of %lu nodes with %lu nodes", offset, chunk_size);
+
+    candidates.resize(chunk_size * n_candidates);
+    candidate_distances.resize(chunk_size * n_candidates);
+    search_host<T, IdxT>(
+      res,
+      candidate_search,
+      metric,
+      raft::make_host_matrix_view<const T, int64_t>(dataset.data_handle(), offset, dim),
+      raft::make_host_matrix_view<const IdxT, int64_t>(new_graph_ptr, offset, degree),
+      raft::make_host_matrix_view<const T, int64_t>(
+        dataset.data_handle() + offset * dim, chunk_size, dim),
+      raft::make_host_matrix_view<IdxT, int64_t>(candidates.data(), chunk_size, n_candidates),
+      raft::make_host_matrix_view<float, int64_t>(
+        candidate_distances.data(), chunk_size, n_candidates));
+
+#pragma omp parallel
+    {
+      std::vector<std::pair<IdxT, uint32_t>> sorted_candidates;
+      std::vector<uint32_t> num_detour;
+#pragma omp for schedule(dynamic, 64)
+      for (uint64_t i = 0; i < chunk_size; i++) {
+        prune_new_node<IdxT>(new_graph_ptr,
+                             offset,
+                             degree,
+                             candidates.data() + i * n_candidates,
+                             n_candidates,
+                             sorted_candidates,
+                             num_detour,
+                             new_graph_ptr + (offset + i) * degree);
+      }
+    }
+
+    // Group the reverse edges by destination, the shortest forward edges first.
+    reverse_edges.clear();
+    for (uint64_t i = 0; i < chunk_size; i++) {
+      const IdxT* row = new_graph_ptr + (offset + i) * degree;
+      for (uint32_t k = 0; k < num_protected_edges; k++) {
+        if (graph::pos_in_array<IdxT>(row[k], row, k) < k) { continue; }
+        reverse_edges.emplace_back(row[k], k, static_cast<IdxT>(offset + i));
+      }
+    }
+    std::sort(reverse_edges.begin(), reverse_edges.end());
+    group_offsets.clear();
+    for (uint64_t e = 0; e < reverse_edges.size(); e++) {
+      if (e == 0 || std::get<0>(reverse_edges[e]) != std::get<0>(reverse_edges[e - 1])) {
+        group_offsets.push_back(e);
+      }
+    }
+    const uint64_t n_groups = group_offsets.size();
+    group_offsets.push_back(reverse_edges.size());
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (uint64_t g = 0; g < n_groups; g++) {
+      IdxT* row = new_graph_ptr + uint64_t(std::get<0>(reverse_edges[group_offsets[g]])) * degree;
+      for (uint64_t e = group_offsets[g + 1]; e > group_offsets[g]; e--) {
+        const IdxT i = std::get<2>(reverse_edges[e - 1]);
+        uint64_t pos = graph::pos_in_array<IdxT>(i, row, degree);
+        if (pos < num_protected_edges) { continue; }
+        if (pos == degree) { pos = degree - 1; }
+        graph::shift_array<IdxT>(row + num_protected_edges, pos - num_protected_edges);
+        row[num_protected_edges] = i;
+      }
+    }
+    offset += chunk_size;
+  }
+  RAFT_LOG_DEBUG("# Extending time: %.1lf sec", graph::elapsed_seconds(start));
+}
+
+}  // namespace cuvs::neighbors::cagra::detail
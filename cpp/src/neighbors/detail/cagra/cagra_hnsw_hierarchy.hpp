@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../../distance/detail/host_distance.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <raft/core/error.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace cuvs::neighbors::cagra::detail {
+
+/**
+ * The upper layers (level >= 1) of an HNSW index, built on the host over the rows sampled into
+ * them.
+ *
+ * The level of every row is drawn from the hnswlib distribution, floor(-ln(U) * mult) with
+ * mult = 1 / ln(M), using a hash of the row index so that it does not depend on the threads.
+ * The rows with a level >= 1 ("upper" rows) are ranked by decreasing level (ties by row index);
+ * the rows of level >= l are then the first `level_size[l]` ranks, which lets all layers share one
+ * rank-indexed storage. The highest ranked row is the entry point.
+ *
+ * The layers are built like hnswlib builds them: the rows are inserted in rank order, each one by
+ * a greedy descent from the entry point followed by a beam search (ef_construction) on each of
+ * its layers, the M neighbors are chosen with the hnswlib heuristic, and the reverse links are
+ * added, shrinking full link lists with the same heuristic. To parallelize the build, the rows are
+ * inserted in batches: the searches of a batch run in parallel against the layers built so far,
+ * then the links are added sequentially. The batch size is a fraction of the number of rows
+ * already inserted, so a row misses at most a small fraction of its layer-mates.
+ *
+ * Usage: construct (this assigns the levels), copy the vectors of the upper rows to
+ * `upper_data()` (see `upper_rows`), then `build`.
+ */
+template <typename T, typename IdxT>
+class hnsw_upper_layers {
+ public:
+  hnsw_upper_layers(size_t n_rows,
+                    uint32_t dim,
+                    uint32_t M,
+                    cuvs::distance::DistanceType metric,
+                    uint32_t ef_construction,
+                    uint64_t seed = 0x5eedULL)
+    : n_rows_(n_rows),
+      dim_(dim),
+      M_(M),
+      ef_construction_(std::max(ef_construction, M)),
+      mult_(M > 1 ? 1.0 / std::log(double(M)) : 0.0)
+  {
+    auto& kernels = cuvs::distance::detail::host::get_distance_kernels<T>();
+    switch (metric) {
+      case cuvs::distance::DistanceType::L2Expanded:
+      case cuvs::distance::DistanceType::L2Unexpanded:
+      case cuvs::distance::DistanceType::L2SqrtExpanded:
+      case cuvs::distance::DistanceType::L2SqrtUnexpanded: kernel_ = kernels.l2; break;
+      case cuvs::distance::DistanceType::InnerProduct:
+        kernel_ = kernels.inner_product;
+        sign_   = -1.0f;
+        break;
+      default: RAFT_FAIL("Unsupported metric for the HNSW hierarchy: %d", static_cast<int>(metric));
+    }
+    assign_levels(seed);
+  }
+
+  [[nodiscard]] auto M() const noexcept -> uint32_t { return M_; }
+  [[nodiscard]] auto mult() const noexcept -> double { return mult_; }
+  [[nodiscard]] auto ef_construction() const noexcept -> uint32_t { return ef_construction_; }
+  /** The top level (0 if there are no upper layers). */
+  [[nodiscard]] auto max_level() const noexcept -> int
+  {
+    return level_size_.empty() ? 0 : int(level_size_.size()) - 1;
+  }
+  [[nodiscard]] auto entry_point() const noexcept -> IdxT
+  {
+    return order_.empty() ? IdxT(n_rows_ / 2) : order_[0];
+  }
+  /** Number of rows with a level >= 1. */
+  [[nodiscard]] auto n_upper() const noexcept -> size_t { return order_.size(); }
+
+  /**
+   * The upper rows as (row index, rank) pairs sorted by row index.
+   *
+   * The caller copies the vector of row `first` to `upper_data() + second * dim`.
+   */
+  [[nodiscard]] auto upper_rows() const noexcept -> const std::vector<std::pair<IdxT, uint32_t>>&
+  {
+    return upper_by_row_;
+  }
+  [[nodiscard]] auto upper_data() noexcept -> T* { return data_.data(); }
+
+  /** Level of the row with the given rank. */
+  [[nodiscard]] auto level_of_rank(uint32_t rank) const noexcept -> int
+  {
+    return rank_level_[rank];
+  }
+
+  /**
+   * Links of the row with the given rank at level `level` (1 <= level <= level_of_rank(rank)),
+   * as row indices.
+   */
+  template <typename OutT>
+  auto links(uint32_t rank, int level, OutT* out) const -> uint32_t
+  {
+    auto count = counts_[level][rank];
+    auto src   = links_[level].data() + size_t(rank) * M_;
+    for (uint32_t i = 0; i < count; i++) {
+      out[i] = static_cast<OutT>(order_[src[i]]);
+    }
+    return count;
+  }
+
+  /** Build the links of all upper layers; the upper rows' vectors must have been provided. */
+  void build()
+  {
+    if (order_.empty()) { return; }
+    for (int l = 1; l <= max_level(); l++) {
+      links_[l].assign(level_size_[l] * M_, 0);
+      counts_[l].assign(level_size_[l], 0);
+    }
+
+    const uint32_t n_upper = order_.size();
+    std::vector<std::vector<std::vector<uint32_t>>> selected;
+    for (uint32_t begin = 1; begin < n_upper;) {
+      uint32_t end = std::min<uint32_t>(n_upper, begin + std::max<uint32_t>(1, begin / 16));
+      selected.resize(end - begin);
+#pragma omp parallel for schedule(dynamic)
+      for (uint32_t r = begin; r < end; r++) {
+        selected[r - begin] = search_links(r, begin);
+      }
+      for (uint32_t r = begin; r < end; r++) {
+        const auto& per_level = selected[r - begin];
+        for (int l = 1; l <= int(per_level.size()); l++) {
+          connect(r, l, per_level[l - 1]);
+        }
+      }
+      begin = end;
+    }
+  }
+
+ private:
+  using candidate_t = std::pair<float, uint32_t>;
+  struct closer {
+    auto operator()(const candidate_t& a, const candidate_t& b) const -> bool
+    {
+      return a.first > b.first;
+    }
+  };
+
+  size_t n_rows_;
+  uint32_t dim_;
+  uint32_t M_;
+  uint32_t ef_construction_;
+  double mult_;
+  cuvs::distance::detail::host::distance_kernel<T> kernel_;
+  float sign_ = 1.0f;
+
+  std::vector<IdxT> order_;                              // rank -> row
+  std::vector<uint8_t> rank_level_;                      // rank -> level
+  std::vector<std::pair<IdxT, uint32_t>> upper_by_row_;  // (row, rank) sorted by row
+  std::vector<size_t> level_size_;                       // level -> number of rows >= level
+  std::vector<T> data_;                                  // rank -> vector
+  std::vector<std::vector<uint32_t>> links_;             // level -> [level_size, M] ranks
+  std::vector<std::vector<uint32_t>> counts_;            // level -> [level_size]
+
+  static auto splitmix64(uint64_t x) -> uint64_t
+  {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  void assign_levels(uint64_t seed)
+  {
+    if (mult_ == 0.0 || n_rows_ == 0) { return; }
+    constexpr int kMaxLevel = 255;
+    std::vector<std::pair<uint8_t, IdxT>> upper;
+#pragma omp parallel
+    {
+      std::vector<std::pair<uint8_t, IdxT>> local;
+#pragma omp for schedule(static) nowait
+      for (size_t i = 0; i < n_rows_; i++) {
+        // U in (0, 1]
+        double u  = double((splitmix64(seed ^ i) >> 11) + 1) * 0x1.0p-53;
+        int level = std::min<int>(kMaxLevel, static_cast<int>(-std::log(u) * mult_));
+        if (level > 0) { local.emplace_back(uint8_t(level), IdxT(i)); }
+      }
+#pragma omp critical
+      upper.insert(upper.end(), local.begin(), local.end());
+    }
+    std::sort(upper.begin(), upper.end(), [](const auto& a, const auto& b) {
+      return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    order_.resize(upper.size());
+    rank_level_.resize(upper.size());
+    upper_by_row_.resize(upper.size());
+    for (size_t r = 0; r < upper.size(); r++) {
+      rank_level_[r]   = upper[r].first;
+      order_[r]        = upper[r].second;
+      upper_by_row_[r] = {upper[r].second, uint32_t(r)};
+    }
+    std::sort(upper_by_row_.begin(), upper_by_row_.end());
+
+    int top = upper.empty() ? 0 : upper[0].first;
+    level_size_.assign(top + 1, 0);
+    level_size_[0] = n_rows_;
+    for (int l = 1; l <= top; l++) {
+      level_size_[l] = std::count_if(
+        rank_level_.begin(), rank_level_.end(), [l](uint8_t level) { return level >= l; });
+    }
+    links_.resize(top + 1);
+    counts_.resize(top + 1);
+    data_.resize(upper.size() * size_t(dim_));
+  }
+
+  inline auto distance(uint32_t a, uint32_t b) const -> float
+  {
+    return sign_ * kernel_(data_.data() + size_t(a) * dim_, data_.data() + size_t(b) * dim_, dim_);
+  }
+
+  /** Beam search for `query` on layer `level`, among the ranks below `limit`. */
+  auto search_layer(uint32_t query, uint32_t entry, int level, uint32_t limit, uint32_t ef) const
+    -> std::vector<candidate_t>
+  {
+    thread_local std::vector<uint32_t> visited;
+    thread_local uint32_t epoch = 0;
+    if (visited.size() < order_.size()) { visited.assign(order_.size(), 0); }
+    if (++epoch == 0) {
+      std::fill(visited.begin(), visited.end(), 0);
+      epoch = 1;
+    }
+
+    std::priority_queue<candidate_t, std::vector<candidate_t>, closer> frontier;
+    std::priority_queue<candidate_t> best;  // worst on top
+    float d = distance(query, entry);
+    frontier.emplace(d, entry);
+    best.emplace(d, entry);
+    visited[entry] = epoch;
+    while (!frontier.empty()) {
+      auto [dist, node] = frontier.top();
+      if (best.size() >= ef && dist > best.top().first) { break; }
+      frontier.pop();
+      const uint32_t* nbrs = links_[level].data() + size_t(node) * M_;
+      uint32_t count       = counts_[level][node];
+      for (uint32_t i = 0; i < count; i++) {
+        uint32_t next = nbrs[i];
+        if (next >= limit || visited[next] == epoch) { continue; }
+        visited[next] = epoch;
+        float dn      = distance(query, next);
+        if (best.size() < ef || dn < best.top().first) {
+          frontier.emplace(dn, next);
+          best.emplace(dn, next);
+          if (best.size() > ef) { best.pop(); }
+        }
+      }
+    }
+    std::vector<candidate_t> result(best.size());
+    for (size_t i = result.size(); i > 0; i--) {
+      result[i - 1] = best.top();
+      best.pop();
+    }
+    return result;
+  }
+
+  /** hnswlib's neighbor selection heuristic; `candidates` sorted by distance to the base. */
+  auto select_neighbors(const std::vector<candidate_t>& candidates) const -> std::vector<uint32_t>
+  {
+    std::vector<uint32_t> selected;
+    selected.reserve(M_);
+    for (const auto& [dist, node] : candidates) {
+      if (selected.size() >= M_) { break; }
+      bool good = true;
+      for (auto s : selected) {
+        if (distance(node, s) < dist) {
+          good = false;
+          break;
+        }
+      }
+      if (good) { selected.push_back(node); }
+    }
+    return selected;
+  }
+
+  /** Find the neighbors of rank `r` on each of its layers, among the ranks below `limit`. */
+  auto search_links(uint32_t r, uint32_t limit) const -> std::vector<std::vector<uint32_t>>
+  {
+    int level        = rank_level_[r];
+    uint32_t entry   = 0;
+    float entry_dist = distance(r, entry);
+    for (int l = max_level(); l > level; l--) {
+      // Greedy descent
+      for (bool changed = true; changed;) {
+        changed              = false;
+        const uint32_t* nbrs = links_[l].data() + size_t(entry) * M_;
+        for (uint32_t i = 0; i < counts_[l][entry]; i++) {
+          if (nbrs[i] >= limit) { continue; }
+          float d = distance(r, nbrs[i]);
+          if (d < entry_dist) {
+            entry_dist = d;
+            entry      = nbrs[i];
+            changed    = true;
+          }
+        }
+      }
+    }
+    std::vector<std::vector<uint32_t>> result(level);
+    for (int l = level; l >= 1; l--) {
+      auto candidates = search_layer(r, entry, l, limit, ef_construction_);
+      result[l - 1]   = select_neighbors(candidates);
+      entry           = candidates.front().second;
+    }
+    return result;
+  }
+
+  /** Link rank `r` to `neighbors` on layer `level`, and add the reverse links. */
+  void connect(uint32_t r, int level, const std::vector<uint32_t>& neighbors)
+  {
+    auto* links = links_[level].data();
+    auto& count = counts_[level];
+    std::copy(neighbors.begin(), neighbors.end(), links + size_t(r) * M_);
+    count[r] = neighbors.size();
+    for (auto n : neighbors) {
+      uint32_t* nbrs = links + size_t(n) * M_;
+      if (count[n] < M_) {
+        nbrs[count[n]++] = r;
+        continue;
+      }
+      std::vector<candidate_t> candidates;
+      candidates.reserve(M_ + 1);
+      candidates.emplace_back(distance(n, r), r);
+      for (uint32_t i = 0; i < M_; i++) {
+        candidates.emplace_back(distance(n, nbrs[i]), nbrs[i]);
+      }
+      std::sort(candidates.begin(), candidates.end());
+      auto kept = select_neighbors(candidates);
+      std::copy(kept.begin(), kept.end(), nbrs);
+      count[n] = kept.size();
+    }
+  }
+};
+
+}  // namespace cuvs::neighbors::cagra::detail
@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../../core/nvtx.hpp"
+#include "../../../distance/detail/host_distance.hpp"
+#include "../../../selection/detail/select_k_host.hpp"
+#include "../sample_filter_host.hpp"
+#include "device_common.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/cagra.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdspan.hpp>
+#include <raft/core/logger.hpp>
+#include <raft/core/resources.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cuvs::neighbors::cagra::detail {
+
+/**
+ * Parameters of the host search, derived from `search_params` the same way the device search
+ * plan (single-CTA) derives them: itopk is rounded up to a multiple of 32, max_iterations is
+ * auto-selected when zero, and the visited set is either a full hash table or a "small" hash
+ * table that is reset every `small_hash_reset_interval` iterations.
+ */
+struct host_search_plan {
+  uint32_t itopk_size;
+  uint32_t search_width;
+  uint32_t min_iterations;
+  uint32_t max_iterations;
+  uint32_t hash_bitlen;
+  /** Reset period of the small hash table; zero when the full hash table is used. */
+  uint32_t small_hash_reset_interval;
+  uint32_t num_random_samplings;
+  uint64_t rand_xor_mask;
+
+  host_search_plan(const search_params& params, uint32_t graph_degree, uint32_t topk)
+    : itopk_size(params.itopk_size),
+      search_width(params.search_width),
+      min_iterations(params.min_iterations),
+      max_iterations(params.max_iterations),
+      hash_bitlen(0),
+      small_hash_reset_interval(0),
+      num_random_samplings(params.num_random_samplings),
+      rand_xor_mask(params.rand_xor_mask)
+  {
+    RAFT_EXPECTS(search_width > 0, "search_width must be positive");
+    RAFT_EXPECTS(num_random_samplings > 0, "num_random_samplings must be positive");
+    RAFT_EXPECTS(params.hashmap_min_bitlen <= 20,
+                 "hashmap_min_bitlen must be equal to or smaller than 20 (got %zu)",
+                 params.hashmap_min_bitlen);
+    RAFT_EXPECTS(params.hashmap_max_fill_rate >= 0.1 && params.hashmap_max_fill_rate < 0.9,
+                 "hashmap_max_fill_rate must be in [0.1, 0.9) (got %f)",
+                 params.hashmap_max_fill_rate);
+
+    uint32_t auto_iterations =
+      1 + std::min((itopk_size / search_width) * 1.1, (itopk_size / search_width) + 10.0);
+    if (max_iterations == 0) { max_iterations = auto_iterations; }
+    max_iterations = std::max(max_iterations, min_iterations);
+    if (itopk_size % 32) { itopk_size += 32 - (itopk_size % 32); }
+    RAFT_EXPECTS(topk <= itopk_size,
+                 "topk = %u must be smaller than itopk_size = %u",
+                 topk,
+                 itopk_size);
+
+    auto fits = [&](uint32_t bitlen, size_t n_visited) {
+      return n_visited <= (size_t(1) << bitlen) * params.hashmap_max_fill_rate;
+    };
+    size_t per_iteration = size_t(search_width) * graph_degree;
+    if (params.hashmap_mode != hash_mode::HASH) {
+      // The small hash table only holds the itopk nodes and the nodes visited since the last reset.
+      constexpr uint32_t kMaxSmallBitlen = 13;
+      uint32_t bitlen = std::max<uint32_t>(8, params.hashmap_min_bitlen);
+      while (!fits(bitlen, itopk_size + per_iteration)) {
+        bitlen++;
+      }
+      if (bitlen <= kMaxSmallBitlen) {
+        hash_bitlen               = bitlen;
+        small_hash_reset_interval = 1;
+        while (fits(hash_bitlen, itopk_size + per_iteration * (small_hash_reset_interval + 1))) {
+          small_hash_reset_interval++;
+        }
+      } else if (params.hashmap_mode == hash_mode::SMALL) {
+        RAFT_FAIL("small-hash cannot be used because the required hash size exceeds the limit (%u)",
+                  1u << kMaxSmallBitlen);
+      }
+    }
+    if (hash_bitlen == 0) {
+      hash_bitlen = std::max<uint32_t>(11, params.hashmap_min_bitlen);
+      while (!fits(hash_bitlen, itopk_size + per_iteration * max_iterations)) {
+        hash_bitlen++;
+      }
+      RAFT_EXPECTS(hash_bitlen <= 20, "hash_bitlen cannot be largen than 20 (1M)");
+    }
+  }
+};
+
+/**
+ * The visited set of the host search: an open-addressing hash table with linear probing, using
+ * the same hash function as the device `hashmap`.
+ */
+template <typename IdxT>
+class host_visited_set {
+ public:
+  static constexpr IdxT kEmpty = ~static_cast<IdxT>(0);
+
+  void reset(uint32_t bitlen)
+  {
+    bitlen_ = bitlen;
+    table_.assign(size_t(1) << bitlen, kEmpty);
+  }
+
+  void clear() { std::fill(table_.begin(), table_.end(), kEmpty); }
+
+  /** Insert the key; returns false if it was already present (or the table is full). */
+  inline auto insert(IdxT key) -> bool
+  {
+    const size_t mask = table_.size() - 1;
+    size_t index      = (key ^ (key >> bitlen_)) & mask;
+    for (size_t i = 0; i < table_.size(); i++) {
+      if (table_[index] == kEmpty) {
+        table_[index] = key;
+        return true;
+      }
+      if (table_[index] == key) { return false; }
+      index = (index + 1) & mask;
+    }
+    return false;
+  }
+
+ private:
+  std::vector<IdxT> table_;
+  uint32_t bitlen_ = 0;
+};
+
+/** Per-thread buffers of the host search, reused across queries. */
+template <typename IdxT>
+struct host_search_workspace {
+  using entry_t = std::pair<float, IdxT>;
+
+  std::vector<entry_t> itopk;
+  std::vector<entry_t> candidates;
+  std::vector<entry_t> merged;
+  host_visited_set<IdxT> visited;
+
+  static auto get(const host_search_plan& plan, uint32_t graph_degree)
+    -> host_search_workspace<IdxT>&
+  {
+    thread_local host_search_workspace<IdxT> ws;
+    ws.itopk.reserve(plan.itopk_size);
+    ws.candidates.reserve(plan.itopk_size + size_t(plan.search_width) * graph_degree);
+    ws.merged.reserve(2 * plan.itopk_size + size_t(plan.search_width) * graph_degree);
+    ws.visited.reset(plan.hash_bitlen);
+    return ws;
+  }
+};
+
+/**
+ * Search one query on the host.
+ *
+ * This follows the single-CTA device search: the internal top-k list is initialized from random
+ * nodes (the best of `num_random_samplings` draws per slot), then in each iteration the best
+ * `search_width` nodes that have not been expanded yet become parents, the distances to their
+ * graph neighbors that were not visited before are computed, and the candidates are merged into
+ * the internal top-k list. The search stops when there are no new parents (after
+ * `min_iterations`) or after `max_iterations`.
+ *
+ * The parent flag is kept in the most significant bit of the node index, as on the device.
+ *
+ * A filter does not restrict the traversal: the rejected nodes stay in the internal top-k list and
+ * are expanded like the others, so that the search can cross the regions of the graph the filter
+ * rejects. The results are the best admitted nodes among all the nodes the search computed the
+ * distance to, collected in a separate heap.
+ *
+ * @param distance `(const T* row) -> float`, smaller is closer
+ * @param admit `(int64_t row) -> bool`, the sample filter
+ */
+template <typename T, typename IdxT, typename DistanceOp, typename FilterT>
+void search_host_query(const host_search_plan& plan,
+                       const T* dataset,
+                       size_t n_rows,
+                       size_t dim,
+                       const IdxT* graph,
+                       uint32_t graph_degree,
+                       DistanceOp distance,
+                       FilterT admit,
+                       uint32_t topk,
+                       IdxT* out_indices,
+                       float* out_distances)
+{
+  constexpr bool kFiltered =
+    !std::is_same_v<FilterT, cuvs::neighbors::filtering::detail::host_admit_all>;
+  using entry_t                = typename host_search_workspace<IdxT>::entry_t;
+  constexpr IdxT kParentFlag   = IdxT(1) << (sizeof(IdxT) * 8 - 1);
+  constexpr IdxT kInvalidIndex = std::numeric_limits<IdxT>::max();
+  constexpr float kInvalidDist = std::numeric_limits<float>::max();
+  auto by_distance = [](const entry_t& a, const entry_t& b) { return a.first < b.first; };
+  auto row         = [=](IdxT id) { return dataset + dim * size_t(id); };
+  auto& ws         = host_search_workspace<IdxT>::get(plan, graph_degree);
+  const size_t itopk_size = plan.itopk_size;
+  const size_t n_children = size_t(plan.search_width) * graph_degree;
+
+  // With a filter, the admitted nodes met during the traversal are collected apart from the
+  // internal top-k list, which keeps the rejected ones as stepping stones.
+  cuvs::selection::detail::host::bounded_heap<float, IdxT>* results = nullptr;
+  if constexpr (kFiltered) {
+    results = &cuvs::selection::detail::host::thread_local_heap<float, IdxT>(topk);
+  }
+  auto collect = [&](float d, IdxT id) {
+    if constexpr (kFiltered) {
+      if (results->accepts(d) && admit(id)) { results->push(d, id); }
+    }
+  };
+
+  // Random initial nodes, as in `compute_distance_to_random_nodes` of the device search.
+  ws.candidates.clear();
+  const size_t num_pickup = itopk_size + n_children;
+  for (size_t i = 0; i < num_pickup; i++) {
+    IdxT best_id    = kInvalidIndex;
+    float best_dist = kInvalidDist;
+    for (uint32_t j = 0; j < plan.num_random_samplings; j++) {
+      uint64_t gid = i + num_pickup * j;
+      auto id      = static_cast<IdxT>(device::xorshift64(gid ^ plan.rand_xor_mask) % n_rows);
+      float d      = distance(row(id));
+      if (d < best_dist) {
+        best_dist = d;
+        best_id   = id;
+      }
+    }
+    if (best_id != kInvalidIndex && ws.visited.insert(best_id)) {
+      ws.candidates.emplace_back(best_dist, best_id);
+      collect(best_dist, best_id);
+    }
+  }
+  std::sort(ws.candidates.begin(), ws.candidates.end(), by_distance);
+  ws.itopk.assign(ws.candidates.begin(),
+                  ws.candidates.begin() + std::min(itopk_size, ws.candidates.size()));
+
+  for (uint32_t iter = 0;; iter++) {
+    if (iter > 0) {
+      // Merge the new candidates into the internal top-k list.
+      std::sort(ws.candidates.begin(), ws.candidates.end(), by_distance);
+      ws.merged.clear();
+      std::merge(ws.itopk.begin(),
+                 ws.itopk.end(),
+                 ws.candidates.begin(),
+                 ws.candidates.end(),
+                 std::back_inserter(ws.merged),
+                 by_distance);
+      if (ws.merged.size() > itopk_size) { ws.merged.resize(itopk_size); }
+      std::swap(ws.itopk, ws.merged);
+    }
+
+    if (plan.small_hash_reset_interval > 0 &&
+        (iter + 1) % plan.small_hash_reset_interval == 0) {
+      // Restore the small hash table with the nodes of the internal top-k list.
+      ws.visited.clear();
+      for (const auto& e : ws.itopk) {
+        ws.visited.insert(e.second & ~kParentFlag);
+      }
+    }
+
+    if (iter + 1 >= plan.max_iterations) { break; }
+
+    // Pick up the next parents and gather their unvisited neighbors, so the rows can be fetched
+    // ahead of the distance computation.
+    uint32_t n_parents = 0;
+    ws.candidates.clear();
+    for (auto& e : ws.itopk) {
+      if (n_parents == plan.search_width) { break; }
+      if (e.second & kParentFlag) { continue; }
+      const IdxT* neighbors = graph + size_t(e.second) * graph_degree;
+      e.second |= kParentFlag;
+      n_parents++;
+      for (uint32_t j = 0; j < graph_degree; j++) {
+        IdxT child = neighbors[j];
+        if (child >= n_rows || !ws.visited.insert(child)) { continue; }
+        __builtin_prefetch(row(child));
+        ws.candidates.emplace_back(0.0f, child);
+      }
+    }
+
+    if (n_parents == 0 && iter >= plan.min_iterations) { break; }
+
+    for (auto& e : ws.candidates) {
+      e.first = distance(row(e.second));
+      collect(e.first, e.second);
+    }
+  }
+
+  size_t n_found = 0;
+  if constexpr (kFiltered) {
+    n_found = results->pop_sorted(out_distances, out_indices);
+  } else {
+    for (; n_found < std::min<size_t>(topk, ws.itopk.size()); n_found++) {
+      out_indices[n_found] = ws.itopk[n_found].second & ~kParentFlag;
+      if (out_distances != nullptr) { out_distances[n_found] = ws.itopk[n_found].first; }
+    }
+  }
+  for (size_t i = n_found; i < topk; i++) {
+    out_indices[i] = kInvalidIndex;
+    if (out_distances != nullptr) { out_distances[i] = kInvalidDist; }
+  }
+}
+
+/**
+ * Exact search of one query among the given rows of the dataset, used instead of the graph search
+ * when a filter admits few rows.
+ *
+ * @param distance `(const T* row) -> float`, smaller is closer
+ */
+template <typename T, typename IdxT, typename DistanceOp>
+void scan_rows_host_query(const T* dataset,
+                          size_t dim,
+                          const std::vector<int64_t>& rows,
+                          DistanceOp distance,
+                          uint32_t topk,
+                          IdxT* out_indices,
+                          float* out_distances)
+{
+  auto& heap = cuvs::selection::detail::host::thread_local_heap<float, IdxT>(topk);
+  for (auto r : rows) {
+    float d = distance(dataset + dim * size_t(r));
+    if (heap.accepts(d)) { heap.push(d, static_cast<IdxT>(r)); }
+  }
+  const size_t n_found = heap.pop_sorted(out_distances, out_indices);
+  for (size_t i = n_found; i < topk; i++) {
+    out_indices[i] = std::numeric_limits<IdxT>::max();
+    if (out_distances != nullptr) { out_distances[i] = std::numeric_limits<float>::max(); }
+  }
+}
+
+/**
+ * Search a CAGRA graph on the host.
+ *
+ * The queries are processed in parallel (one query per OpenMP thread); the distances are computed
+ * by the SIMD kernels selected at runtime.
+ *
+ * With a bitset filter (`host_bitset`), the admitted rows are counted first; when there are few
+ * enough of them (see `prefer_admitted_scan`, compared with the number of distances the graph
+ * search computes at most), they are scanned exactly instead of searching the graph.
+ */
+template <typename T,
+          typename IdxT,
+          typename FilterT = cuvs::neighbors::filtering::detail::host_admit_all>
+void search_host(raft::resources const& res,
+                 const search_params& params,
+                 cuvs::distance::DistanceType metric,
+                 raft::host_matrix_view<const T, int64_t, raft::row_major> dataset,
+                 raft::host_matrix_view<const IdxT, int64_t, raft::row_major> graph,
+                 raft::host_matrix_view<const T, int64_t, raft::row_major> queries,
+                 raft::host_matrix_view<IdxT, int64_t, raft::row_major> neighbors,
+                 raft::host_matrix_view<float, int64_t, raft::row_major> distances,
+                 FilterT sample_filter = FilterT{})
+{
+  size_t n_queries      = queries.extent(0);
+  size_t n_rows         = dataset.extent(0);
+  size_t dim            = dataset.extent(1);
+  uint32_t graph_degree = graph.extent(1);
+  uint32_t topk         = neighbors.extent(1);
+
+  cuvs::common::nvtx::range<cuvs::common::nvtx::domain::cuvs> fun_scope(
+    "cagra::search_host(%zu, %u)", n_queries, topk);
+
+  RAFT_EXPECTS(graph.extent(0) == dataset.extent(0),
+               "Dataset and knn_graph must have equal number of rows");
+  RAFT_EXPECTS(queries.extent(1) == dataset.extent(1),
+               "Number of query dimensions should equal number of dimensions in the index.");
+  RAFT_EXPECTS(neighbors.extent(0) == queries.extent(0) && distances.extent(0) == queries.extent(0),
+               "Number of rows in output neighbors and distances matrices must equal the number of "
+               "queries.");
+  RAFT_EXPECTS(distances.extent(1) == neighbors.extent(1),
+               "Number of columns in output neighbors and distances matrices must equal k");
+  RAFT_EXPECTS(n_rows > 0, "Attempted to search an empty index");
+  RAFT_EXPECTS(n_rows < (size_t(1) << (sizeof(IdxT) * 8 - 1)),
+               "The most significant bit of IdxT is reserved for the parent flag");
+
+  host_search_plan plan(params, graph_degree, topk);
+  RAFT_LOG_DEBUG("# host search: itopk = %u, search_width = %u, max_iterations = %u, hash = %s%u",
+                 plan.itopk_size,
+                 plan.search_width,
+                 plan.max_iterations,
+                 plan.small_hash_reset_interval > 0 ? "small-" : "",
+                 1u << plan.hash_bitlen);
+
+  auto& kernels = cuvs::distance::detail::host::get_distance_kernels<T>();
+  float sign    = 1.0f;
+  cuvs::distance::detail::host::distance_kernel<T> kernel;
+  switch (metric) {
+    case cuvs::distance::DistanceType::L2Expanded:
+    case cuvs::distance::DistanceType::L2Unexpanded: kernel = kernels.l2; break;
+    case cuvs::distance::DistanceType::InnerProduct:
+      kernel = kernels.inner_product;
+      sign   = -1.0f;
+      break;
+    default: RAFT_FAIL("Unsupported metric for CAGRA host search: %d", static_cast<int>(metric));
+  }
+
+  std::optional<std::vector<int64_t>> admitted_rows;
+  if constexpr (!std::is_same_v<FilterT, cuvs::neighbors::filtering::detail::host_admit_all>) {
+    const size_t n_admitted = sample_filter.count();
+    const size_t n_children = size_t(plan.search_width) * graph_degree;
+    const size_t ann_rows   = (plan.itopk_size + n_children) * plan.num_random_samplings +
+                            size_t(plan.max_iterations) * n_children;
+    if (cuvs::neighbors::filtering::detail::prefer_admitted_scan(
+          n_admitted, n_rows, ann_rows, topk)) {
+      admitted_rows = sample_filter.admitted_rows();
+    }
+    RAFT_LOG_DEBUG("# host search: the filter admits %zu of %zu rows, %s",
+                   n_admitted,
+                   n_rows,
+                   admitted_rows ? "scanning them" : "searching the graph with the filter");
+  }
+
+#pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < n_queries; i++) {
+    const T* query = queries.data_handle() + dim * i;
+    auto distance  = [=](const T* row) { return sign * kernel(query, row, dim); };
+    float* out_distances = distances.data_handle() != nullptr ? distances.data_handle() + topk * i
+                                                               : nullptr;
+    if (admitted_rows) {
+      scan_rows_host_query(dataset.data_handle(),
+                           dim,
+                           *admitted_rows,
+                           distance,
+                           topk,
+                           neighbors.data_handle() + topk * i,
+                           out_distances);
+    } else {
+      search_host_query(plan,
+                        dataset.data_handle(),
+                        n_rows,
+                        dim,
+                        graph.data_handle(),
+                        graph_degree,
+                        distance,
+                        sample_filter,
+                        topk,
+                        neighbors.data_handle() + topk * i,
+                        out_distances);
+    }
+    if (out_distances != nullptr && sign != 1.0f) {
+      for (uint32_t j = 0; j < topk; j++) {
+        if (out_distances[j] != std::numeric_limits<float>::max()) { out_distances[j] *= sign; }
+      }
+    }
+  }
+}
+
+}  // namespace cuvs::neighbors::cagra::detail
@@ -25,17 +25,29 @@
 #include <raft/core/resource/cuda_stream.hpp>
 #include <raft/core/serialize.hpp>
 
+#include "../container_serialize.hpp"
 #include "../dataset_serialize.hpp"
+#include "cagra_deserialize_hnswlib.hpp"
+#include "cagra_serialize_hnswlib.hpp"
+#include "cagra_serialize_mapped.hpp"
+#include "graph_core_host.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <string_view>
 #include <type_traits>
 
 static const std::string RAFT_NAME = "raft";
 namespace cuvs::neighbors::cagra::detail {
 
-constexpr int serialization_version = 4;
+// Version 5 is a container (see ../container_serialize.hpp) with the sections "params", "graph"
+// and, optionally, "dataset"; version 4 is the flat format that preceded it.
+constexpr int serialization_version        = 5;
+constexpr int legacy_serialization_version = 4;
+constexpr std::string_view kContainerKind  = "cagra";
 
 /**
  * Save the index to file.
@@ -45,13 +57,16 @@ constexpr int serialization_version = 4;
  * @param[in] res the raft resource handle
  * @param[in] filename the file name for saving the index
  * @param[in] index_ CAGRA index
+ * @param[in] include_dataset whether to write the dataset
+ * @param[in] compression compression of the graph and the dataset
  *
  */
 template <typename T, typename IdxT>
 void serialize(raft::resources const& res,
                std::ostream& os,
                const index<T, IdxT>& index_,
-               bool include_dataset)
+               bool include_dataset,
+               serialize_compression compression = serialize_compression::NONE)
 {
   raft::common::nvtx::range<raft::common::nvtx::domain::raft> fun_scope("cagra::serialize");
 
@@ -60,37 +75,120 @@ void serialize(raft::resources const& res,
 
   std::string dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
   dtype_string.resize(4);
-  os << dtype_string;
 
-  raft::serialize_scalar(res, os, serialization_version);
-  raft::serialize_scalar(res, os, index_.size());
-  raft::serialize_scalar(res, os, index_.dim());
-  raft::serialize_scalar(res, os, index_.graph_degree());
-  raft::serialize_scalar(res, os, index_.metric());
-
-  raft::serialize_mdspan(res, os, index_.graph());
+  constexpr auto kRequired = neighbors::detail::kSectionRequired;
+  // The neighbor ids are much smaller than the range of IdxT; the varints of their differences
+  // take fewer bytes.
+  neighbors::detail::section_encoding graph_encoding;
+  neighbors::detail::section_encoding dataset_encoding;
+  if (compression != serialize_compression::NONE) {
+    graph_encoding   = {neighbors::detail::section_codec::kDeltaVarint, sizeof(IdxT)};
+    dataset_encoding = {neighbors::detail::section_codec::kShuffleLz, sizeof(T)};
+  }
+  neighbors::detail::container_writer writer(os, kContainerKind, serialization_version);
+  writer.section("params", 0, kRequired, [&](std::ostream& s) {
+    s << dtype_string;
+    raft::serialize_scalar(res, s, index_.size());
+    raft::serialize_scalar(res, s, index_.dim());
+    raft::serialize_scalar(res, s, index_.graph_degree());
+    raft::serialize_scalar(res, s, index_.metric());
+  });
+  writer.section("graph", 0, kRequired, graph_encoding, [&](std::ostream& s) {
+    raft::serialize_mdspan(res, s, index_.graph());
+  });
 
   include_dataset &= (index_.data().n_rows() > 0);
-
-  raft::serialize_scalar(res, os, include_dataset);
   if (include_dataset) {
     RAFT_LOG_INFO("Saving CAGRA index with dataset");
-    neighbors::detail::serialize(res, os, index_.data());
+    writer.section("dataset", 0, kRequired, dataset_encoding, [&](std::ostream& s) {
+      neighbors::detail::serialize(res, s, index_.data());
+    });
   } else {
     RAFT_LOG_DEBUG("Saving CAGRA index WITHOUT dataset");
   }
+  writer.finish();
 }
 
 template <typename T, typename IdxT>
 void serialize(raft::resources const& res,
                const std::string& filename,
                const index<T, IdxT>& index_,
-               bool include_dataset)
+               bool include_dataset,
+               serialize_compression compression = serialize_compression::NONE)
+{
+  std::ofstream of(filename, std::ios::out | std::ios::binary);
+  if (!of) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+
+  detail::serialize(res, of, index_, include_dataset, compression);
+
+  of.close();
+  if (!of) { RAFT_FAIL("Error writing output %s", filename.c_str()); }
+}
+
+/**
+ * Save the index in the mapped file layout (see `cagra_serialize_mapped.hpp`).
+ *
+ * The graph and the dataset are copied to the file through a host staging buffer of bounded size,
+ * so the host memory use does not depend on the index size.
+ */
+template <typename T, typename IdxT>
+void serialize_mapped(raft::resources const& res,
+                      const std::string& filename,
+                      const index<T, IdxT>& index_,
+                      bool include_dataset)
 {
+  raft::common::nvtx::range<raft::common::nvtx::domain::raft> fun_scope("cagra::serialize_mapped");
+
+  auto dataset = index_.dataset();
+  if (include_dataset && dataset.extent(0) == 0) {
+    RAFT_LOG_WARN("The CAGRA index has no uncompressed dataset, saving the graph only");
+    include_dataset = false;
+  }
+  auto header = make_mapped_header<T, IdxT>(
+    index_.size(), index_.dim(), index_.graph_degree(), index_.metric(), include_dataset);
+
   std::ofstream of(filename, std::ios::out | std::ios::binary);
   if (!of) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
 
-  detail::serialize(res, of, index_, include_dataset);
+  constexpr size_t kStagingBytes = size_t{64} << 20;
+  auto stream                    = raft::resource::get_cuda_stream(res);
+  auto staging                   = raft::make_host_vector<uint8_t, int64_t>(kStagingBytes);
+  // Copy `n_rows` rows of `row_elems` elements (at distance `stride` apart) to the file.
+  auto write_rows = [&](const auto* src, int64_t n_rows, int64_t row_elems, int64_t stride) {
+    using elem_t     = std::remove_cv_t<std::remove_pointer_t<decltype(src)>>;
+    size_t row_bytes = sizeof(elem_t) * row_elems;
+    int64_t chunk    = std::max<int64_t>(1, kStagingBytes / std::max<size_t>(row_bytes, 1));
+    if (size_t(chunk) * row_bytes > kStagingBytes) {
+      staging = raft::make_host_vector<uint8_t, int64_t>(chunk * row_bytes);
+    }
+    for (int64_t i = 0; i < n_rows; i += chunk) {
+      auto rows = std::min(chunk, n_rows - i);
+      RAFT_CUDA_TRY(cudaMemcpy2DAsync(staging.data_handle(),
+                                      row_bytes,
+                                      src + i * stride,
+                                      sizeof(elem_t) * stride,
+                                      row_bytes,
+                                      rows,
+                                      cudaMemcpyDefault,
+                                      stream));
+      raft::resource::sync_stream(res);
+      of.write(reinterpret_cast<const char*>(staging.data_handle()), rows * row_bytes);
+    }
+  };
+
+  uint64_t pos = 0;
+  of.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  pos += sizeof(header);
+  write_mapped_padding(of, pos, header.graph_offset);
+  auto graph = index_.graph();
+  write_rows(graph.data_handle(), graph.extent(0), graph.extent(1), graph.extent(1));
+  pos = header.graph_offset + graph.size() * sizeof(IdxT);
+  if (include_dataset) {
+    write_mapped_padding(of, pos, header.dataset_offset);
+    write_rows(dataset.data_handle(), dataset.extent(0), dataset.extent(1), dataset.stride(0));
+    pos = header.dataset_offset + dataset.extent(0) * dataset.extent(1) * sizeof(T);
+  }
+  write_mapped_padding(of, pos, header.file_bytes);
 
   of.close();
   if (!of) { RAFT_FAIL("Error writing output %s", filename.c_str()); }
@@ -108,108 +206,56 @@ void serialize_to_hnswlib(raft::resources const& res,
                  static_cast<size_t>(index_.size()),
                  index_.dim());
 
-  // offset_level_0
-  std::size_t offset_level_0 = 0;
-  os.write(reinterpret_cast<char*>(&offset_level_0), sizeof(std::size_t));
-  // max_element
-  std::size_t max_element = index_.size();
-  os.write(reinterpret_cast<char*>(&max_element), sizeof(std::size_t));
-  // curr_element_count
-  std::size_t curr_element_count = index_.size();
-  os.write(reinterpret_cast<char*>(&curr_element_count), sizeof(std::size_t));
-  // Example:M: 16, dim = 128, data_t = float, index_t = uint32_t, list_size_type = uint32_t,
-  // labeltype: size_t size_data_per_element_ = M * 2 * sizeof(index_t) + sizeof(list_size_type) +
-  // dim * sizeof(data_t) + sizeof(labeltype)
-  auto size_data_per_element = static_cast<std::size_t>(index_.graph_degree() * sizeof(IdxT) + 4 +
-                                                        index_.dim() * sizeof(T) + 8);
-  os.write(reinterpret_cast<char*>(&size_data_per_element), sizeof(std::size_t));
-  // label_offset
-  std::size_t label_offset = size_data_per_element - 8;
-  os.write(reinterpret_cast<char*>(&label_offset), sizeof(std::size_t));
-  // offset_data
-  auto offset_data = static_cast<std::size_t>(index_.graph_degree() * sizeof(IdxT) + 4);
-  os.write(reinterpret_cast<char*>(&offset_data), sizeof(std::size_t));
-  // max_level
-  int max_level = 1;
-  os.write(reinterpret_cast<char*>(&max_level), sizeof(int));
-  // entrypoint_node
-  auto entrypoint_node = static_cast<int>(index_.size() / 2);
-  os.write(reinterpret_cast<char*>(&entrypoint_node), sizeof(int));
-  // max_M
-  auto max_M = static_cast<std::size_t>(index_.graph_degree() / 2);
-  os.write(reinterpret_cast<char*>(&max_M), sizeof(std::size_t));
-  // max_M0
-  std::size_t max_M0 = index_.graph_degree();
-  os.write(reinterpret_cast<char*>(&max_M0), sizeof(std::size_t));
-  // M
-  auto M = static_cast<std::size_t>(index_.graph_degree() / 2);
-  os.write(reinterpret_cast<char*>(&M), sizeof(std::size_t));
-  // mult, can be anything
-  double mult = 0.42424242;
-  os.write(reinterpret_cast<char*>(&mult), sizeof(double));
-  // efConstruction, can be anything
-  std::size_t efConstruction = 500;
-  os.write(reinterpret_cast<char*>(&efConstruction), sizeof(std::size_t));
-
   auto dataset = index_.dataset();
-  // Remove padding before saving the dataset
-  auto host_dataset = raft::make_host_matrix<T, int64_t>(dataset.extent(0), dataset.extent(1));
-  RAFT_CUDA_TRY(cudaMemcpy2DAsync(host_dataset.data_handle(),
-                                  sizeof(T) * host_dataset.extent(1),
-                                  dataset.data_handle(),
-                                  sizeof(T) * dataset.stride(0),
-                                  sizeof(T) * host_dataset.extent(1),
-                                  dataset.extent(0),
-                                  cudaMemcpyDefault,
-                                  raft::resource::get_cuda_stream(res)));
-  raft::resource::sync_stream(res);
-
-  auto graph = index_.graph();
-  auto host_graph =
-    raft::make_host_matrix<IdxT, int64_t, raft::row_major>(graph.extent(0), graph.extent(1));
-  raft::copy(host_graph.data_handle(),
-             graph.data_handle(),
-             graph.size(),
-             raft::resource::get_cuda_stream(res));
-  raft::resource::sync_stream(res);
-
-  // Write one dataset and graph row at a time
-  for (std::size_t i = 0; i < index_.size(); i++) {
-    auto graph_degree = static_cast<int>(index_.graph_degree());
-    os.write(reinterpret_cast<char*>(&graph_degree), sizeof(int));
-
-    for (std::size_t j = 0; j < index_.graph_degree(); ++j) {
-      auto graph_elem = host_graph(i, j);
-      os.write(reinterpret_cast<char*>(&graph_elem), sizeof(IdxT));
-    }
-
-    auto data_row = host_dataset.data_handle() + (index_.dim() * i);
-    // if constexpr (std::is_same_v<T, float>) {
-    for (std::size_t j = 0; j < index_.dim(); ++j) {
-      auto data_elem = host_dataset(i, j);
-      os.write(reinterpret_cast<char*>(&data_elem), sizeof(T));
-    }
-    // } else if constexpr (std::is_same_v<T, std::int8_t> or std::is_same_v<T, std::uint8_t>) {
-    //   for (std::size_t j = 0; j < index_.dim(); ++j) {
-    //     auto data_elem = static_cast<int>(host_dataset(i, j));
-    //     os.write(reinterpret_cast<char*>(&data_elem), sizeof(int));
-    //   }
-    // }
-
-    os.write(reinterpret_cast<char*>(&i), sizeof(std::size_t));
-  }
-
-  for (std::size_t i = 0; i < index_.size(); i++) {
-    // zeroes
-    auto zero = 0;
-    os.write(reinterpret_cast<char*>(&zero), sizeof(int));
-  }
+  auto graph   = index_.graph();
+  RAFT_EXPECTS(dataset.extent(0) == graph.extent(0),
+               "The hnswlib export needs the dataset, but the index does not include it");
+
+  // Stream the rows through host staging buffers of one chunk each (removing the dataset padding)
+  // instead of copying the whole index to the host.
+  hnswlib_layout<T, IdxT> layout(index_.dim(), index_.graph_degree());
+  auto chunk_rows   = std::max<int64_t>(1, kHnswlibChunkBytes / layout.record_bytes);
+  chunk_rows        = std::min<int64_t>(chunk_rows, graph.extent(0));
+  auto host_graph   = raft::make_host_matrix<IdxT, int64_t>(chunk_rows, graph.extent(1));
+  auto host_dataset = raft::make_host_matrix<T, int64_t>(chunk_rows, dataset.extent(1));
+  auto stream       = raft::resource::get_cuda_stream(res);
+  auto fetch = [&](size_t first, size_t rows) {
+    raft::copy(host_graph.data_handle(),
+               graph.data_handle() + first * graph.extent(1),
+               rows * graph.extent(1),
+               stream);
+    RAFT_CUDA_TRY(cudaMemcpy2DAsync(host_dataset.data_handle(),
+                                    sizeof(T) * host_dataset.extent(1),
+                                    dataset.data_handle() + first * dataset.stride(0),
+                                    sizeof(T) * dataset.stride(0),
+                                    sizeof(T) * host_dataset.extent(1),
+                                    rows,
+                                    cudaMemcpyDefault,
+                                    stream));
+    raft::resource::sync_stream(res);
+    return std::pair<const IdxT*, const T*>(host_graph.data_handle(), host_dataset.data_handle());
+  };
+  write_hnswlib<T, IdxT>(
+    os, index_.size(), index_.dim(), index_.graph_degree(), index_.metric(), fetch);
 }
 
+/** Write an hnswlib index from a host-resident or memory-mapped CAGRA index. */
 template <typename T, typename IdxT>
+void serialize_to_hnswlib(raft::resources const& res,
+                          std::ostream& os,
+                          const cuvs::neighbors::cagra::mapped_index<T, IdxT>& index_)
+{
+  raft::common::nvtx::range<raft::common::nvtx::domain::raft> fun_scope("cagra::serialize");
+  RAFT_LOG_DEBUG("Saving mapped CAGRA index to hnswlib format, size %zu, dim %u",
+                 static_cast<size_t>(index_.size()),
+                 index_.dim());
+  serialize_to_hnswlib_host<T, IdxT>(os, index_.metric(), index_.graph(), index_.dataset());
+}
+
+template <typename T, typename IdxT, typename Index>
 void serialize_to_hnswlib(raft::resources const& res,
                           const std::string& filename,
-                          const cuvs::neighbors::cagra::index<T, IdxT>& index_)
+                          const Index& index_)
 {
   std::ofstream of(filename, std::ios::out | std::ios::binary);
   if (!of) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
@@ -220,6 +266,63 @@ void serialize_to_hnswlib(raft::resources const& res,
   if (!of) { RAFT_FAIL("Error writing output %s", filename.c_str()); }
 }
 
+/**
+ * Import an hnswlib index: its base layer becomes the CAGRA graph and its vectors the dataset.
+ *
+ * The level-0 lists are turned into a kNN graph of at least the hnswlib level-0 degree (see
+ * `hnswlib_to_knn_graph`), which is pruned to `params.graph_degree` on the host if it is wider.
+ * Only `params.metric` and `params.graph_degree` are used.
+ */
+template <typename T, typename IdxT>
+auto deserialize_from_hnswlib(raft::resources const& res,
+                              std::istream& is,
+                              const cuvs::neighbors::cagra::index_params& params) -> index<T, IdxT>
+{
+  raft::common::nvtx::range<raft::common::nvtx::domain::raft> fun_scope(
+    "cagra::deserialize_from_hnswlib");
+
+  auto header = read_hnswlib_header<T>(is);
+  auto base   = read_hnswlib_base_layer<T>(is, header);
+  RAFT_LOG_DEBUG("Importing hnswlib index, size %zu, dim %u, level-0 degree %u",
+                 base.n_rows,
+                 base.dim,
+                 base.max_degree);
+
+  int64_t n_rows     = base.n_live();
+  int64_t knn_degree = std::max<int64_t>(params.graph_degree, base.max_degree);
+  knn_degree         = std::max<int64_t>(params.graph_degree, std::min(knn_degree, n_rows - 1));
+  auto dataset       = raft::make_host_matrix<T, int64_t>(n_rows, base.dim);
+  auto knn_graph     = raft::make_host_matrix<IdxT, int64_t>(n_rows, knn_degree);
+  hnswlib_to_knn_graph<T, IdxT>(base, params.metric, dataset.view(), knn_graph.view());
+  base = hnswlib_base_layer<T>{};
+
+  index<T, IdxT> idx(res, params.metric);
+  if (knn_degree > static_cast<int64_t>(params.graph_degree)) {
+    auto graph = raft::make_host_matrix<IdxT, int64_t>(n_rows, params.graph_degree);
+    graph::optimize_host<IdxT>(raft::make_const_mdspan(knn_graph.view()), graph.view());
+    idx.update_graph(res, raft::make_const_mdspan(graph.view()));
+  } else {
+    idx.update_graph(res, raft::make_const_mdspan(knn_graph.view()));
+  }
+  idx.update_dataset(res, raft::make_const_mdspan(dataset.view()));
+  return idx;
+}
+
+template <typename T, typename IdxT>
+auto deserialize_from_hnswlib(raft::resources const& res,
+                              const std::string& filename,
+                              const cuvs::neighbors::cagra::index_params& params) -> index<T, IdxT>
+{
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  if (!is) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+
+  auto index = detail::deserialize_from_hnswlib<T, IdxT>(res, is, params);
+
+  is.close();
+
+  return index;
+}
+
 /** Load an index from file.
  *
  * Experimental, both the API and the serialization format are subject to change.
@@ -234,27 +337,62 @@ auto deserialize(raft::resources const& res, std::istream& is) -> index<T, IdxT>
 {
   raft::common::nvtx::range<raft::common::nvtx::domain::raft> fun_scope("cagra::deserialize");
 
-  char dtype_string[4];
-  is.read(dtype_string, 4);
-
-  auto ver = raft::deserialize_scalar<int>(res, is);
-  if (ver != serialization_version) {
-    RAFT_FAIL("serialization version mismatch, expected %d, got %d ", serialization_version, ver);
-  }
-  auto n_rows       = raft::deserialize_scalar<IdxT>(res, is);
-  auto dim          = raft::deserialize_scalar<std::uint32_t>(res, is);
-  auto graph_degree = raft::deserialize_scalar<std::uint32_t>(res, is);
-  auto metric       = raft::deserialize_scalar<cuvs::distance::DistanceType>(res, is);
-
-  auto graph = raft::make_host_matrix<IdxT, int64_t>(n_rows, graph_degree);
-  deserialize_mdspan(res, is, graph.view());
-
-  index<T, IdxT> idx(res, metric);
-  idx.update_graph(res, raft::make_const_mdspan(graph.view()));
-  bool has_dataset = raft::deserialize_scalar<bool>(res, is);
-  if (has_dataset) {
-    idx.update_dataset(res, cuvs::neighbors::detail::deserialize_dataset<int64_t>(res, is));
+  auto prefix = neighbors::detail::read_container_prefix(is);
+  if (!neighbors::detail::is_container(prefix)) {
+    // The prefix of the flat format is the dtype string.
+    auto ver = raft::deserialize_scalar<int>(res, is);
+    if (ver != legacy_serialization_version) {
+      RAFT_FAIL("serialization version mismatch, expected %d, got %d ",
+                legacy_serialization_version,
+                ver);
+    }
+    auto n_rows       = raft::deserialize_scalar<IdxT>(res, is);
+    auto dim          = raft::deserialize_scalar<std::uint32_t>(res, is);
+    auto graph_degree = raft::deserialize_scalar<std::uint32_t>(res, is);
+    auto metric       = raft::deserialize_scalar<cuvs::distance::DistanceType>(res, is);
+
+    auto graph = raft::make_host_matrix<IdxT, int64_t>(n_rows, graph_degree);
+    deserialize_mdspan(res, is, graph.view());
+
+    index<T, IdxT> idx(res, metric);
+    idx.update_graph(res, raft::make_const_mdspan(graph.view()));
+    bool has_dataset = raft::deserialize_scalar<bool>(res, is);
+    if (has_dataset) {
+      idx.update_dataset(res, cuvs::neighbors::detail::deserialize_dataset<int64_t>(res, is));
+    }
+    return idx;
   }
+
+  neighbors::detail::container_reader reader(is, prefix, kContainerKind, serialization_version);
+  index<T, IdxT> idx(res);
+  IdxT n_rows           = 0;
+  uint32_t graph_degree = 0;
+  reader.read_sections([&](const neighbors::detail::section_info& s, std::istream& payload) {
+    if (s.is("params")) {
+      auto dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
+      dtype_string.resize(4);
+      char stored_dtype[4];
+      payload.read(stored_dtype, 4);
+      RAFT_EXPECTS(std::memcmp(stored_dtype, dtype_string.data(), 4) == 0,
+                   "The data type of the CAGRA index does not match");
+      n_rows = raft::deserialize_scalar<IdxT>(res, payload);
+      raft::deserialize_scalar<std::uint32_t>(res, payload);  // dim
+      graph_degree = raft::deserialize_scalar<std::uint32_t>(res, payload);
+      idx          = index<T, IdxT>(
+        res, raft::deserialize_scalar<cuvs::distance::DistanceType>(res, payload));
+    } else if (s.is("graph")) {
+      RAFT_EXPECTS(reader.count_sections("params") > 0, "CAGRA graph precedes the parameters");
+      auto graph = raft::make_host_matrix<IdxT, int64_t>(n_rows, graph_degree);
+      deserialize_mdspan(res, payload, graph.view());
+      idx.update_graph(res, raft::make_const_mdspan(graph.view()));
+    } else if (s.is("dataset")) {
+      idx.update_dataset(res, cuvs::neighbors::detail::deserialize_dataset<int64_t>(res, payload));
+    } else {
+      return false;
+    }
+    return true;
+  });
+  reader.require_sections("CAGRA", {"params", "graph"});
   return idx;
 }
 
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "cagra_hnsw_hierarchy.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/cagra.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdspan.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace cuvs::neighbors::cagra::detail {
+
+/** Size of the blocks of level-0 records assembled in memory before they are written. */
+constexpr size_t kHnswlibChunkBytes = size_t{64} << 20;
+/** Beam width used to build the upper layers of the exported HNSW index. */
+constexpr uint32_t kHnswlibEfConstruction = 200;
+
+/**
+ * Layout of an hnswlib level-0 record:
+ *
+ *   uint32_t                 number of links
+ *   IdxT[graph_degree]       links
+ *   T[dim]                   vector
+ *   size_t                   label
+ */
+template <typename T, typename IdxT>
+struct hnswlib_layout {
+  size_t offset_data;
+  size_t label_offset;
+  size_t record_bytes;
+
+  hnswlib_layout(uint32_t dim, uint32_t graph_degree)
+    : offset_data(graph_degree * sizeof(IdxT) + sizeof(uint32_t)),
+      label_offset(offset_data + dim * sizeof(T)),
+      record_bytes(label_offset + sizeof(size_t))
+  {
+  }
+};
+
+/** Write the header of an hnswlib index. */
+template <typename T, typename IdxT>
+void write_hnswlib_header(std::ostream& os,
+                          size_t n_rows,
+                          uint32_t dim,
+                          uint32_t graph_degree,
+                          const hnsw_upper_layers<T, IdxT>& upper)
+{
+  hnswlib_layout<T, IdxT> layout(dim, graph_degree);
+  auto put = [&os](auto value) { os.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+  put(size_t{0});                                     // offset_level_0
+  put(n_rows);                                        // max_element
+  put(n_rows);                                        // curr_element_count
+  put(layout.record_bytes);                           // size_data_per_element
+  put(layout.label_offset);                           // label_offset
+  put(layout.offset_data);                            // offset_data
+  put(upper.max_level());                             // max_level
+  put(static_cast<int>(upper.entry_point()));         // entrypoint_node
+  put(static_cast<size_t>(upper.M()));                // max_M
+  put(static_cast<size_t>(graph_degree));             // max_M0
+  put(static_cast<size_t>(upper.M()));                // M
+  put(upper.mult());                                  // mult
+  put(static_cast<size_t>(upper.ef_construction()));  // efConstruction
+}
+
+/**
+ * Assemble the level-0 records of rows [first_row, first_row + n_rows) into `out`.
+ *
+ * `graph` and `dataset` point to the first of the rows; the rows are assembled in parallel.
+ */
+template <typename T, typename IdxT>
+void assemble_hnswlib_records(char* out,
+                              size_t first_row,
+                              size_t n_rows,
+                              uint32_t dim,
+                              uint32_t graph_degree,
+                              const IdxT* graph,
+                              size_t graph_stride,
+                              const T* dataset,
+                              size_t dataset_stride)
+{
+  hnswlib_layout<T, IdxT> layout(dim, graph_degree);
+  const auto n_links = static_cast<uint32_t>(graph_degree);
+#pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < n_rows; i++) {
+    char* record = out + i * layout.record_bytes;
+    size_t label = first_row + i;
+    std::memcpy(record, &n_links, sizeof(n_links));
+    std::memcpy(record + sizeof(n_links), graph + i * graph_stride, graph_degree * sizeof(IdxT));
+    std::memcpy(record + layout.offset_data, dataset + i * dataset_stride, dim * sizeof(T));
+    std::memcpy(record + layout.label_offset, &label, sizeof(label));
+  }
+}
+
+/**
+ * Write an hnswlib index, fetching the source rows in chunks.
+ *
+ * The base layer is the CAGRA graph. The records of a chunk are assembled in parallel while the
+ * previous chunk is being written, and the vectors of the rows sampled into the upper layers are
+ * collected on the way; the upper layers are then built on the host (see `hnsw_upper_layers`)
+ * and written after the base layer.
+ *
+ * @param fetch `(size_t first_row, size_t n_rows) -> std::pair<const IdxT*, const T*>` returns
+ *   contiguous graph and dataset rows of the chunk; the pointers must stay valid until the next
+ *   call.
+ */
+template <typename T, typename IdxT, typename FetchRows>
+void write_hnswlib(std::ostream& os,
+                   size_t n_rows,
+                   uint32_t dim,
+                   uint32_t graph_degree,
+                   cuvs::distance::DistanceType metric,
+                   FetchRows fetch)
+{
+  hnsw_upper_layers<T, IdxT> upper(n_rows, dim, graph_degree / 2, metric, kHnswlibEfConstruction);
+  write_hnswlib_header<T, IdxT>(os, n_rows, dim, graph_degree, upper);
+
+  hnswlib_layout<T, IdxT> layout(dim, graph_degree);
+  size_t chunk_rows = std::max<size_t>(1, kHnswlibChunkBytes / layout.record_bytes);
+  std::vector<char> buffers[2];
+  std::future<void> pending;
+  auto wait_pending = [&]() {
+    if (pending.valid()) { pending.get(); }
+  };
+  const auto& upper_rows = upper.upper_rows();
+  auto upper_it          = upper_rows.begin();
+  int current            = 0;
+  for (size_t first = 0; first < n_rows; first += chunk_rows) {
+    size_t rows           = std::min(chunk_rows, n_rows - first);
+    auto [graph, dataset] = fetch(first, rows);
+    auto& buffer          = buffers[current];
+    buffer.resize(rows * layout.record_bytes);
+    assemble_hnswlib_records<T, IdxT>(
+      buffer.data(), first, rows, dim, graph_degree, graph, graph_degree, dataset, dim);
+
+    auto upper_end = std::lower_bound(
+      upper_it, upper_rows.end(), std::make_pair(IdxT(first + rows), uint32_t{0}));
+    for (; upper_it != upper_end; ++upper_it) {
+      std::copy(dataset + size_t(upper_it->first - first) * dim,
+                dataset + size_t(upper_it->first - first + 1) * dim,
+                upper.upper_data() + size_t(upper_it->second) * dim);
+    }
+
+    wait_pending();
+    pending = std::async(std::launch::async, [&os, &buffer]() {
+      os.write(buffer.data(), buffer.size());
+    });
+    current ^= 1;
+  }
+  wait_pending();
+
+  upper.build();
+
+  // Upper-layer link lists of every element: their total size, then per level the link count
+  // followed by M links.
+  const size_t links_per_level = sizeof(uint32_t) * (1 + upper.M());
+  std::vector<char> buffer;
+  std::vector<uint32_t> block(1 + upper.M());
+  upper_it = upper_rows.begin();
+  for (size_t i = 0; i < n_rows; i++) {
+    uint32_t bytes = 0;
+    if (upper_it == upper_rows.end() || upper_it->first != IdxT(i)) {
+      buffer.insert(buffer.end(),
+                    reinterpret_cast<const char*>(&bytes),
+                    reinterpret_cast<const char*>(&bytes) + sizeof(bytes));
+    } else {
+      uint32_t rank = upper_it++->second;
+      int level     = upper.level_of_rank(rank);
+      bytes         = level * links_per_level;
+      buffer.insert(buffer.end(),
+                    reinterpret_cast<const char*>(&bytes),
+                    reinterpret_cast<const char*>(&bytes) + sizeof(bytes));
+      for (int l = 1; l <= level; l++) {
+        std::fill(block.begin(), block.end(), 0);
+        block[0] = upper.links(rank, l, block.data() + 1);
+        buffer.insert(buffer.end(),
+                      reinterpret_cast<const char*>(block.data()),
+                      reinterpret_cast<const char*>(block.data()) + links_per_level);
+      }
+    }
+    if (buffer.size() >= kHnswlibChunkBytes) {
+      os.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+  os.write(buffer.data(), buffer.size());
+}
+
+/** Write an hnswlib index from host-resident (e.g. memory-mapped) graph and dataset. */
+template <typename T, typename IdxT>
+void serialize_to_hnswlib_host(std::ostream& os,
+                               cuvs::distance::DistanceType metric,
+                               raft::host_matrix_view<const IdxT, int64_t, raft::row_major> graph,
+                               raft::host_matrix_view<const T, int64_t, raft::row_major> dataset)
+{
+  RAFT_EXPECTS(graph.extent(0) == dataset.extent(0),
+               "The hnswlib export needs the dataset, but the index does not include it");
+  write_hnswlib<T, IdxT>(
+    os, graph.extent(0), dataset.extent(1), graph.extent(1), metric, [&](size_t first, size_t) {
+      return std::make_pair(graph.data_handle() + first * graph.extent(1),
+                            dataset.data_handle() + first * dataset.extent(1));
+    });
+}
+
+}  // namespace cuvs::neighbors::cagra::detail
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../../core/mmap.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/cagra.hpp>
+#include <raft/core/detail/mdspan_numpy_serializer.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdspan.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace cuvs::neighbors::cagra::detail {
+
+/*
+ * Mapped file layout (all integers in native byte order):
+ *
+ *   [0, header_bytes)                 mapped_file_header
+ *   [graph_offset, +graph bytes)      graph, row-major [n_rows, graph_degree] of IdxT
+ *   [dataset_offset, +dataset bytes)  dataset, row-major [n_rows, dim] of T (only if included)
+ *
+ * The section offsets are multiples of `alignment`, so that the sections are page-aligned in a
+ * mapping of the file; the gaps are zero-filled.
+ */
+constexpr char kMappedMagic[8]                 = {'C', 'A', 'G', 'R', 'A', 'M', 'A', 'P'};
+constexpr uint32_t mapped_serialization_version = 1;
+constexpr uint64_t kMappedAlignment            = 4096;
+
+struct mapped_file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_bytes;
+  /** numpy dtype string of the data type, e.g. "<f4" */
+  char dtype[4];
+  uint32_t index_bytes;
+  int32_t metric;
+  uint32_t dim;
+  uint32_t graph_degree;
+  uint32_t reserved;
+  uint64_t n_rows;
+  uint64_t alignment;
+  uint64_t graph_offset;
+  /** Zero if the dataset is not included. */
+  uint64_t dataset_offset;
+  uint64_t file_bytes;
+};
+static_assert(std::is_trivially_copyable_v<mapped_file_header>);
+
+inline auto mapped_align(uint64_t offset) -> uint64_t
+{
+  return (offset + kMappedAlignment - 1) / kMappedAlignment * kMappedAlignment;
+}
+
+template <typename T, typename IdxT>
+auto make_mapped_header(uint64_t n_rows,
+                        uint32_t dim,
+                        uint32_t graph_degree,
+                        cuvs::distance::DistanceType metric,
+                        bool include_dataset) -> mapped_file_header
+{
+  mapped_file_header h{};
+  std::memcpy(h.magic, kMappedMagic, sizeof(h.magic));
+  h.version      = mapped_serialization_version;
+  h.header_bytes = sizeof(mapped_file_header);
+  auto dtype     = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
+  std::memcpy(h.dtype, dtype.c_str(), std::min(dtype.size(), sizeof(h.dtype)));
+  h.index_bytes  = sizeof(IdxT);
+  h.metric       = static_cast<int32_t>(metric);
+  h.dim          = dim;
+  h.graph_degree = graph_degree;
+  h.n_rows       = n_rows;
+  h.alignment    = kMappedAlignment;
+  h.graph_offset = mapped_align(sizeof(mapped_file_header));
+  uint64_t end   = h.graph_offset + n_rows * graph_degree * sizeof(IdxT);
+  if (include_dataset) {
+    h.dataset_offset = mapped_align(end);
+    end              = h.dataset_offset + n_rows * dim * sizeof(T);
+  }
+  h.file_bytes = mapped_align(end);
+  return h;
+}
+
+/** Write zeros to advance the stream from offset `from` to offset `to`. */
+inline void write_mapped_padding(std::ostream& os, uint64_t from, uint64_t to)
+{
+  static const char zeros[kMappedAlignment] = {};
+  while (from < to) {
+    auto n = std::min<uint64_t>(to - from, sizeof(zeros));
+    os.write(zeros, n);
+    from += n;
+  }
+}
+
+/**
+ * Map a file written by `serialize_mapped`.
+ *
+ * Only the header is read and validated; the returned index views the mapping.
+ */
+template <typename T, typename IdxT>
+auto deserialize_mapped(const std::string& filename) -> mapped_index<T, IdxT>
+{
+  auto file = std::make_shared<cuvs::core::detail::mapped_file>(filename);
+
+  mapped_file_header h{};
+  RAFT_EXPECTS(file->size() >= sizeof(h), "File %s is not a mapped CAGRA index", filename.c_str());
+  std::memcpy(&h, file->data(), sizeof(h));
+  RAFT_EXPECTS(std::memcmp(h.magic, kMappedMagic, sizeof(h.magic)) == 0,
+               "File %s is not a mapped CAGRA index",
+               filename.c_str());
+  if (h.version != mapped_serialization_version) {
+    RAFT_FAIL("serialization version mismatch, expected %u, got %u ",
+              mapped_serialization_version,
+              h.version);
+  }
+  auto dtype = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
+  dtype.resize(sizeof(h.dtype));
+  RAFT_EXPECTS(std::memcmp(h.dtype, dtype.data(), sizeof(h.dtype)) == 0 &&
+                 h.index_bytes == sizeof(IdxT),
+               "The data or index type of the mapped CAGRA index does not match");
+
+  auto check_section = [&](uint64_t offset, uint64_t row_bytes, const char* name) {
+    RAFT_EXPECTS(offset >= h.header_bytes && h.alignment > 0 && offset % h.alignment == 0,
+                 "Invalid %s offset in %s",
+                 name,
+                 filename.c_str());
+    RAFT_EXPECTS(offset <= file->size() &&
+                   (row_bytes == 0 || h.n_rows <= (file->size() - offset) / row_bytes),
+                 "File %s is truncated (%s section)",
+                 filename.c_str(),
+                 name);
+  };
+  check_section(h.graph_offset, uint64_t(h.graph_degree) * sizeof(IdxT), "graph");
+  int64_t dataset_rows = 0;
+  if (h.dataset_offset != 0) {
+    check_section(h.dataset_offset, uint64_t(h.dim) * sizeof(T), "dataset");
+    dataset_rows = h.n_rows;
+  }
+
+  auto graph = raft::make_host_matrix_view<const IdxT, int64_t>(
+    reinterpret_cast<const IdxT*>(file->data() + h.graph_offset), h.n_rows, h.graph_degree);
+  auto dataset = raft::make_host_matrix_view<const T, int64_t>(
+    reinterpret_cast<const T*>(file->data() + h.dataset_offset), dataset_rows, h.dim);
+  // The aliasing constructor keeps the whole mapping alive.
+  std::shared_ptr<const void> mapping(file, file->data());
+  return mapped_index<T, IdxT>(
+    std::move(mapping), static_cast<cuvs::distance::DistanceType>(h.metric), graph, dataset);
+}
+
+}  // namespace cuvs::neighbors::cagra::detail
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "graph_core_host.hpp"
 #include "utils.hpp"
 
 #include <raft/core/device_mdspan.hpp>
@@ -210,23 +211,6 @@ RAFT_KERNEL kern_make_rev_graph(const IdxT* const dest_nodes,     // [graph_size
     if (pos < degree) { rev_graph[pos + ((uint64_t)degree * dest_id)] = src_id; }
   }
 }
-
-template <class T>
-uint64_t pos_in_array(T val, const T* array, uint64_t num)
-{
-  for (uint64_t i = 0; i < num; i++) {
-    if (val == array[i]) { return i; }
-  }
-  return num;
-}
-
-template <class T>
-void shift_array(T* array, uint64_t num)
-{
-  for (uint64_t i = num; i > 0; i--) {
-    array[i] = array[i - 1];
-  }
-}
 }  // namespace
 
 template <
@@ -430,24 +414,12 @@ void optimize(
     const auto num_full = host_stats.data_handle()[1];
 
     // Create pruned kNN graph
-    uint32_t max_detour = 0;
-#pragma omp parallel for reduction(max : max_detour)
-    for (uint64_t i = 0; i < graph_size; i++) {
-      uint64_t pk = 0;
-      for (uint32_t num_detour = 0; num_detour < output_graph_degree; num_detour++) {
-        if (max_detour < num_detour) { max_detour = num_detour; /* stats */ }
-        for (uint64_t k = 0; k < input_graph_degree; k++) {
-          if (detour_count.data_handle()[k + (input_graph_degree * i)] != num_detour) { continue; }
-          output_graph_ptr[pk + (output_graph_degree * i)] =
-            input_graph_ptr[k + (input_graph_degree * i)];
-          pk += 1;
-          if (pk >= output_graph_degree) break;
-        }
-        if (pk >= output_graph_degree) break;
-      }
-      assert(pk == output_graph_degree);
-    }
-    // RAFT_LOG_DEBUG("# max_detour: %u\n", max_detour);
+    select_pruned_edges<IdxT>(
+      raft::make_host_matrix_view<const IdxT, int64_t>(
+        input_graph_ptr, graph_size, input_graph_degree),
+      raft::make_host_matrix_view<const uint8_t, int64_t>(
+        detour_count.data_handle(), graph_size, input_graph_degree),
+      new_graph);
 
     const double time_prune_end = cur_time();
     RAFT_LOG_DEBUG(
@@ -525,57 +497,12 @@ void optimize(
     RAFT_LOG_DEBUG("# Making reverse graph time: %.1lf sec", time_make_end - time_make_start);
   }
 
-  {
-    //
-    // Replace some edges with reverse edges
-    //
-    const double time_replace_start = cur_time();
-
-    const uint64_t num_protected_edges = output_graph_degree / 2;
-    RAFT_LOG_DEBUG("# num_protected_edges: %lu", num_protected_edges);
-
-    constexpr int _omp_chunk = 1024;
-#pragma omp parallel for schedule(dynamic, _omp_chunk)
-    for (uint64_t j = 0; j < graph_size; j++) {
-      uint64_t k = std::min(rev_graph_count.data_handle()[j], output_graph_degree);
-      while (k) {
-        k--;
-        uint64_t i = rev_graph.data_handle()[k + (output_graph_degree * j)];
-
-        uint64_t pos =
-          pos_in_array<IdxT>(i, output_graph_ptr + (output_graph_degree * j), output_graph_degree);
-        if (pos < num_protected_edges) { continue; }
-        uint64_t num_shift = pos - num_protected_edges;
-        if (pos == output_graph_degree) {
-          num_shift = output_graph_degree - num_protected_edges - 1;
-        }
-        shift_array<IdxT>(output_graph_ptr + num_protected_edges + (output_graph_degree * j),
-                          num_shift);
-        output_graph_ptr[num_protected_edges + (output_graph_degree * j)] = i;
-      }
-      if ((omp_get_thread_num() == 0) && ((j % _omp_chunk) == 0)) {
-        RAFT_LOG_DEBUG("# Replacing reverse edges: %lu / %lu    ", j, graph_size);
-      }
-    }
-    RAFT_LOG_DEBUG("\n");
-
-    const double time_replace_end = cur_time();
-    RAFT_LOG_DEBUG("# Replacing edges time: %.1lf sec", time_replace_end - time_replace_start);
-
-    /* stats */
-    uint64_t num_replaced_edges = 0;
-#pragma omp parallel for reduction(+ : num_replaced_edges)
-    for (uint64_t i = 0; i < graph_size; i++) {
-      for (uint64_t k = 0; k < output_graph_degree; k++) {
-        const uint64_t j = output_graph_ptr[k + (output_graph_degree * i)];
-        const uint64_t pos =
-          pos_in_array<IdxT>(j, output_graph_ptr + (output_graph_degree * i), output_graph_degree);
-        if (pos == output_graph_degree) { num_replaced_edges += 1; }
-      }
-    }
-    RAFT_LOG_DEBUG("# Average number of replaced edges per node: %.2f",
-                   (double)num_replaced_edges / graph_size);
-  }
+  //
+  // Replace some edges with reverse edges
+  //
+  replace_with_reverse_edges<IdxT>(new_graph,
+                                   raft::make_const_mdspan(rev_graph.view()),
+                                   raft::make_const_mdspan(rev_graph_count.view()));
 }
 
 }  // namespace graph
@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../../../core/nvtx.hpp"
+
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/host_mdspan.hpp>
+#include <raft/core/logger.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/*
+ * Host building blocks of the CAGRA graph optimization, shared by the GPU `optimize`
+ * (graph_core.cuh) and the pure-host `optimize_host`.
+ */
+namespace cuvs::neighbors::cagra::detail::graph {
+
+template <class T>
+uint64_t pos_in_array(T val, const T* array, uint64_t num)
+{
+  for (uint64_t i = 0; i < num; i++) {
+    if (val == array[i]) { return i; }
+  }
+  return num;
+}
+
+template <class T>
+void shift_array(T* array, uint64_t num)
+{
+  for (uint64_t i = num; i > 0; i--) {
+    array[i] = array[i - 1];
+  }
+}
+
+inline double elapsed_seconds(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Count the 2-hop detours of every edge of a kNN graph sorted by distance; the host equivalent
+ * of `kern_prune`.
+ *
+ * For the k-th edge A->B, the detours are the edges A->D shorter than A->B (k' < k) such that D
+ * has an edge D->B. The counts saturate at 255.
+ *
+ * Each row is processed by one thread, which puts the neighbors of A into a small open-addressing
+ * table (id -> position), so that every edge D->B of the neighbors D is matched against A's list
+ * with one lookup. Most of the candidates B are not neighbors of A; a bitmask of the hashed
+ * neighbor ids rejects almost all of them before probing the table. Rows listing a node twice
+ * fall back to a binary search over the (id, position) pairs, to find the first position after
+ * A->D as the GPU does. Invalid ids (>= n_rows, e.g. padding) are kept out of the table, in a short
+ * list of the row that is searched linearly.
+ *
+ * @param[in] knn_graph [n_rows, input_graph_degree], rows sorted by distance
+ * @param[out] detour_count [n_rows, input_graph_degree]
+ * @param[in] output_graph_degree the degree the graph is pruned to (for the statistics)
+ * @param[out] num_keep the total number of edges without detours (each row capped at
+ *   output_graph_degree)
+ * @param[out] num_full the number of rows with at least output_graph_degree edges without detours
+ */
+template <typename IdxT>
+void count_detours_host(raft::host_matrix_view<const IdxT, int64_t, raft::row_major> knn_graph,
+                        raft::host_matrix_view<uint8_t, int64_t, raft::row_major> detour_count,
+                        uint32_t output_graph_degree,
+                        uint64_t* num_keep,
+                        uint64_t* num_full)
+{
+  const uint64_t graph_size   = knn_graph.extent(0);
+  const uint32_t graph_degree = knn_graph.extent(1);
+  const IdxT* graph           = knn_graph.data_handle();
+  constexpr IdxT kEmpty       = std::numeric_limits<IdxT>::max();
+  uint32_t table_bits         = 1;
+  while ((1u << table_bits) < 2 * graph_degree) {
+    table_bits++;
+  }
+  const uint32_t table_mask = (1u << table_bits) - 1;
+  // The bitmask has 16 bits per table slot (32 per neighbor).
+  const uint32_t filter_bits = (table_mask + 1) * 16;
+  auto hash_of               = [](IdxT id) { return uint64_t(id) * 0x9e3779b97f4a7c15ull; };
+  auto slot_of = [table_bits](uint64_t hash) { return uint32_t(hash >> (64 - table_bits)); };
+  auto bit_of  = [filter_bits](uint64_t hash) { return uint32_t(hash >> 32) & (filter_bits - 1); };
+
+  uint64_t keep = 0;
+  uint64_t full = 0;
+#pragma omp parallel reduction(+ : keep, full)
+  {
+    std::vector<IdxT> table_ids(table_mask + 1);
+    std::vector<uint32_t> table_pos(table_mask + 1);
+    std::vector<uint64_t> filter(filter_bits / 64);
+    std::vector<std::pair<IdxT, uint32_t>> sorted_row(graph_degree);
+    // (id, position) of the invalid edges of the row, e.g. padding, in row order
+    std::vector<std::pair<IdxT, uint32_t>> invalid_edges;
+    std::vector<uint32_t> num_detour(graph_degree);
+#pragma omp for schedule(dynamic, 256)
+    for (uint64_t iA = 0; iA < graph_size; iA++) {
+      const IdxT* row = graph + graph_degree * iA;
+      std::fill(num_detour.begin(), num_detour.end(), 0);
+      std::fill(table_ids.begin(), table_ids.end(), kEmpty);
+      std::fill(filter.begin(), filter.end(), 0);
+      invalid_edges.clear();
+      bool has_duplicates = false;
+      for (uint32_t k = 0; k < graph_degree && !has_duplicates; k++) {
+        // Invalid ids stay out of the table: the sentinel kEmpty would match an empty slot.
+        if (row[k] >= graph_size) {
+          invalid_edges.emplace_back(row[k], k);
+          continue;
+        }
+        const uint64_t hash = hash_of(row[k]);
+        filter[bit_of(hash) / 64] |= uint64_t{1} << (bit_of(hash) % 64);
+        uint32_t slot = slot_of(hash);
+        while (table_ids[slot] != kEmpty && table_ids[slot] != row[k]) {
+          slot = (slot + 1) & table_mask;
+        }
+        has_duplicates  = table_ids[slot] == row[k];
+        table_ids[slot] = row[k];
+        table_pos[slot] = k;
+      }
+      if (has_duplicates) {
+        for (uint32_t k = 0; k < graph_degree; k++) {
+          sorted_row[k] = std::make_pair(row[k], k);
+        }
+        std::sort(sorted_row.begin(), sorted_row.end());
+      }
+
+      for (uint32_t kAD = 0; kAD + 1 < graph_degree; kAD++) {
+        const uint64_t iD = row[kAD];
+        if (iD >= graph_size) { continue; }
+        const IdxT* row_D = graph + graph_degree * iD;
+        for (uint32_t kDB = 0; kDB < graph_degree; kDB++) {
+          const IdxT iB = row_D[kDB];
+          // The first edge A->B after A->D.
+          if (!has_duplicates && iB >= graph_size) {
+            for (const auto& [id, k] : invalid_edges) {
+              if (id == iB && k > kAD) {
+                num_detour[k]++;
+                break;
+              }
+            }
+          } else if (!has_duplicates) {
+            const uint64_t hash = hash_of(iB);
+            if (!((filter[bit_of(hash) / 64] >> (bit_of(hash) % 64)) & 1)) { continue; }
+            uint32_t slot = slot_of(hash);
+            while (table_ids[slot] != kEmpty && table_ids[slot] != iB) {
+              slot = (slot + 1) & table_mask;
+            }
+            if (table_ids[slot] == iB && table_pos[slot] > kAD) { num_detour[table_pos[slot]]++; }
+          } else {
+            auto it = std::lower_bound(
+              sorted_row.begin(), sorted_row.end(), std::make_pair(iB, kAD + 1));
+            if (it != sorted_row.end() && it->first == iB) { num_detour[it->second]++; }
+          }
+        }
+      }
+
+      uint32_t num_edges_no_detour = 0;
+      for (uint32_t k = 0; k < graph_degree; k++) {
+        detour_count(iA, k) = std::min<uint32_t>(num_detour[k], 255);
+        if (num_detour[k] == 0) { num_edges_no_detour++; }
+      }
+      num_edges_no_detour = std::min(num_edges_no_detour, output_graph_degree);
+      keep += num_edges_no_detour;
+      if (num_edges_no_detour >= output_graph_degree) { full++; }
+    }
+  }
+  *num_keep = keep;
+  *num_full = full;
+}
+
+/**
+ * Pick the `output_graph_degree` edges of every row with the fewest detours, in the order of the
+ * input graph.
+ */
+template <typename IdxT>
+void select_pruned_edges(
+  raft::host_matrix_view<const IdxT, int64_t, raft::row_major> knn_graph,
+  raft::host_matrix_view<const uint8_t, int64_t, raft::row_major> detour_count,
+  raft::host_matrix_view<IdxT, int64_t, raft::row_major> new_graph)
+{
+  const uint64_t graph_size          = knn_graph.extent(0);
+  const uint64_t input_graph_degree  = knn_graph.extent(1);
+  const uint32_t output_graph_degree = new_graph.extent(1);
+  const IdxT* input_graph_ptr        = knn_graph.data_handle();
+  const uint8_t* detour_count_ptr    = detour_count.data_handle();
+  IdxT* output_graph_ptr             = new_graph.data_handle();
+
+#pragma omp parallel for
+  for (uint64_t i = 0; i < graph_size; i++) {
+    uint64_t pk = 0;
+    for (uint32_t num_detour = 0; num_detour < output_graph_degree; num_detour++) {
+      for (uint64_t k = 0; k < input_graph_degree; k++) {
+        if (detour_count_ptr[k + (input_graph_degree * i)] != num_detour) { continue; }
+        output_graph_ptr[pk + (output_graph_degree * i)] =
+          input_graph_ptr[k + (input_graph_degree * i)];
+        pk += 1;
+        if (pk >= output_graph_degree) break;
+      }
+      if (pk >= output_graph_degree) break;
+    }
+    assert(pk == output_graph_degree);
+  }
+}
+
+/**
+ * Build the reverse graph of the pruned graph on the host.
+ *
+ * `rev_graph_count[j]` is the in-degree of node j. `rev_graph[j]` holds up to `degree` of the
+ * nodes with an edge to j, those of the shortest edges first (the edge position in the source
+ * row, then the source id), and is padded with invalid ids. The in-edges are gathered with one
+ * parallel counting pass and one parallel scatter over the whole graph, then every row is sorted
+ * independently, so the result does not depend on the number of threads.
+ */
+template <typename IdxT>
+void make_reverse_graph_host(raft::host_matrix_view<const IdxT, int64_t, raft::row_major> graph,
+                             raft::host_matrix_view<IdxT, int64_t, raft::row_major> rev_graph,
+                             raft::host_vector_view<uint32_t, int64_t> rev_graph_count)
+{
+  const uint64_t graph_size = graph.extent(0);
+  const uint32_t degree     = graph.extent(1);
+  const IdxT* graph_ptr     = graph.data_handle();
+  uint32_t* count           = rev_graph_count.data_handle();
+
+  std::fill(count, count + graph_size, 0);
+#pragma omp parallel for
+  for (uint64_t i = 0; i < graph_size * degree; i++) {
+    const uint64_t dest = graph_ptr[i];
+    if (dest >= graph_size) { continue; }
+#pragma omp atomic update
+    count[dest]++;
+  }
+
+  std::vector<uint64_t> offsets(graph_size + 1, 0);
+  for (uint64_t j = 0; j < graph_size; j++) {
+    offsets[j + 1] = offsets[j] + count[j];
+  }
+  std::vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+  // (position of the edge in the source row, source)
+  std::vector<std::pair<uint32_t, IdxT>> in_edges(offsets[graph_size]);
+#pragma omp parallel for
+  for (uint64_t src = 0; src < graph_size; src++) {
+    for (uint32_t k = 0; k < degree; k++) {
+      const uint64_t dest = graph_ptr[k + (uint64_t(degree) * src)];
+      if (dest >= graph_size) { continue; }
+      uint64_t pos;
+#pragma omp atomic capture
+      pos = cursor[dest]++;
+      in_edges[pos] = std::make_pair(k, static_cast<IdxT>(src));
+    }
+  }
+
+#pragma omp parallel for schedule(dynamic, 1024)
+  for (uint64_t j = 0; j < graph_size; j++) {
+    auto first = in_edges.begin() + offsets[j];
+    auto last  = in_edges.begin() + offsets[j + 1];
+    auto n     = std::min<uint64_t>(last - first, degree);
+    std::partial_sort(first, first + n, last);
+    for (uint32_t k = 0; k < degree; k++) {
+      rev_graph(j, k) = k < n ? first[k].second : std::numeric_limits<IdxT>::max();
+    }
+  }
+}
+
+/**
+ * Replace some of the edges of the pruned graph with reverse edges.
+ *
+ * The first half of every row is protected; a reverse edge j->i (from i->j) is moved to the
+ * front of the unprotected part, evicting the last edge if j->i is not in the row yet. The
+ * reverse edges of the shortest forward edges end up first.
+ */
+template <typename IdxT>
+void replace_with_reverse_edges(
+  raft::host_matrix_view<IdxT, int64_t, raft::row_major> new_graph,
+  raft::host_matrix_view<const IdxT, int64_t, raft::row_major> rev_graph,
+  raft::host_vector_view<const uint32_t, int64_t> rev_graph_count)
+{
+  const uint64_t graph_size          = new_graph.extent(0);
+  const uint64_t output_graph_degree = new_graph.extent(1);
+  IdxT* output_graph_ptr             = new_graph.data_handle();
+
+  const auto time_replace_start      = std::chrono::steady_clock::now();
+  const uint64_t num_protected_edges = output_graph_degree / 2;
+  RAFT_LOG_DEBUG("# num_protected_edges: %lu", num_protected_edges);
+
+  constexpr int _omp_chunk = 1024;
+#pragma omp parallel for schedule(dynamic, _omp_chunk)
+  for (uint64_t j = 0; j < graph_size; j++) {
+    uint64_t k = std::min<uint64_t>(rev_graph_count.data_handle()[j], output_graph_degree);
+    while (k) {
+      k--;
+      uint64_t i = rev_graph.data_handle()[k + (output_graph_degree * j)];
+
+      uint64_t pos =
+        pos_in_array<IdxT>(i, output_graph_ptr + (output_graph_degree * j), output_graph_degree);
+      if (pos < num_protected_edges) { continue; }
+      uint64_t num_shift = pos - num_protected_edges;
+      if (pos == output_graph_degree) {
+        num_shift = output_graph_degree - num_protected_edges - 1;
+      }
+      shift_array<IdxT>(output_graph_ptr + num_protected_edges + (output_graph_degree * j),
+                        num_shift);
+      output_graph_ptr[num_protected_edges + (output_graph_degree * j)] = i;
+    }
+    if ((omp_get_thread_num() == 0) && ((j % _omp_chunk) == 0)) {
+      RAFT_LOG_DEBUG("# Replacing reverse edges: %lu / %lu    ", j, graph_size);
+    }
+  }
+  RAFT_LOG_DEBUG("\n");
+  RAFT_LOG_DEBUG("# Replacing edges time: %.1lf sec", elapsed_seconds(time_replace_start));
+
+  /* stats */
+  uint64_t num_replaced_edges = 0;
+#pragma omp parallel for reduction(+ : num_replaced_edges)
+  for (uint64_t i = 0; i < graph_size; i++) {
+    for (uint64_t k = 0; k < output_graph_degree; k++) {
+      const uint64_t j = output_graph_ptr[k + (output_graph_degree * i)];
+      const uint64_t pos =
+        pos_in_array<IdxT>(j, output_graph_ptr + (output_graph_degree * i), output_graph_degree);
+      if (pos == output_graph_degree) { num_replaced_edges += 1; }
+    }
+  }
+  RAFT_LOG_DEBUG("# Average number of replaced edges per node: %.2f",
+                 (double)num_replaced_edges / graph_size);
+}
+
+/**
+ * Optimize a kNN graph into a CAGRA graph on the host, without a GPU.
+ *
+ * This runs the same steps as the GPU `optimize` (graph_core.cuh): count the 2-hop detours of
+ * every edge, keep the `new_graph.extent(1)` edges with the fewest detours, then replace some of
+ * them with reverse edges. The results only differ in the order of the reverse edges of a node
+ * coming from edges at the same position, which is arbitrary on the GPU and by source id here.
+ *
+ * @param[in] knn_graph [n_rows, input_graph_degree], rows sorted by distance
+ * @param[out] new_graph [n_rows, output_graph_degree], output_graph_degree <= input_graph_degree
+ */
+template <typename IdxT>
+void optimize_host(raft::host_matrix_view<const IdxT, int64_t, raft::row_major> knn_graph,
+                   raft::host_matrix_view<IdxT, int64_t, raft::row_major> new_graph)
+{
+  cuvs::common::nvtx::range<cuvs::common::nvtx::domain::cuvs> fun_scope(
+    "cagra::graph::optimize_host(%zu, %zu)",
+    static_cast<size_t>(knn_graph.extent(0)),
+    static_cast<size_t>(knn_graph.extent(1)));
+  RAFT_LOG_DEBUG(
+    "# Pruning kNN graph (size=%lu, degree=%lu)\n", knn_graph.extent(0), knn_graph.extent(1));
+
+  RAFT_EXPECTS(knn_graph.extent(0) == new_graph.extent(0),
+               "Each input array is expected to have the same number of rows");
+  RAFT_EXPECTS(new_graph.extent(1) <= knn_graph.extent(1),
+               "output graph cannot have more columns than input graph");
+  const int64_t graph_size           = new_graph.extent(0);
+  const uint32_t output_graph_degree = new_graph.extent(1);
+
+  {
+    const auto time_prune_start = std::chrono::steady_clock::now();
+    auto detour_count = raft::make_host_matrix<uint8_t, int64_t>(graph_size, knn_graph.extent(1));
+    uint64_t num_keep = 0;
+    uint64_t num_full = 0;
+    count_detours_host<IdxT>(
+      knn_graph, detour_count.view(), output_graph_degree, &num_keep, &num_full);
+    select_pruned_edges<IdxT>(knn_graph, raft::make_const_mdspan(detour_count.view()), new_graph);
+    RAFT_LOG_DEBUG(
+      "# Pruning time: %.1lf sec, "
+      "avg_no_detour_edges_per_node: %.2lf/%u, "
+      "nodes_with_no_detour_at_all_edges: %.1lf%%\n",
+      elapsed_seconds(time_prune_start),
+      (double)num_keep / graph_size,
+      output_graph_degree,
+      (double)num_full / graph_size * 100);
+  }
+
+  auto rev_graph       = raft::make_host_matrix<IdxT, int64_t>(graph_size, output_graph_degree);
+  auto rev_graph_count = raft::make_host_vector<uint32_t, int64_t>(graph_size);
+  {
+    const auto time_make_start = std::chrono::steady_clock::now();
+    make_reverse_graph_host<IdxT>(
+      raft::make_const_mdspan(new_graph), rev_graph.view(), rev_graph_count.view());
+    RAFT_LOG_DEBUG("# Making reverse graph time: %.1lf sec", elapsed_seconds(time_make_start));
+  }
+
+  replace_with_reverse_edges<IdxT>(new_graph,
+                                   raft::make_const_mdspan(rev_graph.view()),
+                                   raft::make_const_mdspan(rev_graph_count.view()));
+}
+
+}  // namespace cuvs::neighbors::cagra::detail::graph
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <raft/core/error.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * The batched kNN graph construction of CAGRA as a pipeline of four stages, connected by bounded
+ * queues:
+ *
+ *   produce -> search -> refine (a pool of threads) -> write
+ *
+ * Every batch in flight owns one of `n_buffers` buffers, from the moment it is produced to the
+ * moment it is written, which bounds the memory of the pipeline. The search runs on the calling
+ * thread (the thread of the raft resources and their stream); the other stages run on their own
+ * threads, so that the host refine and the graph writes of some batches overlap with the search of
+ * the next ones.
+ *
+ * The stages are callbacks: this header depends on neither CUDA nor the search, and the CPU stages
+ * can run with a host stand-in for the search.
+ */
+namespace cuvs::neighbors::cagra::detail {
+
+/** A FIFO queue of at most `capacity` items, for one or more producers and consumers. */
+template <typename T>
+class bounded_queue {
+ public:
+  explicit bounded_queue(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+  /** Wait for room and add an item; returns false (dropping the item) if the queue is closed. */
+  auto push(T item) -> bool
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) { return false; }
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /** Wait for an item; returns nothing once the queue is closed and empty. */
+  auto pop() -> std::optional<T>
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) { return std::nullopt; }
+    T item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return item;
+  }
+
+  /** Wake up all the waiting threads: `push` fails from now on, `pop` drains the queue. */
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  size_t capacity_;
+  std::deque<T> items_;
+  bool closed_ = false;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+/** The rows [offset, offset + size) of the dataset, processed in `buffer`. */
+struct knn_graph_batch {
+  size_t offset;
+  size_t size;
+  size_t buffer;
+};
+
+struct knn_graph_pipeline_params {
+  size_t n_rows;
+  size_t batch_size;
+  /** Number of batches in flight (at least 2). */
+  size_t n_buffers = 4;
+  /** Number of threads of the refine stage (at least 1). */
+  size_t n_refine_threads = 1;
+};
+
+/** Time spent by one stage: in its callback, and waiting for the previous or the next stage. */
+struct knn_graph_stage_stats {
+  double busy_seconds = 0;
+  double wait_seconds = 0;
+  size_t n_batches    = 0;
+};
+
+struct knn_graph_pipeline_stats {
+  knn_graph_stage_stats produce;
+  knn_graph_stage_stats search;
+  /** Summed over the threads of the stage. */
+  knn_graph_stage_stats refine;
+  knn_graph_stage_stats write;
+  double total_seconds = 0;
+};
+
+/**
+ * The number of rows per batch that fits the memory budgets.
+ *
+ * One batch at a time is searched on the device, while up to `n_buffers` batches are in host
+ * memory. A quarter of the free device memory (the rest is left to the workspace of the search)
+ * and an eighth of the available host memory are used, and the result is clamped to
+ * [kMinBatchSize, kMaxBatchSize] and to the number of rows.
+ */
+inline auto choose_knn_graph_batch_size(size_t n_rows,
+                                        size_t device_bytes_per_row,
+                                        size_t host_bytes_per_row,
+                                        size_t n_buffers,
+                                        size_t free_device_bytes,
+                                        size_t free_host_bytes) -> size_t
+{
+  constexpr size_t kMinBatchSize = 128;
+  constexpr size_t kMaxBatchSize = 65536;
+  size_t batch_size              = kMaxBatchSize;
+  if (device_bytes_per_row > 0) {
+    batch_size = std::min(batch_size, free_device_bytes / 4 / device_bytes_per_row);
+  }
+  if (host_bytes_per_row > 0) {
+    batch_size = std::min(batch_size, free_host_bytes / 8 / (n_buffers * host_bytes_per_row));
+  }
+  // Multiples of 128 rows keep the search kernels busy.
+  batch_size = std::max(kMinBatchSize, batch_size / kMinBatchSize * kMinBatchSize);
+  return std::max<size_t>(1, std::min(batch_size, n_rows));
+}
+
+/**
+ * Run the pipeline over all the rows, in batches of `params.batch_size` rows.
+ *
+ * Each callback takes a `const knn_graph_batch&`, and works in the buffer of the batch:
+ * - `produce` prepares the batch (e.g. gathers its rows), on the producer thread;
+ * - `search` finds the candidate neighbors, on the calling thread, one batch at a time;
+ * - `refine` runs on `params.n_refine_threads` threads, several batches at a time;
+ * - `write` stores the result, on the writer thread, one batch at a time; the buffer is reused
+ *   once it returns.
+ *
+ * Batches are searched in increasing order, but may be refined and written in any order. The first
+ * exception thrown by a callback stops the pipeline, and is rethrown here.
+ */
+template <typename Produce, typename Search, typename Refine, typename Write>
+auto run_knn_graph_pipeline(const knn_graph_pipeline_params& params,
+                            Produce&& produce,
+                            Search&& search,
+                            Refine&& refine,
+                            Write&& write) -> knn_graph_pipeline_stats
+{
+  RAFT_EXPECTS(params.batch_size > 0, "The batch size must be positive");
+  using clock             = std::chrono::steady_clock;
+  const size_t n_buffers  = std::max<size_t>(params.n_buffers, 2);
+  const size_t n_refiners = std::max<size_t>(params.n_refine_threads, 1);
+  const auto start        = clock::now();
+  auto seconds_since      = [](clock::time_point t) {
+    return std::chrono::duration<double>(clock::now() - t).count();
+  };
+
+  bounded_queue<size_t> free_buffers(n_buffers);
+  bounded_queue<knn_graph_batch> to_search(n_buffers);
+  bounded_queue<knn_graph_batch> to_refine(n_buffers);
+  bounded_queue<knn_graph_batch> to_write(n_buffers);
+  for (size_t b = 0; b < n_buffers; b++) {
+    free_buffers.push(b);
+  }
+
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  auto fail = [&](std::exception_ptr e) {
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) { error = e; }
+    }
+    free_buffers.close();
+    to_search.close();
+    to_refine.close();
+    to_write.close();
+  };
+
+  knn_graph_pipeline_stats stats;
+  std::vector<knn_graph_stage_stats> refine_stats(n_refiners);
+
+  // Runs `body` on each item of `in` and forwards it to `out` (or to nothing), timing the stage.
+  auto run_stage = [&](bounded_queue<knn_graph_batch>& in,
+                       bounded_queue<knn_graph_batch>* out,
+                       knn_graph_stage_stats& stage,
+                       auto&& body) {
+    try {
+      while (true) {
+        auto t     = clock::now();
+        auto batch = in.pop();
+        stage.wait_seconds += seconds_since(t);
+        if (!batch.has_value()) { break; }
+        t = clock::now();
+        body(*batch);
+        stage.busy_seconds += seconds_since(t);
+        stage.n_batches++;
+        t = clock::now();
+        if (out != nullptr && !out->push(*batch)) { break; }
+        stage.wait_seconds += seconds_since(t);
+      }
+    } catch (...) {
+      fail(std::current_exception());
+    }
+  };
+
+  std::thread producer([&]() {
+    try {
+      for (size_t offset = 0; offset < params.n_rows; offset += params.batch_size) {
+        auto t      = clock::now();
+        auto buffer = free_buffers.pop();
+        stats.produce.wait_seconds += seconds_since(t);
+        if (!buffer.has_value()) { break; }
+        knn_graph_batch batch{offset, std::min(params.batch_size, params.n_rows - offset), *buffer};
+        t = clock::now();
+        produce(batch);
+        stats.produce.busy_seconds += seconds_since(t);
+        stats.produce.n_batches++;
+        t = clock::now();
+        if (!to_search.push(batch)) { break; }
+        stats.produce.wait_seconds += seconds_since(t);
+      }
+    } catch (...) {
+      fail(std::current_exception());
+    }
+    to_search.close();
+  });
+
+  std::atomic<size_t> n_running_refiners{n_refiners};
+  std::vector<std::thread> refiners;
+  for (size_t r = 0; r < n_refiners; r++) {
+    refiners.emplace_back([&, r]() {
+      run_stage(to_refine, &to_write, refine_stats[r], refine);
+      // The last refiner closes the queue of the writer.
+      if (n_running_refiners.fetch_sub(1) == 1) { to_write.close(); }
+    });
+  }
+
+  std::thread writer([&]() {
+    run_stage(to_write, nullptr, stats.write, [&](const knn_graph_batch& batch) {
+      write(batch);
+      free_buffers.push(batch.buffer);
+    });
+  });
+
+  run_stage(to_search, &to_refine, stats.search, search);
+  to_refine.close();
+
+  producer.join();
+  for (auto& t : refiners) {
+    t.join();
+  }
+  writer.join();
+  if (error) { std::rethrow_exception(error); }
+
+  for (const auto& s : refine_stats) {
+    stats.refine.busy_seconds += s.busy_seconds;
+    stats.refine.wait_seconds += s.wait_seconds;
+    stats.refine.n_batches += s.n_batches;
+  }
+  stats.total_seconds = seconds_since(start);
+  return stats;
+}
+
+}  // namespace cuvs::neighbors::cagra::detail
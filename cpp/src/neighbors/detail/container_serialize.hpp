@@ -0,0 +1,808 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "section_codec.hpp"
+
+#include <raft/core/error.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace cuvs::neighbors::detail {
+
+/*
+ * Sectioned container format shared by the index serializers (all integers in native byte order):
+ *
+ *   container_header   magic, format version, schema version of the index kind, index kind
+ *   sections           each a section_header followed by `size` bytes of payload
+ *   toc section        always the last one: a toc_entry for every section before it
+ *   container_trailer  offset of the toc section and size of the container, magic
+ *
+ * A section is identified by its name and an id (e.g. the label of an IVF list). Its payload is
+ * checksummed (CRC-32C) and length-prefixed, which lets the readers:
+ *
+ *   - skip the sections they do not know, unless a section is marked `kSectionRequired`;
+ *   - ignore the trailing bytes of a known section, so that fields can be appended to it;
+ *   - locate a section through the table of contents without reading the others
+ *     (`read_container_toc`, `read_container_section`).
+ *
+ * A section marked `kSectionEncoded` holds its payload compressed by one of the codecs of
+ * section_codec.hpp, in blocks (see the format there):
+ *
+ *   codec_header   codec, element size
+ *   blocks         each a codec_block_header (raw and encoded sizes) followed by the encoded bytes
+ *
+ * The readers decode it as they read it; the size and the checksum of the section cover the
+ * encoded bytes, and a payload the decoder fails on is reported as a truncated file or a checksum
+ * mismatch when it is one.
+ *
+ * The offsets are relative to the start of the container, so a container can be embedded into
+ * another stream, including the payload of a section of another container.
+ */
+constexpr char kContainerMagic[8]      = {'C', 'U', 'V', 'S', 'I', 'D', 'X', '\0'};
+constexpr uint32_t kContainerVersion   = 1;
+constexpr size_t kContainerNameLen     = 16;
+constexpr uint32_t kSectionRequired    = 1u;
+constexpr uint32_t kSectionEncoded     = 2u;
+constexpr uint32_t kSectionFlags       = kSectionRequired | kSectionEncoded;
+constexpr std::string_view kTocSection = "toc";
+constexpr size_t kContainerPrefixBytes = 4;
+using container_prefix                 = std::array<char, kContainerPrefixBytes>;
+
+struct container_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t schema_version;
+  char kind[kContainerNameLen];
+};
+
+struct section_header {
+  char name[kContainerNameLen];
+  uint64_t id;
+  uint64_t size;
+  uint32_t flags;
+  uint32_t checksum;
+};
+
+struct toc_entry {
+  char name[kContainerNameLen];
+  uint64_t id;
+  /** Offset of the section header from the start of the container. */
+  uint64_t offset;
+  uint64_t size;
+  uint32_t flags;
+  uint32_t checksum;
+};
+
+struct container_trailer {
+  uint64_t toc_offset;
+  uint64_t container_bytes;
+  char magic[8];
+};
+static_assert(std::is_trivially_copyable_v<container_header> && sizeof(container_header) == 32);
+static_assert(std::is_trivially_copyable_v<section_header> && sizeof(section_header) == 40);
+static_assert(std::is_trivially_copyable_v<toc_entry> && sizeof(toc_entry) == 48);
+static_assert(std::is_trivially_copyable_v<container_trailer> && sizeof(container_trailer) == 24);
+
+/** A section as seen by the readers. */
+struct section_info {
+  std::string name;
+  uint64_t id;
+  /** Offset of the section header from the start of the container. */
+  uint64_t offset;
+  uint64_t size;
+  uint32_t flags;
+  uint32_t checksum;
+
+  [[nodiscard]] auto required() const noexcept -> bool { return (flags & kSectionRequired) != 0; }
+  [[nodiscard]] auto encoded() const noexcept -> bool { return (flags & kSectionEncoded) != 0; }
+  [[nodiscard]] auto is(std::string_view n) const noexcept -> bool { return name == n; }
+};
+
+/** CRC-32C (Castagnoli), slicing-by-8. */
+class crc32c {
+ public:
+  void update(const void* data, size_t n) noexcept
+  {
+    static const auto t = make_tables();
+    auto* p             = static_cast<const uint8_t*>(data);
+    uint32_t c          = state_;
+    for (; n >= 8; n -= 8, p += 8) {
+      uint32_t lo;
+      uint32_t hi;
+      std::memcpy(&lo, p, 4);
+      std::memcpy(&hi, p + 4, 4);
+      lo ^= c;
+      c = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+          t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+    }
+    for (; n > 0; n--, p++) {
+      c = t[0][(c ^ *p) & 0xff] ^ (c >> 8);
+    }
+    state_ = c;
+  }
+
+  [[nodiscard]] auto value() const noexcept -> uint32_t { return ~state_; }
+
+ private:
+  using tables_t = std::array<std::array<uint32_t, 256>, 8>;
+
+  static auto make_tables() -> tables_t
+  {
+    tables_t t{};
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? (c >> 1) ^ 0x82f63b78u : c >> 1;
+      }
+      t[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+      for (int k = 1; k < 8; k++) {
+        t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+      }
+    }
+    return t;
+  }
+
+  uint32_t state_ = ~0u;
+};
+
+/** Forwards the payload of a section to `sink`, counting and checksumming it. */
+class section_writebuf : public std::streambuf {
+ public:
+  explicit section_writebuf(std::streambuf* sink) : sink_(sink) {}
+
+  [[nodiscard]] auto size() const noexcept -> uint64_t { return size_; }
+  [[nodiscard]] auto checksum() const noexcept -> uint32_t { return crc_.value(); }
+  [[nodiscard]] auto failed() const noexcept -> bool { return failed_; }
+
+ protected:
+  auto xsputn(const char* s, std::streamsize n) -> std::streamsize override
+  {
+    auto written = sink_->sputn(s, n);
+    if (written != n) { failed_ = true; }
+    crc_.update(s, written);
+    size_ += written;
+    return written;
+  }
+
+  auto overflow(int_type ch) -> int_type override
+  {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) { return traits_type::not_eof(ch); }
+    char c = traits_type::to_char_type(ch);
+    return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+  }
+
+ private:
+  std::streambuf* sink_;
+  crc32c crc_;
+  uint64_t size_ = 0;
+  bool failed_   = false;
+};
+
+/** Reads at most `size` bytes of a section payload from `source`, checksumming them. */
+class section_readbuf : public std::streambuf {
+ public:
+  section_readbuf(std::streambuf* source, uint64_t size) : source_(source), remaining_(size) {}
+
+  /** Consume the rest of the payload and return its checksum. */
+  auto finish() -> uint32_t
+  {
+    while (remaining_ > 0) {
+      if (fill() == 0) { break; }
+    }
+    setg(buf_.data(), buf_.data(), buf_.data());
+    return crc_.value();
+  }
+
+  /** Whether the payload was shorter than announced. */
+  [[nodiscard]] auto truncated() const noexcept -> bool { return truncated_; }
+
+ protected:
+  auto underflow() -> int_type override
+  {
+    if (gptr() < egptr()) { return traits_type::to_int_type(*gptr()); }
+    if (fill() == 0) { return traits_type::eof(); }
+    return traits_type::to_int_type(*gptr());
+  }
+
+  auto xsgetn(char* s, std::streamsize n) -> std::streamsize override
+  {
+    // Serve the buffered bytes first, then read the rest directly (large arrays).
+    std::streamsize done = std::min<std::streamsize>(n, egptr() - gptr());
+    if (done > 0) {
+      std::memcpy(s, gptr(), done);
+      gbump(static_cast<int>(done));
+    }
+    if (done < n && remaining_ > 0) {
+      auto want = static_cast<std::streamsize>(std::min<uint64_t>(n - done, remaining_));
+      auto got  = source_->sgetn(s + done, want);
+      if (got != want) { truncated_ = true; }
+      crc_.update(s + done, got);
+      remaining_ -= got;
+      done += got;
+    }
+    return done;
+  }
+
+ private:
+  auto fill() -> size_t
+  {
+    auto want = static_cast<std::streamsize>(std::min<uint64_t>(buf_.size(), remaining_));
+    auto got  = want > 0 ? source_->sgetn(buf_.data(), want) : 0;
+    if (got != want) {
+      truncated_ = true;
+      remaining_ = 0;
+    } else {
+      remaining_ -= got;
+    }
+    crc_.update(buf_.data(), got);
+    setg(buf_.data(), buf_.data(), buf_.data() + got);
+    return got;
+  }
+
+  std::streambuf* source_;
+  uint64_t remaining_;
+  crc32c crc_;
+  bool truncated_ = false;
+  std::array<char, 4096> buf_;
+};
+
+/** Input stream buffer over a range of memory. */
+class memory_readbuf : public std::streambuf {
+ public:
+  memory_readbuf(const uint8_t* data, size_t size)
+  {
+    auto* p = const_cast<char*>(reinterpret_cast<const char*>(data));
+    setg(p, p, p + size);
+  }
+};
+
+inline void set_container_name(char (&dst)[kContainerNameLen], std::string_view name)
+{
+  RAFT_EXPECTS(name.size() < kContainerNameLen, "Section name too long: %s", name.data());
+  std::memset(dst, 0, kContainerNameLen);
+  std::memcpy(dst, name.data(), name.size());
+}
+
+inline auto get_container_name(const char (&src)[kContainerNameLen]) -> std::string
+{
+  return std::string(src, strnlen(src, kContainerNameLen));
+}
+
+inline void read_container_bytes(std::istream& is, void* dst, size_t n, const char* what)
+{
+  is.read(static_cast<char*>(dst), n);
+  RAFT_EXPECTS(is.gcount() == static_cast<std::streamsize>(n), "Truncated index file (%s)", what);
+}
+
+/**
+ * Read the first bytes of a serialized index. They tell a container (`is_container`) from the
+ * formats that predate it, whose readers take these bytes as the start of their own header.
+ */
+inline auto read_container_prefix(std::istream& is) -> container_prefix
+{
+  container_prefix prefix{};
+  read_container_bytes(is, prefix.data(), prefix.size(), "header");
+  return prefix;
+}
+
+inline auto is_container(const container_prefix& prefix) -> bool
+{
+  return std::memcmp(prefix.data(), kContainerMagic, prefix.size()) == 0;
+}
+
+/**
+ * Writes a container section by section.
+ *
+ * Each section is produced by a callback writing its payload to a `std::ostream`. If the output
+ * stream is seekable, the payload goes straight to it and the section header is patched
+ * afterwards; otherwise (e.g. a container nested into a section of another one), the payload is
+ * staged in memory.
+ */
+class container_writer {
+ public:
+  container_writer(std::ostream& os, std::string_view kind, uint32_t schema_version)
+    : os_(os), begin_(os.tellp())
+  {
+    container_header h{};
+    std::memcpy(h.magic, kContainerMagic, sizeof(h.magic));
+    h.version        = kContainerVersion;
+    h.schema_version = schema_version;
+    set_container_name(h.kind, kind);
+    write_raw(&h, sizeof(h));
+    pos_ = sizeof(h);
+  }
+
+  /**
+   * Write a section.
+   *
+   * @param name section name (less than 16 characters)
+   * @param id distinguishes the sections of the same name
+   * @param flags `kSectionRequired` if a reader that does not know the section cannot load the
+   *   index correctly
+   * @param write_payload callable `void(std::ostream&)`
+   */
+  template <typename WritePayload>
+  void section(std::string_view name, uint64_t id, uint32_t flags, WritePayload&& write_payload)
+  {
+    section(name, id, flags, section_encoding{}, write_payload);
+  }
+
+  /** Write a section, with its payload compressed as given by `encoding`. */
+  template <typename WritePayload>
+  void section(std::string_view name,
+               uint64_t id,
+               uint32_t flags,
+               const section_encoding& encoding,
+               WritePayload&& write_payload)
+  {
+    RAFT_EXPECTS(!finished_, "The container is already finished");
+    RAFT_EXPECTS(name != kTocSection, "The section name '%s' is reserved", kTocSection.data());
+    RAFT_EXPECTS((flags & ~kSectionRequired) == 0, "Invalid section flags %u", flags);
+    section_header h{};
+    set_container_name(h.name, name);
+    h.id    = id;
+    h.flags = encoding.enabled() ? flags | kSectionEncoded : flags;
+
+    auto start = os_.tellp();
+    if (start != std::ostream::pos_type(-1)) {
+      write_raw(&h, sizeof(h));
+      section_writebuf buf(os_.rdbuf());
+      write_section_payload(name, buf, encoding, write_payload);
+      h.size     = buf.size();
+      h.checksum = buf.checksum();
+      auto end   = os_.tellp();
+      os_.seekp(start);
+      write_raw(&h, sizeof(h));
+      os_.seekp(end);
+    } else {
+      std::stringbuf staging(std::ios::out | std::ios::binary);
+      section_writebuf buf(&staging);
+      write_section_payload(name, buf, encoding, write_payload);
+      h.size     = buf.size();
+      h.checksum = buf.checksum();
+      write_raw(&h, sizeof(h));
+      auto payload = staging.str();
+      write_raw(payload.data(), payload.size());
+    }
+    RAFT_EXPECTS(os_.good(), "Error writing section '%s'", h.name);
+
+    add_toc_entry(h);
+  }
+
+  /**
+   * Position in the output stream of the next section, for writing sections to the underlying
+   * file by other means (e.g. in parallel, see `parallel_serialize.hpp`). The output must be
+   * seekable; the stream is flushed.
+   */
+  auto external_offset() -> uint64_t
+  {
+    RAFT_EXPECTS(begin_ != std::ostream::pos_type(-1), "The output stream must be seekable");
+    os_.flush();
+    RAFT_EXPECTS(os_.good(), "Error writing the index");
+    return static_cast<uint64_t>(std::streamoff(begin_)) + pos_;
+  }
+
+  /**
+   * Record the sections written back to back from `external_offset()` by other means, and move
+   * the output stream past them.
+   */
+  void add_external_sections(const std::vector<section_header>& headers)
+  {
+    RAFT_EXPECTS(!finished_, "The container is already finished");
+    for (const auto& h : headers) {
+      add_toc_entry(h);
+    }
+    os_.seekp(begin_ + std::streamoff(pos_));
+    RAFT_EXPECTS(os_.good(), "Error writing the index");
+  }
+
+  /** Write the table of contents and the trailer; no sections can be added after this. */
+  void finish()
+  {
+    RAFT_EXPECTS(!finished_, "The container is already finished");
+    section_header h{};
+    set_container_name(h.name, kTocSection);
+    h.size = toc_.size() * sizeof(toc_entry);
+    crc32c crc;
+    crc.update(toc_.data(), h.size);
+    h.checksum   = crc.value();
+    write_raw(&h, sizeof(h));
+    write_raw(toc_.data(), h.size);
+
+    container_trailer t{};
+    t.toc_offset      = pos_;
+    t.container_bytes = pos_ + sizeof(h) + h.size + sizeof(t);
+    std::memcpy(t.magic, kContainerMagic, sizeof(t.magic));
+    write_raw(&t, sizeof(t));
+    pos_      = t.container_bytes;
+    finished_ = true;
+  }
+
+ private:
+  template <typename WritePayload>
+  static void write_section_payload(std::string_view name,
+                                    section_writebuf& buf,
+                                    const section_encoding& encoding,
+                                    WritePayload& write_payload)
+  {
+    bool good = false;
+    if (encoding.enabled()) {
+      encoding_writebuf encoder(&buf, encoding);
+      std::ostream payload(&encoder);
+      write_payload(payload);
+      encoder.finish();
+      good = payload.good() && !encoder.failed();
+    } else {
+      std::ostream payload(&buf);
+      write_payload(payload);
+      good = payload.good();
+    }
+    RAFT_EXPECTS(good && !buf.failed(), "Error writing section '%s'", std::string(name).c_str());
+  }
+
+  /** Add a section, starting at the current end of the container, to the table of contents. */
+  void add_toc_entry(const section_header& h)
+  {
+    toc_entry e{};
+    std::memcpy(e.name, h.name, sizeof(e.name));
+    e.id       = h.id;
+    e.offset   = pos_;
+    e.size     = h.size;
+    e.flags    = h.flags;
+    e.checksum = h.checksum;
+    toc_.push_back(e);
+    pos_ += sizeof(h) + h.size;
+  }
+
+  void write_raw(const void* data, size_t n)
+  {
+    os_.write(static_cast<const char*>(data), n);
+    RAFT_EXPECTS(os_.good(), "Error writing the index");
+  }
+
+  std::ostream& os_;
+  /** Position of the container in the output stream; -1 if the stream cannot seek. */
+  std::ostream::pos_type begin_;
+  uint64_t pos_ = 0;
+  std::vector<toc_entry> toc_;
+  bool finished_ = false;
+};
+
+namespace container_detail {
+
+inline void check_container_header(const container_header& h,
+                                   std::string_view kind,
+                                   uint32_t max_schema_version)
+{
+  RAFT_EXPECTS(std::memcmp(h.magic, kContainerMagic, sizeof(h.magic)) == 0,
+               "Not a cuVS index container");
+  RAFT_EXPECTS(h.version <= kContainerVersion,
+               "Unsupported container version %u (this build reads up to %u)",
+               h.version,
+               kContainerVersion);
+  auto stored_kind = get_container_name(h.kind);
+  RAFT_EXPECTS(stored_kind == kind,
+               "The container holds a '%s' index, expected '%s'",
+               stored_kind.c_str(),
+               std::string(kind).c_str());
+  RAFT_EXPECTS(h.schema_version <= max_schema_version,
+               "Unsupported %s schema version %u (this build reads up to %u)",
+               stored_kind.c_str(),
+               h.schema_version,
+               max_schema_version);
+}
+
+inline auto to_section_info(const section_header& h, uint64_t offset) -> section_info
+{
+  return section_info{get_container_name(h.name), h.id, offset, h.size, h.flags, h.checksum};
+}
+
+/** Run `read_payload(payload_stream)` on the payload of a section and verify the checksum. */
+template <typename ReadPayload>
+auto read_section_payload(std::istream& is, const section_info& info, ReadPayload&& read_payload)
+  -> bool
+{
+  RAFT_EXPECTS((info.flags & ~kSectionFlags) == 0,
+               "Unsupported flags %u of section '%s' (the index was written by a newer version)",
+               info.flags,
+               info.name.c_str());
+  section_readbuf buf(is.rdbuf(), info.size);
+  bool handled = false;
+  bool failed  = false;
+  if (info.encoded()) {
+    // The payload is decoded as it is read; the errors of the decoder make the stream throw.
+    try {
+      decoding_readbuf decoded(&buf, info.size);
+      std::istream payload(&decoded);
+      payload.exceptions(std::ios::badbit);
+      handled = read_payload(payload);
+      failed  = payload.fail();
+    } catch (...) {
+      // A corrupted payload is reported as such rather than as a decoding error.
+      auto checksum = buf.finish();
+      RAFT_EXPECTS(!buf.truncated(),
+                   "Truncated index file (section '%s', id %lu)",
+                   info.name.c_str(),
+                   static_cast<unsigned long>(info.id));
+      RAFT_EXPECTS(checksum == info.checksum,
+                   "Checksum mismatch in section '%s' (id %lu)",
+                   info.name.c_str(),
+                   static_cast<unsigned long>(info.id));
+      throw;
+    }
+  } else {
+    std::istream payload(&buf);
+    handled = read_payload(payload);
+    failed  = payload.fail();
+  }
+  RAFT_EXPECTS(!handled || !failed,
+               "Error reading section '%s' (id %lu): the payload is shorter than expected",
+               info.name.c_str(),
+               static_cast<unsigned long>(info.id));
+  auto checksum = buf.finish();
+  RAFT_EXPECTS(!buf.truncated(),
+               "Truncated index file (section '%s', id %lu)",
+               info.name.c_str(),
+               static_cast<unsigned long>(info.id));
+  RAFT_EXPECTS(checksum == info.checksum,
+               "Checksum mismatch in section '%s' (id %lu)",
+               info.name.c_str(),
+               static_cast<unsigned long>(info.id));
+  return handled;
+}
+
+/** Fail if a section the reader does not know is required. */
+inline void check_section_handled(const section_info& info, bool handled)
+{
+  RAFT_EXPECTS(handled || !info.required(),
+               "Unsupported required section '%s' (the index was written by a newer version)",
+               info.name.c_str());
+}
+
+/** Check the header of a section located through the table of contents. */
+inline void check_section_header(const section_header& h, const section_info& info)
+{
+  RAFT_EXPECTS(get_container_name(h.name) == info.name && h.id == info.id &&
+                 h.size == info.size && h.checksum == info.checksum,
+               "The table of contents does not match section '%s' (id %lu)",
+               info.name.c_str(),
+               static_cast<unsigned long>(info.id));
+}
+
+}  // namespace container_detail
+
+/**
+ * Reads a container sequentially.
+ *
+ * The caller reads the prefix first (`read_container_prefix`) to tell a container from an older
+ * format.
+ */
+class container_reader {
+ public:
+  container_reader(std::istream& is,
+                   const container_prefix& prefix,
+                   std::string_view kind,
+                   uint32_t max_schema_version)
+    : is_(is)
+  {
+    container_header h{};
+    std::memcpy(&h, prefix.data(), prefix.size());
+    read_container_bytes(is_,
+                         reinterpret_cast<char*>(&h) + prefix.size(),
+                         sizeof(h) - prefix.size(),
+                         "container header");
+    container_detail::check_container_header(h, kind, max_schema_version);
+    schema_version_ = h.schema_version;
+    pos_            = sizeof(h);
+  }
+
+  [[nodiscard]] auto schema_version() const noexcept -> uint32_t { return schema_version_; }
+
+  /**
+   * Visit all sections in the order they were written, up to the end of the container.
+   *
+   * `visit(const section_info&, std::istream& payload) -> bool` returns whether it knows the
+   * section; the unknown ones are skipped unless they are required. A visitor does not need to
+   * read the payload to the end. The checksum of every section is verified after the visit.
+   */
+  template <typename Visitor>
+  void read_sections(Visitor&& visit)
+  {
+    while (read_next_section(visit)) {}
+  }
+
+  /**
+   * Visit the next section only (see `read_sections`), e.g. to inspect the parameters of an index
+   * without loading it.
+   *
+   * @return false if the end of the container was reached instead
+   */
+  template <typename Visitor>
+  auto read_next_section(Visitor&& visit) -> bool
+  {
+    if (finished_) { return false; }
+    section_header h{};
+    read_container_bytes(is_, &h, sizeof(h), "section header");
+    auto info = container_detail::to_section_info(h, pos_);
+    pos_ += sizeof(h) + h.size;
+    if (info.is(kTocSection)) {
+      container_detail::read_section_payload(is_, info, [](std::istream&) { return true; });
+      container_trailer t{};
+      read_container_bytes(is_, &t, sizeof(t), "container trailer");
+      RAFT_EXPECTS(std::memcmp(t.magic, kContainerMagic, sizeof(t.magic)) == 0 &&
+                     t.container_bytes == pos_ + sizeof(t),
+                   "Corrupted container trailer");
+      finished_ = true;
+      return false;
+    }
+    bool handled = container_detail::read_section_payload(
+      is_, info, [&](std::istream& payload) -> bool { return visit(info, payload); });
+    container_detail::check_section_handled(info, handled);
+    if (handled) { sections_.push_back(std::move(info)); }
+    return true;
+  }
+
+  /** Number of sections of the given name read by `read_sections`. */
+  [[nodiscard]] auto count_sections(std::string_view name) const -> size_t
+  {
+    return std::count_if(
+      sections_.begin(), sections_.end(), [&](const section_info& s) { return s.is(name); });
+  }
+
+  /** Fail unless `read_sections` has read all the given sections. */
+  void require_sections(std::string_view kind,
+                        std::initializer_list<std::string_view> names) const
+  {
+    for (auto name : names) {
+      RAFT_EXPECTS(count_sections(name) > 0,
+                   "The %s index misses the section '%s'",
+                   std::string(kind).c_str(),
+                   std::string(name).c_str());
+    }
+  }
+
+ private:
+  std::istream& is_;
+  uint32_t schema_version_ = 0;
+  uint64_t pos_            = 0;
+  bool finished_           = false;
+  std::vector<section_info> sections_;
+};
+
+/** The table of contents of a container, for random access to its sections. */
+struct container_toc {
+  /** Position of the container in the stream. */
+  std::istream::pos_type begin;
+  uint32_t schema_version;
+  std::vector<section_info> sections;
+
+  /** Find a section by name and id; nullptr if there is none. */
+  [[nodiscard]] auto find(std::string_view name, uint64_t id = 0) const -> const section_info*
+  {
+    auto it = std::find_if(sections.begin(), sections.end(), [&](const section_info& s) {
+      return s.id == id && s.is(name);
+    });
+    return it == sections.end() ? nullptr : &*it;
+  }
+};
+
+/**
+ * Read the table of contents of the container that ends at the end of a seekable stream.
+ *
+ * Only the header, the trailer and the toc are read.
+ */
+inline auto read_container_toc(std::istream& is, std::string_view kind, uint32_t max_schema_version)
+  -> container_toc
+{
+  is.seekg(0, std::ios::end);
+  auto end = is.tellg();
+  RAFT_EXPECTS(end != std::istream::pos_type(-1) &&
+                 uint64_t(end) >= sizeof(container_header) + sizeof(container_trailer),
+               "Not a cuVS index container");
+  container_trailer t{};
+  is.seekg(end - std::streamoff(sizeof(t)));
+  read_container_bytes(is, &t, sizeof(t), "container trailer");
+  RAFT_EXPECTS(std::memcmp(t.magic, kContainerMagic, sizeof(t.magic)) == 0 &&
+                 t.container_bytes <= uint64_t(end) && t.toc_offset < t.container_bytes,
+               "Not a cuVS index container, or its trailer is corrupted");
+
+  container_toc toc;
+  toc.begin = end - std::streamoff(t.container_bytes);
+  is.seekg(toc.begin);
+  container_header h{};
+  read_container_bytes(is, &h, sizeof(h), "container header");
+  container_detail::check_container_header(h, kind, max_schema_version);
+  toc.schema_version = h.schema_version;
+
+  is.seekg(toc.begin + std::streamoff(t.toc_offset));
+  section_header sh{};
+  read_container_bytes(is, &sh, sizeof(sh), "section header");
+  auto info = container_detail::to_section_info(sh, t.toc_offset);
+  RAFT_EXPECTS(info.is(kTocSection) && info.size % sizeof(toc_entry) == 0,
+               "Corrupted container table of contents");
+  std::vector<toc_entry> entries(info.size / sizeof(toc_entry));
+  container_detail::read_section_payload(is, info, [&](std::istream& payload) {
+    payload.read(reinterpret_cast<char*>(entries.data()), info.size);
+    return true;
+  });
+  toc.sections.reserve(entries.size());
+  for (const auto& e : entries) {
+    toc.sections.push_back(
+      section_info{get_container_name(e.name), e.id, e.offset, e.size, e.flags, e.checksum});
+  }
+  return toc;
+}
+
+/**
+ * Read one section located through the table of contents.
+ *
+ * @param read_payload callable `void(std::istream& payload)`
+ */
+template <typename ReadPayload>
+void read_container_section(std::istream& is,
+                            const container_toc& toc,
+                            const section_info& info,
+                            ReadPayload&& read_payload)
+{
+  is.seekg(toc.begin + std::streamoff(info.offset));
+  section_header h{};
+  read_container_bytes(is, &h, sizeof(h), "section header");
+  container_detail::check_section_header(h, info);
+  container_detail::read_section_payload(is, info, [&](std::istream& payload) {
+    read_payload(payload);
+    return true;
+  });
+}
+
+/**
+ * Read the data type string of a serialized index of the given kind, e.g. to pick the type to
+ * load it as. Such indexes open with their dtype string: at the start of the "params" section of
+ * a container, or as the prefix of the formats that predate it.
+ *
+ * Only the beginning of the index is read.
+ */
+inline auto read_index_dtype(std::istream& is, std::string_view kind) -> std::string
+{
+  auto prefix = read_container_prefix(is);
+  std::string dtype_string(prefix.data(), prefix.size());
+  if (is_container(prefix)) {
+    container_reader reader(is, prefix, kind, std::numeric_limits<uint32_t>::max());
+    reader.read_next_section([&](const section_info& s, std::istream& payload) {
+      RAFT_EXPECTS(s.is("params"), "Unexpected first section '%s' of the index", s.name.c_str());
+      read_container_bytes(payload, dtype_string.data(), dtype_string.size(), "dtype");
+      return true;
+    });
+  }
+  return dtype_string;
+}
+
+}  // namespace cuvs::neighbors::detail
@@ -23,10 +23,15 @@
 
 #include <raft/core/logger-ext.hpp>
 
+#include "container_serialize.hpp"
+
 #include <cuda_fp16.h>
 
+#include <cstring>
 #include <fstream>
 #include <memory>
+#include <optional>
+#include <string_view>
 
 namespace cuvs::neighbors::detail {
 
@@ -35,23 +40,39 @@ constexpr dataset_instance_tag kSerializeEmptyDataset   = 1;
 constexpr dataset_instance_tag kSerializeStridedDataset = 2;
 constexpr dataset_instance_tag kSerializeVPQDataset     = 3;
 
+/*
+ * Version 1 of the dataset container holds the sections
+ *
+ *   "type"    the dataset instance tag and, unless the dataset is empty, its data type
+ *   "shape"   the extents of the dataset
+ *   "data"    the rows (for a VPQ dataset, preceded by "vq_code_book" and "pq_code_book")
+ *
+ * Datasets serialized before the container were a bare instance tag followed by the same fields.
+ */
+constexpr uint32_t kDatasetSchemaVersion         = 1;
+constexpr std::string_view kDatasetContainerKind = "dataset";
+
 template <typename IdxT>
-void serialize(const raft::resources& res, std::ostream& os, const empty_dataset<IdxT>& dataset)
+void serialize(const raft::resources& res, container_writer& w, const empty_dataset<IdxT>& dataset)
 {
-  raft::serialize_scalar(res, os, dataset.suggested_dim);
+  w.section("shape", 0, kSectionRequired, [&](std::ostream& os) {
+    raft::serialize_scalar(res, os, dataset.suggested_dim);
+  });
 }
 
 template <typename DataT, typename IdxT>
 void serialize(const raft::resources& res,
-               std::ostream& os,
+               container_writer& w,
                const strided_dataset<DataT, IdxT>& dataset)
 {
   auto n_rows = dataset.n_rows();
   auto dim    = dataset.dim();
   auto stride = dataset.stride();
-  raft::serialize_scalar(res, os, n_rows);
-  raft::serialize_scalar(res, os, dim);
-  raft::serialize_scalar(res, os, stride);
+  w.section("shape", 0, kSectionRequired, [&](std::ostream& os) {
+    raft::serialize_scalar(res, os, n_rows);
+    raft::serialize_scalar(res, os, dim);
+    raft::serialize_scalar(res, os, stride);
+  });
   // Remove padding before saving the dataset
   auto src = dataset.view();
   auto dst = raft::make_host_matrix<DataT, IdxT>(n_rows, dim);
@@ -64,61 +85,74 @@ void serialize(const raft::resources& res,
                                   cudaMemcpyDefault,
                                   raft::resource::get_cuda_stream(res)));
   raft::resource::sync_stream(res);
-  raft::serialize_mdspan(res, os, dst.view());
+  w.section("data", 0, kSectionRequired, [&](std::ostream& os) {
+    raft::serialize_mdspan(res, os, dst.view());
+  });
 }
 
 template <typename MathT, typename IdxT>
 void serialize(const raft::resources& res,
-               std::ostream& os,
+               container_writer& w,
                const vpq_dataset<MathT, IdxT>& dataset)
 {
-  raft::serialize_scalar(res, os, dataset.n_rows());
-  raft::serialize_scalar(res, os, dataset.dim());
-  raft::serialize_scalar(res, os, dataset.vq_n_centers());
-  raft::serialize_scalar(res, os, dataset.pq_n_centers());
-  raft::serialize_scalar(res, os, dataset.pq_len());
-  raft::serialize_scalar(res, os, dataset.encoded_row_length());
-  raft::serialize_mdspan(res, os, make_const_mdspan(dataset.vq_code_book.view()));
-  raft::serialize_mdspan(res, os, make_const_mdspan(dataset.pq_code_book.view()));
-  raft::serialize_mdspan(res, os, make_const_mdspan(dataset.data.view()));
+  w.section("shape", 0, kSectionRequired, [&](std::ostream& os) {
+    raft::serialize_scalar(res, os, dataset.n_rows());
+    raft::serialize_scalar(res, os, dataset.dim());
+    raft::serialize_scalar(res, os, dataset.vq_n_centers());
+    raft::serialize_scalar(res, os, dataset.pq_n_centers());
+    raft::serialize_scalar(res, os, dataset.pq_len());
+    raft::serialize_scalar(res, os, dataset.encoded_row_length());
+  });
+  w.section("vq_code_book", 0, kSectionRequired, [&](std::ostream& os) {
+    raft::serialize_mdspan(res, os, make_const_mdspan(dataset.vq_code_book.view()));
+  });
+  w.section("pq_code_book", 0, kSectionRequired, [&](std::ostream& os) {
+    raft::serialize_mdspan(res, os, make_const_mdspan(dataset.pq_code_book.view()));
+  });
+  w.section("data", 0, kSectionRequired, [&](std::ostream& os) {
+    raft::serialize_mdspan(res, os, make_const_mdspan(dataset.data.view()));
+  });
+}
+
+template <typename DatasetT>
+void serialize_typed(const raft::resources& res,
+                     std::ostream& os,
+                     dataset_instance_tag tag,
+                     cudaDataType_t dtype,
+                     const DatasetT& dataset)
+{
+  container_writer w(os, kDatasetContainerKind, kDatasetSchemaVersion);
+  w.section("type", 0, kSectionRequired, [&](std::ostream& payload) {
+    raft::serialize_scalar(res, payload, tag);
+    if (tag != kSerializeEmptyDataset) { raft::serialize_scalar(res, payload, dtype); }
+  });
+  serialize(res, w, dataset);
+  w.finish();
 }
 
 template <typename IdxT>
 void serialize(const raft::resources& res, std::ostream& os, const dataset<IdxT>& dataset)
 {
   if (auto x = dynamic_cast<const empty_dataset<IdxT>*>(&dataset); x != nullptr) {
-    raft::serialize_scalar(res, os, kSerializeEmptyDataset);
-    return serialize(res, os, *x);
+    return serialize_typed(res, os, kSerializeEmptyDataset, CUDA_R_32F, *x);
   }
   if (auto x = dynamic_cast<const strided_dataset<float, IdxT>*>(&dataset); x != nullptr) {
-    raft::serialize_scalar(res, os, kSerializeStridedDataset);
-    raft::serialize_scalar(res, os, CUDA_R_32F);
-    return serialize(res, os, *x);
+    return serialize_typed(res, os, kSerializeStridedDataset, CUDA_R_32F, *x);
   }
   if (auto x = dynamic_cast<const strided_dataset<half, IdxT>*>(&dataset); x != nullptr) {
-    raft::serialize_scalar(res, os, kSerializeStridedDataset);
-    raft::serialize_scalar(res, os, CUDA_R_16F);
-    return serialize(res, os, *x);
+    return serialize_typed(res, os, kSerializeStridedDataset, CUDA_R_16F, *x);
   }
   if (auto x = dynamic_cast<const strided_dataset<int8_t, IdxT>*>(&dataset); x != nullptr) {
-    raft::serialize_scalar(res, os, kSerializeStridedDataset);
-    raft::serialize_scalar(res, os, CUDA_R_8I);
-    return serialize(res, os, *x);
+    return serialize_typed(res, os, kSerializeStridedDataset, CUDA_R_8I, *x);
   }
   if (auto x = dynamic_cast<const strided_dataset<uint8_t, IdxT>*>(&dataset); x != nullptr) {
-    raft::serialize_scalar(res, os, kSerializeStridedDataset);
-    raft::serialize_scalar(res, os, CUDA_R_8U);
-    return serialize(res, os, *x);
+    return serialize_typed(res, os, kSerializeStridedDataset, CUDA_R_8U, *x);
   }
   if (auto x = dynamic_cast<const vpq_dataset<float, IdxT>*>(&dataset); x != nullptr) {
-    raft::serialize_scalar(res, os, kSerializeVPQDataset);
-    raft::serialize_scalar(res, os, CUDA_R_32F);
-    return serialize(res, os, *x);
+    return serialize_typed(res, os, kSerializeVPQDataset, CUDA_R_32F, *x);
   }
   if (auto x = dynamic_cast<const vpq_dataset<half, IdxT>*>(&dataset); x != nullptr) {
-    raft::serialize_scalar(res, os, kSerializeVPQDataset);
-    raft::serialize_scalar(res, os, CUDA_R_16F);
-    return serialize(res, os, *x);
+    return serialize_typed(res, os, kSerializeVPQDataset, CUDA_R_16F, *x);
   }
   RAFT_FAIL("unsupported dataset type.");
 }
@@ -131,6 +165,20 @@ auto deserialize_empty(raft::resources const& res, std::istream& is)
   return std::make_unique<empty_dataset<IdxT>>(suggested_dim);
 }
 
+template <typename IdxT>
+auto deserialize_empty(raft::resources const& res, container_reader& reader)
+  -> std::unique_ptr<empty_dataset<IdxT>>
+{
+  std::unique_ptr<empty_dataset<IdxT>> out;
+  reader.read_sections([&](const section_info& s, std::istream& payload) {
+    if (!s.is("shape")) { return false; }
+    out = deserialize_empty<IdxT>(res, payload);
+    return true;
+  });
+  reader.require_sections(kDatasetContainerKind, {"shape"});
+  return out;
+}
+
 template <typename DataT, typename IdxT>
 auto deserialize_strided(raft::resources const& res, std::istream& is)
   -> std::unique_ptr<strided_dataset<DataT, IdxT>>
@@ -143,6 +191,32 @@ auto deserialize_strided(raft::resources const& res, std::istream& is)
   return make_strided_dataset(res, host_array, stride);
 }
 
+template <typename DataT, typename IdxT>
+auto deserialize_strided(raft::resources const& res, container_reader& reader)
+  -> std::unique_ptr<strided_dataset<DataT, IdxT>>
+{
+  IdxT n_rows     = 0;
+  uint32_t dim    = 0;
+  uint32_t stride = 0;
+  std::optional<raft::host_matrix<DataT, IdxT>> host_array;
+  reader.read_sections([&](const section_info& s, std::istream& payload) {
+    if (s.is("shape")) {
+      n_rows = raft::deserialize_scalar<IdxT>(res, payload);
+      dim    = raft::deserialize_scalar<uint32_t>(res, payload);
+      stride = raft::deserialize_scalar<uint32_t>(res, payload);
+      return true;
+    }
+    if (s.is("data")) {
+      host_array.emplace(raft::make_host_matrix<DataT, IdxT>(n_rows, dim));
+      raft::deserialize_mdspan(res, payload, host_array->view());
+      return true;
+    }
+    return false;
+  });
+  reader.require_sections(kDatasetContainerKind, {"shape", "data"});
+  return make_strided_dataset(res, *host_array, stride);
+}
+
 template <typename MathT, typename IdxT>
 auto deserialize_vpq(raft::resources const& res, std::istream& is)
   -> std::unique_ptr<vpq_dataset<MathT, IdxT>>
@@ -169,29 +243,112 @@ auto deserialize_vpq(raft::resources const& res, std::istream& is)
     std::move(vq_code_book), std::move(pq_code_book), std::move(data));
 }
 
-template <typename IdxT>
-auto deserialize_dataset(raft::resources const& res, std::istream& is)
-  -> std::unique_ptr<dataset<IdxT>>
+template <typename MathT, typename IdxT>
+auto deserialize_vpq(raft::resources const& res, container_reader& reader)
+  -> std::unique_ptr<vpq_dataset<MathT, IdxT>>
+{
+  IdxT n_rows                 = 0;
+  uint32_t dim                = 0;
+  uint32_t vq_n_centers       = 0;
+  uint32_t pq_n_centers       = 0;
+  uint32_t pq_len             = 0;
+  uint32_t encoded_row_length = 0;
+  std::optional<raft::device_matrix<MathT, uint32_t, raft::row_major>> vq_code_book;
+  std::optional<raft::device_matrix<MathT, uint32_t, raft::row_major>> pq_code_book;
+  std::optional<raft::device_matrix<uint8_t, IdxT, raft::row_major>> data;
+  reader.read_sections([&](const section_info& s, std::istream& payload) {
+    if (s.is("shape")) {
+      n_rows             = raft::deserialize_scalar<IdxT>(res, payload);
+      dim                = raft::deserialize_scalar<uint32_t>(res, payload);
+      vq_n_centers       = raft::deserialize_scalar<uint32_t>(res, payload);
+      pq_n_centers       = raft::deserialize_scalar<uint32_t>(res, payload);
+      pq_len             = raft::deserialize_scalar<uint32_t>(res, payload);
+      encoded_row_length = raft::deserialize_scalar<uint32_t>(res, payload);
+      return true;
+    }
+    if (s.is("vq_code_book")) {
+      vq_code_book.emplace(
+        raft::make_device_matrix<MathT, uint32_t, raft::row_major>(res, vq_n_centers, dim));
+      raft::deserialize_mdspan(res, payload, vq_code_book->view());
+      return true;
+    }
+    if (s.is("pq_code_book")) {
+      pq_code_book.emplace(
+        raft::make_device_matrix<MathT, uint32_t, raft::row_major>(res, pq_n_centers, pq_len));
+      raft::deserialize_mdspan(res, payload, pq_code_book->view());
+      return true;
+    }
+    if (s.is("data")) {
+      data.emplace(
+        raft::make_device_matrix<uint8_t, IdxT, raft::row_major>(res, n_rows, encoded_row_length));
+      raft::deserialize_mdspan(res, payload, data->view());
+      return true;
+    }
+    return false;
+  });
+  reader.require_sections(kDatasetContainerKind, {"shape", "vq_code_book", "pq_code_book", "data"});
+  return std::make_unique<vpq_dataset<MathT, IdxT>>(
+    std::move(*vq_code_book), std::move(*pq_code_book), std::move(*data));
+}
+
+/** Dispatch on the instance tag and the data type; `src` is either a stream or a reader. */
+template <typename IdxT, typename Source>
+auto deserialize_dataset(raft::resources const& res,
+                         Source& src,
+                         dataset_instance_tag tag,
+                         cudaDataType_t dtype) -> std::unique_ptr<dataset<IdxT>>
 {
-  switch (raft::deserialize_scalar<dataset_instance_tag>(res, is)) {
-    case kSerializeEmptyDataset: return deserialize_empty<IdxT>(res, is);
+  switch (tag) {
+    case kSerializeEmptyDataset: return deserialize_empty<IdxT>(res, src);
     case kSerializeStridedDataset:
-      switch (raft::deserialize_scalar<cudaDataType_t>(res, is)) {
-        case CUDA_R_32F: return deserialize_strided<float, IdxT>(res, is);
-        case CUDA_R_16F: return deserialize_strided<half, IdxT>(res, is);
-        case CUDA_R_8I: return deserialize_strided<int8_t, IdxT>(res, is);
-        case CUDA_R_8U: return deserialize_strided<uint8_t, IdxT>(res, is);
+      switch (dtype) {
+        case CUDA_R_32F: return deserialize_strided<float, IdxT>(res, src);
+        case CUDA_R_16F: return deserialize_strided<half, IdxT>(res, src);
+        case CUDA_R_8I: return deserialize_strided<int8_t, IdxT>(res, src);
+        case CUDA_R_8U: return deserialize_strided<uint8_t, IdxT>(res, src);
         default: break;
       }
+      break;
     case kSerializeVPQDataset:
-      switch (raft::deserialize_scalar<cudaDataType_t>(res, is)) {
-        case CUDA_R_32F: return deserialize_vpq<float, IdxT>(res, is);
-        case CUDA_R_16F: return deserialize_vpq<half, IdxT>(res, is);
+      switch (dtype) {
+        case CUDA_R_32F: return deserialize_vpq<float, IdxT>(res, src);
+        case CUDA_R_16F: return deserialize_vpq<half, IdxT>(res, src);
         default: break;
       }
+      break;
     default: break;
   }
   RAFT_FAIL("Failed to deserialize dataset: unsupported combination of instance tags.");
 }
 
+template <typename IdxT>
+auto deserialize_dataset(raft::resources const& res, std::istream& is)
+  -> std::unique_ptr<dataset<IdxT>>
+{
+  auto prefix = read_container_prefix(is);
+  if (!is_container(prefix)) {
+    // A dataset serialized before the container: the prefix is its instance tag.
+    dataset_instance_tag tag;
+    static_assert(sizeof(tag) == kContainerPrefixBytes);
+    std::memcpy(&tag, prefix.data(), sizeof(tag));
+    auto dtype = tag == kSerializeEmptyDataset ? CUDA_R_32F
+                                               : raft::deserialize_scalar<cudaDataType_t>(res, is);
+    return deserialize_dataset<IdxT>(res, is, tag, dtype);
+  }
+
+  container_reader reader(is, prefix, kDatasetContainerKind, kDatasetSchemaVersion);
+  dataset_instance_tag tag = 0;
+  cudaDataType_t dtype     = CUDA_R_32F;
+  auto has_type = reader.read_next_section([&](const section_info& s, std::istream& payload) {
+    RAFT_EXPECTS(s.is("type"), "The dataset container must start with the section 'type'");
+    tag = raft::deserialize_scalar<dataset_instance_tag>(res, payload);
+    if (tag != kSerializeEmptyDataset) {
+      dtype = raft::deserialize_scalar<cudaDataType_t>(res, payload);
+    }
+    return true;
+  });
+  RAFT_EXPECTS(has_type, "The dataset container is empty");
+  return deserialize_dataset<IdxT>(res, reader, tag, dtype);
+}
+
 }  // namespace cuvs::neighbors::detail
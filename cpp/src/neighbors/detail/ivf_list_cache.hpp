@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../../core/mmap.hpp"
+#include "container_serialize.hpp"
+#include "parallel_serialize.hpp"
+
+#include <cuvs/neighbors/common.hpp>
+
+#include <raft/core/error.hpp>
+
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cuvs::neighbors::detail {
+
+/**
+ * Loads the lists of a host IVF index on demand from the mapped container file.
+ *
+ * A list is decoded from its section, with the checksum verified, when first requested, and then
+ * kept in memory until the lists loaded since take more than `max_resident_bytes`; the least
+ * recently requested lists are dropped first. A list is charged the memory of its decoded content,
+ * as reported by the decoder, whatever the encoding of its section. Concurrent requests are served
+ * concurrently: the lists are decoded outside of the lock, a list requested by two threads at once
+ * may then be decoded twice.
+ *
+ * The pages of the file backing a decoded list are released right away, so that the memory of the
+ * file mapping stays bounded as well.
+ *
+ * @tparam ListT the content of a list in host memory
+ */
+template <typename ListT>
+class mapped_list_cache : public ivf::host_list_loader<ListT> {
+ public:
+  /**
+   * Callable decoding the payload of a list section; returns the list (null for an empty list)
+   * and the memory of its content in bytes.
+   */
+  using decode_type =
+    std::function<std::pair<std::shared_ptr<const ListT>, size_t>(uint32_t, std::istream&)>;
+
+  /**
+   * @param filename the container file
+   * @param toc the table of contents of the file
+   * @param name the name of the list sections
+   * @param n_lists the number of lists; there must be a section for every list
+   * @param max_resident_bytes the memory cap of the lists kept in memory
+   * @param decode see `decode_type`
+   */
+  mapped_list_cache(const std::string& filename,
+                    const container_toc& toc,
+                    std::string_view name,
+                    uint32_t n_lists,
+                    size_t max_resident_bytes,
+                    decode_type decode)
+    : file_(filename),
+      begin_(static_cast<uint64_t>(std::streamoff(toc.begin))),
+      sections_(n_lists),
+      max_resident_bytes_(max_resident_bytes),
+      decode_(std::move(decode))
+  {
+    for (uint32_t label = 0; label < n_lists; label++) {
+      auto* s = toc.find(name, label);
+      RAFT_EXPECTS(s != nullptr,
+                   "The index misses the section '%s' (id %u)",
+                   std::string(name).c_str(),
+                   label);
+      RAFT_EXPECTS(begin_ + s->offset + sizeof(section_header) + s->size <= file_.size(),
+                   "Truncated index file (section '%s', id %u)",
+                   s->name.c_str(),
+                   label);
+      sections_[label] = *s;
+    }
+  }
+
+  auto get(uint32_t label) -> std::shared_ptr<const ListT> override
+  {
+    RAFT_EXPECTS(label < sections_.size(), "List label %u is out of range", label);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (auto it = entries_.find(label); it != entries_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.position);
+        return it->second.list;
+      }
+    }
+    auto [list, bytes] = load(label);
+    if (!list) { return list; }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = entries_.find(label); it != entries_.end()) { return it->second.list; }
+    lru_.push_front(label);
+    entries_.emplace(label, entry{list, bytes, lru_.begin()});
+    resident_bytes_ += bytes;
+    // The list just loaded stays, even if it alone exceeds the cap.
+    while (resident_bytes_ > max_resident_bytes_ && lru_.size() > 1) {
+      auto it = entries_.find(lru_.back());
+      resident_bytes_ -= it->second.bytes;
+      entries_.erase(it);
+      lru_.pop_back();
+    }
+    return list;
+  }
+
+  [[nodiscard]] auto resident_bytes() const -> size_t override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resident_bytes_;
+  }
+
+ private:
+  struct entry {
+    std::shared_ptr<const ListT> list;
+    size_t bytes;
+    std::list<uint32_t>::iterator position;
+  };
+
+  core::detail::mapped_file file_;
+  uint64_t begin_;
+  std::vector<section_info> sections_;
+  size_t max_resident_bytes_;
+  decode_type decode_;
+
+  mutable std::mutex mutex_;
+  std::list<uint32_t> lru_;
+  std::unordered_map<uint32_t, entry> entries_;
+  size_t resident_bytes_ = 0;
+
+  auto load(uint32_t label) const -> std::pair<std::shared_ptr<const ListT>, size_t>
+  {
+    const auto& s     = sections_[label];
+    const auto offset = begin_ + s.offset;
+    const auto bytes  = sizeof(section_header) + s.size;
+    section_header h{};
+    std::memcpy(&h, file_.data() + offset, sizeof(h));
+    container_detail::check_section_header(h, s);
+    file_.advise(offset, bytes, MADV_WILLNEED);
+    memory_readbuf buf(file_.data() + offset + sizeof(h), s.size);
+    std::istream section(&buf);
+    std::pair<std::shared_ptr<const ListT>, size_t> list;
+    container_detail::read_section_payload(section, s, [&](std::istream& payload) {
+      list = decode_(label, payload);
+      return true;
+    });
+    file_.advise(offset, bytes, MADV_DONTNEED);
+    return list;
+  }
+};
+
+}  // namespace cuvs::neighbors::detail
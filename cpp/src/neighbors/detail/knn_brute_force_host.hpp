@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../core/nvtx.hpp"
+#include "../../distance/detail/host_distance.hpp"
+#include "../../distance/detail/host_distance_tile.hpp"
+#include "../../selection/detail/select_k_host.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/brute_force.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/host_mdspan.hpp>
+#include <raft/core/logger.hpp>
+#include <raft/core/resources.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace cuvs::neighbors::brute_force::detail {
+
+/** Bytes of a tile of queries; the tile kernel reuses it for every dataset row (L2 resident). */
+constexpr size_t kHostQueryTileBytes = 128 * 1024;
+/** Upper bound on the queries of a tile. */
+constexpr size_t kHostMaxQueryTile = 64;
+/** Bytes of the distance tile of a thread, one row per query of the query tile. */
+constexpr size_t kHostDistanceTileBytes = 256 * 1024;
+
+/**
+ * The norms of the rows the expanded metrics need, like the GPU `build`: squared L2 norms for
+ * the L2 metrics, L2 norms for the cosine distance, none otherwise.
+ */
+template <typename T>
+auto compute_norms_host(raft::host_matrix_view<const T, int64_t, raft::row_major> dataset,
+                        cuvs::distance::DistanceType metric)
+  -> std::optional<raft::host_vector<T, int64_t>>
+{
+  const bool cosine = metric == cuvs::distance::DistanceType::CosineExpanded;
+  if (!cosine && metric != cuvs::distance::DistanceType::L2Expanded &&
+      metric != cuvs::distance::DistanceType::L2SqrtExpanded) {
+    return std::nullopt;
+  }
+  const int64_t n_rows = dataset.extent(0);
+  const size_t dim     = dataset.extent(1);
+  auto norms           = raft::make_host_vector<T, int64_t>(n_rows);
+  auto dot             = cuvs::distance::detail::host::get_distance_kernels<T>().inner_product;
+#pragma omp parallel for schedule(static)
+  for (int64_t i = 0; i < n_rows; i++) {
+    const T* row = dataset.data_handle() + i * dim;
+    float s      = dot(row, row, dim);
+    norms(i)     = static_cast<T>(cosine ? std::sqrt(s) : s);
+  }
+  return norms;
+}
+
+/**
+ * Search a brute force index on the host.
+ *
+ * This follows the tiling of `tiled_brute_force_knn`: the queries and the dataset are cut in row
+ * and column tiles, sized here for the CPU caches rather than for the device memory. The
+ * expanded metrics compute a tile of inner products with the register-blocked tile kernels (see
+ * `host_distance_tile.hpp`) and turn it into distances with the norms; the other metrics use the
+ * pairwise host distance kernels. The top-k selection is fused: each row of a distance tile is
+ * pushed into the bounded heap of its query while it is still in the L1/L2 cache, instead of
+ * being written out for a separate select_k and merge pass.
+ *
+ * The work items are the query tiles; with fewer query tiles than threads, the dataset is also
+ * split in ranges (of whole column tiles) and the per-range top-k of a query are merged.
+ * As in the other host searches, all keys are "smaller is better": the inner product is negated.
+ */
+template <typename T>
+void search_host(raft::resources const& res,
+                 const host_index<T>& index,
+                 raft::host_matrix_view<const T, int64_t, raft::row_major> queries,
+                 raft::host_matrix_view<int64_t, int64_t, raft::row_major> neighbors,
+                 raft::host_matrix_view<T, int64_t, raft::row_major> distances)
+{
+  static_assert(std::is_same_v<T, float>, "The host brute force search supports float data");
+  using heap_t = cuvs::selection::detail::host::bounded_heap<float, int64_t>;
+
+  const size_t n_queries = queries.extent(0);
+  const size_t n_rows    = index.size();
+  const size_t dim       = index.dim();
+  const size_t k         = neighbors.extent(1);
+  const auto metric      = index.metric();
+
+  cuvs::common::nvtx::range<cuvs::common::nvtx::domain::cuvs> fun_scope(
+    "brute_force::search_host(%zu, %zu)", n_queries, k);
+
+  RAFT_EXPECTS(
+    queries.extent(0) == neighbors.extent(0) && queries.extent(0) == distances.extent(0),
+    "Number of rows in output neighbors and distances matrices must equal the number of queries.");
+  RAFT_EXPECTS(neighbors.extent(1) == distances.extent(1),
+               "Number of columns in output neighbors and distances matrices must be equal");
+  RAFT_EXPECTS(queries.extent(1) == dim,
+               "Number of query dimensions should equal number of dimensions in the index.");
+
+  const auto& pair_kernels = cuvs::distance::detail::host::get_distance_kernels<T>();
+  cuvs::distance::detail::host::distance_kernel<T> pair_distance = nullptr;
+  bool take_sqrt                                                 = false;
+  switch (metric) {
+    case cuvs::distance::DistanceType::L2Expanded:
+    case cuvs::distance::DistanceType::CosineExpanded:
+    case cuvs::distance::DistanceType::InnerProduct: break;
+    case cuvs::distance::DistanceType::L2SqrtExpanded: take_sqrt = true; break;
+    case cuvs::distance::DistanceType::L2Unexpanded: pair_distance = pair_kernels.l2; break;
+    case cuvs::distance::DistanceType::L2SqrtUnexpanded:
+      pair_distance = pair_kernels.l2;
+      take_sqrt     = true;
+      break;
+    case cuvs::distance::DistanceType::L1: pair_distance = pair_kernels.l1; break;
+    case cuvs::distance::DistanceType::Linf: pair_distance = pair_kernels.linf; break;
+    default:
+      RAFT_FAIL("Unsupported metric for brute force host search: %d", static_cast<int>(metric));
+  }
+  const bool inner_product = metric == cuvs::distance::DistanceType::InnerProduct;
+  const bool cosine        = metric == cuvs::distance::DistanceType::CosineExpanded;
+  const bool needs_norms   = pair_distance == nullptr && !inner_product;
+  RAFT_EXPECTS(!needs_norms || index.has_norms(), "The index has no norms for the metric");
+  const T* data_norms = needs_norms ? index.norms().data_handle() : nullptr;
+
+  std::optional<raft::host_vector<T, int64_t>> query_norms;
+  if (needs_norms) { query_norms = compute_norms_host(queries, metric); }
+
+  const size_t tile_rows =
+    std::clamp<size_t>(kHostQueryTileBytes / (std::max<size_t>(dim, 1) * sizeof(T)),
+                       1,
+                       std::min(kHostMaxQueryTile, std::max<size_t>(n_queries, 1)));
+  const size_t tile_cols = std::clamp<size_t>(
+    kHostDistanceTileBytes / (tile_rows * sizeof(float)), 1, std::max<size_t>(n_rows, 1));
+  const size_t n_row_tiles = (n_queries + tile_rows - 1) / tile_rows;
+  const size_t n_col_tiles = (n_rows + tile_cols - 1) / tile_cols;
+  const size_t n_threads   = omp_get_max_threads();
+  const size_t n_splits    = std::clamp<size_t>((n_threads + n_row_tiles - 1) /
+                                                std::max<size_t>(n_row_tiles, 1),
+                                              1,
+                                              std::max<size_t>(n_col_tiles, 1));
+  const size_t split_tiles = (n_col_tiles + n_splits - 1) / n_splits;
+  RAFT_LOG_DEBUG("# brute force host search: tiles %zu x %zu, %zu dataset ranges",
+                 tile_rows,
+                 tile_cols,
+                 n_splits);
+
+  // The per-range top-k of every query, when the dataset is split.
+  std::vector<float> split_keys;
+  std::vector<int64_t> split_indices;
+  std::vector<size_t> split_counts;
+  if (n_splits > 1) {
+    split_keys.resize(n_splits * n_queries * k);
+    split_indices.resize(n_splits * n_queries * k);
+    split_counts.resize(n_splits * n_queries);
+  }
+
+  // Write the results of a query; missing results (fewer than k rows) are marked as out of bounds
+  // like in the other host searches.
+  auto write_results = [&](size_t i, heap_t& heap) {
+    int64_t* out_neighbors = neighbors.data_handle() + i * k;
+    T* out_distances       = distances.data_handle() + i * k;
+    const size_t n         = heap.pop_sorted(out_distances, out_neighbors);
+    for (size_t j = 0; j < n; j++) {
+      if (inner_product) {
+        out_distances[j] = -out_distances[j];
+      } else if (take_sqrt) {
+        out_distances[j] = std::sqrt(out_distances[j]);
+      }
+    }
+    std::fill(out_neighbors + n, out_neighbors + k, std::numeric_limits<int64_t>::max());
+    std::fill(out_distances + n,
+              out_distances + k,
+              inner_product ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max());
+  };
+
+  const auto tile_kernel = cuvs::distance::detail::host::get_inner_product_tile_kernel();
+
+#pragma omp parallel
+  {
+    std::vector<heap_t> heaps(tile_rows);
+    std::vector<float> tile(tile_rows * tile_cols);
+
+#pragma omp for schedule(dynamic)
+    for (size_t item = 0; item < n_row_tiles * n_splits; item++) {
+      const size_t row_tile = item / n_splits;
+      const size_t split    = item % n_splits;
+      const size_t q0       = row_tile * tile_rows;
+      const size_t nq       = std::min(tile_rows, n_queries - q0);
+      const size_t c_begin  = std::min(n_rows, split * split_tiles * tile_cols);
+      const size_t c_end    = std::min(n_rows, c_begin + split_tiles * tile_cols);
+      const T* query_tile   = queries.data_handle() + q0 * dim;
+
+      for (size_t q = 0; q < nq; q++) {
+        heaps[q].reset(k);
+      }
+      for (size_t c0 = c_begin; c0 < c_end; c0 += tile_cols) {
+        const size_t nc    = std::min(tile_cols, c_end - c0);
+        const T* data_tile = index.dataset().data_handle() + c0 * dim;
+        if (pair_distance != nullptr) {
+          for (size_t c = 0; c < nc; c++) {
+            for (size_t q = 0; q < nq; q++) {
+              tile[q * tile_cols + c] =
+                pair_distance(query_tile + q * dim, data_tile + c * dim, dim);
+            }
+          }
+        } else {
+          tile_kernel(query_tile, nq, data_tile, nc, dim, tile.data(), tile_cols);
+        }
+        for (size_t q = 0; q < nq; q++) {
+          float* row = tile.data() + q * tile_cols;
+          if (inner_product) {
+            for (size_t c = 0; c < nc; c++) {
+              row[c] = -row[c];
+            }
+          } else if (cosine) {
+            const float qn    = (*query_norms)(q0 + q);
+            const T* norms_ct = data_norms + c0;
+            for (size_t c = 0; c < nc; c++) {
+              row[c] = 1.0f - row[c] / (qn * norms_ct[c]);
+            }
+          } else if (needs_norms) {
+            const float qn    = (*query_norms)(q0 + q);
+            const T* norms_ct = data_norms + c0;
+            for (size_t c = 0; c < nc; c++) {
+              row[c] = std::max(qn + norms_ct[c] - 2.0f * row[c], 0.0f);
+            }
+          }
+          heaps[q].push_iota(row, nc, static_cast<int64_t>(c0));
+        }
+      }
+
+      for (size_t q = 0; q < nq; q++) {
+        if (n_splits == 1) {
+          write_results(q0 + q, heaps[q]);
+          continue;
+        }
+        const size_t slot = split * n_queries + q0 + q;
+        split_counts[slot] =
+          heaps[q].pop_unsorted(split_keys.data() + slot * k, split_indices.data() + slot * k);
+      }
+    }
+
+    if (n_splits > 1) {
+      auto& heap = heaps.front();
+#pragma omp for schedule(static)
+      for (size_t i = 0; i < n_queries; i++) {
+        heap.reset(k);
+        for (size_t s = 0; s < n_splits; s++) {
+          const size_t slot = s * n_queries + i;
+          heap.push(
+            split_keys.data() + slot * k, split_indices.data() + slot * k, split_counts[slot]);
+        }
+        write_results(i, heap);
+      }
+    }
+  }
+}
+
+}  // namespace cuvs::neighbors::brute_force::detail
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "container_serialize.hpp"
+#include <cuvs/neighbors/brute_force.hpp>
+#include <cuvs/neighbors/common.hpp>
+
+#include <raft/core/detail/mdspan_numpy_serializer.hpp>
+#include <raft/core/device_mdarray.hpp>
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/logger-ext.hpp>
+#include <raft/core/serialize.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string_view>
+
+namespace cuvs::neighbors::brute_force::detail {
+
+// The index is a container (see container_serialize.hpp) with the sections "params", "dataset"
+// and, if the index has them, "norms".
+constexpr int serialization_version       = 1;
+constexpr std::string_view kContainerKind = "brute_force";
+
+template <typename T>
+void serialize(raft::resources const& res,
+               std::ostream& os,
+               const index<T>& index_,
+               serialize_compression compression = serialize_compression::NONE)
+{
+  RAFT_LOG_DEBUG("Saving brute force index, size %zu, dim %zu", index_.size(), index_.dim());
+
+  std::string dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
+  dtype_string.resize(4);
+
+  constexpr auto kRequired = neighbors::detail::kSectionRequired;
+  neighbors::detail::section_encoding dataset_encoding;
+  if (compression != serialize_compression::NONE) {
+    dataset_encoding = {neighbors::detail::section_codec::kShuffleLz, sizeof(T)};
+  }
+  neighbors::detail::container_writer writer(os, kContainerKind, serialization_version);
+  writer.section("params", 0, kRequired, [&](std::ostream& s) {
+    s << dtype_string;
+    raft::serialize_scalar(res, s, static_cast<int64_t>(index_.size()));
+    raft::serialize_scalar(res, s, static_cast<int64_t>(index_.dim()));
+    raft::serialize_scalar(res, s, index_.metric());
+    raft::serialize_scalar(res, s, index_.metric_arg());
+  });
+  writer.section("dataset", 0, kRequired, dataset_encoding, [&](std::ostream& s) {
+    raft::serialize_mdspan(res, s, index_.dataset());
+  });
+  if (index_.has_norms()) {
+    writer.section("norms", 0, kRequired, [&](std::ostream& s) {
+      raft::serialize_mdspan(res, s, index_.norms());
+    });
+  }
+  writer.finish();
+}
+
+template <typename T>
+void serialize(raft::resources const& res,
+               const std::string& filename,
+               const index<T>& index_,
+               serialize_compression compression = serialize_compression::NONE)
+{
+  std::ofstream of(filename, std::ios::out | std::ios::binary);
+  if (!of) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+
+  detail::serialize(res, of, index_, compression);
+
+  of.close();
+  if (!of) { RAFT_FAIL("Error writing output %s", filename.c_str()); }
+}
+
+template <typename T>
+auto deserialize(raft::resources const& res, std::istream& is) -> index<T>
+{
+  auto prefix = neighbors::detail::read_container_prefix(is);
+  RAFT_EXPECTS(neighbors::detail::is_container(prefix), "Not a serialized brute force index");
+  neighbors::detail::container_reader reader(is, prefix, kContainerKind, serialization_version);
+
+  int64_t n_rows = 0;
+  int64_t dim    = 0;
+  auto metric    = cuvs::distance::DistanceType::L2Unexpanded;
+  T metric_arg   = 0;
+  std::optional<raft::host_matrix<T, int64_t>> dataset;
+  std::optional<raft::device_vector<T, int64_t>> norms;
+  reader.read_sections([&](const neighbors::detail::section_info& s, std::istream& payload) {
+    if (s.is("params")) {
+      auto dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
+      dtype_string.resize(4);
+      char stored_dtype[4];
+      neighbors::detail::read_container_bytes(payload, stored_dtype, 4, "dtype");
+      RAFT_EXPECTS(std::memcmp(stored_dtype, dtype_string.data(), 4) == 0,
+                   "The data type of the brute force index does not match");
+      n_rows     = raft::deserialize_scalar<int64_t>(res, payload);
+      dim        = raft::deserialize_scalar<int64_t>(res, payload);
+      metric     = raft::deserialize_scalar<cuvs::distance::DistanceType>(res, payload);
+      metric_arg = raft::deserialize_scalar<T>(res, payload);
+      return true;
+    }
+    RAFT_EXPECTS(reader.count_sections("params") > 0,
+                 "Brute force section '%s' precedes the parameters",
+                 s.name.c_str());
+    if (s.is("dataset")) {
+      dataset.emplace(raft::make_host_matrix<T, int64_t>(n_rows, dim));
+      raft::deserialize_mdspan(res, payload, dataset->view());
+    } else if (s.is("norms")) {
+      norms.emplace(raft::make_device_vector<T, int64_t>(res, n_rows));
+      raft::deserialize_mdspan(res, payload, norms->view());
+    } else {
+      return false;
+    }
+    return true;
+  });
+  reader.require_sections("brute force", {"params", "dataset"});
+
+  return index<T>(
+    res, raft::make_const_mdspan(dataset->view()), std::move(norms), metric, metric_arg);
+}
+
+template <typename T>
+auto deserialize(raft::resources const& res, const std::string& filename) -> index<T>
+{
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  if (!is) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+
+  return detail::deserialize<T>(res, is);
+}
+
+}  // namespace cuvs::neighbors::brute_force::detail
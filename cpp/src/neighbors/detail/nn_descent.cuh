@@ -18,6 +18,9 @@
 
 #include <cuvs/neighbors/nn_descent.hpp>
 
+#include "../../core/bloom_filter.hpp"
+#include "../../distance/detail/host_distance.hpp"
+#include "../../distance/detail/host_distance_tile.hpp"
 #include "ann_utils.cuh"
 #include "cagra/device_common.hpp"
 #include <raft/core/device_mdarray.hpp>
@@ -43,9 +46,14 @@
 #include <mma.h>
 #include <omp.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <queue>
 #include <random>
+#include <vector>
 
 namespace cuvs::neighbors::nn_descent::detail {
 static const std::string RAFT_NAME = "raft";
@@ -218,87 +226,9 @@ struct BuildConfig {
   float termination_threshold{0.0001};
 };
 
-template <typename Index_t>
-class BloomFilter {
- public:
-  BloomFilter(size_t nrow, size_t num_sets_per_list, size_t num_hashs)
-    : nrow_(nrow),
-      num_sets_per_list_(num_sets_per_list),
-      num_hashs_(num_hashs),
-      bitsets_(nrow * num_bits_per_set_ * num_sets_per_list)
-  {
-  }
-
-  void add(size_t list_id, Index_t key)
-  {
-    if (is_cleared) { is_cleared = false; }
-    uint32_t hash         = hash_0(key);
-    size_t global_set_idx = list_id * num_bits_per_set_ * num_sets_per_list_ +
-                            key % num_sets_per_list_ * num_bits_per_set_;
-    bitsets_[global_set_idx + hash % num_bits_per_set_] = 1;
-    for (size_t i = 1; i < num_hashs_; i++) {
-      hash                                                = hash + hash_1(key);
-      bitsets_[global_set_idx + hash % num_bits_per_set_] = 1;
-    }
-  }
-
-  bool check(size_t list_id, Index_t key)
-  {
-    bool is_present       = true;
-    uint32_t hash         = hash_0(key);
-    size_t global_set_idx = list_id * num_bits_per_set_ * num_sets_per_list_ +
-                            key % num_sets_per_list_ * num_bits_per_set_;
-    is_present &= bitsets_[global_set_idx + hash % num_bits_per_set_];
-
-    if (!is_present) return false;
-    for (size_t i = 1; i < num_hashs_; i++) {
-      hash = hash + hash_1(key);
-      is_present &= bitsets_[global_set_idx + hash % num_bits_per_set_];
-      if (!is_present) return false;
-    }
-    return true;
-  }
-
-  void clear()
-  {
-    if (is_cleared) return;
-#pragma omp parallel for
-    for (size_t i = 0; i < nrow_ * num_bits_per_set_ * num_sets_per_list_; i++) {
-      bitsets_[i] = 0;
-    }
-    is_cleared = true;
-  }
-
- private:
-  uint32_t hash_0(uint32_t value)
-  {
-    value *= 1103515245;
-    value += 12345;
-    value ^= value << 13;
-    value ^= value >> 17;
-    value ^= value << 5;
-    return value;
-  }
-
-  uint32_t hash_1(uint32_t value)
-  {
-    value *= 1664525;
-    value += 1013904223;
-    value ^= value << 13;
-    value ^= value >> 17;
-    value ^= value << 5;
-    return value;
-  }
-
-  static constexpr int num_bits_per_set_ = 512;
-  bool is_cleared{true};
-  std::vector<bool> bitsets_;
-  size_t nrow_;
-  size_t num_sets_per_list_;
-  size_t num_hashs_;
-};
-
-template <typename Index_t>
+// The sampled lists live in pinned memory, read directly by the local join kernel; the host
+// backend (`GNNDHost`) keeps them in pageable memory with `std::allocator`.
+template <typename Index_t, template <typename> class HostAllocator = pinned_memory_allocator>
 struct GnndGraph {
   static constexpr int segment_size = 32;
   InternalID_t<Index_t>* h_graph;
@@ -310,12 +240,12 @@ struct GnndGraph {
 
   raft::host_matrix<DistData_t, size_t, raft::row_major> h_dists;
 
-  thrust::host_vector<Index_t, pinned_memory_allocator<Index_t>> h_graph_new;
-  thrust::host_vector<int2, pinned_memory_allocator<int2>> h_list_sizes_new;
+  thrust::host_vector<Index_t, HostAllocator<Index_t>> h_graph_new;
+  thrust::host_vector<int2, HostAllocator<int2>> h_list_sizes_new;
 
-  thrust::host_vector<Index_t, pinned_memory_allocator<Index_t>> h_graph_old;
-  thrust::host_vector<int2, pinned_memory_allocator<int2>> h_list_sizes_old;
-  BloomFilter<Index_t> bloom_filter;
+  thrust::host_vector<Index_t, HostAllocator<Index_t>> h_graph_old;
+  thrust::host_vector<int2, HostAllocator<int2>> h_list_sizes_old;
+  cuvs::core::detail::blocked_bloom_filter<Index_t> bloom_filter;
 
   GnndGraph(const GnndGraph&)            = delete;
   GnndGraph& operator=(const GnndGraph&) = delete;
@@ -324,7 +254,6 @@ struct GnndGraph {
             const size_t internal_node_degree,
             const size_t num_samples);
   void init_random_graph();
-  // TODO: Create a generic bloom filter utility https://github.com/rapidsai/raft/issues/1827
   // Use Bloom filter to sample "new" neighbors for local joining
   void sample_graph_new(InternalID_t<Index_t>* new_neighbors, const size_t width);
   void sample_graph(bool sample_new);
@@ -333,6 +262,9 @@ struct GnndGraph {
                     const size_t width,
                     std::atomic<int64_t>& update_counter);
   void sort_lists();
+  // Write the first `output_degree` neighbors of the sorted lists to `output_graph`, which may
+  // alias `h_graph`, and detach `h_graph`. Missing neighbors are replaced with random nodes.
+  void shrink(Index_t* output_graph, const size_t output_degree);
   void clear();
   ~GnndGraph();
 };
@@ -386,6 +318,59 @@ class GNND {
   raft::device_vector<int2, size_t> d_list_sizes_old_;
 };
 
+/**
+ * The CPU backend of GNND, for machines without a GPU.
+ *
+ * The iterations are those of `GNND`: the sampling, the Bloom filter and the graph updates are the
+ * same `GnndGraph` steps, in pageable memory. The reverse edges and the local join, which `GNND`
+ * runs on the device, run on all the cores:
+ *
+ * - the local join of a list gathers the vectors of its new and old neighbors into two tiles, and
+ *   computes all their inner products with the blocked SIMD tile kernel of the host brute force;
+ *   the L2 distances follow from the precomputed norms.
+ * - as on the device, every neighbor of the list proposes its closest neighbor in the list as a
+ *   candidate. The candidate lists of all the nodes are updated by all the threads at once, without
+ *   locks: a candidate is packed with its distance into one 64-bit word, and replaces the worst
+ *   word of the list with a compare-and-swap.
+ */
+template <typename Data_t = float, typename Index_t = int>
+class GNNDHost {
+ public:
+  explicit GNNDHost(const BuildConfig& build_config);
+  GNNDHost(const GNNDHost&)            = delete;
+  GNNDHost& operator=(const GNNDHost&) = delete;
+
+  void build(Data_t* data, const Index_t nrow, Index_t* output_graph);
+  ~GNNDHost() = default;
+  using ID_t  = InternalID_t<Index_t>;
+
+ private:
+  void add_reverse_edges(const Index_t* graph_ptr, Index_t* rev_graph_ptr, int2* list_sizes);
+  void local_join(const Data_t* data);
+
+  BuildConfig build_config_;
+  GnndGraph<Index_t, std::allocator> graph_;
+  std::atomic<int64_t> update_counter_;
+
+  size_t nrow_;
+  size_t ndim_;
+
+  std::vector<DistData_t> l2_norms_;
+
+  // The candidates of the local join, packed (see `pack_candidate`) [nrow, DEGREE_ON_DEVICE]
+  std::vector<uint64_t> candidates_;
+  // The candidates of the last local join, sorted by distance
+  std::vector<ID_t> graph_host_buffer_;
+  std::vector<DistData_t> dists_host_buffer_;
+
+  std::vector<Index_t> h_rev_graph_new_;
+  std::vector<Index_t> h_graph_old_;
+  std::vector<Index_t> h_rev_graph_old_;
+  // int2.x is the number of forward edges, int2.y is the number of reverse edges
+  std::vector<int2> list_sizes_new_;
+  std::vector<int2> list_sizes_old_;
+};
+
 constexpr int TILE_ROW_WIDTH = 64;
 constexpr int TILE_COL_WIDTH = 128;
 
@@ -968,17 +953,67 @@ int insert_to_ordered_list(InternalID_t<Index_t>* list,
   return idx_insert;
 };
 
+// A candidate of the host local join: the distance, with its bits flipped so that they compare like
+// the floats, above the id. Packed candidates compare by distance, then by id.
+constexpr uint64_t kEmptyCandidate = std::numeric_limits<uint64_t>::max();
+
+inline uint64_t pack_candidate(DistData_t dist, uint32_t id)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &dist, sizeof(bits));
+  bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  return (uint64_t{bits} << 32) | id;
+}
+
+inline DistData_t unpack_candidate_dist(uint64_t candidate)
+{
+  uint32_t bits = static_cast<uint32_t>(candidate >> 32);
+  bits          = (bits & 0x80000000u) ? (bits & 0x7fffffffu) : ~bits;
+  DistData_t dist;
+  std::memcpy(&dist, &bits, sizeof(dist));
+  return dist;
+}
+
+/**
+ * Insert a candidate into an unordered list of `width` packed candidates, unless the list holds a
+ * better one for each slot or the id is already there. Lock-free: the worst slot is replaced with a
+ * compare-and-swap, and the scan is repeated if another thread changed it in the meantime. Two
+ * threads inserting the same id at once may both succeed; the duplicates are dropped by
+ * `update_graph` and by the Bloom filter of `sample_graph_new`.
+ */
+inline void insert_candidate(uint64_t* list, const int width, const uint64_t candidate)
+{
+  const auto id = static_cast<uint32_t>(candidate);
+  while (true) {
+    uint64_t worst = 0;
+    int worst_pos  = 0;
+    for (int i = 0; i < width; i++) {
+      const uint64_t item = __atomic_load_n(list + i, __ATOMIC_RELAXED);
+      if (static_cast<uint32_t>(item) == id) { return; }
+      if (item > worst) {
+        worst     = item;
+        worst_pos = i;
+      }
+    }
+    if (candidate >= worst) { return; }
+    if (__atomic_compare_exchange_n(
+          list + worst_pos, &worst, candidate, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      return;
+    }
+  }
+}
+
 }  // namespace
 
-template <typename Index_t>
-GnndGraph<Index_t>::GnndGraph(const size_t nrow,
-                              const size_t node_degree,
-                              const size_t internal_node_degree,
-                              const size_t num_samples)
+template <typename Index_t, template <typename> class HostAllocator>
+GnndGraph<Index_t, HostAllocator>::GnndGraph(const size_t nrow,
+                                             const size_t node_degree,
+                                             const size_t internal_node_degree,
+                                             const size_t num_samples)
   : nrow(nrow),
     node_degree(node_degree),
     num_samples(num_samples),
-    bloom_filter(nrow, internal_node_degree / segment_size, 3),
+    bloom_filter(nrow, internal_node_degree / segment_size),
     h_dists{raft::make_host_matrix<DistData_t, size_t, raft::row_major>(nrow, node_degree)},
     h_graph_new(nrow * num_samples),
     h_list_sizes_new(nrow),
@@ -996,8 +1031,9 @@ GnndGraph<Index_t>::GnndGraph(const size_t nrow,
 
 // This is the only operation on the CPU that cannot be overlapped.
 // So it should be as fast as possible.
-template <typename Index_t>
-void GnndGraph<Index_t>::sample_graph_new(InternalID_t<Index_t>* new_neighbors, const size_t width)
+template <typename Index_t, template <typename> class HostAllocator>
+void GnndGraph<Index_t, HostAllocator>::sample_graph_new(InternalID_t<Index_t>* new_neighbors,
+                                                         const size_t width)
 {
 #pragma omp parallel for
   for (size_t i = 0; i < nrow; i++) {
@@ -1008,8 +1044,7 @@ void GnndGraph<Index_t>::sample_graph_new(InternalID_t<Index_t>* new_neighbors,
     for (size_t j = 0; j < width; j++) {
       auto new_neighb_id = new_neighbors[i * width + j].id();
       if ((size_t)new_neighb_id >= nrow) break;
-      if (bloom_filter.check(i, new_neighb_id)) { continue; }
-      bloom_filter.add(i, new_neighb_id);
+      if (bloom_filter.check_and_add(i, new_neighb_id)) { continue; }
       new_neighbors[i * width + j].mark_old();
       list_new[h_list_sizes_new[i].x++] = new_neighb_id;
       if (h_list_sizes_new[i].x == num_samples) break;
@@ -1017,8 +1052,8 @@ void GnndGraph<Index_t>::sample_graph_new(InternalID_t<Index_t>* new_neighbors,
   }
 }
 
-template <typename Index_t>
-void GnndGraph<Index_t>::init_random_graph()
+template <typename Index_t, template <typename> class HostAllocator>
+void GnndGraph<Index_t, HostAllocator>::init_random_graph()
 {
   for (size_t seg_idx = 0; seg_idx < static_cast<size_t>(num_segments); seg_idx++) {
     // random sequence (range: 0~nrow)
@@ -1046,8 +1081,8 @@ void GnndGraph<Index_t>::init_random_graph()
   }
 }
 
-template <typename Index_t>
-void GnndGraph<Index_t>::sample_graph(bool sample_new)
+template <typename Index_t, template <typename> class HostAllocator>
+void GnndGraph<Index_t, HostAllocator>::sample_graph(bool sample_new)
 {
 #pragma omp parallel for
   for (size_t i = 0; i < nrow; i++) {
@@ -1080,11 +1115,11 @@ void GnndGraph<Index_t>::sample_graph(bool sample_new)
   }
 }
 
-template <typename Index_t>
-void GnndGraph<Index_t>::update_graph(const InternalID_t<Index_t>* new_neighbors,
-                                      const DistData_t* new_dists,
-                                      const size_t width,
-                                      std::atomic<int64_t>& update_counter)
+template <typename Index_t, template <typename> class HostAllocator>
+void GnndGraph<Index_t, HostAllocator>::update_graph(const InternalID_t<Index_t>* new_neighbors,
+                                                     const DistData_t* new_dists,
+                                                     const size_t width,
+                                                     std::atomic<int64_t>& update_counter)
 {
 #pragma omp parallel for
   for (size_t i = 0; i < nrow; i++) {
@@ -1103,8 +1138,8 @@ void GnndGraph<Index_t>::update_graph(const InternalID_t<Index_t>* new_neighbors
   }
 }
 
-template <typename Index_t>
-void GnndGraph<Index_t>::sort_lists()
+template <typename Index_t, template <typename> class HostAllocator>
+void GnndGraph<Index_t, HostAllocator>::sort_lists()
 {
 #pragma omp parallel for
   for (size_t i = 0; i < nrow; i++) {
@@ -1121,14 +1156,44 @@ void GnndGraph<Index_t>::sort_lists()
   }
 }
 
-template <typename Index_t>
-void GnndGraph<Index_t>::clear()
+template <typename Index_t, template <typename> class HostAllocator>
+void GnndGraph<Index_t, HostAllocator>::shrink(Index_t* output_graph, const size_t output_degree)
+{
+  // Reuse h_dists as the buffer for shrink the lists in graph
+  static_assert(sizeof(DistData_t) >= sizeof(Index_t));
+  Index_t* graph_shrink_buffer = (Index_t*)h_dists.data_handle();
+
+#pragma omp parallel for
+  for (size_t i = 0; i < nrow; i++) {
+    for (size_t j = 0; j < output_degree; j++) {
+      size_t idx = i * node_degree + j;
+      int id     = h_graph[idx].id();
+      if (id < static_cast<int>(nrow)) {
+        graph_shrink_buffer[i * output_degree + j] = id;
+      } else {
+        graph_shrink_buffer[i * output_degree + j] =
+          cuvs::neighbors::cagra::detail::device::xorshift64(idx) % nrow;
+      }
+    }
+  }
+  h_graph = nullptr;
+
+#pragma omp parallel for
+  for (size_t i = 0; i < nrow; i++) {
+    for (size_t j = 0; j < output_degree; j++) {
+      output_graph[i * output_degree + j] = graph_shrink_buffer[i * output_degree + j];
+    }
+  }
+}
+
+template <typename Index_t, template <typename> class HostAllocator>
+void GnndGraph<Index_t, HostAllocator>::clear()
 {
   bloom_filter.clear();
 }
 
-template <typename Index_t>
-GnndGraph<Index_t>::~GnndGraph()
+template <typename Index_t, template <typename> class HostAllocator>
+GnndGraph<Index_t, HostAllocator>::~GnndGraph()
 {
   assert(h_graph == nullptr);
 }
@@ -1336,34 +1401,263 @@ void GNND<Data_t, Index_t>::build(Data_t* data, const Index_t nrow, Index_t* out
   raft::resource::sync_stream(res);
   graph_.sort_lists();
 
-  // Reuse graph_.h_dists as the buffer for shrink the lists in graph
-  static_assert(sizeof(decltype(*(graph_.h_dists.data_handle()))) >= sizeof(Index_t));
-  Index_t* graph_shrink_buffer = (Index_t*)graph_.h_dists.data_handle();
+  graph_.shrink(output_graph, build_config_.node_degree);
+}
+
+template <typename Data_t, typename Index_t>
+GNNDHost<Data_t, Index_t>::GNNDHost(const BuildConfig& build_config)
+  : build_config_(build_config),
+    graph_(build_config.max_dataset_size,
+           align32::roundUp(build_config.node_degree),
+           align32::roundUp(build_config.internal_node_degree ? build_config.internal_node_degree
+                                                              : build_config.node_degree),
+           NUM_SAMPLES),
+    nrow_(build_config.max_dataset_size),
+    ndim_(build_config.dataset_dim),
+    l2_norms_(nrow_),
+    candidates_(nrow_ * DEGREE_ON_DEVICE, kEmptyCandidate),
+    graph_host_buffer_(nrow_ * DEGREE_ON_DEVICE),
+    dists_host_buffer_(nrow_ * DEGREE_ON_DEVICE, std::numeric_limits<DistData_t>::max()),
+    h_rev_graph_new_(nrow_ * NUM_SAMPLES),
+    h_graph_old_(nrow_ * NUM_SAMPLES),
+    h_rev_graph_old_(nrow_ * NUM_SAMPLES),
+    list_sizes_new_(nrow_),
+    list_sizes_old_(nrow_)
+{
+  static_assert(NUM_SAMPLES <= 32);
+}
 
+template <typename Data_t, typename Index_t>
+void GNNDHost<Data_t, Index_t>::add_reverse_edges(const Index_t* graph_ptr,
+                                                  Index_t* rev_graph_ptr,
+                                                  int2* list_sizes)
+{
+#pragma omp parallel for schedule(dynamic, 1024)
+  for (int64_t list_id = 0; list_id < static_cast<int64_t>(nrow_); list_id++) {
+    for (int idx = 0; idx < list_sizes[list_id].x; idx++) {
+      size_t rev_list_id  = graph_ptr[list_id * NUM_SAMPLES + idx];
+      int idx_in_rev_list = __atomic_fetch_add(&list_sizes[rev_list_id].y, 1, __ATOMIC_RELAXED);
+      if (idx_in_rev_list < NUM_SAMPLES) {
+        rev_graph_ptr[rev_list_id * NUM_SAMPLES + idx_in_rev_list] = list_id;
+      }
+    }
+  }
 #pragma omp parallel for
-  for (size_t i = 0; i < (size_t)nrow_; i++) {
-    for (size_t j = 0; j < build_config_.node_degree; j++) {
-      size_t idx = i * graph_.node_degree + j;
-      int id     = graph_.h_graph[idx].id();
-      if (id < static_cast<int>(nrow_)) {
-        graph_shrink_buffer[i * build_config_.node_degree + j] = id;
+  for (size_t list_id = 0; list_id < nrow_; list_id++) {
+    list_sizes[list_id].y = std::min(list_sizes[list_id].y, NUM_SAMPLES);
+  }
+}
+
+template <typename Data_t, typename Index_t>
+void GNNDHost<Data_t, Index_t>::local_join(const Data_t* data)
+{
+  using cuvs::distance::detail::host::to_float;
+  const auto tile_kernel = cuvs::distance::detail::host::get_inner_product_tile_kernel();
+  constexpr int ld       = MAX_NUM_BI_SAMPLES;
+
+  // The forward neighbors of a list, then its reverse neighbors that are not forward ones.
+  auto gather_list = [](const Index_t* graph,
+                        const Index_t* rev_graph,
+                        const int2 list_size,
+                        const size_t list_id,
+                        Index_t* list) {
+    const Index_t* forward = graph + list_id * NUM_SAMPLES;
+    const Index_t* reverse = rev_graph + list_id * NUM_SAMPLES;
+    std::copy(forward, forward + list_size.x, list);
+    int n = list_size.x;
+    for (int i = 0; i < list_size.y; i++) {
+      if (std::find(forward, forward + list_size.x, reverse[i]) == forward + list_size.x) {
+        list[n++] = reverse[i];
+      }
+    }
+    return n;
+  };
+
+#pragma omp parallel
+  {
+    Index_t new_neighbors[MAX_NUM_BI_SAMPLES];
+    Index_t old_neighbors[MAX_NUM_BI_SAMPLES];
+    std::vector<float> new_vectors(MAX_NUM_BI_SAMPLES * ndim_);
+    std::vector<float> old_vectors(MAX_NUM_BI_SAMPLES * ndim_);
+    std::vector<float> distances(MAX_NUM_BI_SAMPLES * ld);
+
+    // The rows are scattered over the dataset: request all of them before converting them.
+    auto load_vectors = [&](const Index_t* neighbors, int n, float* vectors) {
+      for (int i = 0; i < n; i++) {
+        const auto* row =
+          reinterpret_cast<const char*>(data + static_cast<size_t>(neighbors[i]) * ndim_);
+        for (size_t offset = 0; offset < ndim_ * sizeof(Data_t); offset += 64) {
+          __builtin_prefetch(row + offset);
+        }
+      }
+      for (int i = 0; i < n; i++) {
+        const Data_t* row = data + static_cast<size_t>(neighbors[i]) * ndim_;
+        for (size_t k = 0; k < ndim_; k++) {
+          vectors[i * ndim_ + k] = to_float(row[k]);
+        }
+      }
+    };
+    // Turn the inner products of the tile into L2 distances.
+    auto to_l2 = [&](const Index_t* rows, int n_rows, const Index_t* cols, int n_cols) {
+      for (int i = 0; i < n_rows; i++) {
+        for (int j = 0; j < n_cols; j++) {
+          distances[i * ld + j] =
+            l2_norms_[rows[i]] + l2_norms_[cols[j]] - 2.0f * distances[i * ld + j];
+        }
+      }
+    };
+    auto propose = [&](Index_t list_id, Index_t neighb_id, DistData_t dist) {
+      insert_candidate(candidates_.data() + static_cast<size_t>(list_id) * DEGREE_ON_DEVICE,
+                       DEGREE_ON_DEVICE,
+                       pack_candidate(dist, neighb_id));
+    };
+
+#pragma omp for schedule(dynamic, 64)
+    for (int64_t list_id = 0; list_id < static_cast<int64_t>(nrow_); list_id++) {
+      const int n_new = gather_list(graph_.h_graph_new.data(),
+                                    h_rev_graph_new_.data(),
+                                    list_sizes_new_[list_id],
+                                    list_id,
+                                    new_neighbors);
+      if (n_new == 0) { continue; }
+      load_vectors(new_neighbors, n_new, new_vectors.data());
+
+      // new x new: every new neighbor proposes its closest new neighbor.
+      tile_kernel(
+        new_vectors.data(), n_new, new_vectors.data(), n_new, ndim_, distances.data(), ld);
+      to_l2(new_neighbors, n_new, new_neighbors, n_new);
+      for (int i = 0; i < n_new; i++) {
+        int best = -1;
+        for (int j = 0; j < n_new; j++) {
+          if (new_neighbors[j] == new_neighbors[i]) { continue; }
+          if (best < 0 || distances[i * ld + j] < distances[i * ld + best]) { best = j; }
+        }
+        if (best >= 0) { propose(new_neighbors[i], new_neighbors[best], distances[i * ld + best]); }
+      }
+
+      const int n_old = gather_list(h_graph_old_.data(),
+                                    h_rev_graph_old_.data(),
+                                    list_sizes_old_[list_id],
+                                    list_id,
+                                    old_neighbors);
+      if (n_old == 0) { continue; }
+      load_vectors(old_neighbors, n_old, old_vectors.data());
+
+      // new x old: every new neighbor proposes its closest old neighbor, and vice versa.
+      tile_kernel(
+        new_vectors.data(), n_new, old_vectors.data(), n_old, ndim_, distances.data(), ld);
+      to_l2(new_neighbors, n_new, old_neighbors, n_old);
+      for (int i = 0; i < n_new; i++) {
+        int best = -1;
+        for (int j = 0; j < n_old; j++) {
+          if (old_neighbors[j] == new_neighbors[i]) { continue; }
+          if (best < 0 || distances[i * ld + j] < distances[i * ld + best]) { best = j; }
+        }
+        if (best >= 0) { propose(new_neighbors[i], old_neighbors[best], distances[i * ld + best]); }
+      }
+      for (int j = 0; j < n_old; j++) {
+        int best = -1;
+        for (int i = 0; i < n_new; i++) {
+          if (new_neighbors[i] == old_neighbors[j]) { continue; }
+          if (best < 0 || distances[i * ld + j] < distances[best * ld + j]) { best = i; }
+        }
+        if (best >= 0) { propose(old_neighbors[j], new_neighbors[best], distances[best * ld + j]); }
+      }
+    }
+  }
+
+  // Sort the candidates for `update_graph` and `sample_graph_new`, and empty the lists.
+#pragma omp parallel for
+  for (size_t i = 0; i < nrow_; i++) {
+    uint64_t* list = candidates_.data() + i * DEGREE_ON_DEVICE;
+    std::sort(list, list + DEGREE_ON_DEVICE);
+    for (int j = 0; j < DEGREE_ON_DEVICE; j++) {
+      auto& id   = graph_host_buffer_[i * DEGREE_ON_DEVICE + j].id_with_flag();
+      auto& dist = dists_host_buffer_[i * DEGREE_ON_DEVICE + j];
+      if (list[j] == kEmptyCandidate) {
+        id   = std::numeric_limits<Index_t>::max();
+        dist = std::numeric_limits<DistData_t>::max();
       } else {
-        graph_shrink_buffer[i * build_config_.node_degree + j] =
-          cuvs::neighbors::cagra::detail::device::xorshift64(idx) % nrow_;
+        id   = static_cast<Index_t>(static_cast<uint32_t>(list[j]));
+        dist = unpack_candidate_dist(list[j]);
       }
+      list[j] = kEmptyCandidate;
     }
   }
-  graph_.h_graph = nullptr;
+}
+
+template <typename Data_t, typename Index_t>
+void GNNDHost<Data_t, Index_t>::build(Data_t* data, const Index_t nrow, Index_t* output_graph)
+{
+  using input_t = typename std::remove_const<Data_t>::type;
+
+  nrow_          = nrow;
+  graph_.h_graph = (InternalID_t<Index_t>*)output_graph;
 
+  const auto inner_product =
+    cuvs::distance::detail::host::get_distance_kernels<input_t>().inner_product;
 #pragma omp parallel for
-  for (size_t i = 0; i < (size_t)nrow_; i++) {
-    for (size_t j = 0; j < build_config_.node_degree; j++) {
-      output_graph[i * build_config_.node_degree + j] =
-        graph_shrink_buffer[i * build_config_.node_degree + j];
+  for (size_t i = 0; i < nrow_; i++) {
+    const Data_t* row = data + i * ndim_;
+    l2_norms_[i]      = inner_product(row, row, ndim_);
+  }
+
+  graph_.clear();
+  graph_.init_random_graph();
+  graph_.sample_graph(true);
+
+  for (size_t it = 0; it < build_config_.max_iterations; it++) {
+    RAFT_LOG_DEBUG("# GNND (host) iteration: %lu / %lu", it + 1, build_config_.max_iterations);
+    // The local join runs on the lists sampled by the previous iteration; `sample_graph` below
+    // samples the next old lists.
+    std::copy(
+      graph_.h_list_sizes_new.begin(), graph_.h_list_sizes_new.end(), list_sizes_new_.begin());
+    std::copy(graph_.h_graph_old.begin(), graph_.h_graph_old.end(), h_graph_old_.begin());
+    std::copy(
+      graph_.h_list_sizes_old.begin(), graph_.h_list_sizes_old.end(), list_sizes_old_.begin());
+
+    if (it > 0) {
+      update_counter_ = 0;
+      graph_.update_graph(
+        graph_host_buffer_.data(), dists_host_buffer_.data(), DEGREE_ON_DEVICE, update_counter_);
+      if (update_counter_ < build_config_.termination_threshold * nrow_ *
+                              build_config_.dataset_dim / counter_interval) {
+        break;
+      }
     }
+    graph_.sample_graph(false);
+
+    add_reverse_edges(graph_.h_graph_new.data(), h_rev_graph_new_.data(), list_sizes_new_.data());
+    add_reverse_edges(h_graph_old_.data(), h_rev_graph_old_.data(), list_sizes_old_.data());
+    local_join(data);
+
+    graph_.sample_graph_new(graph_host_buffer_.data(), DEGREE_ON_DEVICE);
+  }
+
+  graph_.update_graph(
+    graph_host_buffer_.data(), dists_host_buffer_.data(), DEGREE_ON_DEVICE, update_counter_);
+  graph_.sort_lists();
+
+  graph_.shrink(output_graph, build_config_.node_degree);
+}
+
+/** Whether a CUDA device is visible to the process. */
+inline bool has_cuda_device()
+{
+  int n_devices = 0;
+  if (cudaGetDeviceCount(&n_devices) != cudaSuccess) {
+    // Reset the error, which is not sticky.
+    cudaGetLastError();
+    return false;
   }
+  return n_devices > 0;
 }
 
+/**
+ * Build the graph of `idx` with GNND, on the device, or on the CPU with `GNNDHost` if
+ * `host_backend` is set (by default, when there is no device). The CPU backend needs a dataset in
+ * host memory.
+ */
 template <typename T,
           typename IdxT     = uint32_t,
           typename Accessor = raft::host_device_accessor<std::experimental::default_accessor<T>,
@@ -1371,7 +1665,8 @@ template <typename T,
 void build(raft::resources const& res,
            const index_params& params,
            raft::mdspan<const T, raft::matrix_extent<int64_t>, raft::row_major, Accessor> dataset,
-           index<IdxT>& idx)
+           index<IdxT>& idx,
+           bool host_backend = !has_cuda_device())
 {
   RAFT_EXPECTS(dataset.extent(0) < std::numeric_limits<int>::max() - 1,
                "The dataset size for GNND should be less than %d",
@@ -1412,8 +1707,16 @@ void build(raft::resources const& res,
                            .max_iterations        = params.max_iterations,
                            .termination_threshold = params.termination_threshold};
 
-  GNND<const T, int> nnd(res, build_config);
-  nnd.build(dataset.data_handle(), dataset.extent(0), int_graph.data_handle());
+  if (host_backend) {
+    RAFT_EXPECTS(Accessor::is_host_accessible,
+                 "The CPU backend of NN-descent needs a dataset in host memory");
+    RAFT_LOG_DEBUG("Building the NN-descent graph on the CPU");
+    GNNDHost<const T, int> nnd(build_config);
+    nnd.build(dataset.data_handle(), dataset.extent(0), int_graph.data_handle());
+  } else {
+    GNND<const T, int> nnd(res, build_config);
+    nnd.build(dataset.data_handle(), dataset.extent(0), int_graph.data_handle());
+  }
 
 #pragma omp parallel for
   for (size_t i = 0; i < static_cast<size_t>(dataset.extent(0)); i++) {
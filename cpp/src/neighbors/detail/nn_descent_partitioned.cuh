@@ -0,0 +1,600 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../core/mmap.hpp"
+#include "../../distance/detail/host_distance.hpp"
+#include "../../distance/detail/host_distance_tile.hpp"
+#include "nn_descent.cuh"
+
+#include <cuvs/neighbors/nn_descent.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/host_mdspan.hpp>
+#include <raft/core/logger.hpp>
+#include <raft/core/resources.hpp>
+
+#include <fcntl.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/*
+ * Partitioned (out-of-core) NN-descent.
+ *
+ * The rows are clustered with k-means on a sample, and every row is assigned to its
+ * `partition_overlap` closest clusters, so that the neighbors of the rows near the boundary of a
+ * cluster are found in the others. NN-descent builds the kNN graph of one partition at a time, and the lists of the partitions
+ * are merged into the global graph: only the rows of one partition are in memory at a time.
+ *
+ * The dataset is read through a row reader, either from host memory or from a file.
+ */
+namespace cuvs::neighbors::nn_descent::detail {
+
+/** Number of closest centers considered per row, for rows whose closest partitions are full. */
+constexpr size_t kPartitionCandidates = 4;
+/** Maximum size of a partition, relative to the mean size. */
+constexpr double kPartitionMaxSizeRatio = 2.0;
+/** Rows of the k-means sample per partition. */
+constexpr size_t kSampleRowsPerPartition = 256;
+constexpr int kKmeansIterations          = 10;
+/** Rows per block of the passes over the whole dataset. */
+constexpr size_t kRowBlock = 65536;
+
+/** The rows of a dataset in host memory. */
+template <typename T>
+class memory_row_reader {
+ public:
+  using value_type = T;
+
+  memory_row_reader(const T* data, size_t n_rows, size_t dim)
+    : data_(data), n_rows_(n_rows), dim_(dim)
+  {
+  }
+
+  [[nodiscard]] auto n_rows() const noexcept -> size_t { return n_rows_; }
+  [[nodiscard]] auto dim() const noexcept -> size_t { return dim_; }
+
+  /** Copy the rows [first_row, first_row + n) to `out`. */
+  void read_block(size_t first_row, size_t n, T* out) const
+  {
+    std::memcpy(out, data_ + first_row * dim_, n * dim_ * sizeof(T));
+  }
+
+  /** Copy the given rows, in increasing order, to `out`. */
+  void read_rows(const uint32_t* rows, size_t n, T* out) const
+  {
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(n); i++) {
+      std::memcpy(out + i * dim_, data_ + size_t(rows[i]) * dim_, dim_ * sizeof(T));
+    }
+  }
+
+ private:
+  const T* data_;
+  size_t n_rows_;
+  size_t dim_;
+};
+
+/**
+ * The rows of a dataset in a file, read with `pread` by all the threads.
+ *
+ * `read_rows` reads the sorted rows of a partition in extents: rows closer than `kMaxGapBytes` to
+ * each other are read with one call, through a buffer, together with the rows in between.
+ */
+template <typename T>
+class file_row_reader {
+ public:
+  using value_type = T;
+
+  static constexpr size_t kMaxGapBytes    = size_t{64} << 10;
+  static constexpr size_t kMaxExtentBytes = size_t{4} << 20;
+  static constexpr size_t kChunkBytes     = size_t{16} << 20;
+
+  explicit file_row_reader(const file_dataset<T>& dataset)
+    : file_(dataset.path, O_RDONLY | O_CLOEXEC),
+      n_rows_(dataset.n_rows),
+      dim_(dataset.dim),
+      offset_(dataset.offset)
+  {
+    RAFT_EXPECTS(dataset.n_rows > 0 && dataset.dim > 0, "The dataset must not be empty");
+    RAFT_EXPECTS(file_.size() >= offset_ + n_rows_ * row_bytes(),
+                 "The file %s is too small for a [%ld, %ld] dataset from offset %lu",
+                 dataset.path.c_str(),
+                 dataset.n_rows,
+                 dataset.dim,
+                 dataset.offset);
+  }
+
+  [[nodiscard]] auto n_rows() const noexcept -> size_t { return n_rows_; }
+  [[nodiscard]] auto dim() const noexcept -> size_t { return dim_; }
+
+  /** Read the rows [first_row, first_row + n) to `out`. */
+  void read_block(size_t first_row, size_t n, T* out) const
+  {
+    auto* bytes           = reinterpret_cast<char*>(out);
+    const size_t total    = n * row_bytes();
+    const uint64_t origin = offset_ + first_row * row_bytes();
+    const auto n_chunks   = static_cast<int64_t>((total + kChunkBytes - 1) / kChunkBytes);
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t c = 0; c < n_chunks; c++) {
+      const size_t begin = size_t(c) * kChunkBytes;
+      file_.pread_all(bytes + begin, std::min(kChunkBytes, total - begin), origin + begin);
+    }
+  }
+
+  /** Read the given rows, in increasing order, to `out`. */
+  void read_rows(const uint32_t* rows, size_t n, T* out) const
+  {
+    // Extents of rows read with one call: [first index in `rows`, last index + 1).
+    std::vector<std::pair<size_t, size_t>> extents;
+    const size_t max_gap_rows    = std::max<size_t>(1, kMaxGapBytes / row_bytes());
+    const size_t max_extent_rows = std::max<size_t>(1, kMaxExtentBytes / row_bytes());
+    for (size_t i = 0; i < n;) {
+      size_t j = i + 1;
+      while (j < n && rows[j] - rows[j - 1] <= max_gap_rows &&
+             rows[j] - rows[i] < max_extent_rows) {
+        j++;
+      }
+      extents.emplace_back(i, j);
+      i = j;
+    }
+
+#pragma omp parallel
+    {
+      std::vector<char> buffer;
+#pragma omp for schedule(dynamic)
+      for (int64_t e = 0; e < static_cast<int64_t>(extents.size()); e++) {
+        const auto [begin, end] = extents[e];
+        const size_t first_row  = rows[begin];
+        const size_t n_span     = rows[end - 1] - first_row + 1;
+        if (n_span == end - begin) {
+          read_block_serial(first_row, n_span, out + begin * dim_);
+          continue;
+        }
+        buffer.resize(n_span * row_bytes());
+        file_.pread_all(buffer.data(), buffer.size(), offset_ + first_row * row_bytes());
+        for (size_t i = begin; i < end; i++) {
+          std::memcpy(
+            out + i * dim_, buffer.data() + (rows[i] - first_row) * row_bytes(), row_bytes());
+        }
+      }
+    }
+  }
+
+ private:
+  cuvs::core::detail::file_descriptor file_;
+  size_t n_rows_;
+  size_t dim_;
+  uint64_t offset_;
+
+  [[nodiscard]] auto row_bytes() const noexcept -> size_t { return dim_ * sizeof(T); }
+
+  void read_block_serial(size_t first_row, size_t n, T* out) const
+  {
+    file_.pread_all(out, n * row_bytes(), offset_ + first_row * row_bytes());
+  }
+};
+
+/**
+ * The `n_closest` closest centers of each of `n_rows` rows (in increasing order of distance).
+ *
+ * @param[in] rows [n_rows, dim]
+ * @param[in] centers [n_centers, dim]
+ * @param[in] center_norms squared norms of the centers [n_centers]
+ * @param[out] closest [n_rows, n_closest]
+ */
+inline void closest_centers(const float* rows,
+                            size_t n_rows,
+                            const float* centers,
+                            const float* center_norms,
+                            size_t n_centers,
+                            size_t dim,
+                            size_t n_closest,
+                            uint32_t* closest)
+{
+  constexpr size_t kTileRows = 64;
+  const auto tile_kernel     = cuvs::distance::detail::host::get_inner_product_tile_kernel();
+  const auto n_tiles         = static_cast<int64_t>((n_rows + kTileRows - 1) / kTileRows);
+#pragma omp parallel
+  {
+    std::vector<float> tile(kTileRows * n_centers);
+    std::vector<std::pair<float, uint32_t>> best;
+#pragma omp for schedule(dynamic)
+    for (int64_t t = 0; t < n_tiles; t++) {
+      const size_t r0 = size_t(t) * kTileRows;
+      const size_t nr = std::min(kTileRows, n_rows - r0);
+      tile_kernel(rows + r0 * dim, nr, centers, n_centers, dim, tile.data(), n_centers);
+      for (size_t r = 0; r < nr; r++) {
+        // The norm of the row does not change the order of the centers.
+        best.assign(n_closest, {std::numeric_limits<float>::max(), 0});
+        for (size_t c = 0; c < n_centers; c++) {
+          const float dist = center_norms[c] - 2.0f * tile[r * n_centers + c];
+          if (dist >= best.back().first) { continue; }
+          size_t pos = n_closest - 1;
+          for (; pos > 0 && best[pos - 1].first > dist; pos--) {
+            best[pos] = best[pos - 1];
+          }
+          best[pos] = {dist, static_cast<uint32_t>(c)};
+        }
+        for (size_t j = 0; j < n_closest; j++) {
+          closest[(r0 + r) * n_closest + j] = best[j].second;
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void convert_to_float(const T* in, size_t n, float* out)
+{
+  using cuvs::distance::detail::host::to_float;
+#pragma omp parallel for
+  for (int64_t i = 0; i < static_cast<int64_t>(n); i++) {
+    out[i] = to_float(in[i]);
+  }
+}
+
+/** Cluster a sample of the rows with k-means; returns the centers [n_centers, dim]. */
+template <typename Reader>
+auto fit_partition_centers(const Reader& reader, size_t n_centers) -> std::vector<float>
+{
+  using T          = typename Reader::value_type;
+  const size_t dim = reader.dim();
+
+  std::mt19937_64 rng(137);
+  const size_t n_sample = std::min(reader.n_rows(), n_centers * kSampleRowsPerPartition);
+  std::vector<uint32_t> sample_rows(n_sample);
+  {
+    // Every row with equal probability, in increasing order.
+    if (n_sample == reader.n_rows()) {
+      std::iota(sample_rows.begin(), sample_rows.end(), 0);
+    } else {
+      std::uniform_int_distribution<uint64_t> pick(0, reader.n_rows() - 1);
+      std::vector<uint8_t> taken(reader.n_rows(), 0);
+      for (size_t i = 0; i < n_sample;) {
+        const auto row = pick(rng);
+        if (!taken[row]) {
+          taken[row]       = 1;
+          sample_rows[i++] = static_cast<uint32_t>(row);
+        }
+      }
+      std::sort(sample_rows.begin(), sample_rows.end());
+    }
+  }
+  std::vector<float> sample(n_sample * dim);
+  {
+    std::vector<T> raw(n_sample * dim);
+    reader.read_rows(sample_rows.data(), n_sample, raw.data());
+    convert_to_float(raw.data(), raw.size(), sample.data());
+  }
+
+  std::vector<float> centers(n_centers * dim);
+  std::vector<float> center_norms(n_centers);
+  std::vector<uint32_t> labels(n_sample);
+  std::vector<size_t> sizes(n_centers);
+  std::uniform_int_distribution<size_t> pick_sample(0, n_sample - 1);
+  for (size_t c = 0; c < n_centers; c++) {
+    const size_t row = n_sample >= n_centers ? c * (n_sample / n_centers) : pick_sample(rng);
+    std::copy(
+      sample.begin() + row * dim, sample.begin() + (row + 1) * dim, centers.begin() + c * dim);
+  }
+
+  const auto norm = cuvs::distance::detail::host::get_distance_kernels<float>().inner_product;
+  for (int it = 0; it < kKmeansIterations; it++) {
+    for (size_t c = 0; c < n_centers; c++) {
+      center_norms[c] = norm(centers.data() + c * dim, centers.data() + c * dim, dim);
+    }
+    closest_centers(sample.data(),
+                    n_sample,
+                    centers.data(),
+                    center_norms.data(),
+                    n_centers,
+                    dim,
+                    1,
+                    labels.data());
+    std::fill(centers.begin(), centers.end(), 0.0f);
+    std::fill(sizes.begin(), sizes.end(), 0);
+    for (size_t i = 0; i < n_sample; i++) {
+      float* center = centers.data() + size_t(labels[i]) * dim;
+      for (size_t k = 0; k < dim; k++) {
+        center[k] += sample[i * dim + k];
+      }
+      sizes[labels[i]]++;
+    }
+    for (size_t c = 0; c < n_centers; c++) {
+      float* center = centers.data() + c * dim;
+      if (sizes[c] == 0) {
+        // An empty cluster restarts from a random row of the sample.
+        const size_t row = pick_sample(rng);
+        std::copy(sample.begin() + row * dim, sample.begin() + (row + 1) * dim, center);
+        continue;
+      }
+      for (size_t k = 0; k < dim; k++) {
+        center[k] /= static_cast<float>(sizes[c]);
+      }
+    }
+  }
+  return centers;
+}
+
+/**
+ * The rows of every partition, in increasing order.
+ *
+ * Each row goes to its `overlap` closest partitions that are not full yet, among its
+ * `kPartitionCandidates` closest; a row whose candidates are all full goes to its closest one.
+ */
+template <typename Reader>
+auto assign_partitions(const Reader& reader,
+                       const std::vector<float>& centers,
+                       size_t n_partitions,
+                       size_t overlap) -> std::vector<std::vector<uint32_t>>
+{
+  using T                   = typename Reader::value_type;
+  const size_t dim          = reader.dim();
+  const size_t n_rows       = reader.n_rows();
+  const size_t n_candidates = std::min(n_partitions, std::max(overlap, kPartitionCandidates));
+  const auto max_size =
+    static_cast<size_t>(kPartitionMaxSizeRatio * double(overlap) * double(n_rows) /
+                        double(n_partitions)) +
+    1;
+
+  const auto norm = cuvs::distance::detail::host::get_distance_kernels<float>().inner_product;
+  std::vector<float> center_norms(n_partitions);
+  for (size_t c = 0; c < n_partitions; c++) {
+    center_norms[c] = norm(centers.data() + c * dim, centers.data() + c * dim, dim);
+  }
+
+  std::vector<std::vector<uint32_t>> members(n_partitions);
+  std::vector<T> raw(std::min(kRowBlock, n_rows) * dim);
+  std::vector<float> block(raw.size());
+  std::vector<uint32_t> closest(std::min(kRowBlock, n_rows) * n_candidates);
+  for (size_t first = 0; first < n_rows; first += kRowBlock) {
+    const size_t n = std::min(kRowBlock, n_rows - first);
+    reader.read_block(first, n, raw.data());
+    convert_to_float(raw.data(), n * dim, block.data());
+    closest_centers(block.data(),
+                    n,
+                    centers.data(),
+                    center_norms.data(),
+                    n_partitions,
+                    dim,
+                    n_candidates,
+                    closest.data());
+    for (size_t i = 0; i < n; i++) {
+      const uint32_t* candidates = closest.data() + i * n_candidates;
+      size_t n_assigned          = 0;
+      for (size_t j = 0; j < n_candidates && n_assigned < overlap; j++) {
+        auto& partition = members[candidates[j]];
+        if (partition.size() < max_size) {
+          partition.push_back(static_cast<uint32_t>(first + i));
+          n_assigned++;
+        }
+      }
+      if (n_assigned == 0) { members[candidates[0]].push_back(static_cast<uint32_t>(first + i)); }
+    }
+  }
+  return members;
+}
+
+/**
+ * The exact kNN lists of the rows of a small partition (without the rows themselves).
+ *
+ * @param[in] rows [n_rows, dim]
+ * @param[out] neighbors [n_rows, k]
+ * @param[out] distances [n_rows, k]
+ */
+inline void exact_partition_knn(
+  const float* rows, size_t n_rows, size_t dim, size_t k, uint32_t* neighbors, float* distances)
+{
+  using namespace cuvs::distance::detail::host;
+  const auto tile_kernel = get_inner_product_tile_kernel();
+  const auto norm        = get_distance_kernels<float>().inner_product;
+  std::vector<float> norms(n_rows);
+  for (size_t i = 0; i < n_rows; i++) {
+    norms[i] = norm(rows + i * dim, rows + i * dim, dim);
+  }
+#pragma omp parallel
+  {
+    std::vector<float> products(n_rows);
+    std::vector<std::pair<float, uint32_t>> list;
+#pragma omp for schedule(dynamic)
+    for (int64_t i = 0; i < static_cast<int64_t>(n_rows); i++) {
+      tile_kernel(rows + i * dim, 1, rows, n_rows, dim, products.data(), n_rows);
+      list.clear();
+      for (size_t j = 0; j < n_rows; j++) {
+        if (j == size_t(i)) { continue; }
+        list.emplace_back(norms[i] + norms[j] - 2.0f * products[j], static_cast<uint32_t>(j));
+      }
+      const size_t n = std::min(k, list.size());
+      std::partial_sort(list.begin(), list.begin() + n, list.end());
+      for (size_t j = 0; j < k; j++) {
+        neighbors[i * k + j] = j < n ? list[j].second : std::numeric_limits<uint32_t>::max();
+        distances[i * k + j] = j < n ? list[j].first : std::numeric_limits<float>::max();
+      }
+    }
+  }
+}
+
+/**
+ * Merge a sorted list of candidates into a sorted kNN list of width `k`, skipping the ids already
+ * in the list. Missing neighbors have the id `max()` and the distance `max()`.
+ */
+inline void merge_knn_list(uint32_t* ids,
+                           float* dists,
+                           const uint32_t* new_ids,
+                           const float* new_dists,
+                           size_t n_new,
+                           size_t k,
+                           std::vector<std::pair<float, uint32_t>>& merged)
+{
+  merged.clear();
+  size_t i = 0;
+  size_t j = 0;
+  while (merged.size() < k && (i < k || j < n_new)) {
+    const bool take_old =
+      j >= n_new || (i < k && (dists[i] < new_dists[j] ||
+                               (dists[i] == new_dists[j] && ids[i] <= new_ids[j])));
+    const auto item = take_old ? std::make_pair(dists[i], ids[i])
+                               : std::make_pair(new_dists[j], new_ids[j]);
+    take_old ? i++ : j++;
+    if (item.second == std::numeric_limits<uint32_t>::max()) { continue; }
+    if (std::any_of(
+          merged.begin(), merged.end(), [&](const auto& m) { return m.second == item.second; })) {
+      continue;
+    }
+    merged.push_back(item);
+  }
+  for (size_t m = 0; m < k; m++) {
+    ids[m]   = m < merged.size() ? merged[m].second : std::numeric_limits<uint32_t>::max();
+    dists[m] = m < merged.size() ? merged[m].first : std::numeric_limits<float>::max();
+  }
+}
+
+/**
+ * Build the kNN graph of `idx` partition by partition.
+ *
+ * The graph degree is that of `idx`. The partitions are built with `build` (NN-descent, on the
+ * device or on the CPU), or exactly when they are too small for it.
+ */
+template <typename Reader, typename IdxT>
+void build_partitioned(raft::resources const& res,
+                       const index_params& params,
+                       const Reader& reader,
+                       index<IdxT>& idx)
+{
+  using T             = typename Reader::value_type;
+  const size_t n_rows = reader.n_rows();
+  const size_t dim    = reader.dim();
+  const size_t k      = idx.graph_degree();
+  RAFT_EXPECTS(static_cast<size_t>(idx.size()) == n_rows,
+               "The index has %lu rows, the dataset %lu",
+               static_cast<size_t>(idx.size()),
+               n_rows);
+  RAFT_EXPECTS(n_rows < std::numeric_limits<uint32_t>::max(),
+               "The partitioned build supports up to 2^32 - 1 rows");
+  RAFT_EXPECTS(k > 0 && k < n_rows, "The graph degree must be in [1, %lu)", n_rows);
+  RAFT_EXPECTS(params.partition_overlap > 0, "The partition overlap must be positive");
+
+  const size_t n_partitions = std::max<size_t>(1, std::min(params.n_clusters, n_rows));
+  const size_t overlap      = std::min(params.partition_overlap, n_partitions);
+
+  std::vector<std::vector<uint32_t>> members;
+  if (n_partitions == 1) {
+    members.resize(1);
+    members[0].resize(n_rows);
+    std::iota(members[0].begin(), members[0].end(), 0);
+  } else {
+    auto centers = fit_partition_centers(reader, n_partitions);
+    members      = assign_partitions(reader, centers, n_partitions, overlap);
+  }
+
+  index_params partition_params              = params;
+  partition_params.graph_degree              = k;
+  partition_params.intermediate_graph_degree = std::max(params.intermediate_graph_degree, k);
+  partition_params.n_clusters                = 1;
+  // Partitions up to this size are built exactly, they are too small for NN-descent.
+  const size_t max_exact_rows = 2 * partition_params.intermediate_graph_degree;
+
+  auto* graph = idx.graph().data_handle();
+  std::fill(graph, graph + n_rows * k, std::numeric_limits<IdxT>::max());
+  std::vector<float> graph_dists(n_rows * k, std::numeric_limits<float>::max());
+  const auto l2 = cuvs::distance::detail::host::get_distance_kernels<T>().l2;
+
+  for (size_t p = 0; p < n_partitions; p++) {
+    const auto& rows = members[p];
+    const size_t m   = rows.size();
+    if (m < 2) { continue; }
+    RAFT_LOG_DEBUG("# Partition %lu / %lu: %lu rows", p + 1, n_partitions, m);
+
+    auto data = raft::make_host_matrix<T, int64_t>(m, dim);
+    reader.read_rows(rows.data(), m, data.data_handle());
+
+    const size_t local_k = std::min(k, m - 1);
+    std::vector<uint32_t> local_ids(m * local_k);
+    std::vector<float> local_dists(m * local_k);
+    if (m <= max_exact_rows) {
+      std::vector<float> rows_f(m * dim);
+      convert_to_float(data.data_handle(), m * dim, rows_f.data());
+      exact_partition_knn(rows_f.data(), m, dim, local_k, local_ids.data(), local_dists.data());
+    } else {
+      index<uint32_t> local_idx{res, static_cast<int64_t>(m), static_cast<int64_t>(local_k)};
+      build(res, partition_params, raft::make_const_mdspan(data.view()), local_idx);
+      std::copy(local_idx.graph().data_handle(),
+                local_idx.graph().data_handle() + m * local_k,
+                local_ids.begin());
+      // NN-descent returns the neighbors sorted, without their distances.
+#pragma omp parallel for
+      for (int64_t i = 0; i < static_cast<int64_t>(m); i++) {
+        for (size_t j = 0; j < local_k; j++) {
+          local_dists[i * local_k + j] =
+            l2(data.data_handle() + i * dim,
+               data.data_handle() + size_t(local_ids[i * local_k + j]) * dim,
+               dim);
+        }
+      }
+    }
+
+    // A row is in one partition at a time, so the threads merge into different lists.
+#pragma omp parallel
+    {
+      std::vector<uint32_t> ids(k);
+      std::vector<std::pair<float, uint32_t>> merged;
+#pragma omp for
+      for (int64_t i = 0; i < static_cast<int64_t>(m); i++) {
+        uint32_t* local = local_ids.data() + i * local_k;
+        for (size_t j = 0; j < local_k; j++) {
+          if (local[j] < m) { local[j] = rows[local[j]]; }
+        }
+        const size_t row = rows[i];
+        for (size_t j = 0; j < k; j++) {
+          ids[j] = static_cast<uint32_t>(graph[row * k + j]);
+        }
+        merge_knn_list(ids.data(),
+                       graph_dists.data() + row * k,
+                       local,
+                       local_dists.data() + i * local_k,
+                       local_k,
+                       k,
+                       merged);
+        for (size_t j = 0; j < k; j++) {
+          graph[row * k + j] = static_cast<IdxT>(ids[j]);
+        }
+      }
+    }
+  }
+
+  // As in GNND, the missing neighbors are replaced with random rows.
+#pragma omp parallel for
+  for (int64_t i = 0; i < static_cast<int64_t>(n_rows); i++) {
+    for (size_t j = 0; j < k; j++) {
+      const size_t idx_in_graph = i * k + j;
+      if (graph[idx_in_graph] == std::numeric_limits<IdxT>::max()) {
+        graph[idx_in_graph] = static_cast<IdxT>(
+          cuvs::neighbors::cagra::detail::device::xorshift64(idx_in_graph) % n_rows);
+      }
+    }
+  }
+}
+
+}  // namespace cuvs::neighbors::nn_descent::detail
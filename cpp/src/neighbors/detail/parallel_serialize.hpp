@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../../core/mmap.hpp"
+#include "container_serialize.hpp"
+
+#include <raft/core/error.hpp>
+#include <raft/core/resource/cuda_stream.hpp>
+#include <raft/core/resource/cuda_stream_pool.hpp>
+#include <raft/core/resource/device_id.hpp>
+#include <raft/core/resources.hpp>
+#include <raft/util/cuda_rt_essentials.hpp>
+
+#include <omp.h>
+
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cuvs::neighbors::detail {
+
+/*
+ * Parallel serialization of the many same-named sections of a container file (the lists of the
+ * IVF indexes).
+ *
+ * The writer encodes the sections of a batch on the OpenMP threads, each thread copying from the
+ * device on its own stream of the stream pool (if there is one), then assigns them consecutive
+ * offsets and writes them to the file with `pwrite`, again from all threads. The size of a batch is
+ * bounded by `kParallelIoBatchBytes` of staged payload. The file layout is the same as the one
+ * written sequentially through a stream.
+ *
+ * The reader maps the file, locates the sections through the table of contents and decodes them
+ * concurrently.
+ */
+
+/** Upper bound of the payload staged in memory by a batch of the parallel writer. */
+constexpr size_t kParallelIoBatchBytes = size_t(1) << 30;
+
+/**
+ * Run `f(const raft::resources& worker, size_t i)` for all `i < n` on the OpenMP threads.
+ *
+ * Every thread gets a copy of `res` on its own stream of the pool (the main stream if there is no
+ * pool) and the device of `res`. The first exception thrown is rethrown once all threads are done.
+ */
+template <typename F>
+void parallel_for_with_streams(const raft::resources& res, size_t n, F&& f)
+{
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  std::atomic<bool> failed{false};
+  const int device = raft::resource::get_device_id(res);
+#pragma omp parallel
+  {
+    raft::resources worker(res);
+    try {
+      RAFT_CUDA_TRY(cudaSetDevice(device));
+      raft::resource::set_cuda_stream(
+        worker, raft::resource::get_next_usable_stream(res, omp_get_thread_num()));
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) { error = std::current_exception(); }
+      failed = true;
+    }
+#pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < n; i++) {
+      if (failed) { continue; }
+      try {
+        f(static_cast<const raft::resources&>(worker), i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) { error = std::current_exception(); }
+        failed = true;
+      }
+    }
+  }
+  if (error) { std::rethrow_exception(error); }
+}
+
+/**
+ * Write the sections `name` (ids `0 .. n_sections - 1`) in parallel after the sections already in
+ * `writer`, into `file`, the file behind the output stream of the writer.
+ *
+ * @param encoding the compression of the payloads (see section_codec.hpp)
+ * @param estimate_bytes callable `size_t(uint64_t id)`, the approximate size of a payload
+ * @param write_payload callable `void(const raft::resources& worker, uint64_t id, std::ostream&)`,
+ *   called concurrently for different ids
+ */
+template <typename EstimateBytes, typename WritePayload>
+void write_sections_parallel(const raft::resources& res,
+                             container_writer& writer,
+                             const core::detail::file_descriptor& file,
+                             std::string_view name,
+                             uint64_t n_sections,
+                             uint32_t flags,
+                             const section_encoding& encoding,
+                             EstimateBytes&& estimate_bytes,
+                             WritePayload&& write_payload)
+{
+  if (encoding.enabled()) { flags |= kSectionEncoded; }
+  std::vector<std::string> staged;
+  std::vector<section_header> headers;
+  for (uint64_t first = 0; first < n_sections;) {
+    uint64_t last = first;
+    size_t bytes  = 0;
+    while (last < n_sections && (last == first || bytes < kParallelIoBatchBytes)) {
+      bytes += estimate_bytes(last++);
+    }
+    const size_t n = last - first;
+    staged.assign(n, std::string{});
+    headers.assign(n, section_header{});
+
+    // Encode: the staged buffer holds the section header, patched afterwards, and the payload.
+    parallel_for_with_streams(res, n, [&](const raft::resources& worker, size_t i) {
+      auto& h = headers[i];
+      set_container_name(h.name, name);
+      h.id    = first + i;
+      h.flags = flags;
+      std::stringbuf staging(std::ios::out | std::ios::binary);
+      staging.sputn(reinterpret_cast<const char*>(&h), sizeof(h));
+      section_writebuf buf(&staging);
+      bool good = false;
+      if (encoding.enabled()) {
+        encoding_writebuf encoder(&buf, encoding);
+        std::ostream payload(&encoder);
+        write_payload(worker, h.id, payload);
+        encoder.finish();
+        good = payload.good() && !encoder.failed();
+      } else {
+        std::ostream payload(&buf);
+        write_payload(worker, h.id, payload);
+        good = payload.good();
+      }
+      RAFT_EXPECTS(good && !buf.failed(),
+                   "Error writing section '%s' (id %lu)",
+                   std::string(name).c_str(),
+                   static_cast<unsigned long>(h.id));
+      h.size     = buf.size();
+      h.checksum = buf.checksum();
+      staged[i]  = staging.str();
+      std::memcpy(staged[i].data(), &h, sizeof(h));
+    });
+
+    // Write: the offsets follow from the sizes of the encoded sections.
+    std::vector<uint64_t> offsets(n);
+    uint64_t offset = writer.external_offset();
+    for (size_t i = 0; i < n; i++) {
+      offsets[i] = offset;
+      offset += staged[i].size();
+    }
+    parallel_for_with_streams(res, n, [&](const raft::resources&, size_t i) {
+      file.pwrite_all(staged[i].data(), staged[i].size(), offsets[i]);
+      std::string{}.swap(staged[i]);
+    });
+    writer.add_external_sections(headers);
+    first = last;
+  }
+}
+
+/**
+ * Read the sections of a container file through its table of contents.
+ *
+ * The sections named `parallel_name` are read last and concurrently, the others before them and
+ * in order.
+ *
+ * @param visit callable `bool(const section_info&, std::istream& payload, const raft::resources&)`,
+ *   see `container_reader::read_sections`; the resources are those of the calling thread.
+ */
+template <typename Visitor>
+void read_sections_parallel(const raft::resources& res,
+                            const std::string& filename,
+                            std::istream& is,
+                            const container_toc& toc,
+                            std::string_view parallel_name,
+                            Visitor&& visit)
+{
+  std::vector<const section_info*> parallel;
+  for (const auto& s : toc.sections) {
+    if (s.is(parallel_name)) {
+      parallel.push_back(&s);
+      continue;
+    }
+    bool handled = false;
+    read_container_section(
+      is, toc, s, [&](std::istream& payload) { handled = visit(s, payload, res); });
+    container_detail::check_section_handled(s, handled);
+  }
+  if (parallel.empty()) { return; }
+
+  core::detail::mapped_file file(filename);
+  const auto begin = static_cast<uint64_t>(std::streamoff(toc.begin));
+  parallel_for_with_streams(res, parallel.size(), [&](const raft::resources& worker, size_t i) {
+    const auto& s = *parallel[i];
+    auto offset   = begin + s.offset;
+    RAFT_EXPECTS(offset + sizeof(section_header) + s.size <= file.size(),
+                 "Truncated index file (section '%s', id %lu)",
+                 s.name.c_str(),
+                 static_cast<unsigned long>(s.id));
+    section_header h{};
+    std::memcpy(&h, file.data() + offset, sizeof(h));
+    container_detail::check_section_header(h, s);
+    file.advise(offset, sizeof(h) + s.size, MADV_WILLNEED);
+    memory_readbuf buf(file.data() + offset + sizeof(h), s.size);
+    std::istream section(&buf);
+    auto handled = container_detail::read_section_payload(
+      section, s, [&](std::istream& payload) { return visit(s, payload, worker); });
+    container_detail::check_section_handled(s, handled);
+  });
+}
+
+}  // namespace cuvs::neighbors::detail
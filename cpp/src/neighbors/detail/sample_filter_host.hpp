@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cuvs/core/bitset.hpp>
+#include <cuvs/neighbors/common.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Bitset prefilters of the host searches.
+ *
+ * A filtered search first counts the rows the bitset admits. When the filter is selective enough,
+ * scanning only the admitted rows is both cheaper and more accurate than the ANN search: the ANN
+ * search computes the distances to about the same number of rows whatever the filter, and meets
+ * fewer and fewer admitted rows (down to fewer than k) as the filter gets more selective.
+ */
+namespace cuvs::neighbors::filtering::detail {
+
+/** The filter of the unfiltered host searches, which admits every row. */
+struct host_admit_all {
+  constexpr auto operator()(int64_t) const noexcept -> bool { return true; }
+};
+
+/**
+ * A bitset in host memory, read without the device helpers of `bitset_view`: bit `i` set means
+ * that row `i` is admitted. Rows beyond the bitset size are not admitted.
+ */
+template <typename bitset_t, typename index_t>
+class host_bitset {
+ public:
+  static constexpr size_t kBits = sizeof(bitset_t) * 8;
+
+  explicit host_bitset(const cuvs::core::bitset_view<bitset_t, index_t>& view)
+    : data_(view.data()), size_(view.size())
+  {
+  }
+
+  [[nodiscard]] inline auto size() const noexcept -> size_t { return size_; }
+
+  [[nodiscard]] inline auto test(size_t i) const noexcept -> bool
+  {
+    return i < size_ && ((data_[i / kBits] >> (i % kBits)) & bitset_t{1});
+  }
+
+  inline auto operator()(int64_t i) const noexcept -> bool { return test(static_cast<size_t>(i)); }
+
+  /** Number of admitted rows (population count of the bitset). */
+  [[nodiscard]] auto count() const -> size_t
+  {
+    const int64_t n_words = size_ / kBits;
+    size_t total          = 0;
+#pragma omp parallel for reduction(+ : total) schedule(static) if (n_words > (int64_t{1} << 16))
+    for (int64_t w = 0; w < n_words; w++) {
+      total += popcount(data_[w]);
+    }
+    if (size_ % kBits != 0) {
+      total += popcount(data_[n_words] & ((bitset_t{1} << (size_ % kBits)) - 1));
+    }
+    return total;
+  }
+
+  /** The admitted rows, in increasing order. */
+  [[nodiscard]] auto admitted_rows() const -> std::vector<int64_t>
+  {
+    std::vector<int64_t> rows;
+    rows.reserve(count());
+    const size_t n_words = (size_ + kBits - 1) / kBits;
+    for (size_t w = 0; w < n_words; w++) {
+      auto word = static_cast<uint64_t>(data_[w]);
+      if (w + 1 == n_words && size_ % kBits != 0) { word &= (uint64_t{1} << (size_ % kBits)) - 1; }
+      while (word != 0) {
+        rows.push_back(static_cast<int64_t>(w * kBits + __builtin_ctzll(word)));
+        word &= word - 1;
+      }
+    }
+    return rows;
+  }
+
+ private:
+  const bitset_t* data_;
+  size_t size_;
+
+  static inline auto popcount(bitset_t word) -> size_t
+  {
+    return __builtin_popcountll(static_cast<uint64_t>(word));
+  }
+};
+
+/**
+ * Whether a filtered search should scan the admitted rows instead of running the ANN search with
+ * the filter applied.
+ *
+ * @param n_admitted number of rows admitted by the filter
+ * @param n_rows number of rows of the index
+ * @param ann_rows estimated number of rows the ANN search computes a distance to, per query
+ * @param k number of neighbors to find
+ *
+ * The scan is chosen when it computes fewer distances than the ANN search, or when the ANN search
+ * is expected to meet fewer than `k` admitted rows and would return incomplete results.
+ */
+inline auto prefer_admitted_scan(size_t n_admitted, size_t n_rows, size_t ann_rows, size_t k)
+  -> bool
+{
+  if (n_admitted <= ann_rows) { return true; }
+  return double(ann_rows) * double(n_admitted) < double(k) * double(n_rows);
+}
+
+/**
+ * The admitted rows of the lists of a host IVF index, grouped like the list data.
+ *
+ * `groups[label]` holds a (group, mask) pair for every group of rows of the list with at least one
+ * admitted row: bit `j` of the mask is set if row `group * GroupSize + j` is admitted. `labels`
+ * are the lists with at least one admitted row.
+ */
+template <uint32_t GroupSize>
+struct ivf_admitted_groups {
+  static_assert(GroupSize <= 32, "The group masks are 32-bit");
+
+  std::vector<uint32_t> labels;
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> groups;
+
+  /**
+   * The source indices of all the lists are read, hence the index must be resident: building the
+   * groups of an index whose lists are loaded on demand would load all of them.
+   *
+   * @param n_lists number of lists of the index
+   * @param list_sizes sizes of the lists [n_lists]
+   * @param list_indices `(uint32_t label) -> const IdxT*`, the source indices of the rows of a
+   *        list
+   * @param admit `(IdxT source_index) -> bool`
+   */
+  template <typename ListIndices, typename Admit>
+  ivf_admitted_groups(uint32_t n_lists,
+                      const uint32_t* list_sizes,
+                      ListIndices list_indices,
+                      Admit admit)
+    : groups(n_lists)
+  {
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t label = 0; label < int64_t(n_lists); label++) {
+      const uint32_t list_size = list_sizes[label];
+      if (list_size == 0) { continue; }
+      const auto* rows  = list_indices(uint32_t(label));
+      auto& list_groups = groups[label];
+      for (uint32_t group = 0; group < list_size; group += GroupSize) {
+        const uint32_t n = std::min<uint32_t>(GroupSize, list_size - group);
+        uint32_t mask    = 0;
+        for (uint32_t j = 0; j < n; j++) {
+          if (admit(rows[group + j])) { mask |= uint32_t{1} << j; }
+        }
+        if (mask != 0) { list_groups.emplace_back(group, mask); }
+      }
+    }
+    for (uint32_t label = 0; label < n_lists; label++) {
+      if (!groups[label].empty()) { labels.push_back(label); }
+    }
+  }
+};
+
+/** Whether a sample filter type is a bitset filter, whose selectivity can be counted. */
+template <typename filter_t>
+struct is_bitset_filter : std::false_type {};
+template <typename bitset_t, typename index_t>
+struct is_bitset_filter<cuvs::neighbors::filtering::bitset_filter<bitset_t, index_t>>
+  : std::true_type {};
+
+}  // namespace cuvs::neighbors::filtering::detail
@@ -0,0 +1,571 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <raft/core/error.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cuvs::neighbors::detail {
+
+/*
+ * Lossless codecs of the section payloads of a container (see container_serialize.hpp).
+ *
+ * An encoded payload starts with a codec_header, followed by blocks of at most
+ * `kCodecBlockBytes` bytes of raw payload, each encoded independently (all integers in native
+ * byte order, like the container):
+ *
+ *   codec_header   codec (u32, a section_codec), element size in bytes (u32)
+ *   blocks         each a codec_block_header followed by `encoded_bytes` bytes
+ *
+ *   codec_block_header   raw_bytes (u32, in [1, kCodecBlockBytes]), encoded_bytes (u32)
+ *
+ * The raw payload is the concatenation of the decoded blocks; the payload ends with the last
+ * block, there is no end marker. Every block but the last one holds the same number of raw
+ * bytes, a multiple of the element size, so that a block does not split an element. A block that
+ * does not shrink is stored as is (`encoded_bytes == raw_bytes`); otherwise
+ * `encoded_bytes < raw_bytes` and the bytes are those of the codec:
+ *
+ *   kDeltaVarint   one varint per whole element of the block, then the trailing
+ *                  `raw_bytes % element_size` bytes as is
+ *   kShuffleLz     the LZ77 sequences (see below) of the byte-shuffled block
+ *
+ * The independent blocks bound the memory of the writer and of the reader, and let the reader
+ * decode them in parallel. The decoder checks every length against the bytes it has and the
+ * bytes it must produce: a truncated or corrupted payload makes it throw a raft::logic_error,
+ * never read or write out of bounds. It cannot detect a payload truncated at a block boundary
+ * or changed bytes that still decode; the container detects these with the size and the
+ * checksum of the section.
+ */
+
+/** The codec of an encoded section. */
+enum class section_codec : uint32_t {
+  /** Not encoded. */
+  kNone = 0,
+  /**
+   * Little-endian integers of `element_size` (4 or 8) bytes, e.g. graph rows: the zigzag-coded
+   * difference to the previous integer as a varint (LEB128). The order of the values is kept.
+   */
+  kDeltaVarint = 1,
+  /**
+   * Vectors of `element_size`-byte values: the bytes are shuffled by their position in the
+   * element, so that similar bytes (e.g. the exponents of floats) become adjacent, then compressed
+   * by an LZ77 coder.
+   */
+  kShuffleLz = 2,
+};
+
+/** How to encode the payload of a section. */
+struct section_encoding {
+  section_codec codec   = section_codec::kNone;
+  uint32_t element_size = 1;
+
+  [[nodiscard]] auto enabled() const noexcept -> bool { return codec != section_codec::kNone; }
+};
+
+constexpr size_t kCodecBlockBytes = size_t(4) << 20;
+
+struct codec_header {
+  uint32_t codec;
+  uint32_t element_size;
+};
+
+struct codec_block_header {
+  uint32_t raw_bytes;
+  uint32_t encoded_bytes;
+};
+static_assert(sizeof(codec_header) == 8 && sizeof(codec_block_header) == 8);
+
+namespace codec_detail {
+
+inline void check_encoding(const section_encoding& e)
+{
+  switch (e.codec) {
+    case section_codec::kNone: break;
+    case section_codec::kDeltaVarint:
+      RAFT_EXPECTS(e.element_size == 4 || e.element_size == 8,
+                   "The delta-varint codec takes 4- or 8-byte integers, got %u bytes",
+                   e.element_size);
+      break;
+    case section_codec::kShuffleLz:
+      RAFT_EXPECTS(e.element_size > 0 && e.element_size <= 256,
+                   "Invalid element size %u of the shuffle-LZ codec",
+                   e.element_size);
+      break;
+    default: RAFT_FAIL("Unknown section codec %u", static_cast<uint32_t>(e.codec));
+  }
+}
+
+template <typename U>
+inline auto load_le(const uint8_t* p) -> U
+{
+  U v;
+  std::memcpy(&v, p, sizeof(U));
+  return v;
+}
+
+template <typename U>
+inline void store_le(uint8_t* p, U v)
+{
+  std::memcpy(p, &v, sizeof(U));
+}
+
+/* -------- delta + varint -------- */
+
+template <typename U>
+inline void delta_varint_encode(const uint8_t* src, size_t n, std::string& out)
+{
+  using S          = std::make_signed_t<U>;
+  const size_t cnt = n / sizeof(U);
+  U prev           = 0;
+  for (size_t i = 0; i < cnt; i++) {
+    U v   = load_le<U>(src + i * sizeof(U));
+    S d   = static_cast<S>(v - prev);
+    U zz  = (static_cast<U>(d) << 1) ^ static_cast<U>(d >> (8 * sizeof(U) - 1));
+    prev  = v;
+    while (zz >= 0x80) {
+      out.push_back(static_cast<char>((zz & 0x7f) | 0x80));
+      zz >>= 7;
+    }
+    out.push_back(static_cast<char>(zz));
+  }
+  out.append(reinterpret_cast<const char*>(src) + cnt * sizeof(U), n - cnt * sizeof(U));
+}
+
+template <typename U>
+inline void delta_varint_decode(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_bytes)
+{
+  const size_t cnt = raw_bytes / sizeof(U);
+  const size_t tail = raw_bytes - cnt * sizeof(U);
+  const uint8_t* end = src + n;
+  U prev             = 0;
+  for (size_t i = 0; i < cnt; i++) {
+    U zz      = 0;
+    int shift = 0;
+    for (;;) {
+      RAFT_EXPECTS(src < end && shift < int(8 * sizeof(U)), "Corrupted delta-varint block");
+      uint8_t b = *src++;
+      zz |= static_cast<U>(b & 0x7f) << shift;
+      if ((b & 0x80) == 0) { break; }
+      shift += 7;
+    }
+    U d  = (zz >> 1) ^ (~(zz & 1) + 1);
+    prev = static_cast<U>(prev + d);
+    store_le<U>(dst + i * sizeof(U), prev);
+  }
+  RAFT_EXPECTS(size_t(end - src) == tail, "Corrupted delta-varint block");
+  std::memcpy(dst + cnt * sizeof(U), src, tail);
+}
+
+/* -------- byte shuffle -------- */
+
+inline void byte_shuffle(const uint8_t* src, size_t n, uint32_t elem, uint8_t* dst)
+{
+  const size_t cnt = n / elem;
+  for (uint32_t b = 0; b < elem; b++) {
+    uint8_t* out = dst + b * cnt;
+    for (size_t i = 0; i < cnt; i++) {
+      out[i] = src[i * elem + b];
+    }
+  }
+  std::memcpy(dst + cnt * elem, src + cnt * elem, n - cnt * elem);
+}
+
+inline void byte_unshuffle(const uint8_t* src, size_t n, uint32_t elem, uint8_t* dst)
+{
+  const size_t cnt = n / elem;
+  for (uint32_t b = 0; b < elem; b++) {
+    const uint8_t* in = src + b * cnt;
+    for (size_t i = 0; i < cnt; i++) {
+      dst[i * elem + b] = in[i];
+    }
+  }
+  std::memcpy(dst + cnt * elem, src + cnt * elem, n - cnt * elem);
+}
+
+/* -------- LZ77 --------
+ *
+ * A sequence is a token (literal count in the high nibble, match length - kLzMinMatch in the low
+ * nibble, 15 meaning that the count continues in the following bytes, 255 at a time), the
+ * literals, and the two-byte distance of the match. The last sequence has literals only.
+ */
+
+constexpr size_t kLzMinMatch   = 4;
+constexpr size_t kLzMaxOffset  = 65535;
+constexpr uint32_t kLzHashBits = 14;
+
+inline void lz_put_length(std::string& out, size_t len)
+{
+  for (; len >= 255; len -= 255) {
+    out.push_back(static_cast<char>(255));
+  }
+  out.push_back(static_cast<char>(len));
+}
+
+inline void lz_put_sequence(
+  std::string& out, const uint8_t* literals, size_t n_literals, size_t match_len, size_t offset)
+{
+  const size_t ml = match_len == 0 ? 0 : match_len - kLzMinMatch;
+  out.push_back(
+    static_cast<char>((std::min<size_t>(n_literals, 15) << 4) | std::min<size_t>(ml, 15)));
+  if (n_literals >= 15) { lz_put_length(out, n_literals - 15); }
+  out.append(reinterpret_cast<const char*>(literals), n_literals);
+  if (match_len == 0) { return; }
+  out.push_back(static_cast<char>(offset & 0xff));
+  out.push_back(static_cast<char>(offset >> 8));
+  if (ml >= 15) { lz_put_length(out, ml - 15); }
+}
+
+inline void lz_encode(const uint8_t* src, size_t n, std::string& out)
+{
+  std::vector<uint32_t> table(size_t(1) << kLzHashBits, UINT32_MAX);
+  auto hash = [](uint32_t v) { return (v * 2654435761u) >> (32 - kLzHashBits); };
+  size_t anchor = 0;
+  size_t i      = 0;
+  while (i + kLzMinMatch <= n) {
+    const uint32_t v = load_le<uint32_t>(src + i);
+    const uint32_t h = hash(v);
+    const uint32_t c = table[h];
+    table[h]         = static_cast<uint32_t>(i);
+    if (c == UINT32_MAX || i - c > kLzMaxOffset || load_le<uint32_t>(src + c) != v) {
+      i++;
+      continue;
+    }
+    size_t len = kLzMinMatch;
+    while (i + len < n && src[c + len] == src[i + len]) {
+      len++;
+    }
+    lz_put_sequence(out, src + anchor, i - anchor, len, i - c);
+    i += len;
+    anchor = i;
+  }
+  lz_put_sequence(out, src + anchor, n - anchor, 0, 0);
+}
+
+inline void lz_decode(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_bytes)
+{
+  const uint8_t* end = src + n;
+  size_t o           = 0;
+  auto get_length    = [&](size_t len) {
+    if (len < 15) { return len; }
+    for (;;) {
+      RAFT_EXPECTS(src < end, "Corrupted LZ block");
+      uint8_t b = *src++;
+      len += b;
+      if (b != 255) { return len; }
+    }
+  };
+  for (;;) {
+    RAFT_EXPECTS(src < end, "Corrupted LZ block");
+    const uint8_t token      = *src++;
+    const size_t n_literals  = get_length(token >> 4);
+    RAFT_EXPECTS(n_literals <= size_t(end - src) && n_literals <= raw_bytes - o,
+                 "Corrupted LZ block");
+    std::memcpy(dst + o, src, n_literals);
+    src += n_literals;
+    o += n_literals;
+    if (src == end) { break; }
+    RAFT_EXPECTS(end - src >= 2, "Corrupted LZ block");
+    const size_t offset = size_t(src[0]) | (size_t(src[1]) << 8);
+    src += 2;
+    const size_t len = get_length(token & 0xf) + kLzMinMatch;
+    RAFT_EXPECTS(offset > 0 && offset <= o && len <= raw_bytes - o, "Corrupted LZ block");
+    // The match may overlap the bytes it produces.
+    for (size_t k = 0; k < len; k++, o++) {
+      dst[o] = dst[o - offset];
+    }
+  }
+  RAFT_EXPECTS(o == raw_bytes, "Corrupted LZ block");
+}
+
+/** Encode a block of raw payload, appending it (block header included) to `out`. */
+inline void encode_block(const section_encoding& e,
+                         const uint8_t* src,
+                         size_t n,
+                         std::string& scratch,
+                         std::string& out)
+{
+  scratch.clear();
+  switch (e.codec) {
+    case section_codec::kDeltaVarint:
+      if (e.element_size == 4) {
+        delta_varint_encode<uint32_t>(src, n, scratch);
+      } else {
+        delta_varint_encode<uint64_t>(src, n, scratch);
+      }
+      break;
+    case section_codec::kShuffleLz: {
+      std::vector<uint8_t> shuffled(n);
+      byte_shuffle(src, n, e.element_size, shuffled.data());
+      lz_encode(shuffled.data(), n, scratch);
+      break;
+    }
+    default: RAFT_FAIL("Unknown section codec %u", static_cast<uint32_t>(e.codec));
+  }
+  codec_block_header h{static_cast<uint32_t>(n), static_cast<uint32_t>(n)};
+  const bool stored = scratch.size() >= n;
+  if (!stored) { h.encoded_bytes = static_cast<uint32_t>(scratch.size()); }
+  out.append(reinterpret_cast<const char*>(&h), sizeof(h));
+  if (stored) {
+    out.append(reinterpret_cast<const char*>(src), n);
+  } else {
+    out.append(scratch);
+  }
+}
+
+inline void decode_block(const section_encoding& e,
+                         const uint8_t* src,
+                         const codec_block_header& h,
+                         uint8_t* dst)
+{
+  if (h.encoded_bytes == h.raw_bytes) {
+    std::memcpy(dst, src, h.raw_bytes);
+    return;
+  }
+  switch (e.codec) {
+    case section_codec::kDeltaVarint:
+      if (e.element_size == 4) {
+        delta_varint_decode<uint32_t>(src, h.encoded_bytes, dst, h.raw_bytes);
+      } else {
+        delta_varint_decode<uint64_t>(src, h.encoded_bytes, dst, h.raw_bytes);
+      }
+      break;
+    case section_codec::kShuffleLz: {
+      std::vector<uint8_t> shuffled(h.raw_bytes);
+      lz_decode(src, h.encoded_bytes, shuffled.data(), h.raw_bytes);
+      byte_unshuffle(shuffled.data(), h.raw_bytes, e.element_size, dst);
+      break;
+    }
+    default: RAFT_FAIL("Unknown section codec %u", static_cast<uint32_t>(e.codec));
+  }
+}
+
+}  // namespace codec_detail
+
+/**
+ * Encodes the payload written to it block by block (see `section_encoding`), forwarding the
+ * encoded payload to `sink`. `finish` must be called once the payload is complete.
+ */
+class encoding_writebuf : public std::streambuf {
+ public:
+  encoding_writebuf(std::streambuf* sink, const section_encoding& encoding)
+    : sink_(sink), encoding_(encoding)
+  {
+    codec_detail::check_encoding(encoding);
+    codec_header h{static_cast<uint32_t>(encoding.codec), encoding.element_size};
+    put(reinterpret_cast<const char*>(&h), sizeof(h));
+    // Whole elements per block, so that a block does not split an element.
+    block_bytes_ = kCodecBlockBytes - kCodecBlockBytes % encoding.element_size;
+    block_.reserve(block_bytes_);
+  }
+
+  /** Encode the last, partial block. */
+  void finish()
+  {
+    if (!block_.empty()) { flush_block(); }
+  }
+
+  [[nodiscard]] auto failed() const noexcept -> bool { return failed_; }
+
+ protected:
+  auto xsputn(const char* s, std::streamsize n) -> std::streamsize override
+  {
+    std::streamsize done = 0;
+    while (done < n) {
+      auto take = std::min<size_t>(n - done, block_bytes_ - block_.size());
+      block_.append(s + done, take);
+      done += take;
+      if (block_.size() == block_bytes_) { flush_block(); }
+    }
+    return n;
+  }
+
+  auto overflow(int_type ch) -> int_type override
+  {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) { return traits_type::not_eof(ch); }
+    char c = traits_type::to_char_type(ch);
+    return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+  }
+
+ private:
+  void flush_block()
+  {
+    encoded_.clear();
+    codec_detail::encode_block(encoding_,
+                               reinterpret_cast<const uint8_t*>(block_.data()),
+                               block_.size(),
+                               scratch_,
+                               encoded_);
+    put(encoded_.data(), encoded_.size());
+    block_.clear();
+  }
+
+  void put(const char* s, size_t n)
+  {
+    if (sink_->sputn(s, n) != static_cast<std::streamsize>(n)) { failed_ = true; }
+  }
+
+  std::streambuf* sink_;
+  section_encoding encoding_;
+  size_t block_bytes_;
+  std::string block_;
+  std::string scratch_;
+  std::string encoded_;
+  bool failed_ = false;
+};
+
+/**
+ * Decodes an encoded payload read from `source`, block by block.
+ *
+ * A read that covers whole blocks decodes them in parallel straight into the destination, the
+ * other reads go through a buffer of one block. At most one encoded block per thread is held in
+ * memory, never the whole payload.
+ */
+class decoding_readbuf : public std::streambuf {
+ public:
+  /**
+   * @param source the encoded payload, starting with the codec header
+   * @param size its size in bytes
+   */
+  decoding_readbuf(std::streambuf* source, uint64_t size) : source_(source), remaining_(size)
+  {
+    codec_header h;
+    read_encoded(&h, sizeof(h));
+    encoding_ = section_encoding{static_cast<section_codec>(h.codec), h.element_size};
+    codec_detail::check_encoding(encoding_);
+    max_batch_ = std::max(omp_get_max_threads(), 1);
+  }
+
+ protected:
+  auto underflow() -> int_type override
+  {
+    if (gptr() < egptr()) { return traits_type::to_int_type(*gptr()); }
+    if (!next_block()) { return traits_type::eof(); }
+    block_.resize(pending_.raw_bytes);
+    read_block(0);
+    decode(1, reinterpret_cast<uint8_t*>(block_.data()));
+    setg(block_.data(), block_.data(), block_.data() + block_.size());
+    return traits_type::to_int_type(*gptr());
+  }
+
+  auto xsgetn(char* s, std::streamsize n) -> std::streamsize override
+  {
+    std::streamsize done = 0;
+    while (done < n) {
+      if (gptr() < egptr()) {
+        auto take = std::min<std::streamsize>(n - done, egptr() - gptr());
+        std::memcpy(s + done, gptr(), take);
+        gbump(static_cast<int>(take));
+        done += take;
+        continue;
+      }
+      if (!next_block()) { break; }
+      if (pending_.raw_bytes > static_cast<uint64_t>(n - done)) {
+        // The read ends within the block.
+        underflow();
+        continue;
+      }
+      // The whole blocks that fit in the rest of the read.
+      size_t n_blocks  = 0;
+      uint64_t n_bytes = 0;
+      while (n_blocks < size_t(max_batch_) && next_block() &&
+             n_bytes + pending_.raw_bytes <= static_cast<uint64_t>(n - done)) {
+        n_bytes += pending_.raw_bytes;
+        read_block(n_blocks++);
+      }
+      decode(n_blocks, reinterpret_cast<uint8_t*>(s + done));
+      done += n_bytes;
+    }
+    return done;
+  }
+
+ private:
+  void read_encoded(void* dst, size_t n)
+  {
+    RAFT_EXPECTS(n <= remaining_, "Corrupted encoded section");
+    auto got = source_->sgetn(static_cast<char*>(dst), n);
+    RAFT_EXPECTS(got == static_cast<std::streamsize>(n), "Truncated encoded section");
+    remaining_ -= n;
+  }
+
+  /** Read the header of the next block, if any, into `pending_`. */
+  auto next_block() -> bool
+  {
+    if (has_pending_) { return true; }
+    if (remaining_ == 0) { return false; }
+    read_encoded(&pending_, sizeof(pending_));
+    RAFT_EXPECTS(pending_.raw_bytes > 0 && pending_.raw_bytes <= kCodecBlockBytes &&
+                   pending_.encoded_bytes <= pending_.raw_bytes &&
+                   pending_.encoded_bytes <= remaining_,
+                 "Corrupted encoded section");
+    has_pending_ = true;
+    return true;
+  }
+
+  /** Read the encoded bytes of the pending block as block `i` of the next `decode`. */
+  void read_block(size_t i)
+  {
+    if (blocks_.size() <= i) {
+      blocks_.resize(i + 1);
+      encoded_.resize(i + 1);
+    }
+    blocks_[i] = pending_;
+    encoded_[i].resize(pending_.encoded_bytes);
+    read_encoded(encoded_[i].data(), pending_.encoded_bytes);
+    has_pending_ = false;
+  }
+
+  /** Decode the first `n_blocks` blocks read, one after the other into `dst`. */
+  void decode(size_t n_blocks, uint8_t* dst)
+  {
+    std::vector<size_t> offsets(n_blocks + 1, 0);
+    for (size_t i = 0; i < n_blocks; i++) {
+      offsets[i + 1] = offsets[i] + blocks_[i].raw_bytes;
+    }
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic) if (n_blocks > 1)
+    for (size_t i = 0; i < n_blocks; i++) {
+      try {
+        codec_detail::decode_block(encoding_, encoded_[i].data(), blocks_[i], dst + offsets[i]);
+      } catch (...) {
+#pragma omp critical
+        if (!error) { error = std::current_exception(); }
+      }
+    }
+    if (error) { std::rethrow_exception(error); }
+  }
+
+  std::streambuf* source_;
+  uint64_t remaining_;
+  section_encoding encoding_;
+  int max_batch_;
+  codec_block_header pending_{};
+  bool has_pending_ = false;
+  std::vector<codec_block_header> blocks_;
+  std::vector<std::vector<uint8_t>> encoded_;
+  std::vector<char> block_;
+};
+
+}  // namespace cuvs::neighbors::detail
@@ -45,6 +45,7 @@ build_include_macro = """
 """
 search_include_macro = """
 #include "ivf_flat_search.cuh"
+#include "ivf_flat_search_host.hpp"
 """
 
 serialize_include_macro = """
@@ -162,6 +163,34 @@ search_macro = """
   {                                                                             \\
     cuvs::neighbors::ivf_flat::detail::search_with_filtering(                   \\
       handle, params, idx, queries, neighbors, distances, sample_filter);       \\
+  }                                                                             \\
+  void search(raft::resources const& handle,                                    \\
+              const cuvs::neighbors::ivf_flat::search_params& params,           \\
+              const cuvs::neighbors::ivf_flat::host_index<T, IdxT>& index,      \\
+              raft::host_matrix_view<const T, IdxT, raft::row_major> queries,   \\
+              raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,    \\
+              raft::host_matrix_view<float, IdxT, raft::row_major> distances)   \\
+  {                                                                             \\
+    cuvs::neighbors::ivf_flat::detail::search_host(                             \\
+      handle,                                                                   \\
+      params,                                                                   \\
+      index,                                                                    \\
+      queries,                                                                  \\
+      neighbors,                                                                \\
+      distances,                                                                \\
+      cuvs::neighbors::filtering::none_ivf_sample_filter());                    \\
+  }                                                                             \\
+  void search_with_filtering(                                                   \\
+    raft::resources const& handle,                                              \\
+    const search_params& params,                                                \\
+    const host_index<T, IdxT>& idx,                                             \\
+    raft::host_matrix_view<const T, IdxT, raft::row_major> queries,             \\
+    raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,              \\
+    raft::host_matrix_view<float, IdxT, raft::row_major> distances,             \\
+    cuvs::neighbors::filtering::bitset_filter<uint32_t, IdxT> sample_filter)    \\
+  {                                                                             \\
+    cuvs::neighbors::ivf_flat::detail::search_host(                             \\
+      handle, params, idx, queries, neighbors, distances, sample_filter);       \\
   }
 """
 
@@ -169,20 +198,30 @@ serialize_macro = """
 #define CUVS_INST_IVF_FLAT_SERIALIZE(T, IdxT)                                                      \\
   void serialize_file(raft::resources const& handle,                                               \\
                       const std::string& filename,                                                 \\
-                      const cuvs::neighbors::ivf_flat::index<T, IdxT>& index)                      \\
+                      const cuvs::neighbors::ivf_flat::index<T, IdxT>& index,                      \\
+                      cuvs::neighbors::serialize_compression compression)                          \\
   {                                                                                                \\
-    cuvs::neighbors::ivf_flat::detail::serialize(handle, filename, index);                         \\
+    cuvs::neighbors::ivf_flat::detail::serialize(handle, filename, index, compression);            \\
   }                                                                                                \\
                                                                                                    \\
   void serialize(raft::resources const& handle,                                                    \\
                  std::string& str,                                                                 \\
-                 const cuvs::neighbors::ivf_flat::index<T, IdxT>& index)                           \\
+                 const cuvs::neighbors::ivf_flat::index<T, IdxT>& index,                           \\
+                 cuvs::neighbors::serialize_compression compression)                               \\
   {                                                                                                \\
     std::ostringstream os;                                                                         \\
-    cuvs::neighbors::ivf_flat::detail::serialize(handle, os, index);                               \\
+    cuvs::neighbors::ivf_flat::detail::serialize(handle, os, index, compression);                  \\
     str = os.str();                                                                                \\
   }                                                                                                \\
                                                                                                    \\
+  void serialize(raft::resources const& handle,                                                    \\
+                 std::ostream& os,                                                                 \\
+                 const cuvs::neighbors::ivf_flat::index<T, IdxT>& index,                           \\
+                 cuvs::neighbors::serialize_compression compression)                               \\
+  {                                                                                                \\
+    cuvs::neighbors::ivf_flat::detail::serialize(handle, os, index, compression);                  \\
+  }                                                                                                \\
+                                                                                                   \\
   void deserialize_file(raft::resources const& handle,                                             \\
                         const std::string& filename,                                               \\
                         cuvs::neighbors::ivf_flat::index<T, IdxT>* index)                          \\
@@ -197,6 +236,36 @@ serialize_macro = """
     std::istringstream is(str);                                                                    \\
     * index = cuvs::neighbors::ivf_flat::detail::deserialize<T, IdxT>(                             \\
       handle, is);                                                                                 \\
+  }                                                                                                \\
+  void deserialize(raft::resources const& handle,                                                  \\
+                   std::istream& is,                                                               \\
+                   cuvs::neighbors::ivf_flat::index<T, IdxT>* index)                               \\
+  {                                                                                                \\
+    * index = cuvs::neighbors::ivf_flat::detail::deserialize<T, IdxT>(                             \\
+      handle, is);                                                                                 \\
+  }                                                                                                \\
+  void deserialize_host_file(raft::resources const& handle,                                        \\
+                             const std::string& filename,                                          \\
+                             cuvs::neighbors::ivf_flat::host_index<T, IdxT>* index)                \\
+  {                                                                                                \\
+    * index = cuvs::neighbors::ivf_flat::detail::deserialize_host<T, IdxT>(                        \\
+      handle, filename);                                                                           \\
+  }                                                                                                \\
+  void deserialize_host_file(raft::resources const& handle,                                        \\
+                             const std::string& filename,                                          \\
+                             const cuvs::neighbors::ivf::host_load_params& params,                 \\
+                             cuvs::neighbors::ivf_flat::host_index<T, IdxT>* index)                \\
+  {                                                                                                \\
+    * index = cuvs::neighbors::ivf_flat::detail::deserialize_host<T, IdxT>(                        \\
+      handle, filename, params);                                                                   \\
+  }                                                                                                \\
+  void deserialize_host(raft::resources const& handle,                                             \\
+                        const std::string& str,                                                    \\
+                        cuvs::neighbors::ivf_flat::host_index<T, IdxT>* index)                     \\
+  {                                                                                                \\
+    std::istringstream is(str);                                                                    \\
+    * index = cuvs::neighbors::ivf_flat::detail::deserialize_host<T, IdxT>(                        \\
+      handle, is);                                                                                 \\
   }                                                                                                 
 """
 
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host (CPU) kernels scanning the interleaved groups of the IVF-Flat lists.
+ *
+ * A group holds `kIndexGroupSize` rows as dim / veclen chunks of kIndexGroupSize * veclen
+ * elements. The kernels split a chunk into slabs of as many elements as fit into a SIMD register
+ * and accumulate each slab over all the chunks of the group, so that every lane accumulates one
+ * component class of one row; the lanes belonging to the same row are summed at the end. As with
+ * the host distance kernels, the x86 kernels use function-level `target` attributes and are
+ * selected at run time.
+ */
+
+#include "ivf_flat_interleaved_scan_host.hpp"
+
+#include <cuvs/neighbors/ivf_flat.hpp>
+
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CUVS_HOST_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CUVS_HOST_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cuvs::neighbors::ivf_flat::detail::host {
+
+namespace {
+
+using cuvs::distance::detail::host::simd_isa;
+using cuvs::distance::detail::host::to_float;
+
+/** The largest veclen of the supported data types (one-byte elements). */
+constexpr uint32_t kMaxVeclen = 16;
+
+/** Sum the `veclen` partial sums of each row of the group. */
+inline void reduce_rows(const float* partial, uint32_t veclen, float* out)
+{
+  for (uint32_t r = 0; r < kIndexGroupSize; r++) {
+    float s = 0;
+    for (uint32_t v = 0; v < veclen; v++) {
+      s += partial[r * veclen + v];
+    }
+    out[r] = s;
+  }
+}
+
+template <typename T, bool kInnerProduct>
+void scan_group_scalar(
+  const float* query, const T* group, uint32_t dim, uint32_t veclen, float* out)
+{
+  // With a single lane the expanded query is the query itself.
+  const uint32_t chunk_len = kIndexGroupSize * veclen;
+  float partial[kIndexGroupSize * kMaxVeclen] = {};
+  for (uint32_t c = 0; c < dim / veclen; c++) {
+    const T* chunk = group + size_t(c) * chunk_len;
+    const float* q = query + size_t(c) * veclen;
+    for (uint32_t i = 0; i < chunk_len; i++) {
+      float x = to_float(chunk[i]);
+      if constexpr (kInnerProduct) {
+        partial[i] += q[i % veclen] * x;
+      } else {
+        float d = q[i % veclen] - x;
+        partial[i] += d * d;
+      }
+    }
+  }
+  reduce_rows(partial, veclen, out);
+}
+
+#ifdef CUVS_HOST_SIMD_X86
+
+/* ---------------------------------------- AVX2 ---------------------------------------------- */
+
+__attribute__((target("avx2"))) inline auto load8_avx2(const float* p) -> __m256
+{
+  return _mm256_loadu_ps(p);
+}
+
+__attribute__((target("avx2"))) inline auto load8_avx2(const int8_t* p) -> __m256
+{
+  return _mm256_cvtepi32_ps(
+    _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+__attribute__((target("avx2"))) inline auto load8_avx2(const uint8_t* p) -> __m256
+{
+  return _mm256_cvtepi32_ps(
+    _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+template <bool kInnerProduct>
+__attribute__((target("avx2,fma"))) inline auto accumulate_avx2(__m256 acc, __m256 q, __m256 x)
+  -> __m256
+{
+  if constexpr (kInnerProduct) {
+    return _mm256_fmadd_ps(q, x, acc);
+  } else {
+    __m256 d = _mm256_sub_ps(q, x);
+    return _mm256_fmadd_ps(d, d, acc);
+  }
+}
+
+template <typename T, bool kInnerProduct>
+__attribute__((target("avx2,fma"))) void scan_group_avx2(
+  const float* query, const T* group, uint32_t dim, uint32_t veclen, float* out)
+{
+  constexpr uint32_t kLanes = 8;
+  const uint32_t n_chunks   = dim / veclen;
+  const uint32_t chunk_len  = kIndexGroupSize * veclen;
+  const uint32_t period     = std::max(veclen, kLanes);
+  alignas(32) float partial[kIndexGroupSize * kMaxVeclen];
+  // A chunk has at least four slabs; four independent accumulators hide the FMA latency.
+  for (uint32_t s = 0; s < chunk_len; s += 4 * kLanes) {
+    __m256 acc0     = _mm256_setzero_ps();
+    __m256 acc1     = _mm256_setzero_ps();
+    __m256 acc2     = _mm256_setzero_ps();
+    __m256 acc3     = _mm256_setzero_ps();
+    const float* q0 = query + s % period;
+    const float* q1 = query + (s + kLanes) % period;
+    const float* q2 = query + (s + 2 * kLanes) % period;
+    const float* q3 = query + (s + 3 * kLanes) % period;
+    const T* x      = group + s;
+    for (uint32_t c = 0; c < n_chunks; c++, x += chunk_len) {
+      const size_t qo = size_t(c) * period;
+      acc0 = accumulate_avx2<kInnerProduct>(acc0, _mm256_loadu_ps(q0 + qo), load8_avx2(x));
+      acc1 = accumulate_avx2<kInnerProduct>(acc1, _mm256_loadu_ps(q1 + qo), load8_avx2(x + 8));
+      acc2 = accumulate_avx2<kInnerProduct>(acc2, _mm256_loadu_ps(q2 + qo), load8_avx2(x + 16));
+      acc3 = accumulate_avx2<kInnerProduct>(acc3, _mm256_loadu_ps(q3 + qo), load8_avx2(x + 24));
+    }
+    _mm256_store_ps(partial + s, acc0);
+    _mm256_store_ps(partial + s + kLanes, acc1);
+    _mm256_store_ps(partial + s + 2 * kLanes, acc2);
+    _mm256_store_ps(partial + s + 3 * kLanes, acc3);
+  }
+  reduce_rows(partial, veclen, out);
+}
+
+/* --------------------------------------- AVX-512 -------------------------------------------- */
+
+__attribute__((target("avx512f"))) inline auto load16_avx512(const float* p) -> __m512
+{
+  return _mm512_loadu_ps(p);
+}
+
+__attribute__((target("avx512f"))) inline auto load16_avx512(const int8_t* p) -> __m512
+{
+  return _mm512_cvtepi32_ps(
+    _mm512_cvtepi8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+}
+
+__attribute__((target("avx512f"))) inline auto load16_avx512(const uint8_t* p) -> __m512
+{
+  return _mm512_cvtepi32_ps(
+    _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+}
+
+template <bool kInnerProduct>
+__attribute__((target("avx512f"))) inline auto accumulate_avx512(__m512 acc, __m512 q, __m512 x)
+  -> __m512
+{
+  if constexpr (kInnerProduct) {
+    return _mm512_fmadd_ps(q, x, acc);
+  } else {
+    __m512 d = _mm512_sub_ps(q, x);
+    return _mm512_fmadd_ps(d, d, acc);
+  }
+}
+
+/** Accumulate `kSlabs` consecutive slabs starting at element `s` of the chunks. */
+template <typename T, bool kInnerProduct, uint32_t kSlabs>
+__attribute__((target("avx512f"))) inline void scan_slabs_avx512(const float* query,
+                                                                 const T* group,
+                                                                 uint32_t n_chunks,
+                                                                 uint32_t chunk_len,
+                                                                 uint32_t period,
+                                                                 uint32_t s,
+                                                                 float* partial)
+{
+  constexpr uint32_t kLanes = 16;
+  __m512 acc[kSlabs];
+  const float* q[kSlabs];
+  for (uint32_t j = 0; j < kSlabs; j++) {
+    acc[j] = _mm512_setzero_ps();
+    q[j]   = query + (s + j * kLanes) % period;
+  }
+  const T* x = group + s;
+  for (uint32_t c = 0; c < n_chunks; c++, x += chunk_len) {
+    const size_t qo = size_t(c) * period;
+    for (uint32_t j = 0; j < kSlabs; j++) {
+      acc[j] = accumulate_avx512<kInnerProduct>(
+        acc[j], _mm512_loadu_ps(q[j] + qo), load16_avx512(x + j * kLanes));
+    }
+  }
+  for (uint32_t j = 0; j < kSlabs; j++) {
+    _mm512_store_ps(partial + s + j * kLanes, acc[j]);
+  }
+}
+
+template <typename T, bool kInnerProduct>
+__attribute__((target("avx512f"))) void scan_group_avx512(
+  const float* query, const T* group, uint32_t dim, uint32_t veclen, float* out)
+{
+  constexpr uint32_t kLanes = 16;
+  const uint32_t n_chunks   = dim / veclen;
+  const uint32_t chunk_len  = kIndexGroupSize * veclen;
+  const uint32_t period     = std::max(veclen, kLanes);
+  alignas(64) float partial[kIndexGroupSize * kMaxVeclen];
+  // A chunk has at least two slabs (veclen = 1); use four accumulators when there are enough.
+  if (chunk_len % (4 * kLanes) == 0) {
+    for (uint32_t s = 0; s < chunk_len; s += 4 * kLanes) {
+      scan_slabs_avx512<T, kInnerProduct, 4>(
+        query, group, n_chunks, chunk_len, period, s, partial);
+    }
+  } else {
+    for (uint32_t s = 0; s < chunk_len; s += 2 * kLanes) {
+      scan_slabs_avx512<T, kInnerProduct, 2>(
+        query, group, n_chunks, chunk_len, period, s, partial);
+    }
+  }
+  reduce_rows(partial, veclen, out);
+}
+
+#endif  // CUVS_HOST_SIMD_X86
+
+#ifdef CUVS_HOST_SIMD_NEON
+
+/* ---------------------------------------- NEON ---------------------------------------------- */
+
+template <bool kInnerProduct>
+void scan_group_neon(
+  const float* query, const float* group, uint32_t dim, uint32_t veclen, float* out)
+{
+  constexpr uint32_t kLanes = 4;
+  const uint32_t n_chunks   = dim / veclen;
+  const uint32_t chunk_len  = kIndexGroupSize * veclen;
+  const uint32_t period     = std::max(veclen, kLanes);
+  alignas(16) float partial[kIndexGroupSize * kMaxVeclen];
+  for (uint32_t s = 0; s < chunk_len; s += 4 * kLanes) {
+    float32x4_t acc[4];
+    const float* q[4];
+    for (uint32_t j = 0; j < 4; j++) {
+      acc[j] = vdupq_n_f32(0);
+      q[j]   = query + (s + j * kLanes) % period;
+    }
+    const float* x = group + s;
+    for (uint32_t c = 0; c < n_chunks; c++, x += chunk_len) {
+      const size_t qo = size_t(c) * period;
+      for (uint32_t j = 0; j < 4; j++) {
+        float32x4_t qv = vld1q_f32(q[j] + qo);
+        float32x4_t xv = vld1q_f32(x + j * kLanes);
+        if constexpr (kInnerProduct) {
+          acc[j] = vfmaq_f32(acc[j], qv, xv);
+        } else {
+          float32x4_t d = vsubq_f32(qv, xv);
+          acc[j]        = vfmaq_f32(acc[j], d, d);
+        }
+      }
+    }
+    for (uint32_t j = 0; j < 4; j++) {
+      vst1q_f32(partial + s + j * kLanes, acc[j]);
+    }
+  }
+  reduce_rows(partial, veclen, out);
+}
+
+#endif  // CUVS_HOST_SIMD_NEON
+
+}  // namespace
+
+template <typename T>
+auto get_group_scan_kernels(simd_isa isa) -> const group_scan_kernels<T>&
+{
+  static const group_scan_kernels<T> scalar{
+    1, &scan_group_scalar<T, false>, &scan_group_scalar<T, true>};
+  switch (isa) {
+#if defined(CUVS_HOST_SIMD_X86)
+    case simd_isa::kAvx2: {
+      static const group_scan_kernels<T> avx2{
+        8, &scan_group_avx2<T, false>, &scan_group_avx2<T, true>};
+      return avx2;
+    }
+    case simd_isa::kAvx512: {
+      static const group_scan_kernels<T> avx512{
+        16, &scan_group_avx512<T, false>, &scan_group_avx512<T, true>};
+      return avx512;
+    }
+#elif defined(CUVS_HOST_SIMD_NEON)
+    case simd_isa::kNeon: {
+      // The byte types are widened by the scalar kernels, which the compiler vectorizes well.
+      if constexpr (std::is_same_v<T, float>) {
+        static const group_scan_kernels<T> neon{
+          4, &scan_group_neon<false>, &scan_group_neon<true>};
+        return neon;
+      } else {
+        return scalar;
+      }
+    }
+#endif
+    default: return scalar;
+  }
+}
+
+template auto get_group_scan_kernels<float>(simd_isa) -> const group_scan_kernels<float>&;
+template auto get_group_scan_kernels<int8_t>(simd_isa) -> const group_scan_kernels<int8_t>&;
+template auto get_group_scan_kernels<uint8_t>(simd_isa) -> const group_scan_kernels<uint8_t>&;
+
+}  // namespace cuvs::neighbors::ivf_flat::detail::host
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../distance/detail/host_distance.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace cuvs::neighbors::ivf_flat::detail::host {
+
+/**
+ * Distances from a query to the `kIndexGroupSize` vectors of one interleaved group.
+ *
+ * @param query the query expanded by `expand_query`
+ * @param group the first element of the group in the list data
+ * @param dim dimensionality of the data
+ * @param veclen interleaving chunk length of the index (`index::veclen`)
+ * @param out the distances [kIndexGroupSize]
+ */
+template <typename T>
+using group_scan_kernel =
+  void (*)(const float* query, const T* group, uint32_t dim, uint32_t veclen, float* out);
+
+/** A set of group scan kernels for one data type and instruction set. */
+template <typename T>
+struct group_scan_kernels {
+  /** Number of elements the kernels load at once; defines the layout of the expanded query. */
+  uint32_t lanes;
+  /** Squared euclidean distance */
+  group_scan_kernel<T> l2;
+  /** Inner product */
+  group_scan_kernel<T> inner_product;
+};
+
+/**
+ * Get the kernels for the given instruction set.
+ *
+ * If the instruction set is not available in this build, the scalar kernels are returned.
+ */
+template <typename T>
+auto get_group_scan_kernels(cuvs::distance::detail::host::simd_isa isa)
+  -> const group_scan_kernels<T>&;
+
+/** Get the kernels for the instruction set selected by the runtime CPU dispatch. */
+template <typename T>
+auto get_group_scan_kernels() -> const group_scan_kernels<T>&
+{
+  static const group_scan_kernels<T>& kernels =
+    get_group_scan_kernels<T>(cuvs::distance::detail::host::detected_simd_isa());
+  return kernels;
+}
+
+extern template auto get_group_scan_kernels<float>(cuvs::distance::detail::host::simd_isa)
+  -> const group_scan_kernels<float>&;
+extern template auto get_group_scan_kernels<int8_t>(cuvs::distance::detail::host::simd_isa)
+  -> const group_scan_kernels<int8_t>&;
+extern template auto get_group_scan_kernels<uint8_t>(cuvs::distance::detail::host::simd_isa)
+  -> const group_scan_kernels<uint8_t>&;
+
+/** Number of elements of an expanded query. */
+inline auto expanded_query_size(uint32_t dim, uint32_t veclen, uint32_t lanes) -> size_t
+{
+  return size_t(dim / veclen) * std::max(veclen, lanes);
+}
+
+/**
+ * Expand a query for the group scan kernels.
+ *
+ * A chunk of an interleaved group holds `veclen` components of each of its rows, one row after
+ * another. The kernels load `lanes` consecutive elements of a chunk at a time and subtract or
+ * multiply them lane-wise with the query, so every `veclen` components of the query are repeated
+ * up to the length of max(veclen, lanes). With one lane the expanded query is the query itself.
+ *
+ * @param query [dim]
+ * @param out [expanded_query_size(dim, veclen, lanes)]
+ */
+inline void expand_query(
+  const float* query, uint32_t dim, uint32_t veclen, uint32_t lanes, float* out)
+{
+  const uint32_t period = std::max(veclen, lanes);
+  for (uint32_t c = 0; c < dim / veclen; c++) {
+    for (uint32_t j = 0; j < period; j++) {
+      out[size_t(c) * period + j] = query[size_t(c) * veclen + j % veclen];
+    }
+  }
+}
+
+}  // namespace cuvs::neighbors::ivf_flat::detail::host
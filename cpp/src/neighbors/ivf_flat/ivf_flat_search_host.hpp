@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../core/nvtx.hpp"
+#include "../../distance/detail/host_distance.hpp"
+#include "../../selection/detail/select_k_host.hpp"
+#include "../detail/sample_filter_host.hpp"
+#include "../sample_filter.cuh"
+#include "ivf_flat_interleaved_scan_host.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/common.hpp>
+#include <cuvs/neighbors/ivf_flat.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdspan.hpp>
+#include <raft/core/logger.hpp>
+#include <raft/core/resources.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace cuvs::neighbors::ivf_flat::detail {
+
+/**
+ * The per-thread state of the host search.
+ *
+ * The inner product is negated, so that the best candidates always have the smallest keys.
+ */
+template <typename IdxT>
+struct host_search_context {
+  std::vector<float> query;
+  std::vector<float> expanded_query;
+  std::vector<uint32_t> probes;
+  cuvs::selection::detail::host::bounded_heap<float, uint32_t> probe_heap;
+  cuvs::selection::detail::host::bounded_heap<float, IdxT> heap;
+  float group_distances[kIndexGroupSize];
+
+  host_search_context(uint32_t dim, size_t expanded_size, uint32_t n_probes)
+    : query(dim), expanded_query(expanded_size), probes(n_probes)
+  {
+  }
+};
+
+/**
+ * Search an IVF-Flat index on the host.
+ *
+ * The coarse search computes the distances to all cluster centers with the host SIMD distance
+ * kernels; the probed lists are then scanned group by group in their interleaved layout (see
+ * `ivf_flat_interleaved_scan_host.hpp`). With at least as many queries as threads the queries are
+ * processed in parallel, one per thread; otherwise the probed lists of each query are distributed
+ * over the threads and the per-thread top-k are merged.
+ *
+ * With a bitset filter, the admitted rows are counted first. If the filter is selective enough
+ * (see `prefer_admitted_scan`), the probes are replaced by an exact scan of the groups of rows
+ * holding admitted rows, in all the lists. The lists loaded on demand are always probed.
+ */
+template <typename T, typename IdxT, typename IvfSampleFilterT>
+void search_host(raft::resources const& handle,
+                 const search_params& params,
+                 const host_index<T, IdxT>& index,
+                 raft::host_matrix_view<const T, IdxT, raft::row_major> queries,
+                 raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,
+                 raft::host_matrix_view<float, IdxT, raft::row_major> distances,
+                 IvfSampleFilterT sample_filter)
+{
+  const size_t n_queries = queries.extent(0);
+  const uint32_t k       = neighbors.extent(1);
+  const uint32_t dim     = index.dim();
+  const uint32_t veclen  = index.veclen();
+
+  cuvs::common::nvtx::range<cuvs::common::nvtx::domain::cuvs> fun_scope(
+    "ivf_flat::search_host(%zu, %u)", n_queries, k);
+
+  RAFT_EXPECTS(
+    queries.extent(0) == neighbors.extent(0) && queries.extent(0) == distances.extent(0),
+    "Number of rows in output neighbors and distances matrices must equal the number of queries.");
+  RAFT_EXPECTS(neighbors.extent(1) == distances.extent(1),
+               "Number of columns in output neighbors and distances matrices must be equal");
+  RAFT_EXPECTS(queries.extent(1) == dim,
+               "Number of query dimensions should equal number of dimensions in the index.");
+  RAFT_EXPECTS(params.n_probes > 0,
+               "n_probes (number of clusters to probe in the search) must be positive.");
+  uint32_t n_probes = std::min<uint32_t>(params.n_probes, index.n_lists());
+
+  bool inner_product = false;
+  bool take_sqrt     = false;
+  switch (index.metric()) {
+    case cuvs::distance::DistanceType::L2Expanded:
+    case cuvs::distance::DistanceType::L2Unexpanded: break;
+    case cuvs::distance::DistanceType::L2SqrtExpanded:
+    case cuvs::distance::DistanceType::L2SqrtUnexpanded: take_sqrt = true; break;
+    case cuvs::distance::DistanceType::InnerProduct: inner_product = true; break;
+    default:
+      RAFT_FAIL("Unsupported metric for IVF-Flat host search: %d",
+                static_cast<int>(index.metric()));
+  }
+  const auto& center_kernels = cuvs::distance::detail::host::get_distance_kernels<float>();
+  const auto& scan_kernels   = host::get_group_scan_kernels<T>();
+  auto center_distance = inner_product ? center_kernels.inner_product : center_kernels.l2;
+  auto group_distance  = inner_product ? scan_kernels.inner_product : scan_kernels.l2;
+  const size_t expanded_size = host::expanded_query_size(dim, veclen, scan_kernels.lanes);
+
+  // Like `ivf_to_sample_filter`, but with the indices of the list at hand, which may be loaded on
+  // demand.
+  auto filter = [&](size_t i, uint32_t label, const IdxT* indices, uint32_t j) -> bool {
+    if constexpr (cuvs::neighbors::filtering::takes_three_args<IvfSampleFilterT>::value) {
+      return sample_filter(i, label, j);
+    } else {
+      return sample_filter(i, indices[j]);
+    }
+  };
+
+  // With a selective bitset filter, scan the admitted rows of all the lists instead of probing.
+  // Not with the lists loaded on demand: it would load every list, evicting the cached ones.
+  std::optional<cuvs::neighbors::filtering::detail::ivf_admitted_groups<kIndexGroupSize>> admitted;
+  if constexpr (cuvs::neighbors::filtering::detail::is_bitset_filter<IvfSampleFilterT>::value) {
+    const cuvs::neighbors::filtering::detail::host_bitset bitset(sample_filter.bitset_view_);
+    const size_t n_rows     = index.size();
+    const size_t n_admitted = bitset.count();
+    const size_t ann_rows   = n_rows * n_probes / std::max<uint32_t>(index.n_lists(), 1);
+    if (!index.lazy_lists() && cuvs::neighbors::filtering::detail::prefer_admitted_scan(
+                                 n_admitted, n_rows, ann_rows, k)) {
+      admitted.emplace(
+        index.n_lists(),
+        index.list_sizes().data_handle(),
+        [&](uint32_t label) { return index.list_indices(label); },
+        bitset);
+      n_probes = admitted->labels.size();
+    }
+    RAFT_LOG_DEBUG("# IVF-Flat host search: the filter admits %zu of %zu rows, %s",
+                   n_admitted,
+                   n_rows,
+                   admitted ? "scanning them" : "searching with the filter");
+  }
+
+  using context_t = host_search_context<IdxT>;
+
+  // Convert the query, expand it for the group kernels and select the lists to probe.
+  auto prepare_query = [&](size_t i, context_t& ctx) {
+    const T* query = queries.data_handle() + i * dim;
+    for (uint32_t j = 0; j < dim; j++) {
+      ctx.query[j] = cuvs::distance::detail::host::to_float(query[j]);
+    }
+    host::expand_query(
+      ctx.query.data(), dim, veclen, scan_kernels.lanes, ctx.expanded_query.data());
+    if (admitted) {
+      std::copy(admitted->labels.begin(), admitted->labels.end(), ctx.probes.begin());
+      return;
+    }
+    ctx.probe_heap.reset(n_probes);
+    const float* centers = index.centers().data_handle();
+    for (uint32_t l = 0; l < index.n_lists(); l++) {
+      float d = center_distance(ctx.query.data(), centers + size_t(l) * dim, dim);
+      ctx.probe_heap.push(inner_product ? -d : d, l);
+    }
+    ctx.probe_heap.pop_sorted(nullptr, ctx.probes.data());
+  };
+
+  // Push the admissible vectors of a list into the heap.
+  auto scan_list = [&](size_t i, uint32_t label, const float* expanded_query, context_t& ctx) {
+    const uint32_t list_size = index.list_sizes()(label);
+    if (list_size == 0) { return; }
+    const auto list     = index.list(label);
+    const T* data       = list->data.data();
+    const IdxT* indices = list->indices.data();
+    if (admitted) {
+      // Only the groups with admitted rows, and only their admitted rows.
+      for (auto [group, mask] : admitted->groups[label]) {
+        group_distance(
+          expanded_query, data + size_t(group) * dim, dim, veclen, ctx.group_distances);
+        for (; mask != 0; mask &= mask - 1) {
+          const uint32_t j = __builtin_ctz(mask);
+          float key        = inner_product ? -ctx.group_distances[j] : ctx.group_distances[j];
+          if (ctx.heap.accepts(key)) { ctx.heap.push(key, indices[group + j]); }
+        }
+      }
+      return;
+    }
+    for (uint32_t group = 0; group < list_size; group += kIndexGroupSize) {
+      group_distance(expanded_query, data + size_t(group) * dim, dim, veclen, ctx.group_distances);
+      const uint32_t n = std::min<uint32_t>(kIndexGroupSize, list_size - group);
+      for (uint32_t j = 0; j < n; j++) {
+        float key = inner_product ? -ctx.group_distances[j] : ctx.group_distances[j];
+        if (ctx.heap.accepts(key) && filter(i, label, indices, group + j)) {
+          ctx.heap.push(key, indices[group + j]);
+        }
+      }
+    }
+  };
+
+  // Write the results of a query; missing results (too few admissible vectors in the probed lists)
+  // are marked as out of bounds, like in the GPU search.
+  auto write_results = [&](size_t i, context_t& ctx) {
+    IdxT* out_neighbors  = neighbors.data_handle() + i * k;
+    float* out_distances = distances.data_handle() + i * k;
+    const size_t n       = ctx.heap.pop_sorted(out_distances, out_neighbors);
+    for (size_t j = 0; j < n; j++) {
+      if (inner_product) {
+        out_distances[j] = -out_distances[j];
+      } else if (take_sqrt) {
+        out_distances[j] = std::sqrt(out_distances[j]);
+      }
+    }
+    std::fill(out_neighbors + n, out_neighbors + k, std::numeric_limits<IdxT>::max());
+    std::fill(out_distances + n,
+              out_distances + k,
+              inner_product ? std::numeric_limits<float>::lowest()
+                            : std::numeric_limits<float>::max());
+  };
+
+  const bool parallel_queries = n_queries >= size_t(omp_get_max_threads());
+  RAFT_LOG_DEBUG("# IVF-Flat host search: n_probes = %u, lanes = %u, parallel over %s",
+                 n_probes,
+                 scan_kernels.lanes,
+                 parallel_queries ? "queries" : "lists");
+
+  if (parallel_queries) {
+#pragma omp parallel
+    {
+      context_t ctx(dim, expanded_size, n_probes);
+#pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < n_queries; i++) {
+        prepare_query(i, ctx);
+        ctx.heap.reset(k);
+        for (uint32_t p = 0; p < n_probes; p++) {
+          scan_list(i, ctx.probes[p], ctx.expanded_query.data(), ctx);
+        }
+        write_results(i, ctx);
+      }
+    }
+    return;
+  }
+
+  context_t shared(dim, expanded_size, n_probes);
+#pragma omp parallel
+  {
+    context_t ctx(dim, expanded_size, n_probes);
+    std::vector<float> keys(k);
+    std::vector<IdxT> values(k);
+    for (size_t i = 0; i < n_queries; i++) {
+#pragma omp single
+      {
+        prepare_query(i, shared);
+        shared.heap.reset(k);
+      }
+      ctx.heap.reset(k);
+#pragma omp for schedule(dynamic) nowait
+      for (uint32_t p = 0; p < n_probes; p++) {
+        scan_list(i, shared.probes[p], shared.expanded_query.data(), ctx);
+      }
+      const size_t n = ctx.heap.pop_unsorted(keys.data(), values.data());
+#pragma omp critical
+      shared.heap.push(keys.data(), values.data(), n);
+#pragma omp barrier
+#pragma omp single
+      write_results(i, shared);
+    }
+  }
+}
+
+}  // namespace cuvs::neighbors::ivf_flat::detail
@@ -26,6 +26,7 @@
 #include <cuvs/neighbors/ivf_flat.hpp>
 
 #include "ivf_flat_search.cuh"
+#include "ivf_flat_search_host.hpp"
 
 namespace cuvs::neighbors::ivf_flat {
 
@@ -51,6 +52,34 @@ namespace cuvs::neighbors::ivf_flat {
   {                                                                             \
     cuvs::neighbors::ivf_flat::detail::search_with_filtering(                   \
       handle, params, idx, queries, neighbors, distances, sample_filter);       \
+  }                                                                             \
+  void search(raft::resources const& handle,                                    \
+              const cuvs::neighbors::ivf_flat::search_params& params,           \
+              const cuvs::neighbors::ivf_flat::host_index<T, IdxT>& index,      \
+              raft::host_matrix_view<const T, IdxT, raft::row_major> queries,   \
+              raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,    \
+              raft::host_matrix_view<float, IdxT, raft::row_major> distances)   \
+  {                                                                             \
+    cuvs::neighbors::ivf_flat::detail::search_host(                             \
+      handle,                                                                   \
+      params,                                                                   \
+      index,                                                                    \
+      queries,                                                                  \
+      neighbors,                                                                \
+      distances,                                                                \
+      cuvs::neighbors::filtering::none_ivf_sample_filter());                    \
+  }                                                                             \
+  void search_with_filtering(                                                   \
+    raft::resources const& handle,                                              \
+    const search_params& params,                                                \
+    const host_index<T, IdxT>& idx,                                             \
+    raft::host_matrix_view<const T, IdxT, raft::row_major> queries,             \
+    raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,              \
+    raft::host_matrix_view<float, IdxT, raft::row_major> distances,             \
+    cuvs::neighbors::filtering::bitset_filter<uint32_t, IdxT> sample_filter)    \
+  {                                                                             \
+    cuvs::neighbors::ivf_flat::detail::search_host(                             \
+      handle, params, idx, queries, neighbors, distances, sample_filter);       \
   }
 CUVS_INST_IVF_FLAT_SEARCH(int8_t, int64_t);
 
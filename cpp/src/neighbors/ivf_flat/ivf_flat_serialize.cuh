@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include "../../core/mmap.hpp"
+#include "../detail/container_serialize.hpp"
+#include "../detail/ivf_list_cache.hpp"
+#include "../detail/parallel_serialize.hpp"
 #include "../ivf_common.cuh"
 #include "../ivf_list.cuh"
 #include <cuvs/neighbors/common.hpp>
@@ -27,16 +31,173 @@
 #include <raft/core/serialize.hpp>
 #include <raft/util/pow2_utils.cuh>
 
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 namespace cuvs::neighbors::ivf_flat::detail {
 
 // Serialization version
-// No backward compatibility yet; that is, can't add additional fields without breaking
-// backward compatibility.
-// TODO(hcho3) Implement next-gen serializer for IVF that allows for expansion in a backward
-//             compatible fashion.
-constexpr int serialization_version = 4;
+// Since version 5 the index is written as a container (../detail/container_serialize.hpp);
+// files of version 4 remain readable.
+constexpr int serialization_version        = 5;
+constexpr int legacy_serialization_version = 4;
+constexpr std::string_view kContainerKind  = "ivf_flat";
+
+/** The parameters of a serialized index (the "params" section, or the header of version 4). */
+template <typename IdxT>
+struct serialized_params {
+  IdxT n_rows;
+  uint32_t dim;
+  uint32_t n_lists;
+  cuvs::distance::DistanceType metric;
+  bool adaptive_centers;
+  bool conservative_memory_allocation;
+};
+
+template <typename T>
+auto serialized_dtype() -> std::string
+{
+  std::string dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
+  dtype_string.resize(4);
+  return dtype_string;
+}
+
+template <typename IdxT>
+auto deserialize_params(raft::resources const& handle, std::istream& is) -> serialized_params<IdxT>
+{
+  serialized_params<IdxT> p;
+  p.n_rows  = raft::deserialize_scalar<IdxT>(handle, is);
+  p.dim     = raft::deserialize_scalar<std::uint32_t>(handle, is);
+  p.n_lists = raft::deserialize_scalar<std::uint32_t>(handle, is);
+  p.metric  = raft::deserialize_scalar<cuvs::distance::DistanceType>(handle, is);
+
+  p.adaptive_centers               = raft::deserialize_scalar<bool>(handle, is);
+  p.conservative_memory_allocation = raft::deserialize_scalar<bool>(handle, is);
+  return p;
+}
+
+/** The sections of a container every reader needs, besides the lists. */
+constexpr std::initializer_list<std::string_view> kRequiredSections = {
+  "params", "centers", "list_sizes"};
+
+/** Wrap a visitor of `read_sections` to read the parameters and validate the other sections. */
+template <typename T, typename IdxT, typename OnParams, typename Visitor>
+auto check_sections(raft::resources const& handle,
+                    std::optional<serialized_params<IdxT>>& params,
+                    OnParams& on_params,
+                    Visitor& visit)
+{
+  return [&](const cuvs::neighbors::detail::section_info& s,
+             std::istream& payload,
+             raft::resources const& res) -> bool {
+    if (s.is("params")) {
+      char dtype_string[4];
+      payload.read(dtype_string, 4);
+      RAFT_EXPECTS(std::memcmp(dtype_string, serialized_dtype<T>().data(), 4) == 0,
+                   "The data type of the IVF-Flat index does not match");
+      params = deserialize_params<IdxT>(handle, payload);
+      on_params(*params);
+      return true;
+    }
+    RAFT_EXPECTS(
+      params.has_value(), "IVF-Flat section '%s' precedes the parameters", s.name.c_str());
+    RAFT_EXPECTS(
+      !s.is("list") || s.id < params->n_lists, "Invalid IVF-Flat list label %zu", size_t(s.id));
+    return visit(s, payload, res);
+  };
+}
+
+/**
+ * Read a serialized index: the parameters go to `on_params(const serialized_params<IdxT>&)`, then
+ * the other sections, in order, to
+ * `visit(const section_info&, std::istream&, const raft::resources&) -> bool`, which returns
+ * whether it knows the section.
+ *
+ * For the flat format of version 4 the sections are the consecutive parts of the stream, and the
+ * "center_norms" section is present if the flag preceding it is set.
+ */
+template <typename T, typename IdxT, typename OnParams, typename Visitor>
+void read_sections(raft::resources const& handle,
+                   std::istream& is,
+                   OnParams&& on_params,
+                   Visitor&& visit)
+{
+  using cuvs::neighbors::detail::section_info;
+  std::optional<serialized_params<IdxT>> params;
+  auto prefix = cuvs::neighbors::detail::read_container_prefix(is);
+  if (cuvs::neighbors::detail::is_container(prefix)) {
+    cuvs::neighbors::detail::container_reader reader(
+      is, prefix, kContainerKind, serialization_version);
+    auto checked = check_sections<T, IdxT>(handle, params, on_params, visit);
+    reader.read_sections([&](const section_info& s, std::istream& payload) -> bool {
+      return checked(s, payload, handle);
+    });
+    reader.require_sections("IVF-Flat", kRequiredSections);
+    RAFT_EXPECTS(reader.count_sections("list") == params->n_lists,
+                 "The IVF-Flat index misses some lists");
+    return;
+  }
+
+  // The prefix of the flat format is the dtype string.
+  auto ver = raft::deserialize_scalar<int>(handle, is);
+  if (ver != legacy_serialization_version) {
+    RAFT_FAIL(
+      "serialization version mismatch, expected %d, got %d ", legacy_serialization_version, ver);
+  }
+  params = deserialize_params<IdxT>(handle, is);
+  on_params(*params);
+  visit(section_info{"centers", 0, 0, 0, 0, 0}, is, handle);
+  if (raft::deserialize_scalar<bool>(handle, is)) {
+    visit(section_info{"center_norms", 0, 0, 0, 0, 0}, is, handle);
+  }
+  visit(section_info{"list_sizes", 0, 0, 0, 0, 0}, is, handle);
+  for (uint32_t label = 0; label < params->n_lists; label++) {
+    visit(section_info{"list", label, 0, 0, 0, 0}, is, handle);
+  }
+  if (!is) { RAFT_FAIL("Error reading the IVF-Flat index"); }
+}
+
+/**
+ * Read a serialized index from a file, as `read_sections` does from a stream, except that the
+ * lists of a container are loaded concurrently, `visit` getting the resources of the loading
+ * thread.
+ */
+template <typename T, typename IdxT, typename OnParams, typename Visitor>
+void read_sections(raft::resources const& handle,
+                   const std::string& filename,
+                   OnParams&& on_params,
+                   Visitor&& visit)
+{
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  if (!is) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+  auto prefix = cuvs::neighbors::detail::read_container_prefix(is);
+  is.seekg(0);
+  if (!cuvs::neighbors::detail::is_container(prefix)) {
+    return read_sections<T, IdxT>(handle, is, on_params, visit);
+  }
+
+  auto toc =
+    cuvs::neighbors::detail::read_container_toc(is, kContainerKind, serialization_version);
+  for (auto name : kRequiredSections) {
+    RAFT_EXPECTS(toc.find(name) != nullptr,
+                 "The IVF-Flat index misses the section '%s'",
+                 std::string(name).c_str());
+  }
+  std::optional<serialized_params<IdxT>> params;
+  cuvs::neighbors::detail::read_sections_parallel(
+    handle, filename, is, toc, "list", check_sections<T, IdxT>(handle, params, on_params, visit));
+  auto n_lists = std::count_if(toc.sections.begin(), toc.sections.end(), [](const auto& s) {
+    return s.is("list");
+  });
+  RAFT_EXPECTS(size_t(n_lists) == params->n_lists, "The IVF-Flat index misses some lists");
+}
 
 /**
  * Save the index to file.
@@ -44,35 +205,40 @@ constexpr int serialization_version = 4;
  * Experimental, both the API and the serialization format are subject to change.
  *
  * @param[in] handle the raft handle
- * @param[in] filename the file name for saving the index
+ * @param[in] os output stream
  * @param[in] index_ IVF-Flat index
+ * @param[in] compression compression of the lists
+ * @param[in] file the file behind `os`, if any; the lists are then written to it in parallel
  *
  */
 template <typename T, typename IdxT>
-void serialize(raft::resources const& handle, std::ostream& os, const index<T, IdxT>& index_)
+void serialize(raft::resources const& handle,
+               std::ostream& os,
+               const index<T, IdxT>& index_,
+               serialize_compression compression               = serialize_compression::NONE,
+               const cuvs::core::detail::file_descriptor* file = nullptr)
 {
   RAFT_LOG_DEBUG(
     "Saving IVF-Flat index, size %zu, dim %u", static_cast<size_t>(index_.size()), index_.dim());
 
-  std::string dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<T>().to_string();
-  dtype_string.resize(4);
-  os << dtype_string;
-
-  serialize_scalar(handle, os, serialization_version);
-  serialize_scalar(handle, os, index_.size());
-  serialize_scalar(handle, os, index_.dim());
-  serialize_scalar(handle, os, index_.n_lists());
-  serialize_scalar(handle, os, index_.metric());
-  serialize_scalar(handle, os, index_.adaptive_centers());
-  serialize_scalar(handle, os, index_.conservative_memory_allocation());
-  serialize_mdspan(handle, os, index_.centers());
+  constexpr auto kRequired = cuvs::neighbors::detail::kSectionRequired;
+  cuvs::neighbors::detail::container_writer writer(os, kContainerKind, serialization_version);
+  writer.section("params", 0, kRequired, [&](std::ostream& s) {
+    s << serialized_dtype<T>();
+    serialize_scalar(handle, s, index_.size());
+    serialize_scalar(handle, s, index_.dim());
+    serialize_scalar(handle, s, index_.n_lists());
+    serialize_scalar(handle, s, index_.metric());
+    serialize_scalar(handle, s, index_.adaptive_centers());
+    serialize_scalar(handle, s, index_.conservative_memory_allocation());
+  });
+  writer.section("centers", 0, kRequired, [&](std::ostream& s) {
+    serialize_mdspan(handle, s, index_.centers());
+  });
   if (index_.center_norms()) {
-    bool has_norms = true;
-    serialize_scalar(handle, os, has_norms);
-    serialize_mdspan(handle, os, *index_.center_norms());
-  } else {
-    bool has_norms = false;
-    serialize_scalar(handle, os, has_norms);
+    writer.section("center_norms", 0, kRequired, [&](std::ostream& s) {
+      serialize_mdspan(handle, s, *index_.center_norms());
+    });
   }
   auto sizes_host = raft::make_host_vector<uint32_t, uint32_t>(index_.list_sizes().extent(0));
   raft::copy(sizes_host.data_handle(),
@@ -80,97 +246,299 @@ void serialize(raft::resources const& handle, std::ostream& os, const index<T, I
              sizes_host.size(),
              raft::resource::get_cuda_stream(handle));
   raft::resource::sync_stream(handle);
-  serialize_mdspan(handle, os, sizes_host.view());
+  writer.section("list_sizes", 0, kRequired, [&](std::ostream& s) {
+    serialize_mdspan(handle, s, sizes_host.view());
+  });
 
   list_spec<uint32_t, T, IdxT> list_store_spec{index_.dim(), true};
-  for (uint32_t label = 0; label < index_.n_lists(); label++) {
-    ivf::serialize_list(handle,
-                        os,
-                        index_.lists()[label],
-                        list_store_spec,
-                        raft::Pow2<kIndexGroupSize>::roundUp(sizes_host(label)));
+  auto stored_size = [&](uint64_t label) {
+    return raft::Pow2<kIndexGroupSize>::roundUp(sizes_host(label));
+  };
+  cuvs::neighbors::detail::section_encoding list_encoding;
+  if (compression != serialize_compression::NONE) {
+    list_encoding = {cuvs::neighbors::detail::section_codec::kShuffleLz, sizeof(T)};
   }
+  if (file != nullptr) {
+    const size_t bytes_per_row = index_.dim() * sizeof(T) + sizeof(IdxT);
+    cuvs::neighbors::detail::write_sections_parallel(
+      handle,
+      writer,
+      *file,
+      "list",
+      index_.n_lists(),
+      kRequired,
+      list_encoding,
+      [&](uint64_t label) { return stored_size(label) * bytes_per_row; },
+      [&](raft::resources const& res, uint64_t label, std::ostream& s) {
+        ivf::serialize_list(res, s, index_.lists()[label], list_store_spec, stored_size(label));
+      });
+  } else {
+    for (uint32_t label = 0; label < index_.n_lists(); label++) {
+      writer.section("list", label, kRequired, list_encoding, [&](std::ostream& s) {
+        ivf::serialize_list(handle, s, index_.lists()[label], list_store_spec, stored_size(label));
+      });
+    }
+  }
+  writer.finish();
   raft::resource::sync_stream(handle);
 }
 
 template <typename T, typename IdxT>
 void serialize(raft::resources const& handle,
                const std::string& filename,
-               const index<T, IdxT>& index_)
+               const index<T, IdxT>& index_,
+               serialize_compression compression = serialize_compression::NONE)
 {
   std::ofstream of(filename, std::ios::out | std::ios::binary);
   if (!of) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+  cuvs::core::detail::file_descriptor file(filename, O_WRONLY | O_CLOEXEC);
 
-  detail::serialize(handle, of, index_);
+  detail::serialize(handle, of, index_, compression, &file);
 
   of.close();
   if (!of) { RAFT_FAIL("Error writing output %s", filename.c_str()); }
 }
 
-/** Load an index from file.
+/** Load an index from `source`, an input stream or the name of a file (see `read_sections`). */
+template <typename T, typename IdxT, typename Source>
+auto deserialize_from(raft::resources const& handle, Source& source) -> index<T, IdxT>
+{
+  std::optional<index<T, IdxT>> index_;
+  std::optional<list_spec<uint32_t, T, IdxT>> list_device_spec;
+  std::optional<list_spec<uint32_t, T, IdxT>> list_store_spec;
+  auto on_params = [&](const serialized_params<IdxT>& p) {
+    index_.emplace(handle,
+                   p.metric,
+                   p.n_lists,
+                   p.adaptive_centers,
+                   p.conservative_memory_allocation,
+                   p.dim);
+    list_device_spec.emplace(p.dim, p.conservative_memory_allocation);
+    list_store_spec.emplace(p.dim, true);
+  };
+  auto visit = [&](const cuvs::neighbors::detail::section_info& s,
+                   std::istream& payload,
+                   raft::resources const& res) -> bool {
+    if (s.is("centers")) {
+      deserialize_mdspan(handle, payload, index_->centers());
+    } else if (s.is("center_norms")) {
+      index_->allocate_center_norms(handle);
+      if (!index_->center_norms()) {
+        RAFT_FAIL("Error inconsistent center norms");
+      } else {
+        auto center_norms = index_->center_norms().value();
+        deserialize_mdspan(handle, payload, center_norms);
+      }
+    } else if (s.is("list_sizes")) {
+      deserialize_mdspan(handle, payload, index_->list_sizes());
+    } else if (s.is("list")) {
+      ivf::deserialize_list(
+        res, payload, index_->lists()[s.id], *list_store_spec, *list_device_spec);
+    } else {
+      return false;
+    }
+    return true;
+  };
+  read_sections<T, IdxT>(handle, source, on_params, visit);
+  raft::resource::sync_stream(handle);
+
+  ivf::detail::recompute_internal_state(handle, *index_);
+
+  return std::move(*index_);
+}
+
+/** Load an index from an input stream.
  *
  * Experimental, both the API and the serialization format are subject to change.
  *
  * @param[in] handle the raft handle
- * @param[in] filename the name of the file that stores the index
- * @param[in] index_ IVF-Flat index
+ * @param[in] is input stream
  *
  */
 template <typename T, typename IdxT>
 auto deserialize(raft::resources const& handle, std::istream& is) -> index<T, IdxT>
 {
-  char dtype_string[4];
-  is.read(dtype_string, 4);
+  return deserialize_from<T, IdxT>(handle, is);
+}
 
-  auto ver = raft::deserialize_scalar<int>(handle, is);
-  if (ver != serialization_version) {
-    RAFT_FAIL("serialization version mismatch, expected %d, got %d ", serialization_version, ver);
-  }
-  auto n_rows           = raft::deserialize_scalar<IdxT>(handle, is);
-  auto dim              = raft::deserialize_scalar<std::uint32_t>(handle, is);
-  auto n_lists          = raft::deserialize_scalar<std::uint32_t>(handle, is);
-  auto metric           = raft::deserialize_scalar<cuvs::distance::DistanceType>(handle, is);
-  bool adaptive_centers = raft::deserialize_scalar<bool>(handle, is);
-  bool cma              = raft::deserialize_scalar<bool>(handle, is);
-
-  index<T, IdxT> index_ = index<T, IdxT>(handle, metric, n_lists, adaptive_centers, cma, dim);
-
-  deserialize_mdspan(handle, is, index_.centers());
-  bool has_norms = raft::deserialize_scalar<bool>(handle, is);
-  if (has_norms) {
-    index_.allocate_center_norms(handle);
-    if (!index_.center_norms()) {
-      RAFT_FAIL("Error inconsistent center norms");
+/** Load an index from file; the lists are loaded in parallel.
+ *
+ * Experimental, both the API and the serialization format are subject to change.
+ *
+ * @param[in] handle the raft handle
+ * @param[in] filename the name of the file that stores the index
+ *
+ */
+template <typename T, typename IdxT>
+auto deserialize(raft::resources const& handle, const std::string& filename) -> index<T, IdxT>
+{
+  return deserialize_from<T, IdxT>(handle, filename);
+}
+
+/**
+ * Decode a list section into the host layout of the list, or nothing for an empty list.
+ *
+ * The stored lists are padded to a multiple of the group size, like the lists of the host index.
+ */
+template <typename T, typename IdxT>
+auto deserialize_host_list(raft::resources const& handle,
+                           std::istream& payload,
+                           uint32_t label,
+                           uint32_t dim,
+                           uint32_t list_size)
+  -> std::optional<typename host_index<T, IdxT>::list_type>
+{
+  auto stored_size = raft::deserialize_scalar<uint32_t>(handle, payload);
+  if (stored_size == 0) { return std::nullopt; }
+  RAFT_EXPECTS(stored_size >= list_size && stored_size % kIndexGroupSize == 0,
+               "Inconsistent size of list %u",
+               label);
+  typename host_index<T, IdxT>::list_type list;
+  list.data.resize(size_t(stored_size) * dim);
+  list.indices.resize(stored_size);
+  deserialize_mdspan(
+    handle, payload, raft::make_host_matrix_view<T, uint32_t>(list.data.data(), stored_size, dim));
+  deserialize_mdspan(
+    handle, payload, raft::make_host_vector_view<IdxT, uint32_t>(list.indices.data(), stored_size));
+  return list;
+}
+
+/**
+ * Visitor of `read_sections` loading all sections but the lists into a host index; the index and
+ * the list sizes are created by `on_params`.
+ */
+template <typename T, typename IdxT>
+auto host_index_visitor(raft::resources const& handle,
+                        host_index<T, IdxT>& index_,
+                        std::vector<uint32_t>& list_sizes)
+{
+  return [&](const cuvs::neighbors::detail::section_info& s,
+             std::istream& payload,
+             raft::resources const&) -> bool {
+    if (s.is("centers")) {
+      deserialize_mdspan(handle, payload, index_.centers());
+    } else if (s.is("center_norms")) {
+      // The host search computes the L2 distances to the centers directly.
+      auto center_norms = raft::make_host_vector<float, uint32_t>(index_.n_lists());
+      deserialize_mdspan(handle, payload, center_norms.view());
+    } else if (s.is("list_sizes")) {
+      deserialize_mdspan(handle,
+                         payload,
+                         raft::make_host_vector_view<uint32_t, uint32_t>(list_sizes.data(),
+                                                                         index_.n_lists()));
     } else {
-      auto center_norms = index_.center_norms().value();
-      deserialize_mdspan(handle, is, center_norms);
+      return false;
     }
-  }
-  deserialize_mdspan(handle, is, index_.list_sizes());
-
-  list_spec<uint32_t, T, IdxT> list_device_spec{index_.dim(), cma};
-  list_spec<uint32_t, T, IdxT> list_store_spec{index_.dim(), true};
-  for (uint32_t label = 0; label < index_.n_lists(); label++) {
-    ivf::deserialize_list(handle, is, index_.lists()[label], list_store_spec, list_device_spec);
-  }
-  raft::resource::sync_stream(handle);
+    return true;
+  };
+}
 
-  ivf::detail::recompute_internal_state(handle, index_);
+/**
+ * Load an index saved by `serialize` into host memory, for the host search.
+ *
+ * The file format is the same; the list data keeps its interleaved layout and padding.
+ */
+template <typename T, typename IdxT>
+auto deserialize_host(raft::resources const& handle, std::istream& is) -> host_index<T, IdxT>
+{
+  host_index<T, IdxT> index_;
+  std::vector<uint32_t> list_sizes;
+  auto on_params = [&](const serialized_params<IdxT>& p) {
+    index_ = host_index<T, IdxT>(p.metric, p.n_lists, p.dim);
+    list_sizes.assign(p.n_lists, 0);
+  };
+  auto visit_other = host_index_visitor<T, IdxT>(handle, index_, list_sizes);
+  auto visit       = [&](const cuvs::neighbors::detail::section_info& s,
+                   std::istream& payload,
+                   raft::resources const& res) -> bool {
+    if (!s.is("list")) { return visit_other(s, payload, res); }
+    auto label = static_cast<uint32_t>(s.id);
+    auto list =
+      deserialize_host_list<T, IdxT>(handle, payload, label, index_.dim(), list_sizes[label]);
+    if (list.has_value()) {
+      index_.set_list(label, list_sizes[label], std::move(list->data), std::move(list->indices));
+    }
+    return true;
+  };
+  read_sections<T, IdxT>(handle, is, on_params, visit);
 
   return index_;
 }
 
 template <typename T, typename IdxT>
-auto deserialize(raft::resources const& handle, const std::string& filename) -> index<T, IdxT>
+auto deserialize_host(raft::resources const& handle, const std::string& filename)
+  -> host_index<T, IdxT>
 {
   std::ifstream is(filename, std::ios::in | std::ios::binary);
 
   if (!is) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
 
-  auto index = detail::deserialize<T, IdxT>(handle, is);
+  auto index = detail::deserialize_host<T, IdxT>(handle, is);
 
   is.close();
 
   return index;
 }
+
+/**
+ * Load an index file into host memory, with its lists loaded on demand if
+ * `load_params.lazy_lists` (see `ivf::host_load_params`).
+ *
+ * Only the lists are loaded lazily; the file must be a container (version 5 or newer).
+ */
+template <typename T, typename IdxT>
+auto deserialize_host(raft::resources const& handle,
+                      const std::string& filename,
+                      const ivf::host_load_params& load_params) -> host_index<T, IdxT>
+{
+  if (!load_params.lazy_lists) { return deserialize_host<T, IdxT>(handle, filename); }
+
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  if (!is) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+  auto prefix = cuvs::neighbors::detail::read_container_prefix(is);
+  RAFT_EXPECTS(cuvs::neighbors::detail::is_container(prefix),
+               "Loading the lists on demand needs an IVF-Flat index file of version %d or newer",
+               serialization_version);
+  auto toc =
+    cuvs::neighbors::detail::read_container_toc(is, kContainerKind, serialization_version);
+  for (auto name : kRequiredSections) {
+    RAFT_EXPECTS(toc.find(name) != nullptr,
+                 "The IVF-Flat index misses the section '%s'",
+                 std::string(name).c_str());
+  }
+
+  host_index<T, IdxT> index_;
+  std::vector<uint32_t> list_sizes;
+  std::optional<serialized_params<IdxT>> params;
+  auto on_params = [&](const serialized_params<IdxT>& p) {
+    index_ = host_index<T, IdxT>(p.metric, p.n_lists, p.dim);
+    list_sizes.assign(p.n_lists, 0);
+  };
+  auto visit_other = host_index_visitor<T, IdxT>(handle, index_, list_sizes);
+  auto checked     = check_sections<T, IdxT>(handle, params, on_params, visit_other);
+  for (const auto& s : toc.sections) {
+    if (s.is("list")) { continue; }
+    bool handled = false;
+    cuvs::neighbors::detail::read_container_section(
+      is, toc, s, [&](std::istream& payload) { handled = checked(s, payload, handle); });
+    cuvs::neighbors::detail::container_detail::check_section_handled(s, handled);
+  }
+
+  using list_type = typename host_index<T, IdxT>::list_type;
+  auto decode     = [dim = index_.dim(), list_sizes](uint32_t label, std::istream& payload)
+    -> std::pair<std::shared_ptr<const list_type>, size_t> {
+    // Decoding into host memory uses no resources of the handle; the search threads decode
+    // concurrently, each with its own.
+    raft::resources res;
+    auto list = deserialize_host_list<T, IdxT>(res, payload, label, dim, list_sizes[label]);
+    if (!list.has_value()) { return {nullptr, 0}; }
+    const size_t bytes = list->data.size() * sizeof(T) + list->indices.size() * sizeof(IdxT);
+    return {std::make_shared<const list_type>(std::move(*list)), bytes};
+  };
+  index_.set_list_loader(
+    std::make_shared<cuvs::neighbors::detail::mapped_list_cache<list_type>>(
+      filename, toc, "list", index_.n_lists(), load_params.max_resident_list_bytes, decode),
+    list_sizes);
+  return index_;
+}
 }  // namespace cuvs::neighbors::ivf_flat::detail
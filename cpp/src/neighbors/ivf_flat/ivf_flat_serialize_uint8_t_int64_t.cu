@@ -32,20 +32,30 @@ namespace cuvs::neighbors::ivf_flat {
 #define CUVS_INST_IVF_FLAT_SERIALIZE(T, IdxT)                                           \
   void serialize_file(raft::resources const& handle,                                    \
                       const std::string& filename,                                      \
-                      const cuvs::neighbors::ivf_flat::index<T, IdxT>& index)           \
+                      const cuvs::neighbors::ivf_flat::index<T, IdxT>& index,           \
+                      cuvs::neighbors::serialize_compression compression)               \
   {                                                                                     \
-    cuvs::neighbors::ivf_flat::detail::serialize(handle, filename, index);              \
+    cuvs::neighbors::ivf_flat::detail::serialize(handle, filename, index, compression); \
   }                                                                                     \
                                                                                         \
   void serialize(raft::resources const& handle,                                         \
                  std::string& str,                                                      \
-                 const cuvs::neighbors::ivf_flat::index<T, IdxT>& index)                \
+                 const cuvs::neighbors::ivf_flat::index<T, IdxT>& index,                \
+                 cuvs::neighbors::serialize_compression compression)                    \
   {                                                                                     \
     std::ostringstream os;                                                              \
-    cuvs::neighbors::ivf_flat::detail::serialize(handle, os, index);                    \
+    cuvs::neighbors::ivf_flat::detail::serialize(handle, os, index, compression);       \
     str = os.str();                                                                     \
   }                                                                                     \
                                                                                         \
+  void serialize(raft::resources const& handle,                                         \
+                 std::ostream& os,                                                      \
+                 const cuvs::neighbors::ivf_flat::index<T, IdxT>& index,                \
+                 cuvs::neighbors::serialize_compression compression)                    \
+  {                                                                                     \
+    cuvs::neighbors::ivf_flat::detail::serialize(handle, os, index, compression);       \
+  }                                                                                     \
+                                                                                        \
   void deserialize_file(raft::resources const& handle,                                  \
                         const std::string& filename,                                    \
                         cuvs::neighbors::ivf_flat::index<T, IdxT>* index)               \
@@ -58,6 +68,35 @@ namespace cuvs::neighbors::ivf_flat {
   {                                                                                     \
     std::istringstream is(str);                                                         \
     *index = cuvs::neighbors::ivf_flat::detail::deserialize<T, IdxT>(handle, is);       \
+  }                                                                                     \
+  void deserialize(raft::resources const& handle,                                       \
+                   std::istream& is,                                                    \
+                   cuvs::neighbors::ivf_flat::index<T, IdxT>* index)                    \
+  {                                                                                     \
+    *index = cuvs::neighbors::ivf_flat::detail::deserialize<T, IdxT>(handle, is);       \
+  }                                                                                     \
+                                                                                        \
+  void deserialize_host_file(raft::resources const& handle,                             \
+                             const std::string& filename,                               \
+                             cuvs::neighbors::ivf_flat::host_index<T, IdxT>* index)     \
+  {                                                                                     \
+    *index =                                                                            \
+      cuvs::neighbors::ivf_flat::detail::deserialize_host<T, IdxT>(handle, filename);   \
+  }                                                                                     \
+  void deserialize_host_file(raft::resources const& handle,                             \
+                             const std::string& filename,                               \
+                             const cuvs::neighbors::ivf::host_load_params& params,      \
+                             cuvs::neighbors::ivf_flat::host_index<T, IdxT>* index)     \
+  {                                                                                     \
+    *index = cuvs::neighbors::ivf_flat::detail::deserialize_host<T, IdxT>(              \
+      handle, filename, params);                                                        \
+  }                                                                                     \
+  void deserialize_host(raft::resources const& handle,                                  \
+                        const std::string& str,                                         \
+                        cuvs::neighbors::ivf_flat::host_index<T, IdxT>* index)          \
+  {                                                                                     \
+    std::istringstream is(str);                                                         \
+    *index = cuvs::neighbors::ivf_flat::detail::deserialize_host<T, IdxT>(handle, is);  \
   }
 CUVS_INST_IVF_FLAT_SERIALIZE(uint8_t, int64_t);
 
@@ -17,10 +17,13 @@
 
 #include <cstdint>
 #include <dlpack/dlpack.h>
+#include <fstream>
+#include <string>
 
 #include <raft/core/error.hpp>
 #include <raft/core/mdspan_types.hpp>
 #include <raft/core/resources.hpp>
+#include <raft/core/serialize.hpp>
 
 #include <cuvs/core/c_api.h>
 #include <cuvs/core/exceptions.hpp>
@@ -28,6 +31,9 @@
 #include <cuvs/neighbors/ivf_flat.h>
 #include <cuvs/neighbors/ivf_flat.hpp>
 
+#include "../core/c_api_stream.hpp"
+#include "detail/container_serialize.hpp"
+
 namespace {
 
 template <typename T, typename IdxT>
@@ -83,6 +89,77 @@ void _search(cuvsResources_t res,
     *res_ptr, search_params, *index_ptr, queries_mds, neighbors_mds, distances_mds);
 }
 
+template <typename T, typename IdxT>
+void _serialize(cuvsResources_t res, std::ostream& os, cuvsIvfFlatIndex index)
+{
+  auto res_ptr   = reinterpret_cast<raft::resources*>(res);
+  auto index_ptr = reinterpret_cast<cuvs::neighbors::ivf_flat::index<T, IdxT>*>(index.addr);
+  cuvs::neighbors::ivf_flat::serialize(*res_ptr, os, *index_ptr);
+}
+
+void _serialize(cuvsResources_t res, std::ostream& os, cuvsIvfFlatIndex_t index)
+{
+  if (index->dtype.code == kDLFloat) {
+    _serialize<float, int64_t>(res, os, *index);
+  } else if (index->dtype.code == kDLInt) {
+    _serialize<int8_t, int64_t>(res, os, *index);
+  } else if (index->dtype.code == kDLUInt) {
+    _serialize<uint8_t, int64_t>(res, os, *index);
+  } else {
+    RAFT_FAIL("Unsupported index dtype: %d and bits: %d", index->dtype.code, index->dtype.bits);
+  }
+  os.flush();
+  RAFT_EXPECTS(os.good(), "Error writing the IVF-Flat index");
+}
+
+/** Load an index from `is`, or from `filename` if it is set. */
+template <typename T, typename IdxT>
+void* _deserialize(cuvsResources_t res, std::istream& is, const char* filename)
+{
+  auto res_ptr = reinterpret_cast<raft::resources*>(res);
+  auto index   = new cuvs::neighbors::ivf_flat::index<T, IdxT>(
+    *res_ptr, cuvs::distance::DistanceType::L2Expanded, 0, false, false, 0);
+  try {
+    if (filename != nullptr) {
+      cuvs::neighbors::ivf_flat::deserialize_file(*res_ptr, std::string(filename), index);
+    } else {
+      cuvs::neighbors::ivf_flat::deserialize(*res_ptr, is, index);
+    }
+  } catch (...) {
+    delete index;
+    throw;
+  }
+  return index;
+}
+
+/**
+ * Load an index of the data type given by the beginning of the index, which `header` reads, from
+ * `is` or `filename` (see `_deserialize`).
+ */
+void _deserialize(cuvsResources_t res,
+                  std::istream& header,
+                  std::istream& is,
+                  const char* filename,
+                  cuvsIvfFlatIndex_t index)
+{
+  auto dtype_string = cuvs::neighbors::detail::read_index_dtype(header, "ivf_flat");
+  auto dtype        = raft::detail::numpy_serializer::parse_descr(dtype_string);
+
+  index->dtype.bits = dtype.itemsize * 8;
+  if (dtype.kind == 'f' && dtype.itemsize == 4) {
+    index->addr = reinterpret_cast<uintptr_t>(_deserialize<float, int64_t>(res, is, filename));
+    index->dtype.code = kDLFloat;
+  } else if (dtype.kind == 'i' && dtype.itemsize == 1) {
+    index->addr = reinterpret_cast<uintptr_t>(_deserialize<int8_t, int64_t>(res, is, filename));
+    index->dtype.code = kDLInt;
+  } else if (dtype.kind == 'u' && dtype.itemsize == 1) {
+    index->addr = reinterpret_cast<uintptr_t>(_deserialize<uint8_t, int64_t>(res, is, filename));
+    index->dtype.code = kDLUInt;
+  } else {
+    RAFT_FAIL("Unsupported dtype of the IVF-Flat index");
+  }
+}
+
 }  // namespace
 
 extern "C" cuvsError_t cuvsIvfFlatIndexCreate(cuvsIvfFlatIndex_t* index)
@@ -213,3 +290,68 @@ extern "C" cuvsError_t cuvsIvfFlatSearchParamsDestroy(cuvsIvfFlatSearchParams_t
 {
   return cuvs::core::translate_exceptions([=] { delete params; });
 }
+
+extern "C" cuvsError_t cuvsIvfFlatSerialize(cuvsResources_t res,
+                                            const char* filename,
+                                            cuvsIvfFlatIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    if (!os) { RAFT_FAIL("Cannot open file %s", filename); }
+    _serialize(res, os, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfFlatSerializeToStream(cuvsResources_t res,
+                                                    cuvsWriteCallback write,
+                                                    void* context,
+                                                    cuvsIvfFlatIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::core::detail::callback_writebuf buf(write, context);
+    std::ostream os(&buf);
+    _serialize(res, os, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfFlatDeserialize(cuvsResources_t res,
+                                              const char* filename,
+                                              cuvsIvfFlatIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    std::ifstream is(filename, std::ios::in | std::ios::binary);
+    if (!is) { RAFT_FAIL("Cannot open file %s", filename); }
+    _deserialize(res, is, is, filename, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfFlatDeserializeFromStream(cuvsResources_t res,
+                                                        cuvsReadCallback read,
+                                                        void* context,
+                                                        cuvsIvfFlatIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::core::detail::callback_readbuf buf(read, context);
+    auto first_bytes = buf.peek(cuvs::core::detail::callback_readbuf::kBufferBytes);
+    cuvs::neighbors::detail::memory_readbuf header_buf(
+      reinterpret_cast<const uint8_t*>(first_bytes.data()), first_bytes.size());
+    std::istream header(&header_buf);
+    std::istream is(&buf);
+    _deserialize(res, header, is, nullptr, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfFlatDeserializeFromBuffer(cuvsResources_t res,
+                                                        const void* data,
+                                                        size_t size,
+                                                        cuvsIvfFlatIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    auto bytes = static_cast<const uint8_t*>(data);
+    cuvs::neighbors::detail::memory_readbuf header_buf(bytes, size);
+    cuvs::neighbors::detail::memory_readbuf buf(bytes, size);
+    std::istream header(&header_buf);
+    std::istream is(&buf);
+    _deserialize(res, header, is, nullptr, index);
+  });
+}
@@ -45,6 +45,7 @@ build_include_macro = """
 """
 search_include_macro = """
 #include "../ivf_pq_search.cuh"
+#include "../ivf_pq_search_host.hpp"
 """
 
 namespace_macro = """
@@ -74,6 +75,17 @@ search_macro = """
   {                                                                             \\
     cuvs::neighbors::ivf_pq::detail::search(                                   \\
       handle, params, index, queries, neighbors, distances);  \\
+  }                                                                             \\
+  void search(raft::resources const& handle,                                    \\
+              const cuvs::neighbors::ivf_pq::search_params& params,             \\
+              const cuvs::neighbors::ivf_pq::host_index<IdxT>& index,           \\
+              raft::host_matrix_view<const T, IdxT, raft::row_major> queries,   \\
+              raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,    \\
+              raft::host_matrix_view<float, IdxT, raft::row_major> distances)   \\
+  {                                                                             \\
+    cuvs::neighbors::ivf_pq::detail::search_host(                               \\
+      handle, params, index, queries, neighbors, distances,                     \\
+      cuvs::neighbors::filtering::none_ivf_sample_filter());                    \\
   }
 """
 search_with_filter_macro = """
@@ -89,6 +101,18 @@ search_with_filter_macro = """
   {                                                                             \\
     cuvs::neighbors::ivf_pq::detail::search_with_filtering(                     \\
       handle, params, index, queries, neighbors, distances, sample_filter);     \\
+  }                                                                             \\
+  void search_with_filtering(raft::resources const& handle,                     \\
+              const cuvs::neighbors::ivf_pq::search_params& params,             \\
+              const cuvs::neighbors::ivf_pq::host_index<IdxT>& index,           \\
+              raft::host_matrix_view<const T, IdxT, raft::row_major> queries,   \\
+              raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,    \\
+              raft::host_matrix_view<float, IdxT, raft::row_major> distances,   \\
+              cuvs::neighbors::filtering::bitset_filter<                        \\
+                  uint32_t, IdxT> sample_filter)                                \\
+  {                                                                             \\
+    cuvs::neighbors::ivf_pq::detail::search_host(                               \\
+      handle, params, index, queries, neighbors, distances, sample_filter);     \\
   }
 """
 
@@ -26,6 +26,7 @@
 #include <cuvs/neighbors/ivf_pq.hpp>
 
 #include "../ivf_pq_search.cuh"
+#include "../ivf_pq_search_host.hpp"
 
 namespace cuvs::neighbors::ivf_pq {
 
@@ -38,6 +39,22 @@ namespace cuvs::neighbors::ivf_pq {
               raft::device_matrix_view<float, IdxT, raft::row_major> distances)                    \
   {                                                                                                \
     cuvs::neighbors::ivf_pq::detail::search(handle, params, index, queries, neighbors, distances); \
+  }                                                                                                \
+  void search(raft::resources const& handle,                                                       \
+              const cuvs::neighbors::ivf_pq::search_params& params,                                \
+              const cuvs::neighbors::ivf_pq::host_index<IdxT>& index,                              \
+              raft::host_matrix_view<const T, IdxT, raft::row_major> queries,                      \
+              raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,                       \
+              raft::host_matrix_view<float, IdxT, raft::row_major> distances)                      \
+  {                                                                                                \
+    cuvs::neighbors::ivf_pq::detail::search_host(                                                  \
+      handle,                                                                                      \
+      params,                                                                                      \
+      index,                                                                                       \
+      queries,                                                                                     \
+      neighbors,                                                                                   \
+      distances,                                                                                   \
+      cuvs::neighbors::filtering::none_ivf_sample_filter());                                       \
   }
 CUVS_INST_IVF_PQ_SEARCH(int8_t, int64_t);
 
@@ -26,6 +26,7 @@
 #include <cuvs/neighbors/ivf_pq.hpp>
 
 #include "../ivf_pq_search.cuh"
+#include "../ivf_pq_search_host.hpp"
 
 namespace cuvs::neighbors::ivf_pq {
 
@@ -41,6 +42,18 @@ namespace cuvs::neighbors::ivf_pq {
   {                                                                          \
     cuvs::neighbors::ivf_pq::detail::search_with_filtering(                  \
       handle, params, index, queries, neighbors, distances, sample_filter);  \
+  }                                                                          \
+  void search_with_filtering(                                                \
+    raft::resources const& handle,                                           \
+    const cuvs::neighbors::ivf_pq::search_params& params,                    \
+    const cuvs::neighbors::ivf_pq::host_index<IdxT>& index,                  \
+    raft::host_matrix_view<const T, IdxT, raft::row_major> queries,          \
+    raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,           \
+    raft::host_matrix_view<float, IdxT, raft::row_major> distances,          \
+    cuvs::neighbors::filtering::bitset_filter<uint32_t, IdxT> sample_filter) \
+  {                                                                          \
+    cuvs::neighbors::ivf_pq::detail::search_host(                            \
+      handle, params, index, queries, neighbors, distances, sample_filter);  \
   }
 CUVS_INST_IVF_PQ_SEARCH_FILTER(float, int64_t);
 
@@ -1444,6 +1444,7 @@ auto clone(const raft::resources& res, const index<IdxT>& source) -> index<IdxT>
                      source.dim(),
                      source.pq_bits(),
                      source.pq_dim());
+  target.set_data_type(source.data_type());
 
   // raft::copy the independent parts
   raft::copy(target.list_sizes().data_handle(),
@@ -1682,6 +1683,7 @@ auto build(raft::resources const& handle,
   auto stream = raft::resource::get_cuda_stream(handle);
 
   index<IdxT> index(handle, params, dim);
+  index.set_data_type(utils::config<T>::kDataType);
   utils::memzero(
     index.accum_sorted_sizes().data_handle(), index.accum_sorted_sizes().size(), stream);
   utils::memzero(index.list_sizes().data_handle(), index.list_sizes().size(), stream);
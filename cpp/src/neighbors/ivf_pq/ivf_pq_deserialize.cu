@@ -36,4 +36,38 @@ void deserialize(raft::resources const& handle,
   std::istringstream is(str);
   *index = cuvs::neighbors::ivf_pq::detail::deserialize<int64_t>(handle, is);
 }
+
+void deserialize(raft::resources const& handle,
+                 std::istream& is,
+                 cuvs::neighbors::ivf_pq::index<int64_t>* index)
+{
+  if (!index) { RAFT_FAIL("Invalid index pointer"); }
+  *index = cuvs::neighbors::ivf_pq::detail::deserialize<int64_t>(handle, is);
+}
+
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           cuvs::neighbors::ivf_pq::host_index<int64_t>* index)
+{
+  if (!index) { RAFT_FAIL("Invalid index pointer"); }
+  *index = cuvs::neighbors::ivf_pq::detail::deserialize_host<int64_t>(handle, filename);
+}
+
+void deserialize_host_file(raft::resources const& handle,
+                           const std::string& filename,
+                           const cuvs::neighbors::ivf::host_load_params& params,
+                           cuvs::neighbors::ivf_pq::host_index<int64_t>* index)
+{
+  if (!index) { RAFT_FAIL("Invalid index pointer"); }
+  *index = cuvs::neighbors::ivf_pq::detail::deserialize_host<int64_t>(handle, filename, params);
+}
+
+void deserialize_host(raft::resources const& handle,
+                      const std::string& str,
+                      cuvs::neighbors::ivf_pq::host_index<int64_t>* index)
+{
+  if (!index) { RAFT_FAIL("Invalid index pointer"); }
+  std::istringstream is(str);
+  *index = cuvs::neighbors::ivf_pq::detail::deserialize_host<int64_t>(handle, is);
+}
 }  // namespace cuvs::neighbors::ivf_pq
\ No newline at end of file
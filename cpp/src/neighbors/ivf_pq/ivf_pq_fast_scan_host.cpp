@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host (CPU) kernels scanning the 4-bit PQ codes of IVF-PQ lists with in-register lookup tables.
+ *
+ * With 4-bit codes a subspace has 16 possible values, so its quantized lookup table fits into a
+ * 128-bit register and a byte shuffle looks up 16 (SSE/NEON), 32 (AVX2) or 64 (AVX-512) codes at
+ * once. A byte of a chunk holds the codes of two subspaces, in its low and high nibble; in the
+ * transposed group layout the same byte of all 32 vectors of a group is contiguous, so one load
+ * brings the codes of a subspace pair for the whole group.
+ *
+ * The looked-up bytes are accumulated in 16-bit lanes, the even and odd vectors separately, which
+ * avoids widening the bytes across the register lanes. As with the host distance kernels, the x86
+ * kernels use function-level `target` attributes and are selected at run time.
+ */
+
+#include "ivf_pq_fast_scan_host.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CUVS_HOST_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CUVS_HOST_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cuvs::neighbors::ivf_pq::detail::host {
+
+namespace {
+
+using cuvs::distance::detail::host::simd_isa;
+
+/** Bytes of a transposed chunk of a group. */
+constexpr uint32_t kChunkBytes = kIndexGroupVecLen * kIndexGroupSize;
+/** Bytes of the lookup tables of the subspaces of one chunk. */
+constexpr uint32_t kChunkLutBytes = kFastScanChunkDim * 16;
+
+void fast_scan_scalar(const uint8_t* lut, const uint8_t* group, uint32_t n_chunks, uint16_t* out)
+{
+  uint32_t acc[kIndexGroupSize] = {};
+  for (uint32_t c = 0; c < n_chunks; c++, lut += kChunkLutBytes, group += kChunkBytes) {
+    for (uint32_t b = 0; b < kIndexGroupVecLen; b++) {
+      const uint8_t* codes  = group + b * kIndexGroupSize;
+      const uint8_t* lut_lo = lut + b * 32;
+      const uint8_t* lut_hi = lut_lo + 16;
+      for (uint32_t r = 0; r < kIndexGroupSize; r++) {
+        acc[r] += lut_lo[codes[r] & 0x0f] + lut_hi[codes[r] >> 4];
+      }
+    }
+  }
+  for (uint32_t r = 0; r < kIndexGroupSize; r++) {
+    out[r] = static_cast<uint16_t>(acc[r]);
+  }
+}
+
+#ifdef CUVS_HOST_SIMD_X86
+
+/* ---------------------------------------- AVX2 ---------------------------------------------- */
+
+__attribute__((target("avx2"))) void fast_scan_avx2(const uint8_t* lut,
+                                                    const uint8_t* group,
+                                                    uint32_t n_chunks,
+                                                    uint16_t* out)
+{
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  const __m256i even_mask   = _mm256_set1_epi16(0x00ff);
+  __m256i acc_even          = _mm256_setzero_si256();
+  __m256i acc_odd           = _mm256_setzero_si256();
+  for (uint32_t c = 0; c < n_chunks; c++, lut += kChunkLutBytes, group += kChunkBytes) {
+    for (uint32_t b = 0; b < kIndexGroupVecLen; b++) {
+      const uint8_t* t = lut + b * 32;
+      __m256i codes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(group + b * kIndexGroupSize));
+      __m256i lut_lo =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t)));
+      __m256i lut_hi =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t + 16)));
+      __m256i s_lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(codes, nibble_mask));
+      __m256i s_hi =
+        _mm256_shuffle_epi8(lut_hi, _mm256_and_si256(_mm256_srli_epi16(codes, 4), nibble_mask));
+      acc_even = _mm256_add_epi16(acc_even, _mm256_and_si256(s_lo, even_mask));
+      acc_even = _mm256_add_epi16(acc_even, _mm256_and_si256(s_hi, even_mask));
+      acc_odd  = _mm256_add_epi16(acc_odd, _mm256_srli_epi16(s_lo, 8));
+      acc_odd  = _mm256_add_epi16(acc_odd, _mm256_srli_epi16(s_hi, 8));
+    }
+  }
+  alignas(32) uint16_t even[16];
+  alignas(32) uint16_t odd[16];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(even), acc_even);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(odd), acc_odd);
+  for (uint32_t k = 0; k < 16; k++) {
+    out[2 * k]     = even[k];
+    out[2 * k + 1] = odd[k];
+  }
+}
+
+/* --------------------------------------- AVX-512 --------------------------------------------- */
+
+/*
+ * One 512-bit load brings the codes of two consecutive bytes (four subspaces) of the group; the
+ * 128-bit lanes of the shuffled tables are arranged to match: [t0, t0, t2, t2] for the low nibbles
+ * and [t1, t1, t3, t3] for the high nibbles.
+ */
+__attribute__((target("avx512f,avx512bw"))) void fast_scan_avx512(const uint8_t* lut,
+                                                                  const uint8_t* group,
+                                                                  uint32_t n_chunks,
+                                                                  uint16_t* out)
+{
+  const __m512i nibble_mask = _mm512_set1_epi8(0x0f);
+  const __m512i even_mask   = _mm512_set1_epi16(0x00ff);
+  __m512i acc_even          = _mm512_setzero_si512();
+  __m512i acc_odd           = _mm512_setzero_si512();
+  for (uint32_t c = 0; c < n_chunks; c++, lut += kChunkLutBytes, group += kChunkBytes) {
+    for (uint32_t b = 0; b < kIndexGroupVecLen; b += 2) {
+      __m512i tables = _mm512_loadu_si512(lut + b * 32);
+      __m512i codes  = _mm512_loadu_si512(group + b * kIndexGroupSize);
+      __m512i lut_lo = _mm512_shuffle_i64x2(tables, tables, 0xa0);
+      __m512i lut_hi = _mm512_shuffle_i64x2(tables, tables, 0xf5);
+      __m512i s_lo   = _mm512_shuffle_epi8(lut_lo, _mm512_and_si512(codes, nibble_mask));
+      __m512i s_hi =
+        _mm512_shuffle_epi8(lut_hi, _mm512_and_si512(_mm512_srli_epi16(codes, 4), nibble_mask));
+      acc_even = _mm512_add_epi16(acc_even, _mm512_and_si512(s_lo, even_mask));
+      acc_even = _mm512_add_epi16(acc_even, _mm512_and_si512(s_hi, even_mask));
+      acc_odd  = _mm512_add_epi16(acc_odd, _mm512_srli_epi16(s_lo, 8));
+      acc_odd  = _mm512_add_epi16(acc_odd, _mm512_srli_epi16(s_hi, 8));
+    }
+  }
+  // The upper halves of the accumulators hold the sums of the odd bytes of the chunks.
+  alignas(64) uint16_t even[32];
+  alignas(64) uint16_t odd[32];
+  _mm512_store_si512(even, acc_even);
+  _mm512_store_si512(odd, acc_odd);
+  for (uint32_t k = 0; k < 16; k++) {
+    out[2 * k]     = even[k] + even[k + 16];
+    out[2 * k + 1] = odd[k] + odd[k + 16];
+  }
+}
+
+#endif  // CUVS_HOST_SIMD_X86
+
+#ifdef CUVS_HOST_SIMD_NEON
+
+/* ---------------------------------------- NEON ---------------------------------------------- */
+
+void fast_scan_neon(const uint8_t* lut, const uint8_t* group, uint32_t n_chunks, uint16_t* out)
+{
+  const uint8x16_t nibble_mask = vdupq_n_u8(0x0f);
+  const uint16x8_t even_mask   = vdupq_n_u16(0x00ff);
+  uint16x8_t acc_even[2]       = {vdupq_n_u16(0), vdupq_n_u16(0)};
+  uint16x8_t acc_odd[2]        = {vdupq_n_u16(0), vdupq_n_u16(0)};
+  for (uint32_t c = 0; c < n_chunks; c++, lut += kChunkLutBytes, group += kChunkBytes) {
+    for (uint32_t b = 0; b < kIndexGroupVecLen; b++) {
+      uint8x16_t lut_lo = vld1q_u8(lut + b * 32);
+      uint8x16_t lut_hi = vld1q_u8(lut + b * 32 + 16);
+      for (uint32_t h = 0; h < 2; h++) {
+        uint8x16_t codes = vld1q_u8(group + b * kIndexGroupSize + h * 16);
+        uint16x8_t s_lo  = vreinterpretq_u16_u8(vqtbl1q_u8(lut_lo, vandq_u8(codes, nibble_mask)));
+        uint16x8_t s_hi  = vreinterpretq_u16_u8(vqtbl1q_u8(lut_hi, vshrq_n_u8(codes, 4)));
+        acc_even[h]      = vaddq_u16(acc_even[h], vandq_u16(s_lo, even_mask));
+        acc_even[h]      = vaddq_u16(acc_even[h], vandq_u16(s_hi, even_mask));
+        acc_odd[h]       = vaddq_u16(acc_odd[h], vshrq_n_u16(s_lo, 8));
+        acc_odd[h]       = vaddq_u16(acc_odd[h], vshrq_n_u16(s_hi, 8));
+      }
+    }
+  }
+  uint16_t even[16];
+  uint16_t odd[16];
+  for (uint32_t h = 0; h < 2; h++) {
+    vst1q_u16(even + h * 8, acc_even[h]);
+    vst1q_u16(odd + h * 8, acc_odd[h]);
+  }
+  for (uint32_t k = 0; k < 16; k++) {
+    out[2 * k]     = even[k];
+    out[2 * k + 1] = odd[k];
+  }
+}
+
+#endif  // CUVS_HOST_SIMD_NEON
+
+}  // namespace
+
+auto get_fast_scan_kernel(simd_isa isa) -> fast_scan_kernel
+{
+  switch (isa) {
+#if defined(CUVS_HOST_SIMD_X86)
+    case simd_isa::kAvx2: return &fast_scan_avx2;
+    case simd_isa::kAvx512: return &fast_scan_avx512;
+#elif defined(CUVS_HOST_SIMD_NEON)
+    case simd_isa::kNeon: return &fast_scan_neon;
+#endif
+    default: return &fast_scan_scalar;
+  }
+}
+
+}  // namespace cuvs::neighbors::ivf_pq::detail::host
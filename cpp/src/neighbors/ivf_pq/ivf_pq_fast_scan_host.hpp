@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../distance/detail/host_distance.hpp"
+
+#include <cuvs/neighbors/ivf_pq.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cuvs::neighbors::ivf_pq::detail::host {
+
+/** Number of subspaces encoded by one chunk of 4-bit codes. */
+constexpr uint32_t kFastScanChunkDim = kIndexGroupVecLen * 2;
+
+/**
+ * Sum the 8-bit lookup table entries of the 4-bit PQ codes of the `kIndexGroupSize` vectors of one
+ * group (in the transposed layout of `host_index`).
+ *
+ * @param lut the quantized lookup table [n_chunks * kFastScanChunkDim, 16]; the entries of the
+ *   subspaces beyond `pq_dim` must be zero.
+ * @param group the codes of the group [n_chunks, kIndexGroupVecLen, kIndexGroupSize]
+ * @param n_chunks number of chunks per vector (`host_index::pq_chunks`)
+ * @param out the sums [kIndexGroupSize]; the caller guarantees they fit into 16 bits.
+ */
+using fast_scan_kernel = void (*)(const uint8_t* lut,
+                                  const uint8_t* group,
+                                  uint32_t n_chunks,
+                                  uint16_t* out);
+
+/**
+ * Get the 4-bit fast-scan kernel for the given instruction set.
+ *
+ * The SIMD kernels keep the 16-entry tables of two subspaces in registers and look up 32 codes at
+ * once with byte shuffles (`pshufb` / `tbl`). If the instruction set is not available in this
+ * build, the scalar kernel is returned.
+ */
+auto get_fast_scan_kernel(cuvs::distance::detail::host::simd_isa isa) -> fast_scan_kernel;
+
+/** Get the kernel for the instruction set selected by the runtime CPU dispatch. */
+inline auto get_fast_scan_kernel() -> fast_scan_kernel
+{
+  static const fast_scan_kernel kernel =
+    get_fast_scan_kernel(cuvs::distance::detail::host::detected_simd_isa());
+  return kernel;
+}
+
+/**
+ * Sum the lookup table entries of the PQ codes of the `kIndexGroupSize` vectors of one group, for
+ * any `pq_bits` (in the transposed layout of `host_index`).
+ *
+ * The loop over the vectors of the group is innermost, which lets the compiler vectorize it.
+ *
+ * @tparam LutT lookup table element type
+ * @tparam AccT accumulator type
+ *
+ * @param lut the lookup table [pq_dim, 1 << pq_bits]
+ * @param group the codes of the group
+ * @param pq_bits
+ * @param pq_dim
+ * @param out the sums [kIndexGroupSize]
+ */
+template <typename LutT, typename AccT>
+inline void scan_group(
+  const LutT* lut, const uint8_t* group, uint32_t pq_bits, uint32_t pq_dim, AccT* out)
+{
+  const uint32_t chunk_dim = (kIndexGroupVecLen * 8u) / pq_bits;
+  const uint32_t mask      = (1u << pq_bits) - 1u;
+  for (uint32_t r = 0; r < kIndexGroupSize; r++) {
+    out[r] = 0;
+  }
+  for (uint32_t j = 0; j < pq_dim; j++) {
+    const uint32_t bit_offset = (j % chunk_dim) * pq_bits;
+    const uint32_t shift      = bit_offset % 8u;
+    const uint8_t* lo =
+      group + (size_t(j / chunk_dim) * kIndexGroupVecLen + bit_offset / 8u) * kIndexGroupSize;
+    const LutT* table = lut + (size_t(j) << pq_bits);
+    if (shift + pq_bits > 8) {
+      // The code crosses a byte boundary (never past the end of the chunk).
+      const uint8_t* hi = lo + kIndexGroupSize;
+      for (uint32_t r = 0; r < kIndexGroupSize; r++) {
+        uint32_t v = uint32_t(lo[r]) | (uint32_t(hi[r]) << 8);
+        out[r] += AccT(table[(v >> shift) & mask]);
+      }
+    } else {
+      for (uint32_t r = 0; r < kIndexGroupSize; r++) {
+        out[r] += AccT(table[(uint32_t(lo[r]) >> shift) & mask]);
+      }
+    }
+  }
+}
+
+}  // namespace cuvs::neighbors::ivf_pq::detail::host
@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../../core/nvtx.hpp"
+#include "../../distance/detail/host_distance.hpp"
+#include "../../selection/detail/select_k_host.hpp"
+#include "../detail/ann_utils.cuh"
+#include "../detail/sample_filter_host.hpp"
+#include "../sample_filter.cuh"
+#include "ivf_pq_fast_scan_host.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/common.hpp>
+#include <cuvs/neighbors/ivf_pq.hpp>
+#include <raft/core/error.hpp>
+#include <raft/core/host_mdspan.hpp>
+#include <raft/core/logger.hpp>
+#include <raft/core/resources.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace cuvs::neighbors::ivf_pq::detail {
+
+/**
+ * The per-thread state of the host search.
+ *
+ * The inner product is negated (as in the GPU lookup tables), so that the best candidates always
+ * have the smallest keys.
+ */
+template <typename IdxT>
+struct host_search_context {
+  std::vector<float> query;
+  std::vector<float> rot_query;
+  std::vector<uint32_t> probes;
+  cuvs::selection::detail::host::bounded_heap<float, uint32_t> probe_heap;
+  cuvs::selection::detail::host::bounded_heap<float, IdxT> heap;
+  /** Lookup table of the current probe [pq_dim, pq_book_size]. */
+  std::vector<float> lut;
+  /** The 8-bit quantized lookup table (zero-padded to whole chunks for the 4-bit fast scan). */
+  std::vector<uint8_t> lut_8bit;
+  float group_distances[kIndexGroupSize];
+  uint16_t group_sums_16[kIndexGroupSize];
+  uint32_t group_sums_32[kIndexGroupSize];
+
+  host_search_context(
+    uint32_t dim, uint32_t rot_dim, uint32_t n_probes, size_t lut_size, size_t lut_8bit_size)
+    : query(dim), rot_query(rot_dim), probes(n_probes), lut(lut_size), lut_8bit(lut_8bit_size, 0)
+  {
+  }
+};
+
+/**
+ * Search an IVF-PQ index on the host.
+ *
+ * The queries are compared with the cluster centers using the host SIMD distance kernels and
+ * rotated into the PQ space. For every probed list, a lookup table of the distances between the
+ * query subspaces and the PQ codebook is computed as in the GPU search; the codes are then scanned
+ * one group at a time.
+ *
+ * The `lut_dtype` selects the lookup table precision: CUDA_R_32F and CUDA_R_16F use a float table
+ * (a half-precision table brings nothing on the CPU), while CUDA_R_8U and CUDA_R_8I quantize the
+ * table to 8 bits, with a per-subspace offset and a common scale. With 4-bit codes the 8-bit table
+ * is scanned with in-register byte shuffles (see `ivf_pq_fast_scan_host.hpp`), so that the scores
+ * are approximate, like the GPU 8-bit tables.
+ *
+ * With at least as many queries as threads the queries are processed in parallel, one per thread;
+ * otherwise the probed lists of each query are distributed over the threads and the per-thread
+ * top-k are merged.
+ *
+ * A bitset filter that admits few rows (see `prefer_admitted_scan`) turns the search into an
+ * exhaustive scan of the codes of the admitted rows: every list holding admitted rows is scanned,
+ * skipping the groups of rows without any. The lists loaded on demand are always probed.
+ */
+template <typename T, typename IdxT, typename IvfSampleFilterT>
+void search_host(raft::resources const& handle,
+                 const search_params& params,
+                 const host_index<IdxT>& index,
+                 raft::host_matrix_view<const T, IdxT, raft::row_major> queries,
+                 raft::host_matrix_view<IdxT, IdxT, raft::row_major> neighbors,
+                 raft::host_matrix_view<float, IdxT, raft::row_major> distances,
+                 IvfSampleFilterT sample_filter)
+{
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, uint8_t> ||
+                  std::is_same_v<T, int8_t>,
+                "Unsupported element type.");
+  const size_t n_queries   = queries.extent(0);
+  const uint32_t k         = neighbors.extent(1);
+  const uint32_t dim       = index.dim();
+  const uint32_t rot_dim   = index.rot_dim();
+  const uint32_t pq_dim    = index.pq_dim();
+  const uint32_t pq_len    = index.pq_len();
+  const uint32_t pq_bits   = index.pq_bits();
+  const uint32_t book_size = index.pq_book_size();
+  const uint32_t pq_chunks = index.pq_chunks();
+  const bool per_subspace  = index.codebook_kind() == codebook_gen::PER_SUBSPACE;
+  const size_t code_stride = size_t(pq_chunks) * kIndexGroupVecLen * kIndexGroupSize;
+  const float* pq_centers  = index.pq_centers().data_handle();
+  const float* centers     = index.centers().data_handle();
+  const float* centers_rot = index.centers_rot().data_handle();
+  const float* rotation    = index.rotation_matrix().data_handle();
+
+  cuvs::common::nvtx::range<cuvs::common::nvtx::domain::cuvs> fun_scope(
+    "ivf_pq::search_host(n_queries = %zu, n_probes = %u, k = %u, dim = %u)",
+    n_queries,
+    params.n_probes,
+    k,
+    dim);
+
+  RAFT_EXPECTS(
+    queries.extent(0) == neighbors.extent(0) && queries.extent(0) == distances.extent(0),
+    "Number of rows in output neighbors and distances matrices must equal the number of queries.");
+  RAFT_EXPECTS(neighbors.extent(1) == distances.extent(1),
+               "Number of columns in output neighbors and distances matrices must equal k");
+  RAFT_EXPECTS(queries.extent(1) == dim,
+               "Number of query dimensions should equal number of dimensions in the index.");
+  RAFT_EXPECTS(
+    params.internal_distance_dtype == CUDA_R_16F || params.internal_distance_dtype == CUDA_R_32F,
+    "internal_distance_dtype must be either CUDA_R_16F or CUDA_R_32F");
+  RAFT_EXPECTS(params.lut_dtype == CUDA_R_16F || params.lut_dtype == CUDA_R_32F ||
+                 params.lut_dtype == CUDA_R_8U || params.lut_dtype == CUDA_R_8I,
+               "lut_dtype must be CUDA_R_16F, CUDA_R_32F, CUDA_R_8U or CUDA_R_8I");
+  RAFT_EXPECTS(k > 0, "parameter `k` in top-k must be positive.");
+  RAFT_EXPECTS(params.n_probes > 0,
+               "n_probes (number of clusters to probe in the search) must be positive.");
+  uint32_t n_probes = std::min<uint32_t>(params.n_probes, index.n_lists());
+
+  bool inner_product = false;
+  bool take_sqrt     = false;
+  switch (index.metric()) {
+    case cuvs::distance::DistanceType::L2Expanded: break;
+    case cuvs::distance::DistanceType::L2SqrtExpanded: take_sqrt = true; break;
+    case cuvs::distance::DistanceType::InnerProduct: inner_product = true; break;
+    default: RAFT_FAIL("Unsupported distance type %d.", int(index.metric()));
+  }
+  const bool lut_8bit  = params.lut_dtype == CUDA_R_8U || params.lut_dtype == CUDA_R_8I;
+  const bool fast_scan = lut_8bit && pq_bits == 4;
+  // The 16-bit sums of the fast scan must not overflow.
+  const uint32_t lut_levels = fast_scan ? std::clamp<uint32_t>(65535u / pq_dim, 1u, 255u) : 255u;
+  const size_t lut_8bit_size =
+    !lut_8bit ? 0 : fast_scan ? size_t(pq_chunks) * host::kFastScanChunkDim * 16
+                              : size_t(pq_dim) * book_size;
+  // The same scaling of the integer types as in the GPU search.
+  const float scaling_factor = utils::config<T>::kDivisor / utils::config<float>::kDivisor;
+
+  const auto& float_kernels   = cuvs::distance::detail::host::get_distance_kernels<float>();
+  auto center_distance        = inner_product ? float_kernels.inner_product : float_kernels.l2;
+  const auto fast_scan_kernel = host::get_fast_scan_kernel();
+
+  // The two-argument filters get the source index from the list being scanned: `inds_ptrs` is not
+  // set for the lists loaded on demand.
+  auto filter = [&](size_t i, uint32_t label, const IdxT* indices, uint32_t j) -> bool {
+    if constexpr (cuvs::neighbors::filtering::takes_three_args<IvfSampleFilterT>::value) {
+      return sample_filter(i, label, j);
+    } else {
+      return sample_filter(i, indices[j]);
+    }
+  };
+
+  // With a selective bitset filter, scan the admitted rows of all the lists instead of probing.
+  // Not with the lists loaded on demand: it would load every list, evicting the cached ones.
+  std::optional<cuvs::neighbors::filtering::detail::ivf_admitted_groups<kIndexGroupSize>> admitted;
+  if constexpr (cuvs::neighbors::filtering::detail::is_bitset_filter<IvfSampleFilterT>::value) {
+    const cuvs::neighbors::filtering::detail::host_bitset bitset(sample_filter.bitset_view_);
+    const size_t n_rows     = index.size();
+    const size_t n_admitted = bitset.count();
+    const size_t ann_rows   = n_rows * n_probes / std::max<uint32_t>(index.n_lists(), 1);
+    if (!index.lazy_lists() && cuvs::neighbors::filtering::detail::prefer_admitted_scan(
+                                 n_admitted, n_rows, ann_rows, k)) {
+      admitted.emplace(
+        index.n_lists(),
+        index.list_sizes().data_handle(),
+        [&](uint32_t label) { return index.list_indices(label); },
+        bitset);
+      n_probes = admitted->labels.size();
+    }
+    RAFT_LOG_DEBUG("# IVF-PQ host search: the filter admits %zu of %zu rows, %s",
+                   n_admitted,
+                   n_rows,
+                   admitted ? "scanning them" : "searching with the filter");
+  }
+
+  using context_t = host_search_context<IdxT>;
+
+  // Convert the query, select the lists to probe and rotate the query.
+  auto prepare_query = [&](size_t i, context_t& ctx) {
+    const T* query = queries.data_handle() + i * dim;
+    for (uint32_t j = 0; j < dim; j++) {
+      ctx.query[j] = utils::mapping<float>{}(query[j]);
+    }
+    if (admitted) {
+      std::copy(admitted->labels.begin(), admitted->labels.end(), ctx.probes.begin());
+    } else {
+      ctx.probe_heap.reset(n_probes);
+      for (uint32_t l = 0; l < index.n_lists(); l++) {
+        float d = center_distance(ctx.query.data(), centers + size_t(l) * dim, dim);
+        ctx.probe_heap.push(inner_product ? -d : d, l);
+      }
+      ctx.probe_heap.pop_sorted(nullptr, ctx.probes.data());
+    }
+    for (uint32_t j = 0; j < rot_dim; j++) {
+      ctx.rot_query[j] =
+        float_kernels.inner_product(rotation + size_t(j) * dim, ctx.query.data(), dim);
+    }
+  };
+
+  // Compute the lookup table of a list, the same as the GPU `compute_similarity_kernel`.
+  auto compute_lut = [&](uint32_t label, context_t& ctx) {
+    const float* center = centers_rot + size_t(label) * rot_dim;
+    for (uint32_t s = 0; s < pq_dim; s++) {
+      float* table      = ctx.lut.data() + size_t(s) * book_size;
+      const float* book = pq_centers + size_t(per_subspace ? s : label) * pq_len * book_size;
+      float base        = 0;
+      std::fill(table, table + book_size, 0.0f);
+      for (uint32_t t = 0; t < pq_len; t++) {
+        const uint32_t j  = s * pq_len + t;
+        const float* pq_c = book + size_t(t) * book_size;
+        const float q     = ctx.rot_query[j];
+        if (inner_product) {
+          base -= q * center[j];
+          for (uint32_t c = 0; c < book_size; c++) {
+            table[c] -= q * pq_c[c];
+          }
+        } else {
+          const float diff = q - center[j];
+          for (uint32_t c = 0; c < book_size; c++) {
+            const float d = diff - pq_c[c];
+            table[c] += d * d;
+          }
+        }
+      }
+      if (base != 0) {
+        for (uint32_t c = 0; c < book_size; c++) {
+          table[c] += base;
+        }
+      }
+    }
+  };
+
+  // Quantize the lookup table; returns the offset and the scale of the quantized sums.
+  auto quantize_lut = [&](context_t& ctx, float& bias, float& step) {
+    float range = 0;
+    bias        = 0;
+    for (uint32_t s = 0; s < pq_dim; s++) {
+      const float* table = ctx.lut.data() + size_t(s) * book_size;
+      auto [lo, hi]      = std::minmax_element(table, table + book_size);
+      bias += *lo;
+      range = std::max(range, *hi - *lo);
+    }
+    step              = range > 0 ? range / lut_levels : 0.0f;
+    const float scale = range > 0 ? lut_levels / range : 0.0f;
+    for (uint32_t s = 0; s < pq_dim; s++) {
+      const float* table = ctx.lut.data() + size_t(s) * book_size;
+      const float lo     = *std::min_element(table, table + book_size);
+      uint8_t* out       = ctx.lut_8bit.data() + size_t(s) * book_size;
+      for (uint32_t c = 0; c < book_size; c++) {
+        float v = std::nearbyint((table[c] - lo) * scale);
+        out[c]  = static_cast<uint8_t>(std::clamp<float>(v, 0.0f, float(lut_levels)));
+      }
+    }
+  };
+
+  // Push the admissible vectors of a list into the heap.
+  auto scan_list = [&](size_t i, uint32_t label, context_t& ctx) {
+    const uint32_t list_size = index.list_sizes()(label);
+    if (list_size == 0) { return; }
+    const auto list      = index.list(label);
+    const uint8_t* codes = list->codes.data();
+    const IdxT* indices  = list->indices.data();
+    compute_lut(label, ctx);
+    float bias = 0;
+    float step = 0;
+    if (lut_8bit) { quantize_lut(ctx, bias, step); }
+    auto group_distances = [&](uint32_t group) {
+      const uint8_t* group_codes = codes + size_t(group / kIndexGroupSize) * code_stride;
+      if (fast_scan) {
+        fast_scan_kernel(ctx.lut_8bit.data(), group_codes, pq_chunks, ctx.group_sums_16);
+        for (uint32_t j = 0; j < kIndexGroupSize; j++) {
+          ctx.group_distances[j] = bias + float(ctx.group_sums_16[j]) * step;
+        }
+      } else if (lut_8bit) {
+        host::scan_group(ctx.lut_8bit.data(), group_codes, pq_bits, pq_dim, ctx.group_sums_32);
+        for (uint32_t j = 0; j < kIndexGroupSize; j++) {
+          ctx.group_distances[j] = bias + float(ctx.group_sums_32[j]) * step;
+        }
+      } else {
+        host::scan_group(ctx.lut.data(), group_codes, pq_bits, pq_dim, ctx.group_distances);
+      }
+    };
+    if (admitted) {
+      // Only the groups with admitted rows, and only their admitted rows.
+      for (auto [group, mask] : admitted->groups[label]) {
+        group_distances(group);
+        for (; mask != 0; mask &= mask - 1) {
+          const uint32_t j = __builtin_ctz(mask);
+          float key        = ctx.group_distances[j];
+          if (ctx.heap.accepts(key)) { ctx.heap.push(key, indices[group + j]); }
+        }
+      }
+      return;
+    }
+    for (uint32_t group = 0; group < list_size; group += kIndexGroupSize) {
+      group_distances(group);
+      const uint32_t n = std::min<uint32_t>(kIndexGroupSize, list_size - group);
+      for (uint32_t j = 0; j < n; j++) {
+        float key = ctx.group_distances[j];
+        if (ctx.heap.accepts(key) && filter(i, label, indices, group + j)) {
+          ctx.heap.push(key, indices[group + j]);
+        }
+      }
+    }
+  };
+
+  // Write the results of a query, applying the same post-processing as the GPU search; missing
+  // results (too few admissible vectors in the probed lists) are marked as out of bounds.
+  auto write_results = [&](size_t i, context_t& ctx) {
+    IdxT* out_neighbors  = neighbors.data_handle() + i * k;
+    float* out_distances = distances.data_handle() + i * k;
+    const size_t n       = ctx.heap.pop_sorted(out_distances, out_neighbors);
+    for (size_t j = 0; j < n; j++) {
+      if (inner_product) {
+        out_distances[j] = -out_distances[j] * scaling_factor * scaling_factor;
+      } else if (take_sqrt) {
+        out_distances[j] = std::sqrt(std::max(out_distances[j], 0.0f)) * scaling_factor;
+      } else {
+        out_distances[j] *= scaling_factor * scaling_factor;
+      }
+    }
+    std::fill(out_neighbors + n, out_neighbors + k, kOutOfBoundsRecord<IdxT>);
+    std::fill(out_distances + n,
+              out_distances + k,
+              inner_product ? std::numeric_limits<float>::lowest()
+                            : std::numeric_limits<float>::max());
+  };
+
+  const size_t lut_size       = size_t(pq_dim) * book_size;
+  const bool parallel_queries = n_queries >= size_t(omp_get_max_threads());
+  RAFT_LOG_DEBUG("# IVF-PQ host search: n_probes = %u, lut = %s, parallel over %s",
+                 n_probes,
+                 fast_scan ? "8-bit fast scan" : lut_8bit ? "8-bit" : "float",
+                 parallel_queries ? "queries" : "lists");
+
+  if (parallel_queries) {
+#pragma omp parallel
+    {
+      context_t ctx(dim, rot_dim, n_probes, lut_size, lut_8bit_size);
+#pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < n_queries; i++) {
+        prepare_query(i, ctx);
+        ctx.heap.reset(k);
+        for (uint32_t p = 0; p < n_probes; p++) {
+          scan_list(i, ctx.probes[p], ctx);
+        }
+        write_results(i, ctx);
+      }
+    }
+    return;
+  }
+
+  context_t shared(dim, rot_dim, n_probes, 0, 0);
+#pragma omp parallel
+  {
+    context_t ctx(dim, rot_dim, n_probes, lut_size, lut_8bit_size);
+    std::vector<float> keys(k);
+    std::vector<IdxT> values(k);
+    for (size_t i = 0; i < n_queries; i++) {
+#pragma omp single
+      {
+        prepare_query(i, shared);
+        shared.heap.reset(k);
+      }
+      std::copy(shared.rot_query.begin(), shared.rot_query.end(), ctx.rot_query.begin());
+      ctx.heap.reset(k);
+#pragma omp for schedule(dynamic) nowait
+      for (uint32_t p = 0; p < n_probes; p++) {
+        scan_list(i, shared.probes[p], ctx);
+      }
+      const size_t n = ctx.heap.pop_unsorted(keys.data(), values.data());
+#pragma omp critical
+      shared.heap.push(keys.data(), values.data(), n);
+#pragma omp barrier
+#pragma omp single
+      write_results(i, shared);
+    }
+  }
+}
+
+}  // namespace cuvs::neighbors::ivf_pq::detail
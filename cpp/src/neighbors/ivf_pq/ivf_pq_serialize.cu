@@ -22,17 +22,27 @@ namespace cuvs::neighbors::ivf_pq {
 
 void serialize_file(raft::resources const& handle,
                     const std::string& filename,
-                    const cuvs::neighbors::ivf_pq::index<int64_t>& index)
+                    const cuvs::neighbors::ivf_pq::index<int64_t>& index,
+                    cuvs::neighbors::serialize_compression compression)
 {
-  cuvs::neighbors::ivf_pq::detail::serialize(handle, filename, index);
+  cuvs::neighbors::ivf_pq::detail::serialize(handle, filename, index, compression);
 }
 
 void serialize(raft::resources const& handle,
                std::string& str,
-               const cuvs::neighbors::ivf_pq::index<int64_t>& index)
+               const cuvs::neighbors::ivf_pq::index<int64_t>& index,
+               cuvs::neighbors::serialize_compression compression)
 {
   std::ostringstream os;
-  cuvs::neighbors::ivf_pq::detail::serialize(handle, os, index);
+  cuvs::neighbors::ivf_pq::detail::serialize(handle, os, index, compression);
   str = os.str();
 }
+
+void serialize(raft::resources const& handle,
+               std::ostream& os,
+               const cuvs::neighbors::ivf_pq::index<int64_t>& index,
+               cuvs::neighbors::serialize_compression compression)
+{
+  cuvs::neighbors::ivf_pq::detail::serialize(handle, os, index, compression);
+}
 }  // namespace cuvs::neighbors::ivf_pq
\ No newline at end of file
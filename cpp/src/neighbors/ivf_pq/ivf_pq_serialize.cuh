@@ -16,28 +16,243 @@
 
 #pragma once
 
+#include "../../core/mmap.hpp"
+#include "../detail/container_serialize.hpp"
+#include "../detail/ivf_list_cache.hpp"
+#include "../detail/parallel_serialize.hpp"
 #include "../ivf_common.cuh"
 #include "../ivf_list.cuh"
 #include "ivf_pq_list.cuh"
 #include <cuvs/neighbors/common.hpp>
 #include <cuvs/neighbors/ivf_pq.hpp>
+#include <raft/core/detail/mdspan_numpy_serializer.hpp>
 #include <raft/core/host_mdarray.hpp>
 #include <raft/core/logger-ext.hpp>
 #include <raft/core/resource/cuda_stream.hpp>
 #include <raft/core/resources.hpp>
 #include <raft/core/serialize.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
+#include <initializer_list>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 namespace cuvs::neighbors::ivf_pq::detail {
 
 // Serialization version
-// No backward compatibility yet; that is, can't add additional fields without breaking
-// backward compatibility.
-// TODO(hcho3) Implement next-gen serializer for IVF that allows for expansion in a backward
-//             compatible fashion.
-constexpr int kSerializationVersion = 3;
+// Version 4 stores the index in the sectioned container of `container_serialize.hpp`, which lets
+// later versions add optional sections without breaking the readers. Version 5 opens the "params"
+// section with the numpy dtype string of the data the index was built from, as IVF-Flat and CAGRA
+// do. Version 4 containers and the flat format of version 3 can still be read; their data is float.
+constexpr int kSerializationVersion       = 5;
+constexpr int kFirstContainerVersion      = 4;
+constexpr int kLegacySerializationVersion = 3;
+constexpr std::string_view kContainerKind = "ivf_pq";
+
+/** The parameters of a serialized index (the "params" section, or the header of version 3). */
+template <typename IdxT>
+struct serialized_params {
+  IdxT n_rows;
+  uint32_t dim;
+  uint32_t pq_bits;
+  uint32_t pq_dim;
+  bool conservative_memory_allocation;
+  cuvs::distance::DistanceType metric;
+  codebook_gen codebook_kind;
+  uint32_t n_lists;
+  cudaDataType_t data_type = CUDA_R_32F;
+};
+
+/** The numpy dtype string of a data type, as stored at the start of the "params" section. */
+inline auto serialized_dtype(cudaDataType_t data_type) -> std::string
+{
+  auto dtype = [data_type]() {
+    switch (data_type) {
+      case CUDA_R_32F: return raft::detail::numpy_serializer::get_numpy_dtype<float>();
+      case CUDA_R_16F: return raft::detail::numpy_serializer::get_numpy_dtype<half>();
+      case CUDA_R_8I: return raft::detail::numpy_serializer::get_numpy_dtype<int8_t>();
+      case CUDA_R_8U: return raft::detail::numpy_serializer::get_numpy_dtype<uint8_t>();
+      default: RAFT_FAIL("Unsupported IVF-PQ data type %d", static_cast<int>(data_type));
+    }
+  }();
+  auto dtype_string = dtype.to_string();
+  dtype_string.resize(4);
+  return dtype_string;
+}
+
+/** The data type of a dtype string written by `serialized_dtype`. */
+inline auto parse_serialized_dtype(const std::string& dtype_string) -> cudaDataType_t
+{
+  for (auto data_type : {CUDA_R_32F, CUDA_R_16F, CUDA_R_8I, CUDA_R_8U}) {
+    if (serialized_dtype(data_type) == dtype_string) { return data_type; }
+  }
+  RAFT_FAIL("Unsupported IVF-PQ dtype '%s'", dtype_string.c_str());
+}
+
+template <typename IdxT>
+void serialize_params(raft::resources const& handle_, std::ostream& os, const index<IdxT>& index)
+{
+  os << serialized_dtype(index.data_type());
+  raft::serialize_scalar(handle_, os, index.size());
+  raft::serialize_scalar(handle_, os, index.dim());
+  raft::serialize_scalar(handle_, os, index.pq_bits());
+  raft::serialize_scalar(handle_, os, index.pq_dim());
+  raft::serialize_scalar(handle_, os, index.conservative_memory_allocation());
+
+  raft::serialize_scalar(handle_, os, index.metric());
+  raft::serialize_scalar(handle_, os, index.codebook_kind());
+  raft::serialize_scalar(handle_, os, index.n_lists());
+}
+
+template <typename IdxT>
+auto deserialize_params(raft::resources const& handle_, std::istream& is, uint32_t schema_version)
+  -> serialized_params<IdxT>
+{
+  serialized_params<IdxT> p;
+  if (schema_version > uint32_t(kFirstContainerVersion)) {
+    std::string dtype_string(4, '\0');
+    is.read(dtype_string.data(), 4);
+    RAFT_EXPECTS(is.good(), "Error reading the IVF-PQ parameters");
+    p.data_type = parse_serialized_dtype(dtype_string);
+  }
+  p.n_rows                         = raft::deserialize_scalar<IdxT>(handle_, is);
+  p.dim                            = raft::deserialize_scalar<std::uint32_t>(handle_, is);
+  p.pq_bits                        = raft::deserialize_scalar<std::uint32_t>(handle_, is);
+  p.pq_dim                         = raft::deserialize_scalar<std::uint32_t>(handle_, is);
+  p.conservative_memory_allocation = raft::deserialize_scalar<bool>(handle_, is);
+
+  p.metric        = raft::deserialize_scalar<cuvs::distance::DistanceType>(handle_, is);
+  p.codebook_kind = raft::deserialize_scalar<cuvs::neighbors::ivf_pq::codebook_gen>(handle_, is);
+  p.n_lists       = raft::deserialize_scalar<std::uint32_t>(handle_, is);
+
+  RAFT_LOG_DEBUG("n_rows %zu, dim %d, pq_dim %d, pq_bits %d, n_lists %d",
+                 static_cast<std::size_t>(p.n_rows),
+                 static_cast<int>(p.dim),
+                 static_cast<int>(p.pq_dim),
+                 static_cast<int>(p.pq_bits),
+                 static_cast<int>(p.n_lists));
+  return p;
+}
+
+/** The sections of a container every reader needs, besides the lists. */
+constexpr std::initializer_list<std::string_view> kRequiredSections = {
+  "params", "pq_centers", "centers", "centers_rot", "rotation_matrix", "list_sizes"};
+
+/** Wrap a visitor of `read_sections` to read the parameters and validate the other sections. */
+template <typename IdxT, typename OnParams, typename Visitor>
+auto check_sections(raft::resources const& handle_,
+                    uint32_t schema_version,
+                    std::optional<serialized_params<IdxT>>& params,
+                    OnParams& on_params,
+                    Visitor& visit)
+{
+  return [&, schema_version](const cuvs::neighbors::detail::section_info& s,
+                             std::istream& payload,
+                             raft::resources const& res) -> bool {
+    if (s.is("params")) {
+      params = deserialize_params<IdxT>(handle_, payload, schema_version);
+      on_params(*params);
+      return true;
+    }
+    RAFT_EXPECTS(
+      params.has_value(), "IVF-PQ section '%s' precedes the parameters", s.name.c_str());
+    RAFT_EXPECTS(
+      !s.is("list") || s.id < params->n_lists, "Invalid IVF-PQ list label %zu", size_t(s.id));
+    return visit(s, payload, res);
+  };
+}
+
+/**
+ * Read a serialized index: the parameters go to `on_params(const serialized_params<IdxT>&)`, then
+ * the other sections, in order, to
+ * `visit(const section_info&, std::istream&, const raft::resources&) -> bool`, which returns
+ * whether it knows the section.
+ *
+ * For the flat format of version 3 the sections are the consecutive parts of the stream.
+ */
+template <typename IdxT, typename OnParams, typename Visitor>
+void read_sections(raft::resources const& handle_,
+                   std::istream& is,
+                   OnParams&& on_params,
+                   Visitor&& visit)
+{
+  using cuvs::neighbors::detail::section_info;
+  std::optional<serialized_params<IdxT>> params;
+  auto prefix = cuvs::neighbors::detail::read_container_prefix(is);
+  if (cuvs::neighbors::detail::is_container(prefix)) {
+    cuvs::neighbors::detail::container_reader reader(
+      is, prefix, kContainerKind, kSerializationVersion);
+    auto checked =
+      check_sections<IdxT>(handle_, reader.schema_version(), params, on_params, visit);
+    reader.read_sections([&](const section_info& s, std::istream& payload) -> bool {
+      return checked(s, payload, handle_);
+    });
+    reader.require_sections("IVF-PQ", kRequiredSections);
+    RAFT_EXPECTS(reader.count_sections("list") == params->n_lists,
+                 "The IVF-PQ index misses some lists");
+    return;
+  }
+
+  int ver;
+  std::memcpy(&ver, prefix.data(), sizeof(ver));
+  if (ver != kLegacySerializationVersion) {
+    RAFT_FAIL("serialization version mismatch %d vs. %d", ver, kLegacySerializationVersion);
+  }
+  params = deserialize_params<IdxT>(handle_, is, kLegacySerializationVersion);
+  on_params(*params);
+  for (const char* name :
+       {"pq_centers", "centers", "centers_rot", "rotation_matrix", "list_sizes"}) {
+    visit(section_info{name, 0, 0, 0, 0, 0}, is, handle_);
+  }
+  for (uint32_t label = 0; label < params->n_lists; label++) {
+    visit(section_info{"list", label, 0, 0, 0, 0}, is, handle_);
+  }
+  if (!is) { RAFT_FAIL("Error reading the IVF-PQ index"); }
+}
+
+/**
+ * Read a serialized index from a file, as `read_sections` does from a stream, except that the
+ * lists of a container are read in parallel: `visit` is called concurrently for them, each thread
+ * passing its own resources (see `read_sections_parallel`).
+ */
+template <typename IdxT, typename OnParams, typename Visitor>
+void read_sections(raft::resources const& handle_,
+                   const std::string& filename,
+                   OnParams&& on_params,
+                   Visitor&& visit)
+{
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  if (!is) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+  auto prefix = cuvs::neighbors::detail::read_container_prefix(is);
+  is.seekg(0);
+  if (!cuvs::neighbors::detail::is_container(prefix)) {
+    return read_sections<IdxT>(handle_, is, on_params, visit);
+  }
+
+  auto toc = cuvs::neighbors::detail::read_container_toc(is, kContainerKind, kSerializationVersion);
+  for (auto name : kRequiredSections) {
+    RAFT_EXPECTS(toc.find(name) != nullptr,
+                 "The IVF-PQ index misses the section '%s'",
+                 std::string(name).c_str());
+  }
+  std::optional<serialized_params<IdxT>> params;
+  cuvs::neighbors::detail::read_sections_parallel(
+    handle_,
+    filename,
+    is,
+    toc,
+    "list",
+    check_sections<IdxT>(handle_, toc.schema_version, params, on_params, visit));
+  auto n_lists = std::count_if(toc.sections.begin(), toc.sections.end(), [](const auto& s) {
+    return s.is("list");
+  });
+  RAFT_EXPECTS(size_t(n_lists) == params->n_lists, "The IVF-PQ index misses some lists");
+}
 
 /**
  * Write the index to an output stream
@@ -47,10 +262,16 @@ constexpr int kSerializationVersion = 3;
  * @param[in] handle the raft handle
  * @param[in] os output stream
  * @param[in] index IVF-PQ index
+ * @param[in] compression compression of the lists
+ * @param[in] file the file behind `os`, if any; the lists are then written to it in parallel
  *
  */
 template <typename IdxT>
-void serialize(raft::resources const& handle_, std::ostream& os, const index<IdxT>& index)
+void serialize(raft::resources const& handle_,
+               std::ostream& os,
+               const index<IdxT>& index,
+               serialize_compression compression            = serialize_compression::NONE,
+               const cuvs::core::detail::file_descriptor* file = nullptr)
 {
   RAFT_LOG_DEBUG("Size %zu, dim %d, pq_dim %d, pq_bits %d",
                  static_cast<size_t>(index.size()),
@@ -58,21 +279,22 @@ void serialize(raft::resources const& handle_, std::ostream& os, const index<Idx
                  static_cast<int>(index.pq_dim()),
                  static_cast<int>(index.pq_bits()));
 
-  raft::serialize_scalar(handle_, os, kSerializationVersion);
-  raft::serialize_scalar(handle_, os, index.size());
-  raft::serialize_scalar(handle_, os, index.dim());
-  raft::serialize_scalar(handle_, os, index.pq_bits());
-  raft::serialize_scalar(handle_, os, index.pq_dim());
-  raft::serialize_scalar(handle_, os, index.conservative_memory_allocation());
-
-  raft::serialize_scalar(handle_, os, index.metric());
-  raft::serialize_scalar(handle_, os, index.codebook_kind());
-  raft::serialize_scalar(handle_, os, index.n_lists());
-
-  raft::serialize_mdspan(handle_, os, index.pq_centers());
-  raft::serialize_mdspan(handle_, os, index.centers());
-  raft::serialize_mdspan(handle_, os, index.centers_rot());
-  raft::serialize_mdspan(handle_, os, index.rotation_matrix());
+  constexpr auto kRequired = cuvs::neighbors::detail::kSectionRequired;
+  cuvs::neighbors::detail::container_writer writer(os, kContainerKind, kSerializationVersion);
+  writer.section(
+    "params", 0, kRequired, [&](std::ostream& s) { serialize_params(handle_, s, index); });
+  writer.section("pq_centers", 0, kRequired, [&](std::ostream& s) {
+    raft::serialize_mdspan(handle_, s, index.pq_centers());
+  });
+  writer.section("centers", 0, kRequired, [&](std::ostream& s) {
+    raft::serialize_mdspan(handle_, s, index.centers());
+  });
+  writer.section("centers_rot", 0, kRequired, [&](std::ostream& s) {
+    raft::serialize_mdspan(handle_, s, index.centers_rot());
+  });
+  writer.section("rotation_matrix", 0, kRequired, [&](std::ostream& s) {
+    raft::serialize_mdspan(handle_, s, index.rotation_matrix());
+  });
 
   auto sizes_host =
     raft::make_host_mdarray<uint32_t, uint32_t, raft::row_major>(index.list_sizes().extents());
@@ -81,11 +303,37 @@ void serialize(raft::resources const& handle_, std::ostream& os, const index<Idx
              sizes_host.size(),
              raft::resource::get_cuda_stream(handle_));
   raft::resource::sync_stream(handle_);
-  raft::serialize_mdspan(handle_, os, sizes_host.view());
+  writer.section("list_sizes", 0, kRequired, [&](std::ostream& s) {
+    raft::serialize_mdspan(handle_, s, sizes_host.view());
+  });
   auto list_store_spec = list_spec<uint32_t, IdxT>{index.pq_bits(), index.pq_dim(), true};
-  for (uint32_t label = 0; label < index.n_lists(); label++) {
-    ivf::serialize_list(handle_, os, index.lists()[label], list_store_spec, sizes_host(label));
+  // The codes barely compress, the indices do once their bytes are shuffled.
+  cuvs::neighbors::detail::section_encoding list_encoding;
+  if (compression != serialize_compression::NONE) {
+    list_encoding = {cuvs::neighbors::detail::section_codec::kShuffleLz, sizeof(IdxT)};
   }
+  if (file != nullptr) {
+    const size_t bytes_per_row = index.pq_dim() * index.pq_bits() / 8 + sizeof(IdxT);
+    cuvs::neighbors::detail::write_sections_parallel(
+      handle_,
+      writer,
+      *file,
+      "list",
+      index.n_lists(),
+      kRequired,
+      list_encoding,
+      [&](uint64_t label) { return sizes_host(label) * bytes_per_row; },
+      [&](raft::resources const& res, uint64_t label, std::ostream& s) {
+        ivf::serialize_list(res, s, index.lists()[label], list_store_spec, sizes_host(label));
+      });
+  } else {
+    for (uint32_t label = 0; label < index.n_lists(); label++) {
+      writer.section("list", label, kRequired, list_encoding, [&](std::ostream& s) {
+        ivf::serialize_list(handle_, s, index.lists()[label], list_store_spec, sizes_host(label));
+      });
+    }
+  }
+  writer.finish();
 }
 
 /**
@@ -96,23 +344,76 @@ void serialize(raft::resources const& handle_, std::ostream& os, const index<Idx
  * @param[in] handle the raft handle
  * @param[in] filename the file name for saving the index
  * @param[in] index IVF-PQ index
+ * @param[in] compression compression of the lists
  *
  */
 template <typename IdxT>
 void serialize(raft::resources const& handle_,
                const std::string& filename,
-               const index<IdxT>& index)
+               const index<IdxT>& index,
+               serialize_compression compression = serialize_compression::NONE)
 {
   std::ofstream of(filename, std::ios::out | std::ios::binary);
   if (!of) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+  cuvs::core::detail::file_descriptor file(filename, O_WRONLY | O_CLOEXEC);
 
-  detail::serialize(handle_, of, index);
+  detail::serialize(handle_, of, index, compression, &file);
 
   of.close();
   if (!of) { RAFT_FAIL("Error writing output %s", filename.c_str()); }
   return;
 }
 
+/** Load an index from `source`, an input stream or the name of a file (see `read_sections`). */
+template <typename IdxT, typename Source>
+auto deserialize_from(raft::resources const& handle_, Source& source) -> index<IdxT>
+{
+  std::optional<index<IdxT>> index;
+  std::optional<list_spec<uint32_t, IdxT>> list_device_spec;
+  std::optional<list_spec<uint32_t, IdxT>> list_store_spec;
+  auto on_params = [&](const serialized_params<IdxT>& p) {
+    index.emplace(handle_,
+                  p.metric,
+                  p.codebook_kind,
+                  p.n_lists,
+                  p.dim,
+                  p.pq_bits,
+                  p.pq_dim,
+                  p.conservative_memory_allocation);
+    index->set_data_type(p.data_type);
+    list_device_spec.emplace(p.pq_bits, p.pq_dim, p.conservative_memory_allocation);
+    list_store_spec.emplace(p.pq_bits, p.pq_dim, true);
+  };
+  auto visit = [&](const cuvs::neighbors::detail::section_info& s,
+                   std::istream& payload,
+                   raft::resources const& res) -> bool {
+    if (s.is("pq_centers")) {
+      raft::deserialize_mdspan(handle_, payload, index->pq_centers());
+    } else if (s.is("centers")) {
+      raft::deserialize_mdspan(handle_, payload, index->centers());
+    } else if (s.is("centers_rot")) {
+      raft::deserialize_mdspan(handle_, payload, index->centers_rot());
+    } else if (s.is("rotation_matrix")) {
+      raft::deserialize_mdspan(handle_, payload, index->rotation_matrix());
+    } else if (s.is("list_sizes")) {
+      raft::deserialize_mdspan(handle_, payload, index->list_sizes());
+    } else if (s.is("list")) {
+      ivf::deserialize_list(
+        res, payload, index->lists()[s.id], *list_store_spec, *list_device_spec);
+    } else {
+      return false;
+    }
+    return true;
+  };
+  read_sections<IdxT>(handle_, source, on_params, visit);
+
+  raft::resource::sync_stream(handle_);
+
+  ivf::detail::recompute_internal_state(handle_, *index);
+
+  return std::move(*index);
+}
+
 /**
  * Load index from input stream
  *
@@ -125,46 +426,7 @@ void serialize(raft::resources const& handle_,
 template <typename IdxT>
 auto deserialize(raft::resources const& handle_, std::istream& is) -> index<IdxT>
 {
-  auto ver = raft::deserialize_scalar<int>(handle_, is);
-  if (ver != kSerializationVersion) {
-    RAFT_FAIL("serialization version mismatch %d vs. %d", ver, kSerializationVersion);
-  }
-  auto n_rows  = raft::deserialize_scalar<IdxT>(handle_, is);
-  auto dim     = raft::deserialize_scalar<std::uint32_t>(handle_, is);
-  auto pq_bits = raft::deserialize_scalar<std::uint32_t>(handle_, is);
-  auto pq_dim  = raft::deserialize_scalar<std::uint32_t>(handle_, is);
-  auto cma     = raft::deserialize_scalar<bool>(handle_, is);
-
-  auto metric        = raft::deserialize_scalar<cuvs::distance::DistanceType>(handle_, is);
-  auto codebook_kind = raft::deserialize_scalar<cuvs::neighbors::ivf_pq::codebook_gen>(handle_, is);
-  auto n_lists       = raft::deserialize_scalar<std::uint32_t>(handle_, is);
-
-  RAFT_LOG_DEBUG("n_rows %zu, dim %d, pq_dim %d, pq_bits %d, n_lists %d",
-                 static_cast<std::size_t>(n_rows),
-                 static_cast<int>(dim),
-                 static_cast<int>(pq_dim),
-                 static_cast<int>(pq_bits),
-                 static_cast<int>(n_lists));
-
-  auto index = cuvs::neighbors::ivf_pq::index<IdxT>(
-    handle_, metric, codebook_kind, n_lists, dim, pq_bits, pq_dim, cma);
-
-  raft::deserialize_mdspan(handle_, is, index.pq_centers());
-  raft::deserialize_mdspan(handle_, is, index.centers());
-  raft::deserialize_mdspan(handle_, is, index.centers_rot());
-  raft::deserialize_mdspan(handle_, is, index.rotation_matrix());
-  raft::deserialize_mdspan(handle_, is, index.list_sizes());
-  auto list_device_spec = list_spec<uint32_t, IdxT>{pq_bits, pq_dim, cma};
-  auto list_store_spec  = list_spec<uint32_t, IdxT>{pq_bits, pq_dim, true};
-  for (auto& list : index.lists()) {
-    ivf::deserialize_list(handle_, is, list, list_store_spec, list_device_spec);
-  }
-
-  raft::resource::sync_stream(handle_);
-
-  ivf::detail::recompute_internal_state(handle_, index);
-
-  return index;
+  return deserialize_from<IdxT>(handle_, is);
 }
 
 /**
@@ -178,16 +440,190 @@ auto deserialize(raft::resources const& handle_, std::istream& is) -> index<IdxT
  */
 template <typename IdxT>
 auto deserialize(raft::resources const& handle_, const std::string& filename) -> index<IdxT>
+{
+  return deserialize_from<IdxT>(handle_, filename);
+}
+
+/**
+ * Decode a list section into the host layout of the list (see `host_index::make_list`), or nothing
+ * for an empty list.
+ */
+template <typename IdxT>
+auto deserialize_host_list(raft::resources const& handle_,
+                           std::istream& payload,
+                           uint32_t label,
+                           const list_spec<uint32_t, IdxT>& store_spec,
+                           uint32_t pq_chunks,
+                           uint32_t list_size)
+  -> std::optional<typename host_index<IdxT>::list_type>
+{
+  auto size = raft::deserialize_scalar<uint32_t>(handle_, payload);
+  if (size == 0) { return std::nullopt; }
+  RAFT_EXPECTS(size == list_size, "Inconsistent size of list %u", label);
+  auto data_extents = store_spec.make_list_extents(size);
+  std::vector<uint8_t> codes(size_t(data_extents.extent(0)) * data_extents.extent(1) *
+                             kIndexGroupSize * kIndexGroupVecLen);
+  std::vector<IdxT> indices(size);
+  auto codes_view = raft::make_mdspan<uint8_t, uint32_t, raft::row_major, true, false>(
+    codes.data(), data_extents);
+  raft::deserialize_mdspan(handle_, payload, codes_view);
+  raft::deserialize_mdspan(
+    handle_, payload, raft::make_host_vector_view<IdxT, uint32_t>(indices.data(), size));
+  return host_index<IdxT>::make_list(pq_chunks, size, codes, std::move(indices));
+}
+
+/**
+ * Visitor of `read_sections` loading all sections but the lists into a host index; the index and
+ * the list sizes are created by `on_params`.
+ */
+template <typename IdxT>
+auto host_index_visitor(raft::resources const& handle_,
+                        host_index<IdxT>& index,
+                        std::vector<uint32_t>& list_sizes)
+{
+  return [&](const cuvs::neighbors::detail::section_info& s,
+             std::istream& payload,
+             raft::resources const&) -> bool {
+    if (s.is("pq_centers")) {
+      raft::deserialize_mdspan(handle_, payload, index.pq_centers());
+    } else if (s.is("centers")) {
+      // The centers are stored extended with their norms [n_lists, dim_ext].
+      const uint32_t dim     = index.dim();
+      const uint32_t dim_ext = raft::round_up_safe(dim + 1, 8u);
+      auto centers_ext       = raft::make_host_matrix<float, uint32_t>(index.n_lists(), dim_ext);
+      raft::deserialize_mdspan(handle_, payload, centers_ext.view());
+      for (uint32_t l = 0; l < index.n_lists(); l++) {
+        std::copy(centers_ext.data_handle() + size_t(l) * dim_ext,
+                  centers_ext.data_handle() + size_t(l) * dim_ext + dim,
+                  index.centers().data_handle() + size_t(l) * dim);
+      }
+    } else if (s.is("centers_rot")) {
+      raft::deserialize_mdspan(handle_, payload, index.centers_rot());
+    } else if (s.is("rotation_matrix")) {
+      raft::deserialize_mdspan(handle_, payload, index.rotation_matrix());
+    } else if (s.is("list_sizes")) {
+      raft::deserialize_mdspan(
+        handle_,
+        payload,
+        raft::make_host_vector_view<uint32_t, uint32_t>(list_sizes.data(), index.n_lists()));
+    } else {
+      return false;
+    }
+    return true;
+  };
+}
+
+/**
+ * Load an index saved by `serialize` into host memory, for the host search.
+ *
+ * The file format is the same; the list codes are transposed within the groups by
+ * `host_index::make_list`.
+ */
+template <typename IdxT>
+auto deserialize_host(raft::resources const& handle_, std::istream& is) -> host_index<IdxT>
+{
+  host_index<IdxT> index;
+  std::optional<list_spec<uint32_t, IdxT>> list_store_spec;
+  std::vector<uint32_t> list_sizes;
+  auto on_params = [&](const serialized_params<IdxT>& p) {
+    index = host_index<IdxT>(p.metric, p.codebook_kind, p.n_lists, p.dim, p.pq_bits, p.pq_dim);
+    list_store_spec.emplace(p.pq_bits, p.pq_dim, true);
+    list_sizes.assign(p.n_lists, 0);
+  };
+  auto visit_other = host_index_visitor<IdxT>(handle_, index, list_sizes);
+  auto visit       = [&](const cuvs::neighbors::detail::section_info& s,
+                   std::istream& payload,
+                   raft::resources const& res) -> bool {
+    if (!s.is("list")) { return visit_other(s, payload, res); }
+    auto label = static_cast<uint32_t>(s.id);
+    auto list  = deserialize_host_list<IdxT>(
+      handle_, payload, label, *list_store_spec, index.pq_chunks(), list_sizes[label]);
+    if (list.has_value()) { index.set_list(label, list_sizes[label], std::move(*list)); }
+    return true;
+  };
+  read_sections<IdxT>(handle_, is, on_params, visit);
+
+  return index;
+}
+
+template <typename IdxT>
+auto deserialize_host(raft::resources const& handle_, const std::string& filename)
+  -> host_index<IdxT>
 {
   std::ifstream infile(filename, std::ios::in | std::ios::binary);
 
   if (!infile) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
 
-  auto index = detail::deserialize<IdxT>(handle_, infile);
+  auto index = detail::deserialize_host<IdxT>(handle_, infile);
 
   infile.close();
 
   return index;
 }
 
+/**
+ * Load an index file into host memory, with its lists loaded on demand if
+ * `load_params.lazy_lists` (see `ivf::host_load_params`).
+ *
+ * Only the lists of a container (version 4 or newer) can be loaded lazily.
+ */
+template <typename IdxT>
+auto deserialize_host(raft::resources const& handle_,
+                      const std::string& filename,
+                      const ivf::host_load_params& load_params) -> host_index<IdxT>
+{
+  if (!load_params.lazy_lists) { return deserialize_host<IdxT>(handle_, filename); }
+
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  if (!is) { RAFT_FAIL("Cannot open file %s", filename.c_str()); }
+  auto prefix = cuvs::neighbors::detail::read_container_prefix(is);
+  RAFT_EXPECTS(cuvs::neighbors::detail::is_container(prefix),
+               "Loading the lists on demand needs an IVF-PQ index file of version %d or newer",
+               kFirstContainerVersion);
+  auto toc = cuvs::neighbors::detail::read_container_toc(is, kContainerKind, kSerializationVersion);
+  for (auto name : kRequiredSections) {
+    RAFT_EXPECTS(toc.find(name) != nullptr,
+                 "The IVF-PQ index misses the section '%s'",
+                 std::string(name).c_str());
+  }
+
+  host_index<IdxT> index;
+  std::optional<list_spec<uint32_t, IdxT>> list_store_spec;
+  std::vector<uint32_t> list_sizes;
+  std::optional<serialized_params<IdxT>> params;
+  auto on_params = [&](const serialized_params<IdxT>& p) {
+    index = host_index<IdxT>(p.metric, p.codebook_kind, p.n_lists, p.dim, p.pq_bits, p.pq_dim);
+    list_store_spec.emplace(p.pq_bits, p.pq_dim, true);
+    list_sizes.assign(p.n_lists, 0);
+  };
+  auto visit_other = host_index_visitor<IdxT>(handle_, index, list_sizes);
+  auto checked = check_sections<IdxT>(handle_, toc.schema_version, params, on_params, visit_other);
+  for (const auto& s : toc.sections) {
+    if (s.is("list")) { continue; }
+    bool handled = false;
+    cuvs::neighbors::detail::read_container_section(
+      is, toc, s, [&](std::istream& payload) { handled = checked(s, payload, handle_); });
+    cuvs::neighbors::detail::container_detail::check_section_handled(s, handled);
+  }
+
+  using list_type = typename host_index<IdxT>::list_type;
+  auto decode     = [store_spec = *list_store_spec, pq_chunks = index.pq_chunks(), list_sizes](
+                  uint32_t label, std::istream& payload)
+    -> std::pair<std::shared_ptr<const list_type>, size_t> {
+    // Called from the search threads; the host deserialization does not use the handle, a local
+    // one avoids sharing `handle_` across them.
+    raft::resources res;
+    auto list = deserialize_host_list<IdxT>(
+      res, payload, label, store_spec, pq_chunks, list_sizes[label]);
+    if (!list.has_value()) { return {nullptr, 0}; }
+    const size_t bytes = list->codes.size() + list->indices.size() * sizeof(IdxT);
+    return {std::make_shared<const list_type>(std::move(*list)), bytes};
+  };
+  index.set_list_loader(
+    std::make_shared<cuvs::neighbors::detail::mapped_list_cache<list_type>>(
+      filename, toc, "list", index.n_lists(), load_params.max_resident_list_bytes, decode),
+    list_sizes);
+  return index;
+}
+
 }  // namespace cuvs::neighbors::ivf_pq::detail
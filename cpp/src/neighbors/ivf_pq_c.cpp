@@ -16,16 +16,22 @@
 
 #include <cstdint>
 #include <dlpack/dlpack.h>
+#include <fstream>
+#include <string>
 
 #include <raft/core/error.hpp>
 #include <raft/core/mdspan_types.hpp>
 #include <raft/core/resources.hpp>
 
 #include <cuvs/core/c_api.h>
+#include <cuvs/core/exceptions.hpp>
 #include <cuvs/core/interop.hpp>
 #include <cuvs/neighbors/ivf_pq.h>
 #include <cuvs/neighbors/ivf_pq.hpp>
 
+#include "../core/c_api_stream.hpp"
+#include "detail/container_serialize.hpp"
+
 namespace {
 
 template <typename IdxT>
@@ -88,6 +94,51 @@ void _search(cuvsResources_t res,
     *res_ptr, search_params, *index_ptr, queries_mds, neighbors_mds, distances_mds);
 }
 
+template <typename IdxT>
+void _serialize(cuvsResources_t res, std::ostream& os, cuvsIvfPqIndex_t index)
+{
+  auto res_ptr   = reinterpret_cast<raft::resources*>(res);
+  auto index_ptr = reinterpret_cast<cuvs::neighbors::ivf_pq::index<IdxT>*>(index->addr);
+  RAFT_EXPECTS(index_ptr != nullptr, "The IVF-PQ index is empty");
+  cuvs::neighbors::ivf_pq::serialize(*res_ptr, os, *index_ptr);
+  os.flush();
+  RAFT_EXPECTS(os.good(), "Error writing the IVF-PQ index");
+}
+
+/** Load an index from `is`, or from `filename` if it is set. */
+template <typename IdxT>
+void _deserialize(cuvsResources_t res,
+                  std::istream& is,
+                  const char* filename,
+                  cuvsIvfPqIndex_t index)
+{
+  auto res_ptr   = reinterpret_cast<raft::resources*>(res);
+  auto index_ptr = new cuvs::neighbors::ivf_pq::index<IdxT>(
+    *res_ptr,
+    cuvs::distance::DistanceType::L2Expanded,
+    cuvs::neighbors::ivf_pq::codebook_gen::PER_SUBSPACE,
+    0,
+    0);
+  try {
+    if (filename != nullptr) {
+      cuvs::neighbors::ivf_pq::deserialize_file(*res_ptr, std::string(filename), index_ptr);
+    } else {
+      cuvs::neighbors::ivf_pq::deserialize(*res_ptr, is, index_ptr);
+    }
+  } catch (...) {
+    delete index_ptr;
+    throw;
+  }
+  index->addr = reinterpret_cast<uintptr_t>(index_ptr);
+  switch (index_ptr->data_type()) {
+    case CUDA_R_32F: index->dtype = DLDataType{kDLFloat, 32, 1}; break;
+    case CUDA_R_16F: index->dtype = DLDataType{kDLFloat, 16, 1}; break;
+    case CUDA_R_8I: index->dtype = DLDataType{kDLInt, 8, 1}; break;
+    case CUDA_R_8U: index->dtype = DLDataType{kDLUInt, 8, 1}; break;
+    default: RAFT_FAIL("Unsupported IVF-PQ data type %d", static_cast<int>(index_ptr->data_type()));
+  }
+}
+
 }  // namespace
 
 extern "C" cuvsError_t cuvsIvfPqIndexCreate(cuvsIvfPqIndex_t* index)
@@ -233,3 +284,60 @@ extern "C" cuvsError_t cuvsIvfPqSearchParamsDestroy(cuvsIvfPqSearchParams_t para
     return CUVS_ERROR;
   }
 }
+
+extern "C" cuvsError_t cuvsIvfPqSerialize(cuvsResources_t res,
+                                          const char* filename,
+                                          cuvsIvfPqIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    if (!os) { RAFT_FAIL("Cannot open file %s", filename); }
+    _serialize<int64_t>(res, os, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfPqSerializeToStream(cuvsResources_t res,
+                                                  cuvsWriteCallback write,
+                                                  void* context,
+                                                  cuvsIvfPqIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::core::detail::callback_writebuf buf(write, context);
+    std::ostream os(&buf);
+    _serialize<int64_t>(res, os, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfPqDeserialize(cuvsResources_t res,
+                                            const char* filename,
+                                            cuvsIvfPqIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    std::ifstream is;
+    _deserialize<int64_t>(res, is, filename, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfPqDeserializeFromStream(cuvsResources_t res,
+                                                      cuvsReadCallback read,
+                                                      void* context,
+                                                      cuvsIvfPqIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::core::detail::callback_readbuf buf(read, context);
+    std::istream is(&buf);
+    _deserialize<int64_t>(res, is, nullptr, index);
+  });
+}
+
+extern "C" cuvsError_t cuvsIvfPqDeserializeFromBuffer(cuvsResources_t res,
+                                                      const void* data,
+                                                      size_t size,
+                                                      cuvsIvfPqIndex_t index)
+{
+  return cuvs::core::translate_exceptions([=] {
+    cuvs::neighbors::detail::memory_readbuf buf(static_cast<const uint8_t*>(data), size);
+    std::istream is(&buf);
+    _deserialize<int64_t>(res, is, nullptr, index);
+  });
+}
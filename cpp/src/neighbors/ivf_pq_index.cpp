@@ -148,6 +148,18 @@ bool index<IdxT>::conservative_memory_allocation() const noexcept
   return conservative_memory_allocation_;
 }
 
+template <typename IdxT>
+cudaDataType_t index<IdxT>::data_type() const noexcept
+{
+  return data_type_;
+}
+
+template <typename IdxT>
+void index<IdxT>::set_data_type(cudaDataType_t data_type) noexcept
+{
+  data_type_ = data_type;
+}
+
 template <typename IdxT>
 raft::device_mdspan<float,
                     typename cuvs::neighbors::ivf_pq::index<IdxT>::pq_centers_extents,
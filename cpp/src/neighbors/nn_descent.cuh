@@ -17,11 +17,14 @@
 #pragma once
 
 #include "detail/nn_descent.cuh"
+#include "detail/nn_descent_partitioned.cuh"
 #include <cuvs/neighbors/nn_descent.hpp>
 
 #include <raft/core/device_mdspan.hpp>
 #include <raft/core/host_mdspan.hpp>
 
+#include <algorithm>
+
 namespace cuvs::neighbors::nn_descent {
 
 /**
@@ -61,6 +64,8 @@ auto build(raft::resources const& res,
            index_params const& params,
            raft::device_matrix_view<const T, int64_t, raft::row_major> dataset) -> index<IdxT>
 {
+  RAFT_EXPECTS(params.n_clusters <= 1,
+               "The partitioned build (n_clusters > 1) needs a dataset in host memory or in a file");
   return detail::build<T, IdxT>(res, params, dataset);
 }
 
@@ -100,6 +105,8 @@ void build(raft::resources const& res,
            raft::device_matrix_view<const T, int64_t, raft::row_major> dataset,
            index<IdxT>& idx)
 {
+  RAFT_EXPECTS(params.n_clusters <= 1,
+               "The partitioned build (n_clusters > 1) needs a dataset in host memory or in a file");
   detail::build<T, IdxT>(res, params, dataset, idx);
 }
 
@@ -135,6 +142,14 @@ auto build(raft::resources const& res,
            index_params const& params,
            raft::host_matrix_view<const T, int64_t, raft::row_major> dataset) -> index<IdxT>
 {
+  if (params.n_clusters > 1) {
+    index<IdxT> idx{
+      res,
+      dataset.extent(0),
+      static_cast<int64_t>(std::min(params.graph_degree, params.intermediate_graph_degree))};
+    build<T, IdxT>(res, params, dataset, idx);
+    return idx;
+  }
   return detail::build<T, IdxT>(res, params, dataset);
 }
 
@@ -174,9 +189,40 @@ void build(raft::resources const& res,
            raft::host_matrix_view<const T, int64_t, raft::row_major> dataset,
            index<IdxT>& idx)
 {
+  if (params.n_clusters > 1) {
+    detail::memory_row_reader<T> reader(
+      dataset.data_handle(), dataset.extent(0), dataset.extent(1));
+    detail::build_partitioned(res, params, reader, idx);
+    return;
+  }
   detail::build<T, IdxT>(res, params, dataset, idx);
 }
 
+/**
+ * @brief Build nn-descent Index with a dataset stored in a file
+ *
+ * The dataset is built in `params.n_clusters` overlapping partitions, read from the file one at a
+ * time (see `index_params::n_clusters`).
+ *
+ * @tparam T data-type of the input dataset
+ * @tparam IdxT data-type for the output index
+ * @param[in] res raft::resources is an object mangaging resources
+ * @param[in] params an instance of nn_descent::index_params that are parameters
+ *               to run the nn-descent algorithm
+ * @param[in] dataset the file and shape of the input dataset
+ * @param[out] idx  cuvs::neighbors::nn_descentindex containing all-neighbors knn graph
+ * in host memory
+ */
+template <typename T, typename IdxT = uint32_t>
+void build(raft::resources const& res,
+           index_params const& params,
+           const file_dataset<T>& dataset,
+           index<IdxT>& idx)
+{
+  detail::file_row_reader<T> reader(dataset);
+  detail::build_partitioned(res, params, reader, idx);
+}
+
 /** @} */  // end group nn-descent
 
 }  // namespace cuvs::neighbors::nn_descent
@@ -34,6 +34,14 @@ namespace cuvs::neighbors::nn_descent {
     ->cuvs::neighbors::nn_descent::index<IdxT>                                    \
   {                                                                               \
     return cuvs::neighbors::nn_descent::build<T, IdxT>(handle, params, dataset);  \
+  };                                                                              \
+                                                                                  \
+  void build(raft::resources const& handle,                                       \
+             const cuvs::neighbors::nn_descent::index_params& params,             \
+             const cuvs::neighbors::nn_descent::file_dataset<T>& dataset,         \
+             cuvs::neighbors::nn_descent::index<IdxT>& idx)                       \
+  {                                                                               \
+    cuvs::neighbors::nn_descent::build<T, IdxT>(handle, params, dataset, idx);    \
   };
 
 CUVS_INST_NN_DESCENT_BUILD(int8_t, uint32_t);
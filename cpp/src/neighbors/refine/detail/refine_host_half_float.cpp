@@ -26,10 +26,19 @@
     raft::host_matrix_view<const idx_t, matrix_idx, raft::row_major> neighbor_candidates, \
     raft::host_matrix_view<idx_t, matrix_idx, raft::row_major> indices,                   \
     raft::host_matrix_view<distance_t, matrix_idx, raft::row_major> distances,            \
-    cuvs::distance::DistanceType metric)                                                  \
+    cuvs::distance::DistanceType metric,                                                  \
+    float metric_arg,                                                                     \
+    std::optional<raft::host_vector_view<const float, int64_t>> dataset_norms)            \
   {                                                                                       \
-    refine_impl<idx_t, data_t, distance_t, matrix_idx>(                                   \
-      handle, dataset, queries, neighbor_candidates, indices, distances, metric);         \
+    refine_impl<idx_t, data_t, distance_t, matrix_idx>(handle,                            \
+                                                       dataset,                           \
+                                                       queries,                           \
+                                                       neighbor_candidates,               \
+                                                       indices,                           \
+                                                       distances,                         \
+                                                       metric,                            \
+                                                       metric_arg,                        \
+                                                       dataset_norms);                    \
   }
 
 instantiate_cuvs_neighbors_refine(int64_t, half, float, int64_t);
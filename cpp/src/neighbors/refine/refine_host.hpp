@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include "../../core/mmap.hpp"
 #include "../../core/nvtx.hpp"
+#include "../../distance/detail/host_distance.hpp"
+#include "../../selection/detail/select_k_host.hpp"
 #include "refine_common.hpp"
 #include <raft/core/host_mdspan.hpp>
 #include <raft/util/integer_utils.hpp>
@@ -24,18 +27,161 @@
 #include <omp.h>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <vector>
 
 namespace cuvs::neighbors {
 
 namespace detail {
 
+/** The order in which the host refine reads the dataset rows of the candidates. */
+enum class refine_access_order {
+  /** Storage order if the rows are not resident in memory (see `prefer_storage_order`). */
+  kAuto,
+  /** Query by query. */
+  kQuery,
+  /** Storage order (see `compute_distances_in_storage_order`). */
+  kStorage
+};
+
+/**
+ * Whether the dataset rows of the candidates should be visited in storage order.
+ *
+ * This is the case when a noticeable part of the rows referenced by the candidates is not resident
+ * in memory, e.g. when the dataset is a memory-mapped file on disk that has not been read yet.
+ * Random access to such a dataset is bound by the page fault latency rather than the I/O bandwidth.
+ * A small sample of the candidates is probed with `mincore`.
+ */
+template <typename DataT, typename IdxT>
+auto prefer_storage_order(
+  const DataT* dataset, size_t n_rows, size_t dim, const IdxT* candidates, size_t n_candidates)
+  -> bool
+{
+  constexpr size_t kSamples = 64;
+  size_t n_probed           = 0;
+  size_t n_missing          = 0;
+  auto step                 = std::max<size_t>(1, n_candidates / kSamples);
+  for (size_t i = 0; i < n_candidates; i += step) {
+    auto id = static_cast<size_t>(candidates[i]);
+    if (id >= n_rows) { continue; }
+    n_probed++;
+    if (!cuvs::core::detail::is_page_resident(dataset + dim * id)) { n_missing++; }
+  }
+  // Switch when at least one in eight probed rows would cause a major page fault.
+  return n_missing > 0 && n_missing * 8 >= n_probed;
+}
+
+/** The granularity of the read-ahead requests of `compute_distances_in_storage_order`. */
+constexpr size_t kStorageOrderWindowBytes = size_t(64) << 20;
+
+/**
+ * Compute the distances of all the candidates of the batch, reading the dataset in storage order.
+ *
+ * The candidates are bucketed by the window of the dataset (`window_bytes`) their rows fall into
+ * and sorted by the row id within each window. While the distances of one window are computed, the
+ * kernel is asked to read ahead the rows needed by the next non-empty window (MADV_WILLNEED), so
+ * that the I/O of one window overlaps with the computation of the previous one.
+ *
+ * @param[out] out distances of the candidates [n_queries * orig_k]
+ * @param candidate_distance `(size_t query_ix, IdxT id) -> DistanceT`
+ */
+template <typename DataT, typename IdxT, typename DistanceT, typename DistanceOp>
+void compute_distances_in_storage_order(const DataT* dataset,
+                                        size_t n_rows,
+                                        size_t dim,
+                                        const IdxT* candidates,
+                                        size_t n_queries,
+                                        size_t orig_k,
+                                        DistanceT* out,
+                                        DistanceOp candidate_distance,
+                                        int n_threads,
+                                        size_t window_bytes = kStorageOrderWindowBytes)
+{
+  // Rows closer to each other than this are prefetched as one contiguous range.
+  constexpr size_t kMaxGapBytes = size_t(64) << 10;
+
+  size_t row_bytes       = dim * sizeof(DataT);
+  size_t rows_per_window = std::max<size_t>(1, window_bytes / std::max<size_t>(1, row_bytes));
+  size_t n_windows       = raft::div_rounding_up_safe<size_t>(n_rows, rows_per_window);
+  size_t n_candidates    = n_queries * orig_k;
+
+  // Counting sort of the candidate slots by the dataset window.
+  std::vector<size_t> window_offsets(n_windows + 1, 0);
+  for (size_t slot = 0; slot < n_candidates; slot++) {
+    auto id = static_cast<size_t>(candidates[slot]);
+    if (id < n_rows) {
+      window_offsets[id / rows_per_window + 1]++;
+    } else {
+      out[slot] = std::numeric_limits<DistanceT>::max();
+    }
+  }
+  for (size_t w = 0; w < n_windows; w++) {
+    window_offsets[w + 1] += window_offsets[w];
+  }
+  std::vector<size_t> slots(window_offsets[n_windows]);
+  {
+    std::vector<size_t> cursor(window_offsets.begin(), window_offsets.end() - 1);
+    for (size_t slot = 0; slot < n_candidates; slot++) {
+      auto id = static_cast<size_t>(candidates[slot]);
+      if (id < n_rows) { slots[cursor[id / rows_per_window]++] = slot; }
+    }
+  }
+#pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+  for (size_t w = 0; w < n_windows; w++) {
+    std::sort(slots.data() + window_offsets[w],
+              slots.data() + window_offsets[w + 1],
+              [candidates](size_t a, size_t b) { return candidates[a] < candidates[b]; });
+  }
+
+  auto next_window = [&](size_t w) {
+    while (w < n_windows && window_offsets[w] == window_offsets[w + 1]) {
+      w++;
+    }
+    return w;
+  };
+  auto prefetch_window = [&](size_t w) {
+    if (w >= n_windows) { return; }
+    const char* base = reinterpret_cast<const char*>(dataset);
+    size_t begin     = 0;
+    size_t end       = 0;
+    for (size_t p = window_offsets[w]; p < window_offsets[w + 1]; p++) {
+      size_t row_begin = static_cast<size_t>(candidates[slots[p]]) * row_bytes;
+      if (end > 0 && row_begin <= end + kMaxGapBytes) {
+        end = std::max(end, row_begin + row_bytes);
+        continue;
+      }
+      if (end > 0) { cuvs::core::detail::advise_willneed(base + begin, end - begin); }
+      begin = row_begin;
+      end   = row_begin + row_bytes;
+    }
+    if (end > 0) { cuvs::core::detail::advise_willneed(base + begin, end - begin); }
+  };
+
+  auto w = next_window(0);
+  prefetch_window(w);
+  while (w < n_windows) {
+    auto w_next = next_window(w + 1);
+    prefetch_window(w_next);
+#pragma omp parallel for schedule(static) num_threads(n_threads)
+    for (size_t p = window_offsets[w]; p < window_offsets[w + 1]; p++) {
+      auto slot = slots[p];
+      out[slot] = candidate_distance(slot / orig_k, candidates[slot]);
+    }
+    w = w_next;
+  }
+}
+
 template <typename DC, typename IdxT, typename DataT, typename DistanceT, typename ExtentsT>
 [[gnu::optimize(3), gnu::optimize("tree-vectorize")]] void refine_host_impl(
+  const DC& dc,
   raft::host_matrix_view<const DataT, ExtentsT, raft::row_major> dataset,
   raft::host_matrix_view<const DataT, ExtentsT, raft::row_major> queries,
   raft::host_matrix_view<const IdxT, ExtentsT, raft::row_major> neighbor_candidates,
   raft::host_matrix_view<IdxT, ExtentsT, raft::row_major> indices,
-  raft::host_matrix_view<DistanceT, ExtentsT, raft::row_major> distances)
+  raft::host_matrix_view<DistanceT, ExtentsT, raft::row_major> distances,
+  refine_access_order order)
 {
   size_t n_queries = queries.extent(0);
   size_t n_rows    = dataset.extent(0);
@@ -48,126 +194,302 @@ template <typename DC, typename IdxT, typename DataT, typename DistanceT, typena
 
   auto suggested_n_threads = std::max(1, std::min(omp_get_num_procs(), omp_get_max_threads()));
 
+  namespace host_select = cuvs::selection::detail::host;
+
+  auto candidate_distance = [&](size_t i, IdxT id) -> DistanceT {
+    if (static_cast<size_t>(id) >= n_rows) { return std::numeric_limits<DistanceT>::max(); }
+    const DataT* query = queries.data_handle() + dim * i;
+    const DataT* row   = dataset.data_handle() + dim * id;
+    return static_cast<DistanceT>(dc(i, query, row, static_cast<size_t>(id)));
+  };
+
+  // Write the best refined_k candidates of the query i in the ascending order of distance.
+  auto store_result = [&](host_select::bounded_heap<DistanceT, IdxT>& heap, size_t i) {
+    DistanceT* out_distances =
+      distances.data_handle() != nullptr ? distances.data_handle() + refined_k * i : nullptr;
+    heap.pop_sorted(out_distances, indices.data_handle() + refined_k * i);
+    if (out_distances != nullptr) {
+      for (size_t j = 0; j < refined_k; j++) {
+        out_distances[j] = static_cast<DistanceT>(dc.postprocess(out_distances[j]));
+      }
+    }
+  };
+
+  // If the dataset is not resident in memory (e.g. a cold memory-mapped file), compute the
+  // distances of the whole batch in the storage order of the dataset rows.
+  bool storage_order =
+    order == refine_access_order::kStorage ||
+    (order == refine_access_order::kAuto &&
+     prefer_storage_order(
+       dataset.data_handle(), n_rows, dim, neighbor_candidates.data_handle(), n_queries * orig_k));
+
   // If the number of queries is small, separate the distance calculation and
   // the top-k calculation into separate loops, and apply finer-grained thread
   // parallelism to the distance calculation loop.
-  if (n_queries < size_t(suggested_n_threads)) {
-    std::vector<std::vector<std::tuple<DistanceT, IdxT>>> refined_pairs(
-      n_queries, std::vector<std::tuple<DistanceT, IdxT>>(orig_k));
-
-    // For efficiency, each thread should read a certain amount of array
-    // elements. The number of threads for distance computation is determined
-    // taking this into account.
-    auto n_elements    = std::max(size_t(512), dim);
-    auto max_n_threads = raft::div_rounding_up_safe<size_t>(n_queries * orig_k * dim, n_elements);
-    auto suggested_n_threads_for_distance = std::min(size_t(suggested_n_threads), max_n_threads);
+  if (storage_order || n_queries < size_t(suggested_n_threads)) {
+    // The distances are kept in a buffer of the calling thread, reused across calls; the buffers
+    // of large batches are freed on return instead, so that the thread does not keep them.
+    struct refine_host_distances_tag {};
+    constexpr size_t kMaxRetainedDistances = (size_t(16) << 20) / sizeof(DistanceT);
+    std::vector<DistanceT> batch_distances;
+    DistanceT* refined_distances = nullptr;
+    if (n_queries * orig_k <= kMaxRetainedDistances) {
+      refined_distances =
+        host_select::thread_local_buffer<DistanceT, refine_host_distances_tag>(n_queries * orig_k);
+    } else {
+      batch_distances.resize(n_queries * orig_k);
+      refined_distances = batch_distances.data();
+    }
 
     // The max number of threads for topk computation is the number of queries.
     auto suggested_n_threads_for_topk = std::min(size_t(suggested_n_threads), n_queries);
 
-    // Compute the refined distance using original dataset vectors
+    if (storage_order) {
+      compute_distances_in_storage_order(dataset.data_handle(),
+                                         n_rows,
+                                         dim,
+                                         neighbor_candidates.data_handle(),
+                                         n_queries,
+                                         orig_k,
+                                         refined_distances,
+                                         candidate_distance,
+                                         suggested_n_threads);
+    } else {
+      // For efficiency, each thread should read a certain amount of array
+      // elements. The number of threads for distance computation is determined
+      // taking this into account.
+      auto n_elements = std::max(size_t(512), dim);
+      auto max_n_threads =
+        raft::div_rounding_up_safe<size_t>(n_queries * orig_k * dim, n_elements);
+      auto suggested_n_threads_for_distance = std::min(size_t(suggested_n_threads), max_n_threads);
+
+      // Compute the refined distance using original dataset vectors
 #pragma omp parallel for collapse(2) num_threads(suggested_n_threads_for_distance)
-    for (size_t i = 0; i < n_queries; i++) {
-      for (size_t j = 0; j < orig_k; j++) {
-        const DataT* query = queries.data_handle() + dim * i;
-        IdxT id            = neighbor_candidates(i, j);
-        DistanceT distance = 0.0;
-        if (static_cast<size_t>(id) >= n_rows) {
-          distance = std::numeric_limits<DistanceT>::max();
-        } else {
-          const DataT* row = dataset.data_handle() + dim * id;
-          for (size_t k = 0; k < dim; k++) {
-            distance += DC::template eval<DistanceT>(query[k], row[k]);
-          }
+      for (size_t i = 0; i < n_queries; i++) {
+        for (size_t j = 0; j < orig_k; j++) {
+          refined_distances[i * orig_k + j] = candidate_distance(i, neighbor_candidates(i, j));
         }
-        refined_pairs[i][j] = std::make_tuple(distance, id);
       }
     }
 
-    // Sort the query neighbors by their refined distances
+    // Select the refined_k nearest neighbors of each query
 #pragma omp parallel for num_threads(suggested_n_threads_for_topk)
     for (size_t i = 0; i < n_queries; i++) {
-      std::sort(refined_pairs[i].begin(), refined_pairs[i].end());
-      // Store first refined_k neighbors
-      for (size_t j = 0; j < refined_k; j++) {
-        indices(i, j) = std::get<1>(refined_pairs[i][j]);
-        if (distances.data_handle() != nullptr) {
-          distances(i, j) = DC::template postprocess(std::get<0>(refined_pairs[i][j]));
-        }
-      }
+      auto& heap = host_select::thread_local_heap<DistanceT, IdxT>(refined_k);
+      heap.push(refined_distances + i * orig_k,
+                neighbor_candidates.data_handle() + i * orig_k,
+                orig_k);
+      store_result(heap, i);
     }
     return;
   }
 
   if (size_t(suggested_n_threads) > n_queries) { suggested_n_threads = n_queries; }
 
-  {
-    std::vector<std::vector<std::tuple<DistanceT, IdxT>>> refined_pairs(
-      suggested_n_threads, std::vector<std::tuple<DistanceT, IdxT>>(orig_k));
 #pragma omp parallel num_threads(suggested_n_threads)
-    {
-      auto tid = omp_get_thread_num();
-      for (size_t i = tid; i < n_queries; i += omp_get_num_threads()) {
-        // Compute the refined distance using original dataset vectors
-        const DataT* query = queries.data_handle() + dim * i;
-        for (size_t j = 0; j < orig_k; j++) {
-          IdxT id            = neighbor_candidates(i, j);
-          DistanceT distance = 0.0;
-          if (static_cast<size_t>(id) >= n_rows) {
-            distance = std::numeric_limits<DistanceT>::max();
-          } else {
-            const DataT* row = dataset.data_handle() + dim * id;
-            for (size_t k = 0; k < dim; k++) {
-              distance += DC::template eval<DistanceT>(query[k], row[k]);
-            }
-          }
-          refined_pairs[tid][j] = std::make_tuple(distance, id);
-        }
-        // Sort the query neighbors by their refined distances
-        std::sort(refined_pairs[tid].begin(), refined_pairs[tid].end());
-        // Store first refined_k neighbors
-        for (size_t j = 0; j < refined_k; j++) {
-          indices(i, j) = std::get<1>(refined_pairs[tid][j]);
-          if (distances.data_handle() != nullptr) {
-            distances(i, j) = DC::template postprocess(std::get<0>(refined_pairs[tid][j]));
-          }
-        }
+  {
+    auto tid   = omp_get_thread_num();
+    auto& heap = host_select::thread_local_heap<DistanceT, IdxT>(refined_k);
+    for (size_t i = tid; i < n_queries; i += omp_get_num_threads()) {
+      // Compute the refined distance using original dataset vectors and keep the best refined_k
+      for (size_t j = 0; j < orig_k; j++) {
+        IdxT id = neighbor_candidates(i, j);
+        heap.push(candidate_distance(i, id), id);
       }
+      store_result(heap, i);
     }
   }
 }
 
-struct distance_comp_l2 {
-  template <typename DistanceT>
-  static inline auto eval(const DistanceT& a, const DistanceT& b) -> DistanceT
+/**
+ * Distance components of the host refinement.
+ *
+ * A distance component maps `(query_ix, query, row, row_ix)` to a key, where a smaller key means a
+ * closer neighbor; `postprocess` converts the keys of the selected neighbors into the distances of
+ * the metric. The dataset and the queries share the dimensionality `dim` passed on construction.
+ */
+
+/**
+ * Metrics that are a monotonic function of one of the SIMD kernels (see `distance_kernels`):
+ *
+ *   distance = offset + scale * (sqrt?)(kernel(x, y)),   key = sign * kernel(x, y)
+ */
+template <typename DataT>
+struct distance_comp_kernel {
+  cuvs::distance::detail::host::distance_kernel<DataT> kernel;
+  size_t dim;
+  float sign   = 1.0f;
+  bool sqrt    = false;
+  float scale  = 1.0f;
+  float offset = 0.0f;
+
+  inline auto operator()(size_t, const DataT* query, const DataT* row, size_t) const -> float
+  {
+    return sign * kernel(query, row, dim);
+  }
+  inline auto postprocess(float key) const -> float
+  {
+    float d = sign * key;
+    if (sqrt) { d = std::sqrt(std::max(d, 0.0f)); }
+    return offset + scale * d;
+  }
+};
+
+/**
+ * Cosine distance: 1 - (x ⋅ y) / (||x||_2 ||y||_2)
+ *
+ * The norms of the queries are computed once; the norms of the dataset rows are taken from
+ * `dataset_norms` when given, otherwise they are computed next to the inner product (the row is
+ * in cache by then).
+ */
+template <typename DataT>
+struct distance_comp_cosine {
+  cuvs::distance::detail::host::distance_kernel<DataT> kernel;
+  size_t dim;
+  const float* dataset_norms;
+  std::vector<float> query_norms;
+
+  distance_comp_cosine(const DataT* queries, size_t n_queries, size_t dim, const float* norms)
+    : kernel(cuvs::distance::detail::host::get_distance_kernels<DataT>().inner_product),
+      dim(dim),
+      dataset_norms(norms),
+      query_norms(n_queries)
+  {
+#pragma omp parallel for
+    for (size_t i = 0; i < n_queries; i++) {
+      query_norms[i] = std::sqrt(kernel(queries + dim * i, queries + dim * i, dim));
+    }
+  }
+
+  inline auto operator()(size_t query_ix, const DataT* query, const DataT* row, size_t row_ix) const
+    -> float
+  {
+    float row_norm = dataset_norms != nullptr ? dataset_norms[row_ix]
+                                              : std::sqrt(kernel(row, row, dim));
+    float denom    = query_norms[query_ix] * row_norm;
+    // A zero vector is treated as orthogonal to all other vectors.
+    return denom > 0 ? 1.0f - kernel(query, row, dim) / denom : 1.0f;
+  }
+  inline auto postprocess(float key) const -> float { return key; }
+};
+
+/**
+ * Metrics without a SIMD kernel, computed by an element-wise accumulation followed by an epilog
+ * (mirroring the corresponding `distance_ops`). `Op` provides
+ * `accumulate(float acc, float x, float y) -> float` and `epilog(float acc, size_t dim) -> float`.
+ */
+template <typename DataT, typename Op>
+struct distance_comp_elementwise {
+  size_t dim;
+  Op op;
+
+  inline auto operator()(size_t, const DataT* query, const DataT* row, size_t) const -> float
+  {
+    using cuvs::distance::detail::host::to_float;
+    float acc = 0;
+    for (size_t k = 0; k < dim; k++) {
+      acc = op.accumulate(acc, to_float(query[k]), to_float(row[k]));
+    }
+    return op.epilog(acc, dim);
+  }
+  inline auto postprocess(float key) const -> float { return key; }
+};
+
+/** Lp (Minkowski) distance: (sum |x - y|^p)^(1/p) */
+struct lp_op {
+  float p;
+  inline auto accumulate(float acc, float x, float y) const -> float
   {
-    auto d = a - b;
-    return d * d;
+    return acc + std::pow(std::abs(x - y), p);
   }
-  template <typename DistanceT>
-  static inline auto postprocess(const DistanceT& a) -> DistanceT
+  inline auto epilog(float acc, size_t) const -> float { return std::pow(acc, 1.0f / p); }
+};
+
+/** Canberra distance: sum |x - y| / (|x| + |y|) */
+struct canberra_op {
+  inline auto accumulate(float acc, float x, float y) const -> float
   {
-    return a;
+    float add = std::abs(x) + std::abs(y);
+    return add != 0 ? acc + std::abs(x - y) / add : acc;
   }
+  inline auto epilog(float acc, size_t) const -> float { return acc; }
 };
 
-struct distance_comp_inner {
-  template <typename DistanceT>
-  static inline auto eval(const DistanceT& a, const DistanceT& b) -> DistanceT
+/** Hellinger distance: sqrt(1 - sum sqrt(x * y)) */
+struct hellinger_op {
+  inline auto accumulate(float acc, float x, float y) const -> float
   {
-    return -a * b;
+    return acc + std::sqrt(x) * std::sqrt(y);
   }
-  template <typename DistanceT>
-  static inline auto postprocess(const DistanceT& a) -> DistanceT
+  inline auto epilog(float acc, size_t) const -> float
   {
-    return -a;
+    return std::sqrt(std::max(1.0f - acc, 0.0f));
   }
 };
 
+/** Jensen-Shannon distance: sqrt(0.5 * sum(-x (log m - log x) - y (log m - log y))), m = (x+y)/2 */
+struct jensen_shannon_op {
+  inline auto accumulate(float acc, float x, float y) const -> float
+  {
+    float m     = 0.5f * (x + y);
+    float log_m = m != 0 ? std::log(m) : 0.0f;
+    if (x != 0) { acc += -x * (log_m - std::log(x)); }
+    if (y != 0) { acc += -y * (log_m - std::log(y)); }
+    return acc;
+  }
+  inline auto epilog(float acc, size_t) const -> float { return std::sqrt(0.5f * acc); }
+};
+
+/** Kullback-Leibler divergence of the dataset row from the query: 0.5 * sum(x log(x / y)) */
+struct kl_divergence_op {
+  inline auto accumulate(float acc, float x, float y) const -> float
+  {
+    if (x == 0) { return acc; }
+    return acc + x * (std::log(x) - (y != 0 ? std::log(y) : 0.0f));
+  }
+  inline auto epilog(float acc, size_t) const -> float { return 0.5f * acc; }
+};
+
 /**
- * Naive CPU implementation of refine operation
+ * Correlation distance: 1 - cov(x, y) / (std(x) std(y))
  *
+ * The sums needed for the means and the variances are accumulated in the same pass as the inner
+ * product.
+ */
+template <typename DataT>
+struct distance_comp_correlation {
+  size_t dim;
+
+  inline auto operator()(size_t, const DataT* query, const DataT* row, size_t) const -> float
+  {
+    using cuvs::distance::detail::host::to_float;
+    float sx = 0, sy = 0, sxy = 0, sxx = 0, syy = 0;
+    for (size_t k = 0; k < dim; k++) {
+      float x = to_float(query[k]);
+      float y = to_float(row[k]);
+      sx += x;
+      sy += y;
+      sxy += x * y;
+      sxx += x * x;
+      syy += y * y;
+    }
+    float n     = static_cast<float>(dim);
+    float numer = n * sxy - sx * sy;
+    float denom = std::sqrt((n * sxx - sx * sx) * (n * syy - sy * sy));
+    return denom > 0 ? 1.0f - numer / denom : 1.0f;
+  }
+  inline auto postprocess(float key) const -> float { return key; }
+};
+
+/**
+ * CPU implementation of refine operation
+ *
+ * The distances are computed by SIMD kernels selected at runtime for the CPU we run on.
  * All pointers are expected to be accessible on the host.
+ *
+ * @param metric_arg the `p` of the Lp (Minkowski) metric
+ * @param dataset_norms optional L2 norms of the dataset rows [n_rows], used by the cosine metric
+ * @param order the order in which the dataset rows are read
  */
 template <typename IdxT, typename DataT, typename DistanceT, typename ExtentsT>
 [[gnu::optimize(3), gnu::optimize("tree-vectorize")]] void refine_host(
@@ -176,7 +498,10 @@ template <typename IdxT, typename DataT, typename DistanceT, typename ExtentsT>
   raft::host_matrix_view<const IdxT, ExtentsT, raft::row_major> neighbor_candidates,
   raft::host_matrix_view<IdxT, ExtentsT, raft::row_major> indices,
   raft::host_matrix_view<DistanceT, ExtentsT, raft::row_major> distances,
-  cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded)
+  cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+  float metric_arg                    = 2.0f,
+  const float* dataset_norms          = nullptr,
+  refine_access_order order           = refine_access_order::kAuto)
 {
   refine_check_input(dataset.extents(),
                      queries.extents(),
@@ -185,13 +510,55 @@ template <typename IdxT, typename DataT, typename DistanceT, typename ExtentsT>
                      distances.extents(),
                      metric);
 
+  using cuvs::distance::DistanceType;
+  size_t dim    = dataset.extent(1);
+  auto& kernels = cuvs::distance::detail::host::get_distance_kernels<DataT>();
+  auto run      = [&](const auto& dc) {
+    refine_host_impl(dc, dataset, queries, neighbor_candidates, indices, distances, order);
+  };
+  auto run_elementwise = [&](auto op) {
+    run(distance_comp_elementwise<DataT, decltype(op)>{dim, op});
+  };
+
   switch (metric) {
-    case cuvs::distance::DistanceType::L2Expanded:
-      return refine_host_impl<distance_comp_l2>(
-        dataset, queries, neighbor_candidates, indices, distances);
-    case cuvs::distance::DistanceType::InnerProduct:
-      return refine_host_impl<distance_comp_inner>(
-        dataset, queries, neighbor_candidates, indices, distances);
+    case DistanceType::L2Expanded:
+    case DistanceType::L2Unexpanded: return run(distance_comp_kernel<DataT>{kernels.l2, dim});
+    case DistanceType::L2SqrtExpanded:
+    case DistanceType::L2SqrtUnexpanded: {
+      distance_comp_kernel<DataT> dc{kernels.l2, dim};
+      dc.sqrt = true;
+      return run(dc);
+    }
+    case DistanceType::InnerProduct: {
+      distance_comp_kernel<DataT> dc{kernels.inner_product, dim};
+      dc.sign = -1.0f;
+      return run(dc);
+    }
+    case DistanceType::L1: return run(distance_comp_kernel<DataT>{kernels.l1, dim});
+    case DistanceType::Linf: return run(distance_comp_kernel<DataT>{kernels.linf, dim});
+    case DistanceType::HammingUnexpanded: {
+      distance_comp_kernel<DataT> dc{kernels.hamming, dim};
+      dc.scale = 1.0f / static_cast<float>(dim);
+      return run(dc);
+    }
+    case DistanceType::RusselRaoExpanded: {
+      distance_comp_kernel<DataT> dc{kernels.inner_product, dim};
+      dc.sign   = -1.0f;
+      dc.scale  = -1.0f / static_cast<float>(dim);
+      dc.offset = 1.0f;
+      return run(dc);
+    }
+    case DistanceType::CosineExpanded:
+      return run(distance_comp_cosine<DataT>(
+        queries.data_handle(), queries.extent(0), dim, dataset_norms));
+    case DistanceType::CorrelationExpanded: return run(distance_comp_correlation<DataT>{dim});
+    case DistanceType::LpUnexpanded:
+      RAFT_EXPECTS(metric_arg > 0, "The Lp metric requires p > 0 (got %f)", metric_arg);
+      return run_elementwise(lp_op{metric_arg});
+    case DistanceType::Canberra: return run_elementwise(canberra_op{});
+    case DistanceType::HellingerExpanded: return run_elementwise(hellinger_op{});
+    case DistanceType::JensenShannon: return run_elementwise(jensen_shannon_op{});
+    case DistanceType::KLDivergence: return run_elementwise(kl_divergence_op{});
     default: throw raft::logic_error("Unsupported metric");
   }
 }
@@ -206,9 +573,22 @@ void refine_impl(
   raft::host_matrix_view<const idx_t, matrix_idx, raft::row_major> neighbor_candidates,
   raft::host_matrix_view<idx_t, matrix_idx, raft::row_major> indices,
   raft::host_matrix_view<distance_t, matrix_idx, raft::row_major> distances,
-  cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded)
+  cuvs::distance::DistanceType metric = cuvs::distance::DistanceType::L2Unexpanded,
+  float metric_arg                    = 2.0f,
+  std::optional<raft::host_vector_view<const float, int64_t>> dataset_norms = std::nullopt)
 {
-  detail::refine_host(dataset, queries, neighbor_candidates, indices, distances, metric);
+  if (dataset_norms.has_value()) {
+    RAFT_EXPECTS(dataset_norms->extent(0) == static_cast<int64_t>(dataset.extent(0)),
+                 "dataset_norms must have one element per dataset row");
+  }
+  detail::refine_host(dataset,
+                      queries,
+                      neighbor_candidates,
+                      indices,
+                      distances,
+                      metric,
+                      metric_arg,
+                      dataset_norms.has_value() ? dataset_norms->data_handle() : nullptr);
 }
 
 }  // namespace cuvs::neighbors
\ No newline at end of file
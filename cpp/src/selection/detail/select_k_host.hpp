@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace cuvs::selection::detail::host {
+
+/**
+ * A bounded binary heap that keeps the k best key/value pairs seen so far.
+ *
+ * Keys and values are stored in separate arrays (struct-of-arrays), so that the common case --
+ * rejecting a candidate that is worse than the current k-th best -- touches a single key.
+ * The heap root is the worst of the retained keys.
+ *
+ * The storage is retained between `reset` calls; a heap kept per thread (see `thread_local_heap`)
+ * therefore does not allocate once it has grown to the largest k used.
+ *
+ * @tparam KeyT type of the keys (compared)
+ * @tparam ValT type of the payload (e.g. indices)
+ * @tparam SelectMin whether to keep the k smallest (true) or largest (false) keys
+ */
+template <typename KeyT, typename ValT, bool SelectMin = true>
+class bounded_heap {
+ public:
+  /** Clear the heap and set its capacity to k. */
+  void reset(size_t k)
+  {
+    k_    = k;
+    size_ = 0;
+    if (keys_.size() < k) {
+      keys_.resize(k);
+      vals_.resize(k);
+    }
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> size_t { return k_; }
+  [[nodiscard]] auto size() const noexcept -> size_t { return size_; }
+  [[nodiscard]] auto full() const noexcept -> bool { return size_ == k_; }
+
+  /** Whether the key would be retained if pushed now. */
+  [[nodiscard]] inline auto accepts(KeyT key) const noexcept -> bool
+  {
+    return size_ < k_ || better(key, keys_[0]);
+  }
+
+  /** The worst of the retained keys; valid only when the heap is not empty. */
+  [[nodiscard]] inline auto worst() const noexcept -> KeyT { return keys_[0]; }
+
+  /** Offer a pair; it is kept only if it is better than the current worst one (or not full). */
+  inline void push(KeyT key, ValT val)
+  {
+    if (size_ < k_) {
+      sift_up(size_++, key, val);
+    } else if (k_ > 0 && better(key, keys_[0])) {
+      sift_down(0, key, val);
+    }
+  }
+
+  /** Offer `n` pairs given as separate key and value arrays. */
+  inline void push(const KeyT* keys, const ValT* vals, size_t n)
+  {
+    size_t i = 0;
+    for (; i < n && size_ < k_; i++) {
+      sift_up(size_++, keys[i], vals[i]);
+    }
+    if (k_ == 0) { return; }
+    // Keep the threshold in a register: in the steady state almost all candidates are rejected.
+    KeyT worst = keys_[0];
+    for (; i < n; i++) {
+      if (better(keys[i], worst)) {
+        sift_down(0, keys[i], vals[i]);
+        worst = keys_[0];
+      }
+    }
+  }
+
+  /** Offer `n` keys with the implied payload `offset...offset+n-1`. */
+  inline void push_iota(const KeyT* keys, size_t n, ValT offset)
+  {
+    size_t i = 0;
+    for (; i < n && size_ < k_; i++) {
+      sift_up(size_++, keys[i], static_cast<ValT>(offset + i));
+    }
+    if (k_ == 0) { return; }
+    KeyT worst = keys_[0];
+    for (; i < n; i++) {
+      if (better(keys[i], worst)) {
+        sift_down(0, keys[i], static_cast<ValT>(offset + i));
+        worst = keys_[0];
+      }
+    }
+  }
+
+  /**
+   * Write the retained pairs, best first, and empty the heap.
+   *
+   * Either of the output pointers may be nullptr.
+   * @return the number of written pairs (min(k, number of pushed pairs)).
+   */
+  auto pop_sorted(KeyT* out_keys, ValT* out_vals) -> size_t
+  {
+    auto n = size_;
+    while (size_ > 0) {
+      auto last = --size_;
+      if (out_keys != nullptr) { out_keys[last] = keys_[0]; }
+      if (out_vals != nullptr) { out_vals[last] = vals_[0]; }
+      if (last > 0) { sift_down(0, keys_[last], vals_[last]); }
+    }
+    return n;
+  }
+
+  /** Write the retained pairs in heap (unspecified) order and empty the heap. */
+  auto pop_unsorted(KeyT* out_keys, ValT* out_vals) -> size_t
+  {
+    auto n = size_;
+    for (size_t i = 0; i < n; i++) {
+      if (out_keys != nullptr) { out_keys[i] = keys_[i]; }
+      if (out_vals != nullptr) { out_vals[i] = vals_[i]; }
+    }
+    size_ = 0;
+    return n;
+  }
+
+ private:
+  std::vector<KeyT> keys_;
+  std::vector<ValT> vals_;
+  size_t k_    = 0;
+  size_t size_ = 0;
+
+  static inline auto better(KeyT a, KeyT b) noexcept -> bool
+  {
+    if constexpr (SelectMin) {
+      return a < b;
+    } else {
+      return a > b;
+    }
+  }
+
+  /** Place (key, val) into the hole at position `i`, moving it up towards the root. */
+  inline void sift_up(size_t i, KeyT key, ValT val)
+  {
+    while (i > 0) {
+      auto parent = (i - 1) / 2;
+      if (!better(keys_[parent], key)) { break; }
+      keys_[i] = keys_[parent];
+      vals_[i] = vals_[parent];
+      i        = parent;
+    }
+    keys_[i] = key;
+    vals_[i] = val;
+  }
+
+  /** Place (key, val) into the hole at position `i`, moving it down towards the leaves. */
+  inline void sift_down(size_t i, KeyT key, ValT val)
+  {
+    while (true) {
+      auto child = 2 * i + 1;
+      if (child >= size_) { break; }
+      if (child + 1 < size_ && better(keys_[child], keys_[child + 1])) { child++; }
+      if (!better(key, keys_[child])) { break; }
+      keys_[i] = keys_[child];
+      vals_[i] = vals_[child];
+      i        = child;
+    }
+    keys_[i] = key;
+    vals_[i] = val;
+  }
+};
+
+/**
+ * A heap owned by the calling thread, reset to capacity k.
+ *
+ * This is meant to be used inside OpenMP parallel regions: the worker threads are persistent, so
+ * the heap storage is allocated only on the first use of each thread.
+ */
+template <typename KeyT, typename ValT, bool SelectMin = true>
+auto thread_local_heap(size_t k) -> bounded_heap<KeyT, ValT, SelectMin>&
+{
+  thread_local bounded_heap<KeyT, ValT, SelectMin> heap;
+  heap.reset(k);
+  return heap;
+}
+
+/**
+ * A scratch buffer owned by the calling thread, with at least `size` elements.
+ *
+ * The buffer is reused between calls; the returned pointer is valid until the next call to
+ * `thread_local_buffer` with the same type and tag from the same thread.
+ *
+ * @tparam T element type
+ * @tparam Tag distinguishes the buffers of independent callers
+ */
+template <typename T, typename Tag = void>
+auto thread_local_buffer(size_t size) -> T*
+{
+  thread_local std::vector<T> buffer;
+  if (buffer.size() < size) { buffer.resize(size); }
+  return buffer.data();
+}
+
+/*
+ * Selection of the k best values of one row, the building blocks of the host `select_k`.
+ *
+ * The three algorithms trade per-element work for per-row overhead:
+ *
+ *  - heap: a bounded heap of k elements. The row is read in blocks of 16 values compared to the
+ *    current threshold with a loop the compiler vectorizes; a block with no better value, the
+ *    common case once the heap is full, costs a few SIMD compares. Best for small k.
+ *  - partial sort: `std::nth_element` over the positions of the row. Linear, but with a large
+ *    constant; best for very short rows.
+ *  - radix: an MSD radix select on the order-preserving bit patterns of the values, with 11-bit
+ *    digits. The first pass reads the whole row; the following ones only read the values sharing
+ *    the digits of the k-th one. Its cost does not depend on k; best for long rows and large k.
+ *
+ * Each writes min(k, len) pairs, best first if `sorted`, and pads the rest of the k outputs with
+ * the worst possible value and the maximum index.
+ */
+
+/** The host selection algorithms. */
+enum class select_algo { kHeap, kPartialSort, kRadix };
+
+/**
+ * Choose the algorithm for rows of `len` values.
+ *
+ * The heap is chosen when k is small compared to the row, so that its prefilter rejects almost
+ * every block once the heap is full. The partial sort is chosen for rows too short to amortize the
+ * histograms of the radix select, and the radix select otherwise. (The batch size only decides
+ * whether the rows run in parallel, see `select_k`.)
+ */
+inline auto choose_select_algo(size_t len, size_t k) -> select_algo
+{
+  if (k <= 256 && len >= 128 * k) { return select_algo::kHeap; }
+  return len <= 128 ? select_algo::kPartialSort : select_algo::kRadix;
+}
+
+template <bool SelectMin, typename T>
+inline auto better_value(T a, T b) noexcept -> bool
+{
+  if constexpr (SelectMin) {
+    return a < b;
+  } else {
+    return a > b;
+  }
+}
+
+/** The worst possible value, used to pad rows with fewer than k values. */
+template <bool SelectMin, typename T>
+constexpr auto worst_value() noexcept -> T
+{
+  return SelectMin ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest();
+}
+
+template <bool SelectMin, typename T, typename IdxT>
+inline void pad_selection(size_t n, size_t k, T* out_val, IdxT* out_idx)
+{
+  for (size_t j = n; j < k; j++) {
+    out_val[j] = worst_value<SelectMin, T>();
+    out_idx[j] = std::numeric_limits<IdxT>::max();
+  }
+}
+
+/**
+ * Write the selected positions of a row, sorting them first if asked to.
+ *
+ * `positions` is a scratch array of n positions of the row, reordered in place.
+ */
+template <bool SelectMin, typename T, typename IdxT>
+inline void write_selection(const T* in_val,
+                            const IdxT* in_idx,
+                            int64_t* positions,
+                            size_t n,
+                            bool sorted,
+                            T* out_val,
+                            IdxT* out_idx)
+{
+  if (sorted) {
+    std::sort(positions, positions + n, [in_val](int64_t a, int64_t b) {
+      return better_value<SelectMin>(in_val[a], in_val[b]);
+    });
+  }
+  for (size_t j = 0; j < n; j++) {
+    const int64_t p = positions[j];
+    out_val[j]      = in_val[p];
+    out_idx[j]      = in_idx != nullptr ? in_idx[p] : static_cast<IdxT>(p);
+  }
+}
+
+template <bool SelectMin, typename T, typename IdxT>
+void heap_select_row(const T* in_val,
+                     const IdxT* in_idx,
+                     size_t len,
+                     size_t k,
+                     bool sorted,
+                     T* out_val,
+                     IdxT* out_idx)
+{
+  constexpr size_t kBlock = 16;
+  auto& heap              = thread_local_heap<T, IdxT, SelectMin>(k);
+  auto payload = [in_idx](size_t i) { return in_idx != nullptr ? in_idx[i] : static_cast<IdxT>(i); };
+  size_t i     = 0;
+  for (; i < len && !heap.full(); i++) {
+    heap.push(in_val[i], payload(i));
+  }
+  if (k > 0) {
+    for (; i + kBlock <= len; i += kBlock) {
+      const T threshold = heap.worst();
+      const T* block    = in_val + i;
+      int any           = 0;
+      for (size_t j = 0; j < kBlock; j++) {
+        any |= int(better_value<SelectMin>(block[j], threshold));
+      }
+      if (any == 0) { continue; }
+      for (size_t j = 0; j < kBlock; j++) {
+        heap.push(block[j], payload(i + j));
+      }
+    }
+    for (; i < len; i++) {
+      heap.push(in_val[i], payload(i));
+    }
+  }
+  const size_t n = sorted ? heap.pop_sorted(out_val, out_idx) : heap.pop_unsorted(out_val, out_idx);
+  pad_selection<SelectMin>(n, k, out_val, out_idx);
+}
+
+struct partial_sort_tag {};
+
+template <bool SelectMin, typename T, typename IdxT>
+void partial_sort_row(const T* in_val,
+                      const IdxT* in_idx,
+                      size_t len,
+                      size_t k,
+                      bool sorted,
+                      T* out_val,
+                      IdxT* out_idx)
+{
+  auto* positions = thread_local_buffer<int64_t, partial_sort_tag>(len);
+  for (size_t i = 0; i < len; i++) {
+    positions[i] = static_cast<int64_t>(i);
+  }
+  const size_t n = std::min(k, len);
+  if (n < len) {
+    std::nth_element(positions, positions + n, positions + len, [in_val](int64_t a, int64_t b) {
+      return better_value<SelectMin>(in_val[a], in_val[b]);
+    });
+  }
+  write_selection<SelectMin>(in_val, in_idx, positions, n, sorted, out_val, out_idx);
+  pad_selection<SelectMin>(n, k, out_val, out_idx);
+}
+
+/**
+ * The bit pattern of a float as an unsigned integer with the same order as the values, inverted
+ * when selecting the largest values so that the radix select always looks for the smallest keys.
+ */
+template <bool SelectMin>
+inline auto radix_key(float v) noexcept -> uint32_t
+{
+  uint32_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  u = (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+  return SelectMin ? u : ~u;
+}
+
+struct radix_select_tag {};
+
+template <bool SelectMin, typename T, typename IdxT>
+void radix_select_row(const T* in_val,
+                      const IdxT* in_idx,
+                      size_t len,
+                      size_t k,
+                      bool sorted,
+                      T* out_val,
+                      IdxT* out_idx)
+{
+  static_assert(std::is_same_v<T, float>, "The radix select is implemented for float values");
+  constexpr uint32_t kDigitBits = 11;
+  constexpr uint32_t kBuckets   = 1u << kDigitBits;
+  constexpr int kFirstShift     = 32 - int(kDigitBits);
+
+  const size_t n = std::min(k, len);
+  // The selected positions, then the candidates sharing the digits of the k-th key so far.
+  auto* buffer     = thread_local_buffer<int64_t, radix_select_tag>(n + len);
+  int64_t* out     = buffer;
+  int64_t* cands   = buffer + n;
+  size_t n_out     = 0;
+  size_t n_cands   = 0;
+  size_t remaining = n;
+  uint32_t hist[kBuckets];
+
+  // Find the digit of the k-th key among the candidates, and the number of keys left to select
+  // among those with this digit.
+  auto find_bucket = [&](uint32_t& bucket) {
+    size_t cum = 0;
+    for (bucket = 0; cum + hist[bucket] < remaining; bucket++) {
+      cum += hist[bucket];
+    }
+    remaining -= cum;
+  };
+
+  if (n < len && n > 0) {
+    // First pass over the whole row.
+    std::fill(hist, hist + kBuckets, 0u);
+    for (size_t i = 0; i < len; i++) {
+      hist[radix_key<SelectMin>(in_val[i]) >> kFirstShift]++;
+    }
+    uint32_t bucket;
+    find_bucket(bucket);
+    for (size_t i = 0; i < len; i++) {
+      const uint32_t digit = radix_key<SelectMin>(in_val[i]) >> kFirstShift;
+      if (digit < bucket) {
+        out[n_out++] = static_cast<int64_t>(i);
+      } else if (digit == bucket) {
+        cands[n_cands++] = static_cast<int64_t>(i);
+      }
+    }
+    // The next passes over the candidates, compacted in place.
+    for (int shift = kFirstShift - int(kDigitBits);
+         shift > -int(kDigitBits) && remaining < n_cands;
+         shift -= int(kDigitBits)) {
+      const int s         = std::max(shift, 0);
+      const uint32_t mask = (shift < 0 ? (1u << (kDigitBits + shift)) : kBuckets) - 1;
+      std::fill(hist, hist + kBuckets, 0u);
+      for (size_t c = 0; c < n_cands; c++) {
+        hist[(radix_key<SelectMin>(in_val[cands[c]]) >> s) & mask]++;
+      }
+      find_bucket(bucket);
+      size_t n_next = 0;
+      for (size_t c = 0; c < n_cands; c++) {
+        const uint32_t digit = (radix_key<SelectMin>(in_val[cands[c]]) >> s) & mask;
+        if (digit < bucket) {
+          out[n_out++] = cands[c];
+        } else if (digit == bucket) {
+          cands[n_next++] = cands[c];
+        }
+      }
+      n_cands = n_next;
+    }
+    // The remaining candidates are equal to the k-th key, or are all selected.
+    for (size_t c = 0; c < remaining; c++) {
+      out[n_out++] = cands[c];
+    }
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      out[n_out++] = static_cast<int64_t>(i);
+    }
+  }
+  write_selection<SelectMin>(in_val, in_idx, out, n_out, sorted, out_val, out_idx);
+  pad_selection<SelectMin>(n_out, k, out_val, out_idx);
+}
+
+/**
+ * Select the k best values of each row of a row-major batch, in parallel over the rows.
+ *
+ * @param in_val values [batch_size, len]
+ * @param in_idx payload [batch_size, len], or nullptr for the positions in the row
+ * @param len_i lengths of the rows [batch_size], or nullptr if all rows have `len` values
+ * @param out_val selected values [batch_size, k]
+ * @param out_idx payload of the selected values [batch_size, k]
+ */
+template <typename T, typename IdxT, typename LenT>
+void select_k(const T* in_val,
+              const IdxT* in_idx,
+              size_t batch_size,
+              size_t len,
+              size_t k,
+              T* out_val,
+              IdxT* out_idx,
+              bool select_min,
+              bool sorted,
+              select_algo algo,
+              const LenT* len_i)
+{
+  auto row_fn = [=](auto select_min_tag) {
+    constexpr bool kSelectMin = decltype(select_min_tag)::value;
+    switch (algo) {
+      case select_algo::kHeap: return &heap_select_row<kSelectMin, T, IdxT>;
+      case select_algo::kPartialSort: return &partial_sort_row<kSelectMin, T, IdxT>;
+      default: return &radix_select_row<kSelectMin, T, IdxT>;
+    }
+  };
+  const auto select_row = select_min ? row_fn(std::true_type{}) : row_fn(std::false_type{});
+
+#pragma omp parallel for schedule(dynamic) if (batch_size > 1 && batch_size * len >= (1 << 16))
+  for (int64_t row = 0; row < int64_t(batch_size); row++) {
+    const size_t row_len = len_i != nullptr ? std::min<size_t>(len_i[row], len) : len;
+    select_row(in_val + row * len,
+               in_idx != nullptr ? in_idx + row * len : nullptr,
+               row_len,
+               k,
+               sorted,
+               out_val + row * k,
+               out_idx + row * k);
+  }
+}
+
+}  // namespace cuvs::selection::detail::host
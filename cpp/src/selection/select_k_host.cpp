@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "detail/select_k_host.hpp"
+#include <cuvs/selection/select_k.hpp>
+
+#include <raft/core/error.hpp>
+
+namespace cuvs::selection {
+
+namespace {
+
+auto host_select_algo(SelectAlgo algo, int64_t len, int64_t k) -> detail::host::select_algo
+{
+  switch (algo) {
+    case SelectAlgo::kAuto: return detail::host::choose_select_algo(len, k);
+    case SelectAlgo::kRadix8bits:
+    case SelectAlgo::kRadix11bits:
+    case SelectAlgo::kRadix11bitsExtraPass: return detail::host::select_algo::kRadix;
+    default: return detail::host::select_algo::kHeap;
+  }
+}
+
+template <typename T, typename IdxT>
+void select_k_host(
+  raft::host_matrix_view<const T, int64_t, raft::row_major> in_val,
+  std::optional<raft::host_matrix_view<const IdxT, int64_t, raft::row_major>> in_idx,
+  raft::host_matrix_view<T, int64_t, raft::row_major> out_val,
+  raft::host_matrix_view<IdxT, int64_t, raft::row_major> out_idx,
+  bool select_min,
+  bool sorted,
+  SelectAlgo algo,
+  std::optional<raft::host_vector_view<const IdxT, int64_t>> len_i)
+{
+  auto batch_size = in_val.extent(0);
+  auto len        = in_val.extent(1);
+  auto k          = out_val.extent(1);
+  RAFT_EXPECTS(batch_size == out_val.extent(0), "batch sizes must be equal");
+  RAFT_EXPECTS(batch_size == out_idx.extent(0), "batch sizes must be equal");
+  if (in_idx.has_value()) {
+    RAFT_EXPECTS(batch_size == in_idx->extent(0), "batch sizes must be equal");
+    RAFT_EXPECTS(len == in_idx->extent(1), "value and index input lengths must be equal");
+  }
+  if (len_i.has_value()) {
+    RAFT_EXPECTS(batch_size == len_i->extent(0), "batch sizes must be equal");
+  }
+  RAFT_EXPECTS(k == out_idx.extent(1), "value and index output lengths must be equal");
+
+  detail::host::select_k(in_val.data_handle(),
+                         in_idx.has_value() ? in_idx->data_handle() : nullptr,
+                         batch_size,
+                         len,
+                         k,
+                         out_val.data_handle(),
+                         out_idx.data_handle(),
+                         select_min,
+                         sorted,
+                         host_select_algo(algo, len, k),
+                         len_i.has_value() ? len_i->data_handle() : nullptr);
+}
+
+}  // namespace
+
+#define CUVS_INST_SELECT_K_HOST(T, IdxT)                                                \
+  void select_k(                                                                        \
+    raft::resources const& handle,                                                      \
+    raft::host_matrix_view<const T, int64_t, raft::row_major> in_val,                   \
+    std::optional<raft::host_matrix_view<const IdxT, int64_t, raft::row_major>> in_idx, \
+    raft::host_matrix_view<T, int64_t, raft::row_major> out_val,                        \
+    raft::host_matrix_view<IdxT, int64_t, raft::row_major> out_idx,                     \
+    bool select_min,                                                                    \
+    bool sorted,                                                                        \
+    SelectAlgo algo,                                                                    \
+    std::optional<raft::host_vector_view<const IdxT, int64_t>> len_i)                   \
+  {                                                                                     \
+    select_k_host<T, IdxT>(                                                             \
+      in_val, in_idx, out_val, out_idx, select_min, sorted, algo, len_i);               \
+  }
+
+CUVS_INST_SELECT_K_HOST(float, int64_t);
+CUVS_INST_SELECT_K_HOST(float, uint32_t);
+
+#undef CUVS_INST_SELECT_K_HOST
+
+}  // namespace cuvs::selection
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../src/core/bloom_filter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace cuvs::core {
+
+using detail::blocked_bloom_filter;
+
+struct BloomFilterInputs {
+  size_t n_lists;
+  size_t sets_per_list;
+  size_t keys_per_list;
+};
+
+::std::ostream& operator<<(::std::ostream& os, const BloomFilterInputs& p)
+{
+  os << "{" << p.n_lists << ", " << p.sets_per_list << ", " << p.keys_per_list << "}";
+  return os;
+}
+
+class BloomFilterTest : public ::testing::TestWithParam<BloomFilterInputs> {
+ protected:
+  void SetUp() override
+  {
+    ps_ = GetParam();
+    std::mt19937 rng(42);
+    keys_.resize(ps_.n_lists * ps_.keys_per_list);
+    for (auto& key : keys_) {
+      key = rng() % 1000000;
+    }
+  }
+
+  // The fraction of fresh keys reported as present, over all lists.
+  auto false_positive_rate(const blocked_bloom_filter<uint32_t>& filter) const -> double
+  {
+    size_t n_positive = 0;
+    size_t n_probes   = 0;
+    for (size_t list = 0; list < ps_.n_lists; list++) {
+      for (uint32_t key = 2000000; key < 2000000 + 200; key++) {
+        n_positive += filter.check(list, key);
+        n_probes++;
+      }
+    }
+    return double(n_positive) / double(n_probes);
+  }
+
+  BloomFilterInputs ps_;
+  std::vector<uint32_t> keys_;
+};
+
+TEST_P(BloomFilterTest, AddCheckClear)
+{
+  blocked_bloom_filter<uint32_t> filter(ps_.n_lists, ps_.sets_per_list);
+  EXPECT_EQ(false_positive_rate(filter), 0.0);
+
+#pragma omp parallel for
+  for (int64_t list = 0; list < int64_t(ps_.n_lists); list++) {
+    for (size_t j = 0; j < ps_.keys_per_list; j++) {
+      filter.add(list, keys_[list * ps_.keys_per_list + j]);
+    }
+  }
+  // No false negatives.
+  for (size_t list = 0; list < ps_.n_lists; list++) {
+    for (size_t j = 0; j < ps_.keys_per_list; j++) {
+      ASSERT_TRUE(filter.check(list, keys_[list * ps_.keys_per_list + j]))
+        << "list " << list << ", key " << j;
+      ASSERT_TRUE(filter.check_and_add(list, keys_[list * ps_.keys_per_list + j]));
+    }
+  }
+  // With 32 keys per block, 8 bits per key: below 0.1 % in theory.
+  double keys_per_set = double(ps_.keys_per_list) / double(ps_.sets_per_list);
+  if (keys_per_set <= 32) { EXPECT_LT(false_positive_rate(filter), 0.005); }
+
+  filter.clear();
+  EXPECT_EQ(false_positive_rate(filter), 0.0);
+  for (size_t list = 0; list < ps_.n_lists; list++) {
+    ASSERT_FALSE(filter.check_and_add(list, keys_[list * ps_.keys_per_list]));
+    ASSERT_TRUE(filter.check(list, keys_[list * ps_.keys_per_list]));
+  }
+}
+
+TEST_P(BloomFilterTest, ConcurrentAddsToOneList)
+{
+  blocked_bloom_filter<uint32_t> filter(ps_.n_lists, ps_.sets_per_list);
+  // All the threads add their keys to the same few lists, so they race on the same blocks.
+  const size_t n_shared = std::min<size_t>(ps_.n_lists, 2);
+#pragma omp parallel for schedule(static, 1)
+  for (int64_t i = 0; i < int64_t(keys_.size()); i++) {
+    filter.add(i % n_shared, keys_[i]);
+  }
+  for (size_t i = 0; i < keys_.size(); i++) {
+    ASSERT_TRUE(filter.check(i % n_shared, keys_[i])) << "key " << i;
+  }
+}
+
+const std::vector<BloomFilterInputs> inputs = {
+  {1, 1, 10}, {1000, 2, 64}, {10000, 1, 32}, {100, 4, 128}, {20000, 3, 40}};
+
+INSTANTIATE_TEST_CASE_P(BloomFilterTest, BloomFilterTest, ::testing::ValuesIn(inputs));
+
+/*
+ * Microbenchmark of the NN-descent sampling pattern: every list checks and adds `width` keys, then
+ * the filter is cleared. The baseline is the previous filter of NN-descent: 512-bit sets stored in
+ * a `std::vector<bool>`, three hashes, cleared bit by bit.
+ *
+ * Disabled by default; run with `--gtest_also_run_disabled_tests --gtest_filter=*Benchmark*`.
+ */
+class vector_bool_bloom_filter {
+ public:
+  vector_bool_bloom_filter(size_t n_lists, size_t sets_per_list)
+    : sets_per_list_(sets_per_list), bits_(n_lists * sets_per_list * kBitsPerSet)
+  {
+  }
+
+  auto check_and_add(size_t list_id, uint32_t key) -> bool
+  {
+    size_t set = (list_id * sets_per_list_ + key % sets_per_list_) * kBitsPerSet;
+    uint32_t h = hash_0(key);
+    bool found = true;
+    for (int i = 0; i < 3; i++) {
+      found &= bool(bits_[set + h % kBitsPerSet]);
+      bits_[set + h % kBitsPerSet] = true;
+      h += hash_1(key);
+    }
+    return found;
+  }
+
+  void clear()
+  {
+#pragma omp parallel for
+    for (int64_t i = 0; i < int64_t(bits_.size()); i++) {
+      bits_[i] = false;
+    }
+  }
+
+ private:
+  static constexpr size_t kBitsPerSet = 512;
+  size_t sets_per_list_;
+  std::vector<bool> bits_;
+
+  static auto hash_0(uint32_t v) -> uint32_t
+  {
+    v = v * 1103515245 + 12345;
+    v ^= v << 13;
+    v ^= v >> 17;
+    return v ^ (v << 5);
+  }
+  static auto hash_1(uint32_t v) -> uint32_t
+  {
+    v = v * 1664525 + 1013904223;
+    v ^= v << 13;
+    v ^= v >> 17;
+    return v ^ (v << 5);
+  }
+};
+
+// Keeps the results of the benchmark loops alive.
+volatile size_t bench_sink = 0;
+
+template <typename FilterT>
+auto bench_sampling(FilterT& filter, size_t n_lists, size_t width, int n_rounds) -> double
+{
+  auto start     = std::chrono::steady_clock::now();
+  size_t n_found = 0;
+  for (int round = 0; round < n_rounds; round++) {
+#pragma omp parallel for reduction(+ : n_found)
+    for (int64_t list = 0; list < int64_t(n_lists); list++) {
+      uint32_t key = uint32_t(list * 2654435761u + round);
+      for (size_t j = 0; j < width; j++) {
+        key = key * 1664525u + 1013904223u;
+        n_found += filter.check_and_add(list, key % 10000000);
+      }
+    }
+    filter.clear();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  bench_sink                                        = n_found;
+  return elapsed.count() / n_rounds;
+}
+
+TEST(BloomFilterBenchmark, DISABLED_NnDescentSampling)
+{
+  constexpr size_t kLists = 200000;
+  constexpr size_t kSets  = 2;
+  constexpr size_t kWidth = 64;
+  constexpr int kRounds   = 5;
+
+  blocked_bloom_filter<uint32_t> blocked(kLists, kSets);
+  vector_bool_bloom_filter baseline(kLists, kSets);
+  bench_sampling(blocked, kLists, kWidth, 1);
+  bench_sampling(baseline, kLists, kWidth, 1);
+  double blocked_ms  = bench_sampling(blocked, kLists, kWidth, kRounds);
+  double baseline_ms = bench_sampling(baseline, kLists, kWidth, kRounds);
+  std::cout << "lists: " << kLists << ", keys per list: " << kWidth
+            << ", threads: " << omp_get_max_threads() << "\n"
+            << "  blocked_bloom_filter:  " << blocked_ms << " ms per round\n"
+            << "  std::vector<bool>:     " << baseline_ms << " ms per round" << std::endl;
+}
+
+}  // namespace cuvs::core
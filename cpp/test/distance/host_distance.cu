@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../src/distance/detail/host_distance.hpp"
+#include "../../src/distance/detail/host_distance_tile.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace cuvs::distance {
+
+using detail::host::simd_isa;
+
+/** All instruction sets that can be executed on the current CPU. */
+inline auto runnable_isas() -> std::vector<simd_isa>
+{
+  auto detected = detail::host::detected_simd_isa();
+  std::vector<simd_isa> isas{simd_isa::kScalar};
+  if (detected == simd_isa::kNeon) { isas.push_back(simd_isa::kNeon); }
+  if (detected == simd_isa::kAvx2 || detected == simd_isa::kAvx512) {
+    isas.push_back(simd_isa::kAvx2);
+  }
+  if (detected == simd_isa::kAvx512) { isas.push_back(simd_isa::kAvx512); }
+  return isas;
+}
+
+template <typename DataT>
+auto random_vector(std::mt19937& rng, size_t dim) -> std::vector<DataT>
+{
+  std::vector<DataT> v(dim);
+  if constexpr (std::is_same_v<DataT, float> || std::is_same_v<DataT, half>) {
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    for (auto& x : v) {
+      x = DataT(dist(rng));
+    }
+  } else {
+    std::uniform_int_distribution<int> dist(std::numeric_limits<DataT>::min(),
+                                            std::numeric_limits<DataT>::max());
+    for (auto& x : v) {
+      x = static_cast<DataT>(dist(rng));
+    }
+  }
+  return v;
+}
+
+template <typename DataT>
+auto to_double(DataT x) -> double
+{
+  if constexpr (std::is_same_v<DataT, half>) {
+    return static_cast<double>(__half2float(x));
+  } else {
+    return static_cast<double>(x);
+  }
+}
+
+template <typename DataT>
+class HostDistanceTest : public ::testing::TestWithParam<size_t> {
+ public:
+  void run()
+  {
+    auto dim = GetParam();
+    std::mt19937 rng(1234ULL + dim);
+    auto x = random_vector<DataT>(rng, dim);
+    auto y = random_vector<DataT>(rng, dim);
+
+    // Make some of the components equal to exercise the Hamming distance.
+    for (size_t i = 0; i < dim; i += 3) {
+      y[i] = x[i];
+    }
+
+    double l2_ref      = 0;
+    double ip_ref      = 0;
+    double l1_ref      = 0;
+    double linf_ref    = 0;
+    double hamming_ref = 0;
+    double scale       = 0;
+    for (size_t i = 0; i < dim; i++) {
+      auto a = to_double(x[i]);
+      auto b = to_double(y[i]);
+      l2_ref += (a - b) * (a - b);
+      ip_ref += a * b;
+      l1_ref += std::abs(a - b);
+      linf_ref = std::max(linf_ref, std::abs(a - b));
+      hamming_ref += a != b;
+      scale += std::abs(a * b);
+    }
+    double tol = 1e-4 * (l2_ref + scale) + 1e-3;
+
+    for (auto isa : runnable_isas()) {
+      auto& kernels = detail::host::get_distance_kernels<DataT>(isa);
+      SCOPED_TRACE(detail::host::simd_isa_name(isa));
+      ASSERT_NEAR(kernels.l2(x.data(), y.data(), dim), l2_ref, tol);
+      ASSERT_NEAR(kernels.inner_product(x.data(), y.data(), dim), ip_ref, tol);
+      ASSERT_NEAR(kernels.l1(x.data(), y.data(), dim), l1_ref, 1e-4 * l1_ref + 1e-3);
+      ASSERT_NEAR(kernels.linf(x.data(), y.data(), dim), linf_ref, 1e-3);
+      ASSERT_EQ(kernels.hamming(x.data(), y.data(), dim), hamming_ref);
+    }
+  }
+};
+
+const std::vector<size_t> dims = {1, 3, 8, 15, 16, 17, 31, 32, 33, 96, 128, 257, 1000, 70001};
+
+typedef HostDistanceTest<float> HostDistanceTestF;
+TEST_P(HostDistanceTestF, Result) { this->run(); }
+INSTANTIATE_TEST_CASE_P(HostDistanceTests, HostDistanceTestF, ::testing::ValuesIn(dims));
+
+typedef HostDistanceTest<half> HostDistanceTestH;
+TEST_P(HostDistanceTestH, Result) { this->run(); }
+INSTANTIATE_TEST_CASE_P(HostDistanceTests, HostDistanceTestH, ::testing::ValuesIn(dims));
+
+typedef HostDistanceTest<int8_t> HostDistanceTestI8;
+TEST_P(HostDistanceTestI8, Result) { this->run(); }
+INSTANTIATE_TEST_CASE_P(HostDistanceTests, HostDistanceTestI8, ::testing::ValuesIn(dims));
+
+typedef HostDistanceTest<uint8_t> HostDistanceTestU8;
+TEST_P(HostDistanceTestU8, Result) { this->run(); }
+INSTANTIATE_TEST_CASE_P(HostDistanceTests, HostDistanceTestU8, ::testing::ValuesIn(dims));
+
+class HostDistanceTileTest : public ::testing::TestWithParam<size_t> {
+ public:
+  void run()
+  {
+    auto dim = GetParam();
+    std::mt19937 rng(4321ULL + dim);
+    // Tile sizes covering whole register blocks, edges, and single rows.
+    for (size_t n_x : {1, 3, 4, 13}) {
+      for (size_t n_y : {1, 4, 7, 21}) {
+        std::vector<float> x, y;
+        for (size_t i = 0; i < n_x; i++) {
+          auto v = random_vector<float>(rng, dim);
+          x.insert(x.end(), v.begin(), v.end());
+        }
+        for (size_t j = 0; j < n_y; j++) {
+          auto v = random_vector<float>(rng, dim);
+          y.insert(y.end(), v.begin(), v.end());
+        }
+        // A leading dimension larger than the tile, with a sentinel in the padding.
+        size_t ld_out = n_y + 2;
+        for (auto isa : runnable_isas()) {
+          SCOPED_TRACE(detail::host::simd_isa_name(isa));
+          std::vector<float> out(n_x * ld_out, -1.0f);
+          detail::host::get_inner_product_tile_kernel(isa)(
+            x.data(), n_x, y.data(), n_y, dim, out.data(), ld_out);
+          for (size_t i = 0; i < n_x; i++) {
+            for (size_t j = 0; j < n_y; j++) {
+              double ref   = 0;
+              double scale = 0;
+              for (size_t l = 0; l < dim; l++) {
+                ref += double(x[i * dim + l]) * double(y[j * dim + l]);
+                scale += std::abs(double(x[i * dim + l]) * double(y[j * dim + l]));
+              }
+              ASSERT_NEAR(out[i * ld_out + j], ref, 1e-4 * scale + 1e-3)
+                << "n_x = " << n_x << ", n_y = " << n_y << ", i = " << i << ", j = " << j;
+            }
+            for (size_t j = n_y; j < ld_out; j++) {
+              ASSERT_EQ(out[i * ld_out + j], -1.0f);
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+TEST_P(HostDistanceTileTest, Result) { this->run(); }
+INSTANTIATE_TEST_CASE_P(HostDistanceTests,
+                        HostDistanceTileTest,
+                        ::testing::Values(1, 3, 8, 15, 16, 17, 33, 128, 257));
+
+}  // namespace cuvs::distance
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include "../../src/neighbors/detail/cagra/utils.hpp"
+#include "../../src/neighbors/detail/dataset_serialize.hpp"
 #include "../test_utils.cuh"
 #include "ann_utils.cuh"
 #include <raft/core/resource/cuda_stream.hpp>
@@ -28,6 +30,7 @@
 #include <raft/core/host_mdarray.hpp>
 #include <raft/core/host_mdspan.hpp>
 #include <raft/core/logger.hpp>
+#include <raft/core/serialize.hpp>
 #include <raft/linalg/add.cuh>
 #include <raft/random/rng.cuh>
 #include <raft/util/itertools.hpp>
@@ -38,9 +41,14 @@
 
 #include <thrust/sequence.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -108,6 +116,159 @@ testing::AssertionResult CheckOrder(raft::host_matrix_view<IdxT, int64_t> index_
   return testing::AssertionSuccess();
 }
 
+// Check the structure of an index exported in the hnswlib format: the header, the levels of the
+// nodes and the links of every level, which must stay within the level.
+template <typename DataT>
+testing::AssertionResult CheckHnswlibHierarchy(const std::string& hnswlib,
+                                               size_t n_rows,
+                                               uint32_t dim,
+                                               uint32_t graph_degree)
+{
+  std::istringstream is(hnswlib);
+  auto get = [&is](auto& value) { is.read(reinterpret_cast<char*>(&value), sizeof(value)); };
+  size_t offset_level_0, max_element, curr_element_count, size_data_per_element;
+  size_t label_offset, offset_data, max_M, max_M0, M, ef_construction;
+  int max_level, entry_point;
+  double mult;
+  get(offset_level_0);
+  get(max_element);
+  get(curr_element_count);
+  get(size_data_per_element);
+  get(label_offset);
+  get(offset_data);
+  get(max_level);
+  get(entry_point);
+  get(max_M);
+  get(max_M0);
+  get(M);
+  get(mult);
+  get(ef_construction);
+  if (!is) { return testing::AssertionFailure() << "Truncated header"; }
+  if (curr_element_count != n_rows || max_M0 != graph_degree || max_M != M || M == 0 ||
+      size_data_per_element != sizeof(uint32_t) * (1 + max_M0) + dim * sizeof(DataT) +
+                                 sizeof(size_t)) {
+    return testing::AssertionFailure() << "Unexpected header: " << curr_element_count
+                                       << " elements, max_M0 = " << max_M0
+                                       << ", max_M = " << max_M << ", M = " << M;
+  }
+  if (max_level < 0 || entry_point < 0 || size_t(entry_point) >= n_rows) {
+    return testing::AssertionFailure()
+           << "Invalid max_level " << max_level << " or entry point " << entry_point;
+  }
+
+  // Level 0: a link count of at most max_M0, then max_M0 link slots, the vector and the label.
+  std::vector<char> record(size_data_per_element);
+  for (size_t i = 0; i < n_rows; i++) {
+    is.read(record.data(), record.size());
+    if (!is) { return testing::AssertionFailure() << "Truncated level 0 at node " << i; }
+    uint32_t count;
+    size_t label;
+    std::memcpy(&count, record.data(), sizeof(count));
+    std::memcpy(&label, record.data() + label_offset, sizeof(label));
+    if (count > max_M0 || label != i) {
+      return testing::AssertionFailure()
+             << "Node " << i << ": " << count << " links on level 0, label " << label;
+    }
+    for (uint32_t j = 0; j < count; j++) {
+      uint32_t id;
+      std::memcpy(&id, record.data() + sizeof(uint32_t) * (1 + j), sizeof(id));
+      if (id >= n_rows) {
+        return testing::AssertionFailure() << "Node " << i << ": invalid link " << id;
+      }
+    }
+  }
+
+  // The upper levels of every node: their size in bytes, then per level a link count of at most
+  // max_M and max_M link slots.
+  const size_t level_bytes = sizeof(uint32_t) * (1 + max_M);
+  std::vector<int> levels(n_rows, 0);
+  std::vector<std::vector<uint32_t>> links(n_rows);
+  for (size_t i = 0; i < n_rows; i++) {
+    uint32_t bytes;
+    get(bytes);
+    if (!is || bytes % level_bytes != 0) {
+      return testing::AssertionFailure() << "Invalid upper levels of node " << i;
+    }
+    levels[i] = bytes / level_bytes;
+    links[i].resize(bytes / sizeof(uint32_t));
+    is.read(reinterpret_cast<char*>(links[i].data()), bytes);
+    if (!is) { return testing::AssertionFailure() << "Truncated upper levels of node " << i; }
+  }
+  if (is.peek() != std::char_traits<char>::eof()) {
+    return testing::AssertionFailure() << "Trailing bytes after the upper levels";
+  }
+
+  if (*std::max_element(levels.begin(), levels.end()) != max_level) {
+    return testing::AssertionFailure() << "The header max_level " << max_level
+                                       << " is not the top level of the nodes";
+  }
+  if (levels[entry_point] != max_level) {
+    return testing::AssertionFailure() << "The entry point " << entry_point << " is on level "
+                                       << levels[entry_point] << ", not on the top level";
+  }
+  for (size_t i = 0; i < n_rows; i++) {
+    for (int l = 1; l <= levels[i]; l++) {
+      const uint32_t* level_links = links[i].data() + (l - 1) * (1 + max_M);
+      if (level_links[0] > max_M) {
+        return testing::AssertionFailure()
+               << "Node " << i << ": " << level_links[0] << " links on level " << l;
+      }
+      for (uint32_t j = 1; j <= level_links[0]; j++) {
+        const uint32_t id = level_links[j];
+        if (id >= n_rows || id == i || levels[id] < l) {
+          return testing::AssertionFailure()
+                 << "Node " << i << ": link " << id << " on level " << l << " is not a node of "
+                 << "the level";
+        }
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+// Write an index in the flat format of version 4, the last one before the container. The dataset,
+// if included, must be a strided one.
+template <typename DataT, typename IdxT>
+void SerializeLegacy(raft::resources const& res,
+                     std::ostream& os,
+                     const index<DataT, IdxT>& index_,
+                     bool include_dataset)
+{
+  std::string dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<DataT>().to_string();
+  dtype_string.resize(4);
+  os << dtype_string;
+
+  raft::serialize_scalar(res, os, int{4});
+  raft::serialize_scalar(res, os, index_.size());
+  raft::serialize_scalar(res, os, index_.dim());
+  raft::serialize_scalar(res, os, index_.graph_degree());
+  raft::serialize_scalar(res, os, index_.metric());
+
+  raft::serialize_mdspan(res, os, index_.graph());
+
+  include_dataset &= (index_.data().n_rows() > 0);
+  raft::serialize_scalar(res, os, include_dataset);
+  if (!include_dataset) { return; }
+  auto dataset = index_.dataset();
+  raft::serialize_scalar(res, os, cuvs::neighbors::detail::kSerializeStridedDataset);
+  raft::serialize_scalar(res, os, detail::utils::get_cuda_data_type<DataT>());
+  raft::serialize_scalar(res, os, dataset.extent(0));
+  raft::serialize_scalar(res, os, static_cast<uint32_t>(dataset.extent(1)));
+  raft::serialize_scalar(res, os, static_cast<uint32_t>(dataset.stride(0)));
+  // The rows are written without their padding.
+  auto dataset_host = raft::make_host_matrix<DataT, int64_t>(dataset.extent(0), dataset.extent(1));
+  RAFT_CUDA_TRY(cudaMemcpy2DAsync(dataset_host.data_handle(),
+                                  sizeof(DataT) * dataset.extent(1),
+                                  dataset.data_handle(),
+                                  sizeof(DataT) * dataset.stride(0),
+                                  sizeof(DataT) * dataset.extent(1),
+                                  dataset.extent(0),
+                                  cudaMemcpyDefault,
+                                  raft::resource::get_cuda_stream(res)));
+  raft::resource::sync_stream(res);
+  raft::serialize_mdspan(res, os, dataset_host.view());
+}
+
 // Generate dataset to ensure no rounding error occurs in the norm computation of any two vectors.
 // When testing the CAGRA index sorting function, rounding errors can affect the norm and alter the
 // order of the index. To ensure the accuracy of the test, we utilize the dataset. The generation
@@ -371,6 +532,532 @@ class AnnCagraTest : public ::testing::TestWithParam<AnnCagraInputs> {
   rmm::device_uvector<DataT> search_queries;
 };
 
+/** Parameters of the tests of the host-side features, run on an index built on the device. */
+struct AnnCagraHostInputs {
+  int n_queries;
+  int n_rows;
+  int dim;
+  int k;
+  cuvs::distance::DistanceType metric;
+  bool include_serialized_dataset;
+  double min_recall;
+  std::optional<vpq_params> compression = std::nullopt;
+};
+
+inline ::std::ostream& operator<<(::std::ostream& os, const AnnCagraHostInputs& p)
+{
+  os << "{n_queries=" << p.n_queries << ", dataset shape=" << p.n_rows << "x" << p.dim
+     << ", k=" << p.k << ", metric=" << static_cast<int>(p.metric)
+     << (p.include_serialized_dataset ? ", with dataset" : ", without dataset");
+  if (p.compression.has_value()) {
+    os << ", pq_dim=" << p.compression->pq_dim << ", vq_n_centers=" << p.compression->vq_n_centers;
+  }
+  os << '}' << std::endl;
+  return os;
+}
+
+/**
+ * The dataset and the queries, on the device and on the host, the exact neighbors of the queries
+ * and an index of the dataset built on the device: the common part of the tests of the host-side
+ * features, each of which derives its own fixture.
+ */
+template <typename DistanceT, typename DataT, typename IdxT>
+class AnnCagraHostTest : public ::testing::TestWithParam<AnnCagraHostInputs> {
+ public:
+  AnnCagraHostTest()
+    : stream_(raft::resource::get_cuda_stream(handle_)),
+      ps(::testing::TestWithParam<AnnCagraHostInputs>::GetParam()),
+      database(0, stream_),
+      search_queries(0, stream_),
+      database_host(raft::make_host_matrix<DataT, int64_t>(ps.n_rows, ps.dim)),
+      queries_host(raft::make_host_matrix<DataT, int64_t>(ps.n_queries, ps.dim)),
+      index(handle_)
+  {
+  }
+
+ protected:
+  void SetUp() override
+  {
+    database.resize(((size_t)ps.n_rows) * ps.dim, stream_);
+    search_queries.resize(ps.n_queries * ps.dim, stream_);
+    raft::random::RngState r(1234ULL);
+    if constexpr (std::is_same<DataT, float>{}) {
+      raft::random::normal(handle_, r, database.data(), ps.n_rows * ps.dim, DataT(0.1), DataT(2.0));
+      raft::random::normal(
+        handle_, r, search_queries.data(), ps.n_queries * ps.dim, DataT(0.1), DataT(2.0));
+    } else {
+      raft::random::uniformInt(
+        handle_, r, database.data(), ps.n_rows * ps.dim, DataT(1), DataT(20));
+      raft::random::uniformInt(
+        handle_, r, search_queries.data(), ps.n_queries * ps.dim, DataT(1), DataT(20));
+    }
+    raft::copy(database_host.data_handle(), database.data(), database.size(), stream_);
+    raft::copy(
+      queries_host.data_handle(), search_queries.data(), search_queries.size(), stream_);
+
+    const size_t queries_size = size_t(ps.n_queries) * ps.k;
+    rmm::device_uvector<DistanceT> distances_naive_dev(queries_size, stream_);
+    rmm::device_uvector<IdxT> indices_naive_dev(queries_size, stream_);
+    cuvs::neighbors::naive_knn<DistanceT, DataT, IdxT>(handle_,
+                                                       distances_naive_dev.data(),
+                                                       indices_naive_dev.data(),
+                                                       search_queries.data(),
+                                                       database.data(),
+                                                       ps.n_queries,
+                                                       ps.n_rows,
+                                                       ps.dim,
+                                                       ps.k,
+                                                       ps.metric);
+    distances_naive.resize(queries_size);
+    indices_naive.resize(queries_size);
+    raft::update_host(distances_naive.data(), distances_naive_dev.data(), queries_size, stream_);
+    raft::update_host(indices_naive.data(), indices_naive_dev.data(), queries_size, stream_);
+    raft::resource::sync_stream(handle_);
+
+    cagra::index_params index_params;
+    index_params.metric      = ps.metric;
+    index_params.compression = ps.compression;
+    index = cagra::build(handle_, index_params, database_view());
+  }
+
+  void TearDown() override
+  {
+    raft::resource::sync_stream(handle_);
+    database.resize(0, stream_);
+    search_queries.resize(0, stream_);
+  }
+
+  auto database_view() const
+  {
+    return raft::make_device_matrix_view<const DataT, int64_t>(database.data(), ps.n_rows, ps.dim);
+  }
+
+  /** The graph of the index, copied to the host. */
+  auto graph_host() -> raft::host_matrix<IdxT, int64_t>
+  {
+    auto graph = raft::make_host_matrix<IdxT, int64_t>(index.size(), index.graph_degree());
+    raft::copy(graph.data_handle(), index.graph().data_handle(), index.graph().size(), stream_);
+    raft::resource::sync_stream(handle_);
+    return graph;
+  }
+
+  /** The exact kNN graph of the first `n_rows` rows of the dataset, without the self edges. */
+  auto exact_knn_graph(int64_t n_rows, int64_t degree) -> raft::host_matrix<IdxT, int64_t>
+  {
+    const size_t knn_size = size_t(n_rows) * (degree + 1);
+    rmm::device_uvector<DistanceT> knn_distances_dev(knn_size, stream_);
+    rmm::device_uvector<IdxT> knn_indices_dev(knn_size, stream_);
+    cuvs::neighbors::naive_knn<DistanceT, DataT, IdxT>(handle_,
+                                                       knn_distances_dev.data(),
+                                                       knn_indices_dev.data(),
+                                                       database.data(),
+                                                       database.data(),
+                                                       n_rows,
+                                                       n_rows,
+                                                       ps.dim,
+                                                       degree + 1,
+                                                       ps.metric);
+    std::vector<IdxT> knn_with_self(knn_size);
+    raft::update_host(knn_with_self.data(), knn_indices_dev.data(), knn_size, stream_);
+    raft::resource::sync_stream(handle_);
+    auto knn_graph = raft::make_host_matrix<IdxT, int64_t>(n_rows, degree);
+    for (int64_t i = 0; i < n_rows; i++) {
+      int64_t k = 0;
+      for (int64_t j = 0; j <= degree && k < degree; j++) {
+        const IdxT id = knn_with_self[i * (degree + 1) + j];
+        if (id != IdxT(i)) { knn_graph(i, k++) = id; }
+      }
+    }
+    return knn_graph;
+  }
+
+  /** Search an index on the device. */
+  void search_device(const cagra::index<DataT, IdxT>& idx,
+                     std::vector<IdxT>& indices,
+                     std::vector<DistanceT>& distances)
+  {
+    const size_t queries_size = size_t(ps.n_queries) * ps.k;
+    rmm::device_uvector<DistanceT> distances_dev(queries_size, stream_);
+    rmm::device_uvector<IdxT> indices_dev(queries_size, stream_);
+    cagra::search(
+      handle_,
+      search_params,
+      idx,
+      raft::make_device_matrix_view<const DataT, int64_t>(
+        search_queries.data(), ps.n_queries, ps.dim),
+      raft::make_device_matrix_view<IdxT, int64_t>(indices_dev.data(), ps.n_queries, ps.k),
+      raft::make_device_matrix_view<DistanceT, int64_t>(distances_dev.data(), ps.n_queries, ps.k));
+    indices.resize(queries_size);
+    distances.resize(queries_size);
+    raft::update_host(distances.data(), distances_dev.data(), queries_size, stream_);
+    raft::update_host(indices.data(), indices_dev.data(), queries_size, stream_);
+    raft::resource::sync_stream(handle_);
+  }
+
+  /** Search a graph of a dataset on the host. */
+  void search_host(raft::host_matrix_view<const DataT, int64_t> dataset,
+                   raft::host_matrix_view<const IdxT, int64_t> graph,
+                   std::vector<IdxT>& indices,
+                   std::vector<DistanceT>& distances)
+  {
+    indices.resize(size_t(ps.n_queries) * ps.k);
+    distances.resize(size_t(ps.n_queries) * ps.k);
+    cagra::search(
+      handle_,
+      search_params,
+      ps.metric,
+      dataset,
+      graph,
+      raft::make_const_mdspan(queries_host.view()),
+      raft::make_host_matrix_view<IdxT, int64_t>(indices.data(), ps.n_queries, ps.k),
+      raft::make_host_matrix_view<DistanceT, int64_t>(distances.data(), ps.n_queries, ps.k));
+  }
+
+  auto check_recall(const std::vector<IdxT>& indices,
+                    const std::vector<DistanceT>& distances,
+                    double min_recall)
+  {
+    return eval_neighbours(indices_naive,
+                           indices,
+                           distances_naive,
+                           distances,
+                           ps.n_queries,
+                           ps.k,
+                           0.003,
+                           min_recall);
+  }
+
+  raft::resources handle_;
+  rmm::cuda_stream_view stream_;
+  AnnCagraHostInputs ps;
+  rmm::device_uvector<DataT> database;
+  rmm::device_uvector<DataT> search_queries;
+  raft::host_matrix<DataT, int64_t> database_host;
+  raft::host_matrix<DataT, int64_t> queries_host;
+  std::vector<IdxT> indices_naive;
+  std::vector<DistanceT> distances_naive;
+  cagra::search_params search_params;
+  cagra::index<DataT, IdxT> index;
+};
+
+/** The compressed serialization and the loading of the legacy flat format. */
+template <typename DistanceT, typename DataT, typename IdxT>
+class AnnCagraSerializeTest : public AnnCagraHostTest<DistanceT, DataT, IdxT> {
+ protected:
+  void testSerialize()
+  {
+    auto& ps = this->ps;
+    // A compressed serialization (the graph rows delta-coded, the dataset byte-shuffled) loads
+    // back to the same index.
+    std::string plain;
+    std::string compressed;
+    cagra::serialize(this->handle_, plain, this->index, ps.include_serialized_dataset);
+    cagra::serialize(this->handle_,
+                     compressed,
+                     this->index,
+                     ps.include_serialized_dataset,
+                     serialize_compression::LOSSLESS);
+    ASSERT_NE(compressed, plain);
+    cagra::index<DataT, IdxT> decompressed(this->handle_);
+    cagra::deserialize(this->handle_, compressed, &decompressed);
+    ASSERT_EQ(decompressed.size(), this->index.size());
+    ASSERT_EQ(decompressed.graph_degree(), this->index.graph_degree());
+    std::string roundtrip;
+    cagra::serialize(this->handle_, roundtrip, decompressed, ps.include_serialized_dataset);
+    ASSERT_TRUE(roundtrip == plain);
+
+    if (!ps.compression.has_value()) {
+      // An index in the flat format of version 4 loads through the container reader.
+      std::ostringstream legacy;
+      SerializeLegacy(this->handle_, legacy, this->index, ps.include_serialized_dataset);
+      cagra::index<DataT, IdxT> legacy_index(this->handle_);
+      cagra::deserialize(this->handle_, legacy.str(), &legacy_index);
+      if (!ps.include_serialized_dataset) {
+        legacy_index.update_dataset(this->handle_, this->database_view());
+      }
+      std::string legacy_roundtrip;
+      cagra::serialize(
+        this->handle_, legacy_roundtrip, legacy_index, ps.include_serialized_dataset);
+      ASSERT_TRUE(legacy_roundtrip == plain);
+    }
+  }
+};
+
+/** The memory-mapped index format, and the host search of the mapped graph and dataset. */
+template <typename DistanceT, typename DataT, typename IdxT>
+class AnnCagraMappedTest : public AnnCagraHostTest<DistanceT, DataT, IdxT> {
+ protected:
+  void testMapped()
+  {
+    auto& ps    = this->ps;
+    auto& index = this->index;
+    // Map the index from a file and search it on the host: the mapped graph and dataset must
+    // match the index, and the host search should reach the same recall.
+    const std::string filename = make_temp_file("cagra_index_mapped");
+    cagra::serialize_mapped_file(this->handle_, filename, index);
+    cagra::mapped_index<DataT, IdxT> mapped;
+    cagra::deserialize_mapped_file(this->handle_, filename, &mapped);
+    std::remove(filename.c_str());
+    ASSERT_EQ(mapped.size(), index.size());
+    ASSERT_EQ(mapped.graph_degree(), index.graph_degree());
+    ASSERT_TRUE(mapped.has_dataset());
+    ASSERT_EQ(mapped.metric(), index.metric());
+
+    auto graph_host = this->graph_host();
+    ASSERT_TRUE(std::equal(graph_host.data_handle(),
+                           graph_host.data_handle() + graph_host.size(),
+                           mapped.graph().data_handle()));
+    ASSERT_TRUE(std::equal(this->database_host.data_handle(),
+                           this->database_host.data_handle() + this->database_host.size(),
+                           mapped.dataset().data_handle()));
+
+    std::vector<IdxT> indices_host;
+    std::vector<DistanceT> distances_host;
+    this->search_host(mapped.dataset(), mapped.graph(), indices_host, distances_host);
+    EXPECT_TRUE(this->check_recall(indices_host, distances_host, ps.min_recall));
+  }
+};
+
+/** The filtered host search. */
+template <typename DistanceT, typename DataT, typename IdxT>
+class AnnCagraFilteredHostTest : public AnnCagraHostTest<DistanceT, DataT, IdxT> {
+ protected:
+  void testFilteredSearch()
+  {
+    auto& ps           = this->ps;
+    auto& dataset      = this->database_host;
+    auto& queries_host = this->queries_host;
+    auto graph         = this->graph_host();
+    std::vector<IdxT> indices_host(size_t(ps.n_queries) * ps.k);
+    std::vector<DistanceT> distances_host(size_t(ps.n_queries) * ps.k);
+
+    // With a few admitted rows, they are scanned exactly; with half of the rows admitted, the
+    // graph is searched and only admitted rows are returned.
+    const bool ip = ps.metric == cuvs::distance::DistanceType::InnerProduct;
+    auto exact    = [&](int64_t q, int64_t row) {
+      double d = 0;
+      for (int64_t l = 0; l < ps.dim; l++) {
+        double a = static_cast<double>(queries_host(q, l));
+        double b = static_cast<double>(dataset(row, l));
+        d += ip ? a * b : (a - b) * (a - b);
+      }
+      return d;
+    };
+    std::vector<uint32_t> bits(raft::ceildiv<int64_t>(ps.n_rows, 32), 0);
+    auto search_filtered = [&]() {
+      cagra::search_with_filtering(
+        this->handle_,
+        this->search_params,
+        ps.metric,
+        raft::make_const_mdspan(dataset.view()),
+        raft::make_const_mdspan(graph.view()),
+        raft::make_const_mdspan(queries_host.view()),
+        raft::make_host_matrix_view<IdxT, int64_t>(indices_host.data(), ps.n_queries, ps.k),
+        raft::make_host_matrix_view<DistanceT, int64_t>(
+          distances_host.data(), ps.n_queries, ps.k),
+        cuvs::neighbors::filtering::bitset_filter(
+          cuvs::core::bitset_view<uint32_t, int64_t>(bits.data(), ps.n_rows)));
+    };
+    auto admitted = [&](IdxT row) { return (bits[row / 32] >> (row % 32)) & 1u; };
+
+    std::vector<int64_t> rows;
+    for (int64_t row = 0; row < ps.n_rows && int64_t(rows.size()) < 2 * ps.k;
+         row += std::max<int64_t>(1, ps.n_rows / (2 * ps.k))) {
+      bits[row / 32] |= 1u << (row % 32);
+      rows.push_back(row);
+    }
+    search_filtered();
+    std::vector<double> expected(rows.size());
+    for (int64_t q = 0; q < ps.n_queries; q++) {
+      for (size_t r = 0; r < rows.size(); r++) {
+        expected[r] = exact(q, rows[r]);
+      }
+      std::sort(expected.begin(), expected.end());
+      if (ip) { std::reverse(expected.begin(), expected.end()); }
+      for (int64_t j = 0; j < ps.k; j++) {
+        IdxT id = indices_host[q * ps.k + j];
+        ASSERT_LT(id, ps.n_rows);
+        ASSERT_TRUE(admitted(id));
+        double tol = 1e-3 * (1.0 + std::abs(expected[j]));
+        ASSERT_NEAR(distances_host[q * ps.k + j], expected[j], tol);
+      }
+    }
+
+    for (int64_t row = 0; row < ps.n_rows; row++) {
+      if (row % 2) {
+        bits[row / 32] |= 1u << (row % 32);
+      } else {
+        bits[row / 32] &= ~(1u << (row % 32));
+      }
+    }
+    search_filtered();
+    for (size_t j = 0; j < indices_host.size(); j++) {
+      ASSERT_LT(indices_host[j], ps.n_rows);
+      ASSERT_TRUE(admitted(indices_host[j]));
+    }
+  }
+};
+
+/** The hnswlib export, from the device and from a mapped file, and its import. */
+template <typename DistanceT, typename DataT, typename IdxT>
+class AnnCagraHnswlibTest : public AnnCagraHostTest<DistanceT, DataT, IdxT> {
+ protected:
+  void testHnswlib()
+  {
+    auto& ps    = this->ps;
+    auto& index = this->index;
+
+    const std::string filename = make_temp_file("cagra_index_mapped");
+    cagra::serialize_mapped_file(this->handle_, filename, index);
+    cagra::mapped_index<DataT, IdxT> mapped;
+    cagra::deserialize_mapped_file(this->handle_, filename, &mapped);
+    std::remove(filename.c_str());
+
+    // The hnswlib export streamed from the device and the one from the mapped file must be
+    // identical.
+    std::string hnswlib_device;
+    std::string hnswlib_mapped;
+    cagra::serialize_to_hnswlib(this->handle_, hnswlib_device, index);
+    cagra::serialize_to_hnswlib(this->handle_, hnswlib_mapped, mapped);
+    ASSERT_EQ(hnswlib_device, hnswlib_mapped);
+    ASSERT_TRUE(CheckHnswlibHierarchy<DataT>(
+      hnswlib_device, index.size(), index.dim(), index.graph_degree()));
+
+    // Importing the hnswlib export gives back a searchable CAGRA index. A graph degree below the
+    // hnswlib level-0 degree prunes the imported lists as `optimize` does, one above it pads them
+    // with the neighbors of the neighbors.
+    for (uint32_t import_degree :
+         {index.graph_degree() / 2, index.graph_degree(), 2 * index.graph_degree()}) {
+      if (import_degree >= index.size()) { continue; }
+      cagra::index_params import_params;
+      import_params.metric       = index.metric();
+      import_params.graph_degree = import_degree;
+      cagra::index<DataT, IdxT> imported(this->handle_);
+      cagra::deserialize_from_hnswlib(this->handle_, hnswlib_device, import_params, &imported);
+      ASSERT_EQ(imported.size(), index.size());
+      ASSERT_EQ(imported.dim(), index.dim());
+      ASSERT_EQ(imported.graph_degree(), import_degree);
+
+      auto imported_graph = raft::make_host_matrix<IdxT, int64_t>(imported.size(), import_degree);
+      raft::copy(imported_graph.data_handle(),
+                 imported.graph().data_handle(),
+                 imported.graph().size(),
+                 this->stream_);
+      raft::resource::sync_stream(this->handle_);
+      for (int64_t i = 0; i < int64_t(imported.size()); i++) {
+        std::vector<IdxT> row(imported_graph.data_handle() + i * import_degree,
+                              imported_graph.data_handle() + (i + 1) * import_degree);
+        ASSERT_TRUE(std::all_of(row.begin(), row.end(), [&](IdxT j) {
+          return j < imported.size() && int64_t(j) != i;
+        })) << "Invalid link in row " << i << " of the graph of degree " << import_degree;
+        if (import_degree > index.graph_degree()) {
+          // The padded rows list distinct nodes.
+          std::sort(row.begin(), row.end());
+          ASSERT_TRUE(std::adjacent_find(row.begin(), row.end()) == row.end())
+            << "Duplicate link in row " << i << " of the padded graph";
+        }
+      }
+
+      std::vector<IdxT> indices_imported;
+      std::vector<DistanceT> distances_imported;
+      this->search_device(imported, indices_imported, distances_imported);
+      // The pruned graph has half the edges, allow it a slightly lower recall.
+      EXPECT_TRUE(this->check_recall(
+        indices_imported,
+        distances_imported,
+        import_degree < index.graph_degree() ? ps.min_recall - 0.01 : ps.min_recall))
+        << "hnswlib import with graph degree " << import_degree;
+    }
+  }
+};
+
+/** The optimization of a kNN graph on the host. */
+template <typename DistanceT, typename DataT, typename IdxT>
+class AnnCagraOptimizeHostTest : public AnnCagraHostTest<DistanceT, DataT, IdxT> {
+ protected:
+  void testOptimizeHost()
+  {
+    auto& ps = this->ps;
+    // Optimize an exact kNN graph of the dataset on the host (no GPU involved): searching the
+    // resulting graph should reach the recall of the index.
+    const int64_t graph_degree = this->index.graph_degree();
+    auto knn_graph             = this->exact_knn_graph(ps.n_rows, 2 * graph_degree);
+    auto graph                 = raft::make_host_matrix<IdxT, int64_t>(ps.n_rows, graph_degree);
+    cagra::optimize_host(this->handle_, raft::make_const_mdspan(knn_graph.view()), graph.view());
+    for (size_t i = 0; i < graph.size(); i++) {
+      ASSERT_LT(graph.data_handle()[i], IdxT(ps.n_rows));
+    }
+
+    std::vector<IdxT> indices_host;
+    std::vector<DistanceT> distances_host;
+    this->search_host(raft::make_const_mdspan(this->database_host.view()),
+                      raft::make_const_mdspan(graph.view()),
+                      indices_host,
+                      distances_host);
+    EXPECT_TRUE(this->check_recall(indices_host, distances_host, ps.min_recall));
+  }
+};
+
+/** The incremental extend of a graph on the host. */
+template <typename DistanceT, typename DataT, typename IdxT>
+class AnnCagraExtendHostTest : public AnnCagraHostTest<DistanceT, DataT, IdxT> {
+ protected:
+  void testExtendHost()
+  {
+    auto& ps                   = this->ps;
+    const int64_t graph_degree = this->index.graph_degree();
+    const int64_t knn_degree   = 2 * graph_degree;
+    auto dataset               = raft::make_const_mdspan(this->database_host.view());
+    std::vector<IdxT> indices_host;
+    std::vector<DistanceT> distances_host;
+
+    // The recall of the graph optimized from the exact kNN graph of all the rows.
+    auto graph     = raft::make_host_matrix<IdxT, int64_t>(ps.n_rows, graph_degree);
+    auto knn_graph = this->exact_knn_graph(ps.n_rows, knn_degree);
+    cagra::optimize_host(this->handle_, raft::make_const_mdspan(knn_graph.view()), graph.view());
+    this->search_host(dataset, raft::make_const_mdspan(graph.view()), indices_host, distances_host);
+    const double rebuild_recall = std::get<0>(calc_recall(this->indices_naive,
+                                                          indices_host,
+                                                          this->distances_naive,
+                                                          distances_host,
+                                                          ps.n_queries,
+                                                          ps.k,
+                                                          0.003));
+
+    // Build the graph of the first 90% of the rows the same way and extend it with the others:
+    // the recall should be about the one of the full rebuild.
+    const int64_t n_old_rows = ps.n_rows - ps.n_rows / 10;
+    ASSERT_GT(n_old_rows, knn_degree);
+    auto old_knn_graph = this->exact_knn_graph(n_old_rows, knn_degree);
+    auto old_graph     = raft::make_host_matrix<IdxT, int64_t>(n_old_rows, graph_degree);
+    cagra::optimize_host(
+      this->handle_, raft::make_const_mdspan(old_knn_graph.view()), old_graph.view());
+
+    cagra::extend_params extend_params;
+    cagra::extend(this->handle_,
+                  extend_params,
+                  ps.metric,
+                  dataset,
+                  raft::make_const_mdspan(old_graph.view()),
+                  graph.view());
+    std::vector<uint32_t> in_degree(ps.n_rows, 0);
+    for (int64_t i = 0; i < ps.n_rows; i++) {
+      for (int64_t j = 0; j < graph_degree; j++) {
+        ASSERT_LT(graph(i, j), IdxT(ps.n_rows));
+        ASSERT_NE(graph(i, j), IdxT(i));
+        in_degree[graph(i, j)]++;
+      }
+    }
+    // Every new node is reachable from the rest of the graph.
+    for (int64_t i = n_old_rows; i < ps.n_rows; i++) {
+      ASSERT_GT(in_degree[i], 0u) << "new node " << i << " has no incoming edge";
+    }
+
+    this->search_host(dataset, raft::make_const_mdspan(graph.view()), indices_host, distances_host);
+    EXPECT_TRUE(this->check_recall(indices_host, distances_host, rebuild_recall - 0.01));
+  }
+};
+
 inline std::vector<AnnCagraInputs> generate_inputs()
 {
   // TODO(tfeher): test MULTI_CTA kernel with search_width > 1 to allow multiple CTA per queries
@@ -509,4 +1196,59 @@ inline std::vector<AnnCagraInputs> generate_inputs()
 
 const std::vector<AnnCagraInputs> inputs = generate_inputs();
 
+inline std::vector<AnnCagraHostInputs> generate_serialize_inputs()
+{
+  auto inputs = raft::util::itertools::product<AnnCagraHostInputs>(
+    {100},
+    {1000},
+    {8, 64},  // dim
+    {16},     // k
+    {cuvs::distance::DistanceType::L2Expanded},
+    {false, true},
+    {0.995});
+  // The compressed dataset of CAGRA-Q.
+  auto inputs_vpq =
+    raft::util::itertools::product<AnnCagraHostInputs>({100},
+                                                       {10000},
+                                                       {64, 128},  // dim
+                                                       {16},       // k
+                                                       {cuvs::distance::DistanceType::L2Expanded},
+                                                       {true},
+                                                       {0.6});
+  for (auto input : inputs_vpq) {
+    vpq_params vpq{};
+    vpq.pq_dim       = input.dim / 2;
+    vpq.vq_n_centers = 100;
+    input.compression.emplace(vpq);
+    inputs.push_back(input);
+  }
+  return inputs;
+}
+
+const std::vector<AnnCagraHostInputs> inputs_serialize = generate_serialize_inputs();
+
+/** The inputs of the host-side features, at the given dimensions and k, plus a larger dataset. */
+inline std::vector<AnnCagraHostInputs> generate_host_inputs(std::initializer_list<int> dims,
+                                                            std::initializer_list<int> ks)
+{
+  auto inputs = raft::util::itertools::product<AnnCagraHostInputs>(
+    {100}, {1000}, dims, ks, {cuvs::distance::DistanceType::L2Expanded}, {true}, {0.995});
+  auto inputs_large =
+    raft::util::itertools::product<AnnCagraHostInputs>({100},
+                                                       {10000},
+                                                       {32},  // dim
+                                                       {10},  // k
+                                                       {cuvs::distance::DistanceType::L2Expanded},
+                                                       {true},
+                                                       {0.985});
+  inputs.insert(inputs.end(), inputs_large.begin(), inputs_large.end());
+  return inputs;
+}
+
+// The host searches, of a mapped index and with filters.
+const std::vector<AnnCagraHostInputs> inputs_host_search =
+  generate_host_inputs({1, 8, 17, 64, 128, 619}, {1, 16});
+// The graphs built on the host, and the hnswlib export and import.
+const std::vector<AnnCagraHostInputs> inputs_host_graph = generate_host_inputs({8, 64, 137}, {16});
+
 }  // namespace cuvs::neighbors::cagra
@@ -25,4 +25,40 @@ TEST_P(AnnCagraTestF_U32, AnnCagra) { this->testCagra(); }
 
 INSTANTIATE_TEST_CASE_P(AnnCagraTest, AnnCagraTestF_U32, ::testing::ValuesIn(inputs));
 
+typedef AnnCagraSerializeTest<float, float, std::uint32_t> AnnCagraSerializeTestF_U32;
+TEST_P(AnnCagraSerializeTestF_U32, Serialize) { this->testSerialize(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraSerializeTest,
+                        AnnCagraSerializeTestF_U32,
+                        ::testing::ValuesIn(inputs_serialize));
+
+typedef AnnCagraMappedTest<float, float, std::uint32_t> AnnCagraMappedTestF_U32;
+TEST_P(AnnCagraMappedTestF_U32, Mapped) { this->testMapped(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraMappedTest,
+                        AnnCagraMappedTestF_U32,
+                        ::testing::ValuesIn(inputs_host_search));
+
+typedef AnnCagraFilteredHostTest<float, float, std::uint32_t> AnnCagraFilteredHostTestF_U32;
+TEST_P(AnnCagraFilteredHostTestF_U32, FilteredSearch) { this->testFilteredSearch(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraFilteredHostTest,
+                        AnnCagraFilteredHostTestF_U32,
+                        ::testing::ValuesIn(inputs_host_search));
+
+typedef AnnCagraHnswlibTest<float, float, std::uint32_t> AnnCagraHnswlibTestF_U32;
+TEST_P(AnnCagraHnswlibTestF_U32, Hnswlib) { this->testHnswlib(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraHnswlibTest,
+                        AnnCagraHnswlibTestF_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
+typedef AnnCagraOptimizeHostTest<float, float, std::uint32_t> AnnCagraOptimizeHostTestF_U32;
+TEST_P(AnnCagraOptimizeHostTestF_U32, OptimizeHost) { this->testOptimizeHost(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraOptimizeHostTest,
+                        AnnCagraOptimizeHostTestF_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
+typedef AnnCagraExtendHostTest<float, float, std::uint32_t> AnnCagraExtendHostTestF_U32;
+TEST_P(AnnCagraExtendHostTestF_U32, ExtendHost) { this->testExtendHost(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraExtendHostTest,
+                        AnnCagraExtendHostTestF_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
 }  // namespace cuvs::neighbors::cagra
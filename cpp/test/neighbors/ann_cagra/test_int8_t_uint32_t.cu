@@ -25,4 +25,40 @@ TEST_P(AnnCagraTestI8_U32, AnnCagra) { this->testCagra(); }
 
 INSTANTIATE_TEST_CASE_P(AnnCagraTest, AnnCagraTestI8_U32, ::testing::ValuesIn(inputs));
 
+typedef AnnCagraSerializeTest<float, std::int8_t, std::uint32_t> AnnCagraSerializeTestI8_U32;
+TEST_P(AnnCagraSerializeTestI8_U32, Serialize) { this->testSerialize(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraSerializeTest,
+                        AnnCagraSerializeTestI8_U32,
+                        ::testing::ValuesIn(inputs_serialize));
+
+typedef AnnCagraMappedTest<float, std::int8_t, std::uint32_t> AnnCagraMappedTestI8_U32;
+TEST_P(AnnCagraMappedTestI8_U32, Mapped) { this->testMapped(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraMappedTest,
+                        AnnCagraMappedTestI8_U32,
+                        ::testing::ValuesIn(inputs_host_search));
+
+typedef AnnCagraFilteredHostTest<float, std::int8_t, std::uint32_t> AnnCagraFilteredHostTestI8_U32;
+TEST_P(AnnCagraFilteredHostTestI8_U32, FilteredSearch) { this->testFilteredSearch(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraFilteredHostTest,
+                        AnnCagraFilteredHostTestI8_U32,
+                        ::testing::ValuesIn(inputs_host_search));
+
+typedef AnnCagraHnswlibTest<float, std::int8_t, std::uint32_t> AnnCagraHnswlibTestI8_U32;
+TEST_P(AnnCagraHnswlibTestI8_U32, Hnswlib) { this->testHnswlib(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraHnswlibTest,
+                        AnnCagraHnswlibTestI8_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
+typedef AnnCagraOptimizeHostTest<float, std::int8_t, std::uint32_t> AnnCagraOptimizeHostTestI8_U32;
+TEST_P(AnnCagraOptimizeHostTestI8_U32, OptimizeHost) { this->testOptimizeHost(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraOptimizeHostTest,
+                        AnnCagraOptimizeHostTestI8_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
+typedef AnnCagraExtendHostTest<float, std::int8_t, std::uint32_t> AnnCagraExtendHostTestI8_U32;
+TEST_P(AnnCagraExtendHostTestI8_U32, ExtendHost) { this->testExtendHost(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraExtendHostTest,
+                        AnnCagraExtendHostTestI8_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
 }  // namespace cuvs::neighbors::cagra
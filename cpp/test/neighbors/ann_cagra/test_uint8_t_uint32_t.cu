@@ -25,4 +25,40 @@ TEST_P(AnnCagraTestU8_U32, AnnCagra) { this->testCagra(); }
 
 INSTANTIATE_TEST_CASE_P(AnnCagraTest, AnnCagraTestU8_U32, ::testing::ValuesIn(inputs));
 
+typedef AnnCagraSerializeTest<float, std::uint8_t, std::uint32_t> AnnCagraSerializeTestU8_U32;
+TEST_P(AnnCagraSerializeTestU8_U32, Serialize) { this->testSerialize(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraSerializeTest,
+                        AnnCagraSerializeTestU8_U32,
+                        ::testing::ValuesIn(inputs_serialize));
+
+typedef AnnCagraMappedTest<float, std::uint8_t, std::uint32_t> AnnCagraMappedTestU8_U32;
+TEST_P(AnnCagraMappedTestU8_U32, Mapped) { this->testMapped(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraMappedTest,
+                        AnnCagraMappedTestU8_U32,
+                        ::testing::ValuesIn(inputs_host_search));
+
+typedef AnnCagraFilteredHostTest<float, std::uint8_t, std::uint32_t> AnnCagraFilteredHostTestU8_U32;
+TEST_P(AnnCagraFilteredHostTestU8_U32, FilteredSearch) { this->testFilteredSearch(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraFilteredHostTest,
+                        AnnCagraFilteredHostTestU8_U32,
+                        ::testing::ValuesIn(inputs_host_search));
+
+typedef AnnCagraHnswlibTest<float, std::uint8_t, std::uint32_t> AnnCagraHnswlibTestU8_U32;
+TEST_P(AnnCagraHnswlibTestU8_U32, Hnswlib) { this->testHnswlib(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraHnswlibTest,
+                        AnnCagraHnswlibTestU8_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
+typedef AnnCagraOptimizeHostTest<float, std::uint8_t, std::uint32_t> AnnCagraOptimizeHostTestU8_U32;
+TEST_P(AnnCagraOptimizeHostTestU8_U32, OptimizeHost) { this->testOptimizeHost(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraOptimizeHostTest,
+                        AnnCagraOptimizeHostTestU8_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
+typedef AnnCagraExtendHostTest<float, std::uint8_t, std::uint32_t> AnnCagraExtendHostTestU8_U32;
+TEST_P(AnnCagraExtendHostTestU8_U32, ExtendHost) { this->testExtendHost(); }
+INSTANTIATE_TEST_CASE_P(AnnCagraExtendHostTest,
+                        AnnCagraExtendHostTestU8_U32,
+                        ::testing::ValuesIn(inputs_host_graph));
+
 }  // namespace cuvs::neighbors::cagra
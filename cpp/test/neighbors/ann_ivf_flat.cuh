@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "../../src/neighbors/ivf_list.cuh"
 #include "../test_utils.cuh"
 #include "ann_utils.cuh"
 #include "naive_knn.cuh"
@@ -24,9 +25,14 @@
 #include <raft/stats/mean.cuh>
 #include <thrust/sequence.h>
 
+#include <raft/core/serialize.hpp>
 #include <raft/linalg/add.cuh>
 #include <raft/matrix/gather.cuh>
 #include <raft/util/fast_int_div.cuh>
+#include <raft/util/integer_utils.hpp>
+
+#include <sstream>
+#include <string>
 
 namespace cuvs::neighbors::ivf_flat {
 
@@ -56,6 +62,45 @@ template <typename IdxT>
   return os;
 }
 
+/** Write an index in the flat format of version 4, the last one before the container. */
+template <typename DataT, typename IdxT>
+void serialize_legacy(raft::resources const& handle,
+                      std::ostream& os,
+                      const index<DataT, IdxT>& index_)
+{
+  std::string dtype_string = raft::detail::numpy_serializer::get_numpy_dtype<DataT>().to_string();
+  dtype_string.resize(4);
+  os << dtype_string;
+
+  raft::serialize_scalar(handle, os, int{4});
+  raft::serialize_scalar(handle, os, index_.size());
+  raft::serialize_scalar(handle, os, index_.dim());
+  raft::serialize_scalar(handle, os, index_.n_lists());
+  raft::serialize_scalar(handle, os, index_.metric());
+  raft::serialize_scalar(handle, os, index_.adaptive_centers());
+  raft::serialize_scalar(handle, os, index_.conservative_memory_allocation());
+  raft::serialize_mdspan(handle, os, index_.centers());
+  raft::serialize_scalar(handle, os, index_.center_norms().has_value());
+  if (index_.center_norms()) { raft::serialize_mdspan(handle, os, *index_.center_norms()); }
+  auto sizes_host = raft::make_host_vector<uint32_t, uint32_t>(index_.list_sizes().extent(0));
+  raft::copy(sizes_host.data_handle(),
+             index_.list_sizes().data_handle(),
+             sizes_host.size(),
+             raft::resource::get_cuda_stream(handle));
+  raft::resource::sync_stream(handle);
+  raft::serialize_mdspan(handle, os, sizes_host.view());
+
+  list_spec<uint32_t, DataT, IdxT> list_store_spec{index_.dim(), true};
+  for (uint32_t label = 0; label < index_.n_lists(); label++) {
+    ivf::serialize_list(handle,
+                        os,
+                        index_.lists()[label],
+                        list_store_spec,
+                        raft::round_up_safe<uint32_t>(sizes_host(label), kIndexGroupSize));
+  }
+  raft::resource::sync_stream(handle);
+}
+
 template <typename T, typename DataT, typename IdxT>
 class AnnIVFFlatTest : public ::testing::TestWithParam<AnnIvfFlatInputs<IdxT>> {
  public:
@@ -189,6 +234,19 @@ class AnnIVFFlatTest : public ::testing::TestWithParam<AnnIvfFlatInputs<IdxT>> {
         cuvs::neighbors::ivf_flat::deserialize_file(handle_, filename, &index_loaded);
         ASSERT_EQ(index_2.size(), index_loaded.size());
 
+        {
+          // An index in the flat format of version 4 loads through the container reader.
+          std::ostringstream legacy;
+          serialize_legacy(handle_, legacy, index_2);
+          ivf_flat::index<DataT, IdxT> index_legacy(handle_, index_params, ps.dim);
+          ivf_flat::deserialize(handle_, legacy.str(), &index_legacy);
+          std::string plain;
+          std::string roundtrip;
+          ivf_flat::serialize(handle_, plain, index_2);
+          ivf_flat::serialize(handle_, roundtrip, index_legacy);
+          ASSERT_TRUE(roundtrip == plain);
+        }
+
         cuvs::neighbors::ivf_flat::search(handle_,
                                           search_params,
                                           index_loaded,
@@ -202,6 +260,100 @@ class AnnIVFFlatTest : public ::testing::TestWithParam<AnnIvfFlatInputs<IdxT>> {
           indices_ivfflat.data(), indices_ivfflat_dev.data(), queries_size, stream_);
         raft::resource::sync_stream(handle_);
 
+        // Load the same file into host memory and search it on the CPU.
+        {
+          ivf_flat::host_index<DataT, IdxT> host_idx;
+          ivf_flat::deserialize_host_file(handle_, filename, &host_idx);
+          ASSERT_EQ(host_idx.size(), index_2.size());
+          ASSERT_EQ(host_idx.veclen(), index_2.veclen());
+
+          auto queries_host = raft::make_host_matrix<DataT, IdxT>(ps.num_queries, ps.dim);
+          raft::update_host(
+            queries_host.data_handle(), search_queries.data(), search_queries.size(), stream_);
+          raft::resource::sync_stream(handle_);
+          std::vector<IdxT> indices_host(queries_size);
+          std::vector<T> distances_host(queries_size);
+          ivf_flat::search(
+            handle_,
+            search_params,
+            host_idx,
+            raft::make_const_mdspan(queries_host.view()),
+            raft::make_host_matrix_view<IdxT, IdxT>(indices_host.data(), ps.num_queries, ps.k),
+            raft::make_host_matrix_view<T, IdxT>(distances_host.data(), ps.num_queries, ps.k));
+          ASSERT_TRUE(eval_neighbours(indices_naive,
+                                      indices_host,
+                                      distances_naive,
+                                      distances_host,
+                                      ps.num_queries,
+                                      ps.k,
+                                      0.001,
+                                      min_recall));
+
+          // Load the lists on demand, keeping at most one in memory, and search again.
+          ivf::host_load_params load_params;
+          load_params.lazy_lists              = true;
+          load_params.max_resident_list_bytes = 0;
+          ivf_flat::host_index<DataT, IdxT> lazy_idx;
+          ivf_flat::deserialize_host_file(handle_, filename, load_params, &lazy_idx);
+          ASSERT_TRUE(lazy_idx.lazy_lists());
+          ASSERT_EQ(lazy_idx.size(), index_2.size());
+          ASSERT_EQ(lazy_idx.list_loader()->resident_bytes(), size_t{0});
+          std::vector<IdxT> indices_lazy(queries_size);
+          std::vector<T> distances_lazy(queries_size);
+          ivf_flat::search(
+            handle_,
+            search_params,
+            lazy_idx,
+            raft::make_const_mdspan(queries_host.view()),
+            raft::make_host_matrix_view<IdxT, IdxT>(indices_lazy.data(), ps.num_queries, ps.k),
+            raft::make_host_matrix_view<T, IdxT>(distances_lazy.data(), ps.num_queries, ps.k));
+          ASSERT_TRUE(eval_neighbours(indices_host,
+                                      indices_lazy,
+                                      distances_host,
+                                      distances_lazy,
+                                      ps.num_queries,
+                                      ps.k,
+                                      0.001,
+                                      1.0));
+          uint32_t largest_list = 0;
+          for (uint32_t l = 0; l < host_idx.n_lists(); l++) {
+            largest_list = std::max(largest_list, host_idx.list_sizes()(l));
+          }
+          // The section of a list holds its padded data and indices, and a few bytes of headers.
+          const size_t max_list_bytes =
+            raft::round_up_safe<size_t>(largest_list, ivf_flat::kIndexGroupSize) *
+              (ps.dim * sizeof(DataT) + sizeof(IdxT)) +
+            1024;
+          ASSERT_LE(lazy_idx.list_loader()->resident_bytes(), max_list_bytes);
+
+          // The lists of a compressed file are decoded as they are loaded.
+          const std::string compressed_filename = "ivf_flat_index_compressed";
+          ivf_flat::serialize_file(
+            handle_, compressed_filename, index_2, serialize_compression::LOSSLESS);
+          ivf_flat::host_index<DataT, IdxT> compressed_idx;
+          ivf_flat::deserialize_host_file(
+            handle_, compressed_filename, load_params, &compressed_idx);
+          ASSERT_EQ(compressed_idx.size(), index_2.size());
+          std::vector<IdxT> indices_compressed(queries_size);
+          std::vector<T> distances_compressed(queries_size);
+          ivf_flat::search(handle_,
+                           search_params,
+                           compressed_idx,
+                           raft::make_const_mdspan(queries_host.view()),
+                           raft::make_host_matrix_view<IdxT, IdxT>(
+                             indices_compressed.data(), ps.num_queries, ps.k),
+                           raft::make_host_matrix_view<T, IdxT>(
+                             distances_compressed.data(), ps.num_queries, ps.k));
+          ASSERT_TRUE(eval_neighbours(indices_host,
+                                      indices_compressed,
+                                      distances_host,
+                                      distances_compressed,
+                                      ps.num_queries,
+                                      ps.k,
+                                      0.001,
+                                      1.0));
+        }
+
         // Test the centroid invariants
         if (index_2.adaptive_centers()) {
           // The centers must be up-to-date with the corresponding data
@@ -471,6 +623,96 @@ class AnnIVFFlatTest : public ::testing::TestWithParam<AnnIvfFlatInputs<IdxT>> {
         raft::update_host(
           indices_ivfflat.data(), indices_ivfflat_dev.data_handle(), queries_size, stream_);
         raft::resource::sync_stream(handle_);
+
+        // Search a host copy of the index on the CPU, with the same bitset in host memory.
+        std::string serialized;
+        ivf_flat::serialize(handle_, serialized, index);
+        ivf_flat::host_index<DataT, IdxT> host_idx;
+        ivf_flat::deserialize_host(handle_, serialized, &host_idx);
+
+        auto bitset_dev = removed_indices_bitset.view();
+        std::vector<uint32_t> bitset_host(bitset_dev.n_elements());
+        raft::update_host(bitset_host.data(), bitset_dev.data(), bitset_host.size(), stream_);
+        auto queries_host = raft::make_host_matrix<DataT, IdxT>(ps.num_queries, ps.dim);
+        raft::update_host(
+          queries_host.data_handle(), search_queries.data(), search_queries.size(), stream_);
+        raft::resource::sync_stream(handle_);
+
+        std::vector<IdxT> indices_host(queries_size);
+        std::vector<T> distances_host(queries_size);
+        ivf_flat::search_with_filtering(
+          handle_,
+          search_params,
+          host_idx,
+          raft::make_const_mdspan(queries_host.view()),
+          raft::make_host_matrix_view<IdxT, IdxT>(indices_host.data(), ps.num_queries, ps.k),
+          raft::make_host_matrix_view<T, IdxT>(distances_host.data(), ps.num_queries, ps.k),
+          cuvs::neighbors::filtering::bitset_filter(
+            cuvs::core::bitset_view<uint32_t, IdxT>(bitset_host.data(), ps.num_db_vecs)));
+        ASSERT_TRUE(eval_neighbours(indices_naive,
+                                    indices_host,
+                                    distances_naive,
+                                    distances_host,
+                                    ps.num_queries,
+                                    ps.k,
+                                    0.001,
+                                    min_recall));
+
+        // A selective filter, under which the host search scans the admitted rows exactly.
+        const size_t n_admitted = 2 * ps.k;
+        const size_t stride     = (ps.num_db_vecs - test_ivf_sample_filter::offset) / n_admitted;
+        if (stride > 0 && n_admitted <= size_t(ps.num_db_vecs) * ps.nprobe / ps.nlist) {
+          std::vector<DataT> database_host(database.size());
+          raft::update_host(database_host.data(), database.data(), database.size(), stream_);
+          raft::resource::sync_stream(handle_);
+          std::vector<uint32_t> selective_bits(bitset_host.size(), 0);
+          std::vector<IdxT> admitted_rows;
+          for (size_t i = 0; i < n_admitted; i++) {
+            auto row = IdxT(test_ivf_sample_filter::offset + i * stride);
+            selective_bits[row / 32] |= uint32_t{1} << (row % 32);
+            admitted_rows.push_back(row);
+          }
+          ivf_flat::search_with_filtering(
+            handle_,
+            search_params,
+            host_idx,
+            raft::make_const_mdspan(queries_host.view()),
+            raft::make_host_matrix_view<IdxT, IdxT>(indices_host.data(), ps.num_queries, ps.k),
+            raft::make_host_matrix_view<T, IdxT>(distances_host.data(), ps.num_queries, ps.k),
+            cuvs::neighbors::filtering::bitset_filter(
+              cuvs::core::bitset_view<uint32_t, IdxT>(selective_bits.data(), ps.num_db_vecs)));
+
+          const bool select_max = ps.metric == cuvs::distance::DistanceType::InnerProduct;
+          for (IdxT q = 0; q < ps.num_queries; q++) {
+            std::vector<T> expected;
+            for (auto row : admitted_rows) {
+              T d = 0;
+              for (IdxT j = 0; j < ps.dim; j++) {
+                T x = T(queries_host(q, j));
+                T y = T(database_host[size_t(row) * ps.dim + j]);
+                d += select_max ? x * y : (x - y) * (x - y);
+              }
+              if (ps.metric == cuvs::distance::DistanceType::L2SqrtExpanded ||
+                  ps.metric == cuvs::distance::DistanceType::L2SqrtUnexpanded) {
+                d = std::sqrt(d);
+              }
+              expected.push_back(d);
+            }
+            if (select_max) {
+              std::sort(expected.begin(), expected.end(), std::greater<T>());
+            } else {
+              std::sort(expected.begin(), expected.end());
+            }
+            for (IdxT i = 0; i < ps.k; i++) {
+              auto id = indices_host[q * ps.k + i];
+              ASSERT_TRUE(std::find(admitted_rows.begin(), admitted_rows.end(), id) !=
+                          admitted_rows.end());
+              ASSERT_NEAR(distances_host[q * ps.k + i],
+                          expected[i],
+                          0.001 * std::max<T>(1, std::abs(expected[i])));
+            }
+          }
+        }
       }
       ASSERT_TRUE(eval_neighbours(indices_naive,
                                   indices_ivfflat,
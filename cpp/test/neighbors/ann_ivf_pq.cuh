@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "../../src/neighbors/ivf_list.cuh"
 #include "../test_utils.cuh"
 #include "ann_utils.cuh"
 #include "naive_knn.cuh"
@@ -22,11 +23,16 @@
 #include <cuvs/neighbors/ivf_pq.hpp>
 
 #include <raft/core/bitset.cuh>
+#include <raft/core/serialize.hpp>
 #include <raft/linalg/add.cuh>
 #include <raft/matrix/gather.cuh>
 #include <rmm/mr/device/managed_memory_resource.hpp>
 #include <thrust/sequence.h>
 
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
 namespace cuvs::neighbors::ivf_pq {
 
 using raft::RAFT_NAME;  // For logging
@@ -144,6 +150,40 @@ auto min_output_size(const raft::resources& handle,
   return acc_sizes(last_nonzero) - acc_sizes(last_nonzero - std::min(last_nonzero, n_probes));
 }
 
+/** Write an index in the flat format of version 3, the last one before the container. */
+template <typename IdxT>
+void serialize_legacy(const raft::resources& handle, std::ostream& os, const index<IdxT>& index)
+{
+  raft::serialize_scalar(handle, os, int{3});
+  raft::serialize_scalar(handle, os, index.size());
+  raft::serialize_scalar(handle, os, index.dim());
+  raft::serialize_scalar(handle, os, index.pq_bits());
+  raft::serialize_scalar(handle, os, index.pq_dim());
+  raft::serialize_scalar(handle, os, index.conservative_memory_allocation());
+
+  raft::serialize_scalar(handle, os, index.metric());
+  raft::serialize_scalar(handle, os, index.codebook_kind());
+  raft::serialize_scalar(handle, os, index.n_lists());
+
+  raft::serialize_mdspan(handle, os, index.pq_centers());
+  raft::serialize_mdspan(handle, os, index.centers());
+  raft::serialize_mdspan(handle, os, index.centers_rot());
+  raft::serialize_mdspan(handle, os, index.rotation_matrix());
+
+  auto sizes_host =
+    raft::make_host_mdarray<uint32_t, uint32_t, raft::row_major>(index.list_sizes().extents());
+  raft::copy(sizes_host.data_handle(),
+             index.list_sizes().data_handle(),
+             sizes_host.size(),
+             raft::resource::get_cuda_stream(handle));
+  raft::resource::sync_stream(handle);
+  raft::serialize_mdspan(handle, os, sizes_host.view());
+  auto list_store_spec = list_spec<uint32_t, IdxT>{index.pq_bits(), index.pq_dim(), true};
+  for (uint32_t label = 0; label < index.n_lists(); label++) {
+    ivf::serialize_list(handle, os, index.lists()[label], list_store_spec, sizes_host(label));
+  }
+}
+
 template <typename EvalT, typename DataT, typename IdxT>
 class ivf_pq_test : public ::testing::TestWithParam<ivf_pq_inputs> {
  public:
@@ -241,7 +281,39 @@ class ivf_pq_test : public ::testing::TestWithParam<ivf_pq_inputs> {
   auto build_serialize()
   {
     std::string filename = "ivf_pq_index";
-    cuvs::neighbors::ivf_pq::serialize_file(handle_, filename, build_only());
+    auto built           = build_only();
+    cuvs::neighbors::ivf_pq::serialize_file(handle_, filename, built);
+    // The lists of a file are written in parallel, in the layout of the stream serialization.
+    std::string serialized;
+    cuvs::neighbors::ivf_pq::serialize(handle_, serialized, built);
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    std::string file_bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    EXPECT_TRUE(file_bytes == serialized);
+
+    // The compressed lists load back to the same index.
+    const std::string compressed_filename = "ivf_pq_index_compressed";
+    cuvs::neighbors::ivf_pq::serialize_file(
+      handle_, compressed_filename, built, serialize_compression::LOSSLESS);
+    cuvs::neighbors::ivf_pq::index<IdxT> decompressed(handle_, ps.index_params, ps.dim);
+    cuvs::neighbors::ivf_pq::deserialize_file(handle_, compressed_filename, &decompressed);
+    std::string roundtrip;
+    cuvs::neighbors::ivf_pq::serialize(handle_, roundtrip, decompressed);
+    EXPECT_TRUE(roundtrip == serialized);
+    EXPECT_EQ(decompressed.data_type(),
+              cuvs::spatial::knn::detail::utils::config<DataT>::kDataType);
+
+    // An index in the flat format of version 3 loads through the container reader; that format
+    // does not record the data type, which is then float.
+    std::ostringstream legacy;
+    serialize_legacy(handle_, legacy, built);
+    cuvs::neighbors::ivf_pq::index<IdxT> legacy_index(handle_, ps.index_params, ps.dim);
+    cuvs::neighbors::ivf_pq::deserialize(handle_, legacy.str(), &legacy_index);
+    EXPECT_EQ(legacy_index.data_type(), CUDA_R_32F);
+    legacy_index.set_data_type(built.data_type());
+    std::string legacy_roundtrip;
+    cuvs::neighbors::ivf_pq::serialize(handle_, legacy_roundtrip, legacy_index);
+    EXPECT_TRUE(legacy_roundtrip == serialized);
+
     cuvs::neighbors::ivf_pq::index<IdxT> index(handle_, ps.index_params, ps.dim);
     cuvs::neighbors::ivf_pq::deserialize_file(handle_, filename, &index);
     return index;
@@ -475,6 +547,234 @@ class ivf_pq_test : public ::testing::TestWithParam<ivf_pq_inputs> {
     }
   }
 
+  /** Load a serialized index into host memory and search it on the CPU. */
+  void run_host()
+  {
+    std::string str;
+    const std::string filename            = "ivf_pq_index";
+    const std::string compressed_filename = "ivf_pq_index_compressed";
+    {
+      auto index = build_only();
+      cuvs::neighbors::ivf_pq::serialize(handle_, str, index);
+      cuvs::neighbors::ivf_pq::serialize_file(handle_, filename, index);
+      cuvs::neighbors::ivf_pq::serialize_file(
+        handle_, compressed_filename, index, serialize_compression::LOSSLESS);
+    }
+    host_index<IdxT> index;
+    cuvs::neighbors::ivf_pq::deserialize_host(handle_, str, &index);
+    ASSERT_EQ(index.size(), IdxT(ps.num_db_vecs));
+
+    double compression_ratio =
+      static_cast<double>(ps.dim * 8) / static_cast<double>(index.pq_dim() * index.pq_bits());
+
+    auto queries = raft::make_host_matrix<DataT, int64_t>(ps.num_queries, ps.dim);
+    raft::update_host(
+      queries.data_handle(), search_queries.data(), search_queries.size(), stream_);
+    raft::resource::sync_stream(handle_);
+
+    // With 4-bit codes, also cover the fast-scan path of the 8-bit lookup tables.
+    std::vector<cudaDataType_t> lut_dtypes{ps.search_params.lut_dtype};
+    if (index.pq_bits() == 4 && ps.search_params.lut_dtype != CUDA_R_8U) {
+      lut_dtypes.push_back(CUDA_R_8U);
+    }
+    // Same recall bounds as in `run`
+    double base_min_recall = static_cast<double>(ps.search_params.n_probes) /
+                             static_cast<double>(ps.index_params.n_lists);
+    base_min_recall =
+      std::min(std::erfc(0.05 * compression_ratio / std::max(base_min_recall, 0.5)),
+               base_min_recall);
+    base_min_recall = ps.min_recall.value_or(base_min_recall);
+
+    size_t queries_size = ps.num_queries * ps.k;
+    for (auto lut_dtype : lut_dtypes) {
+      auto search_params      = ps.search_params;
+      search_params.lut_dtype = lut_dtype;
+
+      std::vector<IdxT> indices_ivf_pq(queries_size);
+      std::vector<EvalT> distances_ivf_pq(queries_size);
+      cuvs::neighbors::ivf_pq::search(
+        handle_,
+        search_params,
+        index,
+        raft::make_const_mdspan(queries.view()),
+        raft::make_host_matrix_view<IdxT, int64_t>(indices_ivf_pq.data(), ps.num_queries, ps.k),
+        raft::make_host_matrix_view<EvalT, int64_t>(distances_ivf_pq.data(), ps.num_queries, ps.k));
+
+      double min_recall = base_min_recall;
+      // The 8-bit lookup tables lose some precision.
+      if (lut_dtype != ps.search_params.lut_dtype) { min_recall *= 0.90; }
+
+      ASSERT_TRUE(cuvs::neighbors::eval_neighbours(indices_ref,
+                                                   indices_ivf_pq,
+                                                   distances_ref,
+                                                   distances_ivf_pq,
+                                                   ps.num_queries,
+                                                   ps.k,
+                                                   0.0001 * compression_ratio,
+                                                   min_recall))
+        << ps;
+    }
+
+    // The host search with a bitset filter. The number of admitted rows decides between probing
+    // the lists with the filter applied and scanning the admitted rows of all the lists.
+    const size_t n_rows   = ps.num_db_vecs;
+    const size_t n_probes = std::min(ps.search_params.n_probes, ps.index_params.n_lists);
+    const size_t ann_rows = n_rows * n_probes / ps.index_params.n_lists;
+    std::vector<uint32_t> bits(raft::div_rounding_up_safe<size_t>(n_rows, 32), 0);
+    auto filter = [&]() {
+      return cuvs::neighbors::filtering::bitset_filter(
+        cuvs::core::bitset_view<uint32_t, IdxT>(bits.data(), IdxT(n_rows)));
+    };
+    std::vector<IdxT> indices_filtered(queries_size);
+    std::vector<EvalT> distances_filtered(queries_size);
+    auto search_filtered = [&](const host_index<IdxT>& idx, const search_params& params) {
+      cuvs::neighbors::ivf_pq::search_with_filtering(
+        handle_,
+        params,
+        idx,
+        raft::make_const_mdspan(queries.view()),
+        raft::make_host_matrix_view<IdxT, int64_t>(indices_filtered.data(), ps.num_queries, ps.k),
+        raft::make_host_matrix_view<EvalT, int64_t>(
+          distances_filtered.data(), ps.num_queries, ps.k),
+        filter());
+    };
+
+    // Filter out the first rows: the lists are probed with the filter applied.
+    const size_t offset = test_ivf_sample_filter::offset;
+    if (n_rows > offset + ann_rows &&
+        double(ann_rows) * double(n_rows - offset) >= double(ps.k) * double(n_rows)) {
+      for (size_t row = offset; row < n_rows; row++) {
+        bits[row / 32] |= uint32_t{1} << (row % 32);
+      }
+      size_t ref_size = queries_size;
+      rmm::device_uvector<EvalT> distances_dev(ref_size, stream_);
+      rmm::device_uvector<IdxT> indices_dev(ref_size, stream_);
+      cuvs::neighbors::naive_knn<EvalT, DataT, IdxT>(
+        handle_,
+        distances_dev.data(),
+        indices_dev.data(),
+        search_queries.data(),
+        database.data() + offset * ps.dim,
+        ps.num_queries,
+        n_rows - offset,
+        ps.dim,
+        ps.k,
+        static_cast<cuvs::distance::DistanceType>((int)ps.index_params.metric));
+      raft::linalg::addScalar(
+        indices_dev.data(), indices_dev.data(), IdxT(offset), ref_size, stream_);
+      std::vector<IdxT> indices_filtered_ref(ref_size);
+      std::vector<EvalT> distances_filtered_ref(ref_size);
+      raft::update_host(indices_filtered_ref.data(), indices_dev.data(), ref_size, stream_);
+      raft::update_host(distances_filtered_ref.data(), distances_dev.data(), ref_size, stream_);
+      raft::resource::sync_stream(handle_);
+
+      search_filtered(index, ps.search_params);
+      for (auto id : indices_filtered) {
+        ASSERT_TRUE(id >= IdxT(offset) && id < IdxT(n_rows)) << "row " << id << " is filtered out";
+      }
+      ASSERT_TRUE(cuvs::neighbors::eval_neighbours(indices_filtered_ref,
+                                                   indices_filtered,
+                                                   distances_filtered_ref,
+                                                   distances_filtered,
+                                                   ps.num_queries,
+                                                   ps.k,
+                                                   0.0001 * compression_ratio,
+                                                   base_min_recall))
+        << ps;
+    }
+
+    // Admit a few rows spread over the index: the admitted rows of all the lists are scanned. The
+    // result must match probing all the lists with the filter applied, which a lazily loaded index
+    // does, with the same PQ distances.
+    const size_t n_admitted = 2 * ps.k;
+    const size_t stride     = n_rows / n_admitted;
+    if (stride > 0 && n_admitted <= ann_rows) {
+      std::fill(bits.begin(), bits.end(), 0);
+      for (size_t i = 0; i < n_admitted; i++) {
+        const size_t row = i * stride;
+        bits[row / 32] |= uint32_t{1} << (row % 32);
+      }
+      search_filtered(index, ps.search_params);
+      auto indices_scan   = indices_filtered;
+      auto distances_scan = distances_filtered;
+
+      ivf::host_load_params load_params;
+      load_params.lazy_lists = true;
+      host_index<IdxT> lazy_index;
+      cuvs::neighbors::ivf_pq::deserialize_host_file(handle_, filename, load_params, &lazy_index);
+      auto probe_all_params     = ps.search_params;
+      probe_all_params.n_probes = ps.index_params.n_lists;
+      search_filtered(lazy_index, probe_all_params);
+
+      for (size_t i = 0; i < queries_size; i++) {
+        const auto id = indices_scan[i];
+        ASSERT_TRUE(id >= 0 && id < IdxT(n_rows) && id % stride == 0 &&
+                    size_t(id / stride) < n_admitted)
+          << "row " << id << " is filtered out";
+        ASSERT_NEAR(distances_scan[i],
+                    distances_filtered[i],
+                    1e-5 * std::max<EvalT>(1, std::abs(distances_filtered[i])));
+      }
+    }
+
+    // Load the lists on demand from the file, with room for a quarter of them in memory: the
+    // lists are dropped and loaded again during the search, whose results must not change. The
+    // cap bounds the memory of the decoded lists, also when their sections are compressed.
+    std::vector<IdxT> indices_eager(queries_size);
+    std::vector<EvalT> distances_eager(queries_size);
+    cuvs::neighbors::ivf_pq::search(
+      handle_,
+      ps.search_params,
+      index,
+      raft::make_const_mdspan(queries.view()),
+      raft::make_host_matrix_view<IdxT, int64_t>(indices_eager.data(), ps.num_queries, ps.k),
+      raft::make_host_matrix_view<EvalT, int64_t>(distances_eager.data(), ps.num_queries, ps.k));
+    size_t list_bytes     = 0;
+    uint32_t largest_list = 0;
+    for (uint32_t label = 0; label < index.n_lists(); label++) {
+      const uint32_t size = index.list_sizes()(label);
+      largest_list        = std::max(largest_list, size);
+      list_bytes += raft::round_up_safe<size_t>(size, kIndexGroupSize) *
+                    (index.pq_chunks() * kIndexGroupVecLen + sizeof(IdxT));
+    }
+    // Beyond the cap only the list loaded last stays; a decoded list holds its codes and its
+    // indices.
+    const size_t max_list_bytes = raft::round_up_safe<size_t>(largest_list, kIndexGroupSize) *
+                                  (index.pq_chunks() * kIndexGroupVecLen + sizeof(IdxT));
+    ivf::host_load_params capped_params;
+    capped_params.lazy_lists              = true;
+    capped_params.max_resident_list_bytes = list_bytes / 4;
+    for (const auto& capped_filename : {filename, compressed_filename}) {
+      host_index<IdxT> capped_index;
+      cuvs::neighbors::ivf_pq::deserialize_host_file(
+        handle_, capped_filename, capped_params, &capped_index);
+      ASSERT_TRUE(capped_index.lazy_lists());
+      ASSERT_EQ(capped_index.size(), index.size());
+      std::vector<IdxT> indices_lazy(queries_size);
+      std::vector<EvalT> distances_lazy(queries_size);
+      cuvs::neighbors::ivf_pq::search(
+        handle_,
+        ps.search_params,
+        capped_index,
+        raft::make_const_mdspan(queries.view()),
+        raft::make_host_matrix_view<IdxT, int64_t>(indices_lazy.data(), ps.num_queries, ps.k),
+        raft::make_host_matrix_view<EvalT, int64_t>(
+          distances_lazy.data(), ps.num_queries, ps.k));
+      ASSERT_TRUE(cuvs::neighbors::eval_neighbours(indices_eager,
+                                                   indices_lazy,
+                                                   distances_eager,
+                                                   distances_lazy,
+                                                   ps.num_queries,
+                                                   ps.k,
+                                                   0.0001,
+                                                   1.0))
+        << ps << ", file " << capped_filename;
+      ASSERT_LE(capped_index.list_loader()->resident_bytes(),
+                std::max(capped_params.max_resident_list_bytes, max_list_bytes))
+        << "file " << capped_filename;
+    }
+  }
+
   void SetUp() override  // NOLINT
   {
     gen_data();
@@ -980,6 +1280,12 @@ inline auto special_cases() -> test_cases_t
     this->run([this]() { return this->build_serialize(); }); \
   }
 
+#define TEST_BUILD_HOST_SEARCH(type)          \
+  TEST_P(type, build_host_search) /* NOLINT */ \
+  {                                            \
+    this->run_host();                          \
+  }
+
 #define INSTANTIATE(type, vals) \
   INSTANTIATE_TEST_SUITE_P(IvfPq, type, ::testing::ValuesIn(vals)); /* NOLINT */
 
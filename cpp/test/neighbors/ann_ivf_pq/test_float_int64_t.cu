@@ -23,6 +23,7 @@ using f32_f32_i64_filter = ivf_pq_filter_test<float, float, int64_t>;
 
 TEST_BUILD_EXTEND_SEARCH(f32_f32_i64)
 TEST_BUILD_SERIALIZE_SEARCH(f32_f32_i64)
+TEST_BUILD_HOST_SEARCH(f32_f32_i64)
 INSTANTIATE(f32_f32_i64, defaults() + small_dims() + big_dims_moderate_lut());
 
 TEST_BUILD_SEARCH(f32_f32_i64_filter)
@@ -23,6 +23,7 @@ using f32_i08_i64_filter = ivf_pq_filter_test<float, int8_t, int64_t>;
 
 TEST_BUILD_SEARCH(f32_i08_i64)
 TEST_BUILD_SERIALIZE_SEARCH(f32_i08_i64)
+TEST_BUILD_HOST_SEARCH(f32_i08_i64)
 INSTANTIATE(f32_i08_i64, defaults() + big_dims() + var_k());
 
 TEST_BUILD_SEARCH(f32_i08_i64_filter)
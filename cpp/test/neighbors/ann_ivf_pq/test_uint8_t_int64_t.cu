@@ -23,6 +23,7 @@ using f32_u08_i64_filter = ivf_pq_filter_test<float, uint8_t, int64_t>;
 
 TEST_BUILD_SEARCH(f32_u08_i64)
 TEST_BUILD_EXTEND_SEARCH(f32_u08_i64)
+TEST_BUILD_HOST_SEARCH(f32_u08_i64)
 INSTANTIATE(f32_u08_i64, small_dims_per_cluster() + enum_variety());
 
 TEST_BUILD_SEARCH(f32_u08_i64_filter)
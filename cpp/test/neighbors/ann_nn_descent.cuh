@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "../../src/neighbors/detail/nn_descent.cuh"
 #include "../test_utils.cuh"
 #include "ann_utils.cuh"
 
@@ -27,6 +28,8 @@
 #include <gtest/gtest.h>
 
 #include <cstddef>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -40,13 +43,17 @@ struct AnnNNDescentInputs {
   cuvs::distance::DistanceType metric;
   bool host_dataset;
   double min_recall;
+  bool host_backend;
+  size_t n_clusters;
+  size_t partition_overlap;
 };
 
 inline ::std::ostream& operator<<(::std::ostream& os, const AnnNNDescentInputs& p)
 {
   os << "dataset shape=" << p.n_rows << "x" << p.dim << ", graph_degree=" << p.graph_degree
      << ", metric=" << static_cast<int>(p.metric) << (p.host_dataset ? ", host" : ", device")
-     << std::endl;
+     << (p.host_backend ? ", CPU backend" : "") << ", n_clusters=" << p.n_clusters
+     << ", partition_overlap=" << p.partition_overlap << std::endl;
   return os;
 }
 
@@ -91,21 +98,55 @@ class AnnNNDescentTest : public ::testing::TestWithParam<AnnNNDescentInputs> {
         index_params.graph_degree              = ps.graph_degree;
         index_params.intermediate_graph_degree = 2 * ps.graph_degree;
         index_params.max_iterations            = 100;
+        index_params.n_clusters                = ps.n_clusters;
+        index_params.partition_overlap         = ps.partition_overlap;
 
         auto database_view = raft::make_device_matrix_view<const DataT, int64_t>(
           (const DataT*)database.data(), ps.n_rows, ps.dim);
 
         {
-          if (ps.host_dataset) {
+          if (ps.n_clusters > 1) {
+            // The partitioned build reads the dataset from a file, after a header of 8 bytes.
+            std::vector<DataT> database_host(database.size());
+            raft::update_host(database_host.data(), database.data(), database.size(), stream_);
+            raft::resource::sync_stream(handle_);
+            const std::string path = make_temp_file("nn_descent_dataset");
+            {
+              std::ofstream of(path, std::ios::binary);
+              const uint32_t header[2] = {uint32_t(ps.n_rows), uint32_t(ps.dim)};
+              of.write(reinterpret_cast<const char*>(header), sizeof(header));
+              of.write(reinterpret_cast<const char*>(database_host.data()),
+                       database_host.size() * sizeof(DataT));
+            }
+            index<IdxT> index{handle_, ps.n_rows, ps.graph_degree};
+            cuvs::neighbors::nn_descent::build(
+              handle_, index_params, file_dataset<DataT>{path, ps.n_rows, ps.dim, 8}, index);
+            std::remove(path.c_str());
+            raft::update_host(
+              indices_NNDescent.data(), index.graph().data_handle(), queries_size, stream_);
+          } else if (ps.host_dataset) {
             auto database_host = raft::make_host_matrix<DataT, int64_t>(ps.n_rows, ps.dim);
             raft::copy(database_host.data_handle(), database.data(), database.size(), stream_);
             auto database_host_view = raft::make_host_matrix_view<const DataT, int64_t>(
               (const DataT*)database_host.data_handle(), ps.n_rows, ps.dim);
-            auto index =
-              cuvs::neighbors::nn_descent::build(handle_, index_params, database_host_view);
-            raft::update_host(
-              indices_NNDescent.data(), index.graph().data_handle(), queries_size, stream_);
+            if (ps.host_backend) {
+              index<IdxT> index{handle_, ps.n_rows, ps.graph_degree};
+              detail::build(handle_, index_params, database_host_view, index, true);
+              raft::update_host(
+                indices_NNDescent.data(), index.graph().data_handle(), queries_size, stream_);
+            } else {
+              auto index =
+                cuvs::neighbors::nn_descent::build(handle_, index_params, database_host_view);
+              raft::update_host(
+                indices_NNDescent.data(), index.graph().data_handle(), queries_size, stream_);
+            }
           } else {
+            // A dataset in device memory is not partitioned.
+            auto partitioned_params       = index_params;
+            partitioned_params.n_clusters = 2;
+            EXPECT_THROW(
+              cuvs::neighbors::nn_descent::build(handle_, partitioned_params, database_view),
+              raft::logic_error);
             auto index = cuvs::neighbors::nn_descent::build(handle_, index_params, database_view);
             raft::update_host(
               indices_NNDescent.data(), index.graph().data_handle(), queries_size, stream_);
@@ -152,6 +193,47 @@ const std::vector<AnnNNDescentInputs> inputs = raft::util::itertools::product<An
   {32, 64},                                                  // graph_degree
   {cuvs::distance::DistanceType::L2Expanded},
   {false, true},
-  {0.90});
+  {0.90},
+  {false},
+  {1},
+  {2});
+
+// The CPU backend, which the build selects on machines without a GPU.
+const std::vector<AnnNNDescentInputs> inputs_host_backend =
+  raft::util::itertools::product<AnnNNDescentInputs>({1000, 2000},            // n_rows
+                                                     {3, 17, 128, 137, 619},  // dim
+                                                     {32, 64},                // graph_degree
+                                                     {cuvs::distance::DistanceType::L2Expanded},
+                                                     {true},
+                                                     {0.90},
+                                                     {true},
+                                                     {1},
+                                                     {2});
+
+// The partitioned build of a dataset in a file. The true neighbors of a row are in its two
+// partitions only if the data has a low intrinsic dimension.
+const std::vector<AnnNNDescentInputs> inputs_partitioned =
+  raft::util::itertools::product<AnnNNDescentInputs>({5000, 8000},  // n_rows
+                                                     {3, 8},        // dim
+                                                     {32, 64},      // graph_degree
+                                                     {cuvs::distance::DistanceType::L2Expanded},
+                                                     {true},
+                                                     {0.90},
+                                                     {false},
+                                                     {4, 9},
+                                                     {2});
+
+// The partitioned build at realistic dimensions, where a row shares a partition with its true
+// neighbors only if it is assigned to enough partitions.
+const std::vector<AnnNNDescentInputs> inputs_partitioned_overlap =
+  raft::util::itertools::product<AnnNNDescentInputs>({5000},     // n_rows
+                                                     {64, 128},  // dim
+                                                     {32, 64},   // graph_degree
+                                                     {cuvs::distance::DistanceType::L2Expanded},
+                                                     {true},
+                                                     {0.90},
+                                                     {false},
+                                                     {8},
+                                                     {4});
 
 }  // namespace  cuvs::neighbors::nn_descent
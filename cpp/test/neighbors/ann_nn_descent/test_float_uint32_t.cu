@@ -24,5 +24,14 @@ typedef AnnNNDescentTest<float, float, std::uint32_t> AnnNNDescentTestF_U32;
 TEST_P(AnnNNDescentTestF_U32, AnnNNDescent) { this->testNNDescent(); }
 
 INSTANTIATE_TEST_CASE_P(AnnNNDescentTest, AnnNNDescentTestF_U32, ::testing::ValuesIn(inputs));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentHostBackendTest,
+                        AnnNNDescentTestF_U32,
+                        ::testing::ValuesIn(inputs_host_backend));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentPartitionedTest,
+                        AnnNNDescentTestF_U32,
+                        ::testing::ValuesIn(inputs_partitioned));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentPartitionedOverlapTest,
+                        AnnNNDescentTestF_U32,
+                        ::testing::ValuesIn(inputs_partitioned_overlap));
 
 }  // namespace   cuvs::neighbors::nn_descent
@@ -24,5 +24,14 @@ typedef AnnNNDescentTest<float, int8_t, std::uint32_t> AnnNNDescentTestI8_U32;
 TEST_P(AnnNNDescentTestI8_U32, AnnNNDescent) { this->testNNDescent(); }
 
 INSTANTIATE_TEST_CASE_P(AnnNNDescentTest, AnnNNDescentTestI8_U32, ::testing::ValuesIn(inputs));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentHostBackendTest,
+                        AnnNNDescentTestI8_U32,
+                        ::testing::ValuesIn(inputs_host_backend));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentPartitionedTest,
+                        AnnNNDescentTestI8_U32,
+                        ::testing::ValuesIn(inputs_partitioned));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentPartitionedOverlapTest,
+                        AnnNNDescentTestI8_U32,
+                        ::testing::ValuesIn(inputs_partitioned_overlap));
 
 }  // namespace   cuvs::neighbors::nn_descent
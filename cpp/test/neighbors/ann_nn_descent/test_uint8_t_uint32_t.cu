@@ -24,5 +24,14 @@ typedef AnnNNDescentTest<float, uint8_t, std::uint32_t> AnnNNDescentTestUI8_U32;
 TEST_P(AnnNNDescentTestUI8_U32, AnnNNDescent) { this->testNNDescent(); }
 
 INSTANTIATE_TEST_CASE_P(AnnNNDescentTest, AnnNNDescentTestUI8_U32, ::testing::ValuesIn(inputs));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentHostBackendTest,
+                        AnnNNDescentTestUI8_U32,
+                        ::testing::ValuesIn(inputs_host_backend));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentPartitionedTest,
+                        AnnNNDescentTestUI8_U32,
+                        ::testing::ValuesIn(inputs_partitioned));
+INSTANTIATE_TEST_CASE_P(AnnNNDescentPartitionedOverlapTest,
+                        AnnNNDescentTestUI8_U32,
+                        ::testing::ValuesIn(inputs_partitioned_overlap));
 
 }  // namespace   cuvs::neighbors::nn_descent
@@ -18,6 +18,11 @@
 #include <cuvs/distance/distance.hpp>
 #include <cuvs/neighbors/brute_force.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
 namespace cuvs::neighbors::brute_force {
 struct KNNInputs {
   std::vector<std::vector<float>> input;
@@ -92,6 +97,21 @@ class KNNTest : public ::testing::TestWithParam<KNNInputs> {
 
     ASSERT_TRUE(devArrMatch(
       expected_labels_.data(), actual_labels_.data(), rows_ * k_, cuvs::Compare<int>(), stream));
+
+    // Search the index loaded back from its serialized form.
+    std::string serialized;
+    cuvs::neighbors::brute_force::serialize(
+      handle, serialized, idx, cuvs::neighbors::serialize_compression::LOSSLESS);
+    cuvs::neighbors::brute_force::index<T> loaded(handle);
+    cuvs::neighbors::brute_force::deserialize(handle, serialized, &loaded);
+    ASSERT_EQ(loaded.size(), idx.size());
+    ASSERT_EQ(loaded.metric(), idx.metric());
+    ASSERT_EQ(loaded.has_norms(), idx.has_norms());
+    cuvs::neighbors::brute_force::search(handle, loaded, search, indices, distances, std::nullopt);
+    build_actual_output<<<raft::ceildiv(rows_ * k_, 32), 32, 0, stream>>>(
+      actual_labels_.data(), rows_, k_, search_labels_.data(), indices_.data());
+    ASSERT_TRUE(devArrMatch(
+      expected_labels_.data(), actual_labels_.data(), rows_ * k_, cuvs::Compare<int>(), stream));
   }
 
   void SetUp() override
@@ -179,4 +199,118 @@ typedef KNNTest<float, int64_t> KNNTestFint64_t;
 TEST_P(KNNTestFint64_t, BruteForce) { this->testBruteForce(); }
 
 INSTANTIATE_TEST_CASE_P(KNNTest, KNNTestFint64_t, ::testing::ValuesIn(inputs));
-}  // namespace cuvs::neighbors::brute_force
\ No newline at end of file
+struct HostKNNInputs {
+  int64_t n_rows;
+  int64_t n_queries;
+  int64_t dim;
+  int64_t k;
+  cuvs::distance::DistanceType metric;
+};
+
+auto host_knn_reference(cuvs::distance::DistanceType metric,
+                        const float* x,
+                        const float* y,
+                        int64_t dim) -> double
+{
+  double s = 0, nx = 0, ny = 0;
+  for (int64_t l = 0; l < dim; l++) {
+    double a = x[l], b = y[l];
+    switch (metric) {
+      case cuvs::distance::DistanceType::L1: s += std::abs(a - b); break;
+      case cuvs::distance::DistanceType::Linf: s = std::max(s, std::abs(a - b)); break;
+      case cuvs::distance::DistanceType::InnerProduct: s += a * b; break;
+      case cuvs::distance::DistanceType::CosineExpanded:
+        s += a * b;
+        nx += a * a;
+        ny += b * b;
+        break;
+      default: s += (a - b) * (a - b);
+    }
+  }
+  switch (metric) {
+    case cuvs::distance::DistanceType::CosineExpanded: return 1.0 - s / std::sqrt(nx * ny);
+    case cuvs::distance::DistanceType::L2SqrtExpanded:
+    case cuvs::distance::DistanceType::L2SqrtUnexpanded: return std::sqrt(s);
+    default: return s;
+  }
+}
+
+class HostKNNTest : public ::testing::TestWithParam<HostKNNInputs> {
+ protected:
+  void run()
+  {
+    auto ps = GetParam();
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    auto dataset = raft::make_host_matrix<float, int64_t>(ps.n_rows, ps.dim);
+    auto queries = raft::make_host_matrix<float, int64_t>(ps.n_queries, ps.dim);
+    for (size_t i = 0; i < dataset.size(); i++) {
+      dataset.data_handle()[i] = dist(rng);
+    }
+    for (size_t i = 0; i < queries.size(); i++) {
+      queries.data_handle()[i] = dist(rng);
+    }
+    auto neighbors = raft::make_host_matrix<int64_t, int64_t>(ps.n_queries, ps.k);
+    auto distances = raft::make_host_matrix<float, int64_t>(ps.n_queries, ps.k);
+
+    host_index<float> index(handle_, raft::make_const_mdspan(dataset.view()), ps.metric);
+    search(
+      handle_, index, raft::make_const_mdspan(queries.view()), neighbors.view(), distances.view());
+
+    // Compare the sorted distances with the exact ones, and recompute the distances of the
+    // returned neighbors, which does not depend on the order of ties.
+    const bool ip = ps.metric == cuvs::distance::DistanceType::InnerProduct;
+    std::vector<double> expected(ps.n_rows);
+    for (int64_t q = 0; q < ps.n_queries; q++) {
+      const float* query = queries.data_handle() + q * ps.dim;
+      for (int64_t i = 0; i < ps.n_rows; i++) {
+        expected[i] =
+          host_knn_reference(ps.metric, query, dataset.data_handle() + i * ps.dim, ps.dim);
+      }
+      if (ip) {
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+      } else {
+        std::sort(expected.begin(), expected.end());
+      }
+      for (int64_t j = 0; j < ps.k; j++) {
+        if (j >= ps.n_rows) {
+          ASSERT_EQ(neighbors(q, j), std::numeric_limits<int64_t>::max());
+          continue;
+        }
+        double tol = 1e-3 * (1.0 + std::abs(expected[j]));
+        ASSERT_NEAR(distances(q, j), expected[j], tol) << "query " << q << ", rank " << j;
+        ASSERT_GE(neighbors(q, j), 0);
+        ASSERT_LT(neighbors(q, j), ps.n_rows);
+        double recomputed = host_knn_reference(
+          ps.metric, query, dataset.data_handle() + neighbors(q, j) * ps.dim, ps.dim);
+        ASSERT_NEAR(recomputed, expected[j], tol) << "query " << q << ", rank " << j;
+      }
+    }
+  }
+
+  raft::resources handle_;
+};
+
+TEST_P(HostKNNTest, Result) { this->run(); }
+
+const std::vector<HostKNNInputs> host_inputs = [] {
+  std::vector<HostKNNInputs> inputs;
+  for (auto metric : {cuvs::distance::DistanceType::L2Expanded,
+                      cuvs::distance::DistanceType::L2SqrtExpanded,
+                      cuvs::distance::DistanceType::L2Unexpanded,
+                      cuvs::distance::DistanceType::InnerProduct,
+                      cuvs::distance::DistanceType::CosineExpanded,
+                      cuvs::distance::DistanceType::L1,
+                      cuvs::distance::DistanceType::Linf}) {
+    inputs.push_back({1000, 7, 33, 10, metric});
+    // Few queries: the dataset is split between the threads.
+    inputs.push_back({20000, 2, 128, 50, metric});
+    inputs.push_back({3000, 200, 96, 32, metric});
+    // Fewer rows than k.
+    inputs.push_back({5, 3, 4, 10, metric});
+  }
+  return inputs;
+}();
+
+INSTANTIATE_TEST_CASE_P(HostKNNTest, HostKNNTest, ::testing::ValuesIn(host_inputs));
+}  // namespace cuvs::neighbors::brute_force
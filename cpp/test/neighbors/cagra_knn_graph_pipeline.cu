@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../src/neighbors/detail/cagra/knn_graph_pipeline.hpp"
+
+#include <cuvs/distance/distance.hpp>
+#include <cuvs/neighbors/refine.hpp>
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/resources.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace cuvs::neighbors::cagra::detail {
+
+struct KnnGraphPipelineInputs {
+  size_t n_rows;
+  size_t batch_size;
+  size_t n_buffers;
+  size_t n_refine_threads;
+};
+
+::std::ostream& operator<<(::std::ostream& os, const KnnGraphPipelineInputs& p)
+{
+  os << "{n_rows=" << p.n_rows << ", batch_size=" << p.batch_size << ", n_buffers=" << p.n_buffers
+     << ", n_refine_threads=" << p.n_refine_threads << "}";
+  return os;
+}
+
+/*
+ * The kNN graph pipeline with a host stand-in for the IVF-PQ search: the search stage returns the
+ * exact candidates of each row in a shuffled order, the refine stage sorts them with the host
+ * refine and the writer drops the row itself, as in the CAGRA build.
+ */
+class KnnGraphPipelineTest : public ::testing::TestWithParam<KnnGraphPipelineInputs> {
+ protected:
+  static constexpr size_t kDim        = 8;
+  static constexpr size_t kDegree     = 8;
+  static constexpr size_t kTopK       = kDegree + 1;
+  static constexpr size_t kCandidates = 2 * kTopK;
+
+  void SetUp() override
+  {
+    ps_ = GetParam();
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    dataset_.resize(ps_.n_rows * kDim);
+    for (auto& v : dataset_) {
+      v = dist(rng);
+    }
+    // The exact candidates of each row, the row itself included.
+    candidates_.resize(ps_.n_rows * kCandidates);
+    std::vector<std::pair<float, int64_t>> row_dists(ps_.n_rows);
+    for (size_t i = 0; i < ps_.n_rows; i++) {
+      for (size_t j = 0; j < ps_.n_rows; j++) {
+        float d = 0;
+        for (size_t k = 0; k < kDim; k++) {
+          float diff = dataset_[i * kDim + k] - dataset_[j * kDim + k];
+          d += diff * diff;
+        }
+        row_dists[j] = {d, int64_t(j)};
+      }
+      std::partial_sort(row_dists.begin(), row_dists.begin() + kCandidates, row_dists.end());
+      for (size_t j = 0; j < kCandidates; j++) {
+        candidates_[i * kCandidates + j] = row_dists[j].second;
+      }
+    }
+  }
+
+  struct buffer {
+    std::vector<int64_t> neighbors;
+    std::vector<int64_t> refined_neighbors;
+    std::vector<float> refined_distances;
+  };
+
+  auto run(std::vector<uint32_t>& graph,
+           size_t throw_at_batch = std::numeric_limits<size_t>::max()) -> knn_graph_pipeline_stats
+  {
+    knn_graph_pipeline_params params{
+      ps_.n_rows, ps_.batch_size, ps_.n_buffers, ps_.n_refine_threads};
+    std::vector<buffer> buffers(std::max<size_t>(ps_.n_buffers, 2));
+    for (auto& b : buffers) {
+      b.neighbors.resize(ps_.batch_size * kCandidates);
+      b.refined_neighbors.resize(ps_.batch_size * kTopK);
+      b.refined_distances.resize(ps_.batch_size * kTopK);
+    }
+    std::vector<int> in_flight(buffers.size(), 0);
+    std::thread::id search_thread = std::this_thread::get_id();
+    size_t next_search_offset     = 0;
+
+    auto produce = [&](const knn_graph_batch& batch) {
+      // A buffer is produced again only once its previous batch is written.
+      ASSERT_EQ(in_flight[batch.buffer]++, 0);
+    };
+    auto search = [&](const knn_graph_batch& batch) {
+      ASSERT_EQ(std::this_thread::get_id(), search_thread);
+      ASSERT_EQ(batch.offset, next_search_offset);
+      next_search_offset += batch.size;
+      std::mt19937 rng(batch.offset);
+      auto* out = buffers[batch.buffer].neighbors.data();
+      std::copy(candidates_.begin() + batch.offset * kCandidates,
+                candidates_.begin() + (batch.offset + batch.size) * kCandidates,
+                out);
+      for (size_t i = 0; i < batch.size; i++) {
+        std::shuffle(out + i * kCandidates, out + (i + 1) * kCandidates, rng);
+      }
+    };
+    auto refine = [&](const knn_graph_batch& batch) {
+      if (batch.offset / ps_.batch_size == throw_at_batch) {
+        throw std::runtime_error("refine failed");
+      }
+      auto& b = buffers[batch.buffer];
+      cuvs::neighbors::refine(
+        res_,
+        raft::make_host_matrix_view<const float, int64_t>(dataset_.data(), ps_.n_rows, kDim),
+        raft::make_host_matrix_view<const float, int64_t>(
+          dataset_.data() + batch.offset * kDim, batch.size, kDim),
+        raft::make_host_matrix_view<const int64_t, int64_t>(
+          b.neighbors.data(), batch.size, kCandidates),
+        raft::make_host_matrix_view<int64_t, int64_t>(
+          b.refined_neighbors.data(), batch.size, kTopK),
+        raft::make_host_matrix_view<float, int64_t>(
+          b.refined_distances.data(), batch.size, kTopK),
+        cuvs::distance::DistanceType::L2Expanded);
+    };
+    auto write = [&](const knn_graph_batch& batch) {
+      const auto& b = buffers[batch.buffer];
+      for (size_t i = 0; i < batch.size; i++) {
+        const size_t row = batch.offset + i;
+        for (size_t j = 0, n = 0; j < kTopK && n < kDegree; j++) {
+          const auto v = b.refined_neighbors[i * kTopK + j];
+          if (size_t(v) != row) { graph[row * kDegree + n++] = uint32_t(v); }
+        }
+      }
+      in_flight[batch.buffer]--;
+    };
+    return run_knn_graph_pipeline(params, produce, search, refine, write);
+  }
+
+  raft::resources res_;
+  KnnGraphPipelineInputs ps_;
+  std::vector<float> dataset_;
+  std::vector<int64_t> candidates_;
+};
+
+TEST_P(KnnGraphPipelineTest, MatchesExactGraph)
+{
+  std::vector<uint32_t> graph(ps_.n_rows * kDegree, std::numeric_limits<uint32_t>::max());
+  auto stats = run(graph);
+
+  const size_t n_batches = (ps_.n_rows + ps_.batch_size - 1) / ps_.batch_size;
+  EXPECT_EQ(stats.produce.n_batches, n_batches);
+  EXPECT_EQ(stats.search.n_batches, n_batches);
+  EXPECT_EQ(stats.refine.n_batches, n_batches);
+  EXPECT_EQ(stats.write.n_batches, n_batches);
+  EXPECT_GE(stats.total_seconds, stats.search.busy_seconds);
+
+  // The refined lists are the exact ones: the neighbors are at non-decreasing distances, and the
+  // last one is not farther than the exact k-th neighbor.
+  for (size_t i = 0; i < ps_.n_rows; i++) {
+    auto dist = [&](uint32_t j) {
+      float d = 0;
+      for (size_t k = 0; k < kDim; k++) {
+        float diff = dataset_[i * kDim + k] - dataset_[size_t(j) * kDim + k];
+        d += diff * diff;
+      }
+      return d;
+    };
+    float previous = 0;
+    for (size_t j = 0; j < kDegree; j++) {
+      const auto v = graph[i * kDegree + j];
+      ASSERT_LT(v, ps_.n_rows) << "row " << i << ", neighbor " << j;
+      ASSERT_NE(v, i);
+      ASSERT_GE(dist(v), previous * (1 - 1e-5f));
+      previous = dist(v);
+    }
+    ASSERT_LE(previous, dist(uint32_t(candidates_[i * kCandidates + kDegree])) * (1 + 1e-5f));
+  }
+}
+
+TEST_P(KnnGraphPipelineTest, RethrowsStageErrors)
+{
+  std::vector<uint32_t> graph(ps_.n_rows * kDegree);
+  const size_t n_batches = (ps_.n_rows + ps_.batch_size - 1) / ps_.batch_size;
+  EXPECT_THROW(run(graph, n_batches / 2), std::runtime_error);
+}
+
+const std::vector<KnnGraphPipelineInputs> inputs = {{1000, 1000, 2, 1},
+                                                    {1000, 64, 2, 1},
+                                                    {1500, 100, 4, 2},
+                                                    {2000, 128, 8, 4},
+                                                    {777, 13, 3, 8}};
+
+INSTANTIATE_TEST_CASE_P(KnnGraphPipelineTest, KnnGraphPipelineTest, ::testing::ValuesIn(inputs));
+
+TEST(KnnGraphPipeline, BoundedQueue)
+{
+  bounded_queue<int> queue(2);
+  constexpr int kItems = 10000;
+  std::atomic<long> sum{0};
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < 3; c++) {
+    consumers.emplace_back([&]() {
+      while (auto item = queue.pop()) {
+        sum += *item;
+      }
+    });
+  }
+  for (int i = 1; i <= kItems; i++) {
+    ASSERT_TRUE(queue.push(i));
+  }
+  queue.close();
+  for (auto& t : consumers) {
+    t.join();
+  }
+  EXPECT_EQ(sum.load(), long(kItems) * (kItems + 1) / 2);
+  EXPECT_FALSE(queue.push(0));
+  EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(KnnGraphPipeline, ChooseBatchSize)
+{
+  constexpr size_t kGiB = size_t{1} << 30;
+  // Plenty of memory: the maximum, or all the rows.
+  EXPECT_EQ(choose_knn_graph_batch_size(size_t{1} << 30, 1024, 2048, 4, 16 * kGiB, 64 * kGiB),
+            65536u);
+  EXPECT_EQ(choose_knn_graph_batch_size(1000, 1024, 2048, 4, 16 * kGiB, 64 * kGiB), 1000u);
+  // Limited by the device: a quarter of 64 MiB over 1 KiB per row.
+  EXPECT_EQ(choose_knn_graph_batch_size(size_t{1} << 30, 1024, 2048, 4, kGiB / 16, 64 * kGiB),
+            16384u);
+  // Limited by the host: an eighth of 256 MiB over 4 buffers of 2 KiB per row.
+  EXPECT_EQ(choose_knn_graph_batch_size(size_t{1} << 30, 1024, 2048, 4, 16 * kGiB, kGiB / 4),
+            4096u);
+  // Never below the minimum, and a multiple of it.
+  EXPECT_EQ(choose_knn_graph_batch_size(size_t{1} << 30, 1024, 2048, 4, 1 << 20, 1 << 20), 128u);
+  EXPECT_EQ(choose_knn_graph_batch_size(size_t{1} << 30, 1000, 0, 4, 1000 * 1000, 0) % 128, 0u);
+}
+
+}  // namespace cuvs::neighbors::cagra::detail
@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../src/neighbors/detail/container_serialize.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace cuvs::neighbors::detail {
+
+namespace {
+
+/** An output that cannot seek, like the payload of a section. */
+struct append_only_buf : public std::streambuf {
+  std::string data;
+
+ protected:
+  auto overflow(int_type ch) -> int_type override
+  {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      data.push_back(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+  }
+  auto xsputn(const char* s, std::streamsize n) -> std::streamsize override
+  {
+    data.append(s, n);
+    return n;
+  }
+};
+
+constexpr uint32_t kListBytes = 100000;
+
+auto list_payload(uint64_t id) -> std::string
+{
+  std::string s(kListBytes - id, '\0');
+  for (size_t i = 0; i < s.size(); i++) {
+    s[i] = static_cast<char>((i * 31 + id) & 0xff);
+  }
+  return s;
+}
+
+void write_test_container(std::ostream& os, bool with_optional_section)
+{
+  container_writer w(os, "test", 2);
+  w.section("params", 0, kSectionRequired, [](std::ostream& s) {
+    uint32_t x = 42;
+    s.write(reinterpret_cast<const char*>(&x), sizeof(x));
+    s << "a field appended by a newer version";
+  });
+  if (with_optional_section) {
+    w.section("hint", 0, 0, [](std::ostream& s) { s << "ignored by the readers"; });
+  }
+  for (uint64_t id = 0; id < 3; id++) {
+    w.section("list", id, kSectionRequired, [&](std::ostream& s) { s << list_payload(id); });
+  }
+  w.section("nested", 0, kSectionRequired, [](std::ostream& s) {
+    container_writer inner(s, "inner", 1);
+    inner.section("value", 0, kSectionRequired, [](std::ostream& p) { p << "hello"; });
+    inner.finish();
+  });
+  w.finish();
+}
+
+/** Read the test container and return the number of visited sections. */
+auto read_test_container(std::istream& is) -> int
+{
+  auto prefix = read_container_prefix(is);
+  EXPECT_TRUE(is_container(prefix));
+  container_reader reader(is, prefix, "test", 2);
+  EXPECT_EQ(reader.schema_version(), 2u);
+  int visited = 0;
+  reader.read_sections([&](const section_info& s, std::istream& payload) {
+    if (s.is("params")) {
+      uint32_t x = 0;
+      payload.read(reinterpret_cast<char*>(&x), sizeof(x));
+      EXPECT_EQ(x, 42u);
+    } else if (s.is("list")) {
+      std::string data(kListBytes - s.id, '\0');
+      payload.read(data.data(), data.size());
+      EXPECT_EQ(data, list_payload(s.id));
+    } else if (s.is("nested")) {
+      auto inner_prefix = read_container_prefix(payload);
+      container_reader inner(payload, inner_prefix, "inner", 1);
+      inner.read_sections([](const section_info&, std::istream& p) {
+        std::string value;
+        p >> value;
+        EXPECT_EQ(value, "hello");
+        return true;
+      });
+    } else {
+      return false;
+    }
+    visited++;
+    return true;
+  });
+  reader.require_sections("test", {"params", "list", "nested"});
+  EXPECT_EQ(reader.count_sections("list"), 3u);
+  return visited;
+}
+
+/** Read all sections without looking into the payloads. */
+void read_all_sections(const std::string& container)
+{
+  std::istringstream is(container);
+  auto prefix = read_container_prefix(is);
+  container_reader reader(is, prefix, "test", 2);
+  reader.read_sections([](const section_info&, std::istream&) { return true; });
+}
+
+auto test_container(bool with_optional_section = true) -> std::string
+{
+  std::ostringstream os;
+  write_test_container(os, with_optional_section);
+  return os.str();
+}
+
+auto encode(const section_encoding& encoding, const std::string& raw) -> std::string
+{
+  std::stringbuf sink(std::ios::out | std::ios::binary);
+  encoding_writebuf buf(&sink, encoding);
+  std::ostream os(&buf);
+  os.write(raw.data(), raw.size());
+  buf.finish();
+  EXPECT_FALSE(buf.failed());
+  return sink.str();
+}
+
+/** Decode a payload, reading it `chunk` bytes at a time. */
+auto decode(const std::string& encoded, size_t chunk = 2 * kCodecBlockBytes + 123) -> std::string
+{
+  std::stringbuf source(encoded, std::ios::in | std::ios::binary);
+  decoding_readbuf buf(&source, encoded.size());
+  std::istream is(&buf);
+  is.exceptions(std::ios::badbit);
+  std::string raw;
+  std::string part(chunk, '\0');
+  while (is.read(part.data(), part.size()) || is.gcount() > 0) {
+    raw.append(part.data(), is.gcount());
+  }
+  return raw;
+}
+
+/** Rows of graph neighbor ids below `n_rows`, with a few trailing bytes. */
+auto graph_payload(uint32_t n_rows, uint32_t degree) -> std::string
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint32_t> dist(0, n_rows - 1);
+  std::vector<uint32_t> ids(size_t(n_rows) * degree);
+  for (auto& id : ids) {
+    id = dist(rng);
+  }
+  return std::string(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(uint32_t)) +
+         "abc";
+}
+
+/**
+ * Decode a damaged payload, both through reads of `whole_read` bytes, which cover whole blocks,
+ * and through partial reads; returns whether the decoder rejected it. Any error but a
+ * raft::logic_error fails the test.
+ */
+auto decode_rejects(const std::string& encoded, size_t whole_read = 2 * kCodecBlockBytes + 123)
+  -> bool
+{
+  bool rejected = false;
+  for (size_t chunk : {whole_read, size_t(4093)}) {
+    try {
+      decode(encoded, chunk);
+    } catch (const raft::logic_error&) {
+      rejected = true;
+    }
+  }
+  return rejected;
+}
+
+/** The offsets of the block headers of an encoded payload, and its size. */
+auto block_offsets(const std::string& encoded) -> std::vector<size_t>
+{
+  std::vector<size_t> offsets;
+  size_t offset = sizeof(codec_header);
+  while (offset < encoded.size()) {
+    offsets.push_back(offset);
+    codec_block_header h;
+    std::memcpy(&h, encoded.data() + offset, sizeof(h));
+    offset += sizeof(h) + h.encoded_bytes;
+  }
+  EXPECT_EQ(offset, encoded.size());
+  offsets.push_back(offset);
+  return offsets;
+}
+
+/** Float vectors around a few cluster centers, and zero padding. */
+auto vector_payload(size_t n, uint32_t dim) -> std::string
+{
+  std::mt19937 rng(7);
+  std::normal_distribution<float> dist(0.0f, 1.0f);
+  std::vector<float> data(n * dim, 0.0f);
+  for (size_t i = 0; i < n * dim * 3 / 4; i++) {
+    data[i] = 10.0f * float(i % dim) + dist(rng);
+  }
+  return std::string(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+}
+
+}  // namespace
+
+TEST(ContainerSerialize, Checksum)
+{
+  crc32c crc;
+  crc.update("123456789", 9);
+  EXPECT_EQ(crc.value(), 0xe3069283u);
+}
+
+TEST(ContainerSerialize, RoundTrip)
+{
+  // The optional section is skipped, trailing bytes of a section are ignored.
+  std::istringstream is(test_container() + "next");
+  EXPECT_EQ(read_test_container(is), 5);
+  // The reader stops at the end of the container.
+  std::string rest;
+  is >> rest;
+  EXPECT_EQ(rest, "next");
+}
+
+TEST(ContainerSerialize, NonSeekableOutput)
+{
+  append_only_buf buf;
+  std::ostream os(&buf);
+  write_test_container(os, false);
+  EXPECT_EQ(buf.data, test_container(false));
+  std::istringstream is(buf.data);
+  EXPECT_EQ(read_test_container(is), 5);
+}
+
+TEST(ContainerSerialize, TableOfContents)
+{
+  std::istringstream is(test_container());
+  auto toc = read_container_toc(is, "test", 2);
+  EXPECT_EQ(toc.schema_version, 2u);
+  ASSERT_EQ(toc.sections.size(), 6u);
+  EXPECT_EQ(toc.find("list", 3), nullptr);
+  auto* list = toc.find("list", 2);
+  ASSERT_NE(list, nullptr);
+  EXPECT_EQ(list->size, kListBytes - 2);
+  EXPECT_TRUE(list->required());
+  EXPECT_FALSE(toc.find("hint")->required());
+  std::string data;
+  read_container_section(is, toc, *list, [&](std::istream& payload) {
+    data.resize(list->size);
+    payload.read(data.data(), data.size());
+  });
+  EXPECT_EQ(data, list_payload(2));
+}
+
+TEST(ContainerSerialize, LegacyPrefix)
+{
+  std::istringstream is(std::string("<f4") + '\0' + "legacy index");
+  EXPECT_FALSE(is_container(read_container_prefix(is)));
+}
+
+TEST(ContainerSerialize, Errors)
+{
+  auto good = test_container();
+
+  auto corrupted = good;
+  corrupted[corrupted.size() / 2] ^= 1;
+  EXPECT_THROW(read_all_sections(corrupted), raft::logic_error);
+  EXPECT_THROW(read_all_sections(good.substr(0, good.size() / 3)), raft::logic_error);
+  EXPECT_NO_THROW(read_all_sections(good));
+
+  std::ostringstream os;
+  container_writer w(os, "test", 2);
+  w.section("future", 0, kSectionRequired, [](std::ostream& s) { s << "x"; });
+  w.finish();
+  std::istringstream is_unknown(os.str());
+  EXPECT_THROW(read_test_container(is_unknown), raft::logic_error);
+
+  std::istringstream is_newer(good);
+  auto prefix = read_container_prefix(is_newer);
+  EXPECT_THROW(container_reader(is_newer, prefix, "test", 1), raft::logic_error);
+
+  std::istringstream is_other_kind(good);
+  prefix = read_container_prefix(is_other_kind);
+  EXPECT_THROW(container_reader(is_other_kind, prefix, "ivf_pq", 2), raft::logic_error);
+}
+
+TEST(ContainerSerialize, Codecs)
+{
+  const section_encoding delta32{section_codec::kDeltaVarint, 4};
+  const section_encoding delta64{section_codec::kDeltaVarint, 8};
+  const section_encoding shuffle4{section_codec::kShuffleLz, 4};
+  const section_encoding shuffle1{section_codec::kShuffleLz, 1};
+
+  // Beyond a block, with a partial last block.
+  auto graph   = graph_payload(100000, 32);
+  auto vectors = vector_payload(40000, 40);
+  std::string random(3 * kCodecBlockBytes / 2, '\0');
+  std::mt19937 rng(1);
+  for (auto& c : random) {
+    c = static_cast<char>(rng());
+  }
+
+  for (const auto& encoding : {delta32, delta64, shuffle4, shuffle1}) {
+    for (const auto* raw : {&graph, &vectors, &random}) {
+      EXPECT_EQ(decode(encode(encoding, *raw)), *raw);
+    }
+    // Reads ending within the blocks.
+    EXPECT_EQ(decode(encode(encoding, graph), 4093), graph);
+    EXPECT_EQ(decode(encode(encoding, "")), "");
+    EXPECT_EQ(decode(encode(encoding, "xyz")), "xyz");
+    // Incompressible data is stored as is, with the block headers only.
+    EXPECT_LE(encode(encoding, random).size(), random.size() + 64);
+  }
+  EXPECT_LT(encode(delta32, graph).size(), graph.size() * 4 / 5);
+  EXPECT_LT(encode(shuffle4, vectors).size(), vectors.size() * 3 / 4);
+  EXPECT_LT(encode(shuffle1, std::string(100000, 'a')).size(), 1000u);
+
+  EXPECT_THROW(encode(section_encoding{section_codec::kDeltaVarint, 2}, graph), raft::logic_error);
+  auto corrupted = encode(delta32, graph);
+  corrupted.resize(corrupted.size() - 1);
+  EXPECT_THROW(decode(corrupted), raft::logic_error);
+}
+
+TEST(ContainerSerialize, DamagedCodecBlocks)
+{
+  const section_encoding delta32{section_codec::kDeltaVarint, 4};
+  const section_encoding delta64{section_codec::kDeltaVarint, 8};
+  const section_encoding shuffle4{section_codec::kShuffleLz, 4};
+  const section_encoding shuffle1{section_codec::kShuffleLz, 1};
+  auto graph   = graph_payload(512, 32);
+  auto vectors = vector_payload(1000, 16);
+
+  for (const auto& encoding : {delta32, delta64, shuffle4, shuffle1}) {
+    for (const auto* raw : {&graph, &vectors}) {
+      const auto encoded = encode(encoding, *raw);
+      ASSERT_EQ(block_offsets(encoded).size(), 2u);
+      ASSERT_LT(encoded.size(), raw->size());
+
+      // A payload of one block truncated anywhere but before the block is rejected.
+      for (size_t size = 0; size < encoded.size(); size += size < 64 ? 1 : 97) {
+        EXPECT_EQ(decode_rejects(encoded.substr(0, size), raw->size()),
+                  size != sizeof(codec_header))
+          << "truncated to " << size << " bytes";
+      }
+
+      // Out-of-range header fields are rejected.
+      for (size_t word = 0; word < 4; word++) {
+        auto damaged = encoded;
+        damaged[word * sizeof(uint32_t) + 3] ^= 0x80;
+        EXPECT_TRUE(decode_rejects(damaged, raw->size())) << "header word " << word;
+      }
+
+      // Other changes are rejected or decode to some bytes, within bounds; the container
+      // detects them by the checksum.
+      for (size_t pos = 0; pos < encoded.size(); pos += 61) {
+        for (uint8_t bit : {0x01, 0x10, 0x80}) {
+          auto damaged = encoded;
+          damaged[pos] ^= bit;
+          decode_rejects(damaged, raw->size());
+        }
+      }
+    }
+  }
+
+  // A payload truncated at a block boundary decodes to the whole blocks before it, within a block
+  // it is rejected.
+  auto large   = graph_payload(100000, 32);
+  auto encoded = encode(delta32, large);
+  auto offsets = block_offsets(encoded);
+  ASSERT_GT(offsets.size(), 3u);
+  for (size_t b = 0; b + 1 < offsets.size(); b++) {
+    auto prefix = decode(encoded.substr(0, offsets[b]));
+    EXPECT_EQ(prefix, large.substr(0, prefix.size()));
+    EXPECT_LT(prefix.size(), large.size());
+    for (size_t cut : {size_t(1), sizeof(codec_block_header), sizeof(codec_block_header) + 1}) {
+      EXPECT_TRUE(decode_rejects(encoded.substr(0, offsets[b] + cut)));
+    }
+  }
+
+  // In a container, a damaged or truncated encoded section is reported, whether the decoder
+  // fails or not.
+  std::ostringstream os;
+  container_writer w(os, "test", 2);
+  w.section("vectors", 0, kSectionRequired, shuffle4, [&](std::ostream& s) { s << vectors; });
+  w.finish();
+  const auto container = os.str();
+  auto read_vectors    = [&](const std::string& c) {
+    std::istringstream is(c);
+    auto prefix = read_container_prefix(is);
+    container_reader reader(is, prefix, "test", 2);
+    reader.read_sections([&](const section_info&, std::istream& payload) {
+      std::string data(vectors.size(), '\0');
+      payload.read(data.data(), data.size());
+      return true;
+    });
+  };
+  EXPECT_NO_THROW(read_vectors(container));
+  const size_t payload_begin = sizeof(container_header) + sizeof(section_header);
+  for (size_t pos = payload_begin; pos < payload_begin + 64; pos++) {
+    auto damaged = container;
+    damaged[pos] ^= 0x80;
+    EXPECT_THROW(read_vectors(damaged), raft::logic_error) << "byte " << pos;
+    EXPECT_THROW(read_vectors(container.substr(0, pos)), raft::logic_error) << "size " << pos;
+  }
+}
+
+TEST(ContainerSerialize, EncodedSections)
+{
+  const section_encoding encoding{section_codec::kShuffleLz, 4};
+  auto vectors = vector_payload(1000, 16);
+  auto write   = [&](std::ostream& os) {
+    container_writer w(os, "test", 2);
+    w.section("params", 0, kSectionRequired, [](std::ostream& s) { s << "p"; });
+    for (uint64_t id = 0; id < 3; id++) {
+      w.section("list", id, kSectionRequired, encoding, [&](std::ostream& s) {
+        s << list_payload(id);
+      });
+    }
+    w.section("vectors", 0, kSectionRequired, encoding, [&](std::ostream& s) { s << vectors; });
+    w.finish();
+  };
+  std::ostringstream os;
+  write(os);
+  auto container = os.str();
+  EXPECT_LT(container.size(), vectors.size());
+
+  // The payload of a non-seekable output is staged, with the same result.
+  append_only_buf buf;
+  std::ostream append_only(&buf);
+  write(append_only);
+  EXPECT_EQ(buf.data, container);
+
+  std::istringstream is(container);
+  auto prefix = read_container_prefix(is);
+  container_reader reader(is, prefix, "test", 2);
+  int lists = 0;
+  reader.read_sections([&](const section_info& s, std::istream& payload) {
+    if (s.is("list")) {
+      EXPECT_TRUE(s.encoded());
+      std::string data(kListBytes - s.id, '\0');
+      payload.read(data.data(), data.size());
+      EXPECT_EQ(data, list_payload(s.id));
+      lists++;
+    } else if (s.is("vectors")) {
+      std::string data(vectors.size(), '\0');
+      payload.read(data.data(), data.size());
+      EXPECT_EQ(data, vectors);
+    }
+    return true;
+  });
+  EXPECT_EQ(lists, 3);
+
+  std::istringstream is_toc(container);
+  auto toc     = read_container_toc(is_toc, "test", 2);
+  auto* vector = toc.find("vectors");
+  ASSERT_NE(vector, nullptr);
+  EXPECT_LT(vector->size, vectors.size());
+  std::string data;
+  read_container_section(is_toc, toc, *vector, [&](std::istream& payload) {
+    data.resize(vectors.size());
+    payload.read(data.data(), data.size());
+  });
+  EXPECT_EQ(data, vectors);
+
+  auto corrupted = container;
+  corrupted[toc.find("list", 1)->offset + sizeof(section_header) + 20] ^= 1;
+  EXPECT_THROW(read_all_sections(corrupted), raft::logic_error);
+}
+
+}  // namespace cuvs::neighbors::detail
@@ -35,13 +35,18 @@ RAFT_KERNEL naive_distance_kernel(EvalT* dist,
                                   IdxT m,
                                   IdxT n,
                                   IdxT k,
-                                  cuvs::distance::DistanceType metric)
+                                  cuvs::distance::DistanceType metric,
+                                  EvalT metric_arg)
 {
   IdxT midx = IdxT(threadIdx.x) + IdxT(blockIdx.x) * IdxT(blockDim.x);
   if (midx >= m) return;
   IdxT grid_size = IdxT(blockDim.y) * IdxT(gridDim.y);
   for (IdxT nidx = threadIdx.y + blockIdx.y * blockDim.y; nidx < n; nidx += grid_size) {
-    EvalT acc = EvalT(0);
+    EvalT acc    = EvalT(0);
+    EvalT x_norm = EvalT(0);
+    EvalT y_norm = EvalT(0);
+    EvalT x_sum  = EvalT(0);
+    EvalT y_sum  = EvalT(0);
     for (IdxT i = 0; i < k; ++i) {
       IdxT xidx = i + midx * k;
       IdxT yidx = i + nidx * k;
@@ -58,6 +63,51 @@ RAFT_KERNEL naive_distance_kernel(EvalT* dist,
           auto diff = xv - yv;
           acc += diff * diff;
         } break;
+        case cuvs::distance::DistanceType::CosineExpanded: {
+          acc += xv * yv;
+          x_norm += xv * xv;
+          y_norm += yv * yv;
+        } break;
+        case cuvs::distance::DistanceType::L1: {
+          acc += raft::abs(xv - yv);
+        } break;
+        case cuvs::distance::DistanceType::Linf: {
+          acc = raft::max(acc, raft::abs(xv - yv));
+        } break;
+        case cuvs::distance::DistanceType::HammingUnexpanded: {
+          acc += EvalT(xv != yv);
+        } break;
+        case cuvs::distance::DistanceType::CorrelationExpanded: {
+          acc += xv * yv;
+          x_norm += xv * xv;
+          y_norm += yv * yv;
+          x_sum += xv;
+          y_sum += yv;
+        } break;
+        case cuvs::distance::DistanceType::LpUnexpanded: {
+          acc += raft::pow(raft::abs(xv - yv), metric_arg);
+        } break;
+        case cuvs::distance::DistanceType::Canberra: {
+          auto add = raft::abs(xv) + raft::abs(yv);
+          if (add != EvalT(0)) { acc += raft::abs(xv - yv) / add; }
+        } break;
+        case cuvs::distance::DistanceType::HellingerExpanded: {
+          acc += raft::sqrt(xv) * raft::sqrt(yv);
+        } break;
+        case cuvs::distance::DistanceType::JensenShannon: {
+          auto mid   = EvalT(0.5) * (xv + yv);
+          auto log_m = mid != EvalT(0) ? raft::log(mid) : EvalT(0);
+          if (xv != EvalT(0)) { acc += -xv * (log_m - raft::log(xv)); }
+          if (yv != EvalT(0)) { acc += -yv * (log_m - raft::log(yv)); }
+        } break;
+        case cuvs::distance::DistanceType::KLDivergence: {
+          if (xv != EvalT(0)) {
+            acc += xv * (raft::log(xv) - (yv != EvalT(0) ? raft::log(yv) : EvalT(0)));
+          }
+        } break;
+        case cuvs::distance::DistanceType::RusselRaoExpanded: {
+          acc += xv * yv;
+        } break;
         default: break;
       }
     }
@@ -66,6 +116,33 @@ RAFT_KERNEL naive_distance_kernel(EvalT* dist,
       case cuvs::distance::DistanceType::L2SqrtUnexpanded: {
         acc = raft::sqrt(acc);
       } break;
+      case cuvs::distance::DistanceType::CosineExpanded: {
+        acc = EvalT(1) - acc / raft::sqrt(x_norm * y_norm);
+      } break;
+      case cuvs::distance::DistanceType::HammingUnexpanded: {
+        acc /= EvalT(k);
+      } break;
+      case cuvs::distance::DistanceType::CorrelationExpanded: {
+        auto len   = EvalT(k);
+        auto numer = len * acc - x_sum * y_sum;
+        auto denom = raft::sqrt((len * x_norm - x_sum * x_sum) * (len * y_norm - y_sum * y_sum));
+        acc        = denom > EvalT(0) ? EvalT(1) - numer / denom : EvalT(1);
+      } break;
+      case cuvs::distance::DistanceType::LpUnexpanded: {
+        acc = raft::pow(acc, EvalT(1) / metric_arg);
+      } break;
+      case cuvs::distance::DistanceType::HellingerExpanded: {
+        acc = raft::sqrt(raft::max(EvalT(1) - acc, EvalT(0)));
+      } break;
+      case cuvs::distance::DistanceType::JensenShannon: {
+        acc = raft::sqrt(EvalT(0.5) * acc);
+      } break;
+      case cuvs::distance::DistanceType::KLDivergence: {
+        acc *= EvalT(0.5);
+      } break;
+      case cuvs::distance::DistanceType::RusselRaoExpanded: {
+        acc = (EvalT(k) - acc) / EvalT(k);
+      } break;
       default: break;
     }
     dist[midx * n + nidx] = acc;
@@ -75,6 +152,8 @@ RAFT_KERNEL naive_distance_kernel(EvalT* dist,
 /**
  * Naive, but flexible bruteforce KNN search.
  *
+ * `metric_arg` is the exponent p of the LpUnexpanded metric.
+ *
  * TODO: either replace this with brute_force_knn or with distance+select_k
  *       when either distance or brute_force_knn support 8-bit int inputs.
  */
@@ -88,7 +167,8 @@ void naive_knn(raft::resources const& handle,
                size_t input_len,
                size_t dim,
                uint32_t k,
-               cuvs::distance::DistanceType type)
+               cuvs::distance::DistanceType type,
+               EvalT metric_arg = EvalT(2))
 {
   rmm::mr::device_memory_resource* mr = rmm::mr::get_current_device_resource();
 
@@ -108,7 +188,7 @@ void naive_knn(raft::resources const& handle,
     dim3 grid_dim(raft::ceildiv<size_t>(batch_size, block_dim.x), grid_y, 1);
 
     naive_distance_kernel<EvalT, DataT, IdxT><<<grid_dim, block_dim, 0, stream>>>(
-      dist.data(), x + offset * dim, y, batch_size, input_len, dim, type);
+      dist.data(), x + offset * dim, y, batch_size, input_len, dim, type, metric_arg);
 
     raft::matrix::detail::select_k<EvalT, IdxT>(handle,
                                                 dist.data(),
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include "../../src/core/mmap.hpp"
+#include "../../src/neighbors/refine/refine_host.hpp"
 #include "../test_utils.cuh"
 #include "ann_utils.cuh"
 #include "refine_helper.cuh"
@@ -30,6 +32,12 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
 #include <vector>
 
 namespace cuvs::neighbors {
@@ -57,7 +65,8 @@ class RefineTest : public ::testing::TestWithParam<RefineInputs<IdxT>> {
                               data.candidates_host.view(),
                               data.refined_indices_host.view(),
                               data.refined_distances_host.view(),
-                              data.p.metric);
+                              data.p.metric,
+                              data.p.metric_arg);
       raft::copy(indices.data(),
                  data.refined_indices_host.data_handle(),
                  data.refined_indices_host.size(),
@@ -112,16 +121,219 @@ const std::vector<RefineInputs<int64_t>> inputs =
     {cuvs::distance::DistanceType::L2Expanded, cuvs::distance::DistanceType::InnerProduct},
     {false, true});
 
+// Metrics supported only by the host implementation of refine.
+const std::vector<RefineInputs<int64_t>> inputs_host =
+  raft::util::itertools::product<RefineInputs<int64_t>>(
+    {static_cast<int64_t>(137)},
+    {static_cast<int64_t>(1000)},
+    {static_cast<int64_t>(16)},
+    {static_cast<int64_t>(1), static_cast<int64_t>(10), static_cast<int64_t>(33)},
+    {static_cast<int64_t>(33)},
+    {cuvs::distance::DistanceType::L2SqrtExpanded,
+     cuvs::distance::DistanceType::CosineExpanded,
+     cuvs::distance::DistanceType::L1,
+     cuvs::distance::DistanceType::Linf,
+     cuvs::distance::DistanceType::HammingUnexpanded,
+     cuvs::distance::DistanceType::CorrelationExpanded,
+     cuvs::distance::DistanceType::LpUnexpanded,
+     cuvs::distance::DistanceType::Canberra,
+     cuvs::distance::DistanceType::RusselRaoExpanded},
+    {true});
+
+// The Lp metric with other exponents than 2.
+const std::vector<RefineInputs<int64_t>> inputs_host_lp =
+  raft::util::itertools::product<RefineInputs<int64_t>>(
+    {static_cast<int64_t>(137)},
+    {static_cast<int64_t>(1000)},
+    {static_cast<int64_t>(16)},
+    {static_cast<int64_t>(1), static_cast<int64_t>(10), static_cast<int64_t>(33)},
+    {static_cast<int64_t>(33)},
+    {cuvs::distance::DistanceType::LpUnexpanded},
+    {true},
+    {1.5f, 3.0f});
+
+// Metrics on probability distributions, the data are non-negative rows summing to one.
+const std::vector<RefineInputs<int64_t>> inputs_host_probability =
+  raft::util::itertools::product<RefineInputs<int64_t>>(
+    {static_cast<int64_t>(137)},
+    {static_cast<int64_t>(1000)},
+    {static_cast<int64_t>(16)},
+    {static_cast<int64_t>(1), static_cast<int64_t>(10), static_cast<int64_t>(33)},
+    {static_cast<int64_t>(33)},
+    {cuvs::distance::DistanceType::HellingerExpanded,
+     cuvs::distance::DistanceType::JensenShannon,
+     cuvs::distance::DistanceType::KLDivergence},
+    {true});
+
 typedef RefineTest<float, float, std::int64_t> RefineTestF;
 TEST_P(RefineTestF, AnnRefine) { this->testRefine(); }
 
 INSTANTIATE_TEST_CASE_P(RefineTest, RefineTestF, ::testing::ValuesIn(inputs));
+INSTANTIATE_TEST_CASE_P(RefineHostTest, RefineTestF, ::testing::ValuesIn(inputs_host));
+INSTANTIATE_TEST_CASE_P(RefineHostLpTest, RefineTestF, ::testing::ValuesIn(inputs_host_lp));
+INSTANTIATE_TEST_CASE_P(RefineHostProbabilityTest,
+                        RefineTestF,
+                        ::testing::ValuesIn(inputs_host_probability));
 
 typedef RefineTest<uint8_t, float, std::int64_t> RefineTestF_uint8;
 TEST_P(RefineTestF_uint8, AnnRefine) { this->testRefine(); }
 INSTANTIATE_TEST_CASE_P(RefineTest, RefineTestF_uint8, ::testing::ValuesIn(inputs));
+INSTANTIATE_TEST_CASE_P(RefineHostTest, RefineTestF_uint8, ::testing::ValuesIn(inputs_host));
+INSTANTIATE_TEST_CASE_P(RefineHostLpTest, RefineTestF_uint8, ::testing::ValuesIn(inputs_host_lp));
 
 typedef RefineTest<int8_t, float, std::int64_t> RefineTestF_int8;
 TEST_P(RefineTestF_int8, AnnRefine) { this->testRefine(); }
 INSTANTIATE_TEST_CASE_P(RefineTest, RefineTestF_int8, ::testing::ValuesIn(inputs));
+INSTANTIATE_TEST_CASE_P(RefineHostTest, RefineTestF_int8, ::testing::ValuesIn(inputs_host));
+INSTANTIATE_TEST_CASE_P(RefineHostLpTest, RefineTestF_int8, ::testing::ValuesIn(inputs_host_lp));
+
+/*
+ * The host refine against a memory-mapped dataset file, reading the rows in storage order, gives
+ * the same result as reading them query by query from memory.
+ */
+TEST(RefineHost, StorageOrderMappedFile)
+{
+  constexpr int64_t n_rows = 5000, dim = 24, n_queries = 40, k0 = 64, k = 10;
+  std::mt19937 rng(42);
+  std::normal_distribution<float> normal;
+  std::uniform_int_distribution<int64_t> row(0, n_rows - 1);
+  std::vector<float> dataset(n_rows * dim), queries(n_queries * dim);
+  for (auto& v : dataset) {
+    v = normal(rng);
+  }
+  for (auto& v : queries) {
+    v = normal(rng);
+  }
+  // Random candidates, with an invalid one per query.
+  std::vector<int64_t> candidates(n_queries * k0);
+  for (auto& c : candidates) {
+    c = row(rng);
+  }
+  for (int64_t i = 0; i < n_queries; i++) {
+    candidates[i * k0 + i % k0] = std::numeric_limits<int64_t>::max();
+  }
+
+  const std::string path = make_temp_file("refine_dataset");
+  {
+    std::ofstream of(path, std::ios::binary);
+    of.write(reinterpret_cast<const char*>(dataset.data()), dataset.size() * sizeof(float));
+  }
+  cuvs::core::detail::mapped_file mapped(path);
+  std::remove(path.c_str());
+  ASSERT_EQ(mapped.size(), dataset.size() * sizeof(float));
+  const auto* mapped_dataset = reinterpret_cast<const float*>(mapped.data());
+
+  auto queries_view =
+    raft::make_host_matrix_view<const float, int64_t>(queries.data(), n_queries, dim);
+  auto candidates_view =
+    raft::make_host_matrix_view<const int64_t, int64_t>(candidates.data(), n_queries, k0);
+  for (auto metric : {cuvs::distance::DistanceType::L2Expanded,
+                      cuvs::distance::DistanceType::InnerProduct,
+                      cuvs::distance::DistanceType::CosineExpanded}) {
+    std::vector<int64_t> indices_memory(n_queries * k), indices_mapped(n_queries * k);
+    std::vector<float> distances_memory(n_queries * k), distances_mapped(n_queries * k);
+    detail::refine_host(
+      raft::make_host_matrix_view<const float, int64_t>(dataset.data(), n_rows, dim),
+      queries_view,
+      candidates_view,
+      raft::make_host_matrix_view<int64_t, int64_t>(indices_memory.data(), n_queries, k),
+      raft::make_host_matrix_view<float, int64_t>(distances_memory.data(), n_queries, k),
+      metric,
+      2.0f,
+      nullptr,
+      detail::refine_access_order::kQuery);
+    detail::refine_host(
+      raft::make_host_matrix_view<const float, int64_t>(mapped_dataset, n_rows, dim),
+      queries_view,
+      candidates_view,
+      raft::make_host_matrix_view<int64_t, int64_t>(indices_mapped.data(), n_queries, k),
+      raft::make_host_matrix_view<float, int64_t>(distances_mapped.data(), n_queries, k),
+      metric,
+      2.0f,
+      nullptr,
+      detail::refine_access_order::kStorage);
+    ASSERT_EQ(indices_memory, indices_mapped);
+    ASSERT_EQ(distances_memory, distances_mapped);
+  }
+
+  // Small windows: the candidates are spread over many windows, each read ahead separately.
+  auto& kernels = cuvs::distance::detail::host::get_distance_kernels<float>();
+  auto l2       = [&](size_t i, int64_t id) {
+    return kernels.l2(queries.data() + i * dim, mapped_dataset + id * dim, dim);
+  };
+  std::vector<float> out(n_queries * k0);
+  detail::compute_distances_in_storage_order(
+    mapped_dataset, n_rows, dim, candidates.data(), n_queries, k0, out.data(), l2, 4, 4096);
+  for (int64_t i = 0; i < n_queries; i++) {
+    for (int64_t j = 0; j < k0; j++) {
+      const auto id = candidates[i * k0 + j];
+      const float expected =
+        id < n_rows ? kernels.l2(queries.data() + i * dim, dataset.data() + id * dim, dim)
+                    : std::numeric_limits<float>::max();
+      ASSERT_EQ(out[i * k0 + j], expected) << "query " << i << ", candidate " << j;
+    }
+  }
+}
+
+/*
+ * The cosine refine through the public API gives the same result with the dataset norms passed by
+ * the caller as with the norms it computes itself.
+ */
+TEST(RefineHost, CosineDatasetNorms)
+{
+  constexpr int64_t n_rows = 2000, dim = 20, n_queries = 30, k0 = 40, k = 10;
+  raft::resources handle;
+  std::mt19937 rng(7);
+  std::normal_distribution<float> normal;
+  std::uniform_int_distribution<int64_t> row(0, n_rows - 1);
+  auto dataset    = raft::make_host_matrix<float, int64_t>(n_rows, dim);
+  auto queries    = raft::make_host_matrix<float, int64_t>(n_queries, dim);
+  auto candidates = raft::make_host_matrix<int64_t, int64_t>(n_queries, k0);
+  auto norms      = raft::make_host_vector<float, int64_t>(n_rows);
+  for (int64_t i = 0; i < dataset.size(); i++) {
+    dataset.data_handle()[i] = normal(rng);
+  }
+  for (int64_t i = 0; i < queries.size(); i++) {
+    queries.data_handle()[i] = normal(rng);
+  }
+  for (int64_t i = 0; i < candidates.size(); i++) {
+    candidates.data_handle()[i] = row(rng);
+  }
+  for (int64_t i = 0; i < n_rows; i++) {
+    double sum = 0;
+    for (int64_t j = 0; j < dim; j++) {
+      sum += double(dataset(i, j)) * dataset(i, j);
+    }
+    norms(i) = std::sqrt(sum);
+  }
+
+  auto indices         = raft::make_host_matrix<int64_t, int64_t>(n_queries, k);
+  auto distances       = raft::make_host_matrix<float, int64_t>(n_queries, k);
+  auto indices_norms   = raft::make_host_matrix<int64_t, int64_t>(n_queries, k);
+  auto distances_norms = raft::make_host_matrix<float, int64_t>(n_queries, k);
+  auto dataset_view    = raft::make_const_mdspan(dataset.view());
+  auto queries_view    = raft::make_const_mdspan(queries.view());
+  auto candidates_view = raft::make_const_mdspan(candidates.view());
+  const auto cosine    = cuvs::distance::DistanceType::CosineExpanded;
+  cuvs::neighbors::refine(handle,
+                          dataset_view,
+                          queries_view,
+                          candidates_view,
+                          indices.view(),
+                          distances.view(),
+                          cosine);
+  cuvs::neighbors::refine(handle,
+                          dataset_view,
+                          queries_view,
+                          candidates_view,
+                          indices_norms.view(),
+                          distances_norms.view(),
+                          cosine,
+                          2.0f,
+                          raft::make_const_mdspan(norms.view()));
+  for (int64_t i = 0; i < n_queries * k; i++) {
+    ASSERT_EQ(indices.data_handle()[i], indices_norms.data_handle()[i]) << "at " << i;
+    ASSERT_NEAR(distances.data_handle()[i], distances_norms.data_handle()[i], 1e-5) << "at " << i;
+  }
+}
 }  // namespace cuvs::neighbors
@@ -29,6 +29,9 @@
 #include <rmm/cuda_stream_view.hpp>
 #include <rmm/device_uvector.hpp>
 
+#include <numeric>
+#include <vector>
+
 namespace cuvs::neighbors {
 
 template <typename IdxT>
@@ -40,6 +43,7 @@ struct RefineInputs {
   IdxT k0;  // initial k before refinement (k0 >= k).
   cuvs::distance::DistanceType metric;
   bool host_data;
+  float metric_arg = 2.0f;  // p of the LpUnexpanded metric
 };
 
 /** Helper class to allocate arrays and generate input data for refinement test and benchmark. */
@@ -70,6 +74,15 @@ class RefineHelper {
         handle, rng, dataset.data_handle(), dataset.size(), DataT(-10.0), DataT(10.0));
       raft::random::uniform(
         handle, rng, queries.data_handle(), queries.size(), DataT(-10.0), DataT(10.0));
+      if (is_probability_metric(p.metric)) {
+        // Non-negative rows summing to one.
+        raft::random::uniform(
+          handle, rng, dataset.data_handle(), dataset.size(), DataT(0.0), DataT(1.0));
+        raft::random::uniform(
+          handle, rng, queries.data_handle(), queries.size(), DataT(0.0), DataT(1.0));
+        normalize_rows(dataset.data_handle(), p.n_rows, p.dim);
+        normalize_rows(queries.data_handle(), p.n_queries, p.dim);
+      }
     } else {
       raft::random::uniformInt(
         handle, rng, dataset.data_handle(), dataset.size(), DataT(1), DataT(20));
@@ -93,7 +106,8 @@ class RefineHelper {
                                         p.n_rows,
                                         p.dim,
                                         p.k0,
-                                        p.metric);
+                                        p.metric,
+                                        p.metric_arg);
       raft::resource::sync_stream(handle_, stream_);
     }
 
@@ -125,7 +139,8 @@ class RefineHelper {
                                         p.n_rows,
                                         p.dim,
                                         p.k,
-                                        p.metric);
+                                        p.metric,
+                                        p.metric_arg);
       true_refined_distances_host.resize(p.n_queries * p.k);
       true_refined_indices_host.resize(p.n_queries * p.k);
       raft::copy(true_refined_indices_host.data(), indices_dev.data(), indices_dev.size(), stream_);
@@ -135,6 +150,32 @@ class RefineHelper {
     }
   }
 
+  /** Metrics defined on probability distributions. */
+  static bool is_probability_metric(cuvs::distance::DistanceType metric)
+  {
+    return metric == cuvs::distance::DistanceType::HellingerExpanded ||
+           metric == cuvs::distance::DistanceType::JensenShannon ||
+           metric == cuvs::distance::DistanceType::KLDivergence;
+  }
+
+ private:
+  /** Scale the rows of a device matrix of non-negative values to sum to one. */
+  void normalize_rows(DataT* data, IdxT n_rows, IdxT dim)
+  {
+    std::vector<DataT> h(size_t(n_rows) * dim);
+    raft::copy(h.data(), data, h.size(), stream_);
+    raft::resource::sync_stream(handle_, stream_);
+    for (IdxT i = 0; i < n_rows; i++) {
+      DataT* row = h.data() + size_t(i) * dim;
+      DataT sum  = std::accumulate(row, row + dim, DataT(0));
+      for (IdxT j = 0; j < dim; j++) {
+        row[j] /= sum;
+      }
+    }
+    raft::copy(data, h.data(), h.size(), stream_);
+    raft::resource::sync_stream(handle_, stream_);
+  }
+
  public:
   RefineInputs<IdxT> p;
   const raft::resources& handle_;
@@ -49,6 +49,12 @@ void run_brute_force(int64_t n_rows,
   // build index
   cuvsBruteForceBuild(res, &dataset_tensor, metric, 0.0f, index);
 
+  // save the index to file, and search the index loaded from it
+  cuvsBruteForceSerialize(res, "brute_force_c_index", index);
+  cuvsBruteForceIndexDestroy(index);
+  cuvsBruteForceIndexCreate(&index);
+  cuvsBruteForceDeserialize(res, "brute_force_c_index", index);
+
   // create queries DLTensor
   DLManagedTensor queries_tensor;
   queries_tensor.dl_tensor.data               = (void*)query_data;
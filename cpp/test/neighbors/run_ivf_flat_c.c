@@ -16,6 +16,26 @@
 
 #include <cuvs/neighbors/ivf_flat.h>
 
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  char* data;
+  size_t size;
+  size_t pos;
+} byte_buffer;
+
+static size_t append_bytes(void* context, const void* data, size_t size)
+{
+  byte_buffer* buf = (byte_buffer*)context;
+  char* grown      = (char*)realloc(buf->data, buf->size + size);
+  if (grown == NULL) { return 0; }
+  memcpy(grown + buf->size, data, size);
+  buf->data = grown;
+  buf->size += size;
+  return size;
+}
+
 void run_ivf_flat(int64_t n_rows,
                   int64_t n_queries,
                   int64_t n_dim,
@@ -55,6 +75,14 @@ void run_ivf_flat(int64_t n_rows,
   build_params->n_lists = n_lists;
   cuvsIvfFlatBuild(res, build_params, &dataset_tensor, index);
 
+  // save the index to memory, and search the index loaded from there
+  byte_buffer serialized = {NULL, 0, 0};
+  cuvsIvfFlatSerializeToStream(res, append_bytes, &serialized, index);
+  cuvsIvfFlatIndexDestroy(index);
+  cuvsIvfFlatIndexCreate(&index);
+  cuvsIvfFlatDeserializeFromBuffer(res, serialized.data, serialized.size, index);
+  free(serialized.data);
+
   // create queries DLTensor
   DLManagedTensor queries_tensor;
   queries_tensor.dl_tensor.data               = (void*)query_data;
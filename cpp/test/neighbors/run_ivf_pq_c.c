@@ -16,6 +16,35 @@
 
 #include <cuvs/neighbors/ivf_pq.h>
 
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  char* data;
+  size_t size;
+  size_t pos;
+} byte_buffer;
+
+static size_t append_bytes(void* context, const void* data, size_t size)
+{
+  byte_buffer* buf = (byte_buffer*)context;
+  char* grown      = (char*)realloc(buf->data, buf->size + size);
+  if (grown == NULL) { return 0; }
+  memcpy(grown + buf->size, data, size);
+  buf->data = grown;
+  buf->size += size;
+  return size;
+}
+
+static size_t read_bytes(void* context, void* data, size_t size)
+{
+  byte_buffer* buf = (byte_buffer*)context;
+  size_t n         = buf->size - buf->pos < size ? buf->size - buf->pos : size;
+  memcpy(data, buf->data + buf->pos, n);
+  buf->pos += n;
+  return n;
+}
+
 void run_ivf_pq(int64_t n_rows,
                 int64_t n_queries,
                 int64_t n_dim,
@@ -55,6 +84,14 @@ void run_ivf_pq(int64_t n_rows,
   build_params->n_lists = n_lists;
   cuvsIvfPqBuild(res, build_params, &dataset_tensor, index);
 
+  // save the index to a stream, and search the index loaded back from it
+  byte_buffer serialized = {NULL, 0, 0};
+  cuvsIvfPqSerializeToStream(res, append_bytes, &serialized, index);
+  cuvsIvfPqIndexDestroy(index);
+  cuvsIvfPqIndexCreate(&index);
+  cuvsIvfPqDeserializeFromStream(res, read_bytes, &serialized, index);
+  free(serialized.data);
+
   // create queries DLTensor
   DLManagedTensor queries_tensor;
   queries_tensor.dl_tensor.data               = (void*)query_data;
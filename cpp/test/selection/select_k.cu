@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_utils.cuh"
+#include <cuvs/selection/select_k.hpp>
+
+#include <raft/core/host_mdarray.hpp>
+#include <raft/core/resources.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace cuvs::selection {
+
+struct HostSelectKInputs {
+  int64_t batch_size;
+  int64_t len;
+  int64_t k;
+  bool select_min;
+  SelectAlgo algo;
+  // Draw the values from a few integers, so that the rows have many ties.
+  bool ties;
+  bool with_len_i;
+};
+
+::std::ostream& operator<<(::std::ostream& os, const HostSelectKInputs& p)
+{
+  os << "{" << p.batch_size << ", " << p.len << ", " << p.k << ", " << p.select_min << ", "
+     << static_cast<int>(p.algo) << ", " << p.ties << ", " << p.with_len_i << "}";
+  return os;
+}
+
+template <typename IdxT>
+class HostSelectKTest : public ::testing::TestWithParam<HostSelectKInputs> {
+ protected:
+  void run()
+  {
+    auto ps = GetParam();
+    std::mt19937 rng(42);
+    auto in_val = raft::make_host_matrix<float, int64_t>(ps.batch_size, ps.len);
+    auto in_idx = raft::make_host_matrix<IdxT, int64_t>(ps.batch_size, ps.len);
+    auto len_i  = raft::make_host_vector<IdxT, int64_t>(ps.batch_size);
+    std::normal_distribution<float> normal;
+    for (int64_t i = 0; i < ps.batch_size * ps.len; i++) {
+      in_val.data_handle()[i] = ps.ties ? float(rng() % 5) : normal(rng);
+      // A payload distinct from the position, to check that it is carried along.
+      in_idx.data_handle()[i] = IdxT(3 * (i % ps.len) + 1);
+    }
+    for (int64_t r = 0; r < ps.batch_size; r++) {
+      len_i(r) = ps.with_len_i ? IdxT(rng() % (ps.len + 1)) : IdxT(ps.len);
+    }
+    auto out_val = raft::make_host_matrix<float, int64_t>(ps.batch_size, ps.k);
+    auto out_idx = raft::make_host_matrix<IdxT, int64_t>(ps.batch_size, ps.k);
+
+    for (bool with_idx : {false, true}) {
+      select_k(handle_,
+               raft::make_const_mdspan(in_val.view()),
+               with_idx ? std::make_optional(raft::make_const_mdspan(in_idx.view())) : std::nullopt,
+               out_val.view(),
+               out_idx.view(),
+               ps.select_min,
+               true,
+               ps.algo,
+               ps.with_len_i ? std::make_optional(raft::make_const_mdspan(len_i.view()))
+                             : std::nullopt);
+
+      for (int64_t r = 0; r < ps.batch_size; r++) {
+        const int64_t row_len = len_i(r);
+        const float* row      = in_val.data_handle() + r * ps.len;
+        std::vector<float> expected(row, row + row_len);
+        if (ps.select_min) {
+          std::sort(expected.begin(), expected.end());
+        } else {
+          std::sort(expected.begin(), expected.end(), std::greater<>());
+        }
+        std::vector<int64_t> positions;
+        for (int64_t j = 0; j < ps.k; j++) {
+          if (j >= row_len) {
+            ASSERT_EQ(out_idx(r, j), std::numeric_limits<IdxT>::max());
+            continue;
+          }
+          ASSERT_EQ(out_val(r, j), expected[j]) << "row " << r << ", rank " << j;
+          int64_t p = with_idx ? (int64_t(out_idx(r, j)) - 1) / 3 : int64_t(out_idx(r, j));
+          ASSERT_GE(p, 0);
+          ASSERT_LT(p, row_len);
+          ASSERT_EQ(row[p], out_val(r, j));
+          positions.push_back(p);
+        }
+        std::sort(positions.begin(), positions.end());
+        ASSERT_TRUE(std::adjacent_find(positions.begin(), positions.end()) == positions.end())
+          << "row " << r << " has duplicate results";
+      }
+    }
+  }
+
+  raft::resources handle_;
+};
+
+const std::vector<HostSelectKInputs> host_inputs = [] {
+  std::vector<HostSelectKInputs> inputs;
+  for (auto algo : {SelectAlgo::kAuto, SelectAlgo::kRadix11bits, SelectAlgo::kWarpImmediate}) {
+    for (bool select_min : {true, false}) {
+      inputs.push_back({10, 1000, 10, select_min, algo, false, false});
+      inputs.push_back({3, 100000, 1000, select_min, algo, false, false});
+      inputs.push_back({200, 100, 64, select_min, algo, true, false});
+      inputs.push_back({100, 5000, 300, select_min, algo, true, true});
+      // Rows shorter than k.
+      inputs.push_back({4, 20, 50, select_min, algo, false, false});
+    }
+  }
+  return inputs;
+}();
+
+using HostSelectKTestI64 = HostSelectKTest<int64_t>;
+TEST_P(HostSelectKTestI64, Result) { this->run(); }
+INSTANTIATE_TEST_CASE_P(HostSelectKTest, HostSelectKTestI64, ::testing::ValuesIn(host_inputs));
+
+using HostSelectKTestU32 = HostSelectKTest<uint32_t>;
+TEST_P(HostSelectKTestU32, Result) { this->run(); }
+INSTANTIATE_TEST_CASE_P(HostSelectKTest, HostSelectKTestU32, ::testing::ValuesIn(host_inputs));
+
+}  // namespace cuvs::selection
@@ -27,6 +27,7 @@
 #include <rmm/exec_policy.hpp>
 #include <thrust/for_each.h>
 
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -35,6 +36,9 @@
 #include <utility>
 #include <vector>
 
+#include <stdlib.h>
+#include <unistd.h>
+
 namespace cuvs {
 
 /*
@@ -327,4 +331,17 @@ inline std::vector<float> read_csv(std::string filename, bool skip_first_n_colum
   return result;
 }
 
+/**
+ * Create a unique empty file in the temporary directory and return its path, so that the tests
+ * running concurrently do not write the same file. The caller removes the file.
+ */
+inline std::string make_temp_file(const std::string& prefix)
+{
+  std::string path = (std::filesystem::temp_directory_path() / (prefix + ".XXXXXX")).string();
+  int fd           = mkstemp(path.data());
+  if (fd < 0) throw std::runtime_error("Could not create a temporary file " + path);
+  close(fd);
+  return path;
+}
+
 };  // end namespace cuvs
\ No newline at end of file
@@ -32,3 +32,10 @@ cdef extern from "cuvs/core/c_api.h":
     cuvsError_t cuvsStreamSet(cuvsResources_t res, cudaStream_t stream)
     cuvsError_t cuvsStreamSync(cuvsResources_t res)
     const char * cuvsGetLastErrorText()
+
+    ctypedef size_t (*cuvsWriteCallback)(void* context,
+                                         const void* data,
+                                         size_t size) noexcept
+    ctypedef size_t (*cuvsReadCallback)(void* context,
+                                        void* data,
+                                        size_t size) noexcept
@@ -0,0 +1,29 @@
+#
+# Copyright (c) 2024, NVIDIA CORPORATION.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# cython: language_level=3
+
+from libcpp cimport bool
+
+
+cdef size_t write_to_file(void* context,
+                          const void* data,
+                          size_t size) noexcept with gil
+
+cdef size_t read_from_file(void* context,
+                           void* data,
+                           size_t size) noexcept with gil
+
+cpdef bool is_path(obj)
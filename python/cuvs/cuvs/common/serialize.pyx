@@ -0,0 +1,57 @@
+#
+# Copyright (c) 2024, NVIDIA CORPORATION.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# cython: language_level=3
+
+import os
+
+from cpython.bytes cimport PyBytes_FromStringAndSize
+from libc.string cimport memcpy
+from libcpp cimport bool
+
+
+# The callbacks handed to the `...SerializeToStream` and
+# `...DeserializeFromStream` functions of the C API. `context` is a Python
+# file object, which the caller keeps alive during the call. An exception of
+# the file object is reported as a failed write or an early end of the stream.
+
+cdef size_t write_to_file(void* context,
+                          const void* data,
+                          size_t size) noexcept with gil:
+    try:
+        (<object>context).write(
+            PyBytes_FromStringAndSize(<const char*>data, size))
+    except BaseException:
+        return 0
+    return size
+
+
+cdef size_t read_from_file(void* context,
+                           void* data,
+                           size_t size) noexcept with gil:
+    cdef const unsigned char[::1] chunk
+    try:
+        chunk = (<object>context).read(size)
+    except BaseException:
+        return 0
+    if chunk is None or chunk.shape[0] == 0:
+        return 0
+    memcpy(data, &chunk[0], min(<size_t>chunk.shape[0], size))
+    return min(<size_t>chunk.shape[0], size)
+
+
+cpdef bool is_path(obj):
+    """Whether `obj` names a file, rather than being a file object."""
+    return isinstance(obj, (str, os.PathLike))
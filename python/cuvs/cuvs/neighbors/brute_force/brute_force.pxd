@@ -17,7 +17,12 @@
 
 from libc.stdint cimport uintptr_t
 
-from cuvs.common.c_api cimport cuvsError_t, cuvsResources_t
+from cuvs.common.c_api cimport (
+    cuvsError_t,
+    cuvsReadCallback,
+    cuvsResources_t,
+    cuvsWriteCallback,
+)
 from cuvs.common.cydlpack cimport DLDataType, DLManagedTensor
 from cuvs.distance_type cimport cuvsDistanceType
 
@@ -45,3 +50,29 @@ cdef extern from "cuvs/neighbors/brute_force.h" nogil:
                                      DLManagedTensor* queries,
                                      DLManagedTensor* neighbors,
                                      DLManagedTensor* distances) except +
+
+    cuvsError_t cuvsBruteForceSerialize(cuvsResources_t res,
+                                        const char* filename,
+                                        cuvsBruteForceIndex_t index) except +
+
+    cuvsError_t cuvsBruteForceSerializeToStream(
+        cuvsResources_t res,
+        cuvsWriteCallback write,
+        void* context,
+        cuvsBruteForceIndex_t index) except +
+
+    cuvsError_t cuvsBruteForceDeserialize(cuvsResources_t res,
+                                          const char* filename,
+                                          cuvsBruteForceIndex_t index) except +
+
+    cuvsError_t cuvsBruteForceDeserializeFromStream(
+        cuvsResources_t res,
+        cuvsReadCallback read,
+        void* context,
+        cuvsBruteForceIndex_t index) except +
+
+    cuvsError_t cuvsBruteForceDeserializeFromBuffer(
+        cuvsResources_t res,
+        const void* data,
+        size_t size,
+        cuvsBruteForceIndex_t index) except +
@@ -18,7 +18,12 @@
 from libc.stdint cimport uint32_t, uintptr_t
 from libcpp cimport bool
 
-from cuvs.common.c_api cimport cuvsError_t, cuvsResources_t
+from cuvs.common.c_api cimport (
+    cuvsError_t,
+    cuvsReadCallback,
+    cuvsResources_t,
+    cuvsWriteCallback,
+)
 from cuvs.common.cydlpack cimport DLDataType, DLManagedTensor
 from cuvs.distance_type cimport cuvsDistanceType
 
@@ -72,3 +77,28 @@ cdef extern from "cuvs/neighbors/ivf_flat.h" nogil:
                                   DLManagedTensor* queries,
                                   DLManagedTensor* neighbors,
                                   DLManagedTensor* distances) except +
+
+    cuvsError_t cuvsIvfFlatSerialize(cuvsResources_t res,
+                                     const char* filename,
+                                     cuvsIvfFlatIndex_t index) except +
+
+    cuvsError_t cuvsIvfFlatSerializeToStream(cuvsResources_t res,
+                                             cuvsWriteCallback write,
+                                             void* context,
+                                             cuvsIvfFlatIndex_t index) except +
+
+    cuvsError_t cuvsIvfFlatDeserialize(cuvsResources_t res,
+                                       const char* filename,
+                                       cuvsIvfFlatIndex_t index) except +
+
+    cuvsError_t cuvsIvfFlatDeserializeFromStream(
+        cuvsResources_t res,
+        cuvsReadCallback read,
+        void* context,
+        cuvsIvfFlatIndex_t index) except +
+
+    cuvsError_t cuvsIvfFlatDeserializeFromBuffer(
+        cuvsResources_t res,
+        const void* data,
+        size_t size,
+        cuvsIvfFlatIndex_t index) except +
@@ -18,7 +18,12 @@
 from libc.stdint cimport uint32_t, uintptr_t
 from libcpp cimport bool
 
-from cuvs.common.c_api cimport cuvsError_t, cuvsResources_t
+from cuvs.common.c_api cimport (
+    cuvsError_t,
+    cuvsReadCallback,
+    cuvsResources_t,
+    cuvsWriteCallback,
+)
 from cuvs.common.cydlpack cimport DLDataType, DLManagedTensor
 from cuvs.distance_type cimport cuvsDistanceType
 
@@ -91,3 +96,26 @@ cdef extern from "cuvs/neighbors/ivf_pq.h" nogil:
                                 DLManagedTensor* queries,
                                 DLManagedTensor* neighbors,
                                 DLManagedTensor* distances) except +
+
+    cuvsError_t cuvsIvfPqSerialize(cuvsResources_t res,
+                                   const char* filename,
+                                   cuvsIvfPqIndex_t index) except +
+
+    cuvsError_t cuvsIvfPqSerializeToStream(cuvsResources_t res,
+                                           cuvsWriteCallback write,
+                                           void* context,
+                                           cuvsIvfPqIndex_t index) except +
+
+    cuvsError_t cuvsIvfPqDeserialize(cuvsResources_t res,
+                                     const char* filename,
+                                     cuvsIvfPqIndex_t index) except +
+
+    cuvsError_t cuvsIvfPqDeserializeFromStream(cuvsResources_t res,
+                                               cuvsReadCallback read,
+                                               void* context,
+                                               cuvsIvfPqIndex_t index) except +
+
+    cuvsError_t cuvsIvfPqDeserializeFromBuffer(cuvsResources_t res,
+                                               const void* data,
+                                               size_t size,
+                                               cuvsIvfPqIndex_t index) except +
@@ -15,6 +15,8 @@
 #
 # cython: language_level=3
 
+import os
+
 import numpy as np
 
 cimport cuvs.common.cydlpack
@@ -23,8 +25,10 @@ from cuvs.common.resources import auto_sync_resources
 
 from cython.operator cimport dereference as deref
 from libcpp cimport bool, cast
+from libcpp.string cimport string
 
 from cuvs.common cimport cydlpack
+from cuvs.common.serialize cimport is_path, read_from_file, write_to_file
 from cuvs.distance_type cimport cuvsDistanceType
 
 from pylibraft.common import auto_convert_output, cai_wrapper, device_ndarray
@@ -432,3 +436,111 @@ def search(SearchParams search_params,
         ))
 
     return (distances, neighbors)
+
+
+@auto_sync_resources
+def save(filename, Index index, resources=None):
+    """
+    Saves the index to a file or a file object.
+
+    Saving / loading the index is experimental. The serialization format is
+    subject to change.
+
+    Parameters
+    ----------
+    filename : str, os.PathLike or file object
+        Name of the file, or a binary file object receiving the index, e.g.
+        an ``io.BytesIO`` or the ``makefile("wb")`` of a socket.
+    index : Index
+        Trained IvfPq index.
+    {resources_docstring}
+
+    Examples
+    --------
+    >>> import io
+    >>> import cupy as cp
+    >>> from cuvs.neighbors import ivf_pq
+    >>> n_samples = 50000
+    >>> n_features = 50
+    >>> dataset = cp.random.random_sample((n_samples, n_features),
+    ...                                   dtype=cp.float32)
+    >>> index = ivf_pq.build(ivf_pq.IndexParams(), dataset)
+    >>> # Save to a file, or to memory
+    >>> ivf_pq.save("my_index.bin", index)
+    >>> buffer = io.BytesIO()
+    >>> ivf_pq.save(buffer, index)
+    >>> index_loaded = ivf_pq.load(buffer.getvalue())
+    """
+    cdef cuvsResources_t res = <cuvsResources_t>resources.get_c_obj()
+    cdef string c_filename
+
+    if not index.trained:
+        raise ValueError("Index needs to be built before saving it.")
+    if is_path(filename):
+        c_filename = os.fsencode(filename)
+        check_cuvs(cuvsIvfPqSerialize(
+            res,
+            c_filename.c_str(),
+            index.index
+        ))
+    else:
+        check_cuvs(cuvsIvfPqSerializeToStream(
+            res,
+            write_to_file,
+            <void*>filename,
+            index.index
+        ))
+
+
+@auto_sync_resources
+def load(filename, resources=None):
+    """
+    Loads an index saved with `save`.
+
+    Saving / loading the index is experimental. The serialization format is
+    subject to change, therefore loading an index saved with a previous
+    version of cuvs is not guaranteed to work.
+
+    Parameters
+    ----------
+    filename : str, os.PathLike, file object or bytes-like
+        Name of the file, a binary file object providing the index, or the
+        serialized index itself as ``bytes``, ``bytearray`` or
+        ``memoryview``.
+    {resources_docstring}
+
+    Returns
+    -------
+    index : Index
+    """
+    cdef Index idx = Index()
+    cdef cuvsResources_t res = <cuvsResources_t>resources.get_c_obj()
+    cdef string c_filename
+    cdef const uint8_t[::1] data
+
+    if is_path(filename):
+        c_filename = os.fsencode(filename)
+        check_cuvs(cuvsIvfPqDeserialize(
+            res,
+            c_filename.c_str(),
+            idx.index
+        ))
+    elif isinstance(filename, (bytes, bytearray, memoryview)):
+        data = memoryview(filename).cast("B")
+        if data.shape[0] == 0:
+            raise ValueError("The serialized index is empty.")
+        check_cuvs(cuvsIvfPqDeserializeFromBuffer(
+            res,
+            <const void*>&data[0],
+            data.shape[0],
+            idx.index
+        ))
+    else:
+        check_cuvs(cuvsIvfPqDeserializeFromStream(
+            res,
+            read_from_file,
+            <void*>filename,
+            idx.index
+        ))
+    idx.trained = True
+    return idx
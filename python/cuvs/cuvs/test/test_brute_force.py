@@ -13,6 +13,8 @@
 # limitations under the License.
 #
 
+import io
+
 import numpy as np
 import pytest
 from pylibraft.common import device_ndarray
@@ -88,3 +90,46 @@ def test_brute_force_knn(
         np.testing.assert_allclose(
             cpu_ordered[:k], gpu_dists, atol=1e-3, rtol=1e-3
         )
+
+
+@pytest.mark.parametrize("target", ["file", "bytes", "stream"])
+def test_save_load(target, tmp_path):
+    n_rows = 10000
+    n_cols = 50
+    n_queries = 1000
+    k = 10
+
+    dataset = np.random.random_sample((n_rows, n_cols)).astype(np.float32)
+    dataset_device = device_ndarray(dataset)
+    index = brute_force.build(dataset_device)
+
+    if target == "file":
+        filename = str(tmp_path / "index.bin")
+        brute_force.save(filename, index)
+        loaded_index = brute_force.load(filename)
+    else:
+        buffer = io.BytesIO()
+        brute_force.save(buffer, index)
+        if target == "bytes":
+            loaded_index = brute_force.load(buffer.getvalue())
+        else:
+            buffer.seek(0)
+            loaded_index = brute_force.load(buffer)
+    assert loaded_index.trained
+
+    queries = np.random.random_sample((n_queries, n_cols)).astype(np.float32)
+    queries_device = device_ndarray(queries)
+
+    distance_dev, neighbors_dev = brute_force.search(index, queries_device, k)
+    neighbors = neighbors_dev.copy_to_host()
+    dist = distance_dev.copy_to_host()
+    del index
+
+    distance_dev, neighbors_dev = brute_force.search(
+        loaded_index, queries_device, k
+    )
+    neighbors2 = neighbors_dev.copy_to_host()
+    dist2 = distance_dev.copy_to_host()
+
+    assert np.all(neighbors == neighbors2)
+    assert np.allclose(dist, dist2, rtol=1e-6)
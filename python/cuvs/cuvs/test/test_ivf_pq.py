@@ -13,6 +13,8 @@
 # limitations under the License.
 #
 
+import io
+
 import numpy as np
 import pytest
 from pylibraft.common import device_ndarray
@@ -166,3 +168,48 @@ def test_ivf_pq_search_params(params):
         lut_dtype=params["lut"],
         internal_distance_dtype=params["idd"],
     )
+
+
+@pytest.mark.parametrize("target", ["file", "bytes", "stream"])
+def test_save_load(target, tmp_path):
+    n_rows = 10000
+    n_cols = 50
+    n_queries = 1000
+    k = 10
+
+    dataset = np.random.random_sample((n_rows, n_cols)).astype(np.float32)
+    dataset_device = device_ndarray(dataset)
+    index = ivf_pq.build(ivf_pq.IndexParams(), dataset_device)
+
+    if target == "file":
+        filename = str(tmp_path / "index.bin")
+        ivf_pq.save(filename, index)
+        loaded_index = ivf_pq.load(filename)
+    else:
+        buffer = io.BytesIO()
+        ivf_pq.save(buffer, index)
+        if target == "bytes":
+            loaded_index = ivf_pq.load(buffer.getvalue())
+        else:
+            buffer.seek(0)
+            loaded_index = ivf_pq.load(buffer)
+    assert loaded_index.trained
+
+    queries = np.random.random_sample((n_queries, n_cols)).astype(np.float32)
+    queries_device = device_ndarray(queries)
+
+    distance_dev, neighbors_dev = ivf_pq.search(
+        ivf_pq.SearchParams(), index, queries_device, k
+    )
+    neighbors = neighbors_dev.copy_to_host()
+    dist = distance_dev.copy_to_host()
+    del index
+
+    distance_dev, neighbors_dev = ivf_pq.search(
+        ivf_pq.SearchParams(), loaded_index, queries_device, k
+    )
+    neighbors2 = neighbors_dev.copy_to_host()
+    dist2 = distance_dev.copy_to_host()
+
+    assert np.all(neighbors == neighbors2)
+    assert np.allclose(dist, dist2, rtol=1e-6)
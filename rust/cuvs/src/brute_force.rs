@@ -15,12 +15,14 @@
  */
 //! Brute Force KNN
 
-use std::io::{stderr, Write};
+use std::io::{stderr, Read, Write};
+use std::os::raw::c_void;
 
 use crate::distance_type::DistanceType;
 use crate::dlpack::ManagedTensor;
 use crate::error::{check_cuvs, Result};
 use crate::resources::Resources;
+use crate::serialize::{c_filename, read_callback, write_callback};
 
 /// Brute Force KNN Index
 #[derive(Debug)]
@@ -89,6 +91,91 @@ impl Index {
             ))
         }
     }
+
+    /// Saves the index to a file.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `filename` - The file to write the index to
+    pub fn serialize(&self, res: &Resources, filename: &str) -> Result<()> {
+        let filename = c_filename(filename)?;
+        unsafe { check_cuvs(ffi::cuvsBruteForceSerialize(res.0, filename.as_ptr(), self.0)) }
+    }
+
+    /// Writes the index to `writer`, e.g. a socket or a `Vec<u8>`, without a temporary file.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `writer` - Receives the serialized index
+    pub fn serialize_to_writer<W: Write>(&self, res: &Resources, writer: &mut W) -> Result<()> {
+        unsafe {
+            check_cuvs(ffi::cuvsBruteForceSerializeToStream(
+                res.0,
+                Some(write_callback::<W>),
+                writer as *mut W as *mut c_void,
+                self.0,
+            ))
+        }
+    }
+
+    /// Loads an index saved with `serialize`.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `filename` - The file the index was saved to
+    pub fn deserialize(res: &Resources, filename: &str) -> Result<Index> {
+        let filename = c_filename(filename)?;
+        let index = Index::new()?;
+        unsafe {
+            check_cuvs(ffi::cuvsBruteForceDeserialize(
+                res.0,
+                filename.as_ptr(),
+                index.0,
+            ))?;
+        }
+        Ok(index)
+    }
+
+    /// Loads an index from `reader`, which provides the bytes written by `serialize_to_writer`.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `reader` - Provides the serialized index
+    pub fn deserialize_from_reader<R: Read>(res: &Resources, reader: &mut R) -> Result<Index> {
+        let index = Index::new()?;
+        unsafe {
+            check_cuvs(ffi::cuvsBruteForceDeserializeFromStream(
+                res.0,
+                Some(read_callback::<R>),
+                reader as *mut R as *mut c_void,
+                index.0,
+            ))?;
+        }
+        Ok(index)
+    }
+
+    /// Loads an index from a serialized index in memory.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `bytes` - The serialized index
+    pub fn deserialize_from_bytes(res: &Resources, bytes: &[u8]) -> Result<Index> {
+        let index = Index::new()?;
+        unsafe {
+            check_cuvs(ffi::cuvsBruteForceDeserializeFromBuffer(
+                res.0,
+                bytes.as_ptr() as *const c_void,
+                bytes.len(),
+                index.0,
+            ))?;
+        }
+        Ok(index)
+    }
 }
 
 impl Drop for Index {
@@ -126,6 +213,13 @@ mod tests {
         let index =
             Index::build(&res, metric, None, dataset).expect("failed to create brute force index");
 
+        // search the index after saving and loading it
+        let filename = std::env::temp_dir().join("cuvs_rust_brute_force_index");
+        let filename = filename.to_str().unwrap();
+        index.serialize(&res, filename).unwrap();
+        let index = Index::deserialize(&res, filename).unwrap();
+        std::fs::remove_file(filename).unwrap();
+
         res.sync_stream().unwrap();
 
         // use the first 4 points from the dataset as queries : will test that we get them back
@@ -29,6 +29,17 @@ pub enum Error {
 }
 
 impl std::error::Error for Error {}
+
+impl Error {
+    /// An error detected before calling into cuvs
+    pub(crate) fn invalid_argument(text: String) -> Error {
+        Error::CuvsError(CuvsError {
+            code: ffi::cuvsError_t::CUVS_ERROR,
+            text,
+        })
+    }
+}
+
 impl std::error::Error for CuvsError {}
 
 pub type Result<T> = std::result::Result<T, Error>;
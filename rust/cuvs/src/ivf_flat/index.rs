@@ -14,12 +14,14 @@
  * limitations under the License.
  */
 
-use std::io::{stderr, Write};
+use std::io::{stderr, Read, Write};
+use std::os::raw::c_void;
 
 use crate::ivf_flat::{IndexParams, SearchParams};
 use crate::dlpack::ManagedTensor;
 use crate::error::{check_cuvs, Result};
 use crate::resources::Resources;
+use crate::serialize::{c_filename, read_callback, write_callback};
 
 /// Ivf-Flat ANN Index
 #[derive(Debug)]
@@ -88,6 +90,91 @@ impl Index {
             ))
         }
     }
+
+    /// Saves the index to a file.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `filename` - The file to write the index to
+    pub fn serialize(&self, res: &Resources, filename: &str) -> Result<()> {
+        let filename = c_filename(filename)?;
+        unsafe { check_cuvs(ffi::cuvsIvfFlatSerialize(res.0, filename.as_ptr(), self.0)) }
+    }
+
+    /// Writes the index to `writer`, e.g. a socket or a `Vec<u8>`, without a temporary file.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `writer` - Receives the serialized index
+    pub fn serialize_to_writer<W: Write>(&self, res: &Resources, writer: &mut W) -> Result<()> {
+        unsafe {
+            check_cuvs(ffi::cuvsIvfFlatSerializeToStream(
+                res.0,
+                Some(write_callback::<W>),
+                writer as *mut W as *mut c_void,
+                self.0,
+            ))
+        }
+    }
+
+    /// Loads an index saved with `serialize`.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `filename` - The file the index was saved to
+    pub fn deserialize(res: &Resources, filename: &str) -> Result<Index> {
+        let filename = c_filename(filename)?;
+        let index = Index::new()?;
+        unsafe {
+            check_cuvs(ffi::cuvsIvfFlatDeserialize(
+                res.0,
+                filename.as_ptr(),
+                index.0,
+            ))?;
+        }
+        Ok(index)
+    }
+
+    /// Loads an index from `reader`, which provides the bytes written by `serialize_to_writer`.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `reader` - Provides the serialized index
+    pub fn deserialize_from_reader<R: Read>(res: &Resources, reader: &mut R) -> Result<Index> {
+        let index = Index::new()?;
+        unsafe {
+            check_cuvs(ffi::cuvsIvfFlatDeserializeFromStream(
+                res.0,
+                Some(read_callback::<R>),
+                reader as *mut R as *mut c_void,
+                index.0,
+            ))?;
+        }
+        Ok(index)
+    }
+
+    /// Loads an index from a serialized index in memory.
+    ///
+    /// # Arguments
+    ///
+    /// * `res` - Resources to use
+    /// * `bytes` - The serialized index
+    pub fn deserialize_from_bytes(res: &Resources, bytes: &[u8]) -> Result<Index> {
+        let index = Index::new()?;
+        unsafe {
+            check_cuvs(ffi::cuvsIvfFlatDeserializeFromBuffer(
+                res.0,
+                bytes.as_ptr() as *const c_void,
+                bytes.len(),
+                index.0,
+            ))?;
+        }
+        Ok(index)
+    }
 }
 
 impl Drop for Index {
@@ -124,6 +211,11 @@ mod tests {
         let index =
             Index::build(&res, &build_params, dataset_device).expect("failed to create ivf-flat index");
 
+        // search the index after a round trip through memory
+        let mut serialized = Vec::new();
+        index.serialize_to_writer(&res, &mut serialized).unwrap();
+        let index = Index::deserialize_from_bytes(&res, &serialized).unwrap();
+
         // use the first 4 points from the dataset as queries : will test that we get them back
         // as their own nearest neighbor
         let n_queries = 4;
@@ -27,6 +27,7 @@ mod dlpack;
 mod error;
 pub mod ivf_pq;
 mod resources;
+mod serialize;
 
 pub use dlpack::ManagedTensor;
 pub use error::{Error, Result};
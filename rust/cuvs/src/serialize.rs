@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//! Adapters letting the serialization functions of the C API write to and read from Rust
+//! `Write` and `Read` implementations.
+
+use std::ffi::CString;
+use std::io::{ErrorKind, Read, Write};
+use std::os::raw::c_void;
+
+use crate::error::{Error, Result};
+
+/// `cuvsWriteCallback` writing to the `W` that `context` points to
+pub(crate) unsafe extern "C" fn write_callback<W: Write>(
+    context: *mut c_void,
+    data: *const c_void,
+    size: usize,
+) -> usize {
+    let writer = &mut *(context as *mut W);
+    let bytes = std::slice::from_raw_parts(data as *const u8, size);
+    match writer.write_all(bytes) {
+        Ok(()) => size,
+        Err(_) => 0,
+    }
+}
+
+/// `cuvsReadCallback` reading from the `R` that `context` points to
+pub(crate) unsafe extern "C" fn read_callback<R: Read>(
+    context: *mut c_void,
+    data: *mut c_void,
+    size: usize,
+) -> usize {
+    let reader = &mut *(context as *mut R);
+    let buffer = std::slice::from_raw_parts_mut(data as *mut u8, size);
+    loop {
+        match reader.read(buffer) {
+            Ok(n) => return n,
+            Err(e) if e.kind() == ErrorKind::Interrupted => continue,
+            Err(_) => return 0,
+        }
+    }
+}
+
+/// Converts a file name to the C string the C API takes
+pub(crate) fn c_filename(filename: &str) -> Result<CString> {
+    CString::new(filename)
+        .map_err(|_| Error::invalid_argument(format!("invalid file name {:?}", filename)))
+}